@@ -23,6 +23,8 @@ file(GLOB PPLCV_X86_AVX_SRC
      src/ppl/cv/x86/avx/*.cpp)
 file(GLOB PPLCV_X86_FMA_SRC
      src/ppl/cv/x86/fma/*.cpp)
+file(GLOB PPLCV_X86_AVX512_SRC
+     src/ppl/cv/x86/avx512/*.cpp)
 file(GLOB PPLCV_X86_IMGCODECS
      src/ppl/cv/x86/imgcodecs/*.cpp)
 
@@ -30,8 +32,21 @@ set(PPLCV_X86_SRC
     ${PPLCV_X86_SSE_SRC}
     ${PPLCV_X86_AVX_SRC}
     ${PPLCV_X86_FMA_SRC}
+    ${PPLCV_X86_AVX512_SRC}
     ${PPLCV_X86_IMGCODECS})
 
+# the AVX-512 kernels only run when the cpu reports AVX512F/BW/DQ/VL
+if(NOT AVX512_ENABLED_FLAGS)
+    if(MSVC)
+        set(AVX512_ENABLED_FLAGS "/arch:AVX512")
+    else()
+        set(AVX512_ENABLED_FLAGS "-mavx512f -mavx512bw -mavx512dq -mavx512vl -mfma -mavx2")
+    endif()
+endif()
+
+foreach(filename ${PPLCV_X86_AVX512_SRC})
+    set_source_files_properties(${filename} PROPERTIES COMPILE_FLAGS "${AVX512_ENABLED_FLAGS}")
+endforeach()
 foreach(filename ${PPLCV_X86_FMA_SRC})
     set_source_files_properties(${filename} PROPERTIES COMPILE_FLAGS "${FMA_ENABLED_FLAGS}")
 endforeach()
@@ -50,6 +65,10 @@ if(USE_X86_OMP)
     if(OPENMP_FOUND)
         list(APPEND PPLCV_LINK_LIBRARIES OpenMP::OpenMP_CXX)
     endif()
+else()
+    # the built-in worker pool of parallel.cpp
+    FIND_PACKAGE(Threads REQUIRED)
+    list(APPEND PPLCV_LINK_LIBRARIES Threads::Threads)
 endif()
 
 list(APPEND PPLCV_SRC ${PPLCV_X86_SRC})
@@ -52,6 +52,24 @@ enum InterpolationType {
     INTERPOLATION_AREA //!< Area interpolation
 };
 
+/**
+ * \brief
+ * Recursion used by GaussianBlurIIR, trading accuracy for speed.
+ */
+enum GaussianIIRType {
+    GAUSSIAN_IIR_FAST     = 0, //!< 3rd order van Vliet-Young-Verbeek cascade, within 1.5% of the Gaussian peak from sigma 3
+    GAUSSIAN_IIR_ACCURATE = 1  //!< 4th order Deriche sum, within 0.05% of the Gaussian peak
+};
+
+/**
+ * \brief
+ * How BilateralFilter weighs the neighbourhood of a pixel.
+ */
+enum BilateralFilterType {
+    BILATERAL_EXACT = 0, //!< every pixel within the diameter, cost growing with its square
+    BILATERAL_GRID  = 1  //!< bilateral grid approximation, cost independent of the spatial sigma
+};
+
 enum BorderType {
     BORDER_CONSTANT       = 0, //!< `iiiiii|abcdefgh|iiiiii` with some specified `i`
     BORDER_REPLICATE      = 1, //!< `aaaaaa|abcdefgh|hhhhhh`
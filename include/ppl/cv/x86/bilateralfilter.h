@@ -39,7 +39,23 @@ namespace x86 {
  * @param outWidthStride    the width stride of output image, usually it equals to `width * channels`
  * @param dst               output image data
  * @param border_type       ways to deal with border. Only BORDER_REFLECT_101 or BORDER_DEFAULT are supported now.
+ * @param type              BILATERAL_EXACT weighs every pixel within the diameter, BILATERAL_GRID approximates
+ *                          the filter on a bilateral grid.
  * @warning All input parameters must be valid, or undefined behaviour may occur.
+ * @note 1 BILATERAL_GRID sums the image into a grid of cells sigma_space pixels wide and sigma_color
+ *         levels deep, blurs it and interpolates every pixel back from it, so its cost does not grow
+ *         with the spatial sigma. The spatial weights follow sigma_space and diameter is ignored;
+ *         pixels outside the image are not used instead of being reflected. 3 channel pixels are
+ *         placed in the grid by b + g + r, so colour edges of equal brightness are not kept.
+ *       2 BILATERAL_GRID pays off from a sigma_space of about 4; below that the grid has about as
+ *         many cells as the image has pixels.
+ *       3 BILATERAL_GRID keeps the grid within 1024 range levels. When the range of the image
+ *         over sigma_color is wider, e.g. float input with outliers or a tiny sigma_color, the
+ *         levels are made deeper than sigma_color and edges are smoothed more. Float images
+ *         holding inf or nan are filtered by BILATERAL_EXACT instead.
+ *       4 BILATERAL_GRID returns RC_OUT_OF_MEMORY without allocating when the grid would take more
+ *         than 1 GiB, which is about (height / sigma_space) * (width / sigma_space) * levels * 16
+ *         bytes for 3 channels and half of it for 1, with levels about range / sigma_color.
  * @remark The following table show which data type and channels are supported.
  * <table>
  * <tr><th>Data type(T)<th>channels
@@ -87,7 +103,8 @@ template <typename T, int32_t numChannels>
     float space,
     int32_t outWidthStride,
     T* outData,
-    BorderType border_type);
+    BorderType border_type,
+    BilateralFilterType type = ppl::cv::BILATERAL_EXACT);
 
 }
 }
@@ -38,7 +38,7 @@ namespace x86 {
 * @param normalize         Whether it needs to be normalized
 * @param outWidthStride    the width stride of output image, usually it equals to `width * channels`
 * @param outData           output image data
-* @param border_type       ways to deal with border. Only BORDER_REFLECT, BORDER_REFLECT_101 or BORDER_DEFAULT are supported now.
+* @param border_type       ways to deal with border. BORDER_CONSTANT (padded with 0), BORDER_REPLICATE, BORDER_REFLECT, BORDER_WRAP, BORDER_REFLECT_101 and BORDER_DEFAULT are supported.
 * @warning All input parameters must be valid, or undefined behaviour may occur.
 * @remark The following table show which data type and channels are supported.
 * <table>
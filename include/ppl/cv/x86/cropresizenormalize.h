@@ -0,0 +1,128 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+#ifndef __ST_HPC_PPL_CV_X86_CROPRESIZENORMALIZE_H_
+#define __ST_HPC_PPL_CV_X86_CROPRESIZENORMALIZE_H_
+
+#include "ppl/common/retcode.h"
+
+#include <stdint.h>
+
+namespace ppl {
+namespace cv {
+namespace x86 {
+
+/**
+* @brief Crops a region of an interleaved image, resizes it with linear interpolation and writes
+*        it normalized into planar (NCHW) float or half-precision planes, in one pass.
+* @tparam TSrc The data type of input image, currently only \a uint8_t and \a float are supported.
+* @tparam channels The number of channels of input image, 1, 3 and 4 are supported.
+* @tparam TDst The data type of output planes, \a float, or \a uint16_t holding IEEE 754 half-precision values.
+* @param inHeight          input image's height
+* @param inWidth           input image's width
+* @param inWidthStride     input image's width stride, usually it equals to `width * channels`
+* @param inData            input image data
+* @param left              left column of the cropped region
+* @param top               top row of the cropped region
+* @param cropWidth         width of the cropped region
+* @param cropHeight        height of the cropped region
+* @param outHeight         output planes' height
+* @param outWidth          output planes' width
+* @param outWidthStride    elements between two rows of an output plane, usually it equals to `outWidth`
+* @param outPlaneStride    elements between two output planes, usually it equals to `outHeight * outWidthStride`
+* @param outData           output planes, 1 for 1 channel images and 3 for 3 and 4 channel images
+* @param mean              per plane value subtracted from the resized pixels, in output plane order
+* @param std               per plane value the pixels are divided by after subtracting `mean`, in output plane order
+* @param swapRB            whether the first and third channels are swapped, e.g. BGR in and RGB out
+* @return The execution status, succeeds or fails with an error code.
+* @note 1 The result equals Crop(), ResizeLinear(), channel swapping, (x - mean) / std and splitting
+*         the channels run one after the other, up to float rounding: the resized pixels of \a uint8_t
+*         images are rounded to \a uint8_t as ResizeLinear() does. Rows are resized a tile at a time
+*         into a buffer that stays in the L2 cache and converted from there, so the source region is
+*         read once and no full size intermediate image is made.
+*       2 The 4th channel of 4 channel images, usually alpha, is dropped.
+*       3 Half-precision values are rounded to nearest even; values out of its range become infinity.
+* @warning All input parameters must be valid, or undefined behaviour may occur.
+* @remark The fllowing table show which data type and channels are supported.
+* <table>
+* <tr><th>Data type(TSrc)<th>channels<th>Data type(TDst)
+* <tr><td>uint8_t(uchar)<td>1<td>float
+* <tr><td>uint8_t(uchar)<td>3<td>float
+* <tr><td>uint8_t(uchar)<td>4<td>float
+* <tr><td>float<td>1<td>float
+* <tr><td>float<td>3<td>float
+* <tr><td>float<td>4<td>float
+* <tr><td>uint8_t(uchar)<td>1<td>uint16_t(half)
+* <tr><td>uint8_t(uchar)<td>3<td>uint16_t(half)
+* <tr><td>uint8_t(uchar)<td>4<td>uint16_t(half)
+* <tr><td>float<td>1<td>uint16_t(half)
+* <tr><td>float<td>3<td>uint16_t(half)
+* <tr><td>float<td>4<td>uint16_t(half)
+* </table>
+* <table>
+* <caption align="left">Requirements</caption>
+* <tr><td>x86 platforms supported<td> All
+* <tr><td>Header files<td> #include &lt;ppl/cv/x86/cropresizenormalize.h&gt;
+* <tr><td>Project<td> ppl.cv
+* @since ppl.cv-v0.7.0
+* ###Example
+* @code{.cpp}
+* #include <ppl/cv/x86/cropresizenormalize.h>
+* int32_t main(int32_t argc, char** argv) {
+*     const int32_t W = 1920;
+*     const int32_t H = 1080;
+*     const int32_t C = 3;
+*     const int32_t outWidth = 224;
+*     const int32_t outHeight = 224;
+*     const float mean[3] = {123.675f, 116.28f, 103.53f};
+*     const float std[3] = {58.395f, 57.12f, 57.375f};
+*     uint8_t* dev_iImage = (uint8_t*)malloc(W * H * C * sizeof(uint8_t));
+*     float* dev_oImage = (float*)malloc(outWidth * outHeight * 3 * sizeof(float));
+*
+*     // the centered 1080x1080 square of a BGR frame to a normalized RGB tensor
+*     ppl::cv::x86::CropResizeNormalize<uint8_t, 3, float>(H, W, W * C, dev_iImage,
+*         420, 0, 1080, 1080, outHeight, outWidth, outWidth, outHeight * outWidth, dev_oImage,
+*         mean, std, true);
+*
+*     free(dev_iImage);
+*     free(dev_oImage);
+*     return 0;
+* }
+* @endcode
+***************************************************************************************************/
+template <typename TSrc, int32_t channels, typename TDst>
+::ppl::common::RetCode CropResizeNormalize(
+    int32_t inHeight,
+    int32_t inWidth,
+    int32_t inWidthStride,
+    const TSrc* inData,
+    int32_t left,
+    int32_t top,
+    int32_t cropWidth,
+    int32_t cropHeight,
+    int32_t outHeight,
+    int32_t outWidth,
+    int32_t outWidthStride,
+    int32_t outPlaneStride,
+    TDst* outData,
+    const float* mean,
+    const float* std,
+    bool swapRB);
+
+}
+}
+} // namespace ppl::cv::x86
+#endif //! __ST_HPC_PPL_CV_X86_CROPRESIZENORMALIZE_H_
@@ -71,6 +71,59 @@ namespace x86 {
     int32_t outWidthStride,
     uint8_t* outData);
 
+/**
+* @brief Equalizes the histogram of a grayscale image with a histogram computed beforehand.
+* @param inHeight          inData's height, the same height as outData
+* @param inWidth           inData's width,  the same width as outData
+* @param inWidthStride     inData's width stride, usually it equals to `width`
+* @param inData            input data
+* @param outWidthStride    outData's width stride, usually it equals to `width`
+* @param outData           output data
+* @param inHist            the 256-bin histogram of inData, e.g. the output of CalcHist;
+*                          it is computed here when null
+* @warning All input parameters must be valid, or undefined behaviour may occur.
+* @note Callers which already ran CalcHist on the image save the second pass over
+*       the input. inData and outData may point to the same image.
+* @remark The fllowing table show which data type is supported.
+* <table>
+* <tr><td>uint8_t
+* </table>
+* <table>
+* <caption align="left">Requirements</caption>
+* <tr><td>X86 platforms supported<td> All
+* <tr><td>Header files<td> #include &lt;ppl/cv/x86/equalizehist.h&gt;
+* <tr><td>Project<td> ppl.cv
+* @since ppl.cv-v0.7.0
+* ###Example
+* @code{.cpp}
+* #include <ppl/cv/x86/calchist.h>
+* #include <ppl/cv/x86/equalizehist.h>
+* int32_t main(int32_t argc, char** argv) {
+*     const int32_t W = 640;
+*     const int32_t H = 480;
+*     uint8_t* dev_iImage = (uint8_t*)malloc(W * H * sizeof(uint8_t));
+*     uint8_t* dev_oImage = (uint8_t*)malloc(W * H * sizeof(uint8_t));
+*     int32_t hist[256];
+*
+*     ppl::cv::x86::CalcHist<uint8_t>(H, W, W, dev_iImage, hist);
+*     ppl::cv::x86::EqualizeHist(H, W, W, dev_iImage, W, dev_oImage, hist);
+*
+*     free(dev_iImage);
+*     free(dev_oImage);
+*     return 0;
+* }
+* @endcode
+***************************************************************************************************/
+
+::ppl::common::RetCode EqualizeHist(
+    int32_t inHeight,
+    int32_t inWidth,
+    int32_t inWidthStride,
+    const uint8_t* inData,
+    int32_t outWidthStride,
+    uint8_t* outData,
+    const int32_t* inHist);
+
 }
 }
 } // namespace ppl::cv::x86
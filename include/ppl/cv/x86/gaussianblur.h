@@ -37,8 +37,7 @@ namespace x86 {
  * @param sigma             standard deviation
  * @param outWidthStride    the width stride of output image, usually it equals to `width * channels`
  * @param outData           output image data
- * @param border_type       ways to deal with border. For float, only BORDER_REFLECT_101 or BORDER_DEFAULT are supported now.
- *                          For uchar, all BORDER_TYPE are supported.
+ * @param border_type       ways to deal with border. BORDER_CONSTANT (padded with 0), BORDER_REPLICATE, BORDER_REFLECT, BORDER_WRAP, BORDER_REFLECT_101 and BORDER_DEFAULT are supported.
  * @warning All input parameters must be valid, or undefined behaviour may occur.
  * @remark The fllowing table show which data type and channels are supported.
  * <table>
@@ -86,6 +85,77 @@ template <typename T, int32_t numChannels>
     T *outData,
     BorderType border_type = ppl::cv::BORDER_DEFAULT);
 
+
+/**
+ * @brief Gaussian blur by recursive filtering, whose cost per pixel does not depend on sigma.
+ * @tparam T The data type of input image, currently only \a uint8_t(uchar) and \a float are supported.
+ * @tparam channels The number of channels of input image, 1, 3 and 4 are supported.
+ * @param height            input image's height
+ * @param width             input image's width need to be processed
+ * @param inWidthStride     input image's width stride, usually it equals to `width * channels`
+ * @param inData            input image data
+ * @param sigma             standard deviation in both directions, at least 0.5
+ * @param outWidthStride    the width stride of output image, usually it equals to `width * channels`
+ * @param outData           output image data
+ * @param type              GAUSSIAN_IIR_ACCURATE for a 4th order Deriche filter, GAUSSIAN_IIR_FAST for
+ *                          a cheaper 3rd order van Vliet-Young-Verbeek filter.
+ * @param border_type       ways to deal with border. BORDER_CONSTANT (padded with 0), BORDER_REPLICATE, BORDER_REFLECT, BORDER_WRAP, BORDER_REFLECT_101 and BORDER_DEFAULT are supported.
+ * @warning All input parameters must be valid, or undefined behaviour may occur.
+ * @note 1 Every line is filtered forward and backward, so unlike GaussianBlur there is no kernel
+ *         and the cost stays the same for any sigma. Worth it from a sigma of about 3 for uchar
+ *         and 8 for float; below that GaussianBlur with a kernel of about 6 * sigma is both faster
+ *         and exact.
+ *       2 BORDER_REPLICATE and, for GAUSSIAN_IIR_ACCURATE, BORDER_CONSTANT start the recursions
+ *         from their steady state. The other borders run them over 4 * sigma extra pixels at
+ *         each end of every line.
+ *       3 outData must not overlap inData.
+ * @remark The fllowing table show which data type and channels are supported.
+ * <table>
+ * <tr><th>Data type(T)<th>channels
+ * <tr><td>uint8_t(uchar)<td>1
+ * <tr><td>uint8_t(uchar)<td>3
+ * <tr><td>uint8_t(uchar)<td>4
+ * <tr><td>float<td>1
+ * <tr><td>float<td>3
+ * <tr><td>float<td>4
+ * </table>
+ * <table>
+ * <caption align="left">Requirements</caption>
+ * <tr><td>X86 platforms supported<td> All
+ * <tr><td>Header files<td> #include &lt;ppl/cv/x86/gaussianblur.h&gt;
+ * <tr><td>Project<td> ppl.cv
+ * @since ppl.cv-v0.7.0
+ * ###Example
+ * @code{.cpp}
+ * #include <ppl/cv/x86/gaussianblur.h>
+ * int32_t main(int32_t argc, char** argv) {
+ *     const int32_t W = 1920;
+ *     const int32_t H = 1080;
+ *     const int32_t C = 1;
+ *     uint8_t* dev_iImage = (uint8_t*)malloc(W * H * C * sizeof(uint8_t));
+ *     uint8_t* dev_oImage = (uint8_t*)malloc(W * H * C * sizeof(uint8_t));
+ *
+ *     ppl::cv::x86::GaussianBlurIIR<uint8_t, 1>(H, W, W * C, dev_iImage, 20.f, W * C, dev_oImage,
+ *                                                ppl::cv::GAUSSIAN_IIR_ACCURATE, ppl::cv::BORDER_REPLICATE);
+ *
+ *     free(dev_iImage);
+ *     free(dev_oImage);
+ *     return 0;
+ * }
+ * @endcode
+ ***************************************************************************************************/
+template <typename T, int32_t numChannels>
+::ppl::common::RetCode GaussianBlurIIR(
+    int32_t height,
+    int32_t width,
+    int32_t inWidthStride,
+    const T *inData,
+    float sigma,
+    int32_t outWidthStride,
+    T *outData,
+    GaussianIIRType type   = ppl::cv::GAUSSIAN_IIR_ACCURATE,
+    BorderType border_type = ppl::cv::BORDER_DEFAULT);
+
 }
 }
 } // namespace ppl::cv::x86
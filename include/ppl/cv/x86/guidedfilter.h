@@ -41,7 +41,12 @@ namespace x86 {
 * @param radius               filter window radius
 * @param eps                  Regularization parameter (fuzzy coefficient), if input is in range of [0, 255], eps should be multiplied by 255
 * @param border_type       ways to deal with border. Only BORDER_REFLECT, BORDER_REFLECT_101 or BORDER_DEFAULT are supported now.
+* @param subsample         1 runs the full resolution filter. A larger value runs the fast guided filter, computing the
+*                          coefficients on the images shrunk by this factor with a radius of `radius / subsample` and
+*                          upsampling them bilinearly, which cuts the cost by about its square.
 * @warning All input parameters must be valid, or undefined behaviour may occur.
+* @note The window means are running sums streamed over the rows, so the cost does not depend on `radius` and no
+*       temporary image is allocated unless `subsample` is above 1, when the shrunk images are.
 * @remark The fllowing table show which data type and channels are supported.
 * <table>
 * <tr><th>Data type(T)<th>channels
@@ -91,7 +96,8 @@ template <typename T, int32_t srcChannels, int32_t guidedChannels>
     T* dst,
     int32_t radius,
     float eps,
-    BorderType border_type);
+    BorderType border_type,
+    int32_t subsample = 1);
 
 }
 }
@@ -79,6 +79,615 @@ namespace x86 {
                               int* stride,
                               uchar** image);
 
+/**
+ * @brief Loads an image from a file at a reduced size.
+ * @param fileName  name of file to be loaded.
+ * @param height    pointer to store the height of the loaded image.
+ * @param width     pointer to store the width of the loaded image.
+ * @param channels  pointer to store the channels of the loaded image.
+ * @param stride    pointer to store the row stride of the loaded image.
+ * @param image     pointer to a memory buffer storing the pixel data of the
+ *                  loaded image. This buffer is allocated in Imread()
+ *                  according to the height and stride of the image.
+ * @param scale     denominator of the size, the image is decoded into
+ *                  ceil(height / scale) x ceil(width / scale) pixels.
+ * @return The execution status, succeeds or fails with an error code.
+ *         RC_UNSUPPORTED is returned when scale is not 1 and the file is not
+ *         a JPEG image.
+ * @note 1 The valid values of scale are 1, 2, 4 and 8.
+ *       2 JPEG images are scaled in the inverse DCT, which transforms each
+ *         8x8 block into 4x4, 2x2 or 1x1 pixels, and the chroma of subsampled
+ *         images is not upsampled as far, so it is much faster than decoding
+ *         at the full size and resizing. Each pixel approximates the average
+ *         of the scale x scale pixels it covers in the full size image.
+ *       3 Other notes are the same as Imread() without scale.
+ * @warning All input parameters must be valid, or undefined behaviour may occur.
+ * @remark
+ * <caption align="left">Requirements</caption>
+ * <tr><td>x86 platforms supported<td> All
+ * <tr><td>Header files<td> #include &lt;ppl/cv/x86/imread.h&gt;
+ * <tr><td>Project<td> ppl.cv
+ * @since ppl.cv-v0.7.0
+ * ###Example
+ * @code{.cpp}
+ * #include "ppl/cv/x86/imread.h"
+ *
+ * int32_t main(int32_t argc, char** argv) {
+ *     char file_name[] = "test.jpg";
+ *     int height, width, channels, stride;
+ *     uchar* image;
+ *
+ *     ppl::cv::x86::Imread(file_name, &height, &width, &channels, &stride,
+ *                          &image, 4);
+ *
+ *     free(image);
+ *
+ *     return 0;
+ * }
+ * @endcode
+ ******************************************************************************/
+::ppl::common::RetCode Imread(const char* fileName,
+                              int* height,
+                              int* width,
+                              int* channels,
+                              int* stride,
+                              uchar** image,
+                              int scale);
+
+/**
+ * @brief Decodes an image from a memory buffer.
+ * @param data      pointer to the encoded image, e.g. the content of a bmp,
+ *                  jpeg or png file.
+ * @param size      the number of bytes in data.
+ * @param height    pointer to store the height of the decoded image.
+ * @param width     pointer to store the width of the decoded image.
+ * @param channels  pointer to store the channels of the decoded image.
+ * @param stride    pointer to store the row stride of the decoded image.
+ * @param image     pointer to a memory buffer storing the pixel data of the
+ *                  decoded image. This buffer is allocated in Imdecode()
+ *                  according to the height and stride of the image.
+ * @return The execution status, succeeds or fails with an error code.
+ * @note 1 data is read in place, it is neither copied nor modified.
+ *       2 Supported formats and the layout of the decoded data are the same
+ *         as Imread().
+ *       3 size must be less than 4GB.
+ *       4 image[] must be freed when unused.
+ * @warning All input parameters must be valid, or undefined behaviour may occur.
+ * @remark
+ * <caption align="left">Requirements</caption>
+ * <tr><td>x86 platforms supported<td> All
+ * <tr><td>Header files<td> #include &lt;ppl/cv/x86/imread.h&gt;
+ * <tr><td>Project<td> ppl.cv
+ * @since ppl.cv-v0.7.0
+ * ###Example
+ * @code{.cpp}
+ * #include "ppl/cv/x86/imread.h"
+ *
+ * void decode(const uchar* data, size_t size) {
+ *     int height, width, channels, stride;
+ *     uchar* image;
+ *
+ *     ppl::cv::x86::Imdecode(data, size, &height, &width, &channels, &stride,
+ *                            &image);
+ *
+ *     free(image);
+ * }
+ * @endcode
+ ******************************************************************************/
+::ppl::common::RetCode Imdecode(const uchar* data,
+                                size_t size,
+                                int* height,
+                                int* width,
+                                int* channels,
+                                int* stride,
+                                uchar** image);
+
+/**
+ * @brief Decodes an image from a memory buffer at a reduced size.
+ * @param data      pointer to the encoded image, e.g. the content of a bmp,
+ *                  jpeg or png file.
+ * @param size      the number of bytes in data.
+ * @param height    pointer to store the height of the decoded image.
+ * @param width     pointer to store the width of the decoded image.
+ * @param channels  pointer to store the channels of the decoded image.
+ * @param stride    pointer to store the row stride of the decoded image.
+ * @param image     pointer to a memory buffer storing the pixel data of the
+ *                  decoded image. This buffer is allocated in Imdecode()
+ *                  according to the height and stride of the image.
+ * @param scale     denominator of the size, the image is decoded into
+ *                  ceil(height / scale) x ceil(width / scale) pixels.
+ * @return The execution status, succeeds or fails with an error code.
+ *         RC_UNSUPPORTED is returned when scale is not 1 and data is not a
+ *         JPEG image.
+ * @note 1 scale is the same as that of Imread().
+ *       2 Other notes are the same as Imdecode() without scale.
+ * @warning All input parameters must be valid, or undefined behaviour may occur.
+ * @remark
+ * <caption align="left">Requirements</caption>
+ * <tr><td>x86 platforms supported<td> All
+ * <tr><td>Header files<td> #include &lt;ppl/cv/x86/imread.h&gt;
+ * <tr><td>Project<td> ppl.cv
+ * @since ppl.cv-v0.7.0
+ * ###Example
+ * @code{.cpp}
+ * #include "ppl/cv/x86/imread.h"
+ *
+ * void decodeThumbnail(const uchar* data, size_t size) {
+ *     int height, width, channels, stride;
+ *     uchar* image;
+ *
+ *     ppl::cv::x86::Imdecode(data, size, &height, &width, &channels, &stride,
+ *                            &image, 8);
+ *
+ *     free(image);
+ * }
+ * @endcode
+ ******************************************************************************/
+::ppl::common::RetCode Imdecode(const uchar* data,
+                                size_t size,
+                                int* height,
+                                int* width,
+                                int* channels,
+                                int* stride,
+                                uchar** image,
+                                int scale);
+
+/**
+ * @brief Decodes an image from a memory buffer into a caller-supplied buffer.
+ * @param data      pointer to the encoded image, e.g. the content of a bmp,
+ *                  jpeg or png file.
+ * @param size      the number of bytes in data.
+ * @param height    pointer to store the height of the decoded image.
+ * @param width     pointer to store the width of the decoded image.
+ * @param channels  pointer to store the channels of the decoded image.
+ * @param stride    row stride of image in bytes.
+ * @param image     output buffer of the pixel data.
+ * @param imageSize the number of bytes in image.
+ * @return The execution status, succeeds or fails with an error code.
+ *         RC_INVALID_VALUE is returned when image can't hold the decoded
+ *         image, height, width and channels are still filled in then.
+ * @note 1 data is read in place, it is neither copied nor modified.
+ *       2 Supported formats and the layout of the decoded data are the same
+ *         as Imread(), png images must have at most 8 bits per channel.
+ *       3 stride must be not less than width * channels.
+ *       4 Png images are decoded in place when image is 16-byte aligned and
+ *         stride is a multiple of 16 not less than the stride returned by
+ *         Imread(), otherwise they are decoded into a temporary buffer and
+ *         copied to image.
+ * @warning All input parameters must be valid, or undefined behaviour may occur.
+ * @remark
+ * <caption align="left">Requirements</caption>
+ * <tr><td>x86 platforms supported<td> All
+ * <tr><td>Header files<td> #include &lt;ppl/cv/x86/imread.h&gt;
+ * <tr><td>Project<td> ppl.cv
+ * @since ppl.cv-v0.7.0
+ * ###Example
+ * @code{.cpp}
+ * #include "ppl/cv/x86/imread.h"
+ *
+ * void decode(const uchar* data, size_t size) {
+ *     int height, width, channels;
+ *     int stride = 1920 * 3;
+ *     uchar* image = (uchar*)malloc(stride * 1080);
+ *
+ *     ppl::cv::x86::Imdecode(data, size, &height, &width, &channels, stride,
+ *                            image, stride * 1080);
+ *
+ *     free(image);
+ * }
+ * @endcode
+ ******************************************************************************/
+::ppl::common::RetCode Imdecode(const uchar* data,
+                                size_t size,
+                                int* height,
+                                int* width,
+                                int* channels,
+                                int stride,
+                                uchar* image,
+                                size_t imageSize);
+
+/**
+ * @brief Decodes an image from a memory buffer at a reduced size into a
+ *        caller-supplied buffer.
+ * @param data      pointer to the encoded image, e.g. the content of a bmp,
+ *                  jpeg or png file.
+ * @param size      the number of bytes in data.
+ * @param height    pointer to store the height of the decoded image.
+ * @param width     pointer to store the width of the decoded image.
+ * @param channels  pointer to store the channels of the decoded image.
+ * @param stride    row stride of image in bytes.
+ * @param image     output buffer of the pixel data.
+ * @param imageSize the number of bytes in image.
+ * @param scale     denominator of the size, the image is decoded into
+ *                  ceil(height / scale) x ceil(width / scale) pixels.
+ * @return The execution status, succeeds or fails with an error code.
+ *         RC_INVALID_VALUE is returned when image can't hold the decoded
+ *         image, RC_UNSUPPORTED is returned when scale is not 1 and data is
+ *         not a JPEG image.
+ * @note 1 scale is the same as that of Imread().
+ *       2 Other notes are the same as Imdecode() without scale.
+ * @warning All input parameters must be valid, or undefined behaviour may occur.
+ * @remark
+ * <caption align="left">Requirements</caption>
+ * <tr><td>x86 platforms supported<td> All
+ * <tr><td>Header files<td> #include &lt;ppl/cv/x86/imread.h&gt;
+ * <tr><td>Project<td> ppl.cv
+ * @since ppl.cv-v0.7.0
+ * ###Example
+ * @code{.cpp}
+ * #include "ppl/cv/x86/imread.h"
+ *
+ * void decodeThumbnail(const uchar* data, size_t size) {
+ *     int height, width, channels;
+ *     int stride = 480 * 3;
+ *     uchar* image = (uchar*)malloc(stride * 270);
+ *
+ *     // a 1920x1080 jpeg image is decoded into 480x270 pixels.
+ *     ppl::cv::x86::Imdecode(data, size, &height, &width, &channels, stride,
+ *                            image, stride * 270, 4);
+ *
+ *     free(image);
+ * }
+ * @endcode
+ ******************************************************************************/
+::ppl::common::RetCode Imdecode(const uchar* data,
+                                size_t size,
+                                int* height,
+                                int* width,
+                                int* channels,
+                                int stride,
+                                uchar* image,
+                                size_t imageSize,
+                                int scale);
+
+/**
+ * @brief Loads a region of interest of an image from a file.
+ * @param fileName  name of file to be loaded.
+ * @param top       the row of the top left corner of the region.
+ * @param left      the column of the top left corner of the region.
+ * @param height    the height of the region.
+ * @param width     the width of the region.
+ * @param channels  pointer to store the channels of the loaded image.
+ * @param stride    pointer to store the row stride of the loaded image.
+ * @param image     pointer to a memory buffer storing the pixel data of the
+ *                  region. This buffer is allocated in ImreadRoi() according
+ *                  to height and the stride of the region.
+ * @return The execution status, succeeds or fails with an error code.
+ *         RC_INVALID_VALUE is returned when the region is not inside the
+ *         image.
+ * @note 1 The result is the same as cropping the region out of the image
+ *         loaded by Imread().
+ *       2 JPEG images are decoded around the region only. The entropy-coded
+ *         data after the region is not decoded, and when the image has
+ *         restart markers, neither are the restart intervals out of the
+ *         region. The inverse DCT and the color conversion run on the mcus
+ *         of the region and a margin of an mcu around it.
+ *       3 Other formats are decoded in whole and the region is copied.
+ *       4 image[] must be freed when unused.
+ * @warning All input parameters must be valid, or undefined behaviour may occur.
+ * @remark
+ * <caption align="left">Requirements</caption>
+ * <tr><td>x86 platforms supported<td> All
+ * <tr><td>Header files<td> #include &lt;ppl/cv/x86/imread.h&gt;
+ * <tr><td>Project<td> ppl.cv
+ * @since ppl.cv-v0.7.0
+ * ###Example
+ * @code{.cpp}
+ * #include "ppl/cv/x86/imread.h"
+ *
+ * int32_t main(int32_t argc, char** argv) {
+ *     char file_name[] = "test.jpg";
+ *     int channels, stride;
+ *     uchar* image;
+ *
+ *     // the 64x128 region whose top left corner is at (100, 200).
+ *     ppl::cv::x86::ImreadRoi(file_name, 100, 200, 64, 128, &channels,
+ *                             &stride, &image);
+ *
+ *     free(image);
+ *
+ *     return 0;
+ * }
+ * @endcode
+ ******************************************************************************/
+::ppl::common::RetCode ImreadRoi(const char* fileName,
+                                 int top,
+                                 int left,
+                                 int height,
+                                 int width,
+                                 int* channels,
+                                 int* stride,
+                                 uchar** image);
+
+/**
+ * @brief Decodes a region of interest of an image from a memory buffer.
+ * @param data      pointer to the encoded image, e.g. the content of a bmp,
+ *                  jpeg or png file.
+ * @param size      the number of bytes in data.
+ * @param top       the row of the top left corner of the region.
+ * @param left      the column of the top left corner of the region.
+ * @param height    the height of the region.
+ * @param width     the width of the region.
+ * @param channels  pointer to store the channels of the decoded image.
+ * @param stride    pointer to store the row stride of the decoded image.
+ * @param image     pointer to a memory buffer storing the pixel data of the
+ *                  region. This buffer is allocated in ImdecodeRoi()
+ *                  according to height and the stride of the region.
+ * @return The execution status, succeeds or fails with an error code.
+ *         RC_INVALID_VALUE is returned when the region is not inside the
+ *         image.
+ * @note 1 data is read in place, it is neither copied nor modified.
+ *       2 Other notes are the same as ImreadRoi().
+ * @warning All input parameters must be valid, or undefined behaviour may occur.
+ * @remark
+ * <caption align="left">Requirements</caption>
+ * <tr><td>x86 platforms supported<td> All
+ * <tr><td>Header files<td> #include &lt;ppl/cv/x86/imread.h&gt;
+ * <tr><td>Project<td> ppl.cv
+ * @since ppl.cv-v0.7.0
+ * ###Example
+ * @code{.cpp}
+ * #include "ppl/cv/x86/imread.h"
+ *
+ * void decodeFace(const uchar* data, size_t size, int top, int left,
+ *                 int height, int width) {
+ *     int channels, stride;
+ *     uchar* image;
+ *
+ *     ppl::cv::x86::ImdecodeRoi(data, size, top, left, height, width,
+ *                               &channels, &stride, &image);
+ *
+ *     free(image);
+ * }
+ * @endcode
+ ******************************************************************************/
+::ppl::common::RetCode ImdecodeRoi(const uchar* data,
+                                   size_t size,
+                                   int top,
+                                   int left,
+                                   int height,
+                                   int width,
+                                   int* channels,
+                                   int* stride,
+                                   uchar** image);
+
+/**
+ * @brief Decodes a region of interest of an image from a memory buffer into
+ *        a caller-supplied buffer.
+ * @param data      pointer to the encoded image, e.g. the content of a bmp,
+ *                  jpeg or png file.
+ * @param size      the number of bytes in data.
+ * @param top       the row of the top left corner of the region.
+ * @param left      the column of the top left corner of the region.
+ * @param height    the height of the region.
+ * @param width     the width of the region.
+ * @param channels  pointer to store the channels of the decoded image.
+ * @param stride    row stride of image in bytes.
+ * @param image     output buffer of the pixel data.
+ * @param imageSize the number of bytes in image.
+ * @return The execution status, succeeds or fails with an error code.
+ *         RC_INVALID_VALUE is returned when the region is not inside the
+ *         image or image can't hold it.
+ * @note 1 data is read in place, it is neither copied nor modified.
+ *       2 stride must be not less than width * channels.
+ *       3 Other notes are the same as ImreadRoi().
+ * @warning All input parameters must be valid, or undefined behaviour may occur.
+ * @remark
+ * <caption align="left">Requirements</caption>
+ * <tr><td>x86 platforms supported<td> All
+ * <tr><td>Header files<td> #include &lt;ppl/cv/x86/imread.h&gt;
+ * <tr><td>Project<td> ppl.cv
+ * @since ppl.cv-v0.7.0
+ * ###Example
+ * @code{.cpp}
+ * #include "ppl/cv/x86/imread.h"
+ *
+ * void decodeTile(const uchar* data, size_t size, int row, int col) {
+ *     int channels;
+ *     int stride = 256 * 3;
+ *     uchar* image = (uchar*)malloc(stride * 256);
+ *
+ *     ppl::cv::x86::ImdecodeRoi(data, size, row * 256, col * 256, 256, 256,
+ *                               &channels, stride, image, stride * 256);
+ *
+ *     free(image);
+ * }
+ * @endcode
+ ******************************************************************************/
+::ppl::common::RetCode ImdecodeRoi(const uchar* data,
+                                   size_t size,
+                                   int top,
+                                   int left,
+                                   int height,
+                                   int width,
+                                   int* channels,
+                                   int stride,
+                                   uchar* image,
+                                   size_t imageSize);
+
+/**
+ * @brief Reads the dimensions of an image file without decoding it.
+ * @param fileName  name of file to be probed.
+ * @param height    pointer to store the height of the image.
+ * @param width     pointer to store the width of the image.
+ * @param channels  pointer to store the channels of the decoded image.
+ * @param depth     pointer to store the bits per channel of the decoded image,
+ *                  always 8, png images of 16 bits per channel are
+ *                  rejected.
+ * @param stride    pointer to store the row stride Imread() allocates the
+ *                  image with.
+ * @return The execution status, succeeds or fails with an error code.
+ * @note 1 Only the file header is parsed, the pixel data is neither read nor
+ *         decoded, so it takes microseconds whatever the size of the image.
+ *       2 The results are those Imread() returns for the same file, so they
+ *         can size the buffer of Imdecode() with a caller-supplied buffer.
+ * @warning All input parameters must be valid, or undefined behaviour may occur.
+ * @remark
+ * <caption align="left">Requirements</caption>
+ * <tr><td>x86 platforms supported<td> All
+ * <tr><td>Header files<td> #include &lt;ppl/cv/x86/imread.h&gt;
+ * <tr><td>Project<td> ppl.cv
+ * @since ppl.cv-v0.7.0
+ * ###Example
+ * @code{.cpp}
+ * #include "ppl/cv/x86/imread.h"
+ *
+ * int32_t main(int32_t argc, char** argv) {
+ *     char file_name[] = "test.png";
+ *     int height, width, channels, depth, stride;
+ *
+ *     ppl::cv::x86::ImreadInfo(file_name, &height, &width, &channels, &depth,
+ *                              &stride);
+ *
+ *     return 0;
+ * }
+ * @endcode
+ ******************************************************************************/
+::ppl::common::RetCode ImreadInfo(const char* fileName,
+                                  int* height,
+                                  int* width,
+                                  int* channels,
+                                  int* depth,
+                                  int* stride);
+
+/**
+ * @brief Reads the dimensions of an image in a memory buffer without decoding
+ *        it.
+ * @param data      pointer to the encoded image, e.g. the content of a bmp,
+ *                  jpeg or png file.
+ * @param size      the number of bytes in data.
+ * @param height    pointer to store the height of the image.
+ * @param width     pointer to store the width of the image.
+ * @param channels  pointer to store the channels of the decoded image.
+ * @param depth     pointer to store the bits per channel of the decoded image,
+ *                  always 8, png images of 16 bits per channel are
+ *                  rejected.
+ * @param stride    pointer to store the row stride Imdecode() allocates the
+ *                  image with.
+ * @return The execution status, succeeds or fails with an error code.
+ * @note 1 Only the header is parsed, data is read in place.
+ *       2 size must be less than 4GB.
+ * @warning All input parameters must be valid, or undefined behaviour may occur.
+ * @remark
+ * <caption align="left">Requirements</caption>
+ * <tr><td>x86 platforms supported<td> All
+ * <tr><td>Header files<td> #include &lt;ppl/cv/x86/imread.h&gt;
+ * <tr><td>Project<td> ppl.cv
+ * @since ppl.cv-v0.7.0
+ * ###Example
+ * @code{.cpp}
+ * #include "ppl/cv/x86/imread.h"
+ *
+ * void decode(const uchar* data, size_t size) {
+ *     int height, width, channels, depth, stride;
+ *     ppl::cv::x86::ImdecodeInfo(data, size, &height, &width, &channels,
+ *                                &depth, &stride);
+ *
+ *     uchar* image = (uchar*)malloc((size_t)stride * height);
+ *     ppl::cv::x86::Imdecode(data, size, &height, &width, &channels, stride,
+ *                            image, (size_t)stride * height);
+ *
+ *     free(image);
+ * }
+ * @endcode
+ ******************************************************************************/
+::ppl::common::RetCode ImdecodeInfo(const uchar* data,
+                                    size_t size,
+                                    int* height,
+                                    int* width,
+                                    int* channels,
+                                    int* depth,
+                                    int* stride);
+
+/**
+ * @brief Sets the number of threads the Imread and Imdecode functions use.
+ * @param numThreads  the maximal number of threads decoding an image. 0
+ *                    restores the default, which follows SetNumThreads();
+ *                    1 decodes on the calling thread.
+ * @return The execution status, succeeds or fails with an error code.
+ * @note 1 The idct of jpeg images runs in bands of block rows on the worker
+ *         pool of SetNumThreads(), no thread is created per call.
+ *       2 Images smaller than about 64K pixels per component, and calls made
+ *         while the pool is busy, e.g. from the decoding threads of a
+ *         service, are decoded on the calling thread whatever the setting.
+ *       3 The setting is process wide.
+ * @warning All input parameters must be valid, or undefined behaviour may occur.
+ * @remark
+ * <caption align="left">Requirements</caption>
+ * <tr><td>x86 platforms supported<td> All
+ * <tr><td>Header files<td> #include &lt;ppl/cv/x86/imread.h&gt;
+ * <tr><td>Project<td> ppl.cv
+ * @since ppl.cv-v0.7.0
+ * ###Example
+ * @code{.cpp}
+ * #include "ppl/cv/x86/imread.h"
+ *
+ * int32_t main(int32_t argc, char** argv) {
+ *     // one decoding worker per core, each decodes on its own thread.
+ *     ppl::cv::x86::SetImdecodeNumThreads(1);
+ *
+ *     return 0;
+ * }
+ * @endcode
+ ******************************************************************************/
+::ppl::common::RetCode SetImdecodeNumThreads(int numThreads);
+
+/**
+ * @brief Gets the number of threads the Imread and Imdecode functions use.
+ * @return The number set by SetImdecodeNumThreads(), or GetNumThreads() by
+ *         default.
+ * @remark
+ * <caption align="left">Requirements</caption>
+ * <tr><td>x86 platforms supported<td> All
+ * <tr><td>Header files<td> #include &lt;ppl/cv/x86/imread.h&gt;
+ * <tr><td>Project<td> ppl.cv
+ * @since ppl.cv-v0.7.0
+ ******************************************************************************/
+int GetImdecodeNumThreads();
+
+/**
+ * @brief Sets whether the Imread and Imdecode functions verify the checksums
+ *        of png images.
+ * @param verify  true checks the CRC32 of every chunk and the ADLER32 of the
+ *                zlib stream, the default; false skips both for trusted
+ *                inputs.
+ * @return The execution status, succeeds or fails with an error code.
+ * @note 1 A corrupt image decoded without verification may come out with
+ *         wrong pixels, but no memory out of the image is touched.
+ *       2 The setting is process wide.
+ * @remark
+ * <caption align="left">Requirements</caption>
+ * <tr><td>x86 platforms supported<td> All
+ * <tr><td>Header files<td> #include &lt;ppl/cv/x86/imread.h&gt;
+ * <tr><td>Project<td> ppl.cv
+ * @since ppl.cv-v0.7.0
+ * ###Example
+ * @code{.cpp}
+ * #include "ppl/cv/x86/imread.h"
+ *
+ * int32_t main(int32_t argc, char** argv) {
+ *     // the images come from our own encoder.
+ *     ppl::cv::x86::SetImdecodeVerifyChecksums(false);
+ *
+ *     return 0;
+ * }
+ * @endcode
+ ******************************************************************************/
+::ppl::common::RetCode SetImdecodeVerifyChecksums(bool verify);
+
+/**
+ * @brief Gets whether the Imread and Imdecode functions verify the checksums
+ *        of png images.
+ * @return The value set by SetImdecodeVerifyChecksums(), or true by default.
+ * @remark
+ * <caption align="left">Requirements</caption>
+ * <tr><td>x86 platforms supported<td> All
+ * <tr><td>Header files<td> #include &lt;ppl/cv/x86/imread.h&gt;
+ * <tr><td>Project<td> ppl.cv
+ * @since ppl.cv-v0.7.0
+ ******************************************************************************/
+bool GetImdecodeVerifyChecksums();
+
 } //! namespace x86
 } //! namespace cv
 } //! namespace ppl
@@ -0,0 +1,200 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#ifndef __ST_HPC_PPL_CV_X86_IMWRITE_H_
+#define __ST_HPC_PPL_CV_X86_IMWRITE_H_
+
+#include "ppl/cv/types.h"
+
+#include "ppl/common/retcode.h"
+
+namespace ppl {
+namespace cv {
+namespace x86 {
+
+/**
+ * \brief
+ * Keys of the encoding parameters, which are given to Imwrite() and
+ * Imencode() as key and value pairs. The values follow the ones of OpenCV.
+ */
+enum ImwriteFlags {
+    IMWRITE_JPEG_QUALITY = 1, //!< 0-100, 95 by default, the higher the better
+    IMWRITE_JPEG_SAMPLING_FACTOR = 7, //!< one of ImwriteJpegSamplingFactors, IMWRITE_JPEG_SAMPLING_FACTOR_420 by default
+    IMWRITE_PNG_COMPRESSION = 16, //!< 0-9, 1 by default. 0 stores the data, 1 only encodes runs at near raw speed, 2-9 search back references ever harder
+};
+
+/**
+ * \brief
+ * Chroma subsampling of jpeg, the values of IMWRITE_JPEG_SAMPLING_FACTOR.
+ */
+enum ImwriteJpegSamplingFactors {
+    IMWRITE_JPEG_SAMPLING_FACTOR_420 = 0x221111, //!< 4:2:0, Cb and Cr are halved in both directions
+    IMWRITE_JPEG_SAMPLING_FACTOR_422 = 0x211111, //!< 4:2:2, Cb and Cr are halved horizontally
+    IMWRITE_JPEG_SAMPLING_FACTOR_444 = 0x111111, //!< 4:4:4, no subsampling
+};
+
+/**
+ * @brief Saves an image to a file.
+ * @tparam T The data type of the image, currently only \a uint8_t(uchar) and \a uint16_t are supported, jpeg only takes \a uint8_t.
+ * @param fileName     name of the file to be saved, the extension decides the
+ *                     format.
+ * @param height       height of the image.
+ * @param width        width of the image.
+ * @param channels     channels of the image.
+ * @param stride       the width stride of the image, similar to
+ *                     width * channels.
+ * @param image        pixel data of the image.
+ * @param paramsNumber number of the elements in params.
+ * @param params       key and value pairs of ImwriteFlags, nullptr when
+ *                     paramsNumber is 0.
+ * @return The execution status, succeeds or fails with an error code.
+ *         RC_UNSUPPORTED is returned when the extension is not .png,
+ *         .jpg or .jpeg, or a uint16_t image is saved as jpeg.
+ * @note 1 Portable network graphics(*.png) and baseline JPEG files(*.jpg,
+ *         *.jpeg) are supported for now.
+ *       2 1, 3 and 4 channels are supported, color images are in
+ *         B G R / B G R A order, as Imread() decodes them.
+ *       3 For png, each row is filtered with the one of the
+ *         Sub/Up/Average/Paeth filters which leaves the smallest residuals,
+ *         then deflated.
+ *       4 For jpeg, color images are converted to full-range YCbCr of JFIF
+ *         and the alpha channel is dropped, the huffman tables are optimized
+ *         for each image.
+ *       5 Keys of other formats in params are ignored.
+ * @warning All input parameters must be valid, or undefined behaviour may occur.
+ * @remark
+ * <caption align="left">Requirements</caption>
+ * <tr><td>x86 platforms supported<td> All
+ * <tr><td>Header files<td> #include &lt;ppl/cv/x86/imwrite.h&gt;
+ * <tr><td>Project<td> ppl.cv
+ * @since ppl.cv-v0.7.0
+ * ###Example
+ * @code{.cpp}
+ * #include "ppl/cv/x86/imwrite.h"
+ *
+ * int32_t main(int32_t argc, char** argv) {
+ *     int height = 480, width = 640, channels = 1;
+ *     uint8_t* mask = (uint8_t*)malloc(height * width);
+ *     memset(mask, 0, height * width);
+ *
+ *     int params[] = {ppl::cv::x86::IMWRITE_PNG_COMPRESSION, 1};
+ *     ppl::cv::x86::Imwrite<uint8_t>("mask.png", height, width, channels,
+ *                                    width, mask, 2, params);
+ *
+ *     free(mask);
+ *
+ *     return 0;
+ * }
+ * @endcode
+ ******************************************************************************/
+template <typename T>
+::ppl::common::RetCode Imwrite(const char* fileName,
+                               int height,
+                               int width,
+                               int channels,
+                               int stride,
+                               const T* image,
+                               int paramsNumber,
+                               const int* params);
+
+/**
+ * @brief Saves an image to a file with the default parameters.
+ * @tparam T The data type of the image, currently only \a uint8_t(uchar) and \a uint16_t are supported, jpeg only takes \a uint8_t.
+ * @param fileName  name of the file to be saved, the extension decides the
+ *                  format.
+ * @param height    height of the image.
+ * @param width     width of the image.
+ * @param channels  channels of the image.
+ * @param stride    the width stride of the image, similar to width * channels.
+ * @param image     pixel data of the image.
+ * @return The execution status, succeeds or fails with an error code.
+ * @note The notes are the same as Imwrite() with parameters.
+ * @warning All input parameters must be valid, or undefined behaviour may occur.
+ * @remark
+ * <caption align="left">Requirements</caption>
+ * <tr><td>x86 platforms supported<td> All
+ * <tr><td>Header files<td> #include &lt;ppl/cv/x86/imwrite.h&gt;
+ * <tr><td>Project<td> ppl.cv
+ * @since ppl.cv-v0.7.0
+ ******************************************************************************/
+template <typename T>
+::ppl::common::RetCode Imwrite(const char* fileName,
+                               int height,
+                               int width,
+                               int channels,
+                               int stride,
+                               const T* image);
+
+/**
+ * @brief Encodes an image into a memory buffer.
+ * @tparam T The data type of the image, currently only \a uint8_t(uchar) and \a uint16_t are supported, jpeg only takes \a uint8_t.
+ * @param format       the format of the encoded data.
+ * @param height       height of the image.
+ * @param width        width of the image.
+ * @param channels     channels of the image.
+ * @param stride       the width stride of the image, similar to
+ *                     width * channels.
+ * @param image        pixel data of the image.
+ * @param paramsNumber number of the elements in params.
+ * @param params       key and value pairs of ImwriteFlags, nullptr when
+ *                     paramsNumber is 0.
+ * @param size         pointer to store the size of the encoded data.
+ * @param data         pointer to a memory buffer storing the encoded data,
+ *                     which is allocated in Imencode().
+ * @return The execution status, succeeds or fails with an error code.
+ *         RC_UNSUPPORTED is returned when format is not PNG or JPEG, or a
+ *         uint16_t image is encoded into JPEG.
+ * @note 1 data[] must be freed when unused.
+ *       2 Other notes are the same as Imwrite().
+ * @warning All input parameters must be valid, or undefined behaviour may occur.
+ * @remark
+ * <caption align="left">Requirements</caption>
+ * <tr><td>x86 platforms supported<td> All
+ * <tr><td>Header files<td> #include &lt;ppl/cv/x86/imwrite.h&gt;
+ * <tr><td>Project<td> ppl.cv
+ * @since ppl.cv-v0.7.0
+ * ###Example
+ * @code{.cpp}
+ * #include "ppl/cv/x86/imwrite.h"
+ *
+ * void encode(const uint16_t* depth, int height, int width) {
+ *     size_t size;
+ *     uchar* data;
+ *     ppl::cv::x86::Imencode<uint16_t>(ppl::cv::PNG, height, width, 1, width,
+ *                                      depth, 0, nullptr, &size, &data);
+ *
+ *     free(data);
+ * }
+ * @endcode
+ ******************************************************************************/
+template <typename T>
+::ppl::common::RetCode Imencode(ImageFormats format,
+                                int height,
+                                int width,
+                                int channels,
+                                int stride,
+                                const T* image,
+                                int paramsNumber,
+                                const int* params,
+                                size_t* size,
+                                uchar** data);
+
+} //! namespace x86
+} //! namespace cv
+} //! namespace ppl
+
+#endif //! __ST_HPC_PPL_CV_X86_IMWRITE_H_
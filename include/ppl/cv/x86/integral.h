@@ -106,6 +106,86 @@ template <typename TSrc, typename TDst, int32_t numChannels>
     int32_t outWidthStride,
     TDst *outData);
 
+/**
+ * @brief Calculates the integral, the squared integral and the tilted integral of an image in one pass.
+ * @tparam TSrc The data type of input image, currently only \a uint8_t and \a float are supported.
+ * @tparam TDst The data type of the integral and the tilted integral, \a int32_t for \a uint8_t input and \a float for \a float input.
+ * @tparam numChannels The number of channels of input image, 1, 3 and 4 are supported.
+ * @param inHeight              input image's height
+ * @param inWidth               input image's width need to be processed
+ * @param inWidthStride         input image's width stride, usually it equals to `width * channels`
+ * @param inData                input image data
+ * @param outHeight             output images' height, must be inHeight + 1
+ * @param outWidth              output images' width, must be inWidth + 1
+ * @param outWidthStride        the width stride of the integral, usually it equals to `outWidth * channels`
+ * @param outData               the integral
+ * @param outSqWidthStride      the width stride of the squared integral
+ * @param outSqData             the integral of the squared pixel values, or nullptr if not needed
+ * @param outTiltedWidthStride  the width stride of the tilted integral
+ * @param outTiltedData         the integral of the image rotated by 45 degrees, or nullptr if not needed
+ * @warning All input parameters must be valid, or undefined behaviour may occur.
+ * @note 1 All outputs use the layout of version 2 above and are compatible with
+ *         integral(src, sum, sqsum, tilted, sdepth, CV_64F) in OpenCV 4.1.
+ *       2 The tilted integral at (X, Y) is the sum of the pixels (x, y) with
+ *         y < Y and |x - X + 1| <= Y - y - 1.
+ *       3 The squared integral is stored in double, which is exact for
+ *         uint8_t images of up to 2^53 / 255^2 pixels.
+ * @remark The fllowing table show which data type and channels are supported.
+ * <table>
+ * <tr><th>TSrc type<th>TDst type<th>channels
+ * <tr><td>float<td>float<td>1
+ * <tr><td>float<td>float<td>3
+ * <tr><td>float<td>float<td>4
+ * <tr><td>uint8_t<td>int32_t<td>1
+ * <tr><td>uint8_t<td>int32_t<td>3
+ * <tr><td>uint8_t<td>int32_t<td>4
+ * </table>
+ * <table>
+ * <caption align="left">Requirements</caption>
+ * <tr><td>X86 platforms supported<td> All
+ * <tr><td>Header files<td> #include &lt;ppl/cv/x86/integral.h&gt;
+ * <tr><td>Project<td> ppl.cv
+ * @since ppl.cv-v0.7.0
+ * ###Example
+ * @code{.cpp}
+ * #include <ppl/cv/x86/integral.h>
+ * int32_t main(int32_t argc, char** argv) {
+ *     const int32_t inW = 640;
+ *     const int32_t inH = 480;
+ *     const int32_t outW = inW + 1;
+ *     const int32_t outH = inH + 1;
+ *     uint8_t* dev_iImage = (uint8_t*)malloc(inW * inH * sizeof(uint8_t));
+ *     int32_t* dev_sum = (int32_t*)malloc(outW * outH * sizeof(int32_t));
+ *     double* dev_sqsum = (double*)malloc(outW * outH * sizeof(double));
+ *     int32_t* dev_tilted = (int32_t*)malloc(outW * outH * sizeof(int32_t));
+ *
+ *     ppl::cv::x86::Integral<uint8_t, int32_t, 1>(inH, inW, inW, dev_iImage,
+ *         outH, outW, outW, dev_sum, outW, dev_sqsum, outW, dev_tilted);
+ *
+ *     free(dev_iImage);
+ *     free(dev_sum);
+ *     free(dev_sqsum);
+ *     free(dev_tilted);
+ *     return 0;
+ * }
+ * @endcode
+ ***************************************************************************************************/
+
+template <typename TSrc, typename TDst, int32_t numChannels>
+::ppl::common::RetCode Integral(
+    int32_t inHeight,
+    int32_t inWidth,
+    int32_t inWidthStride,
+    const TSrc *inData,
+    int32_t outHeight,
+    int32_t outWidth,
+    int32_t outWidthStride,
+    TDst *outData,
+    int32_t outSqWidthStride,
+    double *outSqData,
+    int32_t outTiltedWidthStride,
+    TDst *outTiltedData);
+
 }
 }
 } // namespace ppl::cv::x86
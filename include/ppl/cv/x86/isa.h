@@ -0,0 +1,77 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#ifndef __ST_HPC_PPL_CV_X86_ISA_H_
+#define __ST_HPC_PPL_CV_X86_ISA_H_
+
+#include "ppl/common/retcode.h"
+#include "ppl/cv/types.h"
+
+namespace ppl {
+namespace cv {
+namespace x86 {
+
+/**
+ * @brief Restricts the instruction sets the x86 kernels may dispatch to.
+ * @param isa_mask   bitwise OR of ppl::common::ISA_X86_* flags the kernels are
+ *                   allowed to use. A kernel tier is selected only when every
+ *                   flag it needs is in the mask and supported by the cpu.
+ *                   0xffffffff, the default, allows everything the cpu has.
+ * @return The execution status, succeeds or fails with an error code.
+ * @note 1 Kernels try AVX-512, then FMA/AVX2, then AVX, and fall back to SSE,
+ *         which is always allowed whatever the mask.
+ *       2 Useful to compare tiers, or to keep a process off AVX-512 where the
+ *         frequency drop costs more than the wider vectors win.
+ *       3 The setting is process wide. ResizePlan and other objects that pick
+ *         a kernel at construction keep the tier they were created with.
+ * @warning All input parameters must be valid, or undefined behaviour may occur.
+ * @remark
+ * <table>
+ * <caption align="left">Requirements</caption>
+ * <tr><td>X86 platforms supported<td> All
+ * <tr><td>Header files<td> #include &lt;ppl/cv/x86/isa.h&gt;
+ * <tr><td>Project<td> ppl.cv
+ * @since ppl.cv-v0.7.0
+ * ###Example
+ * @code{.cpp}
+ * #include <ppl/cv/x86/isa.h>
+ * int32_t main(int32_t argc, char** argv) {
+ *     // stay on AVX2
+ *     ppl::cv::x86::SetIsaMask(~(uint32_t)ppl::common::ISA_X86_AVX512);
+ *     return 0;
+ * }
+ * @endcode
+ ***************************************************************************************************/
+::ppl::common::RetCode SetIsaMask(uint32_t isa_mask);
+
+/**
+ * @brief Gets the instruction set mask set by SetIsaMask().
+ * @return The current mask, 0xffffffff by default.
+ * @remark
+ * <table>
+ * <caption align="left">Requirements</caption>
+ * <tr><td>X86 platforms supported<td> All
+ * <tr><td>Header files<td> #include &lt;ppl/cv/x86/isa.h&gt;
+ * <tr><td>Project<td> ppl.cv
+ * @since ppl.cv-v0.7.0
+ ***************************************************************************************************/
+uint32_t GetIsaMask();
+
+} // namespace x86
+} // namespace cv
+} // namespace ppl
+#endif //! __ST_HPC_PPL_CV_X86_ISA_H_
@@ -37,6 +37,9 @@ namespace x86 {
  * @param stddev            output parameter: calculateded standard deviation of each channel
  * @param maskStride        input mask's width stride,  usually it equals to `width`
  * @param mask              input mask data
+ * @note 1 uint8_t images are summed exactly in integers, float images in double.
+ *       2 Rows are reduced on the x86 worker pool, see SetNumThreads().
+ *       3 A mask which selects no pixel gives zero mean and stddev.
  * @warning All input parameters must be valid, or undefined behaviour may occur.
  * @remark The fllowing table show which data type and channels are supported.
  * <table>
@@ -37,6 +37,9 @@ namespace x86 {
  * @param outData           output image data
  * @param ksize             the length of kernel
  * @param border_type       ways to deal with border. BORDER_REFLECT_101 ,BORDER_REFLECT, BORDER_CONSTANT and BORDER_REPLICATE are supported now.
+ * @note uint8_t images are filtered with sorting networks when ksize is 3 or 5, and with
+ *       a histogram based algorithm whose cost per pixel does not depend on ksize otherwise.
+ *       ksize must be odd.
  * @warning All input parameters must be valid, or undefined behaviour may occur.
  * @remark The fllowing table show which data type and channels are supported.
  * <table>
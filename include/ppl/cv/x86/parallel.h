@@ -0,0 +1,76 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#ifndef __ST_HPC_PPL_CV_X86_PARALLEL_H_
+#define __ST_HPC_PPL_CV_X86_PARALLEL_H_
+
+#include "ppl/common/retcode.h"
+#include "ppl/cv/types.h"
+
+namespace ppl {
+namespace cv {
+namespace x86 {
+
+/**
+ * @brief Sets the number of threads used by the x86 kernels.
+ * @param num_threads   number of threads to use. 0 restores the default, which
+ *                      is the number of hardware threads; 1 runs every kernel
+ *                      on the calling thread.
+ * @return The execution status, succeeds or fails with an error code.
+ * @note 1 Kernels split their work into bands of rows and run each band on a
+ *         persistent worker pool, or on OpenMP threads when the library is
+ *         built with PPLCV_USE_OPENMP.
+ *       2 Small images and nested calls from inside a parallel region run on
+ *         the calling thread.
+ *       3 The setting is process wide.
+ * @warning All input parameters must be valid, or undefined behaviour may occur.
+ * @remark
+ * <table>
+ * <caption align="left">Requirements</caption>
+ * <tr><td>X86 platforms supported<td> All
+ * <tr><td>Header files<td> #include &lt;ppl/cv/x86/parallel.h&gt;
+ * <tr><td>Project<td> ppl.cv
+ * @since ppl.cv-v0.7.0
+ * ###Example
+ * @code{.cpp}
+ * #include <ppl/cv/x86/parallel.h>
+ * int32_t main(int32_t argc, char** argv) {
+ *     ppl::cv::x86::SetNumThreads(8);
+ *     return 0;
+ * }
+ * @endcode
+ ***************************************************************************************************/
+::ppl::common::RetCode SetNumThreads(int32_t num_threads);
+
+/**
+ * @brief Gets the number of threads used by the x86 kernels.
+ * @return The number of threads set by SetNumThreads(), or the number of
+ *         hardware threads by default.
+ * @remark
+ * <table>
+ * <caption align="left">Requirements</caption>
+ * <tr><td>X86 platforms supported<td> All
+ * <tr><td>Header files<td> #include &lt;ppl/cv/x86/parallel.h&gt;
+ * <tr><td>Project<td> ppl.cv
+ * @since ppl.cv-v0.7.0
+ ***************************************************************************************************/
+int32_t GetNumThreads();
+
+} // namespace x86
+} // namespace cv
+} // namespace ppl
+#endif //! __ST_HPC_PPL_CV_X86_PARALLEL_H_
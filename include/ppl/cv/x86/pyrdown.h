@@ -35,7 +35,7 @@ namespace x86 {
 * @param inData            input image data
 * @param outWidthStride    output image's width stride, usually it equals to `outWidth * nc`
 * @param outData           output image data
-* @param border_type       ways to deal with border. Only BORDER_REFLECT_101 or BORDER_DEFAULT are supported now.
+* @param border_type       ways to deal with border. BORDER_REPLICATE, BORDER_REFLECT, BORDER_WRAP, BORDER_REFLECT_101 and BORDER_DEFAULT are supported.
 * @warning All input parameters must be valid, or undefined behaviour may occur.
 * @warning abs(outHeight * 2 - height) should <=2
 * @warning abs(outWidth * 2 - width) should <=2
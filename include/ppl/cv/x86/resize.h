@@ -145,6 +145,166 @@ template<typename T, int32_t channels>
     int32_t outWidthStride,
     T* outData);
 
+/**
+* @brief Resize the image with area interpolation method. Shrinking averages the
+*        source pixels covered by every output pixel, weighted by how much of
+*        them it covers; enlarging interpolates linearly, as OpenCV's INTER_AREA does.
+* @tparam T The data type of input and output image, currently only \a uint8_t and \a float are supported.
+* @tparam channels The number of channels of input image, 1, 3 and 4 are supported.
+* @param inHeight          input image's height
+* @param inWidth           input image's width need to be processed
+* @param inWidthStride     input image's width stride, usually it equals to `width * channels`
+* @param inData            input image data
+* @param outHeight         output image's height
+* @param outWidth          output image's width need to be processed
+* @param outWidthStride    the width stride of output image, usually it equals to `width * channels`
+* @param outData           output image data
+* @note Shrinking by integer factors in both directions sums the source pixels
+*       exactly and is the fastest case, 2x and 4x in particular.
+* @warning All input parameters must be valid, or undefined behaviour may occur.
+* @remark The fllowing table show which data type and channels are supported.
+* <table>
+* <tr><th>Data type(T)<th>channels
+* <tr><td>uint8_t(uchar)<td>1
+* <tr><td>uint8_t(uchar)<td>3
+* <tr><td>uint8_t(uchar)<td>4
+* <tr><td>float<td>1
+* <tr><td>float<td>3
+* <tr><td>float<td>4
+* </table>
+* <table>
+* <caption align="left">Requirements</caption>
+* <tr><td>X86 platforms supported<td> all
+* <tr><td>Header files<td> #include &lt;ppl/cv/x86/resize.h&gt;
+* <tr><td>Project<td> ppl.cv
+* @since ppl.cv-v0.7.0
+* ###Example
+* @code{.cpp}
+* #include <ppl/cv/x86/resize.h>
+* int32_t main(int32_t argc, char** argv) {
+*     const int32_t inWidth = 1920;
+*     const int32_t inHeight = 1080;
+*     const int32_t outWidth = 480;
+*     const int32_t outHeight = 270;
+*     const int32_t C = 3;
+*     uint8_t* dev_iImage = (uint8_t*)malloc(inWidth * inHeight * C * sizeof(uint8_t));
+*     uint8_t* dev_oImage = (uint8_t*)malloc(outWidth * outHeight * C * sizeof(uint8_t));
+*
+*     ppl::cv::x86::ResizeArea<uint8_t, 3>(inHeight, inWidth, inWidth * C, dev_iImage, outHeight, outWidth, outWidth * C, dev_oImage);
+*
+*     free(dev_iImage);
+*     free(dev_oImage);
+*     return 0;
+* }
+* @endcode
+***************************************************************************************************/
+template<typename T, int32_t channels>
+::ppl::common::RetCode ResizeArea(
+    int32_t inHeight,
+    int32_t inWidth,
+    int32_t inWidthStride,
+    const T* inData,
+    int32_t outHeight,
+    int32_t outWidth,
+    int32_t outWidthStride,
+    T* outData);
+
+struct ResizeTable;
+
+/**
+* @brief Resizes a stream of images of one geometry. The source row and column
+*        of every output pixel, their weights, the instruction set and the row
+*        buffers of each thread are set up once by Init(), so that Apply() does
+*        no allocation and no table building per image.
+* @tparam T The data type of input and output image, currently only \a uint8_t and \a float are supported.
+* @tparam channels The number of channels of input image, 1, 3 and 4 are supported.
+* @note 1 Apply() gives the same result as ResizeLinear(), ResizeNearestPoint()
+*         or ResizeArea() called with the same geometry.
+*       2 The number of threads is taken when Init() is called; call Init()
+*         again to follow a later SetNumThreads().
+*       3 A plan is applied by one thread at a time; use one plan per thread
+*         to resize several streams concurrently.
+* @warning All input parameters must be valid, or undefined behaviour may occur.
+* @remark The fllowing table show which data type, channels and interpolation are supported.
+* <table>
+* <tr><th>Data type(T)<th>channels<th>interpolation
+* <tr><td>uint8_t(uchar)<td>1, 3, 4<td>INTERPOLATION_LINEAR, INTERPOLATION_NEAREST_POINT, INTERPOLATION_AREA
+* <tr><td>float<td>1, 3, 4<td>INTERPOLATION_LINEAR, INTERPOLATION_NEAREST_POINT, INTERPOLATION_AREA
+* </table>
+* <table>
+* <caption align="left">Requirements</caption>
+* <tr><td>X86 platforms supported<td> all
+* <tr><td>Header files<td> #include &lt;ppl/cv/x86/resize.h&gt;
+* <tr><td>Project<td> ppl.cv
+* @since ppl.cv-v0.7.0
+* ###Example
+* @code{.cpp}
+* #include <ppl/cv/x86/resize.h>
+* int32_t main(int32_t argc, char** argv) {
+*     const int32_t inWidth = 1920;
+*     const int32_t inHeight = 1080;
+*     const int32_t outWidth = 640;
+*     const int32_t outHeight = 360;
+*     const int32_t C = 3;
+*     uint8_t* dev_iImage = (uint8_t*)malloc(inWidth * inHeight * C * sizeof(uint8_t));
+*     uint8_t* dev_oImage = (uint8_t*)malloc(outWidth * outHeight * C * sizeof(uint8_t));
+*
+*     ppl::cv::x86::ResizePlan<uint8_t, 3> plan;
+*     plan.Init(inHeight, inWidth, outHeight, outWidth, ppl::cv::INTERPOLATION_LINEAR);
+*     for (int32_t frame = 0; frame < 100; ++frame) {
+*         plan.Apply(inWidth * C, dev_iImage, outWidth * C, dev_oImage);
+*     }
+*
+*     free(dev_iImage);
+*     free(dev_oImage);
+*     return 0;
+* }
+* @endcode
+***************************************************************************************************/
+template<typename T, int32_t channels>
+class ResizePlan {
+public:
+    ResizePlan();
+    ~ResizePlan();
+
+    /**
+    * @brief Sets up the plan for one geometry, releasing the previous one.
+    * @param inHeight          input image's height
+    * @param inWidth           input image's width need to be processed
+    * @param outHeight         output image's height
+    * @param outWidth          output image's width need to be processed
+    * @param interpolation     INTERPOLATION_LINEAR, INTERPOLATION_NEAREST_POINT or INTERPOLATION_AREA
+    * @return The execution status, succeeds or fails with an error code.
+    */
+    ::ppl::common::RetCode Init(
+        int32_t inHeight,
+        int32_t inWidth,
+        int32_t outHeight,
+        int32_t outWidth,
+        InterpolationType interpolation);
+
+    /**
+    * @brief Resizes one image with the geometry given to Init().
+    * @param inWidthStride     input image's width stride, usually it equals to `width * channels`
+    * @param inData            input image data
+    * @param outWidthStride    the width stride of output image, usually it equals to `width * channels`
+    * @param outData           output image data
+    * @return The execution status, succeeds or fails with an error code.
+    */
+    ::ppl::common::RetCode Apply(
+        int32_t inWidthStride,
+        const T* inData,
+        int32_t outWidthStride,
+        T* outData);
+
+private:
+    ResizePlan(const ResizePlan&);
+    ResizePlan& operator=(const ResizePlan&);
+
+    InterpolationType interpolation_;
+    ResizeTable* table_;
+};
+
 
 } //! namespace x86
 } //! namespace cv
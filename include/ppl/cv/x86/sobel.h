@@ -40,7 +40,7 @@ namespace x86 {
  * @param ksize             the length of kernel. when ksize == -1, it will use 3x3 scharr kernel, (dx, dy) = (0, 1) or (1, 0). when ksize == 1, 3, 5, 7, dx + dy should > 0. other ksize is not supported.
  * @param scale             scale factor for the computed derivative values
  * @param delta             delta value that is added to the results prior to storing them
- * @param border_type       ways to deal with border. Only BORDER_REFLECT_101 or BORDER_DEFAULT are supported now.
+ * @param border_type       ways to deal with border. BORDER_CONSTANT (padded with 0), BORDER_REPLICATE, BORDER_REFLECT, BORDER_WRAP, BORDER_REFLECT_101 and BORDER_DEFAULT are supported.
  * @warning All input parameters must be valid, or undefined behaviour may occur.
  * @remark The following table show which data type and channels are supported.
  * <table>
@@ -21,6 +21,7 @@
 #include "ppl/cv/x86/fma/internal_fma.hpp"
 #include "ppl/common/sys.h"
 #include "ppl/common/x86/sysinfo.h"
+#include "ppl/cv/x86/isa.hpp"
 #include <string.h>
 #include <cmath>
 #include <limits.h>
@@ -95,7 +96,7 @@ template <int32_t channels>
         return ppl::common::RC_INVALID_VALUE;
     }
 
-    if (ppl::common::CpuSupports(ppl::common::ISA_X86_FMA)) {
+    if (isa_supported(ppl::common::ISA_X86_FMA)) {
         return ppl::cv::x86::fma::addWighted_fma<channels>(height, width, inWidthStride0, inData0, alpha, inWidthStride1, inData1, beta, gamma, outWidthStride, outData);
     }
 
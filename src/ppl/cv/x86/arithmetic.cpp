@@ -23,6 +23,7 @@
 #include "ppl/common/retcode.h"
 #include "ppl/common/sys.h"
 #include "ppl/common/x86/sysinfo.h"
+#include "ppl/cv/x86/isa.hpp"
 #include <string.h>
 #include <cmath>
 
@@ -77,7 +78,7 @@ template <typename T, int32_t channels>
                 });
         }
     } else if (std::is_same<T, uint8_t>().value) {
-        if (ppl::common::CpuSupports(ppl::common::ISA_X86_FMA)) {
+        if (isa_supported(ppl::common::ISA_X86_FMA)) {
             return fma::Add_fma<T, channels>(height, width, inWidthStride0, inData0, inWidthStride1, inData1, outWidthStride, outData);
         }
         int32_t i = 0;
@@ -137,7 +138,7 @@ template <typename T, int32_t channels>
                     });
             }
         } else if (std::is_same<T, uint8_t>().value) {
-            if (ppl::common::CpuSupports(ppl::common::ISA_X86_FMA)) {
+            if (isa_supported(ppl::common::ISA_X86_FMA)) {
                 return fma::Mul_fma<T, channels>(height, width, inWidthStride0, inData0, inWidthStride1, inData1, outWidthStride, outData, alpha);
             }
             int32_t i = 0;
@@ -330,7 +331,7 @@ template <int32_t channels>
         outWidthStride <= 0) {
         return ppl::common::RC_INVALID_VALUE;
     }
-    if (ppl::common::CpuSupports(ppl::common::ISA_X86_FMA)) {
+    if (isa_supported(ppl::common::ISA_X86_FMA)) {
         return fma::Subtract<channels>(height, width, inWidthStride, inData, scalar, outWidthStride, outData);
     }
     if (channels == 1) {
@@ -19,6 +19,7 @@
 #include "ppl/cv/x86/avx/internal_avx.hpp"
 #include "ppl/common/sys.h"
 #include "ppl/common/x86/sysinfo.h"
+#include "ppl/cv/x86/isa.hpp"
 #include <vector>
 #include <stdint.h>
 #include <cstring>
@@ -65,7 +66,7 @@ struct RGB2Gray<float> {
             std::swap(coeffs[0], coeffs[2]);
 
         core        = 1;
-        bSupportAVX = ppl::common::CpuSupports(ppl::common::ISA_X86_AVX);
+        bSupportAVX = isa_supported(ppl::common::ISA_X86_AVX);
         if (bSupportAVX) {
             v_cb = _mm256_set1_ps(coeffs[0]);
             v_cg = _mm256_set1_ps(coeffs[1]);
@@ -16,9 +16,12 @@
 // under the License.
 
 #include "ppl/cv/x86/gaussianblur.h"
-#include "ppl/cv/x86/copymakeborder.h"
 #include "ppl/cv/x86/avx/internal_avx.hpp"
+#include "ppl/cv/x86/avx512/internal_avx512.hpp"
+#include "ppl/cv/x86/parallel.hpp"
+#include "ppl/cv/x86/filter_engine.hpp"
 #include "ppl/common/x86/sysinfo.h"
+#include "ppl/cv/x86/isa.hpp"
 #include "ppl/common/sys.h"
 #include "ppl/cv/types.h"
 #include <string.h>
@@ -203,12 +206,17 @@ static void createGaussianKernels(std::vector<float> &k, int32_t ksize, double s
     k = getGaussianKernel(sigma, ksize);
 }
 
+// The functors share their names with the SSE ones of gaussianblur.cpp, so
+// they are kept local to this file.
+namespace {
+
 struct RowVec_32f {
     RowVec_32f(const std::vector<float> &_kernel)
     {
-        kernel      = _kernel;
-        core        = 1;
-        bSupportAVX = true;
+        kernel         = _kernel;
+        core           = 1;
+        bSupportAVX    = true;
+        bSupportAVX512 = isa_supported(ppl::common::ISA_X86_AVX512);
     }
 
     void operator()(const float *_src, float *_dst, int32_t width, int32_t cn) const
@@ -219,6 +227,9 @@ struct RowVec_32f {
 
         int32_t i = 0, k;
         width *= cn;
+        if (bSupportAVX512) {
+            i = avx512::gaussblur_row_f32(src0, dst, width, cn, &kernel[0], _ksize);
+        }
 
         if (bSupportAVX) {
             for (; i <= width - 16; i += 16) {
@@ -249,17 +260,27 @@ struct RowVec_32f {
     std::vector<float> kernel;
     int32_t core;
     bool bSupportAVX;
+    bool bSupportAVX512;
 };
 
 struct SymmColumnVec_32f {
     SymmColumnVec_32f(const std::vector<float> &_kernel)
     {
-        kernel      = _kernel;
-        core        = 1;
-        bSupportAVX = true;
+        kernel         = _kernel;
+        core           = 1;
+        bSupportAVX    = true;
+        bSupportAVX512 = isa_supported(ppl::common::ISA_X86_AVX512);
     }
 
-    void operator()(float **_src, float *_dst, int32_t width) const
+    void operator()(const float **src, float *dst, int32_t dststep, int32_t count, int32_t width) const
+    {
+        int32_t ksize2 = kernel.size() / 2;
+        for (; count-- > 0; src++, dst += dststep) {
+            row(src + ksize2, dst, width);
+        }
+    }
+
+    void row(const float **_src, float *_dst, int32_t width) const
     {
         int32_t ksize2    = (kernel.size()) / 2;
         const float *ky   = &kernel[ksize2];
@@ -268,6 +289,10 @@ struct SymmColumnVec_32f {
         const float *S, *S2;
         float *dst = (float *)_dst;
 
+        if (bSupportAVX512) {
+            i = avx512::gaussblur_col_f32(src, dst, width, ky, ksize2);
+        }
+
         if (bSupportAVX) {
             for (; i <= width - 32; i += 32) {
                 __m256 f = _mm256_broadcast_ss(ky);
@@ -333,6 +358,7 @@ struct SymmColumnVec_32f {
     std::vector<float> kernel;
     int32_t core;
     bool bSupportAVX;
+    bool bSupportAVX512;
 };
 #define TRANSPOSE_KERNEL_DEF       \
     __m256 ymm0, ymm1, ymm2, ymm3; \
@@ -388,9 +414,10 @@ struct SymmColumnVec_32f {
 struct RowVec_32f_k3 {
     RowVec_32f_k3(const std::vector<float> &_kernel)
     {
-        kernel      = _kernel;
-        core        = 1;
-        bSupportAVX = true;
+        kernel         = _kernel;
+        core           = 1;
+        bSupportAVX    = true;
+        bSupportAVX512 = isa_supported(ppl::common::ISA_X86_AVX512);
     }
 
     void operator()(const float **_src, float *_dst, int32_t width, int32_t cn, int32_t dstep) const
@@ -408,6 +435,9 @@ struct RowVec_32f_k3 {
 
         width     = width * cn;
         int32_t i = 0;
+        if (bSupportAVX512) {
+            i = avx512::gaussblur_symm_f32(_src, _dst, width, cn, dstep, 9, &kernel[0], 3);
+        }
         if (bSupportAVX) {
             for (; i <= width - 8; i += 8) {
                 TRANSPOSE_KERNEL_DEF
@@ -447,14 +477,16 @@ struct RowVec_32f_k3 {
     std::vector<float> kernel;
     int32_t core;
     bool bSupportAVX;
+    bool bSupportAVX512;
 };
 
 struct RowVec_32f_k3_raw {
     RowVec_32f_k3_raw(const std::vector<float> &_kernel)
     {
-        kernel      = _kernel;
-        core        = 1;
-        bSupportAVX = true;
+        kernel         = _kernel;
+        core           = 1;
+        bSupportAVX    = true;
+        bSupportAVX512 = isa_supported(ppl::common::ISA_X86_AVX512);
     }
 
     void operator()(const float **_src, float *_dst, int32_t width, int32_t cn, int32_t dstep) const
@@ -473,6 +505,9 @@ struct RowVec_32f_k3_raw {
 
         width     = width * cn;
         int32_t i = 0;
+        if (bSupportAVX512) {
+            i = avx512::gaussblur_symm_f32(_src, _dst, width, cn, dstep, 1, &kernel[0], 3);
+        }
         if (bSupportAVX) {
             for (; i <= width - 8; i += 8) {
                 TRANSPOSE_KERNEL_DEF
@@ -496,6 +531,7 @@ struct RowVec_32f_k3_raw {
     std::vector<float> kernel;
     int32_t core;
     bool bSupportAVX;
+    bool bSupportAVX512;
 };
 
 #undef TRANSPOSE_KERNEL_DEF
@@ -567,9 +603,10 @@ struct RowVec_32f_k3_raw {
 struct RowVec_32f_k5_raw {
     RowVec_32f_k5_raw(const std::vector<float> &_kernel)
     {
-        kernel      = _kernel;
-        core        = 1;
-        bSupportAVX = true;
+        kernel         = _kernel;
+        core           = 1;
+        bSupportAVX    = true;
+        bSupportAVX512 = isa_supported(ppl::common::ISA_X86_AVX512);
     }
 
     void operator()(const float **_src, float *_dst, int32_t width, int32_t cn, int32_t dstep) const
@@ -592,6 +629,9 @@ struct RowVec_32f_k5_raw {
 
         width     = width * cn;
         int32_t i = 0;
+        if (bSupportAVX512) {
+            i = avx512::gaussblur_symm_f32(_src, _dst, width, cn, dstep, 1, &kernel[0], 5);
+        }
 
         if (bSupportAVX) {
             for (; i <= width - 8; i += 8) {
@@ -625,14 +665,16 @@ struct RowVec_32f_k5_raw {
     std::vector<float> kernel;
     int32_t core;
     bool bSupportAVX;
+    bool bSupportAVX512;
 };
 
 struct RowVec_32f_k5 {
     RowVec_32f_k5(const std::vector<float> &_kernel)
     {
-        kernel      = _kernel;
-        core        = 1;
-        bSupportAVX = true;
+        kernel         = _kernel;
+        core           = 1;
+        bSupportAVX    = true;
+        bSupportAVX512 = isa_supported(ppl::common::ISA_X86_AVX512);
     }
 
     void operator()(const float **_src, float *_dst, int32_t width, int32_t cn, int32_t dstep) const
@@ -654,6 +696,9 @@ struct RowVec_32f_k5 {
 
         width     = width * cn;
         int32_t i = 0;
+        if (bSupportAVX512) {
+            i = avx512::gaussblur_symm_f32(_src, _dst, width, cn, dstep, 10, &kernel[0], 5);
+        }
         if (bSupportAVX) {
             for (; i <= width - 8; i += 8) {
                 k5_TRANSPOSE_KERNEL_DEF
@@ -723,8 +768,11 @@ struct RowVec_32f_k5 {
     std::vector<float> kernel;
     int32_t core;
     bool bSupportAVX;
+    bool bSupportAVX512;
 };
 
+} // namespace
+
 static void x86GaussianBlur_fs3(
     int32_t height,
     int32_t width,
@@ -768,19 +816,25 @@ static void x86GaussianBlur_fs3(
         leftrightBor[i + lrheight] = left_right + (i)*lrstep + 3 * radius * cn;
     }
 
-    RowVec_32f_k3 rowVecOp = RowVec_32f_k3(kernel);
-    int32_t i              = 0;
-    for (; i <= innerHeight - 9; i += 9) {
-        const float **src = pReRowFilter + i + radius;
-        float *dst        = outData + (i + radius) * outWidthStride + radius * cn;
-        rowVecOp.operator()((const float **)src, dst, innerWidth, cn, outWidthStride);
-    }
+    RowVec_32f_k3 rowVecOp         = RowVec_32f_k3(kernel);
     RowVec_32f_k3_raw rowVecOp_raw = RowVec_32f_k3_raw(kernel);
-    for (; i < innerHeight; i++) {
-        const float **src = pReRowFilter + i + radius;
-        float *dst        = outData + (i + radius) * outWidthStride + radius * cn;
-        rowVecOp_raw.operator()((const float **)src, dst, innerWidth, cn, outWidthStride);
-    }
+    // the blocked operator computes 9 rows per call; each band runs whole
+    // blocks from its own start row and finishes its tail with the raw one.
+    parallel_for_rows(innerHeight, innerWidth * cn * kernel_len, [&](int32_t begin, int32_t end) {
+        int32_t i = begin;
+        for (; i <= end - 9; i += 9) {
+            const float **src = pReRowFilter + i + radius;
+            float *dst        = outData + (i + radius) * outWidthStride + radius * cn;
+            rowVecOp.operator()((const float **)src, dst, innerWidth, cn, outWidthStride);
+        }
+        for (; i < end; i++) {
+            const float **src = pReRowFilter + i + radius;
+            float *dst        = outData + (i + radius) * outWidthStride + radius * cn;
+            rowVecOp_raw.operator()((const float **)src, dst, innerWidth, cn, outWidthStride);
+        }
+    }, 9);
+
+    int32_t i = 0;
 
     for (i = 0; i < radius; i++) {
         const float **src = updownBor + i + radius;
@@ -851,20 +905,25 @@ static void x86GaussianBlur_fs5(
         leftrightBor[i + lrheight] = left_right + (i)*lrstep + 3 * radius * cn;
     }
 
-    RowVec_32f_k5 rowVecOp = RowVec_32f_k5(kernel);
-    int32_t i              = 0;
-    for (; i <= innerHeight - 10; i += 10) {
-        const float **src = pReRowFilter + i + radius;
-        float *dst        = outData + (i + radius) * outWidthStride + radius * cn;
-        rowVecOp.operator()((const float **)src, dst, innerWidth, cn, outWidthStride);
-    }
-
+    RowVec_32f_k5 rowVecOp         = RowVec_32f_k5(kernel);
     RowVec_32f_k5_raw rowVecOp_raw = RowVec_32f_k5_raw(kernel);
-    for (; i < innerHeight; i++) {
-        const float **src = pReRowFilter + i + radius;
-        float *dst        = outData + (i + radius) * outWidthStride + radius * cn;
-        rowVecOp_raw.operator()((const float **)src, dst, innerWidth, cn, outWidthStride);
-    }
+    // the blocked operator computes 10 rows per call; each band runs whole
+    // blocks from its own start row and finishes its tail with the raw one.
+    parallel_for_rows(innerHeight, innerWidth * cn * kernel_len, [&](int32_t begin, int32_t end) {
+        int32_t i = begin;
+        for (; i <= end - 10; i += 10) {
+            const float **src = pReRowFilter + i + radius;
+            float *dst        = outData + (i + radius) * outWidthStride + radius * cn;
+            rowVecOp.operator()((const float **)src, dst, innerWidth, cn, outWidthStride);
+        }
+        for (; i < end; i++) {
+            const float **src = pReRowFilter + i + radius;
+            float *dst        = outData + (i + radius) * outWidthStride + radius * cn;
+            rowVecOp_raw.operator()((const float **)src, dst, innerWidth, cn, outWidthStride);
+        }
+    }, 10);
+
+    int32_t i = 0;
 
     for (i = 0; i < radius; i++) {
         const float **src = updownBor + i + radius;
@@ -893,6 +952,8 @@ static void x86GaussianBlur_fs5(
     free(leftrightBor);
 }
 
+// Any kernel and border: rows stream through the filter engine instead of a
+// bordered copy of the whole image.
 template <int cn>
 static void x86GaussianBlur_flarge(
     int32_t height,
@@ -907,133 +968,11 @@ static void x86GaussianBlur_flarge(
 {
     std::vector<float> kernel;
     createGaussianKernels(kernel, kernel_len, sigma, sense32F);
+    kernel_len = kernel.size();
 
-    int32_t radius     = kernel_len / 2;
-    int32_t bsrcHeight = height + 2 * radius;
-    int32_t bsrcWidth  = width + 2 * radius;
-
-    int32_t bsrcWidthStep = (bsrcWidth + 7) / 8 * 8 * cn;
-    float *bsrc           = (float *)_mm_malloc(bsrcHeight * bsrcWidthStep * sizeof(float), 64);
-    CopyMakeBorder<float, cn>(height, width, inWidthStride, inData, bsrcHeight, bsrcWidth, bsrcWidthStep, bsrc, border_type);
-    float *resultRowFilter = bsrc;
-    float **pReRowFilter   = (float **)malloc(bsrcHeight * sizeof(resultRowFilter));
-    for (int32_t i = 0; i < bsrcHeight; i++) {
-        pReRowFilter[i] = resultRowFilter + (i)*bsrcWidthStep;
-    }
-
-    RowVec_32f rowVecOp = RowVec_32f(kernel);
-    for (int32_t i = 0; i < bsrcHeight; i++) {
-        float *src = bsrc + i * bsrcWidthStep;
-        float *dst = resultRowFilter + i * bsrcWidthStep;
-        rowVecOp.operator()(src, dst, width, cn);
-    }
-
-    SymmColumnVec_32f colVecOp = SymmColumnVec_32f(kernel);
-
-    for (int32_t i = 0; i < height; i++) {
-        float **src = pReRowFilter + i + radius;
-        float *dst  = outData + i * outWidthStride;
-        colVecOp.operator()(src, dst, width *cn);
-    }
-
-    _mm_free(bsrc);
-    free(pReRowFilter);
-    bsrc         = NULL;
-    pReRowFilter = NULL;
-}
-
-template<int cn>
-void x86GaussianBlur_f_vector_avx(
-    int32_t height,
-    int32_t width,
-    const float *inData,
-    int32_t kernel_len,
-    float sigma,
-    float *outData,
-    ppl::cv::BorderType border_type)
-{   
-    std::vector<float> kernel;
-    createGaussianKernels(kernel, kernel_len, sigma, sense32F);
-
-    int32_t radius    = kernel_len / 2;
-    int32_t radius_cn = radius * cn;
-    int32_t pad_size  = 3 * radius_cn * 2;
-    float*  pad_data  = (float *) malloc(pad_size * sizeof(inData));
-
-    int32_t i, j, size = sizeof(float);
-    int32_t length     = width ^ 1 ? width : height;
-    int32_t length_cn  = length * cn;
-    // make border
-    for (i = 0; i < radius; i++) {
-        j = borderInterpolate(i - radius, length, border_type);
-        memcpy(pad_data + i * cn, inData + j * cn, cn * size);
-
-        j = borderInterpolate(length + i, length, border_type);
-        memcpy(pad_data + 5 * radius_cn + i * cn, inData + j * cn, cn * size);
-    }
-    memcpy(pad_data + radius_cn, inData, 2 * radius_cn * size);
-    memcpy(pad_data + 3 * radius_cn, inData + length_cn - 2 * radius_cn, 2 * radius_cn * size);
-
-    bool bSupportAVX = ppl::common::CpuSupports(ppl::common::ISA_X86_AVX);
-
-    // do gaussianblur on pad data
-    i = 0;
-    if (bSupportAVX) {
-        for (; i <= radius_cn - 8; i += 8) {
-            float* src0 = pad_data + i;                              
-            float* src1 = pad_data + 3 * radius_cn + i;
-            __m256 f, res0 = _mm256_setzero_ps(), res1 = res0, x0, x1;
-            for (j = 0; j < kernel_len; j++, src0 += cn, src1 += cn) {
-                f    = _mm256_broadcast_ss(&kernel[j]);
-                x0   = _mm256_loadu_ps(src0);
-                x1   = _mm256_loadu_ps(src1);
-                res0 = _mm256_add_ps(res0, _mm256_mul_ps(x0, f));
-                res1 = _mm256_add_ps(res1, _mm256_mul_ps(x1, f));
-            }
-
-            _mm256_storeu_ps(outData + i, res0);
-            _mm256_storeu_ps(outData + length_cn - radius_cn + i, res1);
-        }
-    }
-
-    for (; i < radius_cn; i++) {
-        float* src0 = pad_data + i;
-        float* src1 = pad_data + 3 * radius_cn + i;
-        float res0 = 0, res1 = 0;
-        for (j = 0; j < kernel_len; j++, src0 += cn, src1 += cn) {
-            res0 += src0[0] * kernel[j];
-            res1 += src1[0] * kernel[j];
-        }
-        outData[i] = res0;
-        outData[length_cn - radius_cn + i] = res1;
-    }
-
-    i = 0;
-    const int32_t rest = length_cn - 2 * radius_cn;
-    if (bSupportAVX) {
-        for (; i <= rest - 8; i += 8) {
-            const float* src = inData + i;
-            __m256 f, res = _mm256_setzero_ps(), x0;
-            for (j = 0; j < kernel_len; j++, src += cn) {
-                f   = _mm256_broadcast_ss(&kernel[j]);
-                x0  = _mm256_loadu_ps(src);
-                res = _mm256_add_ps(res, _mm256_mul_ps(x0, f));
-            }
-            _mm256_storeu_ps(outData + radius_cn + i, res);
-        }
-    }
-
-    // do gaussianblur on src data
-    for (; i < rest; i++) {
-        const float* src = inData + i;
-        float res = 0;
-        for (j = 0; j < kernel_len; j++, src += cn) {
-            res += src[0] * kernel[j];
-        }
-        outData[radius_cn + i] = res;
-    }
-
-    free(pad_data);
+    SeparableFilterEngine<float, float, float, RowVec_32f, SymmColumnVec_32f> engine(
+        height, width, cn, kernel_len, kernel_len, border_type, 0.f, RowVec_32f(kernel), SymmColumnVec_32f(kernel));
+    engine.process(inData, inWidthStride, outData, outWidthStride);
 }
 
 template <int cn>
@@ -1048,18 +987,12 @@ void x86GaussianBlur_f_avx(
     float *outData,
     ppl::cv::BorderType border_type)
 {
-    // only one element
-    if (height == 1 && width == 1) {
-        outData[0] = inData[0];
-        return;
-    }
-    // vector
-    if (height == 1 || width == 1) {
-        x86GaussianBlur_f_vector_avx<cn>(height, width, inData, kernel_len, sigma, outData, border_type);
-        return;
-    }
     int32_t radius = kernel_len / 2;
-    if (radius == 1 && border_type == ppl::cv::BORDER_REFLECT_101)
+    // the on-the-fly border of the 3x3 and 5x5 kernels reads 2 * radius rows
+    // and columns, and their inner part needs one more
+    if (height < kernel_len || width < kernel_len)
+        x86GaussianBlur_flarge<cn>(height, width, inWidthStride, inData, kernel_len, sigma, outWidthStride, outData, border_type);
+    else if (radius == 1 && border_type == ppl::cv::BORDER_REFLECT_101)
         x86GaussianBlur_fs3(height, width, inWidthStride, inData, kernel_len, sigma, outWidthStride, outData, cn);
     else if (radius == 2 && border_type == ppl::cv::BORDER_REFLECT_101)
         x86GaussianBlur_fs5(height, width, inWidthStride, inData, kernel_len, sigma, outWidthStride, outData, cn);
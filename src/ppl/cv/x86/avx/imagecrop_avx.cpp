@@ -2,6 +2,7 @@
 #include "./internal_avx.hpp"
 #include "ppl/common/sys.h"
 #include "ppl/common/x86/sysinfo.h"
+#include "ppl/cv/x86/isa.hpp"
 #include <vector>
 #include <stdint.h>
 #include <cstring>
@@ -30,7 +31,7 @@ template <>
         {
             v_scale = _mm256_set1_ps(scale);
             core = 1;
-            bSupportAVX = ppl::common::CpuSupports(ppl::common::ISA_X86_AVX);
+            bSupportAVX = isa_supported(ppl::common::ISA_X86_AVX);
         }
 
         void operator()(const float* src, float* dst, int n) const
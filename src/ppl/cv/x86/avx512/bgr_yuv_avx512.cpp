@@ -0,0 +1,407 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "ppl/cv/x86/avx512/internal_avx512.hpp"
+#include "ppl/cv/x86/avx512/intrinutils_avx512.hpp"
+#include "ppl/cv/x86/util.hpp"
+#include "ppl/cv/types.h"
+#include "ppl/common/retcode.h"
+#include <stdint.h>
+#include <immintrin.h>
+#include <algorithm>
+
+#define CY_coeff  1220542
+#define CUB_coeff 2116026
+#define CUG_coeff -409993
+#define CVG_coeff -852492
+#define CVR_coeff 1673527
+#define SHIFT     20
+
+#define CRY_coeff 269484
+#define CGY_coeff 528482
+#define CBY_coeff 102760
+#define CRU_coeff -155188
+#define CGU_coeff -305135
+#define CBU_coeff 460324
+#define CGV_coeff -385875
+#define CBV_coeff -74448
+
+namespace ppl {
+namespace cv {
+namespace x86 {
+namespace avx512 {
+
+// 64 pixels of one luma row to BGR(A), with the chroma terms of the 4 groups
+// of 16 pixels precomputed since both rows of a pair share them. Same integer
+// math as the scalar and FMA kernels, so the output is bit-identical.
+template <int32_t dstcn, int32_t blueIdx>
+static inline void y_2_rgb_x64(
+    const uint8_t *y,
+    const __m512i *ruv,
+    const __m512i *guv,
+    const __m512i *buv,
+    uint8_t *dst)
+{
+    const __m512i delta_y = _mm512_set1_epi32(16);
+    const __m512i cy      = _mm512_set1_epi32(CY_coeff);
+    const __m512i zero    = _mm512_setzero_si512();
+    __m512i b[4], g[4], r[4];
+    for (int32_t k = 0; k < 4; ++k) {
+        __m512i y32 = _mm512_cvtepu8_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(y + 16 * k)));
+        y32         = _mm512_mullo_epi32(_mm512_max_epi32(_mm512_sub_epi32(y32, delta_y), zero), cy);
+        b[k]        = _mm512_srai_epi32(_mm512_add_epi32(y32, buv[k]), SHIFT);
+        g[k]        = _mm512_srai_epi32(_mm512_add_epi32(y32, guv[k]), SHIFT);
+        r[k]        = _mm512_srai_epi32(_mm512_add_epi32(y32, ruv[k]), SHIFT);
+    }
+    __m512i vb = v_pack_u8(b[0], b[1], b[2], b[3]);
+    __m512i vg = v_pack_u8(g[0], g[1], g[2], g[3]);
+    __m512i vr = v_pack_u8(r[0], r[1], r[2], r[3]);
+    __m512i first = blueIdx == 0 ? vb : vr;
+    __m512i third = blueIdx == 0 ? vr : vb;
+    if (dstcn == 3) {
+        v_store_interleave(dst, first, vg, third);
+    } else {
+        v_store_interleave(dst, first, vg, third, _mm512_set1_epi8((char)255));
+    }
+}
+
+static inline void uv_terms(__m512i u, __m512i v, __m512i &ruv, __m512i &guv, __m512i &buv)
+{
+    const __m512i bias = _mm512_set1_epi32(1 << (SHIFT - 1));
+    ruv = _mm512_add_epi32(_mm512_mullo_epi32(v, _mm512_set1_epi32(CVR_coeff)), bias);
+    guv = _mm512_add_epi32(_mm512_add_epi32(_mm512_mullo_epi32(v, _mm512_set1_epi32(CVG_coeff)), bias), _mm512_mullo_epi32(u, _mm512_set1_epi32(CUG_coeff)));
+    buv = _mm512_add_epi32(_mm512_mullo_epi32(u, _mm512_set1_epi32(CUB_coeff)), bias);
+}
+
+template <int32_t dstcn, int32_t blueIdx>
+static inline void yuv_2_rgb_pair(int32_t y00, int32_t y01, int32_t y10, int32_t y11, int32_t u, int32_t v, uint8_t *dst0, uint8_t *dst1)
+{
+    int32_t ruv = (1 << (SHIFT - 1)) + CVR_coeff * v;
+    int32_t guv = (1 << (SHIFT - 1)) + CVG_coeff * v + CUG_coeff * u;
+    int32_t buv = (1 << (SHIFT - 1)) + CUB_coeff * u;
+    const int32_t ys[4] = {y00, y01, y10, y11};
+    uint8_t *ds[4]      = {dst0, dst0 + dstcn, dst1, dst1 + dstcn};
+    for (int32_t p = 0; p < 4; ++p) {
+        int32_t yy             = std::max(0, ys[p] - 16) * CY_coeff;
+        ds[p][blueIdx]         = sat_cast_u8((yy + buv) >> SHIFT);
+        ds[p][1]               = sat_cast_u8((yy + guv) >> SHIFT);
+        ds[p][blueIdx ^ 2]     = sat_cast_u8((yy + ruv) >> SHIFT);
+        if (dstcn == 4) {
+            ds[p][3] = 255;
+        }
+    }
+}
+
+template <int32_t dstcn, int32_t blueIdx, bool isUV>
+::ppl::common::RetCode nv_2_rgb(
+    int32_t height,
+    int32_t width,
+    int32_t inYStride,
+    const uint8_t *inY,
+    int32_t inUVStride,
+    const uint8_t *inUV,
+    int32_t outWidthStride,
+    uint8_t *outData)
+{
+    const __m512i delta_uv = _mm512_set1_epi32(128);
+    for (int32_t i = 0; i < height; i += 2) {
+        const uint8_t *src0 = inY + i * inYStride;
+        const uint8_t *src1 = inY + (i + 1) * inYStride;
+        const uint8_t *src2 = inUV + (i / 2) * inUVStride;
+        uint8_t *dst0       = outData + i * outWidthStride;
+        uint8_t *dst1       = outData + (i + 1) * outWidthStride;
+        int32_t j           = 0;
+        for (; j <= width - 64; j += 64) {
+            __m512i ruv[4], guv[4], buv[4];
+            for (int32_t k = 0; k < 4; ++k) {
+                __m512 uv = _mm512_castsi512_ps(_mm512_sub_epi32(_mm512_cvtepu8_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src2 + j + 16 * k))), delta_uv));
+                __m512i even = _mm512_castps_si512(_mm512_moveldup_ps(uv));
+                __m512i odd  = _mm512_castps_si512(_mm512_movehdup_ps(uv));
+                uv_terms(isUV ? even : odd, isUV ? odd : even, ruv[k], guv[k], buv[k]);
+            }
+            y_2_rgb_x64<dstcn, blueIdx>(src0 + j, ruv, guv, buv, dst0 + j * dstcn);
+            y_2_rgb_x64<dstcn, blueIdx>(src1 + j, ruv, guv, buv, dst1 + j * dstcn);
+        }
+        for (; j < width; j += 2) {
+            int32_t u = int32_t(src2[j + (isUV ? 0 : 1)]) - 128;
+            int32_t v = int32_t(src2[j + (isUV ? 1 : 0)]) - 128;
+            yuv_2_rgb_pair<dstcn, blueIdx>(src0[j], src0[j + 1], src1[j], src1[j + 1], u, v, dst0 + j * dstcn, dst1 + j * dstcn);
+        }
+    }
+    return ppl::common::RC_SUCCESS;
+}
+
+template <int32_t dstcn, int32_t blueIdx>
+::ppl::common::RetCode i420_2_rgb(
+    int32_t height,
+    int32_t width,
+    int32_t inYStride,
+    const uint8_t *inY,
+    int32_t inUStride,
+    const uint8_t *inU,
+    int32_t inVStride,
+    const uint8_t *inV,
+    int32_t outWidthStride,
+    uint8_t *outData)
+{
+    if (width % 2 != 0 || height % 2 != 0) {
+        return ppl::common::RC_INVALID_VALUE;
+    }
+    const __m512i delta_uv = _mm512_set1_epi32(128);
+    for (int32_t i = 0; i < height; i += 2) {
+        const uint8_t *src0 = inY + i * inYStride;
+        const uint8_t *src1 = inY + (i + 1) * inYStride;
+        const uint8_t *src2 = inU + (i / 2) * inUStride;
+        const uint8_t *src3 = inV + (i / 2) * inVStride;
+        uint8_t *dst0       = outData + i * outWidthStride;
+        uint8_t *dst1       = outData + (i + 1) * outWidthStride;
+        int32_t j           = 0;
+        for (; j <= width - 64; j += 64) {
+            __m512i ruv[4], guv[4], buv[4];
+            for (int32_t k = 0; k < 4; ++k) {
+                // each chroma sample covers two pixels of the row
+                __m128i u8 = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(src2 + j / 2 + 8 * k));
+                __m128i v8 = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(src3 + j / 2 + 8 * k));
+                __m512i u  = _mm512_sub_epi32(_mm512_cvtepu8_epi32(_mm_unpacklo_epi8(u8, u8)), delta_uv);
+                __m512i v  = _mm512_sub_epi32(_mm512_cvtepu8_epi32(_mm_unpacklo_epi8(v8, v8)), delta_uv);
+                uv_terms(u, v, ruv[k], guv[k], buv[k]);
+            }
+            y_2_rgb_x64<dstcn, blueIdx>(src0 + j, ruv, guv, buv, dst0 + j * dstcn);
+            y_2_rgb_x64<dstcn, blueIdx>(src1 + j, ruv, guv, buv, dst1 + j * dstcn);
+        }
+        for (; j < width; j += 2) {
+            yuv_2_rgb_pair<dstcn, blueIdx>(src0[j], src0[j + 1], src1[j], src1[j + 1], int32_t(src2[j / 2]) - 128, int32_t(src3[j / 2]) - 128, dst0 + j * dstcn, dst1 + j * dstcn);
+        }
+    }
+    return ppl::common::RC_SUCCESS;
+}
+
+// Luma of 16 pixels and, for even rows, the chroma of their even pixels
+// interleaved in the order the NV12/NV21 plane stores it.
+static inline __m512i rgb_2_y_x16(__m512i r, __m512i g, __m512i b)
+{
+    const __m512i bias = _mm512_set1_epi32((1 << (SHIFT - 1)) + (16 << SHIFT));
+    __m512i y          = _mm512_add_epi32(_mm512_mullo_epi32(r, _mm512_set1_epi32(CRY_coeff)), _mm512_mullo_epi32(g, _mm512_set1_epi32(CGY_coeff)));
+    y                  = _mm512_add_epi32(_mm512_add_epi32(y, _mm512_mullo_epi32(b, _mm512_set1_epi32(CBY_coeff))), bias);
+    return _mm512_srai_epi32(y, SHIFT);
+}
+
+template <int32_t srccn, int32_t bIdx>
+static inline void load_rgb_x64(const uint8_t *src, __m512i &r, __m512i &g, __m512i &b)
+{
+    __m512i c0, c1, c2, c3;
+    if (srccn == 3) {
+        v_load_deinterleave(src, c0, c1, c2);
+    } else {
+        v_load_deinterleave(src, c0, c1, c2, c3);
+    }
+    r = bIdx == 0 ? c2 : c0;
+    g = c1;
+    b = bIdx == 0 ? c0 : c2;
+}
+
+static inline __m512i widen(__m512i v, int32_t k)
+{
+    switch (k) {
+        case 0: return _mm512_cvtepu8_epi32(_mm512_castsi512_si128(v));
+        case 1: return _mm512_cvtepu8_epi32(_mm512_extracti32x4_epi32(v, 1));
+        case 2: return _mm512_cvtepu8_epi32(_mm512_extracti32x4_epi32(v, 2));
+        default: return _mm512_cvtepu8_epi32(_mm512_extracti32x4_epi32(v, 3));
+    }
+}
+
+template <int32_t srccn, int32_t bIdx, bool isUV>
+::ppl::common::RetCode rgb_2_nv(
+    int32_t height,
+    int32_t width,
+    int32_t inWidthStride,
+    const uint8_t *inData,
+    int32_t outYStride,
+    uint8_t *outY,
+    int32_t outUVStride,
+    uint8_t *outUV)
+{
+    // even lanes produce U, odd lanes V (swapped for NV21); both are computed
+    // from the even pixel, which moveldup copies into the odd lane
+    const __m512i cr = isUV ? _mm512_set_epi32(CBU_coeff, CRU_coeff, CBU_coeff, CRU_coeff, CBU_coeff, CRU_coeff, CBU_coeff, CRU_coeff,
+                                               CBU_coeff, CRU_coeff, CBU_coeff, CRU_coeff, CBU_coeff, CRU_coeff, CBU_coeff, CRU_coeff)
+                            : _mm512_set_epi32(CRU_coeff, CBU_coeff, CRU_coeff, CBU_coeff, CRU_coeff, CBU_coeff, CRU_coeff, CBU_coeff,
+                                               CRU_coeff, CBU_coeff, CRU_coeff, CBU_coeff, CRU_coeff, CBU_coeff, CRU_coeff, CBU_coeff);
+    const __m512i cg = isUV ? _mm512_set_epi32(CGV_coeff, CGU_coeff, CGV_coeff, CGU_coeff, CGV_coeff, CGU_coeff, CGV_coeff, CGU_coeff,
+                                               CGV_coeff, CGU_coeff, CGV_coeff, CGU_coeff, CGV_coeff, CGU_coeff, CGV_coeff, CGU_coeff)
+                            : _mm512_set_epi32(CGU_coeff, CGV_coeff, CGU_coeff, CGV_coeff, CGU_coeff, CGV_coeff, CGU_coeff, CGV_coeff,
+                                               CGU_coeff, CGV_coeff, CGU_coeff, CGV_coeff, CGU_coeff, CGV_coeff, CGU_coeff, CGV_coeff);
+    const __m512i cb = isUV ? _mm512_set_epi32(CBV_coeff, CBU_coeff, CBV_coeff, CBU_coeff, CBV_coeff, CBU_coeff, CBV_coeff, CBU_coeff,
+                                               CBV_coeff, CBU_coeff, CBV_coeff, CBU_coeff, CBV_coeff, CBU_coeff, CBV_coeff, CBU_coeff)
+                            : _mm512_set_epi32(CBU_coeff, CBV_coeff, CBU_coeff, CBV_coeff, CBU_coeff, CBV_coeff, CBU_coeff, CBV_coeff,
+                                               CBU_coeff, CBV_coeff, CBU_coeff, CBV_coeff, CBU_coeff, CBV_coeff, CBU_coeff, CBV_coeff);
+    const __m512i uv_bias = _mm512_set1_epi32((1 << (SHIFT - 1)) + (128 << SHIFT));
+
+    for (int32_t i = 0; i < height; i += 2) {
+        const uint8_t *src0 = inData + i * inWidthStride;
+        const uint8_t *src1 = inData + (i + 1) * inWidthStride;
+        uint8_t *dst0       = outY + i * outYStride;
+        uint8_t *dst1       = outY + (i + 1) * outYStride;
+        uint8_t *dst2       = outUV + (i / 2) * outUVStride;
+        int32_t j           = 0;
+        for (; j <= width - 64; j += 64) {
+            __m512i r, g, b;
+            __m512i y[4], uv[4];
+            load_rgb_x64<srccn, bIdx>(src0 + j * srccn, r, g, b);
+            for (int32_t k = 0; k < 4; ++k) {
+                __m512i r32 = widen(r, k), g32 = widen(g, k), b32 = widen(b, k);
+                y[k]        = rgb_2_y_x16(r32, g32, b32);
+                r32         = _mm512_castps_si512(_mm512_moveldup_ps(_mm512_castsi512_ps(r32)));
+                g32         = _mm512_castps_si512(_mm512_moveldup_ps(_mm512_castsi512_ps(g32)));
+                b32         = _mm512_castps_si512(_mm512_moveldup_ps(_mm512_castsi512_ps(b32)));
+                __m512i s   = _mm512_add_epi32(_mm512_mullo_epi32(r32, cr), _mm512_mullo_epi32(g32, cg));
+                s           = _mm512_add_epi32(_mm512_add_epi32(s, _mm512_mullo_epi32(b32, cb)), uv_bias);
+                uv[k]       = _mm512_srai_epi32(s, SHIFT);
+            }
+            _mm512_storeu_si512(dst0 + j, v_pack_u8(y[0], y[1], y[2], y[3]));
+            _mm512_storeu_si512(dst2 + j, v_pack_u8(uv[0], uv[1], uv[2], uv[3]));
+
+            load_rgb_x64<srccn, bIdx>(src1 + j * srccn, r, g, b);
+            for (int32_t k = 0; k < 4; ++k) {
+                y[k] = rgb_2_y_x16(widen(r, k), widen(g, k), widen(b, k));
+            }
+            _mm512_storeu_si512(dst1 + j, v_pack_u8(y[0], y[1], y[2], y[3]));
+        }
+        for (; j < width / 2 * 2; j += 2) {
+            const uint8_t *p0 = src0 + j * srccn;
+            const uint8_t *p1 = src1 + j * srccn;
+            const int32_t halfShift = (1 << (SHIFT - 1));
+            const uint8_t *px[4] = {p0, p0 + srccn, p1, p1 + srccn};
+            uint8_t *dy[4]       = {dst0 + j, dst0 + j + 1, dst1 + j, dst1 + j + 1};
+            for (int32_t p = 0; p < 4; ++p) {
+                int32_t yy = CRY_coeff * px[p][2 - bIdx] + CGY_coeff * px[p][1] + CBY_coeff * px[p][bIdx] + halfShift + (16 << SHIFT);
+                *dy[p]     = sat_cast_u8(yy >> SHIFT);
+            }
+            int32_t r00 = p0[2 - bIdx], g00 = p0[1], b00 = p0[bIdx];
+            int32_t u00 = CRU_coeff * r00 + CGU_coeff * g00 + CBU_coeff * b00 + halfShift + (128 << SHIFT);
+            int32_t v00 = CBU_coeff * r00 + CGV_coeff * g00 + CBV_coeff * b00 + halfShift + (128 << SHIFT);
+            dst2[j + (isUV ? 0 : 1)] = sat_cast_u8(u00 >> SHIFT);
+            dst2[j + (isUV ? 1 : 0)] = sat_cast_u8(v00 >> SHIFT);
+        }
+    }
+    return ppl::common::RC_SUCCESS;
+}
+
+static inline int32_t pack_epi16(int32_t lo, int32_t hi)
+{
+    return (int32_t)((uint32_t)(uint16_t)lo | ((uint32_t)(uint16_t)hi << 16));
+}
+
+// Row part of the SSE BGR2I420 kernel on 64 pixels at a time: the lane
+// gather puts 16 whole pixels in each 128-bit lane, so its 16-bit
+// multiply-add body runs unchanged per lane and the results match it exactly.
+int32_t bgr_2_i420_line(
+    const uint8_t *src,
+    int32_t half_width,
+    const int32_t *coeffs,
+    uint8_t *dstY,
+    uint8_t *dstU,
+    uint8_t *dstV)
+{
+    const int32_t shift      = 13;
+    const int32_t half_shift = 1 << (shift - 1);
+    const int32_t bias_YC = 32, bias_UVC = 257;
+    const __m512i coeff_YBG = _mm512_set1_epi32(pack_epi16(coeffs[0], coeffs[1]));
+    const __m512i coeff_YRC = _mm512_set1_epi32(pack_epi16(coeffs[2], bias_YC));
+    const __m512i coeff_UBG = _mm512_set1_epi32(pack_epi16(coeffs[3], coeffs[4]));
+    const __m512i coeff_URC = _mm512_set1_epi32(pack_epi16(coeffs[5], bias_UVC));
+    const __m512i coeff_VBG = _mm512_set1_epi32(pack_epi16(coeffs[6], coeffs[7]));
+    const __m512i coeff_VRC = _mm512_set1_epi32(pack_epi16(coeffs[8], bias_UVC));
+    const __m512i half      = _mm512_set1_epi32(half_shift << 16);
+    const __m512i vzero     = _mm512_setzero_si512();
+
+    const __m512i bgl0 = _mm512_broadcast_i32x4(_mm_setr_epi8(0, 1, 3, 4, 6, 7, 9, 10, 12, 13, 15, -1, -1, -1, -1, -1));
+    const __m512i bgl1 = _mm512_broadcast_i32x4(_mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 0, 2, 3, 5, 6));
+    const __m512i bgh1 = _mm512_broadcast_i32x4(_mm_setr_epi8(8, 9, 11, 12, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1));
+    const __m512i bgh2 = _mm512_broadcast_i32x4(_mm_setr_epi8(-1, -1, -1, -1, -1, -1, 1, 2, 4, 5, 7, 8, 10, 11, 13, 14));
+    const __m512i rcl0 = _mm512_broadcast_i32x4(_mm_setr_epi8(2, -1, 5, -1, 8, -1, 11, -1, 14, -1, -1, -1, -1, -1, -1, -1));
+    const __m512i rcl1 = _mm512_broadcast_i32x4(_mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 1, -1, 4, -1, 7, -1));
+    const __m512i rch1 = _mm512_broadcast_i32x4(_mm_setr_epi8(10, -1, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1));
+    const __m512i rch2 = _mm512_broadcast_i32x4(_mm_setr_epi8(-1, -1, -1, -1, 0, -1, 3, -1, 6, -1, 9, -1, 12, -1, 15, -1));
+    const __m512i even = _mm512_broadcast_i32x4(_mm_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, -1, -1, -1, -1, -1, -1, -1, -1));
+    const __m512i low_halves = _mm512_setr_epi64(0, 2, 4, 6, 1, 3, 5, 7);
+
+    int32_t w = 0;
+    for (; w <= half_width - 32; w += 32, src += 192) {
+        __m512i d0, d1, d2;
+        v_load_lanes3(src, d0, d1, d2);
+        __m512i bgl = _mm512_or_si512(_mm512_shuffle_epi8(d0, bgl0), _mm512_shuffle_epi8(d1, bgl1));
+        __m512i bgh = _mm512_or_si512(_mm512_shuffle_epi8(d1, bgh1), _mm512_shuffle_epi8(d2, bgh2));
+        __m512i rcl = _mm512_or_si512(_mm512_shuffle_epi8(d0, rcl0), _mm512_shuffle_epi8(d1, rcl1));
+        __m512i rch = _mm512_or_si512(_mm512_shuffle_epi8(d1, rch1), _mm512_shuffle_epi8(d2, rch2));
+
+        __m512i bg[4] = {_mm512_unpacklo_epi8(bgl, vzero), _mm512_unpackhi_epi8(bgl, vzero), _mm512_unpacklo_epi8(bgh, vzero), _mm512_unpackhi_epi8(bgh, vzero)};
+        __m512i rc[4] = {_mm512_or_si512(_mm512_unpacklo_epi8(rcl, vzero), half), _mm512_or_si512(_mm512_unpackhi_epi8(rcl, vzero), half),
+                         _mm512_or_si512(_mm512_unpacklo_epi8(rch, vzero), half), _mm512_or_si512(_mm512_unpackhi_epi8(rch, vzero), half)};
+
+        __m512i Y[4];
+        for (int32_t k = 0; k < 4; ++k) {
+            Y[k] = _mm512_srai_epi32(_mm512_add_epi32(_mm512_madd_epi16(bg[k], coeff_YBG), _mm512_madd_epi16(rc[k], coeff_YRC)), shift);
+        }
+        _mm512_storeu_si512(dstY + 2 * w, _mm512_packus_epi16(_mm512_packus_epi32(Y[0], Y[1]), _mm512_packus_epi32(Y[2], Y[3])));
+
+        if (dstU) {
+            __m512i U[4], V[4];
+            for (int32_t k = 0; k < 4; ++k) {
+                U[k] = _mm512_srai_epi32(_mm512_add_epi32(_mm512_madd_epi16(bg[k], coeff_UBG), _mm512_madd_epi16(rc[k], coeff_URC)), shift);
+                V[k] = _mm512_srai_epi32(_mm512_add_epi32(_mm512_madd_epi16(bg[k], coeff_VBG), _mm512_madd_epi16(rc[k], coeff_VRC)), shift);
+            }
+            __m512i u = _mm512_shuffle_epi8(_mm512_packus_epi16(_mm512_packus_epi32(U[0], U[1]), _mm512_packus_epi32(U[2], U[3])), even);
+            __m512i v = _mm512_shuffle_epi8(_mm512_packus_epi16(_mm512_packus_epi32(V[0], V[1]), _mm512_packus_epi32(V[2], V[3])), even);
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(dstU + w), _mm512_castsi512_si256(_mm512_permutexvar_epi64(low_halves, u)));
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(dstV + w), _mm512_castsi512_si256(_mm512_permutexvar_epi64(low_halves, v)));
+        }
+    }
+    return w;
+}
+
+#define INSTANTIATE_NV_2_RGB(dstcn, blueIdx, isUV) \
+    template ::ppl::common::RetCode nv_2_rgb<dstcn, blueIdx, isUV>(int32_t height, int32_t width, int32_t inYStride, const uint8_t *inY, int32_t inUVStride, const uint8_t *inUV, int32_t outWidthStride, uint8_t *outData);
+INSTANTIATE_NV_2_RGB(3, 0, true)
+INSTANTIATE_NV_2_RGB(3, 2, true)
+INSTANTIATE_NV_2_RGB(3, 0, false)
+INSTANTIATE_NV_2_RGB(3, 2, false)
+INSTANTIATE_NV_2_RGB(4, 0, true)
+INSTANTIATE_NV_2_RGB(4, 2, true)
+INSTANTIATE_NV_2_RGB(4, 0, false)
+INSTANTIATE_NV_2_RGB(4, 2, false)
+
+#define INSTANTIATE_RGB_2_NV(srccn, bIdx, isUV) \
+    template ::ppl::common::RetCode rgb_2_nv<srccn, bIdx, isUV>(int32_t height, int32_t width, int32_t inWidthStride, const uint8_t *inData, int32_t outYStride, uint8_t *outY, int32_t outUVStride, uint8_t *outUV);
+INSTANTIATE_RGB_2_NV(3, 0, true)
+INSTANTIATE_RGB_2_NV(3, 2, true)
+INSTANTIATE_RGB_2_NV(3, 0, false)
+INSTANTIATE_RGB_2_NV(3, 2, false)
+INSTANTIATE_RGB_2_NV(4, 0, true)
+INSTANTIATE_RGB_2_NV(4, 2, true)
+INSTANTIATE_RGB_2_NV(4, 0, false)
+INSTANTIATE_RGB_2_NV(4, 2, false)
+
+template ::ppl::common::RetCode i420_2_rgb<3, 0>(int32_t height, int32_t width, int32_t inYStride, const uint8_t *inY, int32_t inUStride, const uint8_t *inU, int32_t inVStride, const uint8_t *inV, int32_t outWidthStride, uint8_t *outData);
+template ::ppl::common::RetCode i420_2_rgb<4, 0>(int32_t height, int32_t width, int32_t inYStride, const uint8_t *inY, int32_t inUStride, const uint8_t *inU, int32_t inVStride, const uint8_t *inV, int32_t outWidthStride, uint8_t *outData);
+template ::ppl::common::RetCode i420_2_rgb<3, 2>(int32_t height, int32_t width, int32_t inYStride, const uint8_t *inY, int32_t inUStride, const uint8_t *inU, int32_t inVStride, const uint8_t *inV, int32_t outWidthStride, uint8_t *outData);
+template ::ppl::common::RetCode i420_2_rgb<4, 2>(int32_t height, int32_t width, int32_t inYStride, const uint8_t *inY, int32_t inUStride, const uint8_t *inU, int32_t inVStride, const uint8_t *inV, int32_t outWidthStride, uint8_t *outData);
+
+}
+}
+}
+} // namespace ppl::cv::x86::avx512
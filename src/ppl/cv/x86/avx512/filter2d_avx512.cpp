@@ -0,0 +1,339 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+#include "ppl/cv/x86/avx512/internal_avx512.hpp"
+#include <immintrin.h>
+#include <algorithm>
+#include <vector>
+
+namespace ppl {
+namespace cv {
+namespace x86 {
+namespace avx512 {
+
+// Every output sums its taps fx outer and fy inner with one fused
+// multiply-add each, which is the order of every fma::convolution_f/_b
+// variant. kRows output rows are done together so that each source row is
+// loaded once for all of them. Inner columns read the source rows in place;
+// only the radius columns next to each side are copied out with their border,
+// and the last columns of a row are done with masked loads.
+
+static const int32_t kRows = 4;
+
+static inline int32_t border_index(int32_t p, int32_t len, BorderType border_type)
+{
+    if (p >= 0 && p < len) {
+        return p;
+    }
+    if (border_type == ppl::cv::BORDER_CONSTANT) {
+        return -1;
+    }
+    if (border_type == ppl::cv::BORDER_REPLICATE) {
+        return p < 0 ? 0 : len - 1;
+    }
+    int32_t delta = border_type == ppl::cv::BORDER_REFLECT_101 ? 1 : 0;
+    if (len == 1) {
+        return 0;
+    }
+    do {
+        p = p < 0 ? -p - 1 + delta : 2 * len - p - 1 - delta;
+    } while (p < 0 || p >= len);
+    return p;
+}
+
+static inline __mmask16 tail_mask(int32_t remain)
+{
+    if (remain <= 0) {
+        return 0;
+    }
+    return remain >= 16 ? (__mmask16)0xffff : (__mmask16)((1u << remain) - 1);
+}
+
+static inline __m512 load_f32(const float *ptr, __mmask16 mask)
+{
+    return _mm512_maskz_loadu_ps(mask, ptr);
+}
+
+static inline __m512 load_f32(const uint8_t *ptr, __mmask16 mask)
+{
+    return _mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(_mm_maskz_loadu_epi8(mask, ptr)));
+}
+
+static inline void store_f32(float *ptr, __m512 v, __mmask16 mask)
+{
+    _mm512_mask_storeu_ps(ptr, mask, v);
+}
+
+static inline void store_f32(uint8_t *ptr, __m512 v, __mmask16 mask)
+{
+    __m512i m_int = _mm512_max_epi32(_mm512_cvtps_epi32(v), _mm512_setzero_si512());
+    _mm_mask_storeu_epi8(ptr, mask, _mm512_cvtusepi32_epi8(m_int));
+}
+
+// Output row o takes tap fy from window row o + fy, so window row k, loaded
+// once, feeds rows o = k - fy. The first and last three window rows reach
+// only some of the four output rows and are peeled off, which needs
+// filterSize >= 3.
+#define FILTER2D_LOAD(k)                                         \
+    {                                                            \
+        const T *src = rows[k] + x + fx * cn;                    \
+        m_src0       = load_f32(src, mask0);                     \
+        m_src1       = load_f32(src + 16, mask1);                \
+    }
+#define FILTER2D_ACC(acc0, acc1, fy)                                        \
+    {                                                                       \
+        __m512 m_coef = _mm512_set1_ps(filter[fx + (fy)*filterSize]);       \
+        acc0          = _mm512_fmadd_ps(m_coef, m_src0, acc0);              \
+        acc1          = _mm512_fmadd_ps(m_coef, m_src1, acc1);              \
+    }
+
+// Filters 32 columns starting at x for four output rows, the first 16
+// loaded and stored under mask0 and the second under mask1. rows[k] is
+// bordered source row k of the window, dst[o] output row o.
+template <int32_t FS, typename T>
+static inline void convolve_4rows(
+    const T *const *rows,
+    int32_t size,
+    const float *filter,
+    int32_t cn,
+    int32_t x,
+    __mmask16 mask0,
+    __mmask16 mask1,
+    T *const *dst)
+{
+    const int32_t filterSize = FS > 0 ? FS : size;
+    __m512 m_acc00 = _mm512_setzero_ps(), m_acc01 = _mm512_setzero_ps();
+    __m512 m_acc10 = _mm512_setzero_ps(), m_acc11 = _mm512_setzero_ps();
+    __m512 m_acc20 = _mm512_setzero_ps(), m_acc21 = _mm512_setzero_ps();
+    __m512 m_acc30 = _mm512_setzero_ps(), m_acc31 = _mm512_setzero_ps();
+    __m512 m_src0, m_src1;
+    for (int32_t fx = 0; fx < filterSize; fx++) {
+        FILTER2D_LOAD(0);
+        FILTER2D_ACC(m_acc00, m_acc01, 0);
+        FILTER2D_LOAD(1);
+        FILTER2D_ACC(m_acc00, m_acc01, 1);
+        FILTER2D_ACC(m_acc10, m_acc11, 0);
+        FILTER2D_LOAD(2);
+        FILTER2D_ACC(m_acc00, m_acc01, 2);
+        FILTER2D_ACC(m_acc10, m_acc11, 1);
+        FILTER2D_ACC(m_acc20, m_acc21, 0);
+        for (int32_t k = 3; k < filterSize; k++) {
+            FILTER2D_LOAD(k);
+            FILTER2D_ACC(m_acc00, m_acc01, k);
+            FILTER2D_ACC(m_acc10, m_acc11, k - 1);
+            FILTER2D_ACC(m_acc20, m_acc21, k - 2);
+            FILTER2D_ACC(m_acc30, m_acc31, k - 3);
+        }
+        FILTER2D_LOAD(filterSize);
+        FILTER2D_ACC(m_acc10, m_acc11, filterSize - 1);
+        FILTER2D_ACC(m_acc20, m_acc21, filterSize - 2);
+        FILTER2D_ACC(m_acc30, m_acc31, filterSize - 3);
+        FILTER2D_LOAD(filterSize + 1);
+        FILTER2D_ACC(m_acc20, m_acc21, filterSize - 1);
+        FILTER2D_ACC(m_acc30, m_acc31, filterSize - 2);
+        FILTER2D_LOAD(filterSize + 2);
+        FILTER2D_ACC(m_acc30, m_acc31, filterSize - 1);
+    }
+    store_f32(dst[0] + x, m_acc00, mask0);
+    store_f32(dst[0] + x + 16, m_acc01, mask1);
+    store_f32(dst[1] + x, m_acc10, mask0);
+    store_f32(dst[1] + x + 16, m_acc11, mask1);
+    store_f32(dst[2] + x, m_acc20, mask0);
+    store_f32(dst[2] + x + 16, m_acc21, mask1);
+    store_f32(dst[3] + x, m_acc30, mask0);
+    store_f32(dst[3] + x + 16, m_acc31, mask1);
+}
+
+template <int32_t FS, typename T>
+static inline void convolve_1row(
+    const T *const *rows,
+    int32_t size,
+    const float *filter,
+    int32_t cn,
+    int32_t x,
+    __mmask16 mask0,
+    __mmask16 mask1,
+    T *const *dst)
+{
+    const int32_t filterSize = FS > 0 ? FS : size;
+    __m512 m_acc0 = _mm512_setzero_ps(), m_acc1 = _mm512_setzero_ps();
+    __m512 m_src0, m_src1;
+    for (int32_t fx = 0; fx < filterSize; fx++) {
+        for (int32_t fy = 0; fy < filterSize; fy++) {
+            FILTER2D_LOAD(fy);
+            FILTER2D_ACC(m_acc0, m_acc1, fy);
+        }
+    }
+    store_f32(dst[0] + x, m_acc0, mask0);
+    store_f32(dst[0] + x + 16, m_acc1, mask1);
+}
+
+#undef FILTER2D_LOAD
+#undef FILTER2D_ACC
+
+template <int32_t R, int32_t FS, typename T>
+static void convolve_rows(
+    const T *const *rows,
+    int32_t filterSize,
+    const float *filter,
+    int32_t cn,
+    int32_t length,
+    T *const *dst)
+{
+    for (int32_t x = 0; x < length; x += 32) {
+        __mmask16 mask0 = tail_mask(length - x);
+        __mmask16 mask1 = tail_mask(length - x - 16);
+        if (R == kRows) {
+            convolve_4rows<FS, T>(rows, filterSize, filter, cn, x, mask0, mask1, dst);
+        } else {
+            convolve_1row<FS, T>(rows, filterSize, filter, cn, x, mask0, mask1, dst);
+        }
+    }
+}
+
+// The common 3, 5 and 7 tap filters get loops with constant bounds, as the
+// fma kernels have a template for each.
+template <int32_t R, typename T>
+static void convolve_inner(
+    const T *const *rows,
+    int32_t filterSize,
+    const float *filter,
+    int32_t cn,
+    int32_t length,
+    T *const *dst)
+{
+    switch (filterSize) {
+        case 3:
+            convolve_rows<R, 3, T>(rows, filterSize, filter, cn, length, dst);
+            break;
+        case 5:
+            convolve_rows<R, 5, T>(rows, filterSize, filter, cn, length, dst);
+            break;
+        case 7:
+            convolve_rows<R, 7, T>(rows, filterSize, filter, cn, length, dst);
+            break;
+        default:
+            convolve_rows<R, 0, T>(rows, filterSize, filter, cn, length, dst);
+            break;
+    }
+}
+
+template <typename T>
+static void convolution(
+    int32_t height,
+    int32_t width,
+    int32_t inWidthStride,
+    const T *inData,
+    int32_t filterSize,
+    const float *filter,
+    int32_t outWidthStride,
+    T *outData,
+    int32_t cn,
+    BorderType border_type)
+{
+    int32_t radius      = filterSize / 2;
+    int32_t length      = width * cn;
+    int32_t edge        = radius * cn;
+    int32_t leftEnd     = std::min(edge, length);
+    int32_t rightBegin  = std::max(edge, length - edge);
+    int32_t windowRows  = kRows + filterSize - 1;
+    int32_t leftLength  = leftEnd + 2 * edge;
+    int32_t rightLength = length - rightBegin + 2 * edge;
+
+    // bordered column b of a row is source column b - edge
+    std::vector<int32_t> leftTab(leftLength), rightTab(rightLength);
+    for (int32_t b = 0; b < leftLength; b++) {
+        int32_t sx = border_index(b / cn - radius, width, border_type);
+        leftTab[b] = sx < 0 ? -1 : sx * cn + b % cn;
+    }
+    for (int32_t b = 0; b < rightLength; b++) {
+        int32_t sx  = border_index((rightBegin + b) / cn - radius, width, border_type);
+        rightTab[b] = sx < 0 ? -1 : sx * cn + (rightBegin + b) % cn;
+    }
+    std::vector<T> zeros(length, 0);
+    std::vector<T> leftEdge(windowRows * leftLength), rightEdge(windowRows * rightLength);
+    std::vector<const T *> rows(windowRows), leftRows(windowRows), rightRows(windowRows);
+    T *dst[kRows], *rightDst[kRows], *innerDst[kRows];
+
+    for (int32_t y = 0; y < height;) {
+        int32_t count = height - y >= kRows && filterSize >= 3 ? kRows : 1;
+        for (int32_t k = 0; k < count + filterSize - 1; k++) {
+            int32_t sy   = border_index(y + k - radius, height, border_type);
+            const T *src = sy < 0 ? zeros.data() : inData + sy * inWidthStride;
+            T *left      = leftEdge.data() + k * leftLength;
+            T *right     = rightEdge.data() + k * rightLength;
+            for (int32_t b = 0; b < leftLength; b++) {
+                left[b] = leftTab[b] < 0 ? 0 : src[leftTab[b]];
+            }
+            for (int32_t b = 0; b < rightLength; b++) {
+                right[b] = rightTab[b] < 0 ? 0 : src[rightTab[b]];
+            }
+            rows[k]      = src;
+            leftRows[k]  = left;
+            rightRows[k] = right;
+        }
+        for (int32_t o = 0; o < count; o++) {
+            dst[o]      = outData + (y + o) * outWidthStride;
+            innerDst[o] = dst[o] + edge;
+            rightDst[o] = dst[o] + rightBegin;
+        }
+        if (count == kRows) {
+            convolve_rows<kRows, 0, T>(leftRows.data(), filterSize, filter, cn, leftEnd, dst);
+            convolve_inner<kRows, T>(rows.data(), filterSize, filter, cn, rightBegin - edge, innerDst);
+            convolve_rows<kRows, 0, T>(rightRows.data(), filterSize, filter, cn, length - rightBegin, rightDst);
+        } else {
+            convolve_rows<1, 0, T>(leftRows.data(), filterSize, filter, cn, leftEnd, dst);
+            convolve_inner<1, T>(rows.data(), filterSize, filter, cn, rightBegin - edge, innerDst);
+            convolve_rows<1, 0, T>(rightRows.data(), filterSize, filter, cn, length - rightBegin, rightDst);
+        }
+        y += count;
+    }
+}
+
+void convolution_f(
+    int32_t height,
+    int32_t width,
+    int32_t inWidthStride,
+    const float *inData,
+    int32_t filterSize,
+    const float *filter,
+    int32_t outWidthStride,
+    float *outData,
+    int32_t cn,
+    BorderType border_type)
+{
+    convolution<float>(height, width, inWidthStride, inData, filterSize, filter, outWidthStride, outData, cn, border_type);
+}
+
+void convolution_b(
+    int32_t height,
+    int32_t width,
+    int32_t inWidthStride,
+    const uint8_t *inData,
+    int32_t filterSize,
+    const float *filter,
+    int32_t outWidthStride,
+    uint8_t *outData,
+    int32_t cn,
+    BorderType border_type)
+{
+    convolution<uint8_t>(height, width, inWidthStride, inData, filterSize, filter, outWidthStride, outData, cn, border_type);
+}
+
+}
+}
+}
+} // namespace ppl::cv::x86::avx512
@@ -0,0 +1,180 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "ppl/cv/x86/avx512/internal_avx512.hpp"
+#include <immintrin.h>
+
+namespace ppl {
+namespace cv {
+namespace x86 {
+namespace avx512 {
+
+// Sixteen-wide versions of the float GaussianBlur loops of
+// avx/gaussblur_avx.cpp. They use separate multiplies and adds in the same
+// order as the AVX code, never fused ones, so the two tiers agree exactly.
+
+// The rounding-mode forms with the current mode are the plain add and
+// multiply, but unlike _mm512_add_ps() and _mm512_mul_ps() compilers do not
+// contract them into a fused multiply-add.
+static inline __m512 v_add(__m512 a, __m512 b)
+{
+    return _mm512_add_round_ps(a, b, _MM_FROUND_CUR_DIRECTION);
+}
+
+static inline __m512 v_mul(__m512 a, __m512 b)
+{
+    return _mm512_mul_round_ps(a, b, _MM_FROUND_CUR_DIRECTION);
+}
+
+static inline __m512 symm_row_k3(const float *src, int32_t cn, __m512 f0, __m512 f1)
+{
+    __m512 x0 = v_add(_mm512_loadu_ps(src), _mm512_loadu_ps(src + 2 * cn));
+    __m512 x1 = v_mul(_mm512_loadu_ps(src + cn), f1);
+    return v_add(v_mul(x0, f0), x1);
+}
+
+static inline __m512 symm_row_k5(const float *src, int32_t cn, __m512 f0, __m512 f1, __m512 f2)
+{
+    __m512 x0 = v_add(_mm512_loadu_ps(src), _mm512_loadu_ps(src + 4 * cn));
+    __m512 x1 = v_add(_mm512_loadu_ps(src + cn), _mm512_loadu_ps(src + 3 * cn));
+    __m512 x2 = v_mul(_mm512_loadu_ps(src + 2 * cn), f2);
+    x0        = v_mul(x0, f0);
+    x1        = v_mul(x1, f1);
+    return v_add(v_add(x0, x1), x2);
+}
+
+// Horizontally filtered rows j - radius .. j + radius are kept in r0..r4 and
+// slide down one row per output row.
+template <int32_t radius>
+static int32_t gaussblur_symm(
+    const float **src,
+    float *dst,
+    int32_t length,
+    int32_t cn,
+    int32_t dstep,
+    int32_t rows,
+    const float *kernel)
+{
+    __m512 f0 = _mm512_set1_ps(kernel[0]);
+    __m512 f1 = _mm512_set1_ps(kernel[1]);
+    __m512 f2 = _mm512_set1_ps(kernel[radius]);
+
+    int32_t i = 0;
+    for (; i <= length - 16; i += 16) {
+        __m512 r0, r1, r2, r3, r4, s;
+        if (radius == 1) {
+            r0 = symm_row_k3(src[-1] + i, cn, f0, f1);
+            r1 = symm_row_k3(src[0] + i, cn, f0, f1);
+        } else {
+            r0 = symm_row_k5(src[-2] + i, cn, f0, f1, f2);
+            r1 = symm_row_k5(src[-1] + i, cn, f0, f1, f2);
+            r2 = symm_row_k5(src[0] + i, cn, f0, f1, f2);
+            r3 = symm_row_k5(src[1] + i, cn, f0, f1, f2);
+        }
+        for (int32_t j = 0; j < rows; j++) {
+            if (radius == 1) {
+                r2 = symm_row_k3(src[j + 1] + i, cn, f0, f1);
+                s  = v_add(v_mul(v_add(r0, r2), f0), v_mul(r1, f1));
+                r0 = r1;
+                r1 = r2;
+            } else {
+                r4        = symm_row_k5(src[j + 2] + i, cn, f0, f1, f2);
+                __m512 x0 = v_mul(v_add(r0, r4), f0);
+                __m512 x1 = v_mul(v_add(r1, r3), f1);
+                s         = v_add(v_add(x0, x1), v_mul(r2, f2));
+                r0        = r1;
+                r1        = r2;
+                r2        = r3;
+                r3        = r4;
+            }
+            _mm512_storeu_ps(dst + j * dstep + i, s);
+        }
+    }
+    return i;
+}
+
+int32_t gaussblur_symm_f32(
+    const float **src,
+    float *dst,
+    int32_t length,
+    int32_t cn,
+    int32_t dstep,
+    int32_t rows,
+    const float *kernel,
+    int32_t ksize)
+{
+    if (ksize == 3) {
+        return gaussblur_symm<1>(src, dst, length, cn, dstep, rows, kernel);
+    }
+    return gaussblur_symm<2>(src, dst, length, cn, dstep, rows, kernel);
+}
+
+int32_t gaussblur_row_f32(
+    const float *src,
+    float *dst,
+    int32_t length,
+    int32_t cn,
+    const float *kernel,
+    int32_t ksize)
+{
+    int32_t i = 0;
+    for (; i <= length - 32; i += 32) {
+        const float *s = src + i;
+        __m512 s0 = _mm512_setzero_ps(), s1 = s0;
+        for (int32_t k = 0; k < ksize; k++, s += cn) {
+            __m512 f = _mm512_set1_ps(kernel[k]);
+            s0       = v_add(s0, v_mul(_mm512_loadu_ps(s), f));
+            s1       = v_add(s1, v_mul(_mm512_loadu_ps(s + 16), f));
+        }
+        // the row is filtered in place: these columns have been read for the last time
+        _mm512_storeu_ps(dst + i, s0);
+        _mm512_storeu_ps(dst + i + 16, s1);
+    }
+    return i;
+}
+
+int32_t gaussblur_col_f32(
+    const float **src,
+    float *dst,
+    int32_t length,
+    const float *ky,
+    int32_t radius)
+{
+    int32_t i = 0;
+    for (; i <= length - 32; i += 32) {
+        __m512 f  = _mm512_set1_ps(ky[0]);
+        __m512 s0 = v_mul(_mm512_loadu_ps(src[0] + i), f);
+        __m512 s1 = v_mul(_mm512_loadu_ps(src[0] + i + 16), f);
+        for (int32_t k = 1; k <= radius; k++) {
+            const float *S  = src[k] + i;
+            const float *S2 = src[-k] + i;
+            f               = _mm512_set1_ps(ky[k]);
+            __m512 x0       = v_add(_mm512_loadu_ps(S), _mm512_loadu_ps(S2));
+            __m512 x1       = v_add(_mm512_loadu_ps(S + 16), _mm512_loadu_ps(S2 + 16));
+            s0              = v_add(s0, v_mul(x0, f));
+            s1              = v_add(s1, v_mul(x1, f));
+        }
+        _mm512_storeu_ps(dst + i, s0);
+        _mm512_storeu_ps(dst + i + 16, s1);
+    }
+    return i;
+}
+
+}
+}
+}
+} // namespace ppl::cv::x86::avx512
@@ -0,0 +1,189 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#ifndef PPL_CV_X86_INTERNAL_AVX512_H_
+#define PPL_CV_X86_INTERNAL_AVX512_H_
+#include "ppl/cv/types.h"
+#include "ppl/common/retcode.h"
+#include <stdint.h>
+
+// Kernels built with AVX-512F/BW/DQ/VL. Callers check
+// isa_supported(ppl::common::ISA_X86_AVX512) first and fall back to the FMA
+// or SSE kernels, whose results these match bit for bit.
+namespace ppl {
+namespace cv {
+namespace x86 {
+namespace avx512 {
+
+template <typename T, int32_t nc>
+::ppl::common::RetCode splitAOS2SOA(
+    int32_t height,
+    int32_t width,
+    int32_t inWidthStride,
+    const T *in,
+    int32_t outWidthStride,
+    T **out);
+
+template <typename T, int32_t nc>
+void mergeSOA2AOS(
+    int32_t height,
+    int32_t width,
+    int32_t inWidthStride,
+    const T **in,
+    int32_t outWidthStride,
+    T *out);
+
+template <int32_t dstcn, int32_t blueIdx, bool isUV>
+::ppl::common::RetCode nv_2_rgb(
+    int32_t height,
+    int32_t width,
+    int32_t inYStride,
+    const uint8_t *inY,
+    int32_t inUVStride,
+    const uint8_t *inUV,
+    int32_t outWidthStride,
+    uint8_t *outData);
+
+template <int32_t srccn, int32_t bIdx, bool isUV>
+::ppl::common::RetCode rgb_2_nv(
+    int32_t height,
+    int32_t width,
+    int32_t inWidthStride,
+    const uint8_t *inData,
+    int32_t outYStride,
+    uint8_t *outY,
+    int32_t outUVStride,
+    uint8_t *outUV);
+
+template <int32_t dstcn, int32_t blueIdx>
+::ppl::common::RetCode i420_2_rgb(
+    int32_t height,
+    int32_t width,
+    int32_t inYStride,
+    const uint8_t *inY,
+    int32_t inUStride,
+    const uint8_t *inU,
+    int32_t inVStride,
+    const uint8_t *inV,
+    int32_t outWidthStride,
+    uint8_t *outData);
+
+// coeffs holds the 13-bit YB, YG, YR, UB, UG, UR, VB, VG, VR factors of the
+// SSE kernel; dstU and dstV are null on odd rows. Returns the number of pixel
+// pairs done, a multiple of 32, for the caller to finish the row.
+int32_t bgr_2_i420_line(
+    const uint8_t *src,
+    int32_t half_width,
+    const int32_t *coeffs,
+    uint8_t *dstY,
+    uint8_t *dstU,
+    uint8_t *dstV);
+
+int32_t resize_linear_twoline_fp32(
+    int32_t max_length,
+    int32_t channels,
+    const float *in_data_0,
+    const float *in_data_1,
+    const int32_t *w_offset,
+    const float *w_coeff,
+    float h_coeff,
+    float *row_0,
+    float *row_1,
+    float *out_data);
+
+int32_t resize_linear_w_oneline_fp32(
+    int32_t max_length,
+    int32_t channels,
+    const float *in_data,
+    const int32_t *w_offset,
+    const float *w_coeff,
+    float *row);
+
+template <typename T, int32_t nc, ppl::cv::BorderType borderMode>
+::ppl::common::RetCode warpaffine_linear(
+    int32_t inHeight,
+    int32_t inWidth,
+    int32_t inWidthStride,
+    int32_t rowBegin,
+    int32_t outHeight,
+    int32_t outWidth,
+    int32_t outWidthStride,
+    T *dst,
+    const T *src,
+    const double *M,
+    T delta);
+
+// Filter2D. The border is built a few rows at a time while the image is
+// read, so no bordered copy of the whole image is made.
+void convolution_f(
+    int32_t height,
+    int32_t width,
+    int32_t inWidthStride,
+    const float *inData,
+    int32_t filterSize,
+    const float *filter,
+    int32_t outWidthStride,
+    float *outData,
+    int32_t cn,
+    BorderType border_type);
+
+void convolution_b(
+    int32_t height,
+    int32_t width,
+    int32_t inWidthStride,
+    const uint8_t *inData,
+    int32_t filterSize,
+    const float *filter,
+    int32_t outWidthStride,
+    uint8_t *outData,
+    int32_t cn,
+    BorderType border_type);
+
+// GaussianBlur float loops. gaussblur_symm_f32() is the fused 3- or 5-tap
+// filter of RowVec_32f_k3/k5 for up to 12 output rows, gaussblur_row_f32() and
+// gaussblur_col_f32() the passes of RowVec_32f and SymmColumnVec_32f. Each
+// returns the number of elements done.
+int32_t gaussblur_symm_f32(
+    const float **src,
+    float *dst,
+    int32_t length,
+    int32_t cn,
+    int32_t dstep,
+    int32_t rows,
+    const float *kernel,
+    int32_t ksize);
+
+int32_t gaussblur_row_f32(
+    const float *src,
+    float *dst,
+    int32_t length,
+    int32_t cn,
+    const float *kernel,
+    int32_t ksize);
+
+int32_t gaussblur_col_f32(
+    const float **src,
+    float *dst,
+    int32_t length,
+    const float *ky,
+    int32_t radius);
+
+}
+}
+}
+} // namespace ppl::cv::x86::avx512
+#endif //! PPL_CV_X86_INTERNAL_AVX512_H_
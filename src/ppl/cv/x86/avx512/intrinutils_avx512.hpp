@@ -0,0 +1,233 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#ifndef __INTRINUTILS_AVX512_H__
+#define __INTRINUTILS_AVX512_H__
+
+#include "ppl/cv/types.h"
+#include <immintrin.h>
+
+namespace ppl {
+namespace cv {
+namespace x86 {
+namespace avx512 {
+
+template <typename T>
+struct v_reg;
+template <>
+struct v_reg<uint8_t> {
+    typedef __m512i type;
+};
+template <>
+struct v_reg<float> {
+    typedef __m512 type;
+};
+
+inline __m512i v_load(const uint8_t *ptr)
+{
+    return _mm512_loadu_si512((const void *)ptr);
+}
+inline __m512 v_load(const float *ptr)
+{
+    return _mm512_loadu_ps(ptr);
+}
+inline void v_store(uint8_t *ptr, const __m512i &v)
+{
+    _mm512_storeu_si512((void *)ptr, v);
+}
+inline void v_store(float *ptr, const __m512 &v)
+{
+    _mm512_storeu_ps(ptr, v);
+}
+
+// The 3-channel byte helpers first gather 128-bit chunks 3g, 3g + 1 and 3g + 2
+// of the 192 loaded bytes into lane g of three registers; every lane then
+// holds 16 whole pixels and the 128-bit SSE blend/shuffle trick applies as is.
+// v_load_lanes3() stops after the gather, for kernels that port a 16-pixel
+// SSE loop body lane by lane.
+inline void v_load_lanes3(const uint8_t *ptr, __m512i &s0, __m512i &s1, __m512i &s2)
+{
+    __m512i l0 = _mm512_loadu_si512((const void *)ptr);
+    __m512i l1 = _mm512_loadu_si512((const void *)(ptr + 64));
+    __m512i l2 = _mm512_loadu_si512((const void *)(ptr + 128));
+
+    s0 = _mm512_permutex2var_epi64(l0, _mm512_setr_epi64(0, 1, 6, 7, 12, 13, 0, 0), l1);
+    s1 = _mm512_permutex2var_epi64(l0, _mm512_setr_epi64(2, 3, 8, 9, 14, 15, 0, 0), l1);
+    s2 = _mm512_permutex2var_epi64(l0, _mm512_setr_epi64(4, 5, 10, 11, 0, 0, 0, 0), l1);
+    s0 = _mm512_permutex2var_epi64(s0, _mm512_setr_epi64(0, 1, 2, 3, 4, 5, 10, 11), l2);
+    s1 = _mm512_permutex2var_epi64(s1, _mm512_setr_epi64(0, 1, 2, 3, 4, 5, 12, 13), l2);
+    s2 = _mm512_permutex2var_epi64(s2, _mm512_setr_epi64(0, 1, 2, 3, 8, 9, 14, 15), l2);
+}
+
+inline void v_load_deinterleave(const uint8_t *ptr, __m512i &a, __m512i &b, __m512i &c)
+{
+    __m512i s0, s1, s2;
+    v_load_lanes3(ptr, s0, s1, s2);
+
+    const __mmask64 m0 = 0x4924492449244924ULL;
+    const __mmask64 m1 = 0x2492249224922492ULL;
+    __m512i a0 = _mm512_mask_blend_epi8(m1, _mm512_mask_blend_epi8(m0, s0, s1), s2);
+    __m512i b0 = _mm512_mask_blend_epi8(m1, _mm512_mask_blend_epi8(m0, s1, s2), s0);
+    __m512i c0 = _mm512_mask_blend_epi8(m1, _mm512_mask_blend_epi8(m0, s2, s0), s1);
+
+    const __m512i sh_b = _mm512_broadcast_i32x4(_mm_setr_epi8(0, 3, 6, 9, 12, 15, 2, 5, 8, 11, 14, 1, 4, 7, 10, 13));
+    const __m512i sh_g = _mm512_broadcast_i32x4(_mm_setr_epi8(1, 4, 7, 10, 13, 0, 3, 6, 9, 12, 15, 2, 5, 8, 11, 14));
+    const __m512i sh_r = _mm512_broadcast_i32x4(_mm_setr_epi8(2, 5, 8, 11, 14, 1, 4, 7, 10, 13, 0, 3, 6, 9, 12, 15));
+    a = _mm512_shuffle_epi8(a0, sh_b);
+    b = _mm512_shuffle_epi8(b0, sh_g);
+    c = _mm512_shuffle_epi8(c0, sh_r);
+}
+
+inline void v_store_interleave(uint8_t *ptr, const __m512i &a, const __m512i &b, const __m512i &c)
+{
+    const __m512i ish_b = _mm512_broadcast_i32x4(_mm_setr_epi8(0, 11, 6, 1, 12, 7, 2, 13, 8, 3, 14, 9, 4, 15, 10, 5));
+    const __m512i ish_g = _mm512_broadcast_i32x4(_mm_setr_epi8(5, 0, 11, 6, 1, 12, 7, 2, 13, 8, 3, 14, 9, 4, 15, 10));
+    const __m512i ish_r = _mm512_broadcast_i32x4(_mm_setr_epi8(10, 5, 0, 11, 6, 1, 12, 7, 2, 13, 8, 3, 14, 9, 4, 15));
+    __m512i a0 = _mm512_shuffle_epi8(a, ish_b);
+    __m512i b0 = _mm512_shuffle_epi8(b, ish_g);
+    __m512i c0 = _mm512_shuffle_epi8(c, ish_r);
+
+    const __mmask64 m0 = 0x4924492449244924ULL;
+    const __mmask64 m1 = 0x2492249224922492ULL;
+    __m512i s0 = _mm512_mask_blend_epi8(m1, _mm512_mask_blend_epi8(m0, a0, c0), b0);
+    __m512i s1 = _mm512_mask_blend_epi8(m1, _mm512_mask_blend_epi8(m0, b0, a0), c0);
+    __m512i s2 = _mm512_mask_blend_epi8(m1, _mm512_mask_blend_epi8(m0, c0, b0), a0);
+
+    __m512i l0 = _mm512_permutex2var_epi64(s0, _mm512_setr_epi64(0, 1, 8, 9, 0, 0, 2, 3), s1);
+    __m512i l1 = _mm512_permutex2var_epi64(s1, _mm512_setr_epi64(2, 3, 10, 11, 0, 0, 4, 5), s2);
+    __m512i l2 = _mm512_permutex2var_epi64(s0, _mm512_setr_epi64(0, 0, 6, 7, 14, 15, 0, 0), s1);
+    l0 = _mm512_permutex2var_epi64(l0, _mm512_setr_epi64(0, 1, 2, 3, 8, 9, 6, 7), s2);
+    l1 = _mm512_permutex2var_epi64(l1, _mm512_setr_epi64(0, 1, 2, 3, 12, 13, 6, 7), s0);
+    l2 = _mm512_permutex2var_epi64(l2, _mm512_setr_epi64(12, 13, 2, 3, 4, 5, 14, 15), s2);
+    _mm512_storeu_si512((void *)ptr, l0);
+    _mm512_storeu_si512((void *)(ptr + 64), l1);
+    _mm512_storeu_si512((void *)(ptr + 128), l2);
+}
+
+// 4-channel bytes: gather each channel into one dword per lane, then a
+// dword transpose within every register and a 4x4 lane transpose across them.
+inline void v_load_deinterleave(const uint8_t *ptr, __m512i &a, __m512i &b, __m512i &c, __m512i &d)
+{
+    const __m512i sh = _mm512_broadcast_i32x4(_mm_setr_epi8(0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15));
+    const __m512i tr = _mm512_setr_epi32(0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15);
+    __m512i v0 = _mm512_permutexvar_epi32(tr, _mm512_shuffle_epi8(_mm512_loadu_si512((const void *)ptr), sh));
+    __m512i v1 = _mm512_permutexvar_epi32(tr, _mm512_shuffle_epi8(_mm512_loadu_si512((const void *)(ptr + 64)), sh));
+    __m512i v2 = _mm512_permutexvar_epi32(tr, _mm512_shuffle_epi8(_mm512_loadu_si512((const void *)(ptr + 128)), sh));
+    __m512i v3 = _mm512_permutexvar_epi32(tr, _mm512_shuffle_epi8(_mm512_loadu_si512((const void *)(ptr + 192)), sh));
+
+    __m512i t0 = _mm512_shuffle_i64x2(v0, v1, _MM_SHUFFLE(1, 0, 1, 0));
+    __m512i t1 = _mm512_shuffle_i64x2(v2, v3, _MM_SHUFFLE(1, 0, 1, 0));
+    __m512i t2 = _mm512_shuffle_i64x2(v0, v1, _MM_SHUFFLE(3, 2, 3, 2));
+    __m512i t3 = _mm512_shuffle_i64x2(v2, v3, _MM_SHUFFLE(3, 2, 3, 2));
+    a = _mm512_shuffle_i64x2(t0, t1, _MM_SHUFFLE(2, 0, 2, 0));
+    b = _mm512_shuffle_i64x2(t0, t1, _MM_SHUFFLE(3, 1, 3, 1));
+    c = _mm512_shuffle_i64x2(t2, t3, _MM_SHUFFLE(2, 0, 2, 0));
+    d = _mm512_shuffle_i64x2(t2, t3, _MM_SHUFFLE(3, 1, 3, 1));
+}
+
+inline void v_store_interleave(uint8_t *ptr, const __m512i &a, const __m512i &b, const __m512i &c, const __m512i &d)
+{
+    __m512i t0 = _mm512_shuffle_i64x2(a, b, _MM_SHUFFLE(1, 0, 1, 0));
+    __m512i t1 = _mm512_shuffle_i64x2(c, d, _MM_SHUFFLE(1, 0, 1, 0));
+    __m512i t2 = _mm512_shuffle_i64x2(a, b, _MM_SHUFFLE(3, 2, 3, 2));
+    __m512i t3 = _mm512_shuffle_i64x2(c, d, _MM_SHUFFLE(3, 2, 3, 2));
+
+    const __m512i sh = _mm512_broadcast_i32x4(_mm_setr_epi8(0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15));
+    const __m512i tr = _mm512_setr_epi32(0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15);
+    __m512i v0 = _mm512_shuffle_i64x2(t0, t1, _MM_SHUFFLE(2, 0, 2, 0));
+    __m512i v1 = _mm512_shuffle_i64x2(t0, t1, _MM_SHUFFLE(3, 1, 3, 1));
+    __m512i v2 = _mm512_shuffle_i64x2(t2, t3, _MM_SHUFFLE(2, 0, 2, 0));
+    __m512i v3 = _mm512_shuffle_i64x2(t2, t3, _MM_SHUFFLE(3, 1, 3, 1));
+    _mm512_storeu_si512((void *)ptr, _mm512_shuffle_epi8(_mm512_permutexvar_epi32(tr, v0), sh));
+    _mm512_storeu_si512((void *)(ptr + 64), _mm512_shuffle_epi8(_mm512_permutexvar_epi32(tr, v1), sh));
+    _mm512_storeu_si512((void *)(ptr + 128), _mm512_shuffle_epi8(_mm512_permutexvar_epi32(tr, v2), sh));
+    _mm512_storeu_si512((void *)(ptr + 192), _mm512_shuffle_epi8(_mm512_permutexvar_epi32(tr, v3), sh));
+}
+
+// Saturates four registers of 16 int32 each to 64 bytes in element order.
+inline __m512i v_pack_u8(const __m512i &x0, const __m512i &x1, const __m512i &x2, const __m512i &x3)
+{
+    __m512i p = _mm512_packus_epi16(_mm512_packus_epi32(x0, x1), _mm512_packus_epi32(x2, x3));
+    return _mm512_permutexvar_epi32(_mm512_setr_epi32(0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15), p);
+}
+
+inline void v_load_deinterleave(const float *ptr, __m512 &a, __m512 &b, __m512 &c)
+{
+    __m512 s0 = _mm512_loadu_ps(ptr);
+    __m512 s1 = _mm512_loadu_ps(ptr + 16);
+    __m512 s2 = _mm512_loadu_ps(ptr + 32);
+    __m512 t0 = _mm512_permutex2var_ps(s0, _mm512_setr_epi32(0, 3, 6, 9, 12, 15, 18, 21, 24, 27, 30, 0, 0, 0, 0, 0), s1);
+    __m512 t1 = _mm512_permutex2var_ps(s0, _mm512_setr_epi32(1, 4, 7, 10, 13, 16, 19, 22, 25, 28, 31, 0, 0, 0, 0, 0), s1);
+    __m512 t2 = _mm512_permutex2var_ps(s0, _mm512_setr_epi32(2, 5, 8, 11, 14, 17, 20, 23, 26, 29, 0, 0, 0, 0, 0, 0), s1);
+    a = _mm512_permutex2var_ps(t0, _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 17, 20, 23, 26, 29), s2);
+    b = _mm512_permutex2var_ps(t1, _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 18, 21, 24, 27, 30), s2);
+    c = _mm512_permutex2var_ps(t2, _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 16, 19, 22, 25, 28, 31), s2);
+}
+
+inline void v_store_interleave(float *ptr, const __m512 &a, const __m512 &b, const __m512 &c)
+{
+    __m512 t0 = _mm512_permutex2var_ps(a, _mm512_setr_epi32(0, 16, 0, 1, 17, 0, 2, 18, 0, 3, 19, 0, 4, 20, 0, 5), b);
+    __m512 t1 = _mm512_permutex2var_ps(a, _mm512_setr_epi32(21, 0, 6, 22, 0, 7, 23, 0, 8, 24, 0, 9, 25, 0, 10, 26), b);
+    __m512 t2 = _mm512_permutex2var_ps(a, _mm512_setr_epi32(0, 11, 27, 0, 12, 28, 0, 13, 29, 0, 14, 30, 0, 15, 31, 0), b);
+    _mm512_storeu_ps(ptr, _mm512_permutex2var_ps(t0, _mm512_setr_epi32(0, 1, 16, 3, 4, 17, 6, 7, 18, 9, 10, 19, 12, 13, 20, 15), c));
+    _mm512_storeu_ps(ptr + 16, _mm512_permutex2var_ps(t1, _mm512_setr_epi32(0, 21, 2, 3, 22, 5, 6, 23, 8, 9, 24, 11, 12, 25, 14, 15), c));
+    _mm512_storeu_ps(ptr + 32, _mm512_permutex2var_ps(t2, _mm512_setr_epi32(26, 1, 2, 27, 4, 5, 28, 7, 8, 29, 10, 11, 30, 13, 14, 31), c));
+}
+
+inline void v_load_deinterleave(const float *ptr, __m512 &a, __m512 &b, __m512 &c, __m512 &d)
+{
+    const __m512i lo = _mm512_setr_epi32(0, 4, 8, 12, 16, 20, 24, 28, 1, 5, 9, 13, 17, 21, 25, 29);
+    const __m512i hi = _mm512_setr_epi32(2, 6, 10, 14, 18, 22, 26, 30, 3, 7, 11, 15, 19, 23, 27, 31);
+    __m512 s0 = _mm512_loadu_ps(ptr);
+    __m512 s1 = _mm512_loadu_ps(ptr + 16);
+    __m512 s2 = _mm512_loadu_ps(ptr + 32);
+    __m512 s3 = _mm512_loadu_ps(ptr + 48);
+    __m512 ab0 = _mm512_permutex2var_ps(s0, lo, s1);
+    __m512 cd0 = _mm512_permutex2var_ps(s0, hi, s1);
+    __m512 ab1 = _mm512_permutex2var_ps(s2, lo, s3);
+    __m512 cd1 = _mm512_permutex2var_ps(s2, hi, s3);
+
+    const __m512i first  = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 16, 17, 18, 19, 20, 21, 22, 23);
+    const __m512i second = _mm512_setr_epi32(8, 9, 10, 11, 12, 13, 14, 15, 24, 25, 26, 27, 28, 29, 30, 31);
+    a = _mm512_permutex2var_ps(ab0, first, ab1);
+    b = _mm512_permutex2var_ps(ab0, second, ab1);
+    c = _mm512_permutex2var_ps(cd0, first, cd1);
+    d = _mm512_permutex2var_ps(cd0, second, cd1);
+}
+
+inline void v_store_interleave(float *ptr, const __m512 &a, const __m512 &b, const __m512 &c, const __m512 &d)
+{
+    const __m512i zip_lo = _mm512_setr_epi32(0, 16, 1, 17, 2, 18, 3, 19, 4, 20, 5, 21, 6, 22, 7, 23);
+    const __m512i zip_hi = _mm512_setr_epi32(8, 24, 9, 25, 10, 26, 11, 27, 12, 28, 13, 29, 14, 30, 15, 31);
+    __m512 ab0 = _mm512_permutex2var_ps(a, zip_lo, b);
+    __m512 ab1 = _mm512_permutex2var_ps(a, zip_hi, b);
+    __m512 cd0 = _mm512_permutex2var_ps(c, zip_lo, d);
+    __m512 cd1 = _mm512_permutex2var_ps(c, zip_hi, d);
+
+    const __m512i px_lo = _mm512_setr_epi32(0, 1, 16, 17, 2, 3, 18, 19, 4, 5, 20, 21, 6, 7, 22, 23);
+    const __m512i px_hi = _mm512_setr_epi32(8, 9, 24, 25, 10, 11, 26, 27, 12, 13, 28, 29, 14, 15, 30, 31);
+    _mm512_storeu_ps(ptr, _mm512_permutex2var_ps(ab0, px_lo, cd0));
+    _mm512_storeu_ps(ptr + 16, _mm512_permutex2var_ps(ab0, px_hi, cd0));
+    _mm512_storeu_ps(ptr + 32, _mm512_permutex2var_ps(ab1, px_lo, cd1));
+    _mm512_storeu_ps(ptr + 48, _mm512_permutex2var_ps(ab1, px_hi, cd1));
+}
+
+}
+}
+}
+} // namespace ppl::cv::x86::avx512
+#endif //!__INTRINUTILS_AVX512_H__
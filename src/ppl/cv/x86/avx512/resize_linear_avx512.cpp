@@ -0,0 +1,126 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include <immintrin.h>
+#include "internal_avx512.hpp"
+
+namespace ppl {
+namespace cv {
+namespace x86 {
+namespace avx512 {
+
+// Same operation order as resize_linear_twoline_fp32_fma(): sixteen columns
+// per gather, then one eight-column step so the tail left to the SSE code is
+// the one the FMA kernel leaves as well.
+int32_t resize_linear_twoline_fp32(
+    int32_t max_length,
+    int32_t channels,
+    const float *in_data_0,
+    const float *in_data_1,
+    const int32_t *w_offset,
+    const float *w_coeff,
+    float h_coeff,
+    float *row_0,
+    float *row_1,
+    float *out_data)
+{
+    __m512 m_h_coeff_0 = _mm512_set1_ps(h_coeff);
+    __m512 m_h_coeff_1 = _mm512_set1_ps(1.0f - h_coeff);
+    __m512 m_one       = _mm512_set1_ps(1.0f);
+
+    int32_t i = 0;
+    for (; i <= max_length - 16; i += 16) {
+        __m512i m_idx   = _mm512_loadu_si512(w_offset + i);
+        __m512 m_data_0 = _mm512_i32gather_ps(m_idx, in_data_0, 4);
+        __m512 m_data_1 = _mm512_i32gather_ps(m_idx, in_data_0 + channels, 4);
+        __m512 m_data_2 = _mm512_i32gather_ps(m_idx, in_data_1, 4);
+        __m512 m_data_3 = _mm512_i32gather_ps(m_idx, in_data_1 + channels, 4);
+
+        __m512 m_w_coeff_0 = _mm512_loadu_ps(w_coeff + i);
+        __m512 m_w_coeff_1 = _mm512_sub_ps(m_one, m_w_coeff_0);
+
+        __m512 m_rst_row_0 = _mm512_fmadd_ps(m_data_0, m_w_coeff_0, _mm512_mul_ps(m_data_1, m_w_coeff_1));
+        __m512 m_rst_row_1 = _mm512_fmadd_ps(m_data_2, m_w_coeff_0, _mm512_mul_ps(m_data_3, m_w_coeff_1));
+
+        __m512 m_rst = _mm512_fmadd_ps(m_rst_row_0, m_h_coeff_0, _mm512_mul_ps(m_rst_row_1, m_h_coeff_1));
+
+        _mm512_storeu_ps(row_0 + i, m_rst_row_0);
+        _mm512_storeu_ps(row_1 + i, m_rst_row_1);
+        _mm512_storeu_ps(out_data + i, m_rst);
+    }
+    if (i <= max_length - 8) {
+        __m256i m_idx   = _mm256_loadu_si256((const __m256i *)(w_offset + i));
+        __m256 m_data_0 = _mm256_i32gather_ps(in_data_0, m_idx, 4);
+        __m256 m_data_1 = _mm256_i32gather_ps(in_data_0 + channels, m_idx, 4);
+        __m256 m_data_2 = _mm256_i32gather_ps(in_data_1, m_idx, 4);
+        __m256 m_data_3 = _mm256_i32gather_ps(in_data_1 + channels, m_idx, 4);
+
+        __m256 m_w_coeff_0 = _mm256_loadu_ps(w_coeff + i);
+        __m256 m_w_coeff_1 = _mm256_sub_ps(_mm256_set1_ps(1.0f), m_w_coeff_0);
+
+        __m256 m_rst_row_0 = _mm256_fmadd_ps(m_data_0, m_w_coeff_0, _mm256_mul_ps(m_data_1, m_w_coeff_1));
+        __m256 m_rst_row_1 = _mm256_fmadd_ps(m_data_2, m_w_coeff_0, _mm256_mul_ps(m_data_3, m_w_coeff_1));
+
+        __m256 m_rst = _mm256_fmadd_ps(m_rst_row_0, _mm256_set1_ps(h_coeff), _mm256_mul_ps(m_rst_row_1, _mm256_set1_ps(1.0f - h_coeff)));
+
+        _mm256_storeu_ps(row_0 + i, m_rst_row_0);
+        _mm256_storeu_ps(row_1 + i, m_rst_row_1);
+        _mm256_storeu_ps(out_data + i, m_rst);
+        i += 8;
+    }
+    return i;
+}
+
+int32_t resize_linear_w_oneline_fp32(
+    int32_t max_length,
+    int32_t channels,
+    const float *in_data,
+    const int32_t *w_offset,
+    const float *w_coeff,
+    float *row)
+{
+    __m512 m_one = _mm512_set1_ps(1.0f);
+
+    int32_t i = 0;
+    for (; i <= max_length - 16; i += 16) {
+        __m512i m_idx   = _mm512_loadu_si512(w_offset + i);
+        __m512 m_data_0 = _mm512_i32gather_ps(m_idx, in_data, 4);
+        __m512 m_data_1 = _mm512_i32gather_ps(m_idx, in_data + channels, 4);
+
+        __m512 m_w_coeff_0 = _mm512_loadu_ps(w_coeff + i);
+        __m512 m_w_coeff_1 = _mm512_sub_ps(m_one, m_w_coeff_0);
+
+        _mm512_storeu_ps(row + i, _mm512_fmadd_ps(m_data_0, m_w_coeff_0, _mm512_mul_ps(m_data_1, m_w_coeff_1)));
+    }
+    if (i <= max_length - 8) {
+        __m256i m_idx   = _mm256_loadu_si256((const __m256i *)(w_offset + i));
+        __m256 m_data_0 = _mm256_i32gather_ps(in_data, m_idx, 4);
+        __m256 m_data_1 = _mm256_i32gather_ps(in_data + channels, m_idx, 4);
+
+        __m256 m_w_coeff_0 = _mm256_loadu_ps(w_coeff + i);
+        __m256 m_w_coeff_1 = _mm256_sub_ps(_mm256_set1_ps(1.0f), m_w_coeff_0);
+
+        _mm256_storeu_ps(row + i, _mm256_fmadd_ps(m_data_0, m_w_coeff_0, _mm256_mul_ps(m_data_1, m_w_coeff_1)));
+        i += 8;
+    }
+    return i;
+}
+
+}
+}
+}
+} // namespace ppl::cv::x86::avx512
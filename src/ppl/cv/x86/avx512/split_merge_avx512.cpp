@@ -0,0 +1,110 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "ppl/cv/x86/avx512/internal_avx512.hpp"
+#include "ppl/cv/x86/avx512/intrinutils_avx512.hpp"
+#include "ppl/cv/types.h"
+#include "ppl/common/retcode.h"
+#include <stdint.h>
+#include <immintrin.h>
+
+namespace ppl {
+namespace cv {
+namespace x86 {
+namespace avx512 {
+
+template <typename T, int32_t nc>
+::ppl::common::RetCode splitAOS2SOA(
+    int32_t height,
+    int32_t width,
+    int32_t inWidthStride,
+    const T *in,
+    int32_t outWidthStride,
+    T **out)
+{
+    typedef typename v_reg<T>::type V;
+    const int32_t lanes = 64 / sizeof(T);
+    for (int32_t h = 0; h < height; ++h) {
+        const T *src = in + h * inWidthStride;
+        int32_t w    = 0;
+        for (; w <= width - lanes; w += lanes) {
+            V v[4];
+            if (nc == 3) {
+                v_load_deinterleave(src + w * nc, v[0], v[1], v[2]);
+            } else {
+                v_load_deinterleave(src + w * nc, v[0], v[1], v[2], v[3]);
+            }
+            for (int32_t c = 0; c < nc; ++c) {
+                v_store(out[c] + h * outWidthStride + w, v[c]);
+            }
+        }
+        for (; w < width; ++w) {
+            for (int32_t c = 0; c < nc; ++c) {
+                out[c][h * outWidthStride + w] = src[w * nc + c];
+            }
+        }
+    }
+    return ppl::common::RC_SUCCESS;
+}
+
+template ::ppl::common::RetCode splitAOS2SOA<uint8_t, 3>(int32_t height, int32_t width, int32_t inWidthStride, const uint8_t *in, int32_t outWidthStride, uint8_t **out);
+template ::ppl::common::RetCode splitAOS2SOA<uint8_t, 4>(int32_t height, int32_t width, int32_t inWidthStride, const uint8_t *in, int32_t outWidthStride, uint8_t **out);
+template ::ppl::common::RetCode splitAOS2SOA<float, 3>(int32_t height, int32_t width, int32_t inWidthStride, const float *in, int32_t outWidthStride, float **out);
+template ::ppl::common::RetCode splitAOS2SOA<float, 4>(int32_t height, int32_t width, int32_t inWidthStride, const float *in, int32_t outWidthStride, float **out);
+
+template <typename T, int32_t nc>
+void mergeSOA2AOS(
+    int32_t height,
+    int32_t width,
+    int32_t inWidthStride,
+    const T **in,
+    int32_t outWidthStride,
+    T *out)
+{
+    typedef typename v_reg<T>::type V;
+    const int32_t lanes = 64 / sizeof(T);
+    for (int32_t h = 0; h < height; ++h) {
+        T *dst    = out + h * outWidthStride;
+        int32_t w = 0;
+        for (; w <= width - lanes; w += lanes) {
+            V v[4];
+            for (int32_t c = 0; c < nc; ++c) {
+                v[c] = v_load(in[c] + h * inWidthStride + w);
+            }
+            if (nc == 3) {
+                v_store_interleave(dst + w * nc, v[0], v[1], v[2]);
+            } else {
+                v_store_interleave(dst + w * nc, v[0], v[1], v[2], v[3]);
+            }
+        }
+        for (; w < width; ++w) {
+            for (int32_t c = 0; c < nc; ++c) {
+                dst[w * nc + c] = in[c][h * inWidthStride + w];
+            }
+        }
+    }
+}
+
+template void mergeSOA2AOS<uint8_t, 3>(int32_t height, int32_t width, int32_t inWidthStride, const uint8_t **in, int32_t outWidthStride, uint8_t *out);
+template void mergeSOA2AOS<uint8_t, 4>(int32_t height, int32_t width, int32_t inWidthStride, const uint8_t **in, int32_t outWidthStride, uint8_t *out);
+template void mergeSOA2AOS<float, 3>(int32_t height, int32_t width, int32_t inWidthStride, const float **in, int32_t outWidthStride, float *out);
+template void mergeSOA2AOS<float, 4>(int32_t height, int32_t width, int32_t inWidthStride, const float **in, int32_t outWidthStride, float *out);
+
+}
+}
+}
+} // namespace ppl::cv::x86::avx512
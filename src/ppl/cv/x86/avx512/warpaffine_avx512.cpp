@@ -0,0 +1,378 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "ppl/cv/x86/avx512/internal_avx512.hpp"
+#include "ppl/cv/x86/avx512/intrinutils_avx512.hpp"
+#include "ppl/cv/types.h"
+#include <immintrin.h>
+#include <algorithm>
+#include <type_traits>
+#define QUANTIZED_BITS       16
+#define QUANTIZED_MULTIPLIER (1 << QUANTIZED_BITS)
+#define QUANTIZED_BIAS       (1 << (QUANTIZED_BITS - 1))
+
+namespace ppl {
+namespace cv {
+namespace x86 {
+namespace avx512 {
+
+// Coordinates and weights are computed as fma::warpaffine_linear() computes
+// them, sixteen pixels at a time. Blocks whose four neighbours all lie inside
+// the image are interpolated with gathers; every other pixel goes through the
+// per-pixel code of the FMA kernel, so both tiers give the same output.
+
+template <typename T>
+static inline T clip(T x, T a, T b)
+{
+    return std::max(a, std::min(x, b));
+}
+
+template <int32_t nc, ppl::cv::BorderType borderMode>
+static inline void linear_pixel(
+    int32_t inHeight,
+    int32_t inWidth,
+    int32_t inWidthStride,
+    const float *src,
+    int32_t sx0,
+    int32_t sy0,
+    const float *tab,
+    float delta,
+    float *dst)
+{
+    float v0, v1, v2, v3;
+    if (borderMode == ppl::cv::BORDER_CONSTANT) {
+        bool flag = (sx0 >= 0 && sx0 + 1 < inWidth && sy0 >= 0 && sy0 + 1 < inHeight);
+        if (flag) {
+            int32_t position1 = (sy0 * inWidthStride + sx0 * nc);
+            int32_t position2 = ((sy0 + 1) * inWidthStride + sx0 * nc);
+            for (int32_t k = 0; k < nc; k++) {
+                v0     = src[position1 + k];
+                v1     = src[position1 + nc + k];
+                v2     = src[position2 + k];
+                v3     = src[position2 + nc + k];
+                dst[k] = tab[0] * v0 + tab[1] * v1 + tab[2] * v2 + tab[3] * v3;
+            }
+        } else if (sx0 >= inWidth || sx0 + 1 < 0 || sy0 >= inHeight || sy0 + 1 < 0) {
+            for (int32_t k = 0; k < nc; k++) {
+                dst[k] = delta;
+            }
+        } else {
+            bool flag0        = (sx0 >= 0 && sx0 < inWidth && sy0 >= 0 && sy0 < inHeight);
+            bool flag1        = (flag0 && (sx0 + 1 < inWidth));
+            bool flag2        = (sx0 >= 0 && sx0 < inWidth && sy0 + 1 >= 0 && sy0 + 1 < inHeight);
+            bool flag3        = (flag2 && (sx0 + 1 < inWidth));
+            int32_t position1 = (sy0 * inWidthStride + sx0 * nc);
+            int32_t position2 = ((sy0 + 1) * inWidthStride + sx0 * nc);
+            for (int32_t k = 0; k < nc; k++) {
+                v0     = flag0 ? src[position1 + k] : delta;
+                v1     = flag1 ? src[position1 + nc + k] : delta;
+                v2     = flag2 ? src[position2 + k] : delta;
+                v3     = flag3 ? src[position2 + nc + k] : delta;
+                dst[k] = tab[0] * v0 + tab[1] * v1 + tab[2] * v2 + tab[3] * v3;
+            }
+        }
+    } else if (borderMode == ppl::cv::BORDER_REPLICATE) {
+        int32_t sx1     = clip(sx0 + 1, 0, inWidth - 1);
+        int32_t sy1     = clip(sy0 + 1, 0, inHeight - 1);
+        sx0             = clip(sx0, 0, inWidth - 1);
+        sy0             = clip(sy0, 0, inHeight - 1);
+        const float *t0 = src + sy0 * inWidthStride + sx0 * nc;
+        const float *t1 = src + sy0 * inWidthStride + sx1 * nc;
+        const float *t2 = src + sy1 * inWidthStride + sx0 * nc;
+        const float *t3 = src + sy1 * inWidthStride + sx1 * nc;
+        for (int32_t k = 0; k < nc; ++k) {
+            dst[k] = tab[0] * t0[k] + tab[1] * t1[k] + tab[2] * t2[k] + tab[3] * t3[k];
+        }
+    } else if (borderMode == ppl::cv::BORDER_TRANSPARENT) {
+        bool flag = (sx0 >= 0 && sx0 + 1 < inWidth && sy0 >= 0 && sy0 + 1 < inHeight);
+        if (flag) {
+            int32_t position1 = (sy0 * inWidthStride + sx0 * nc);
+            int32_t position2 = ((sy0 + 1) * inWidthStride + sx0 * nc);
+            for (int32_t k = 0; k < nc; k++) {
+                v0     = src[position1 + k];
+                v1     = src[position1 + nc + k];
+                v2     = src[position2 + k];
+                v3     = src[position2 + nc + k];
+                dst[k] = tab[0] * v0 + tab[1] * v1 + tab[2] * v2 + tab[3] * v3;
+            }
+        }
+    }
+}
+
+template <int32_t nc, ppl::cv::BorderType borderMode>
+static inline void linear_pixel(
+    int32_t inHeight,
+    int32_t inWidth,
+    int32_t inWidthStride,
+    const uint8_t *src,
+    int32_t sx0,
+    int32_t sy0,
+    const int32_t *tab,
+    uint8_t delta,
+    uint8_t *dst)
+{
+    int32_t v0, v1, v2, v3;
+    if (borderMode == ppl::cv::BORDER_CONSTANT) {
+        bool all_valid = (sx0 >= 0 && sx0 < (inWidth - 1) && sy0 >= 0 && sy0 < (inHeight - 1));
+        bool flag0     = all_valid || (sx0 >= 0 && sx0 < inWidth && sy0 >= 0 && sy0 < inHeight);
+        bool flag1     = all_valid || (flag0 && (sx0 + 1 < inWidth));
+        bool flag2     = all_valid || (sx0 >= 0 && sx0 < inWidth && sy0 + 1 >= 0 && sy0 + 1 < inHeight);
+        bool flag3     = all_valid || (flag2 && (sx0 + 1 < inWidth));
+        if (sx0 < -1 || sx0 >= inWidth || sy0 < -1 || sy0 >= inHeight) {
+            flag0 = flag1 = flag2 = flag3 = false;
+        }
+        int32_t position1 = (sy0 * inWidthStride + sx0 * nc);
+        int32_t position2 = ((sy0 + 1) * inWidthStride + sx0 * nc);
+        for (int32_t k = 0; k < nc; k++) {
+            v0     = flag0 ? src[position1 + k] : delta;
+            v1     = flag1 ? src[position1 + nc + k] : delta;
+            v2     = flag2 ? src[position2 + k] : delta;
+            v3     = flag3 ? src[position2 + nc + k] : delta;
+            dst[k] = static_cast<uint8_t>((tab[0] * v0 + tab[1] * v1 + tab[2] * v2 + tab[3] * v3 + QUANTIZED_BIAS) >> QUANTIZED_BITS);
+        }
+    } else if (borderMode == ppl::cv::BORDER_REPLICATE) {
+        int32_t sx1       = clip(sx0 + 1, 0, inWidth - 1);
+        int32_t sy1       = clip(sy0 + 1, 0, inHeight - 1);
+        sx0               = clip(sx0, 0, inWidth - 1);
+        sy0               = clip(sy0, 0, inHeight - 1);
+        const uint8_t *t0 = src + sy0 * inWidthStride + sx0 * nc;
+        const uint8_t *t1 = src + sy0 * inWidthStride + sx1 * nc;
+        const uint8_t *t2 = src + sy1 * inWidthStride + sx0 * nc;
+        const uint8_t *t3 = src + sy1 * inWidthStride + sx1 * nc;
+        for (int32_t k = 0; k < nc; ++k) {
+            dst[k] = static_cast<uint8_t>((tab[0] * t0[k] + tab[1] * t1[k] + tab[2] * t2[k] + tab[3] * t3[k] + QUANTIZED_BIAS) >> QUANTIZED_BITS);
+        }
+    } else if (borderMode == ppl::cv::BORDER_TRANSPARENT) {
+        bool flag0 = (sx0 >= 0 && sx0 + 1 < inWidth && sy0 >= 0 && sy0 + 1 < inHeight);
+        if (flag0) {
+            int32_t position1 = (sy0 * inWidthStride + sx0 * nc);
+            int32_t position2 = ((sy0 + 1) * inWidthStride + sx0 * nc);
+            for (int32_t k = 0; k < nc; k++) {
+                v0     = src[position1 + k];
+                v1     = src[position1 + nc + k];
+                v2     = src[position2 + k];
+                v3     = src[position2 + nc + k];
+                dst[k] = static_cast<uint8_t>((tab[0] * v0 + tab[1] * v1 + tab[2] * v2 + tab[3] * v3 + QUANTIZED_BIAS) >> QUANTIZED_BITS);
+            }
+        }
+    }
+}
+
+static inline void quantize_tab(__m512 tab, __m512 &out)
+{
+    out = tab;
+}
+
+static inline void quantize_tab(__m512 tab, __m512i &out)
+{
+    out = _mm512_cvtps_epi32(_mm512_mul_ps(tab, _mm512_set1_ps(QUANTIZED_MULTIPLIER)));
+}
+
+static inline void store_tab(float *ptr, __m512 tab)
+{
+    _mm512_storeu_ps(ptr, tab);
+}
+
+static inline void store_tab(int32_t *ptr, __m512i tab)
+{
+    _mm512_storeu_si512(ptr, tab);
+}
+
+// Sixteen pixels whose neighbours are all inside the image, channel k of
+// every corner gathered at once.
+template <int32_t nc>
+static inline void linear_block(
+    int32_t inWidthStride,
+    const float *src,
+    __m512i m_sx0,
+    __m512i m_sy0,
+    const __m512 *m_tab,
+    float *dst)
+{
+    __m512i m_pos1 = _mm512_add_epi32(_mm512_mullo_epi32(m_sy0, _mm512_set1_epi32(inWidthStride)),
+                                      _mm512_mullo_epi32(m_sx0, _mm512_set1_epi32(nc)));
+    __m512i m_pos2 = _mm512_add_epi32(m_pos1, _mm512_set1_epi32(inWidthStride));
+    __m512 m_res[4];
+    for (int32_t k = 0; k < nc; k++) {
+        __m512 m_v0 = _mm512_i32gather_ps(m_pos1, src + k, 4);
+        __m512 m_v1 = _mm512_i32gather_ps(m_pos1, src + nc + k, 4);
+        __m512 m_v2 = _mm512_i32gather_ps(m_pos2, src + k, 4);
+        __m512 m_v3 = _mm512_i32gather_ps(m_pos2, src + nc + k, 4);
+        // the order compilers contract the scalar sum of four products into
+        m_res[k]    = _mm512_fmadd_ps(m_tab[3], m_v3, _mm512_fmadd_ps(m_tab[2], m_v2, _mm512_fmadd_ps(m_tab[0], m_v0, _mm512_mul_ps(m_tab[1], m_v1))));
+    }
+    if (nc == 1) {
+        _mm512_storeu_ps(dst, m_res[0]);
+    } else if (nc == 3) {
+        v_store_interleave(dst, m_res[0], m_res[1], m_res[2]);
+    } else {
+        v_store_interleave(dst, m_res[0], m_res[1], m_res[2], m_res[3]);
+    }
+}
+
+template <int32_t nc>
+static inline void linear_block(
+    int32_t inWidthStride,
+    const uint8_t *src,
+    __m512i m_sx0,
+    __m512i m_sy0,
+    const __m512i *m_tab,
+    uint8_t *dst)
+{
+    __m512i m_pos1 = _mm512_add_epi32(_mm512_mullo_epi32(m_sy0, _mm512_set1_epi32(inWidthStride)),
+                                      _mm512_mullo_epi32(m_sx0, _mm512_set1_epi32(nc)));
+    __m512i m_pos2 = _mm512_add_epi32(m_pos1, _mm512_set1_epi32(inWidthStride));
+    __m512i m_byte = _mm512_set1_epi32(0xff);
+    __m512i m_bias = _mm512_set1_epi32(QUANTIZED_BIAS);
+    __m512i m_res  = _mm512_setzero_si512();
+    for (int32_t k = 0; k < nc; k++) {
+        __m512i m_v0  = _mm512_and_si512(_mm512_i32gather_epi32(m_pos1, src + k, 1), m_byte);
+        __m512i m_v1  = _mm512_and_si512(_mm512_i32gather_epi32(m_pos1, src + nc + k, 1), m_byte);
+        __m512i m_v2  = _mm512_and_si512(_mm512_i32gather_epi32(m_pos2, src + k, 1), m_byte);
+        __m512i m_v3  = _mm512_and_si512(_mm512_i32gather_epi32(m_pos2, src + nc + k, 1), m_byte);
+        __m512i m_sum = _mm512_add_epi32(_mm512_add_epi32(_mm512_mullo_epi32(m_tab[0], m_v0), _mm512_mullo_epi32(m_tab[1], m_v1)),
+                                         _mm512_add_epi32(_mm512_mullo_epi32(m_tab[2], m_v2), _mm512_mullo_epi32(m_tab[3], m_v3)));
+        m_sum         = _mm512_and_si512(_mm512_srai_epi32(_mm512_add_epi32(m_sum, m_bias), QUANTIZED_BITS), m_byte);
+        m_res         = _mm512_or_si512(m_res, _mm512_slli_epi32(m_sum, 8 * k));
+    }
+    if (nc == 1) {
+        _mm_storeu_si128((__m128i *)dst, _mm512_cvtepi32_epi8(m_res));
+    } else if (nc == 3) {
+        // drop the fourth byte of every dword, then write 12 bytes per lane
+        m_res = _mm512_shuffle_epi8(m_res, _mm512_broadcast_i32x4(_mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1)));
+        _mm_mask_storeu_epi8(dst, 0x0fff, _mm512_castsi512_si128(m_res));
+        _mm_mask_storeu_epi8(dst + 12, 0x0fff, _mm512_extracti32x4_epi32(m_res, 1));
+        _mm_mask_storeu_epi8(dst + 24, 0x0fff, _mm512_extracti32x4_epi32(m_res, 2));
+        _mm_mask_storeu_epi8(dst + 36, 0x0fff, _mm512_extracti32x4_epi32(m_res, 3));
+    } else {
+        _mm512_storeu_si512(dst, m_res);
+    }
+}
+
+template <typename T, int32_t nc, ppl::cv::BorderType borderMode>
+::ppl::common::RetCode warpaffine_linear(
+    int32_t inHeight,
+    int32_t inWidth,
+    int32_t inWidthStride,
+    int32_t rowBegin,
+    int32_t outHeight,
+    int32_t outWidth,
+    int32_t outWidthStride,
+    T *dst,
+    const T *src,
+    const double *M,
+    T delta)
+{
+    typedef typename std::conditional<std::is_same<T, float>::value, float, int32_t>::type tab_t;
+    typedef typename v_reg<T>::type tab_v;
+    const bool is_u8 = std::is_same<T, uint8_t>::value;
+    // The byte gathers read a whole dword at every byte position, so they
+    // must stop three bytes before the last byte the image is known to have.
+    const int64_t gather_end = (int64_t)(inHeight - 1) * inWidthStride + (int64_t)inWidth * nc - (is_u8 ? 3 : 0);
+
+    uint32_t cur_mode = _MM_GET_ROUNDING_MODE();
+    _MM_SET_ROUNDING_MODE(_MM_ROUND_DOWN);
+    __m512 base_seq_vec = _mm512_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f, 9.0f, 10.0f, 11.0f, 12.0f, 13.0f, 14.0f, 15.0f);
+    __m512 one_vec      = _mm512_set1_ps(1.0f);
+    __m512 m3_vec       = _mm512_set1_ps(M[3]);
+    __m512 m0_vec       = _mm512_set1_ps(M[0]);
+    __m512i x_max_vec   = _mm512_set1_epi32(inWidth - 1);
+    __m512i y_max_vec   = _mm512_set1_epi32(inHeight - 1);
+    __m512i zero_vec    = _mm512_setzero_si512();
+    for (int32_t i = 0; i < outHeight; i++) {
+        float base_x     = M[1] * (rowBegin + i) + M[2];
+        float base_y     = M[4] * (rowBegin + i) + M[5];
+        __m512 baseX_vec = _mm512_set1_ps(base_x);
+        __m512 baseY_vec = _mm512_set1_ps(base_y);
+        T *dst_row       = dst + i * outWidthStride;
+        for (int32_t block_j = 0; block_j < outWidth; block_j += 16) {
+            __m512 seq_vec = _mm512_add_ps(base_seq_vec, _mm512_set1_ps(block_j));
+            __m512 x_vec   = _mm512_fmadd_ps(m0_vec, seq_vec, baseX_vec);
+            __m512 y_vec   = _mm512_fmadd_ps(m3_vec, seq_vec, baseY_vec);
+            // the float kernel truncates, the byte kernel rounds down
+            __m512i sx0_vec  = is_u8 ? _mm512_cvtps_epi32(x_vec) : _mm512_cvttps_epi32(x_vec);
+            __m512i sy0_vec  = is_u8 ? _mm512_cvtps_epi32(y_vec) : _mm512_cvttps_epi32(y_vec);
+            __m512 u_vec     = _mm512_sub_ps(x_vec, _mm512_cvtepi32_ps(sx0_vec));
+            __m512 v_vec     = _mm512_sub_ps(y_vec, _mm512_cvtepi32_ps(sy0_vec));
+            __m512 taby0_vec = _mm512_sub_ps(one_vec, v_vec);
+            __m512 taby1_vec = v_vec;
+            __m512 tabx0_vec = _mm512_sub_ps(one_vec, u_vec);
+            __m512 tabx1_vec = u_vec;
+            __m512 tab_vec[4] = {_mm512_mul_ps(taby0_vec, tabx0_vec), _mm512_mul_ps(taby0_vec, tabx1_vec),
+                                 _mm512_mul_ps(taby1_vec, tabx0_vec), _mm512_mul_ps(taby1_vec, tabx1_vec)};
+            tab_v m_tab[4];
+            for (int32_t t = 0; t < 4; t++) {
+                quantize_tab(tab_vec[t], m_tab[t]);
+            }
+
+            __mmask16 inside = _mm512_cmpge_epi32_mask(sx0_vec, zero_vec) & _mm512_cmplt_epi32_mask(sx0_vec, x_max_vec) &
+                               _mm512_cmpge_epi32_mask(sy0_vec, zero_vec) & _mm512_cmplt_epi32_mask(sy0_vec, y_max_vec);
+            if (nc != 2 && block_j + 16 <= outWidth && inside == 0xffff) {
+                int64_t last = 0;
+                if (is_u8) {
+                    int32_t sx0_array[16], sy0_array[16];
+                    _mm512_storeu_si512(sx0_array, sx0_vec);
+                    _mm512_storeu_si512(sy0_array, sy0_vec);
+                    for (int32_t idx = 0; idx < 16; idx++) {
+                        last = std::max(last, (int64_t)(sy0_array[idx] + 1) * inWidthStride + (int64_t)(sx0_array[idx] + 2) * nc);
+                    }
+                }
+                if (last <= gather_end) {
+                    linear_block<nc>(inWidthStride, src, sx0_vec, sy0_vec, m_tab, dst_row + block_j * nc);
+                    continue;
+                }
+            }
+
+            int32_t sx0_array[16], sy0_array[16];
+            tab_t tab_array[4][16];
+            _mm512_storeu_si512(sx0_array, sx0_vec);
+            _mm512_storeu_si512(sy0_array, sy0_vec);
+            for (int32_t t = 0; t < 4; t++) {
+                store_tab(tab_array[t], m_tab[t]);
+            }
+            for (int32_t j = block_j; j < std::min(block_j + 16, outWidth); ++j) {
+                int32_t idx  = j - block_j;
+                tab_t tab[4] = {tab_array[0][idx], tab_array[1][idx], tab_array[2][idx], tab_array[3][idx]};
+                linear_pixel<nc, borderMode>(inHeight, inWidth, inWidthStride, src, sx0_array[idx], sy0_array[idx], tab, delta, dst_row + j * nc);
+            }
+        }
+    }
+    _MM_SET_ROUNDING_MODE(cur_mode);
+    return ppl::common::RC_SUCCESS;
+}
+
+#define INSTANTIATE_WARPAFFINE_LINEAR(T)                                                                                                                                                                                       \
+    template ::ppl::common::RetCode warpaffine_linear<T, 1, BORDER_CONSTANT>(int32_t, int32_t, int32_t, int32_t, int32_t, int32_t, int32_t, T *, const T *, const double *, T);    \
+    template ::ppl::common::RetCode warpaffine_linear<T, 2, BORDER_CONSTANT>(int32_t, int32_t, int32_t, int32_t, int32_t, int32_t, int32_t, T *, const T *, const double *, T);    \
+    template ::ppl::common::RetCode warpaffine_linear<T, 3, BORDER_CONSTANT>(int32_t, int32_t, int32_t, int32_t, int32_t, int32_t, int32_t, T *, const T *, const double *, T);    \
+    template ::ppl::common::RetCode warpaffine_linear<T, 4, BORDER_CONSTANT>(int32_t, int32_t, int32_t, int32_t, int32_t, int32_t, int32_t, T *, const T *, const double *, T);    \
+    template ::ppl::common::RetCode warpaffine_linear<T, 1, BORDER_REPLICATE>(int32_t, int32_t, int32_t, int32_t, int32_t, int32_t, int32_t, T *, const T *, const double *, T);   \
+    template ::ppl::common::RetCode warpaffine_linear<T, 2, BORDER_REPLICATE>(int32_t, int32_t, int32_t, int32_t, int32_t, int32_t, int32_t, T *, const T *, const double *, T);   \
+    template ::ppl::common::RetCode warpaffine_linear<T, 3, BORDER_REPLICATE>(int32_t, int32_t, int32_t, int32_t, int32_t, int32_t, int32_t, T *, const T *, const double *, T);   \
+    template ::ppl::common::RetCode warpaffine_linear<T, 4, BORDER_REPLICATE>(int32_t, int32_t, int32_t, int32_t, int32_t, int32_t, int32_t, T *, const T *, const double *, T);   \
+    template ::ppl::common::RetCode warpaffine_linear<T, 1, BORDER_TRANSPARENT>(int32_t, int32_t, int32_t, int32_t, int32_t, int32_t, int32_t, T *, const T *, const double *, T); \
+    template ::ppl::common::RetCode warpaffine_linear<T, 2, BORDER_TRANSPARENT>(int32_t, int32_t, int32_t, int32_t, int32_t, int32_t, int32_t, T *, const T *, const double *, T); \
+    template ::ppl::common::RetCode warpaffine_linear<T, 3, BORDER_TRANSPARENT>(int32_t, int32_t, int32_t, int32_t, int32_t, int32_t, int32_t, T *, const T *, const double *, T); \
+    template ::ppl::common::RetCode warpaffine_linear<T, 4, BORDER_TRANSPARENT>(int32_t, int32_t, int32_t, int32_t, int32_t, int32_t, int32_t, T *, const T *, const double *, T);
+
+INSTANTIATE_WARPAFFINE_LINEAR(float)
+INSTANTIATE_WARPAFFINE_LINEAR(uint8_t)
+
+}
+}
+}
+} // namespace ppl::cv::x86::avx512
@@ -18,10 +18,13 @@
 #include "ppl/cv/x86/cvtcolor.h"
 #include "ppl/cv/x86/avx/internal_avx.hpp"
 #include "ppl/cv/x86/fma/internal_fma.hpp"
+#include "ppl/cv/x86/avx512/internal_avx512.hpp"
 #include "ppl/cv/x86/util.hpp"
+#include "ppl/cv/x86/parallel.hpp"
 #include "ppl/cv/types.h"
 #include "ppl/common/sys.h"
 #include "ppl/common/x86/sysinfo.h"
+#include "ppl/cv/x86/isa.hpp"
 #include <string.h>
 #include <cmath>
 
@@ -172,6 +175,44 @@ void nv_2_rgb(
     }
 }
 
+// NV12/NV21 kernels work on pairs of luma rows sharing one chroma row, so the
+// image is split into bands of even height and each band's planes are offset.
+template <typename Kernel>
+::ppl::common::RetCode rgb_2_nv_parallel(
+    Kernel kernel,
+    int32_t height,
+    int32_t width,
+    int32_t inWidthStride,
+    const uint8_t *inData,
+    int32_t outYStride,
+    uint8_t *outY,
+    int32_t outUVStride,
+    uint8_t *outUV)
+{
+    parallel_for_rows(height, width * 4, [&](int32_t begin, int32_t end) {
+        kernel(end - begin, width, inWidthStride, inData + begin * inWidthStride, outYStride, outY + begin * outYStride, outUVStride, outUV + begin / 2 * outUVStride);
+    }, 2);
+    return ppl::common::RC_SUCCESS;
+}
+
+template <typename Kernel>
+::ppl::common::RetCode nv_2_rgb_parallel(
+    Kernel kernel,
+    int32_t height,
+    int32_t width,
+    int32_t inYStride,
+    const uint8_t *inY,
+    int32_t inUVStride,
+    const uint8_t *inUV,
+    int32_t outWidthStride,
+    uint8_t *outData)
+{
+    parallel_for_rows(height, width * 4, [&](int32_t begin, int32_t end) {
+        kernel(end - begin, width, inYStride, inY + begin * inYStride, inUVStride, inUV + begin / 2 * inUVStride, outWidthStride, outData + begin * outWidthStride);
+    }, 2);
+    return ppl::common::RC_SUCCESS;
+}
+
 template <>
 ::ppl::common::RetCode BGR2NV12<uint8_t>(
     int32_t height,
@@ -187,7 +228,10 @@ template <>
     if (width == 0 || height == 0 || inWidthStride == 0 || outWidthStride == 0) {
         return ppl::common::RC_INVALID_VALUE;
     }
-    rgb_2_nv<3, 0, true>(height, width, inWidthStride, inData, outWidthStride, outData, outWidthStride, outData + height * outWidthStride);
+    if (isa_supported(ppl::common::ISA_X86_AVX512)) {
+        return rgb_2_nv_parallel(avx512::rgb_2_nv<3, 0, true>, height, width, inWidthStride, inData, outWidthStride, outData, outWidthStride, outData + height * outWidthStride);
+    }
+    rgb_2_nv_parallel(rgb_2_nv<3, 0, true>, height, width, inWidthStride, inData, outWidthStride, outData, outWidthStride, outData + height * outWidthStride);
     return ppl::common::RC_SUCCESS;
 }
 
@@ -206,7 +250,10 @@ template <>
     if (width == 0 || height == 0 || inWidthStride == 0 || outWidthStride == 0) {
         return ppl::common::RC_INVALID_VALUE;
     }
-    rgb_2_nv<4, 0, true>(height, width, inWidthStride, inData, outWidthStride, outData, outWidthStride, outData + height * outWidthStride);
+    if (isa_supported(ppl::common::ISA_X86_AVX512)) {
+        return rgb_2_nv_parallel(avx512::rgb_2_nv<4, 0, true>, height, width, inWidthStride, inData, outWidthStride, outData, outWidthStride, outData + height * outWidthStride);
+    }
+    rgb_2_nv_parallel(rgb_2_nv<4, 0, true>, height, width, inWidthStride, inData, outWidthStride, outData, outWidthStride, outData + height * outWidthStride);
     return ppl::common::RC_SUCCESS;
 }
 
@@ -225,10 +272,12 @@ template <>
     if (width == 0 || height == 0 || inWidthStride == 0 || outWidthStride == 0) {
         return ppl::common::RC_INVALID_VALUE;
     }
-    if (ppl::common::CpuSupports(ppl::common::ISA_X86_FMA)) {
-        return fma::nv_2_rgb<3, 0, true>(height, width, inWidthStride, inData, inWidthStride, inData + height * inWidthStride, outWidthStride, outData);
+    if (isa_supported(ppl::common::ISA_X86_AVX512)) {
+        return nv_2_rgb_parallel(avx512::nv_2_rgb<3, 0, true>, height, width, inWidthStride, inData, inWidthStride, inData + height * inWidthStride, outWidthStride, outData);
+    } else if (isa_supported(ppl::common::ISA_X86_FMA)) {
+        return nv_2_rgb_parallel(fma::nv_2_rgb<3, 0, true>, height, width, inWidthStride, inData, inWidthStride, inData + height * inWidthStride, outWidthStride, outData);
     } else {
-        nv_2_rgb<3, 0, true>(height, width, inWidthStride, inData, inWidthStride, inData + height * inWidthStride, outWidthStride, outData);
+        nv_2_rgb_parallel(nv_2_rgb<3, 0, true>, height, width, inWidthStride, inData, inWidthStride, inData + height * inWidthStride, outWidthStride, outData);
     }
     return ppl::common::RC_SUCCESS;
 }
@@ -248,7 +297,10 @@ template <>
     if (width == 0 || height == 0 || inWidthStride == 0 || outWidthStride == 0) {
         return ppl::common::RC_INVALID_VALUE;
     }
-    nv_2_rgb<4, 0, true>(height, width, inWidthStride, inData, inWidthStride, inData + height * inWidthStride, outWidthStride, outData);
+    if (isa_supported(ppl::common::ISA_X86_AVX512)) {
+        return nv_2_rgb_parallel(avx512::nv_2_rgb<4, 0, true>, height, width, inWidthStride, inData, inWidthStride, inData + height * inWidthStride, outWidthStride, outData);
+    }
+    nv_2_rgb_parallel(nv_2_rgb<4, 0, true>, height, width, inWidthStride, inData, inWidthStride, inData + height * inWidthStride, outWidthStride, outData);
     return ppl::common::RC_SUCCESS;
 }
 
@@ -267,7 +319,10 @@ template <>
     if (width == 0 || height == 0 || inWidthStride == 0 || outWidthStride == 0) {
         return ppl::common::RC_INVALID_VALUE;
     }
-    rgb_2_nv<3, 2, true>(height, width, inWidthStride, inData, outWidthStride, outData, outWidthStride, outData + height * outWidthStride);
+    if (isa_supported(ppl::common::ISA_X86_AVX512)) {
+        return rgb_2_nv_parallel(avx512::rgb_2_nv<3, 2, true>, height, width, inWidthStride, inData, outWidthStride, outData, outWidthStride, outData + height * outWidthStride);
+    }
+    rgb_2_nv_parallel(rgb_2_nv<3, 2, true>, height, width, inWidthStride, inData, outWidthStride, outData, outWidthStride, outData + height * outWidthStride);
     return ppl::common::RC_SUCCESS;
 }
 
@@ -286,7 +341,10 @@ template <>
     if (width == 0 || height == 0 || inWidthStride == 0 || outWidthStride == 0) {
         return ppl::common::RC_INVALID_VALUE;
     }
-    rgb_2_nv<4, 2, true>(height, width, inWidthStride, inData, outWidthStride, outData, outWidthStride, outData + height * outWidthStride);
+    if (isa_supported(ppl::common::ISA_X86_AVX512)) {
+        return rgb_2_nv_parallel(avx512::rgb_2_nv<4, 2, true>, height, width, inWidthStride, inData, outWidthStride, outData, outWidthStride, outData + height * outWidthStride);
+    }
+    rgb_2_nv_parallel(rgb_2_nv<4, 2, true>, height, width, inWidthStride, inData, outWidthStride, outData, outWidthStride, outData + height * outWidthStride);
     return ppl::common::RC_SUCCESS;
 }
 
@@ -305,10 +363,12 @@ template <>
     if (width == 0 || height == 0 || inWidthStride == 0 || outWidthStride == 0) {
         return ppl::common::RC_INVALID_VALUE;
     }
-    if (ppl::common::CpuSupports(ppl::common::ISA_X86_FMA)) {
-        return fma::nv_2_rgb<3, 2, true>(height, width, inWidthStride, inData, inWidthStride, inData + height * inWidthStride, outWidthStride, outData);
+    if (isa_supported(ppl::common::ISA_X86_AVX512)) {
+        return nv_2_rgb_parallel(avx512::nv_2_rgb<3, 2, true>, height, width, inWidthStride, inData, inWidthStride, inData + height * inWidthStride, outWidthStride, outData);
+    } else if (isa_supported(ppl::common::ISA_X86_FMA)) {
+        return nv_2_rgb_parallel(fma::nv_2_rgb<3, 2, true>, height, width, inWidthStride, inData, inWidthStride, inData + height * inWidthStride, outWidthStride, outData);
     } else {
-        nv_2_rgb<3, 2, true>(height, width, inWidthStride, inData, inWidthStride, inData + height * inWidthStride, outWidthStride, outData);
+        nv_2_rgb_parallel(nv_2_rgb<3, 2, true>, height, width, inWidthStride, inData, inWidthStride, inData + height * inWidthStride, outWidthStride, outData);
     }
     return ppl::common::RC_SUCCESS;
 }
@@ -328,7 +388,10 @@ template <>
     if (width == 0 || height == 0 || inWidthStride == 0 || outWidthStride == 0) {
         return ppl::common::RC_INVALID_VALUE;
     }
-    nv_2_rgb<4, 2, true>(height, width, inWidthStride, inData, inWidthStride, inData + height * inWidthStride, outWidthStride, outData);
+    if (isa_supported(ppl::common::ISA_X86_AVX512)) {
+        return nv_2_rgb_parallel(avx512::nv_2_rgb<4, 2, true>, height, width, inWidthStride, inData, inWidthStride, inData + height * inWidthStride, outWidthStride, outData);
+    }
+    nv_2_rgb_parallel(nv_2_rgb<4, 2, true>, height, width, inWidthStride, inData, inWidthStride, inData + height * inWidthStride, outWidthStride, outData);
     return ppl::common::RC_SUCCESS;
 }
 
@@ -349,7 +412,10 @@ template <>
     if (width == 0 || height == 0 || inWidthStride == 0 || outYStride == 0 || outUVStride == 0) {
         return ppl::common::RC_INVALID_VALUE;
     }
-    rgb_2_nv<3, 0, true>(height, width, inWidthStride, inData, outYStride, outY, outUVStride, outUV);
+    if (isa_supported(ppl::common::ISA_X86_AVX512)) {
+        return rgb_2_nv_parallel(avx512::rgb_2_nv<3, 0, true>, height, width, inWidthStride, inData, outYStride, outY, outUVStride, outUV);
+    }
+    rgb_2_nv_parallel(rgb_2_nv<3, 0, true>, height, width, inWidthStride, inData, outYStride, outY, outUVStride, outUV);
     return ppl::common::RC_SUCCESS;
 }
 
@@ -370,7 +436,10 @@ template <>
     if (width == 0 || height == 0 || inWidthStride == 0 || outYStride == 0 || outUVStride == 0) {
         return ppl::common::RC_INVALID_VALUE;
     }
-    rgb_2_nv<4, 0, true>(height, width, inWidthStride, inData, outYStride, outY, outUVStride, outUV);
+    if (isa_supported(ppl::common::ISA_X86_AVX512)) {
+        return rgb_2_nv_parallel(avx512::rgb_2_nv<4, 0, true>, height, width, inWidthStride, inData, outYStride, outY, outUVStride, outUV);
+    }
+    rgb_2_nv_parallel(rgb_2_nv<4, 0, true>, height, width, inWidthStride, inData, outYStride, outY, outUVStride, outUV);
     return ppl::common::RC_SUCCESS;
 }
 
@@ -394,10 +463,12 @@ template <>
     if (width == 0 || height == 0 || inYStride == 0 || inUVStride == 0 || outWidthStride == 0) {
         return ppl::common::RC_INVALID_VALUE;
     }
-    if (ppl::common::CpuSupports(ppl::common::ISA_X86_FMA)) {
-        return fma::nv_2_rgb<3, 0, true>(height, width, inYStride, inY, inUVStride, inUV, outWidthStride, outData);
+    if (isa_supported(ppl::common::ISA_X86_AVX512)) {
+        return nv_2_rgb_parallel(avx512::nv_2_rgb<3, 0, true>, height, width, inYStride, inY, inUVStride, inUV, outWidthStride, outData);
+    } else if (isa_supported(ppl::common::ISA_X86_FMA)) {
+        return nv_2_rgb_parallel(fma::nv_2_rgb<3, 0, true>, height, width, inYStride, inY, inUVStride, inUV, outWidthStride, outData);
     } else {
-        nv_2_rgb<3, 0, true>(height, width, inYStride, inY, inUVStride, inUV, outWidthStride, outData);
+        nv_2_rgb_parallel(nv_2_rgb<3, 0, true>, height, width, inYStride, inY, inUVStride, inUV, outWidthStride, outData);
     }
     return ppl::common::RC_SUCCESS;
 }
@@ -422,7 +493,10 @@ template <>
     if (width == 0 || height == 0 || inYStride == 0 || inUVStride == 0 || outWidthStride == 0) {
         return ppl::common::RC_INVALID_VALUE;
     }
-    nv_2_rgb<4, 0, true>(height, width, inYStride, inY, inUVStride, inUV, outWidthStride, outData);
+    if (isa_supported(ppl::common::ISA_X86_AVX512)) {
+        return nv_2_rgb_parallel(avx512::nv_2_rgb<4, 0, true>, height, width, inYStride, inY, inUVStride, inUV, outWidthStride, outData);
+    }
+    nv_2_rgb_parallel(nv_2_rgb<4, 0, true>, height, width, inYStride, inY, inUVStride, inUV, outWidthStride, outData);
     return ppl::common::RC_SUCCESS;
 }
 
@@ -443,7 +517,10 @@ template <>
     if (width == 0 || height == 0 || inWidthStride == 0 || outYStride == 0 || outUVStride == 0) {
         return ppl::common::RC_INVALID_VALUE;
     }
-    rgb_2_nv<3, 2, true>(height, width, inWidthStride, inData, outYStride, outY, outUVStride, outUV);
+    if (isa_supported(ppl::common::ISA_X86_AVX512)) {
+        return rgb_2_nv_parallel(avx512::rgb_2_nv<3, 2, true>, height, width, inWidthStride, inData, outYStride, outY, outUVStride, outUV);
+    }
+    rgb_2_nv_parallel(rgb_2_nv<3, 2, true>, height, width, inWidthStride, inData, outYStride, outY, outUVStride, outUV);
     return ppl::common::RC_SUCCESS;
 }
 
@@ -464,7 +541,10 @@ template <>
     if (width == 0 || height == 0 || inWidthStride == 0 || outYStride == 0 || outUVStride == 0) {
         return ppl::common::RC_INVALID_VALUE;
     }
-    rgb_2_nv<4, 2, true>(height, width, inWidthStride, inData, outYStride, outY, outUVStride, outUV);
+    if (isa_supported(ppl::common::ISA_X86_AVX512)) {
+        return rgb_2_nv_parallel(avx512::rgb_2_nv<4, 2, true>, height, width, inWidthStride, inData, outYStride, outY, outUVStride, outUV);
+    }
+    rgb_2_nv_parallel(rgb_2_nv<4, 2, true>, height, width, inWidthStride, inData, outYStride, outY, outUVStride, outUV);
     return ppl::common::RC_SUCCESS;
 }
 
@@ -488,10 +568,12 @@ template <>
     if (width == 0 || height == 0 || inYStride == 0 || inUVStride == 0 || outWidthStride == 0) {
         return ppl::common::RC_INVALID_VALUE;
     }
-    if (ppl::common::CpuSupports(ppl::common::ISA_X86_FMA)) {
-        return fma::nv_2_rgb<3, 2, true>(height, width, inYStride, inY, inUVStride, inUV, outWidthStride, outData);
+    if (isa_supported(ppl::common::ISA_X86_AVX512)) {
+        return nv_2_rgb_parallel(avx512::nv_2_rgb<3, 2, true>, height, width, inYStride, inY, inUVStride, inUV, outWidthStride, outData);
+    } else if (isa_supported(ppl::common::ISA_X86_FMA)) {
+        return nv_2_rgb_parallel(fma::nv_2_rgb<3, 2, true>, height, width, inYStride, inY, inUVStride, inUV, outWidthStride, outData);
     } else {
-        nv_2_rgb<3, 2, true>(height, width, inYStride, inY, inUVStride, inUV, outWidthStride, outData);
+        nv_2_rgb_parallel(nv_2_rgb<3, 2, true>, height, width, inYStride, inY, inUVStride, inUV, outWidthStride, outData);
     }
     return ppl::common::RC_SUCCESS;
 }
@@ -516,7 +598,10 @@ template <>
     if (width == 0 || height == 0 || inYStride == 0 || inUVStride == 0 || outWidthStride == 0) {
         return ppl::common::RC_INVALID_VALUE;
     }
-    nv_2_rgb<4, 2, true>(height, width, inYStride, inY, inUVStride, inUV, outWidthStride, outData);
+    if (isa_supported(ppl::common::ISA_X86_AVX512)) {
+        return nv_2_rgb_parallel(avx512::nv_2_rgb<4, 2, true>, height, width, inYStride, inY, inUVStride, inUV, outWidthStride, outData);
+    }
+    nv_2_rgb_parallel(nv_2_rgb<4, 2, true>, height, width, inYStride, inY, inUVStride, inUV, outWidthStride, outData);
     return ppl::common::RC_SUCCESS;
 }
 
@@ -535,7 +620,10 @@ template <>
     if (width == 0 || height == 0 || inWidthStride == 0 || outWidthStride == 0) {
         return ppl::common::RC_INVALID_VALUE;
     }
-    rgb_2_nv<3, 0, false>(height, width, inWidthStride, inData, outWidthStride, outData, outWidthStride, outData + height * outWidthStride);
+    if (isa_supported(ppl::common::ISA_X86_AVX512)) {
+        return rgb_2_nv_parallel(avx512::rgb_2_nv<3, 0, false>, height, width, inWidthStride, inData, outWidthStride, outData, outWidthStride, outData + height * outWidthStride);
+    }
+    rgb_2_nv_parallel(rgb_2_nv<3, 0, false>, height, width, inWidthStride, inData, outWidthStride, outData, outWidthStride, outData + height * outWidthStride);
     return ppl::common::RC_SUCCESS;
 }
 
@@ -554,7 +642,10 @@ template <>
     if (width == 0 || height == 0 || inWidthStride == 0 || outWidthStride == 0) {
         return ppl::common::RC_INVALID_VALUE;
     }
-    rgb_2_nv<4, 0, false>(height, width, inWidthStride, inData, outWidthStride, outData, outWidthStride, outData + height * outWidthStride);
+    if (isa_supported(ppl::common::ISA_X86_AVX512)) {
+        return rgb_2_nv_parallel(avx512::rgb_2_nv<4, 0, false>, height, width, inWidthStride, inData, outWidthStride, outData, outWidthStride, outData + height * outWidthStride);
+    }
+    rgb_2_nv_parallel(rgb_2_nv<4, 0, false>, height, width, inWidthStride, inData, outWidthStride, outData, outWidthStride, outData + height * outWidthStride);
     return ppl::common::RC_SUCCESS;
 }
 
@@ -573,10 +664,12 @@ template <>
     if (width == 0 || height == 0 || inWidthStride == 0 || outWidthStride == 0) {
         return ppl::common::RC_INVALID_VALUE;
     }
-    if (ppl::common::CpuSupports(ppl::common::ISA_X86_FMA)) {
-        return fma::nv_2_rgb<3, 0, false>(height, width, inWidthStride, inData, inWidthStride, inData + height * inWidthStride, outWidthStride, outData);
+    if (isa_supported(ppl::common::ISA_X86_AVX512)) {
+        return nv_2_rgb_parallel(avx512::nv_2_rgb<3, 0, false>, height, width, inWidthStride, inData, inWidthStride, inData + height * inWidthStride, outWidthStride, outData);
+    } else if (isa_supported(ppl::common::ISA_X86_FMA)) {
+        return nv_2_rgb_parallel(fma::nv_2_rgb<3, 0, false>, height, width, inWidthStride, inData, inWidthStride, inData + height * inWidthStride, outWidthStride, outData);
     } else {
-        nv_2_rgb<3, 0, false>(height, width, inWidthStride, inData, inWidthStride, inData + height * inWidthStride, outWidthStride, outData);
+        nv_2_rgb_parallel(nv_2_rgb<3, 0, false>, height, width, inWidthStride, inData, inWidthStride, inData + height * inWidthStride, outWidthStride, outData);
     }
     return ppl::common::RC_SUCCESS;
 }
@@ -596,7 +689,10 @@ template <>
     if (width == 0 || height == 0 || inWidthStride == 0 || outWidthStride == 0) {
         return ppl::common::RC_INVALID_VALUE;
     }
-    nv_2_rgb<4, 0, false>(height, width, inWidthStride, inData, inWidthStride, inData + height * inWidthStride, outWidthStride, outData);
+    if (isa_supported(ppl::common::ISA_X86_AVX512)) {
+        return nv_2_rgb_parallel(avx512::nv_2_rgb<4, 0, false>, height, width, inWidthStride, inData, inWidthStride, inData + height * inWidthStride, outWidthStride, outData);
+    }
+    nv_2_rgb_parallel(nv_2_rgb<4, 0, false>, height, width, inWidthStride, inData, inWidthStride, inData + height * inWidthStride, outWidthStride, outData);
     return ppl::common::RC_SUCCESS;
 }
 
@@ -615,7 +711,10 @@ template <>
     if (width == 0 || height == 0 || inWidthStride == 0 || outWidthStride == 0) {
         return ppl::common::RC_INVALID_VALUE;
     }
-    rgb_2_nv<3, 2, false>(height, width, inWidthStride, inData, outWidthStride, outData, outWidthStride, outData + height * outWidthStride);
+    if (isa_supported(ppl::common::ISA_X86_AVX512)) {
+        return rgb_2_nv_parallel(avx512::rgb_2_nv<3, 2, false>, height, width, inWidthStride, inData, outWidthStride, outData, outWidthStride, outData + height * outWidthStride);
+    }
+    rgb_2_nv_parallel(rgb_2_nv<3, 2, false>, height, width, inWidthStride, inData, outWidthStride, outData, outWidthStride, outData + height * outWidthStride);
     return ppl::common::RC_SUCCESS;
 }
 
@@ -634,7 +733,10 @@ template <>
     if (width == 0 || height == 0 || inWidthStride == 0 || outWidthStride == 0) {
         return ppl::common::RC_INVALID_VALUE;
     }
-    rgb_2_nv<4, 2, false>(height, width, inWidthStride, inData, outWidthStride, outData, outWidthStride, outData + height * outWidthStride);
+    if (isa_supported(ppl::common::ISA_X86_AVX512)) {
+        return rgb_2_nv_parallel(avx512::rgb_2_nv<4, 2, false>, height, width, inWidthStride, inData, outWidthStride, outData, outWidthStride, outData + height * outWidthStride);
+    }
+    rgb_2_nv_parallel(rgb_2_nv<4, 2, false>, height, width, inWidthStride, inData, outWidthStride, outData, outWidthStride, outData + height * outWidthStride);
     return ppl::common::RC_SUCCESS;
 }
 
@@ -653,10 +755,12 @@ template <>
     if (width == 0 || height == 0 || inWidthStride == 0 || outWidthStride == 0) {
         return ppl::common::RC_INVALID_VALUE;
     }
-    if (ppl::common::CpuSupports(ppl::common::ISA_X86_FMA)) {
-        return fma::nv_2_rgb<3, 2, false>(height, width, inWidthStride, inData, inWidthStride, inData + height * inWidthStride, outWidthStride, outData);
+    if (isa_supported(ppl::common::ISA_X86_AVX512)) {
+        return nv_2_rgb_parallel(avx512::nv_2_rgb<3, 2, false>, height, width, inWidthStride, inData, inWidthStride, inData + height * inWidthStride, outWidthStride, outData);
+    } else if (isa_supported(ppl::common::ISA_X86_FMA)) {
+        return nv_2_rgb_parallel(fma::nv_2_rgb<3, 2, false>, height, width, inWidthStride, inData, inWidthStride, inData + height * inWidthStride, outWidthStride, outData);
     } else {
-        nv_2_rgb<3, 2, false>(height, width, inWidthStride, inData, inWidthStride, inData + height * inWidthStride, outWidthStride, outData);
+        nv_2_rgb_parallel(nv_2_rgb<3, 2, false>, height, width, inWidthStride, inData, inWidthStride, inData + height * inWidthStride, outWidthStride, outData);
     }
     return ppl::common::RC_SUCCESS;
 }
@@ -676,7 +780,10 @@ template <>
     if (width == 0 || height == 0 || inWidthStride == 0 || outWidthStride == 0) {
         return ppl::common::RC_INVALID_VALUE;
     }
-    nv_2_rgb<4, 2, false>(height, width, inWidthStride, inData, inWidthStride, inData + height * inWidthStride, outWidthStride, outData);
+    if (isa_supported(ppl::common::ISA_X86_AVX512)) {
+        return nv_2_rgb_parallel(avx512::nv_2_rgb<4, 2, false>, height, width, inWidthStride, inData, inWidthStride, inData + height * inWidthStride, outWidthStride, outData);
+    }
+    nv_2_rgb_parallel(nv_2_rgb<4, 2, false>, height, width, inWidthStride, inData, inWidthStride, inData + height * inWidthStride, outWidthStride, outData);
     return ppl::common::RC_SUCCESS;
 }
 
@@ -697,7 +804,10 @@ template <>
     if (width == 0 || height == 0 || inWidthStride == 0 || outYStride == 0 || outUVStride == 0) {
         return ppl::common::RC_INVALID_VALUE;
     }
-    rgb_2_nv<3, 0, false>(height, width, inWidthStride, inData, outYStride, outY, outUVStride, outUV);
+    if (isa_supported(ppl::common::ISA_X86_AVX512)) {
+        return rgb_2_nv_parallel(avx512::rgb_2_nv<3, 0, false>, height, width, inWidthStride, inData, outYStride, outY, outUVStride, outUV);
+    }
+    rgb_2_nv_parallel(rgb_2_nv<3, 0, false>, height, width, inWidthStride, inData, outYStride, outY, outUVStride, outUV);
     return ppl::common::RC_SUCCESS;
 }
 
@@ -718,7 +828,10 @@ template <>
     if (width == 0 || height == 0 || inWidthStride == 0 || outYStride == 0 || outUVStride == 0) {
         return ppl::common::RC_INVALID_VALUE;
     }
-    rgb_2_nv<4, 0, false>(height, width, inWidthStride, inData, outYStride, outY, outUVStride, outUV);
+    if (isa_supported(ppl::common::ISA_X86_AVX512)) {
+        return rgb_2_nv_parallel(avx512::rgb_2_nv<4, 0, false>, height, width, inWidthStride, inData, outYStride, outY, outUVStride, outUV);
+    }
+    rgb_2_nv_parallel(rgb_2_nv<4, 0, false>, height, width, inWidthStride, inData, outYStride, outY, outUVStride, outUV);
     return ppl::common::RC_SUCCESS;
 }
 
@@ -742,10 +855,12 @@ template <>
     if (width == 0 || height == 0 || inYStride == 0 || inUVStride == 0 || outWidthStride == 0) {
         return ppl::common::RC_INVALID_VALUE;
     }
-    if (ppl::common::CpuSupports(ppl::common::ISA_X86_FMA)) {
-        return fma::nv_2_rgb<3, 0, false>(height, width, inYStride, inY, inUVStride, inUV, outWidthStride, outData);
+    if (isa_supported(ppl::common::ISA_X86_AVX512)) {
+        return nv_2_rgb_parallel(avx512::nv_2_rgb<3, 0, false>, height, width, inYStride, inY, inUVStride, inUV, outWidthStride, outData);
+    } else if (isa_supported(ppl::common::ISA_X86_FMA)) {
+        return nv_2_rgb_parallel(fma::nv_2_rgb<3, 0, false>, height, width, inYStride, inY, inUVStride, inUV, outWidthStride, outData);
     } else {
-        nv_2_rgb<3, 0, false>(height, width, inYStride, inY, inUVStride, inUV, outWidthStride, outData);
+        nv_2_rgb_parallel(nv_2_rgb<3, 0, false>, height, width, inYStride, inY, inUVStride, inUV, outWidthStride, outData);
     }
     return ppl::common::RC_SUCCESS;
 }
@@ -770,7 +885,10 @@ template <>
     if (width == 0 || height == 0 || inYStride == 0 || inUVStride == 0 || outWidthStride == 0) {
         return ppl::common::RC_INVALID_VALUE;
     }
-    nv_2_rgb<4, 0, false>(height, width, inYStride, inY, inUVStride, inUV, outWidthStride, outData);
+    if (isa_supported(ppl::common::ISA_X86_AVX512)) {
+        return nv_2_rgb_parallel(avx512::nv_2_rgb<4, 0, false>, height, width, inYStride, inY, inUVStride, inUV, outWidthStride, outData);
+    }
+    nv_2_rgb_parallel(nv_2_rgb<4, 0, false>, height, width, inYStride, inY, inUVStride, inUV, outWidthStride, outData);
     return ppl::common::RC_SUCCESS;
 }
 
@@ -791,7 +909,10 @@ template <>
     if (width == 0 || height == 0 || inWidthStride == 0 || outYStride == 0 || outUVStride == 0) {
         return ppl::common::RC_INVALID_VALUE;
     }
-    rgb_2_nv<3, 2, false>(height, width, inWidthStride, inData, outYStride, outY, outUVStride, outUV);
+    if (isa_supported(ppl::common::ISA_X86_AVX512)) {
+        return rgb_2_nv_parallel(avx512::rgb_2_nv<3, 2, false>, height, width, inWidthStride, inData, outYStride, outY, outUVStride, outUV);
+    }
+    rgb_2_nv_parallel(rgb_2_nv<3, 2, false>, height, width, inWidthStride, inData, outYStride, outY, outUVStride, outUV);
     return ppl::common::RC_SUCCESS;
 }
 
@@ -812,7 +933,10 @@ template <>
     if (width == 0 || height == 0 || inWidthStride == 0 || outYStride == 0 || outUVStride == 0) {
         return ppl::common::RC_INVALID_VALUE;
     }
-    rgb_2_nv<4, 2, false>(height, width, inWidthStride, inData, outYStride, outY, outUVStride, outUV);
+    if (isa_supported(ppl::common::ISA_X86_AVX512)) {
+        return rgb_2_nv_parallel(avx512::rgb_2_nv<4, 2, false>, height, width, inWidthStride, inData, outYStride, outY, outUVStride, outUV);
+    }
+    rgb_2_nv_parallel(rgb_2_nv<4, 2, false>, height, width, inWidthStride, inData, outYStride, outY, outUVStride, outUV);
     return ppl::common::RC_SUCCESS;
 }
 
@@ -836,10 +960,12 @@ template <>
     if (width == 0 || height == 0 || inYStride == 0 || inUVStride == 0 || outWidthStride == 0) {
         return ppl::common::RC_INVALID_VALUE;
     }
-    if (ppl::common::CpuSupports(ppl::common::ISA_X86_FMA)) {
-        return fma::nv_2_rgb<3, 2, false>(height, width, inYStride, inY, inUVStride, inUV, outWidthStride, outData);
+    if (isa_supported(ppl::common::ISA_X86_AVX512)) {
+        return nv_2_rgb_parallel(avx512::nv_2_rgb<3, 2, false>, height, width, inYStride, inY, inUVStride, inUV, outWidthStride, outData);
+    } else if (isa_supported(ppl::common::ISA_X86_FMA)) {
+        return nv_2_rgb_parallel(fma::nv_2_rgb<3, 2, false>, height, width, inYStride, inY, inUVStride, inUV, outWidthStride, outData);
     } else {
-        nv_2_rgb<3, 2, false>(height, width, inYStride, inY, inUVStride, inUV, outWidthStride, outData);
+        nv_2_rgb_parallel(nv_2_rgb<3, 2, false>, height, width, inYStride, inY, inUVStride, inUV, outWidthStride, outData);
     }
     return ppl::common::RC_SUCCESS;
 }
@@ -864,7 +990,10 @@ template <>
     if (width == 0 || height == 0 || inYStride == 0 || inUVStride == 0 || outWidthStride == 0) {
         return ppl::common::RC_INVALID_VALUE;
     }
-    nv_2_rgb<4, 2, false>(height, width, inYStride, inY, inUVStride, inUV, outWidthStride, outData);
+    if (isa_supported(ppl::common::ISA_X86_AVX512)) {
+        return nv_2_rgb_parallel(avx512::nv_2_rgb<4, 2, false>, height, width, inYStride, inY, inUVStride, inUV, outWidthStride, outData);
+    }
+    nv_2_rgb_parallel(nv_2_rgb<4, 2, false>, height, width, inYStride, inY, inUVStride, inUV, outWidthStride, outData);
     return ppl::common::RC_SUCCESS;
 }
 }
@@ -19,11 +19,14 @@
 
 #include "ppl/cv/x86/avx/internal_avx.hpp"
 #include "ppl/cv/x86/fma/internal_fma.hpp"
+#include "ppl/cv/x86/avx512/internal_avx512.hpp"
 #include "ppl/cv/types.h"
 #include "ppl/cv/x86/util.hpp"
+#include "ppl/cv/x86/parallel.hpp"
 #include "ppl/common/sys.h"
 #include "ppl/common/retcode.h"
 #include "ppl/common/x86/sysinfo.h"
+#include "ppl/cv/x86/isa.hpp"
 
 #include <string.h>
 #include <cmath>
@@ -307,6 +310,9 @@ struct RGBtoYUV420p_u8 {
     __m128i half      = _mm_setr_epi16(0, half_shift, 0, half_shift, 0, half_shift, 0, half_shift);
     __m128i vzero     = _mm_setzero_si128();
 
+    const int32_t coeffs[9] = {coeff_YB, coeff_YG, coeff_YR, coeff_UB, coeff_UG, coeff_UR, coeff_VB, coeff_VG, coeff_VR};
+    bool use_avx512         = isa_supported(ppl::common::ISA_X86_AVX512);
+
     int32_t vsize = 16;
     for (int32_t h = 0; h < height; h++) {
         const uint8_t *src_ptr = src + h * inWidthStride;
@@ -315,6 +321,10 @@ struct RGBtoYUV420p_u8 {
         uint8_t *dstV_ptr      = dstV + (h / 2) * vStride;
         bool evenh             = (h % 2) == 0;
         int32_t w              = 0;
+        if (use_avx512) {
+            w = avx512::bgr_2_i420_line(src_ptr, width / 2, coeffs, dstY_ptr, evenh ? dstU_ptr : nullptr, dstV_ptr);
+            src_ptr += w * 6;
+        }
         for (; w <= width / 2 - 16; w += vsize, src_ptr += vsize * 6) {
             __m128i data0_0 = _mm_loadu_si128((__m128i *)(src_ptr + 0));
             __m128i data0_1 = _mm_loadu_si128((__m128i *)(src_ptr + 16));
@@ -467,6 +477,63 @@ template <int32_t scn, int32_t bIdx>
     return s.operator()(height, width, scn, inWidthStride, inData, outYStride, outDataY, outUStride, outDataU, outVStride, outDataV);
 }
 
+// I420/YV12 kernels work on pairs of luma rows sharing one row of each chroma
+// plane, so the image is split into bands of even height and each band's
+// planes are offset to its first row.
+template <typename Kernel>
+::ppl::common::RetCode yuv420_2_rgb_parallel(
+    Kernel kernel,
+    int32_t height,
+    int32_t width,
+    int32_t inYStride,
+    const uint8_t *inDataY,
+    int32_t inUStride,
+    const uint8_t *inDataU,
+    int32_t inVStride,
+    const uint8_t *inDataV,
+    int32_t outWidthStride,
+    uint8_t *outData)
+{
+    return parallel_for_rows_status(height, width * 4, [&](int32_t begin, int32_t end) {
+        return kernel(end - begin, width, inYStride, inDataY + begin * inYStride, inUStride, inDataU + begin / 2 * inUStride, inVStride, inDataV + begin / 2 * inVStride, outWidthStride, outData + begin * outWidthStride);
+    }, 2);
+}
+
+template <typename Kernel>
+::ppl::common::RetCode rgb_2_yuv420_parallel(
+    Kernel kernel,
+    int32_t height,
+    int32_t width,
+    int32_t inWidthStride,
+    const uint8_t *inData,
+    int32_t outYStride,
+    uint8_t *outDataY,
+    int32_t outUStride,
+    uint8_t *outDataU,
+    int32_t outVStride,
+    uint8_t *outDataV)
+{
+    return parallel_for_rows_status(height, width * 4, [&](int32_t begin, int32_t end) {
+        return kernel(end - begin, width, inWidthStride, inData + begin * inWidthStride, outYStride, outDataY + begin * outYStride, outUStride, outDataU + begin / 2 * outUStride, outVStride, outDataV + begin / 2 * outVStride);
+    }, 2);
+}
+
+template <bool isRGB>
+::ppl::common::RetCode RGBtoYUV420p_sse(
+    int32_t height,
+    int32_t width,
+    int32_t inWidthStride,
+    const uint8_t *inData,
+    int32_t outYStride,
+    uint8_t *outDataY,
+    int32_t outUStride,
+    uint8_t *outDataU,
+    int32_t outVStride,
+    uint8_t *outDataV)
+{
+    return BGR2I420SSE(inData, outDataY, outDataU, outDataV, width, height, inWidthStride, outYStride, outUStride, outVStride, isRGB);
+}
+
 template <>
 ::ppl::common::RetCode I4202BGR<uint8_t>(
     int32_t height,
@@ -488,12 +555,14 @@ template <>
     const uint8_t *inDataY = inData;
     const uint8_t *inDataU = inData + height * inWidthStride;
     const uint8_t *inDataV = inData + height * inWidthStride + (height / 2) * (inWidthStride / 2);
-    if (ppl::common::CpuSupports(ppl::common::ISA_X86_FMA)) {
-        return fma::i420_2_rgb<3, 0>(height, width, inWidthStride, inDataY, inWidthStride / 2, inDataU, inWidthStride / 2, inDataV, outWidthStride, outData);
-    } else if (ppl::common::CpuSupports(ppl::common::ISA_X86_AVX)) {
-        return YUV420ptoRGB_avx<3, 0>(height, width, inWidthStride, inDataY, inWidthStride / 2, inDataU, inWidthStride / 2, inDataV, outWidthStride, outData);
+    if (isa_supported(ppl::common::ISA_X86_AVX512)) {
+        return yuv420_2_rgb_parallel(avx512::i420_2_rgb<3, 0>, height, width, inWidthStride, inDataY, inWidthStride / 2, inDataU, inWidthStride / 2, inDataV, outWidthStride, outData);
+    } else if (isa_supported(ppl::common::ISA_X86_FMA)) {
+        return yuv420_2_rgb_parallel(fma::i420_2_rgb<3, 0>, height, width, inWidthStride, inDataY, inWidthStride / 2, inDataU, inWidthStride / 2, inDataV, outWidthStride, outData);
+    } else if (isa_supported(ppl::common::ISA_X86_AVX)) {
+        return yuv420_2_rgb_parallel(YUV420ptoRGB_avx<3, 0>, height, width, inWidthStride, inDataY, inWidthStride / 2, inDataU, inWidthStride / 2, inDataV, outWidthStride, outData);
     } else {
-        return YUV420ptoRGB<3, 0>(height, width, inWidthStride, inDataY, inWidthStride / 2, inDataU, inWidthStride / 2, inDataV, outWidthStride, outData);
+        return yuv420_2_rgb_parallel(YUV420ptoRGB<3, 0>, height, width, inWidthStride, inDataY, inWidthStride / 2, inDataU, inWidthStride / 2, inDataV, outWidthStride, outData);
     }
 }
 template <>
@@ -517,12 +586,14 @@ template <>
     const uint8_t *inDataY = inData;
     const uint8_t *inDataV = inData + height * inWidthStride;
     const uint8_t *inDataU = inData + height * inWidthStride + (height / 2) * (inWidthStride / 2);
-    if (ppl::common::CpuSupports(ppl::common::ISA_X86_FMA)) {
-        return fma::i420_2_rgb<3, 0>(height, width, inWidthStride, inDataY, inWidthStride / 2, inDataU, inWidthStride / 2, inDataV, outWidthStride, outData);
-    } else if (ppl::common::CpuSupports(ppl::common::ISA_X86_AVX)) {
-        return YUV420ptoRGB_avx<3, 0>(height, width, inWidthStride, inDataY, inWidthStride / 2, inDataU, inWidthStride / 2, inDataV, outWidthStride, outData);
+    if (isa_supported(ppl::common::ISA_X86_AVX512)) {
+        return yuv420_2_rgb_parallel(avx512::i420_2_rgb<3, 0>, height, width, inWidthStride, inDataY, inWidthStride / 2, inDataU, inWidthStride / 2, inDataV, outWidthStride, outData);
+    } else if (isa_supported(ppl::common::ISA_X86_FMA)) {
+        return yuv420_2_rgb_parallel(fma::i420_2_rgb<3, 0>, height, width, inWidthStride, inDataY, inWidthStride / 2, inDataU, inWidthStride / 2, inDataV, outWidthStride, outData);
+    } else if (isa_supported(ppl::common::ISA_X86_AVX)) {
+        return yuv420_2_rgb_parallel(YUV420ptoRGB_avx<3, 0>, height, width, inWidthStride, inDataY, inWidthStride / 2, inDataU, inWidthStride / 2, inDataV, outWidthStride, outData);
     } else {
-        return YUV420ptoRGB<3, 0>(height, width, inWidthStride, inDataY, inWidthStride / 2, inDataU, inWidthStride / 2, inDataV, outWidthStride, outData);
+        return yuv420_2_rgb_parallel(YUV420ptoRGB<3, 0>, height, width, inWidthStride, inDataY, inWidthStride / 2, inDataU, inWidthStride / 2, inDataV, outWidthStride, outData);
     }
 }
 template <>
@@ -546,10 +617,12 @@ template <>
     const uint8_t *inDataY = inData;
     const uint8_t *inDataU = inData + height * inWidthStride;
     const uint8_t *inDataV = inData + height * inWidthStride + (height / 2) * (inWidthStride / 2);
-    if (ppl::common::CpuSupports(ppl::common::ISA_X86_AVX)) {
-        return YUV420ptoRGB_avx<4, 0>(height, width, inWidthStride, inDataY, inWidthStride / 2, inDataU, inWidthStride / 2, inDataV, outWidthStride, outData);
+    if (isa_supported(ppl::common::ISA_X86_AVX512)) {
+        return yuv420_2_rgb_parallel(avx512::i420_2_rgb<4, 0>, height, width, inWidthStride, inDataY, inWidthStride / 2, inDataU, inWidthStride / 2, inDataV, outWidthStride, outData);
+    } else if (isa_supported(ppl::common::ISA_X86_AVX)) {
+        return yuv420_2_rgb_parallel(YUV420ptoRGB_avx<4, 0>, height, width, inWidthStride, inDataY, inWidthStride / 2, inDataU, inWidthStride / 2, inDataV, outWidthStride, outData);
     } else {
-        return YUV420ptoRGB<4, 0>(height, width, inWidthStride, inDataY, inWidthStride / 2, inDataU, inWidthStride / 2, inDataV, outWidthStride, outData);
+        return yuv420_2_rgb_parallel(YUV420ptoRGB<4, 0>, height, width, inWidthStride, inDataY, inWidthStride / 2, inDataU, inWidthStride / 2, inDataV, outWidthStride, outData);
     }
 }
 template <>
@@ -573,10 +646,12 @@ template <>
     const uint8_t *inDataY = inData;
     const uint8_t *inDataV = inData + height * inWidthStride;
     const uint8_t *inDataU = inData + height * inWidthStride + (height / 2) * (inWidthStride / 2);
-    if (ppl::common::CpuSupports(ppl::common::ISA_X86_AVX)) {
-        return YUV420ptoRGB_avx<4, 0>(height, width, inWidthStride, inDataY, inWidthStride / 2, inDataU, inWidthStride / 2, inDataV, outWidthStride, outData);
+    if (isa_supported(ppl::common::ISA_X86_AVX512)) {
+        return yuv420_2_rgb_parallel(avx512::i420_2_rgb<4, 0>, height, width, inWidthStride, inDataY, inWidthStride / 2, inDataU, inWidthStride / 2, inDataV, outWidthStride, outData);
+    } else if (isa_supported(ppl::common::ISA_X86_AVX)) {
+        return yuv420_2_rgb_parallel(YUV420ptoRGB_avx<4, 0>, height, width, inWidthStride, inDataY, inWidthStride / 2, inDataU, inWidthStride / 2, inDataV, outWidthStride, outData);
     } else {
-        return YUV420ptoRGB<4, 0>(height, width, inWidthStride, inDataY, inWidthStride / 2, inDataU, inWidthStride / 2, inDataV, outWidthStride, outData);
+        return yuv420_2_rgb_parallel(YUV420ptoRGB<4, 0>, height, width, inWidthStride, inDataY, inWidthStride / 2, inDataU, inWidthStride / 2, inDataV, outWidthStride, outData);
     }
 }
 
@@ -601,10 +676,10 @@ template <>
     uint8_t *outDataY = outData;
     uint8_t *outDataU = outData + height * outWidthStride;
     uint8_t *outDataV = outData + height * outWidthStride + (height / 2) * (outWidthStride / 2);
-    if (ppl::common::CpuSupports(ppl::common::ISA_X86_SSE41)) {
-        return BGR2I420SSE(inData, outDataY, outDataU, outDataV, width, height, inWidthStride, outWidthStride, outWidthStride / 2, outWidthStride / 2);
+    if (isa_supported(ppl::common::ISA_X86_SSE41)) {
+        return rgb_2_yuv420_parallel(RGBtoYUV420p_sse<false>, height, width, inWidthStride, inData, outWidthStride, outDataY, outWidthStride / 2, outDataU, outWidthStride / 2, outDataV);
     }
-    return RGBtoYUV420p<3, 0>(height, width, inWidthStride, inData, outWidthStride, outDataY, outWidthStride / 2, outDataU, outWidthStride / 2, outDataV);
+    return rgb_2_yuv420_parallel(RGBtoYUV420p<3, 0>, height, width, inWidthStride, inData, outWidthStride, outDataY, outWidthStride / 2, outDataU, outWidthStride / 2, outDataV);
 }
 template <>
 ::ppl::common::RetCode BGR2YV12<uint8_t>(
@@ -627,10 +702,10 @@ template <>
     uint8_t *outDataY = outData;
     uint8_t *outDataV = outData + height * outWidthStride;
     uint8_t *outDataU = outData + height * outWidthStride + (height / 2) * (outWidthStride / 2);
-    if (ppl::common::CpuSupports(ppl::common::ISA_X86_SSE41)) {
-        return BGR2I420SSE(inData, outDataY, outDataU, outDataV, width, height, inWidthStride, outWidthStride, outWidthStride / 2, outWidthStride / 2);
+    if (isa_supported(ppl::common::ISA_X86_SSE41)) {
+        return rgb_2_yuv420_parallel(RGBtoYUV420p_sse<false>, height, width, inWidthStride, inData, outWidthStride, outDataY, outWidthStride / 2, outDataU, outWidthStride / 2, outDataV);
     }
-    return RGBtoYUV420p<3, 0>(height, width, inWidthStride, inData, outWidthStride, outDataY, outWidthStride / 2, outDataU, outWidthStride / 2, outDataV);
+    return rgb_2_yuv420_parallel(RGBtoYUV420p<3, 0>, height, width, inWidthStride, inData, outWidthStride, outDataY, outWidthStride / 2, outDataU, outWidthStride / 2, outDataV);
 }
 
 template <>
@@ -654,7 +729,7 @@ template <>
     uint8_t *outDataY = outData;
     uint8_t *outDataU = outData + height * outWidthStride;
     uint8_t *outDataV = outData + height * outWidthStride + (height / 2) * (outWidthStride / 2);
-    return RGBtoYUV420p<4, 0>(height, width, inWidthStride, inData, outWidthStride, outDataY, outWidthStride / 2, outDataU, outWidthStride / 2, outDataV);
+    return rgb_2_yuv420_parallel(RGBtoYUV420p<4, 0>, height, width, inWidthStride, inData, outWidthStride, outDataY, outWidthStride / 2, outDataU, outWidthStride / 2, outDataV);
 }
 template <>
 ::ppl::common::RetCode BGRA2YV12<uint8_t>(
@@ -677,7 +752,7 @@ template <>
     uint8_t *outDataY = outData;
     uint8_t *outDataV = outData + height * outWidthStride;
     uint8_t *outDataU = outData + height * outWidthStride + (height / 2) * (outWidthStride / 2);
-    return RGBtoYUV420p<4, 0>(height, width, inWidthStride, inData, outWidthStride, outDataY, outWidthStride / 2, outDataU, outWidthStride / 2, outDataV);
+    return rgb_2_yuv420_parallel(RGBtoYUV420p<4, 0>, height, width, inWidthStride, inData, outWidthStride, outDataY, outWidthStride / 2, outDataU, outWidthStride / 2, outDataV);
 }
 
 template <>
@@ -701,12 +776,14 @@ template <>
     const uint8_t *inDataY = inData;
     const uint8_t *inDataU = inData + height * inWidthStride;
     const uint8_t *inDataV = inData + height * inWidthStride + (height / 2) * (inWidthStride / 2);
-    if (ppl::common::CpuSupports(ppl::common::ISA_X86_FMA)) {
-        return fma::i420_2_rgb<3, 2>(height, width, inWidthStride, inDataY, inWidthStride / 2, inDataU, inWidthStride / 2, inDataV, outWidthStride, outData);
-    } else if (ppl::common::CpuSupports(ppl::common::ISA_X86_AVX)) {
-        return YUV420ptoRGB_avx<3, 2>(height, width, inWidthStride, inDataY, inWidthStride / 2, inDataU, inWidthStride / 2, inDataV, outWidthStride, outData);
+    if (isa_supported(ppl::common::ISA_X86_AVX512)) {
+        return yuv420_2_rgb_parallel(avx512::i420_2_rgb<3, 2>, height, width, inWidthStride, inDataY, inWidthStride / 2, inDataU, inWidthStride / 2, inDataV, outWidthStride, outData);
+    } else if (isa_supported(ppl::common::ISA_X86_FMA)) {
+        return yuv420_2_rgb_parallel(fma::i420_2_rgb<3, 2>, height, width, inWidthStride, inDataY, inWidthStride / 2, inDataU, inWidthStride / 2, inDataV, outWidthStride, outData);
+    } else if (isa_supported(ppl::common::ISA_X86_AVX)) {
+        return yuv420_2_rgb_parallel(YUV420ptoRGB_avx<3, 2>, height, width, inWidthStride, inDataY, inWidthStride / 2, inDataU, inWidthStride / 2, inDataV, outWidthStride, outData);
     } else {
-        return YUV420ptoRGB<3, 2>(height, width, inWidthStride, inDataY, inWidthStride / 2, inDataU, inWidthStride / 2, inDataV, outWidthStride, outData);
+        return yuv420_2_rgb_parallel(YUV420ptoRGB<3, 2>, height, width, inWidthStride, inDataY, inWidthStride / 2, inDataU, inWidthStride / 2, inDataV, outWidthStride, outData);
     }
 }
 template <>
@@ -730,12 +807,14 @@ template <>
     const uint8_t *inDataY = inData;
     const uint8_t *inDataV = inData + height * inWidthStride;
     const uint8_t *inDataU = inData + height * inWidthStride + (height / 2) * (inWidthStride / 2);
-    if (ppl::common::CpuSupports(ppl::common::ISA_X86_FMA)) {
-        return fma::i420_2_rgb<3, 2>(height, width, inWidthStride, inDataY, inWidthStride / 2, inDataU, inWidthStride / 2, inDataV, outWidthStride, outData);
-    } else if (ppl::common::CpuSupports(ppl::common::ISA_X86_AVX)) {
-        return YUV420ptoRGB_avx<3, 2>(height, width, inWidthStride, inDataY, inWidthStride / 2, inDataU, inWidthStride / 2, inDataV, outWidthStride, outData);
+    if (isa_supported(ppl::common::ISA_X86_AVX512)) {
+        return yuv420_2_rgb_parallel(avx512::i420_2_rgb<3, 2>, height, width, inWidthStride, inDataY, inWidthStride / 2, inDataU, inWidthStride / 2, inDataV, outWidthStride, outData);
+    } else if (isa_supported(ppl::common::ISA_X86_FMA)) {
+        return yuv420_2_rgb_parallel(fma::i420_2_rgb<3, 2>, height, width, inWidthStride, inDataY, inWidthStride / 2, inDataU, inWidthStride / 2, inDataV, outWidthStride, outData);
+    } else if (isa_supported(ppl::common::ISA_X86_AVX)) {
+        return yuv420_2_rgb_parallel(YUV420ptoRGB_avx<3, 2>, height, width, inWidthStride, inDataY, inWidthStride / 2, inDataU, inWidthStride / 2, inDataV, outWidthStride, outData);
     } else {
-        return YUV420ptoRGB<3, 2>(height, width, inWidthStride, inDataY, inWidthStride / 2, inDataU, inWidthStride / 2, inDataV, outWidthStride, outData);
+        return yuv420_2_rgb_parallel(YUV420ptoRGB<3, 2>, height, width, inWidthStride, inDataY, inWidthStride / 2, inDataU, inWidthStride / 2, inDataV, outWidthStride, outData);
     }
 }
 template <>
@@ -759,10 +838,12 @@ template <>
     const uint8_t *inDataY = inData;
     const uint8_t *inDataU = inData + height * inWidthStride;
     const uint8_t *inDataV = inData + height * inWidthStride + (height / 2) * (inWidthStride / 2);
-    if (ppl::common::CpuSupports(ppl::common::ISA_X86_AVX)) {
-        return YUV420ptoRGB_avx<4, 2>(height, width, inWidthStride, inDataY, inWidthStride / 2, inDataU, inWidthStride / 2, inDataV, outWidthStride, outData);
+    if (isa_supported(ppl::common::ISA_X86_AVX512)) {
+        return yuv420_2_rgb_parallel(avx512::i420_2_rgb<4, 2>, height, width, inWidthStride, inDataY, inWidthStride / 2, inDataU, inWidthStride / 2, inDataV, outWidthStride, outData);
+    } else if (isa_supported(ppl::common::ISA_X86_AVX)) {
+        return yuv420_2_rgb_parallel(YUV420ptoRGB_avx<4, 2>, height, width, inWidthStride, inDataY, inWidthStride / 2, inDataU, inWidthStride / 2, inDataV, outWidthStride, outData);
     } else {
-        return YUV420ptoRGB<4, 2>(height, width, inWidthStride, inDataY, inWidthStride / 2, inDataU, inWidthStride / 2, inDataV, outWidthStride, outData);
+        return yuv420_2_rgb_parallel(YUV420ptoRGB<4, 2>, height, width, inWidthStride, inDataY, inWidthStride / 2, inDataU, inWidthStride / 2, inDataV, outWidthStride, outData);
     }
 }
 template <>
@@ -786,10 +867,12 @@ template <>
     const uint8_t *inDataY = inData;
     const uint8_t *inDataV = inData + height * inWidthStride;
     const uint8_t *inDataU = inData + height * inWidthStride + (height / 2) * (inWidthStride / 2);
-    if (ppl::common::CpuSupports(ppl::common::ISA_X86_AVX)) {
-        return YUV420ptoRGB_avx<4, 2>(height, width, inWidthStride, inDataY, inWidthStride / 2, inDataU, inWidthStride / 2, inDataV, outWidthStride, outData);
+    if (isa_supported(ppl::common::ISA_X86_AVX512)) {
+        return yuv420_2_rgb_parallel(avx512::i420_2_rgb<4, 2>, height, width, inWidthStride, inDataY, inWidthStride / 2, inDataU, inWidthStride / 2, inDataV, outWidthStride, outData);
+    } else if (isa_supported(ppl::common::ISA_X86_AVX)) {
+        return yuv420_2_rgb_parallel(YUV420ptoRGB_avx<4, 2>, height, width, inWidthStride, inDataY, inWidthStride / 2, inDataU, inWidthStride / 2, inDataV, outWidthStride, outData);
     } else {
-        return YUV420ptoRGB<4, 2>(height, width, inWidthStride, inDataY, inWidthStride / 2, inDataU, inWidthStride / 2, inDataV, outWidthStride, outData);
+        return yuv420_2_rgb_parallel(YUV420ptoRGB<4, 2>, height, width, inWidthStride, inDataY, inWidthStride / 2, inDataU, inWidthStride / 2, inDataV, outWidthStride, outData);
     }
 }
 template <>
@@ -813,10 +896,10 @@ template <>
     uint8_t *outDataY = outData;
     uint8_t *outDataU = outData + height * outWidthStride;
     uint8_t *outDataV = outData + height * outWidthStride + (height / 2) * (outWidthStride / 2);
-    if (ppl::common::CpuSupports(ppl::common::ISA_X86_SSE41)) {
-        return BGR2I420SSE(inData, outDataY, outDataU, outDataV, width, height, inWidthStride, outWidthStride, outWidthStride / 2, outWidthStride / 2, true);
+    if (isa_supported(ppl::common::ISA_X86_SSE41)) {
+        return rgb_2_yuv420_parallel(RGBtoYUV420p_sse<true>, height, width, inWidthStride, inData, outWidthStride, outDataY, outWidthStride / 2, outDataU, outWidthStride / 2, outDataV);
     }
-    return RGBtoYUV420p<3, 2>(height, width, inWidthStride, inData, outWidthStride, outDataY, outWidthStride / 2, outDataU, outWidthStride / 2, outDataV);
+    return rgb_2_yuv420_parallel(RGBtoYUV420p<3, 2>, height, width, inWidthStride, inData, outWidthStride, outDataY, outWidthStride / 2, outDataU, outWidthStride / 2, outDataV);
 }
 
 template <>
@@ -840,10 +923,10 @@ template <>
     uint8_t *outDataY = outData;
     uint8_t *outDataV = outData + height * outWidthStride;
     uint8_t *outDataU = outData + height * outWidthStride + (height / 2) * (outWidthStride / 2);
-    if (ppl::common::CpuSupports(ppl::common::ISA_X86_SSE41)) {
-        return BGR2I420SSE(inData, outDataY, outDataU, outDataV, width, height, inWidthStride, outWidthStride, outWidthStride / 2, outWidthStride / 2, true);
+    if (isa_supported(ppl::common::ISA_X86_SSE41)) {
+        return rgb_2_yuv420_parallel(RGBtoYUV420p_sse<true>, height, width, inWidthStride, inData, outWidthStride, outDataY, outWidthStride / 2, outDataU, outWidthStride / 2, outDataV);
     }
-    return RGBtoYUV420p<3, 2>(height, width, inWidthStride, inData, outWidthStride, outDataY, outWidthStride / 2, outDataU, outWidthStride / 2, outDataV);
+    return rgb_2_yuv420_parallel(RGBtoYUV420p<3, 2>, height, width, inWidthStride, inData, outWidthStride, outDataY, outWidthStride / 2, outDataU, outWidthStride / 2, outDataV);
 }
 
 template <>
@@ -867,7 +950,7 @@ template <>
     uint8_t *outDataY = outData;
     uint8_t *outDataU = outData + height * outWidthStride;
     uint8_t *outDataV = outData + height * outWidthStride + (height / 2) * (outWidthStride / 2);
-    return RGBtoYUV420p<4, 2>(height, width, inWidthStride, inData, outWidthStride, outDataY, outWidthStride / 2, outDataU, outWidthStride / 2, outDataV);
+    return rgb_2_yuv420_parallel(RGBtoYUV420p<4, 2>, height, width, inWidthStride, inData, outWidthStride, outDataY, outWidthStride / 2, outDataU, outWidthStride / 2, outDataV);
 }
 
 template <>
@@ -891,7 +974,7 @@ template <>
     uint8_t *outDataY = outData;
     uint8_t *outDataV = outData + height * outWidthStride;
     uint8_t *outDataU = outData + height * outWidthStride + (height / 2) * (outWidthStride / 2);
-    return RGBtoYUV420p<4, 2>(height, width, inWidthStride, inData, outWidthStride, outDataY, outWidthStride / 2, outDataU, outWidthStride / 2, outDataV);
+    return rgb_2_yuv420_parallel(RGBtoYUV420p<4, 2>, height, width, inWidthStride, inData, outWidthStride, outDataY, outWidthStride / 2, outDataU, outWidthStride / 2, outDataV);
 }
 
 // multiple plane implement
@@ -917,12 +1000,14 @@ template <>
     if (width == 0 || height == 0 || inYStride == 0 || inUStride == 0 || inVStride == 0 || outWidthStride == 0) {
         return ppl::common::RC_INVALID_VALUE;
     }
-    if (ppl::common::CpuSupports(ppl::common::ISA_X86_FMA)) {
-        return fma::i420_2_rgb<3, 0>(height, width, inYStride, inDataY, inUStride, inDataU, inVStride, inDataV, outWidthStride, outData);
-    } else if (ppl::common::CpuSupports(ppl::common::ISA_X86_AVX)) {
-        return YUV420ptoRGB_avx<3, 0>(height, width, inYStride, inDataY, inUStride, inDataU, inVStride, inDataV, outWidthStride, outData);
+    if (isa_supported(ppl::common::ISA_X86_AVX512)) {
+        return yuv420_2_rgb_parallel(avx512::i420_2_rgb<3, 0>, height, width, inYStride, inDataY, inUStride, inDataU, inVStride, inDataV, outWidthStride, outData);
+    } else if (isa_supported(ppl::common::ISA_X86_FMA)) {
+        return yuv420_2_rgb_parallel(fma::i420_2_rgb<3, 0>, height, width, inYStride, inDataY, inUStride, inDataU, inVStride, inDataV, outWidthStride, outData);
+    } else if (isa_supported(ppl::common::ISA_X86_AVX)) {
+        return yuv420_2_rgb_parallel(YUV420ptoRGB_avx<3, 0>, height, width, inYStride, inDataY, inUStride, inDataU, inVStride, inDataV, outWidthStride, outData);
     } else {
-        return YUV420ptoRGB<3, 0>(height, width, inYStride, inDataY, inUStride, inDataU, inVStride, inDataV, outWidthStride, outData);
+        return yuv420_2_rgb_parallel(YUV420ptoRGB<3, 0>, height, width, inYStride, inDataY, inUStride, inDataU, inVStride, inDataV, outWidthStride, outData);
     }
 }
 template <>
@@ -947,10 +1032,12 @@ template <>
     if (width == 0 || height == 0 || inYStride == 0 || inUStride == 0 || inVStride == 0 || outWidthStride == 0) {
         return ppl::common::RC_INVALID_VALUE;
     }
-    if (ppl::common::CpuSupports(ppl::common::ISA_X86_AVX)) {
-        return YUV420ptoRGB_avx<4, 0>(height, width, inYStride, inDataY, inUStride, inDataU, inVStride, inDataV, outWidthStride, outData);
+    if (isa_supported(ppl::common::ISA_X86_AVX512)) {
+        return yuv420_2_rgb_parallel(avx512::i420_2_rgb<4, 0>, height, width, inYStride, inDataY, inUStride, inDataU, inVStride, inDataV, outWidthStride, outData);
+    } else if (isa_supported(ppl::common::ISA_X86_AVX)) {
+        return yuv420_2_rgb_parallel(YUV420ptoRGB_avx<4, 0>, height, width, inYStride, inDataY, inUStride, inDataU, inVStride, inDataV, outWidthStride, outData);
     } else {
-        return YUV420ptoRGB<4, 0>(height, width, inYStride, inDataY, inUStride, inDataU, inVStride, inDataV, outWidthStride, outData);
+        return yuv420_2_rgb_parallel(YUV420ptoRGB<4, 0>, height, width, inYStride, inDataY, inUStride, inDataU, inVStride, inDataV, outWidthStride, outData);
     }
 }
 template <>
@@ -975,10 +1062,10 @@ template <>
     if (width == 0 || height == 0 || inWidthStride == 0 || outYStride == 0 || outUStride == 0 || outVStride == 0) {
         return ppl::common::RC_INVALID_VALUE;
     }
-    if (ppl::common::CpuSupports(ppl::common::ISA_X86_SSE41)) {
-        return BGR2I420SSE(inData, outDataY, outDataU, outDataV, width, height, inWidthStride, outYStride, outUStride, outVStride);
+    if (isa_supported(ppl::common::ISA_X86_SSE41)) {
+        return rgb_2_yuv420_parallel(RGBtoYUV420p_sse<false>, height, width, inWidthStride, inData, outYStride, outDataY, outUStride, outDataU, outVStride, outDataV);
     }
-    return RGBtoYUV420p<3, 0>(height, width, inWidthStride, inData, outYStride, outDataY, outUStride, outDataU, outVStride, outDataV);
+    return rgb_2_yuv420_parallel(RGBtoYUV420p<3, 0>, height, width, inWidthStride, inData, outYStride, outDataY, outUStride, outDataU, outVStride, outDataV);
 }
 
 template <>
@@ -1003,7 +1090,7 @@ template <>
     if (width == 0 || height == 0 || inWidthStride == 0 || outYStride == 0 || outUStride == 0 || outVStride == 0) {
         return ppl::common::RC_INVALID_VALUE;
     }
-    return RGBtoYUV420p<4, 0>(height, width, inWidthStride, inData, outYStride, outDataY, outUStride, outDataU, outVStride, outDataV);
+    return rgb_2_yuv420_parallel(RGBtoYUV420p<4, 0>, height, width, inWidthStride, inData, outYStride, outDataY, outUStride, outDataU, outVStride, outDataV);
 }
 
 template <>
@@ -1028,12 +1115,14 @@ template <>
     if (width == 0 || height == 0 || inYStride == 0 || inUStride == 0 || inVStride == 0 || outWidthStride == 0) {
         return ppl::common::RC_INVALID_VALUE;
     }
-    if (ppl::common::CpuSupports(ppl::common::ISA_X86_FMA)) {
-        return fma::i420_2_rgb<3, 2>(height, width, inYStride, inDataY, inUStride, inDataU, inVStride, inDataV, outWidthStride, outData);
-    } else if (ppl::common::CpuSupports(ppl::common::ISA_X86_AVX)) {
-        return YUV420ptoRGB_avx<3, 2>(height, width, inYStride, inDataY, inUStride, inDataU, inVStride, inDataV, outWidthStride, outData);
+    if (isa_supported(ppl::common::ISA_X86_AVX512)) {
+        return yuv420_2_rgb_parallel(avx512::i420_2_rgb<3, 2>, height, width, inYStride, inDataY, inUStride, inDataU, inVStride, inDataV, outWidthStride, outData);
+    } else if (isa_supported(ppl::common::ISA_X86_FMA)) {
+        return yuv420_2_rgb_parallel(fma::i420_2_rgb<3, 2>, height, width, inYStride, inDataY, inUStride, inDataU, inVStride, inDataV, outWidthStride, outData);
+    } else if (isa_supported(ppl::common::ISA_X86_AVX)) {
+        return yuv420_2_rgb_parallel(YUV420ptoRGB_avx<3, 2>, height, width, inYStride, inDataY, inUStride, inDataU, inVStride, inDataV, outWidthStride, outData);
     } else {
-        return YUV420ptoRGB<3, 2>(height, width, inYStride, inDataY, inUStride, inDataU, inVStride, inDataV, outWidthStride, outData);
+        return yuv420_2_rgb_parallel(YUV420ptoRGB<3, 2>, height, width, inYStride, inDataY, inUStride, inDataU, inVStride, inDataV, outWidthStride, outData);
     }
 }
 template <>
@@ -1058,10 +1147,12 @@ template <>
     if (width == 0 || height == 0 || inYStride == 0 || inUStride == 0 || inVStride == 0 || outWidthStride == 0) {
         return ppl::common::RC_INVALID_VALUE;
     }
-    if (ppl::common::CpuSupports(ppl::common::ISA_X86_AVX)) {
-        return YUV420ptoRGB_avx<4, 2>(height, width, inYStride, inDataY, inUStride, inDataU, inVStride, inDataV, outWidthStride, outData);
+    if (isa_supported(ppl::common::ISA_X86_AVX512)) {
+        return yuv420_2_rgb_parallel(avx512::i420_2_rgb<4, 2>, height, width, inYStride, inDataY, inUStride, inDataU, inVStride, inDataV, outWidthStride, outData);
+    } else if (isa_supported(ppl::common::ISA_X86_AVX)) {
+        return yuv420_2_rgb_parallel(YUV420ptoRGB_avx<4, 2>, height, width, inYStride, inDataY, inUStride, inDataU, inVStride, inDataV, outWidthStride, outData);
     } else {
-        return YUV420ptoRGB<4, 2>(height, width, inYStride, inDataY, inUStride, inDataU, inVStride, inDataV, outWidthStride, outData);
+        return yuv420_2_rgb_parallel(YUV420ptoRGB<4, 2>, height, width, inYStride, inDataY, inUStride, inDataU, inVStride, inDataV, outWidthStride, outData);
     }
 }
 template <>
@@ -1086,10 +1177,10 @@ template <>
     if (width == 0 || height == 0 || inWidthStride == 0 || outYStride == 0 || outUStride == 0 || outVStride == 0) {
         return ppl::common::RC_INVALID_VALUE;
     }
-    if (ppl::common::CpuSupports(ppl::common::ISA_X86_SSE41)) {
-        return BGR2I420SSE(inData, outDataY, outDataU, outDataV, width, height, inWidthStride, outYStride, outUStride, outVStride, true);
+    if (isa_supported(ppl::common::ISA_X86_SSE41)) {
+        return rgb_2_yuv420_parallel(RGBtoYUV420p_sse<true>, height, width, inWidthStride, inData, outYStride, outDataY, outUStride, outDataU, outVStride, outDataV);
     }
-    return RGBtoYUV420p<3, 2>(height, width, inWidthStride, inData, outYStride, outDataY, outUStride, outDataU, outVStride, outDataV);
+    return rgb_2_yuv420_parallel(RGBtoYUV420p<3, 2>, height, width, inWidthStride, inData, outYStride, outDataY, outUStride, outDataU, outVStride, outDataV);
 }
 
 template <>
@@ -1114,7 +1205,7 @@ template <>
     if (width == 0 || height == 0 || inWidthStride == 0 || outYStride == 0 || outUStride == 0 || outVStride == 0) {
         return ppl::common::RC_INVALID_VALUE;
     }
-    return RGBtoYUV420p<4, 2>(height, width, inWidthStride, inData, outYStride, outDataY, outUStride, outDataU, outVStride, outDataV);
+    return rgb_2_yuv420_parallel(RGBtoYUV420p<4, 2>, height, width, inWidthStride, inData, outYStride, outDataY, outUStride, outDataU, outVStride, outDataV);
 }
 
 }
@@ -22,6 +22,8 @@
 #include "ppl/cv/types.h"
 #include "ppl/common/sys.h"
 #include "ppl/common/x86/sysinfo.h"
+#include "ppl/cv/x86/isa.hpp"
+#include "ppl/cv/x86/parallel.hpp"
 
 #include <string.h>
 #include <limits.h>
@@ -30,6 +32,7 @@
 
 #include <algorithm>
 #include <vector>
+#include <type_traits>
 
 namespace ppl {
 namespace cv {
@@ -266,6 +269,225 @@ static void bilateralFilter_b(
     }
 }
 
+// Bilateral grid (Chen, Paris and Durand 2007). Pixels are summed into a
+// coarse (y, x, range) grid whose cells are about sigma_space pixels wide and
+// sigma_color levels deep, the grid is blurred by [1 4 6 4 1] / 16 along each
+// axis, one cell of standard deviation, and every pixel reads its value back
+// by trilinear interpolation. Pixels outside the image weigh nothing. The
+// range of 3 channel pixels is b + g + r, on the scale of the L1 colour
+// distance of the exact filter.
+#define BILATERAL_GRID_PAD 2
+// Range levels the grid is capped at; wider ranges get deeper cells.
+#define BILATERAL_GRID_MAX_LEVELS 1024
+// Bytes the grid may take; a larger one is refused before allocating it.
+#define BILATERAL_GRID_MAX_BYTES ((int64_t)1 << 30)
+
+// Blurs `count` rows of `len` floats, `step` floats apart, across the rows,
+// rows outside being zero. `ring` holds 3 * len floats.
+static void bilateral_grid_blur(float* data, int32_t count, int64_t step, int32_t len, float* ring)
+{
+    float* prev2       = ring; // rows i - 2 and i - 1 before they were blurred
+    float* prev1       = ring + len;
+    const float* zeros = ring + 2 * len;
+    memset(ring, 0, 3 * len * sizeof(float));
+    for (int32_t i = 0; i < count; ++i) {
+        float* row         = data + i * step;
+        const float* next1 = i + 1 < count ? row + step : zeros;
+        const float* next2 = i + 2 < count ? row + 2 * step : zeros;
+        for (int32_t k = 0; k < len; ++k) {
+            float v  = row[k];
+            row[k]   = (prev2[k] + next2[k] + 4.f * (prev1[k] + next1[k]) + 6.f * v) * (1.f / 16);
+            prev2[k] = prev1[k];
+            prev1[k] = v;
+        }
+    }
+}
+
+template <typename T, int32_t cn>
+static inline float bilateral_grid_range(const T* p)
+{
+    return cn == 1 ? (float)p[0] : (float)p[0] + (float)p[1] + (float)p[2];
+}
+
+static inline void bilateral_grid_store(const float* v, float* dst, int32_t cn)
+{
+    for (int32_t c = 0; c < cn; ++c) {
+        dst[c] = v[c];
+    }
+}
+
+static inline void bilateral_grid_store(const float* v, uint8_t* dst, int32_t cn)
+{
+    for (int32_t c = 0; c < cn; ++c) {
+        dst[c] = sat_cast_u8(_mm_cvtss_si32(_mm_set_ss(v[c])));
+    }
+}
+
+template <typename T, int32_t cn>
+static ::ppl::common::RetCode bilateral_grid(
+    int32_t height,
+    int32_t width,
+    int32_t inWidthStride,
+    const T* src,
+    int32_t outWidthStride,
+    T* dst,
+    float sigma_color,
+    float sigma_space)
+{
+    const int32_t cell = cn == 1 ? 2 : 4; // channel sums, then the weight
+    const int32_t pad  = BILATERAL_GRID_PAD;
+    // summing into the nearest cell and interpolating back widen the blur
+    // from 1 to sqrt(1 + 1 / 12 + 1 / 6) cells, so cells are that much
+    // smaller than the sigmas
+    float space = std::max(sigma_space > 0.f ? sigma_space * 0.8944f : 1.f, 1.f);
+    float color = sigma_color > 0.f ? sigma_color * 0.8944f : 1.f;
+
+    float range_min = 0.f, range_max = 255.f * cn;
+    if (!std::is_same<T, uint8_t>::value) {
+        range_min = range_max = bilateral_grid_range<T, cn>(src);
+        for (int32_t i = 0; i < height; ++i) {
+            const T* s = src + (int64_t)i * inWidthStride;
+            for (int32_t j = 0; j < width; ++j) {
+                float r   = bilateral_grid_range<T, cn>(s + j * cn);
+                if (!std::isfinite(r)) {
+                    // the caller filters images with inf or nan exactly
+                    return ppl::common::RC_UNSUPPORTED;
+                }
+                range_min = std::min(range_min, r);
+                range_max = std::max(range_max, r);
+            }
+        }
+    }
+    // a float outlier or a tiny sigma_color would ask for an unbounded grid,
+    // so the cells deepen to keep it within BILATERAL_GRID_MAX_LEVELS
+    double range = (double)range_max - range_min;
+    if (range > (double)color * BILATERAL_GRID_MAX_LEVELS) {
+        color = (float)(range / BILATERAL_GRID_MAX_LEVELS);
+    }
+    const float inv_space = 1.f / space;
+    const float inv_color = 1.f / color;
+    const int32_t gh      = (int32_t)((height - 1) * inv_space + 0.5f) + 1 + 2 * pad;
+    const int32_t gw      = (int32_t)((width - 1) * inv_space + 0.5f) + 1 + 2 * pad;
+    const int32_t gd      = (int32_t)(range / color + 0.5) + 1 + 2 * pad;
+    const int64_t plane   = (int64_t)gw * gd * cell;
+    if ((double)gh * plane * sizeof(float) > (double)BILATERAL_GRID_MAX_BYTES) {
+        return ppl::common::RC_OUT_OF_MEMORY;
+    }
+    float* grid           = (float*)ppl::common::AlignedAlloc(gh * plane * sizeof(float), 64);
+    if (nullptr == grid) {
+        return ppl::common::RC_OUT_OF_MEMORY;
+    }
+    memset(grid, 0, gh * plane * sizeof(float));
+
+    // nearest cell of every row and column, and the cells a pixel is read from
+    std::vector<int32_t> row_cell(height), col_cell(width), col_x0(width);
+    std::vector<float> col_wx(width);
+    for (int32_t i = 0; i < height; ++i) {
+        row_cell[i] = (int32_t)(i * inv_space + 0.5f) + pad;
+    }
+    for (int32_t j = 0; j < width; ++j) {
+        float x     = j * inv_space + pad;
+        col_cell[j] = (int32_t)(x + 0.5f);
+        col_x0[j]   = (int32_t)x;
+        col_wx[j]   = x - col_x0[j];
+    }
+
+    // a band of grid rows sums the image rows nearest to them
+    parallel_for_rows(gh, (int64_t)width * cn * height / gh, [&](int32_t begin, int32_t end) {
+        int32_t i     = (int32_t)(std::lower_bound(row_cell.begin(), row_cell.end(), begin) - row_cell.begin());
+        int32_t i_end = (int32_t)(std::lower_bound(row_cell.begin(), row_cell.end(), end) - row_cell.begin());
+        for (; i < i_end; ++i) {
+            const T* s  = src + (int64_t)i * inWidthStride;
+            float* grow = grid + row_cell[i] * plane;
+            for (int32_t j = 0; j < width; ++j, s += cn) {
+                int32_t z = (int32_t)((bilateral_grid_range<T, cn>(s) - range_min) * inv_color + 0.5f) + pad;
+                float* g  = grow + ((int64_t)col_cell[j] * gd + z) * cell;
+                if (cn == 1) {
+                    g[0] += s[0];
+                    g[1] += 1.f;
+                } else {
+                    __m128 m_v = _mm_setr_ps(s[0], s[1], s[2], 1.f);
+                    _mm_storeu_ps(g, _mm_add_ps(_mm_loadu_ps(g), m_v));
+                }
+            }
+        }
+    });
+
+    // blur along range and x within each grid row, then along y in bands of
+    // grid columns
+    const int64_t row_len = (int64_t)gd * cell;
+    parallel_for_rows(gh, plane * 5, [&](int32_t begin, int32_t end) {
+        std::vector<float> ring(3 * row_len);
+        for (int32_t y = begin; y < end; ++y) {
+            float* g = grid + y * plane;
+            for (int32_t x = 0; x < gw; ++x) {
+                bilateral_grid_blur(g + x * row_len, gd, cell, cell, ring.data());
+            }
+            bilateral_grid_blur(g, gw, row_len, (int32_t)row_len, ring.data());
+        }
+    });
+    parallel_for_rows(gw, (int64_t)gh * row_len * 5, [&](int32_t begin, int32_t end) {
+        std::vector<float> ring(3 * (end - begin) * row_len);
+        bilateral_grid_blur(grid + begin * row_len, gh, plane, (int32_t)((end - begin) * row_len), ring.data());
+    });
+
+    // every pixel interpolates the 8 cells around its position
+    parallel_for_rows(height, (int64_t)width * cn * 8, [&](int32_t begin, int32_t end) {
+        for (int32_t i = begin; i < end; ++i) {
+            float y         = i * inv_space + pad;
+            int32_t y0      = (int32_t)y;
+            float wy        = y - y0;
+            const float* g0 = grid + y0 * plane;
+            const T* s      = src + (int64_t)i * inWidthStride;
+            T* d            = dst + (int64_t)i * outWidthStride;
+            for (int32_t j = 0; j < width; ++j, s += cn, d += cn) {
+                float z          = (bilateral_grid_range<T, cn>(s) - range_min) * inv_color + pad;
+                int32_t z0       = (int32_t)z;
+                float wz         = z - z0;
+                float wx         = col_wx[j];
+                const float* c00 = g0 + (col_x0[j] * row_len + z0 * cell);
+                const float* c01 = c00 + row_len;
+                const float* c10 = c00 + plane;
+                const float* c11 = c10 + row_len;
+                float v[4];
+                if (cn == 1) {
+                    float a[2];
+                    for (int32_t c = 0; c < 2; ++c) {
+                        float a0 = c00[c] + wz * (c00[c + 2] - c00[c]);
+                        float a1 = c01[c] + wz * (c01[c + 2] - c01[c]);
+                        float b0 = c10[c] + wz * (c10[c + 2] - c10[c]);
+                        float b1 = c11[c] + wz * (c11[c + 2] - c11[c]);
+                        a0 += wx * (a1 - a0);
+                        b0 += wx * (b1 - b0);
+                        a[c] = a0 + wy * (b0 - a0);
+                    }
+                    v[0] = a[0] / a[1];
+                } else {
+                    __m128 m_wz = _mm_set1_ps(wz);
+                    __m128 m_wx = _mm_set1_ps(wx);
+                    __m128 m_a0 = _mm_loadu_ps(c00);
+                    __m128 m_a1 = _mm_loadu_ps(c01);
+                    __m128 m_b0 = _mm_loadu_ps(c10);
+                    __m128 m_b1 = _mm_loadu_ps(c11);
+                    m_a0        = _mm_add_ps(m_a0, _mm_mul_ps(m_wz, _mm_sub_ps(_mm_loadu_ps(c00 + 4), m_a0)));
+                    m_a1        = _mm_add_ps(m_a1, _mm_mul_ps(m_wz, _mm_sub_ps(_mm_loadu_ps(c01 + 4), m_a1)));
+                    m_b0        = _mm_add_ps(m_b0, _mm_mul_ps(m_wz, _mm_sub_ps(_mm_loadu_ps(c10 + 4), m_b0)));
+                    m_b1        = _mm_add_ps(m_b1, _mm_mul_ps(m_wz, _mm_sub_ps(_mm_loadu_ps(c11 + 4), m_b1)));
+                    m_a0        = _mm_add_ps(m_a0, _mm_mul_ps(m_wx, _mm_sub_ps(m_a1, m_a0)));
+                    m_b0        = _mm_add_ps(m_b0, _mm_mul_ps(m_wx, _mm_sub_ps(m_b1, m_b0)));
+                    __m128 m_v  = _mm_add_ps(m_a0, _mm_mul_ps(_mm_set1_ps(wy), _mm_sub_ps(m_b0, m_a0)));
+                    m_v         = _mm_div_ps(m_v, _mm_shuffle_ps(m_v, m_v, _MM_SHUFFLE(3, 3, 3, 3)));
+                    _mm_storeu_ps(v, m_v);
+                }
+                bilateral_grid_store(v, d, cn);
+            }
+        }
+    });
+
+    ppl::common::AlignedFree(grid);
+    return ppl::common::RC_SUCCESS;
+}
+
 template <>
 ::ppl::common::RetCode BilateralFilter<uint8_t, 1>(
     int32_t height,
@@ -277,7 +499,8 @@ template <>
     float space,
     int32_t outWidthStride,
     uint8_t* outData,
-    BorderType border_type)
+    BorderType border_type,
+    BilateralFilterType type)
 {
     if (nullptr == inData || nullptr == outData) {
         return ppl::common::RC_INVALID_VALUE;
@@ -288,6 +511,12 @@ template <>
     if (border_type != ppl::cv::BORDER_REFLECT_101) {
         return ppl::common::RC_INVALID_VALUE;
     }
+    if (type == ppl::cv::BILATERAL_GRID) {
+        return bilateral_grid<uint8_t, 1>(height, width, inWidthStride, inData, outWidthStride, outData, color, space);
+    }
+    if (type != ppl::cv::BILATERAL_EXACT) {
+        return ppl::common::RC_INVALID_VALUE;
+    }
     bilateralFilter_b<1>(height, width, inWidthStride, inData, outWidthStride, outData, diameter, color, space);
     return ppl::common::RC_SUCCESS;
 }
@@ -303,7 +532,8 @@ template <>
     float space,
     int32_t outWidthStride,
     uint8_t* outData,
-    BorderType border_type)
+    BorderType border_type,
+    BilateralFilterType type)
 {
     if (nullptr == inData || nullptr == outData) {
         return ppl::common::RC_INVALID_VALUE;
@@ -314,6 +544,12 @@ template <>
     if (border_type != ppl::cv::BORDER_REFLECT_101) {
         return ppl::common::RC_INVALID_VALUE;
     }
+    if (type == ppl::cv::BILATERAL_GRID) {
+        return bilateral_grid<uint8_t, 3>(height, width, inWidthStride, inData, outWidthStride, outData, color, space);
+    }
+    if (type != ppl::cv::BILATERAL_EXACT) {
+        return ppl::common::RC_INVALID_VALUE;
+    }
     bilateralFilter_b<3>(height, width, inWidthStride, inData, outWidthStride, outData, diameter, color, space);
     return ppl::common::RC_SUCCESS;
 }
@@ -329,7 +565,8 @@ template <>
     float space,
     int32_t outWidthStride,
     float* outData,
-    BorderType border_type)
+    BorderType border_type,
+    BilateralFilterType type)
 {
     if (nullptr == inData || nullptr == outData) {
         return ppl::common::RC_INVALID_VALUE;
@@ -340,7 +577,15 @@ template <>
     if (border_type != ppl::cv::BORDER_REFLECT_101) {
         return ppl::common::RC_INVALID_VALUE;
     }
-    if (ppl::common::CpuSupports(ppl::common::ISA_X86_AVX)) {
+    if (type == ppl::cv::BILATERAL_GRID) {
+        ppl::common::RetCode ret = bilateral_grid<float, 1>(height, width, inWidthStride, inData, outWidthStride, outData, color, space);
+        if (ret != ppl::common::RC_UNSUPPORTED) {
+            return ret;
+        }
+    } else if (type != ppl::cv::BILATERAL_EXACT) {
+        return ppl::common::RC_INVALID_VALUE;
+    }
+    if (isa_supported(ppl::common::ISA_X86_AVX)) {
         bilateralFilter_32f_avx<1>(height, width, inWidthStride, inData, outWidthStride, outData, diameter, color, space);
     } else {
         bilateralFilter_32f<1>(height, width, inWidthStride, inData, outWidthStride, outData, diameter, color, space);
@@ -359,7 +604,8 @@ template <>
     float space,
     int32_t outWidthStride,
     float* outData,
-    BorderType border_type)
+    BorderType border_type,
+    BilateralFilterType type)
 {
     if (nullptr == inData || nullptr == outData) {
         return ppl::common::RC_INVALID_VALUE;
@@ -370,7 +616,15 @@ template <>
     if (border_type != ppl::cv::BORDER_REFLECT_101) {
         return ppl::common::RC_INVALID_VALUE;
     }
-    if (ppl::common::CpuSupports(ppl::common::ISA_X86_AVX)) {
+    if (type == ppl::cv::BILATERAL_GRID) {
+        ppl::common::RetCode ret = bilateral_grid<float, 3>(height, width, inWidthStride, inData, outWidthStride, outData, color, space);
+        if (ret != ppl::common::RC_UNSUPPORTED) {
+            return ret;
+        }
+    } else if (type != ppl::cv::BILATERAL_EXACT) {
+        return ppl::common::RC_INVALID_VALUE;
+    }
+    if (isa_supported(ppl::common::ISA_X86_AVX)) {
         bilateralFilter_32f_avx<3>(height, width, inWidthStride, inData, outWidthStride, outData, diameter, color, space);
     } else {
         bilateralFilter_32f<3>(height, width, inWidthStride, inData, outWidthStride, outData, diameter, color, space);
@@ -17,6 +17,8 @@
 
 #include <benchmark/benchmark.h>
 #include <memory>
+#include <algorithm>
+#include <cmath>
 #include "ppl/cv/x86/bilateralfilter.h"
 #include "ppl/cv/debug.h"
 #include <opencv2/imgproc.hpp>
@@ -43,10 +45,82 @@ void BM_Bilateral_ppl_x86(benchmark::State &state) {
     state.SetItemsProcessed(state.iterations() * 1);
 }
 
+// Smooth shading with a disc and a bright block plus noise, on which the exact
+// filter and the grid can be compared.
+template<typename T, int32_t channels>
+void fillScene(T *data, int32_t height, int32_t width) {
+    std::unique_ptr<T[]> noise(new T[width * height * channels]);
+    ppl::cv::debug::randomFill<T>(noise.get(), width * height * channels, 0, 40);
+    for (int32_t i = 0; i < height; ++i) {
+        for (int32_t j = 0; j < width; ++j) {
+            for (int32_t c = 0; c < channels; ++c) {
+                float v = 60.f + 0.1f * j + 20.f * std::sin(i * 0.02f + c);
+                if ((i - height / 2) * (i - height / 2) + (j - width / 3) * (j - width / 3) < height * height / 16) {
+                    v += 90.f - 30.f * c;
+                }
+                if (j > 2 * width / 3 && i < height / 2) {
+                    v = 200.f - 40.f * c;
+                }
+                v += (float)noise[(i * width + j) * channels + c] - 20.f;
+                data[(i * width + j) * channels + c] = (T)std::min(255.f, std::max(0.f, v));
+            }
+        }
+    }
+}
+
+// The exact filter over a diameter of 4 * space + 1 against BILATERAL_GRID,
+// whose PSNR to the exact result is reported in the "psnr" counter.
+template<typename T, int32_t channels, int32_t color, int32_t space, ppl::cv::BilateralFilterType type>
+void BM_BilateralSigma_ppl_x86(benchmark::State &state) {
+    int32_t width = state.range(0);
+    int32_t height = state.range(1);
+    int32_t diameter = 4 * space + 1;
+    std::unique_ptr<T[]> src(new T[width * height * channels]);
+    std::unique_ptr<T[]> dst(new T[width * height * channels]);
+    fillScene<T, channels>(src.get(), height, width);
+    for (auto _ : state) {
+        ppl::cv::x86::BilateralFilter<T, channels>(height, width, width * channels,
+                                src.get(),
+                                diameter,
+                                color,
+                                space,
+                                width * channels,
+                                dst.get(),
+                                ppl::cv::BORDER_DEFAULT,
+                                type);
+    }
+    state.SetItemsProcessed(state.iterations() * 1);
+
+    if (type == ppl::cv::BILATERAL_GRID) {
+        std::unique_ptr<T[]> exact(new T[width * height * channels]);
+        ppl::cv::x86::BilateralFilter<T, channels>(height, width, width * channels, src.get(), diameter, color, space,
+                                                   width * channels, exact.get(), ppl::cv::BORDER_DEFAULT);
+        double mse = 0;
+        for (int32_t i = 0; i < width * height * channels; ++i) {
+            double diff = (double)exact[i] - (double)dst[i];
+            mse += diff * diff;
+        }
+        state.counters["psnr"] = 10 * std::log10(255.0 * 255.0 * width * height * channels / mse);
+    }
+}
+
 using namespace ppl::cv::debug;
 
 BENCHMARK_TEMPLATE(BM_Bilateral_ppl_x86, float, c3, 9, 75, 75)->Args({320, 240})->Args({640, 480})->Args({1280, 720})->Args({1920, 1080})->Args({3840, 2160});
 BENCHMARK_TEMPLATE(BM_Bilateral_ppl_x86, uint8_t, c3, 9, 75, 75)->Args({320, 240})->Args({640, 480})->Args({1280, 720})->Args({1920, 1080})->Args({3840, 2160});
+BENCHMARK_TEMPLATE(BM_BilateralSigma_ppl_x86, uint8_t, c1, 30, 4, ppl::cv::BILATERAL_EXACT)->Args({640, 480})->Args({1280, 720});
+BENCHMARK_TEMPLATE(BM_BilateralSigma_ppl_x86, uint8_t, c1, 30, 4, ppl::cv::BILATERAL_GRID)->Args({640, 480})->Args({1280, 720});
+BENCHMARK_TEMPLATE(BM_BilateralSigma_ppl_x86, uint8_t, c1, 30, 16, ppl::cv::BILATERAL_EXACT)->Args({640, 480})->Args({1280, 720});
+BENCHMARK_TEMPLATE(BM_BilateralSigma_ppl_x86, uint8_t, c1, 30, 16, ppl::cv::BILATERAL_GRID)->Args({640, 480})->Args({1280, 720});
+BENCHMARK_TEMPLATE(BM_BilateralSigma_ppl_x86, uint8_t, c3, 15, 8, ppl::cv::BILATERAL_GRID)->Args({640, 480})->Args({1280, 720});
+BENCHMARK_TEMPLATE(BM_BilateralSigma_ppl_x86, uint8_t, c3, 30, 4, ppl::cv::BILATERAL_EXACT)->Args({640, 480})->Args({1280, 720});
+BENCHMARK_TEMPLATE(BM_BilateralSigma_ppl_x86, uint8_t, c3, 30, 4, ppl::cv::BILATERAL_GRID)->Args({640, 480})->Args({1280, 720});
+BENCHMARK_TEMPLATE(BM_BilateralSigma_ppl_x86, uint8_t, c3, 30, 16, ppl::cv::BILATERAL_EXACT)->Args({640, 480})->Args({1280, 720});
+BENCHMARK_TEMPLATE(BM_BilateralSigma_ppl_x86, uint8_t, c3, 30, 16, ppl::cv::BILATERAL_GRID)->Args({640, 480})->Args({1280, 720});
+BENCHMARK_TEMPLATE(BM_BilateralSigma_ppl_x86, uint8_t, c3, 60, 8, ppl::cv::BILATERAL_GRID)->Args({640, 480})->Args({1280, 720});
+BENCHMARK_TEMPLATE(BM_BilateralSigma_ppl_x86, float, c1, 30, 16, ppl::cv::BILATERAL_GRID)->Args({640, 480})->Args({1280, 720});
+BENCHMARK_TEMPLATE(BM_BilateralSigma_ppl_x86, float, c3, 30, 16, ppl::cv::BILATERAL_EXACT)->Args({640, 480})->Args({1280, 720});
+BENCHMARK_TEMPLATE(BM_BilateralSigma_ppl_x86, float, c3, 30, 16, ppl::cv::BILATERAL_GRID)->Args({640, 480})->Args({1280, 720});
 
 #ifdef PPLCV_BENCHMARK_OPENCV
 template<typename T, int32_t channels, int32_t diameter, int32_t color, int32_t space>
@@ -19,6 +19,9 @@
 #include "ppl/cv/x86/test.h"
 #include <opencv2/imgproc.hpp>
 #include <memory>
+#include <algorithm>
+#include <limits>
+#include <cmath>
 #include <gtest/gtest.h>
 #include "ppl/cv/debug.h"
 
@@ -59,3 +62,107 @@ TEST(BilateralFilter_U8, x86)
     BilateralFilterTest<uint8_t, 1, 9, 75, 75>(720, 1080, 2.0f);
     BilateralFilterTest<uint8_t, 3, 9, 75, 75>(720, 1080, 2.0f);
 }
+
+// Smooth shading, a disc and a bright block, plus noise: the filter should
+// smooth the noise and keep the edges.
+template<typename T, int32_t nc>
+void fillScene(T *data, int32_t height, int32_t width) {
+    std::unique_ptr<T[]> noise(new T[width * height * nc]);
+    ppl::cv::debug::randomFill<T>(noise.get(), width * height * nc, 0, 40);
+    for (int32_t i = 0; i < height; ++i) {
+        for (int32_t j = 0; j < width; ++j) {
+            for (int32_t c = 0; c < nc; ++c) {
+                float v = 60.f + 0.1f * j + 20.f * std::sin(i * 0.02f + c);
+                if ((i - height / 2) * (i - height / 2) + (j - width / 3) * (j - width / 3) < height * height / 16) {
+                    v += 90.f - 30.f * c;
+                }
+                if (j > 2 * width / 3 && i < height / 2) {
+                    v = 200.f - 40.f * c;
+                }
+                v += (float)noise[(i * width + j) * nc + c] - 20.f;
+                data[(i * width + j) * nc + c] = (T)std::min(255.f, std::max(0.f, v));
+            }
+        }
+    }
+}
+
+// BILATERAL_GRID is compared with the exact filter by PSNR, leaving out the
+// border, which the grid does not reflect.
+template<typename T, int32_t nc, int32_t color, int32_t space>
+void BilateralGridTest(int32_t height, int32_t width, double min_psnr) {
+    int32_t diameter = 6 * space + 1;
+    std::unique_ptr<T[]> src(new T[width * height * nc]);
+    std::unique_ptr<T[]> dst_ref(new T[width * height * nc]);
+    std::unique_ptr<T[]> dst(new T[width * height * nc]);
+    fillScene<T, nc>(src.get(), height, width);
+    cv::Mat src_opencv(height, width, CV_MAKETYPE(cv::DataType<T>::depth, nc), src.get(), sizeof(T) * width * nc);
+    cv::Mat dst_opencv(height, width, CV_MAKETYPE(cv::DataType<T>::depth, nc), dst_ref.get(), sizeof(T) * width * nc);
+
+    cv::bilateralFilter(src_opencv, dst_opencv, diameter, color, space);
+    ppl::cv::x86::BilateralFilter<T, nc>(height, width, width * nc,
+                            src.get(),
+                            diameter,
+                            color,
+                            space,
+                            width * nc,
+                            dst.get(),
+                            ppl::cv::BORDER_DEFAULT,
+                            ppl::cv::BILATERAL_GRID);
+
+    double mse = 0;
+    int64_t count = 0;
+    for (int32_t i = diameter / 2; i < height - diameter / 2; ++i) {
+        for (int32_t j = diameter / 2 * nc; j < (width - diameter / 2) * nc; ++j) {
+            double diff = (double)dst_ref[i * width * nc + j] - (double)dst[i * width * nc + j];
+            mse += diff * diff;
+            ++count;
+        }
+    }
+    EXPECT_GT(10 * std::log10(255.0 * 255.0 * count / mse), min_psnr);
+}
+
+TEST(BilateralFilter_Grid_FP32, x86)
+{
+    BilateralGridTest<float, 1, 30, 8>(240, 320, 45.0);
+    BilateralGridTest<float, 3, 30, 8>(240, 320, 35.0);
+}
+
+TEST(BilateralFilter_Grid_U8, x86)
+{
+    BilateralGridTest<uint8_t, 1, 30, 8>(240, 320, 45.0);
+    BilateralGridTest<uint8_t, 3, 30, 8>(240, 320, 35.0);
+}
+
+// An outlier must neither overflow the grid depth nor make it unbounded, and
+// inf falls back to the exact filter.
+TEST(BilateralFilter_Grid_Outlier, x86)
+{
+    const int32_t height = 64, width = 64;
+    std::unique_ptr<float[]> src(new float[width * height]);
+    std::unique_ptr<float[]> dst(new float[width * height]);
+    fillScene<float, 1>(src.get(), height, width);
+    src[width * 10 + 10] = 1e30f;
+    EXPECT_EQ(ppl::common::RC_SUCCESS,
+              ppl::cv::x86::BilateralFilter<float, 1>(height, width, width, src.get(), 25, 0.5f, 4.0f,
+                                                       width, dst.get(), ppl::cv::BORDER_DEFAULT,
+                                                       ppl::cv::BILATERAL_GRID));
+    EXPECT_TRUE(std::isfinite(dst[width * 40 + 40]));
+    src[width * 10 + 10] = std::numeric_limits<float>::infinity();
+    EXPECT_EQ(ppl::common::RC_SUCCESS,
+              ppl::cv::x86::BilateralFilter<float, 1>(height, width, width, src.get(), 25, 0.5f, 4.0f,
+                                                       width, dst.get(), ppl::cv::BORDER_DEFAULT,
+                                                       ppl::cv::BILATERAL_GRID));
+}
+
+// A grid over the size limit is refused before it is allocated.
+TEST(BilateralFilter_Grid_Limit, x86)
+{
+    const int32_t height = 2160, width = 3840;
+    std::unique_ptr<uint8_t[]> src(new uint8_t[width * height]);
+    std::unique_ptr<uint8_t[]> dst(new uint8_t[width * height]);
+    fillScene<uint8_t, 1>(src.get(), height, width);
+    EXPECT_EQ(ppl::common::RC_OUT_OF_MEMORY,
+              ppl::cv::x86::BilateralFilter<uint8_t, 1>(height, width, width, src.get(), 7, 1.0f, 1.0f,
+                                                         width, dst.get(), ppl::cv::BORDER_DEFAULT,
+                                                         ppl::cv::BILATERAL_GRID));
+}
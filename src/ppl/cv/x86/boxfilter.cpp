@@ -17,7 +17,7 @@
 
 #include "ppl/cv/x86/boxfilter.h"
 #include "ppl/cv/x86/avx/internal_avx.hpp"
-#include "ppl/cv/x86/copymakeborder.h"
+#include "ppl/cv/x86/filter_engine.hpp"
 #include "ppl/cv/types.h"
 #include "ppl/common/sys.h"
 #include "ppl/cv/x86/util.hpp"
@@ -40,7 +40,7 @@ struct RowSum {
         ksize = _ksize;
     }
 
-    void operator()(const T* src, ST* dst, int32_t width, int32_t cn)
+    void operator()(const T* src, ST* dst, int32_t width, int32_t cn) const
     {
         const T* S = (const T*)src;
         ST* D      = (ST*)dst;
@@ -278,7 +278,6 @@ struct ColumnSum<float, float> {
         ksize    = _ksize;
         scale    = _scale;
         sumCount = 0;
-        core     = 1;
     }
 
     void reset()
@@ -289,15 +288,23 @@ struct ColumnSum<float, float> {
     void operator()(const float** src, float* dst, int32_t dststep, int32_t count, int32_t width)
     {
         int32_t i;
+        float* SUM;
+        float _scale = scale;
 
-        float* SUM     = (float*)_mm_malloc(width * sizeof(float), 64);
-        bool haveScale = scale != 1;
+        if (width != (int32_t)sum.size()) {
+            sum.resize(width);
+            sumCount = 0;
+        }
+
+        SUM = &sum[0];
         if (sumCount == 0) {
             memset((void*)SUM, 0, width * sizeof(float));
-
             for (; sumCount < ksize - 1; sumCount++, src++) {
-                const float* Sp = (const float*)src[0];
+                const float* Sp = src[0];
                 i               = 0;
+                for (; i <= width - 4; i += 4) {
+                    _mm_storeu_ps(SUM + i, _mm_add_ps(_mm_loadu_ps(SUM + i), _mm_loadu_ps(Sp + i)));
+                }
                 for (; i < width; i++)
                     SUM[i] += Sp[i];
             }
@@ -305,36 +312,37 @@ struct ColumnSum<float, float> {
             src += ksize - 1;
         }
 
+        const __m128 scale4 = _mm_set1_ps(scale);
         for (; count--; src++) {
-            const float* Sp = (const float*)src[0];
-            const float* Sm = (const float*)src[1 - ksize];
-            float* D        = (float*)dst;
-            if (haveScale) {
-                i = 0;
-                for (; i < width; i++) {
-                    float s0 = SUM[i] + Sp[i];
-                    D[i]     = s0 * scale;
-                    SUM[i]   = s0 - Sm[i];
-                }
-            } else {
-                i = 0;
-                for (; i < width; i++) {
-                    float s0 = SUM[i] + Sp[i];
-                    D[i]     = s0;
-                    SUM[i]   = s0 - Sm[i];
-                }
+            const float* Sp = src[0];
+            const float* Sm = src[1 - ksize];
+            float* D        = dst;
+            i               = 0;
+            for (; i <= width - 4; i += 4) {
+                __m128 s0 = _mm_add_ps(_mm_loadu_ps(SUM + i), _mm_loadu_ps(Sp + i));
+                _mm_storeu_ps(D + i, _mm_mul_ps(s0, scale4));
+                _mm_storeu_ps(SUM + i, _mm_sub_ps(s0, _mm_loadu_ps(Sm + i)));
+            }
+            for (; i < width; i++) {
+                float s0 = SUM[i] + Sp[i];
+                D[i]     = s0 * _scale;
+                SUM[i]   = s0 - Sm[i];
             }
             dst += dststep;
         }
-        _mm_free(SUM);
     }
     int32_t ksize;
     float scale;
     int32_t sumCount;
-    int32_t core;
-    bool bSupportAVX;
+    std::vector<float> sum;
 };
 
+// Float running column sums round differently depending on the row they
+// start from, so they restart every BOX_FILTER_SUM_ROWS rows, counted from the
+// top of the image, and bands begin at multiples of it. The output does not
+// depend on the number of threads then.
+#define BOX_FILTER_SUM_ROWS 64
+
 template <int32_t cn>
 void x86boxFilter_f(
     int32_t height,
@@ -349,35 +357,15 @@ void x86boxFilter_f(
     BorderType borderType,
     float border_value = 0)
 {
-    int32_t radius_x = kernelx_len / 2;
-    int32_t radius_y = kernely_len / 2;
-
-    int32_t bsrcHeight = height + 2 * radius_y;
-    int32_t bsrcWidth  = width + 2 * radius_x;
-
-    int32_t bsrcWidthStep = (bsrcWidth)*cn;
-    float* bsrc_t         = (float*)malloc((bsrcHeight + 1) * bsrcWidth * cn * sizeof(float));
-    float* bsrc           = bsrc_t + bsrcWidthStep;
-    CopyMakeBorder<float, cn>(height, width, inWidthStride, inData, bsrcHeight, bsrcWidth, bsrcWidthStep, bsrc, borderType, border_value);
-
-    RowSum<float, float> rowVecOp = RowSum<float, float>(kernelx_len);
-    for (int32_t i = 0; i < bsrcHeight; i++) {
-        float* src = bsrc + i * bsrcWidthStep;
-        float* dst = bsrc_t + i * bsrcWidthStep;
-        rowVecOp.operator()(src, dst, width, cn);
-    }
-    const float** pReRowFilter = (const float**)malloc(bsrcHeight * sizeof(bsrc_t));
-    for (int32_t i = 0; i < bsrcHeight; i++) {
-        pReRowFilter[i] = bsrc_t + (i)*bsrcWidthStep;
-    }
-
-    ColumnSum<float, float> colVecOp = ColumnSum<float, float>(kernely_len, normalize ? 1. / (kernelx_len * kernely_len) : 1);
-    colVecOp.operator()((const float**)pReRowFilter, (float*)outData, outWidthStride, height, width* cn);
-
-    free(bsrc_t);
-    free(pReRowFilter);
-    bsrc         = NULL;
-    pReRowFilter = NULL;
+    float scale = normalize ? 1. / (kernelx_len * kernely_len) : 1;
+    SeparableFilterEngine<float, float, float, RowSum<float, float>, ColumnSum<float, float>> engine(
+        height, width, cn, kernely_len, kernelx_len, borderType, border_value,
+        RowSum<float, float>(kernelx_len), ColumnSum<float, float>(kernely_len, scale));
+    parallel_for_rows(height, (int64_t)width * cn * (kernelx_len + kernely_len), [&](int32_t begin, int32_t end) {
+        for (int32_t y = begin; y < end; y += BOX_FILTER_SUM_ROWS) {
+            engine.process_rows(inData, inWidthStride, outData, outWidthStride, y, std::min(y + BOX_FILTER_SUM_ROWS, end));
+        }
+    }, BOX_FILTER_SUM_ROWS);
 }
 
 template <int32_t cn>
@@ -394,38 +382,11 @@ void x86boxFilter_b(
     BorderType borderType,
     uint8_t border_value = 0)
 {
-    int32_t radius_x = kernelx_len / 2;
-    int32_t radius_y = kernely_len / 2;
-
-    int32_t bsrcHeight = height + 2 * radius_y;
-    int32_t bsrcWidth  = width + 2 * radius_x;
-
-    int32_t bsrcWidthStep = (bsrcWidth)*cn;
-    int32_t rfstep        = width * cn;
-    uint8_t* bsrc         = (uint8_t*)malloc(bsrcHeight * bsrcWidth * cn * sizeof(uint8_t) +
-                                     bsrcHeight * width * cn * sizeof(int32_t));
-    CopyMakeBorder<uint8_t, cn>(height, width, inWidthStride, inData, bsrcHeight, bsrcWidth, bsrcWidthStep, bsrc, borderType, border_value);
-
-    int32_t* resultRowFilter = (int32_t*)(bsrc + bsrcHeight * bsrcWidth * cn * sizeof(uint8_t));
-
-    RowSum<uint8_t, int32_t> rowVecOp = RowSum<uint8_t, int32_t>(kernelx_len);
-    for (int32_t i = 0; i < bsrcHeight; i++) {
-        uint8_t* src = bsrc + i * bsrcWidthStep;
-        int32_t* dst = resultRowFilter + i * rfstep;
-        rowVecOp.operator()(src, dst, width, cn);
-    }
-
-    ColumnSum<int32_t, uint8_t> colVecOp = ColumnSum<int32_t, uint8_t>(kernely_len, normalize ? 1. / (kernelx_len * kernely_len) : 1);
-    const int32_t** pReRowFilter         = (const int32_t**)malloc(bsrcHeight * sizeof(resultRowFilter));
-    for (int32_t i = 0; i < bsrcHeight; i++) {
-        pReRowFilter[i] = resultRowFilter + (i)*rfstep;
-    }
-    colVecOp.operator()(pReRowFilter, outData, outWidthStride, height, width* cn);
-
-    free(bsrc);
-    free(pReRowFilter);
-    bsrc         = NULL;
-    pReRowFilter = NULL;
+    float scale = normalize ? 1. / (kernelx_len * kernely_len) : 1;
+    SeparableFilterEngine<uint8_t, int32_t, uint8_t, RowSum<uint8_t, int32_t>, ColumnSum<int32_t, uint8_t>> engine(
+        height, width, cn, kernely_len, kernelx_len, borderType, border_value,
+        RowSum<uint8_t, int32_t>(kernelx_len), ColumnSum<int32_t, uint8_t>(kernely_len, scale));
+    engine.process(inData, inWidthStride, outData, outWidthStride);
 }
 
 template <>
@@ -447,6 +408,9 @@ template <>
     if (width == 0 || height == 0 || inWidthStride == 0 || outWidthStride == 0) {
         return ppl::common::RC_INVALID_VALUE;
     }
+    if (kernelx_len <= 0 || kernely_len <= 0 || !filter_border_supported(border_type)) {
+        return ppl::common::RC_INVALID_VALUE;
+    }
     x86boxFilter_f<1>(height, width, inWidthStride, inData, kernelx_len, kernely_len, normalize, outWidthStride, outData, border_type);
     return ppl::common::RC_SUCCESS;
 }
@@ -469,6 +433,9 @@ template <>
     if (width == 0 || height == 0 || inWidthStride == 0 || outWidthStride == 0) {
         return ppl::common::RC_INVALID_VALUE;
     }
+    if (kernelx_len <= 0 || kernely_len <= 0 || !filter_border_supported(border_type)) {
+        return ppl::common::RC_INVALID_VALUE;
+    }
     x86boxFilter_f<3>(height, width, inWidthStride, inData, kernelx_len, kernely_len, normalize, outWidthStride, outData, border_type);
     return ppl::common::RC_SUCCESS;
 }
@@ -491,6 +458,9 @@ template <>
     if (width == 0 || height == 0 || inWidthStride == 0 || outWidthStride == 0) {
         return ppl::common::RC_INVALID_VALUE;
     }
+    if (kernelx_len <= 0 || kernely_len <= 0 || !filter_border_supported(border_type)) {
+        return ppl::common::RC_INVALID_VALUE;
+    }
     x86boxFilter_f<4>(height, width, inWidthStride, inData, kernelx_len, kernely_len, normalize, outWidthStride, outData, border_type);
     return ppl::common::RC_SUCCESS;
 }
@@ -513,6 +483,9 @@ template <>
     if (width == 0 || height == 0 || inWidthStride == 0 || outWidthStride == 0) {
         return ppl::common::RC_INVALID_VALUE;
     }
+    if (kernelx_len <= 0 || kernely_len <= 0 || !filter_border_supported(border_type)) {
+        return ppl::common::RC_INVALID_VALUE;
+    }
     x86boxFilter_b<1>(height, width, inWidthStride, inData, kernelx_len, kernely_len, normalize, outWidthStride, outData, border_type);
     return ppl::common::RC_SUCCESS;
 }
@@ -535,6 +508,9 @@ template <>
     if (width == 0 || height == 0 || inWidthStride == 0 || outWidthStride == 0) {
         return ppl::common::RC_INVALID_VALUE;
     }
+    if (kernelx_len <= 0 || kernely_len <= 0 || !filter_border_supported(border_type)) {
+        return ppl::common::RC_INVALID_VALUE;
+    }
     x86boxFilter_b<3>(height, width, inWidthStride, inData, kernelx_len, kernely_len, normalize, outWidthStride, outData, border_type);
     return ppl::common::RC_SUCCESS;
 }
@@ -557,6 +533,9 @@ template <>
     if (width == 0 || height == 0 || inWidthStride == 0 || outWidthStride == 0) {
         return ppl::common::RC_INVALID_VALUE;
     }
+    if (kernelx_len <= 0 || kernely_len <= 0 || !filter_border_supported(border_type)) {
+        return ppl::common::RC_INVALID_VALUE;
+    }
     x86boxFilter_b<4>(height, width, inWidthStride, inData, kernelx_len, kernely_len, normalize, outWidthStride, outData, border_type);
     return ppl::common::RC_SUCCESS;
 }
@@ -59,6 +59,18 @@ void BoxFilterTest(int32_t height, int32_t width, T diff) {
                                 width * nc, dst.get(), ppl::cv::BORDER_CONSTANT);
         cv::boxFilter(src_opencv, dst_opencv, -1,
                 cv::Size(filter_size, filter_size), cv::Point(-1,-1), normalized, cv::BORDER_CONSTANT);
+    } else if (border_type == ppl::cv::BORDER_WRAP) {
+        ppl::cv::x86::BoxFilter<T, nc>(height, width,
+                                width * nc, src.get(),
+                                filter_size, filter_size, normalized,
+                                width * nc, dst.get(), ppl::cv::BORDER_WRAP);
+        // OpenCV filters reject BORDER_WRAP, so filter a wrapped copy and crop it.
+        int32_t radius = filter_size / 2;
+        cv::Mat padded, filtered;
+        cv::copyMakeBorder(src_opencv, padded, radius, radius, radius, radius, cv::BORDER_WRAP);
+        cv::boxFilter(padded, filtered, -1,
+                cv::Size(filter_size, filter_size), cv::Point(-1,-1), normalized, cv::BORDER_REPLICATE);
+        filtered(cv::Rect(radius, radius, width, height)).copyTo(dst_opencv);
     }
     checkResult<T, nc>(dst_ref.get(), dst.get(),
                     height, width,
@@ -186,3 +198,37 @@ TEST(BoxFilter_REPLICATE_UINT8, x86)
     BoxFilterTest<uint8_t, 1, 5, false, ppl::cv::BORDER_REPLICATE>(720, 1080, 1.0f);
     BoxFilterTest<uint8_t, 1, 5, true, ppl::cv::BORDER_REPLICATE>(720, 1080, 1.0f);
 }
+
+TEST(BoxFilter_WRAP_FP32, x86)
+{
+    BoxFilterTest<float, 3, 3, false, ppl::cv::BORDER_WRAP>(720, 1080, 1.0f);
+    BoxFilterTest<float, 3, 3, true, ppl::cv::BORDER_WRAP>(720, 1080, 1.0f);
+
+    BoxFilterTest<float, 1, 3, false, ppl::cv::BORDER_WRAP>(720, 1080, 1.0f);
+    BoxFilterTest<float, 1, 3, true, ppl::cv::BORDER_WRAP>(720, 1080, 1.0f);
+
+    BoxFilterTest<float, 3, 5, false, ppl::cv::BORDER_WRAP>(720, 1080, 1.0f);
+    BoxFilterTest<float, 3, 5, true, ppl::cv::BORDER_WRAP>(720, 1080, 1.0f);
+
+    BoxFilterTest<float, 1, 5, false, ppl::cv::BORDER_WRAP>(720, 1080, 1.0f);
+    BoxFilterTest<float, 1, 5, true, ppl::cv::BORDER_WRAP>(720, 1080, 1.0f);
+
+    BoxFilterTest<float, 4, 7, true, ppl::cv::BORDER_WRAP>(241, 321, 1.0f);
+}
+
+TEST(BoxFilter_WRAP_UINT8, x86)
+{
+    BoxFilterTest<uint8_t, 3, 3, false, ppl::cv::BORDER_WRAP>(720, 1080, 1.0f);
+    BoxFilterTest<uint8_t, 3, 3, true, ppl::cv::BORDER_WRAP>(720, 1080, 1.0f);
+
+    BoxFilterTest<uint8_t, 1, 3, false, ppl::cv::BORDER_WRAP>(720, 1080, 1.0f);
+    BoxFilterTest<uint8_t, 1, 3, true, ppl::cv::BORDER_WRAP>(720, 1080, 1.0f);
+
+    BoxFilterTest<uint8_t, 3, 5, false, ppl::cv::BORDER_WRAP>(720, 1080, 1.0f);
+    BoxFilterTest<uint8_t, 3, 5, true, ppl::cv::BORDER_WRAP>(720, 1080, 1.0f);
+
+    BoxFilterTest<uint8_t, 1, 5, false, ppl::cv::BORDER_WRAP>(720, 1080, 1.0f);
+    BoxFilterTest<uint8_t, 1, 5, true, ppl::cv::BORDER_WRAP>(720, 1080, 1.0f);
+
+    BoxFilterTest<uint8_t, 4, 7, true, ppl::cv::BORDER_WRAP>(241, 321, 1.0f);
+}
@@ -16,15 +16,99 @@
 // under the License.
 
 #include "ppl/cv/x86/calchist.h"
+#include "ppl/cv/x86/parallel.hpp"
 #include "ppl/cv/types.h"
 #include "ppl/common/sys.h"
 #include "ppl/common/log.h"
 #include <string.h>
+#include <mutex>
+#include <smmintrin.h>
 
 namespace ppl {
 namespace cv {
 namespace x86 {
 
+// Consecutive pixels are counted into different sub-histograms, so runs of
+// one value (flat backgrounds) do not serialize on a single counter through
+// store-to-load forwarding. The last bin of each sub-histogram collects the
+// masked-out pixels, which keeps the masked loop free of branches.
+#define CALCHIST_SUB_NUM  8
+#define CALCHIST_BINS     256
+#define CALCHIST_SUB_SIZE (CALCHIST_BINS + 8)
+
+static inline void calc_hist_count8(uint64_t v, uint32_t (*sub)[CALCHIST_SUB_SIZE])
+{
+    sub[0][v & 0xFF]++;
+    sub[1][(v >> 8) & 0xFF]++;
+    sub[2][(v >> 16) & 0xFF]++;
+    sub[3][(v >> 24) & 0xFF]++;
+    sub[4][(v >> 32) & 0xFF]++;
+    sub[5][(v >> 40) & 0xFF]++;
+    sub[6][(v >> 48) & 0xFF]++;
+    sub[7][v >> 56]++;
+}
+
+static void calc_hist_rows_u8(
+    int32_t begin,
+    int32_t end,
+    int32_t width,
+    int32_t inWidthStride,
+    const uint8_t* inData,
+    uint32_t (*sub)[CALCHIST_SUB_SIZE])
+{
+    for (int32_t h = begin; h < end; ++h) {
+        const uint8_t* src = inData + (int64_t)h * inWidthStride;
+        int32_t w          = 0;
+        for (; w <= width - 16; w += 16) {
+            uint64_t v0, v1;
+            memcpy(&v0, src + w, sizeof(v0));
+            memcpy(&v1, src + w + 8, sizeof(v1));
+            calc_hist_count8(v0, sub);
+            calc_hist_count8(v1, sub);
+        }
+        for (; w < width; ++w) {
+            sub[w & 7][src[w]]++;
+        }
+    }
+}
+
+static void calc_hist_rows_mask_u8(
+    int32_t begin,
+    int32_t end,
+    int32_t width,
+    int32_t inWidthStride,
+    const uint8_t* inData,
+    int32_t maskWidthStride,
+    const uint8_t* mask,
+    uint32_t (*sub)[CALCHIST_SUB_SIZE])
+{
+    // masked-out pixels get index 256: low byte cleared, high byte set to 1
+    const __m128i v_zero = _mm_setzero_si128();
+    const __m128i v_one  = _mm_set1_epi8(1);
+    uint16_t idx[16];
+    for (int32_t h = begin; h < end; ++h) {
+        const uint8_t* src = inData + (int64_t)h * inWidthStride;
+        const uint8_t* msk = mask + (int64_t)h * maskWidthStride;
+        int32_t w          = 0;
+        for (; w <= width - 16; w += 16) {
+            __m128i v_out = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(msk + w)), v_zero);
+            __m128i v_src = _mm_andnot_si128(v_out, _mm_loadu_si128((const __m128i*)(src + w)));
+            __m128i v_off = _mm_and_si128(v_out, v_one);
+            _mm_storeu_si128((__m128i*)idx, _mm_unpacklo_epi8(v_src, v_off));
+            _mm_storeu_si128((__m128i*)(idx + 8), _mm_unpackhi_epi8(v_src, v_off));
+            for (int32_t i = 0; i < 16; i += CALCHIST_SUB_NUM) {
+                for (int32_t j = 0; j < CALCHIST_SUB_NUM; ++j) {
+                    sub[j][idx[i + j]]++;
+                }
+            }
+        }
+        for (; w < width; ++w) {
+            int32_t out = msk[w] == 0;
+            sub[w & 7][(src[w] & (out - 1)) | (out << 8)]++;
+        }
+    }
+}
+
 template <>
 ::ppl::common::RetCode CalcHist<uint8_t>(
     int32_t height,
@@ -41,29 +125,36 @@ template <>
     if (width <= 0 || height <= 0 || inWidthStride < width) {
         return ppl::common::RC_INVALID_VALUE;
     }
+    if (mask && maskWidthStride < width) {
+        return ppl::common::RC_INVALID_VALUE;
+    }
 
-    memset(outHist, 0, sizeof(int32_t) * 256);
+    memset(outHist, 0, sizeof(int32_t) * CALCHIST_BINS);
 
-    if (mask) {
-        for (int32_t h = 0; h < height; ++h) {
-            for (int32_t w = 0; w < width; ++w) {
-                int32_t inIdx      = h * inWidthStride + w;
-                int32_t inIdx_mask = h * maskWidthStride + w;
-                if (mask[inIdx_mask]) {
-                    int32_t value = inData[inIdx];
-                    outHist[value]++;
-                }
-            }
+    // every band reduces into its own sub-histograms, only the final merge is shared
+    std::mutex merge_mutex;
+    parallel_for_rows(height, width, [&](int32_t begin, int32_t end) {
+        uint32_t sub[CALCHIST_SUB_NUM][CALCHIST_SUB_SIZE];
+        memset(sub, 0, sizeof(sub));
+        if (mask) {
+            calc_hist_rows_mask_u8(begin, end, width, inWidthStride, inData, maskWidthStride, mask, sub);
+        } else {
+            calc_hist_rows_u8(begin, end, width, inWidthStride, inData, sub);
         }
-    } else {
-        for (int32_t h = 0; h < height; ++h) {
-            for (int32_t w = 0; w < width; ++w) {
-                int32_t inIdx = h * inWidthStride + w;
-                int32_t value = inData[inIdx];
-                outHist[value]++;
+        for (int32_t i = 0; i < CALCHIST_BINS; i += 4) {
+            __m128i v_sum = _mm_loadu_si128((const __m128i*)(sub[0] + i));
+            for (int32_t j = 1; j < CALCHIST_SUB_NUM; ++j) {
+                v_sum = _mm_add_epi32(v_sum, _mm_loadu_si128((const __m128i*)(sub[j] + i)));
             }
+            _mm_storeu_si128((__m128i*)(sub[0] + i), v_sum);
         }
-    }
+        std::lock_guard<std::mutex> lock(merge_mutex);
+        for (int32_t i = 0; i < CALCHIST_BINS; i += 4) {
+            __m128i v_hist = _mm_loadu_si128((const __m128i*)(outHist + i));
+            v_hist         = _mm_add_epi32(v_hist, _mm_loadu_si128((const __m128i*)(sub[0] + i)));
+            _mm_storeu_si128((__m128i*)(outHist + i), v_hist);
+        }
+    });
     return ppl::common::RC_SUCCESS;
 }
 
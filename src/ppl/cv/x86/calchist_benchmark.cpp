@@ -23,7 +23,23 @@
 
 namespace {
 
-template<typename T, bool with_mask>
+// A synthetic "natural" image: a flat background covering most of the frame,
+// a smooth gradient object in the middle and a little sensor noise. Long runs
+// of one value are what make scalar histograms stall.
+void fillNaturalImage(uint8_t *data, int height, int width)
+{
+    uint8_t noise[64];
+    ppl::cv::debug::randomFill<uint8_t>(noise, 64, 0, 3);
+    for (int i = 0; i < height; ++i) {
+        for (int j = 0; j < width; ++j) {
+            bool object = i > height / 4 && i < height * 3 / 4 && j > width / 3 && j < width * 2 / 3;
+            int value = object ? 40 + (i + j) * 160 / (height + width) : 235;
+            data[i * width + j] = value + (((i * 7 + j * 13) & 63) < 8 ? noise[(i + j) & 63] : 0);
+        }
+    }
+}
+
+template<typename T, bool with_mask, bool natural>
 void BM_CalcHist_ppl_x86(benchmark::State &state) {
     int width = state.range(0);
     int height = state.range(1);
@@ -34,7 +50,11 @@ void BM_CalcHist_ppl_x86(benchmark::State &state) {
     std::unique_ptr<int> dst(new int[histSize]); //for uint8_t
 
     //init 
-    ppl::cv::debug::randomFill<uint8_t>(src.get(), width * height * c, 0, 255);
+    if (natural) {
+        fillNaturalImage(src.get(), height, width);
+    } else {
+        ppl::cv::debug::randomFill<uint8_t>(src.get(), width * height * c, 0, 255);
+    }
     ppl::cv::debug::randomFill<uint8_t>(mask.get(), width * height * c, 0, 2);
     memset(dst.get(), 0, sizeof(int)*histSize);
     if (!with_mask) {
@@ -53,11 +73,13 @@ void BM_CalcHist_ppl_x86(benchmark::State &state) {
 
 using namespace ppl::cv::debug;
 
-BENCHMARK_TEMPLATE(BM_CalcHist_ppl_x86, uint8_t, false)->Args({320, 240})->Args({640, 480})->Args({1280, 720})->Args({1920, 1080})->Args({3840, 2160});
-BENCHMARK_TEMPLATE(BM_CalcHist_ppl_x86, uint8_t, true)->Args({320, 240})->Args({640, 480})->Args({1280, 720})->Args({1920, 1080})->Args({3840, 2160});
+BENCHMARK_TEMPLATE(BM_CalcHist_ppl_x86, uint8_t, false, false)->Args({320, 240})->Args({640, 480})->Args({1280, 720})->Args({1920, 1080})->Args({3840, 2160});
+BENCHMARK_TEMPLATE(BM_CalcHist_ppl_x86, uint8_t, true, false)->Args({320, 240})->Args({640, 480})->Args({1280, 720})->Args({1920, 1080})->Args({3840, 2160});
+BENCHMARK_TEMPLATE(BM_CalcHist_ppl_x86, uint8_t, false, true)->Args({320, 240})->Args({640, 480})->Args({1280, 720})->Args({1920, 1080})->Args({3840, 2160});
+BENCHMARK_TEMPLATE(BM_CalcHist_ppl_x86, uint8_t, true, true)->Args({320, 240})->Args({640, 480})->Args({1280, 720})->Args({1920, 1080})->Args({3840, 2160});
 
 #ifdef PPLCV_BENCHMARK_OPENCV
-template<typename T, bool with_mask>
+template<typename T, bool with_mask, bool natural>
 static void BM_CalcHist_opencv_x86(benchmark::State &state)
 {
     int width = state.range(0);
@@ -69,7 +91,11 @@ static void BM_CalcHist_opencv_x86(benchmark::State &state)
     std::unique_ptr<int> dst(new int[histSize]); //for uint8_t
 
     //init 
-    ppl::cv::debug::randomFill<uint8_t>(src.get(), width * height * c, 0, 255);
+    if (natural) {
+        fillNaturalImage(src.get(), height, width);
+    } else {
+        ppl::cv::debug::randomFill<uint8_t>(src.get(), width * height * c, 0, 255);
+    }
     ppl::cv::debug::randomFill<uint8_t>(mask.get(), width * height * c, 0, 2);
     memset(dst.get(), 0, sizeof(int)*histSize);
     cv::Mat srcMat(height, width, CV_MAKETYPE(cv::DataType<T>::depth, 1), src.get());
@@ -93,8 +119,10 @@ static void BM_CalcHist_opencv_x86(benchmark::State &state)
     }
 }
 
-BENCHMARK_TEMPLATE(BM_CalcHist_opencv_x86, uint8_t, false)->Args({320, 240})->Args({640, 480})->Args({1280, 720})->Args({1920, 1080})->Args({3840, 2160});
-BENCHMARK_TEMPLATE(BM_CalcHist_opencv_x86, uint8_t, true)->Args({320, 240})->Args({640, 480})->Args({1280, 720})->Args({1920, 1080})->Args({3840, 2160});
+BENCHMARK_TEMPLATE(BM_CalcHist_opencv_x86, uint8_t, false, false)->Args({320, 240})->Args({640, 480})->Args({1280, 720})->Args({1920, 1080})->Args({3840, 2160});
+BENCHMARK_TEMPLATE(BM_CalcHist_opencv_x86, uint8_t, true, false)->Args({320, 240})->Args({640, 480})->Args({1280, 720})->Args({1920, 1080})->Args({3840, 2160});
+BENCHMARK_TEMPLATE(BM_CalcHist_opencv_x86, uint8_t, false, true)->Args({320, 240})->Args({640, 480})->Args({1280, 720})->Args({1920, 1080})->Args({3840, 2160});
+BENCHMARK_TEMPLATE(BM_CalcHist_opencv_x86, uint8_t, true, true)->Args({320, 240})->Args({640, 480})->Args({1280, 720})->Args({1920, 1080})->Args({3840, 2160});
 #endif //! PPLCV_BENCHMARK_OPENCV
 }
 
@@ -85,3 +85,10 @@ TEST(CalcHistTest_UINT8, x86)
     CalcHistTest<uint8_t>(1080, 1920);
 }
 
+TEST(CalcHistTest_UINT8_ODD_SIZE, x86)
+{
+    CalcHistTest<uint8_t>(1, 1);
+    CalcHistTest<uint8_t>(7, 13);
+    CalcHistTest<uint8_t>(481, 643);
+}
+
@@ -21,8 +21,10 @@
 #include "ppl/cv/x86/intrinutils.hpp"
 #include "ppl/cv/types.h"
 #include "ppl/cv/x86/util.hpp"
+#include "ppl/cv/x86/parallel.hpp"
 #include "ppl/common/sys.h"
 #include "ppl/common/x86/sysinfo.h"
+#include "ppl/cv/x86/isa.hpp"
 #include <string.h>
 #include <cmath>
 
@@ -186,43 +188,45 @@ struct RGB2Gray<uint8_t> {
     __m128i v_zero   = _mm_setzero_si128();
 
     int32_t vsize = 16;
-    for (int32_t h = 0; h < height; h++) {
-        const uint8_t *src_ptr = src + h * stride;
-        uint8_t *dst_ptr       = dst + h * width;
-        int32_t w              = 0;
-        for (; w < width; w += vsize, src_ptr += vsize * 3) {
-            __m128i data1 = _mm_loadu_si128((__m128i *)(src_ptr + 0));
-            __m128i data2 = _mm_loadu_si128((__m128i *)(src_ptr + 16));
-            __m128i data3 = _mm_loadu_si128((__m128i *)(src_ptr + 32));
+    parallel_for_rows(height, width * 4, [&](int32_t begin, int32_t end) {
+        for (int32_t h = begin; h < end; h++) {
+            const uint8_t *src_ptr = src + h * stride;
+            uint8_t *dst_ptr       = dst + h * width;
+            int32_t w              = 0;
+            for (; w <= width - vsize; w += vsize, src_ptr += vsize * 3) {
+                __m128i data1 = _mm_loadu_si128((__m128i *)(src_ptr + 0));
+                __m128i data2 = _mm_loadu_si128((__m128i *)(src_ptr + 16));
+                __m128i data3 = _mm_loadu_si128((__m128i *)(src_ptr + 32));
 
-            __m128i v_bgl  = _mm_shuffle_epi8(data1, _mm_setr_epi8(0, 1, 3, 4, 6, 7, 9, 10, 12, 13, 15, -1, -1, -1, -1, -1));
-            v_bgl          = _mm_or_si128(v_bgl, _mm_shuffle_epi8(data2, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 0, 2, 3, 5, 6)));
-            __m128i v_bgh  = _mm_shuffle_epi8(data2, _mm_setr_epi8(8, 9, 11, 12, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1));
-            v_bgh          = _mm_or_si128(v_bgh, _mm_shuffle_epi8(data3, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, 1, 2, 4, 5, 7, 8, 10, 11, 13, 14)));
-            __m128i v_rcl  = _mm_shuffle_epi8(data1, _mm_setr_epi8(2, -1, 5, -1, 8, -1, 11, -1, 14, -1, -1, -1, -1, -1, -1, -1));
-            v_rcl          = _mm_or_si128(v_rcl, _mm_shuffle_epi8(data2, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 1, -1, 4, -1, 7, -1)));
-            __m128i v_rch  = _mm_shuffle_epi8(data2, _mm_setr_epi8(10, -1, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1));
-            v_rch          = _mm_or_si128(v_rch, _mm_shuffle_epi8(data3, _mm_setr_epi8(-1, -1, -1, -1, 0, -1, 3, -1, 6, -1, 9, -1, 12, -1, 15, -1)));
-            __m128i v_gbll = _mm_unpacklo_epi8(v_bgl, v_zero);
-            __m128i v_gblh = _mm_unpackhi_epi8(v_bgl, v_zero);
-            __m128i v_rcll = _mm_or_si128(_mm_unpacklo_epi8(v_rcl, v_zero), v_half);
-            __m128i v_rclh = _mm_or_si128(_mm_unpackhi_epi8(v_rcl, v_zero), v_half);
-            __m128i v_bghl = _mm_unpacklo_epi8(v_bgh, v_zero);
-            __m128i v_bghh = _mm_unpackhi_epi8(v_bgh, v_zero);
-            __m128i v_rchl = _mm_or_si128(_mm_unpacklo_epi8(v_rch, v_zero), v_half);
-            __m128i v_rchh = _mm_or_si128(_mm_unpackhi_epi8(v_rch, v_zero), v_half);
+                __m128i v_bgl  = _mm_shuffle_epi8(data1, _mm_setr_epi8(0, 1, 3, 4, 6, 7, 9, 10, 12, 13, 15, -1, -1, -1, -1, -1));
+                v_bgl          = _mm_or_si128(v_bgl, _mm_shuffle_epi8(data2, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 0, 2, 3, 5, 6)));
+                __m128i v_bgh  = _mm_shuffle_epi8(data2, _mm_setr_epi8(8, 9, 11, 12, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1));
+                v_bgh          = _mm_or_si128(v_bgh, _mm_shuffle_epi8(data3, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, 1, 2, 4, 5, 7, 8, 10, 11, 13, 14)));
+                __m128i v_rcl  = _mm_shuffle_epi8(data1, _mm_setr_epi8(2, -1, 5, -1, 8, -1, 11, -1, 14, -1, -1, -1, -1, -1, -1, -1));
+                v_rcl          = _mm_or_si128(v_rcl, _mm_shuffle_epi8(data2, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 1, -1, 4, -1, 7, -1)));
+                __m128i v_rch  = _mm_shuffle_epi8(data2, _mm_setr_epi8(10, -1, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1));
+                v_rch          = _mm_or_si128(v_rch, _mm_shuffle_epi8(data3, _mm_setr_epi8(-1, -1, -1, -1, 0, -1, 3, -1, 6, -1, 9, -1, 12, -1, 15, -1)));
+                __m128i v_gbll = _mm_unpacklo_epi8(v_bgl, v_zero);
+                __m128i v_gblh = _mm_unpackhi_epi8(v_bgl, v_zero);
+                __m128i v_rcll = _mm_or_si128(_mm_unpacklo_epi8(v_rcl, v_zero), v_half);
+                __m128i v_rclh = _mm_or_si128(_mm_unpackhi_epi8(v_rcl, v_zero), v_half);
+                __m128i v_bghl = _mm_unpacklo_epi8(v_bgh, v_zero);
+                __m128i v_bghh = _mm_unpackhi_epi8(v_bgh, v_zero);
+                __m128i v_rchl = _mm_or_si128(_mm_unpacklo_epi8(v_rch, v_zero), v_half);
+                __m128i v_rchh = _mm_or_si128(_mm_unpackhi_epi8(v_rch, v_zero), v_half);
 
-            __m128i grayll = _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(v_gbll, coeff_bg), _mm_madd_epi16(v_rcll, coeff_rc)), shift);
-            __m128i graylh = _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(v_gblh, coeff_bg), _mm_madd_epi16(v_rclh, coeff_rc)), shift);
-            __m128i grayhl = _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(v_bghl, coeff_bg), _mm_madd_epi16(v_rchl, coeff_rc)), shift);
-            __m128i grayhh = _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(v_bghh, coeff_bg), _mm_madd_epi16(v_rchh, coeff_rc)), shift);
-            _mm_storeu_si128((__m128i *)(dst_ptr + w), _mm_packus_epi16(_mm_packus_epi32(grayll, graylh), _mm_packus_epi32(grayhl, grayhh)));
-        }
-        for (; w < width; w++, src_ptr += 3) {
-            int32_t blue = src_ptr[0], green = src_ptr[1], red = src_ptr[2];
-            dst_ptr[w] = (coeff_b * blue + coeff_g * green + coeff_r * red + halfshift) >> shift;
+                __m128i grayll = _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(v_gbll, coeff_bg), _mm_madd_epi16(v_rcll, coeff_rc)), shift);
+                __m128i graylh = _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(v_gblh, coeff_bg), _mm_madd_epi16(v_rclh, coeff_rc)), shift);
+                __m128i grayhl = _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(v_bghl, coeff_bg), _mm_madd_epi16(v_rchl, coeff_rc)), shift);
+                __m128i grayhh = _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(v_bghh, coeff_bg), _mm_madd_epi16(v_rchh, coeff_rc)), shift);
+                _mm_storeu_si128((__m128i *)(dst_ptr + w), _mm_packus_epi16(_mm_packus_epi32(grayll, graylh), _mm_packus_epi32(grayhl, grayhh)));
+            }
+            for (; w < width; w++, src_ptr += 3) {
+                int32_t blue = src_ptr[0], green = src_ptr[1], red = src_ptr[2];
+                dst_ptr[w] = (coeff_b * blue + coeff_g * green + coeff_r * red + halfshift) >> shift;
+            }
         }
-    }
+    });
     return ppl::common::RC_SUCCESS;
 }
 
@@ -244,19 +248,21 @@ template <>
     if (width == 0 || height == 0 || inWidthStride == 0 || outWidthStride == 0) {
         return ppl::common::RC_INVALID_VALUE;
     }
-    if (ppl::common::CpuSupports(ppl::common::ISA_X86_FMA)) {
-        return fma::BGR2GRAY(height, width, inWidthStride, inData, outWidthStride, outData, false);
-    } else if (ppl::common::CpuSupports(ppl::common::ISA_X86_AVX)) {
-        return BGR2GRAYImage_avx<float, 3, float, 1>(height, width, inWidthStride, inData, outWidthStride, outData);
+    if (isa_supported(ppl::common::ISA_X86_FMA)) {
+        return parallel_for_rows_status(height, width * 4, [&](int32_t begin, int32_t end) {
+            return fma::BGR2GRAY(end - begin, width, inWidthStride, inData + begin * inWidthStride, outWidthStride, outData + begin * outWidthStride, false);
+        });
+    } else if (isa_supported(ppl::common::ISA_X86_AVX)) {
+        return parallel_for_rows_status(height, width * 4, [&](int32_t begin, int32_t end) {
+            return BGR2GRAYImage_avx<float, 3, float, 1>(end - begin, width, inWidthStride, inData + begin * inWidthStride, outWidthStride, outData + begin * outWidthStride);
+        });
     }
-    const float *src  = inData;
-    float *dst        = outData;
     RGB2Gray<float> s = RGB2Gray<float>(3, 0, NULL);
-    for (int32_t i = 0; i < height; ++i) {
-        s.operator()(src, dst, width);
-        src += inWidthStride;
-        dst += outWidthStride;
-    }
+    parallel_for_rows(height, width * 4, [&](int32_t begin, int32_t end) {
+        for (int32_t i = begin; i < end; ++i) {
+            s.operator()(inData + i * inWidthStride, outData + i * outWidthStride, width);
+        }
+    });
     return ppl::common::RC_SUCCESS;
 }
 
@@ -299,17 +305,17 @@ template <>
     if (width == 0 || height == 0 || inWidthStride == 0 || outWidthStride == 0) {
         return ppl::common::RC_INVALID_VALUE;
     }
-    if (ppl::common::CpuSupports(ppl::common::ISA_X86_AVX)) {
-        return BGR2GRAYImage_avx<float, 4, float, 1>(height, width, inWidthStride, inData, outWidthStride, outData);
+    if (isa_supported(ppl::common::ISA_X86_AVX)) {
+        return parallel_for_rows_status(height, width * 4, [&](int32_t begin, int32_t end) {
+            return BGR2GRAYImage_avx<float, 4, float, 1>(end - begin, width, inWidthStride, inData + begin * inWidthStride, outWidthStride, outData + begin * outWidthStride);
+        });
     }
-    const float *src  = inData;
-    float *dst        = outData;
     RGB2Gray<float> s = RGB2Gray<float>(4, 0, NULL);
-    for (int32_t i = 0; i < height; ++i) {
-        s.operator()(src, dst, width);
-        src += inWidthStride;
-        dst += outWidthStride;
-    }
+    parallel_for_rows(height, width * 4, [&](int32_t begin, int32_t end) {
+        for (int32_t i = begin; i < end; ++i) {
+            s.operator()(inData + i * inWidthStride, outData + i * outWidthStride, width);
+        }
+    });
     return ppl::common::RC_SUCCESS;
 }
 template <>
@@ -330,14 +336,12 @@ template <>
     if (width == 0 || height == 0 || inWidthStride == 0 || outWidthStride == 0) {
         return ppl::common::RC_INVALID_VALUE;
     }
-    const uint8_t *src  = inData;
-    uint8_t *dst        = outData;
     RGB2Gray<uint8_t> s = RGB2Gray<uint8_t>(4, 0, NULL);
-    for (int32_t i = 0; i < height; i++) {
-        s.operator()(src, dst, width);
-        src += inWidthStride;
-        dst += outWidthStride;
-    }
+    parallel_for_rows(height, width * 4, [&](int32_t begin, int32_t end) {
+        for (int32_t i = begin; i < end; ++i) {
+            s.operator()(inData + i * inWidthStride, outData + i * outWidthStride, width);
+        }
+    });
     return ppl::common::RC_SUCCESS;
 }
 
@@ -359,19 +363,21 @@ template <>
     if (width == 0 || height == 0 || inWidthStride == 0 || outWidthStride == 0) {
         return ppl::common::RC_INVALID_VALUE;
     }
-    if (ppl::common::CpuSupports(ppl::common::ISA_X86_FMA)) {
-        return fma::BGR2GRAY(height, width, inWidthStride, inData, outWidthStride, outData, true);
-    } else if (ppl::common::CpuSupports(ppl::common::ISA_X86_AVX)) {
-        return RGB2GRAYImage_avx<float, 3, float, 1>(height, width, inWidthStride, inData, outWidthStride, outData);
+    if (isa_supported(ppl::common::ISA_X86_FMA)) {
+        return parallel_for_rows_status(height, width * 4, [&](int32_t begin, int32_t end) {
+            return fma::BGR2GRAY(end - begin, width, inWidthStride, inData + begin * inWidthStride, outWidthStride, outData + begin * outWidthStride, true);
+        });
+    } else if (isa_supported(ppl::common::ISA_X86_AVX)) {
+        return parallel_for_rows_status(height, width * 4, [&](int32_t begin, int32_t end) {
+            return RGB2GRAYImage_avx<float, 3, float, 1>(end - begin, width, inWidthStride, inData + begin * inWidthStride, outWidthStride, outData + begin * outWidthStride);
+        });
     }
-    const float *src  = inData;
-    float *dst        = outData;
     RGB2Gray<float> s = RGB2Gray<float>(3, 2, NULL);
-    for (int32_t i = 0; i < height; ++i) {
-        s.operator()(src, dst, width);
-        src += inWidthStride;
-        dst += outWidthStride;
-    }
+    parallel_for_rows(height, width * 4, [&](int32_t begin, int32_t end) {
+        for (int32_t i = begin; i < end; ++i) {
+            s.operator()(inData + i * inWidthStride, outData + i * outWidthStride, width);
+        }
+    });
     return ppl::common::RC_SUCCESS;
 }
 template <>
@@ -393,14 +399,12 @@ template <>
         return ppl::common::RC_INVALID_VALUE;
     }
     return bgr2gray_operator(inData, outData, width, height, inWidthStride, false);
-    const uint8_t *src  = inData;
-    uint8_t *dst        = outData;
     RGB2Gray<uint8_t> s = RGB2Gray<uint8_t>(3, 2, NULL);
-    for (int32_t i = 0; i < height; i++) {
-        s.operator()(src, dst, width);
-        src += inWidthStride;
-        dst += outWidthStride;
-    }
+    parallel_for_rows(height, width * 4, [&](int32_t begin, int32_t end) {
+        for (int32_t i = begin; i < end; ++i) {
+            s.operator()(inData + i * inWidthStride, outData + i * outWidthStride, width);
+        }
+    });
     return ppl::common::RC_SUCCESS;
 }
 
@@ -422,17 +426,17 @@ template <>
     if (width == 0 || height == 0 || inWidthStride == 0 || outWidthStride == 0) {
         return ppl::common::RC_INVALID_VALUE;
     }
-    if (ppl::common::CpuSupports(ppl::common::ISA_X86_AVX)) {
-        return RGB2GRAYImage_avx<float, 4, float, 1>(height, width, inWidthStride, inData, outWidthStride, outData);
+    if (isa_supported(ppl::common::ISA_X86_AVX)) {
+        return parallel_for_rows_status(height, width * 4, [&](int32_t begin, int32_t end) {
+            return RGB2GRAYImage_avx<float, 4, float, 1>(end - begin, width, inWidthStride, inData + begin * inWidthStride, outWidthStride, outData + begin * outWidthStride);
+        });
     }
-    const float *src  = inData;
-    float *dst        = outData;
     RGB2Gray<float> s = RGB2Gray<float>(4, 2, NULL);
-    for (int32_t i = 0; i < height; ++i) {
-        s.operator()(src, dst, width);
-        src += inWidthStride;
-        dst += outWidthStride;
-    }
+    parallel_for_rows(height, width * 4, [&](int32_t begin, int32_t end) {
+        for (int32_t i = begin; i < end; ++i) {
+            s.operator()(inData + i * inWidthStride, outData + i * outWidthStride, width);
+        }
+    });
     return ppl::common::RC_SUCCESS;
 }
 template <>
@@ -453,14 +457,12 @@ template <>
     if (width == 0 || height == 0 || inWidthStride == 0 || outWidthStride == 0) {
         return ppl::common::RC_INVALID_VALUE;
     }
-    const uint8_t *src  = inData;
-    uint8_t *dst        = outData;
     RGB2Gray<uint8_t> s = RGB2Gray<uint8_t>(4, 2, NULL);
-    for (int32_t i = 0; i < height; i++) {
-        s.operator()(src, dst, width);
-        src += inWidthStride;
-        dst += outWidthStride;
-    }
+    parallel_for_rows(height, width * 4, [&](int32_t begin, int32_t end) {
+        for (int32_t i = begin; i < end; ++i) {
+            s.operator()(inData + i * inWidthStride, outData + i * outWidthStride, width);
+        }
+    });
     return ppl::common::RC_SUCCESS;
 }
 
@@ -482,14 +484,12 @@ template <>
     if (width == 0 || height == 0 || inWidthStride == 0 || outWidthStride == 0) {
         return ppl::common::RC_INVALID_VALUE;
     }
-    const float *src  = inData;
-    float *dst        = outData;
     Gray2RGB<float> s = Gray2RGB<float>(3);
-    for (int32_t i = 0; i < height; i++) {
-        s.operator()(src, dst, width);
-        src += inWidthStride;
-        dst += outWidthStride;
-    }
+    parallel_for_rows(height, width * 4, [&](int32_t begin, int32_t end) {
+        for (int32_t i = begin; i < end; ++i) {
+            s.operator()(inData + i * inWidthStride, outData + i * outWidthStride, width);
+        }
+    });
     return ppl::common::RC_SUCCESS;
 }
 template <>
@@ -510,14 +510,12 @@ template <>
     if (width == 0 || height == 0 || inWidthStride == 0 || outWidthStride == 0) {
         return ppl::common::RC_INVALID_VALUE;
     }
-    const uint8_t *src  = inData;
-    uint8_t *dst        = outData;
     Gray2RGB<uint8_t> s = Gray2RGB<uint8_t>(3);
-    for (int32_t i = 0; i < height; i++) {
-        s.operator()(src, dst, width);
-        src += inWidthStride;
-        dst += outWidthStride;
-    }
+    parallel_for_rows(height, width * 4, [&](int32_t begin, int32_t end) {
+        for (int32_t i = begin; i < end; ++i) {
+            s.operator()(inData + i * inWidthStride, outData + i * outWidthStride, width);
+        }
+    });
     return ppl::common::RC_SUCCESS;
 }
 
@@ -539,14 +537,12 @@ template <>
     if (width == 0 || height == 0 || inWidthStride == 0 || outWidthStride == 0) {
         return ppl::common::RC_INVALID_VALUE;
     }
-    const float *src  = inData;
-    float *dst        = outData;
     Gray2RGB<float> s = Gray2RGB<float>(4);
-    for (int32_t i = 0; i < height; i++) {
-        s.operator()(src, dst, width);
-        src += inWidthStride;
-        dst += outWidthStride;
-    }
+    parallel_for_rows(height, width * 4, [&](int32_t begin, int32_t end) {
+        for (int32_t i = begin; i < end; ++i) {
+            s.operator()(inData + i * inWidthStride, outData + i * outWidthStride, width);
+        }
+    });
     return ppl::common::RC_SUCCESS;
 }
 template <>
@@ -567,14 +563,12 @@ template <>
     if (width == 0 || height == 0 || inWidthStride == 0 || outWidthStride == 0) {
         return ppl::common::RC_INVALID_VALUE;
     }
-    const uint8_t *src  = inData;
-    uint8_t *dst        = outData;
     Gray2RGB<uint8_t> s = Gray2RGB<uint8_t>(4);
-    for (int32_t i = 0; i < height; i++) {
-        s.operator()(src, dst, width);
-        src += inWidthStride;
-        dst += outWidthStride;
-    }
+    parallel_for_rows(height, width * 4, [&](int32_t begin, int32_t end) {
+        for (int32_t i = begin; i < end; ++i) {
+            s.operator()(inData + i * inWidthStride, outData + i * outWidthStride, width);
+        }
+    });
     return ppl::common::RC_SUCCESS;
 }
 
@@ -596,14 +590,12 @@ template <>
     if (width == 0 || height == 0 || inWidthStride == 0 || outWidthStride == 0) {
         return ppl::common::RC_INVALID_VALUE;
     }
-    const float *src  = inData;
-    float *dst        = outData;
     Gray2RGB<float> s = Gray2RGB<float>(3);
-    for (int32_t i = 0; i < height; i++) {
-        s.operator()(src, dst, width);
-        src += inWidthStride;
-        dst += outWidthStride;
-    }
+    parallel_for_rows(height, width * 4, [&](int32_t begin, int32_t end) {
+        for (int32_t i = begin; i < end; ++i) {
+            s.operator()(inData + i * inWidthStride, outData + i * outWidthStride, width);
+        }
+    });
     return ppl::common::RC_SUCCESS;
 }
 template <>
@@ -624,14 +616,12 @@ template <>
     if (width == 0 || height == 0 || inWidthStride == 0 || outWidthStride == 0) {
         return ppl::common::RC_INVALID_VALUE;
     }
-    const uint8_t *src  = inData;
-    uint8_t *dst        = outData;
     Gray2RGB<uint8_t> s = Gray2RGB<uint8_t>(3);
-    for (int32_t i = 0; i < height; i++) {
-        s.operator()(src, dst, width);
-        src += inWidthStride;
-        dst += outWidthStride;
-    }
+    parallel_for_rows(height, width * 4, [&](int32_t begin, int32_t end) {
+        for (int32_t i = begin; i < end; ++i) {
+            s.operator()(inData + i * inWidthStride, outData + i * outWidthStride, width);
+        }
+    });
     return ppl::common::RC_SUCCESS;
 }
 
@@ -653,14 +643,12 @@ template <>
     if (width == 0 || height == 0 || inWidthStride == 0 || outWidthStride == 0) {
         return ppl::common::RC_INVALID_VALUE;
     }
-    const float *src  = inData;
-    float *dst        = outData;
     Gray2RGB<float> s = Gray2RGB<float>(4);
-    for (int32_t i = 0; i < height; i++) {
-        s.operator()(src, dst, width);
-        src += inWidthStride;
-        dst += outWidthStride;
-    }
+    parallel_for_rows(height, width * 4, [&](int32_t begin, int32_t end) {
+        for (int32_t i = begin; i < end; ++i) {
+            s.operator()(inData + i * inWidthStride, outData + i * outWidthStride, width);
+        }
+    });
     return ppl::common::RC_SUCCESS;
 }
 template <>
@@ -681,14 +669,12 @@ template <>
     if (width == 0 || height == 0 || inWidthStride == 0 || outWidthStride == 0) {
         return ppl::common::RC_INVALID_VALUE;
     }
-    const uint8_t *src  = inData;
-    uint8_t *dst        = outData;
     Gray2RGB<uint8_t> s = Gray2RGB<uint8_t>(4);
-    for (int32_t i = 0; i < height; i++) {
-        s.operator()(src, dst, width);
-        src += inWidthStride;
-        dst += outWidthStride;
-    }
+    parallel_for_rows(height, width * 4, [&](int32_t begin, int32_t end) {
+        for (int32_t i = begin; i < end; ++i) {
+            s.operator()(inData + i * inWidthStride, outData + i * outWidthStride, width);
+        }
+    });
     return ppl::common::RC_SUCCESS;
 }
 
@@ -20,6 +20,7 @@
 #include "ppl/cv/types.h"
 #include "ppl/common/sys.h"
 #include "ppl/common/x86/sysinfo.h"
+#include "ppl/cv/x86/isa.hpp"
 #include <string.h>
 
 namespace ppl {
@@ -92,7 +93,7 @@ ppl::common::RetCode Crop<float, 1>(
         return ppl::common::RC_INVALID_VALUE;
     }
 
-    if (ppl::common::CpuSupports(ppl::common::ISA_X86_AVX)) {
+    if (isa_supported(ppl::common::ISA_X86_AVX)) {
         x86ImageCrop_avx<float, 1, float, 1, 1>(top, left, inWidthStride, inData, outHeight, outWidth, outWidthStride, outData, ratio);
         return ppl::common::RC_SUCCESS;
     }
@@ -129,7 +130,7 @@ ppl::common::RetCode Crop<float, 3>(
         return ppl::common::RC_INVALID_VALUE;
     }
 
-    if (ppl::common::CpuSupports(ppl::common::ISA_X86_AVX)) {
+    if (isa_supported(ppl::common::ISA_X86_AVX)) {
         x86ImageCrop_avx<float, 3, float, 3, 3>(top, left, inWidthStride, inData, outHeight, outWidth, outWidthStride, outData, ratio);
         return ppl::common::RC_SUCCESS;
     }
@@ -166,7 +167,7 @@ ppl::common::RetCode Crop<float, 4>(
         return ppl::common::RC_INVALID_VALUE;
     }
 
-    if (ppl::common::CpuSupports(ppl::common::ISA_X86_AVX)) {
+    if (isa_supported(ppl::common::ISA_X86_AVX)) {
         x86ImageCrop_avx<float, 4, float, 4, 4>(top, left, inWidthStride, inData, outHeight, outWidth, outWidthStride, outData, ratio);
         return ppl::common::RC_SUCCESS;
     }
@@ -0,0 +1,657 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+#include "ppl/cv/x86/cropresizenormalize.h"
+
+#include "ppl/cv/types.h"
+#include "ppl/common/sys.h"
+#include "ppl/common/retcode.h"
+#include "ppl/common/x86/sysinfo.h"
+#include "ppl/cv/x86/isa.hpp"
+#include "ppl/cv/x86/intrinutils.hpp"
+
+#include <string.h>
+#include <immintrin.h>
+#include <stdint.h>
+#include <algorithm>
+#include <atomic>
+
+#include "ppl/cv/x86/fma/internal_fma.hpp"
+#include "ppl/cv/x86/parallel.hpp"
+#include "ppl/cv/x86/resize.hpp"
+
+namespace ppl {
+namespace cv {
+namespace x86 {
+
+// Each band resizes its output rows a tile at a time into an interleaved
+// buffer of about this size, small enough to stay in L2 until the tile has
+// been normalized into the planes.
+#define CROP_RESIZE_NORMALIZE_TILE_BYTES (128 * 1024)
+// fewest rows of a tile, as the float resize computes two rows ahead of each tile
+#define CROP_RESIZE_NORMALIZE_MIN_TILE_ROWS 8
+
+static inline void crop_resize_normalize_store4(__m128 value, __m128 scale, __m128 bias, float *dst)
+{
+    _mm_storeu_ps(dst, _mm_add_ps(_mm_mul_ps(value, scale), bias));
+}
+
+static inline void crop_resize_normalize_store16(__m128i data, __m128 scale, __m128 bias, float *dst)
+{
+    crop_resize_normalize_store4(_mm_cvtepi32_ps(_mm_cvtepu8_epi32(data)), scale, bias, dst + 0);
+    crop_resize_normalize_store4(_mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_srli_si128(data, 4))), scale, bias, dst + 4);
+    crop_resize_normalize_store4(_mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_srli_si128(data, 8))), scale, bias, dst + 8);
+    crop_resize_normalize_store4(_mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_srli_si128(data, 12))), scale, bias, dst + 12);
+}
+
+// One resized row to the planes: dst[c][w] = src[w * channels + c] * scale[c] + bias[c],
+// for the first 1 or 3 channels.
+static void crop_resize_normalize_row(
+    const uint8_t *src,
+    int32_t channels,
+    int32_t width,
+    const float *scale,
+    const float *bias,
+    bool use_fma,
+    float *const *dst)
+{
+    int32_t planes = 1 == channels ? 1 : 3;
+    int32_t w      = 0;
+    if (use_fma) {
+        w = fma::crop_resize_normalize_row_u8_fma(src, channels, width, scale, bias, dst);
+    }
+
+    __m128 m_scale[3], m_bias[3];
+    for (int32_t c = 0; c < planes; ++c) {
+        m_scale[c] = _mm_set1_ps(scale[c]);
+        m_bias[c]  = _mm_set1_ps(bias[c]);
+    }
+    if (1 == channels) {
+        for (; w <= width - 16; w += 16) {
+            crop_resize_normalize_store16(_mm_loadu_si128((const __m128i *)(src + w)), m_scale[0], m_bias[0], dst[0] + w);
+        }
+    } else if (3 == channels) {
+        for (; w <= width - 16; w += 16) {
+            __m128i m_data[3];
+            v_load_deinterleave(src + w * 3, m_data[0], m_data[1], m_data[2]);
+            for (int32_t c = 0; c < 3; ++c) {
+                crop_resize_normalize_store16(m_data[c], m_scale[c], m_bias[c], dst[c] + w);
+            }
+        }
+    } else {
+        for (; w <= width - 16; w += 16) {
+            __m128i m_data[4];
+            v_load_deinterleave(src + w * 4, m_data[0], m_data[1], m_data[2], m_data[3]);
+            for (int32_t c = 0; c < 3; ++c) {
+                crop_resize_normalize_store16(m_data[c], m_scale[c], m_bias[c], dst[c] + w);
+            }
+        }
+    }
+    for (; w < width; ++w) {
+        for (int32_t c = 0; c < planes; ++c) {
+            dst[c][w] = src[w * channels + c] * scale[c] + bias[c];
+        }
+    }
+}
+
+static void crop_resize_normalize_row(
+    const float *src,
+    int32_t channels,
+    int32_t width,
+    const float *scale,
+    const float *bias,
+    bool use_fma,
+    float *const *dst)
+{
+    int32_t planes = 1 == channels ? 1 : 3;
+    int32_t w      = 0;
+    if (use_fma) {
+        w = fma::crop_resize_normalize_row_fp32_fma(src, channels, width, scale, bias, dst);
+    }
+
+    __m128 m_scale[3], m_bias[3];
+    for (int32_t c = 0; c < planes; ++c) {
+        m_scale[c] = _mm_set1_ps(scale[c]);
+        m_bias[c]  = _mm_set1_ps(bias[c]);
+    }
+    if (1 == channels) {
+        for (; w <= width - 4; w += 4) {
+            crop_resize_normalize_store4(_mm_loadu_ps(src + w), m_scale[0], m_bias[0], dst[0] + w);
+        }
+    } else if (3 == channels) {
+        for (; w <= width - 4; w += 4) {
+            __m128 m_data[3];
+            v_load_deinterleave(src + w * 3, m_data[0], m_data[1], m_data[2]);
+            for (int32_t c = 0; c < 3; ++c) {
+                crop_resize_normalize_store4(m_data[c], m_scale[c], m_bias[c], dst[c] + w);
+            }
+        }
+    } else {
+        for (; w <= width - 4; w += 4) {
+            __m128 m_data[4];
+            v_load_deinterleave(src + w * 4, m_data[0], m_data[1], m_data[2], m_data[3]);
+            for (int32_t c = 0; c < 3; ++c) {
+                crop_resize_normalize_store4(m_data[c], m_scale[c], m_bias[c], dst[c] + w);
+            }
+        }
+    }
+    for (; w < width; ++w) {
+        for (int32_t c = 0; c < planes; ++c) {
+            dst[c][w] = src[w * channels + c] * scale[c] + bias[c];
+        }
+    }
+}
+
+// float to IEEE half, rounding to nearest even. Half subnormals come from a
+// float addition that leaves the result in the low mantissa bits; values too
+// large for a half become infinity and NaNs stay quiet NaNs.
+static inline uint16_t crop_resize_normalize_half(float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    uint32_t sign = bits & 0x80000000u;
+    bits ^= sign;
+
+    uint32_t half;
+    if (bits >= (127 + 16) << 23) {
+        half = bits > 255u << 23 ? 0x7e00 : 0x7c00;
+    } else if (bits < 113 << 23) {
+        float magic = 0.5f;
+        float sum;
+        memcpy(&sum, &bits, sizeof(sum));
+        sum += magic;
+        memcpy(&half, &sum, sizeof(half));
+        half -= 0x3f000000u;
+    } else {
+        half = (bits + ((uint32_t)(15 - 127) << 23) + 0xfff + ((bits >> 13) & 1)) >> 13;
+    }
+    return (uint16_t)(half | (sign >> 16));
+}
+
+static inline __m128i crop_resize_normalize_half4(__m128 value)
+{
+    __m128i m_bits  = _mm_castps_si128(value);
+    __m128i m_sign  = _mm_and_si128(m_bits, _mm_set1_epi32(0x80000000));
+    __m128i m_abs   = _mm_xor_si128(m_bits, m_sign);
+    __m128 m_magic  = _mm_set1_ps(0.5f);
+    __m128i m_odd   = _mm_and_si128(_mm_srli_epi32(m_abs, 13), _mm_set1_epi32(1));
+    __m128i m_rebias = _mm_set1_epi32((int32_t)(((uint32_t)(15 - 127) << 23) + 0xfff));
+
+    __m128i m_normal    = _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(m_abs, m_rebias), m_odd), 13);
+    __m128i m_subnormal = _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(_mm_castsi128_ps(m_abs), m_magic)), _mm_castps_si128(m_magic));
+    __m128i m_inf_nan   = _mm_blendv_epi8(_mm_set1_epi32(0x7c00), _mm_set1_epi32(0x7e00), _mm_cmpgt_epi32(m_abs, _mm_set1_epi32(255 << 23)));
+
+    __m128i m_half = _mm_blendv_epi8(m_normal, m_subnormal, _mm_cmplt_epi32(m_abs, _mm_set1_epi32(113 << 23)));
+    m_half         = _mm_blendv_epi8(m_half, m_inf_nan, _mm_cmpgt_epi32(m_abs, _mm_set1_epi32(((127 + 16) << 23) - 1)));
+    return _mm_or_si128(m_half, _mm_srli_epi32(m_sign, 16));
+}
+
+static void crop_resize_normalize_half_row(const float *src, int32_t width, bool use_fma, uint16_t *dst)
+{
+    int32_t w = 0;
+    if (use_fma) {
+        w = fma::crop_resize_normalize_half_row_fma(src, width, dst);
+    }
+    for (; w <= width - 8; w += 8) {
+        __m128i m_half_0 = crop_resize_normalize_half4(_mm_loadu_ps(src + w + 0));
+        __m128i m_half_1 = crop_resize_normalize_half4(_mm_loadu_ps(src + w + 4));
+        _mm_storeu_si128((__m128i *)(dst + w), _mm_packus_epi32(m_half_0, m_half_1));
+    }
+    for (; w < width; ++w) {
+        dst[w] = crop_resize_normalize_half(src[w]);
+    }
+}
+
+// Writes one resized row into the planes. Float planes are written directly,
+// half planes go through a row of floats per plane in `scratch`.
+template <typename TSrc>
+static void crop_resize_normalize_store(
+    const TSrc *src,
+    int32_t channels,
+    int32_t width,
+    const float *scale,
+    const float *bias,
+    const int32_t *plane,
+    bool use_fma,
+    int32_t outPlaneStride,
+    float *outData,
+    float *)
+{
+    float *dst[3];
+    for (int32_t c = 0; c < (1 == channels ? 1 : 3); ++c) {
+        dst[c] = outData + plane[c] * outPlaneStride;
+    }
+    crop_resize_normalize_row(src, channels, width, scale, bias, use_fma, dst);
+}
+
+template <typename TSrc>
+static void crop_resize_normalize_store(
+    const TSrc *src,
+    int32_t channels,
+    int32_t width,
+    const float *scale,
+    const float *bias,
+    const int32_t *plane,
+    bool use_fma,
+    int32_t outPlaneStride,
+    uint16_t *outData,
+    float *scratch)
+{
+    int32_t planes = 1 == channels ? 1 : 3;
+    float *dst[3];
+    for (int32_t c = 0; c < planes; ++c) {
+        dst[c] = scratch + plane[c] * width;
+    }
+    crop_resize_normalize_row(src, channels, width, scale, bias, use_fma, dst);
+    for (int32_t p = 0; p < planes; ++p) {
+        crop_resize_normalize_half_row(scratch + p * width, width, use_fma, outData + p * outPlaneStride);
+    }
+}
+
+static inline ::ppl::common::RetCode crop_resize_normalize_table_create(const uint8_t *, int32_t inHeight, int32_t inWidth, int32_t channels, int32_t outHeight, int32_t outWidth, ResizeTable *table)
+{
+    return resize_linear_table_create_u8(inHeight, inWidth, channels, outHeight, outWidth, table);
+}
+
+static inline ::ppl::common::RetCode crop_resize_normalize_table_create(const float *, int32_t inHeight, int32_t inWidth, int32_t channels, int32_t outHeight, int32_t outWidth, ResizeTable *table)
+{
+    return resize_linear_table_create_fp32(inHeight, inWidth, channels, outHeight, outWidth, table);
+}
+
+static inline void crop_resize_normalize_resize(const ResizeTable &table, int32_t inWidthStride, const uint8_t *inData, int32_t outWidthStride, uint8_t *outData, void *rows, int32_t begin, int32_t end)
+{
+    resize_linear_run_rows_u8(table, inWidthStride, inData, outWidthStride, outData, rows, begin, end);
+}
+
+static inline void crop_resize_normalize_resize(const ResizeTable &table, int32_t inWidthStride, const float *inData, int32_t outWidthStride, float *outData, void *rows, int32_t begin, int32_t end)
+{
+    resize_linear_run_rows_fp32(table, inWidthStride, inData, outWidthStride, outData, rows, begin, end);
+}
+
+template <typename TSrc, typename TDst>
+static ::ppl::common::RetCode crop_resize_normalize(
+    int32_t inHeight,
+    int32_t inWidth,
+    int32_t inWidthStride,
+    const TSrc *inData,
+    int32_t channels,
+    int32_t left,
+    int32_t top,
+    int32_t cropWidth,
+    int32_t cropHeight,
+    int32_t outHeight,
+    int32_t outWidth,
+    int32_t outWidthStride,
+    int32_t outPlaneStride,
+    TDst *outData,
+    const float *mean,
+    const float *std,
+    bool swapRB)
+{
+    if (nullptr == inData || nullptr == outData || nullptr == mean || nullptr == std) {
+        return ppl::common::RC_INVALID_VALUE;
+    }
+    if (cropWidth <= 0 || cropHeight <= 0 || outWidth <= 0 || outHeight <= 0) {
+        return ppl::common::RC_INVALID_VALUE;
+    }
+    if (left < 0 || top < 0 || left + cropWidth > inWidth || top + cropHeight > inHeight) {
+        return ppl::common::RC_INVALID_VALUE;
+    }
+    if (inWidthStride < inWidth * channels || outWidthStride < outWidth ||
+        outPlaneStride < (outHeight - 1) * outWidthStride + outWidth) {
+        return ppl::common::RC_INVALID_VALUE;
+    }
+
+    // the scale, bias and output plane of every source channel
+    int32_t planes = 1 == channels ? 1 : 3;
+    float scale[3], bias[3];
+    int32_t plane[3];
+    for (int32_t p = 0; p < planes; ++p) {
+        if (0.f == std[p]) {
+            return ppl::common::RC_INVALID_VALUE;
+        }
+        int32_t c = swapRB && 3 == planes ? 2 - p : p;
+        scale[c]  = 1.f / std[p];
+        bias[c]   = -mean[p] * scale[c];
+        plane[c]  = p;
+    }
+
+    const TSrc *src = inData + top * inWidthStride + left * channels;
+    ResizeTable table;
+    ::ppl::common::RetCode status = crop_resize_normalize_table_create(src, cropHeight, cropWidth, channels, outHeight, outWidth, &table);
+    if (ppl::common::RC_SUCCESS != status) {
+        resize_table_destroy(&table);
+        return status;
+    }
+
+    // the u8 fma shrink kernel walks output rows in groups of 4
+    int32_t row_align     = !table.shrink2 && 0 == table.row_size ? 4 : 1;
+    int32_t cn_width      = channels * outWidth;
+    int32_t tile_stride   = (cn_width * sizeof(TSrc) + 128 - 1) / 128 * 128 / sizeof(TSrc);
+    int32_t tile_rows     = std::max<int32_t>(CROP_RESIZE_NORMALIZE_TILE_BYTES / (tile_stride * sizeof(TSrc)), CROP_RESIZE_NORMALIZE_MIN_TILE_ROWS);
+    tile_rows             = (std::min(tile_rows, outHeight) + row_align - 1) / row_align * row_align;
+    int32_t num_bands     = parallel_num_bands(outHeight, (int64_t)cn_width * 4, row_align, table.num_bands);
+    uint64_t size_for_tile    = (uint64_t)tile_rows * tile_stride * sizeof(TSrc);
+    uint64_t size_for_scratch = sizeof(TDst) == sizeof(float) ? 0 : ((uint64_t)planes * outWidth * sizeof(float) + 128 - 1) / 128 * 128;
+    uint64_t band_size        = size_for_tile + size_for_scratch;
+
+    unsigned char *buffer = (unsigned char *)ppl::common::AlignedAlloc(band_size * num_bands, 128);
+    if (nullptr == buffer) {
+        resize_table_destroy(&table);
+        return ppl::common::RC_OUT_OF_MEMORY;
+    }
+
+    bool use_fma = table.use_fma;
+    // bands take the row and tile buffers in the order they start
+    std::atomic<int32_t> next_band(0);
+    parallel_for_rows(outHeight, (int64_t)cn_width * 4, [&](int32_t begin, int32_t end) {
+        int32_t band   = next_band.fetch_add(1);
+        void *rows     = (unsigned char *)table.rows + table.row_size * 2 * band;
+        TSrc *tile     = (TSrc *)(buffer + band_size * band);
+        float *scratch = (float *)(buffer + band_size * band + size_for_tile);
+        for (int32_t h = begin; h < end; h += tile_rows) {
+            int32_t tile_end = std::min(h + tile_rows, end);
+            crop_resize_normalize_resize(table, inWidthStride, src, tile_stride, tile, rows, h, tile_end);
+            for (int32_t i = h; i < tile_end; ++i) {
+                crop_resize_normalize_store(tile + (i - h) * tile_stride, channels, outWidth, scale, bias, plane, use_fma, outPlaneStride, outData + i * outWidthStride, scratch);
+            }
+        }
+    }, row_align, num_bands);
+
+    ppl::common::AlignedFree(buffer);
+    resize_table_destroy(&table);
+    return ppl::common::RC_SUCCESS;
+}
+
+template <>
+::ppl::common::RetCode CropResizeNormalize<uint8_t, 1, float>(
+    int32_t inHeight,
+    int32_t inWidth,
+    int32_t inWidthStride,
+    const uint8_t *inData,
+    int32_t left,
+    int32_t top,
+    int32_t cropWidth,
+    int32_t cropHeight,
+    int32_t outHeight,
+    int32_t outWidth,
+    int32_t outWidthStride,
+    int32_t outPlaneStride,
+    float *outData,
+    const float *mean,
+    const float *std,
+    bool swapRB)
+{
+    return crop_resize_normalize<uint8_t, float>(
+        inHeight, inWidth, inWidthStride, inData, 1, left, top, cropWidth, cropHeight, outHeight, outWidth, outWidthStride, outPlaneStride, outData, mean, std, swapRB);
+}
+
+template <>
+::ppl::common::RetCode CropResizeNormalize<uint8_t, 3, float>(
+    int32_t inHeight,
+    int32_t inWidth,
+    int32_t inWidthStride,
+    const uint8_t *inData,
+    int32_t left,
+    int32_t top,
+    int32_t cropWidth,
+    int32_t cropHeight,
+    int32_t outHeight,
+    int32_t outWidth,
+    int32_t outWidthStride,
+    int32_t outPlaneStride,
+    float *outData,
+    const float *mean,
+    const float *std,
+    bool swapRB)
+{
+    return crop_resize_normalize<uint8_t, float>(
+        inHeight, inWidth, inWidthStride, inData, 3, left, top, cropWidth, cropHeight, outHeight, outWidth, outWidthStride, outPlaneStride, outData, mean, std, swapRB);
+}
+
+template <>
+::ppl::common::RetCode CropResizeNormalize<uint8_t, 4, float>(
+    int32_t inHeight,
+    int32_t inWidth,
+    int32_t inWidthStride,
+    const uint8_t *inData,
+    int32_t left,
+    int32_t top,
+    int32_t cropWidth,
+    int32_t cropHeight,
+    int32_t outHeight,
+    int32_t outWidth,
+    int32_t outWidthStride,
+    int32_t outPlaneStride,
+    float *outData,
+    const float *mean,
+    const float *std,
+    bool swapRB)
+{
+    return crop_resize_normalize<uint8_t, float>(
+        inHeight, inWidth, inWidthStride, inData, 4, left, top, cropWidth, cropHeight, outHeight, outWidth, outWidthStride, outPlaneStride, outData, mean, std, swapRB);
+}
+
+template <>
+::ppl::common::RetCode CropResizeNormalize<float, 1, float>(
+    int32_t inHeight,
+    int32_t inWidth,
+    int32_t inWidthStride,
+    const float *inData,
+    int32_t left,
+    int32_t top,
+    int32_t cropWidth,
+    int32_t cropHeight,
+    int32_t outHeight,
+    int32_t outWidth,
+    int32_t outWidthStride,
+    int32_t outPlaneStride,
+    float *outData,
+    const float *mean,
+    const float *std,
+    bool swapRB)
+{
+    return crop_resize_normalize<float, float>(
+        inHeight, inWidth, inWidthStride, inData, 1, left, top, cropWidth, cropHeight, outHeight, outWidth, outWidthStride, outPlaneStride, outData, mean, std, swapRB);
+}
+
+template <>
+::ppl::common::RetCode CropResizeNormalize<float, 3, float>(
+    int32_t inHeight,
+    int32_t inWidth,
+    int32_t inWidthStride,
+    const float *inData,
+    int32_t left,
+    int32_t top,
+    int32_t cropWidth,
+    int32_t cropHeight,
+    int32_t outHeight,
+    int32_t outWidth,
+    int32_t outWidthStride,
+    int32_t outPlaneStride,
+    float *outData,
+    const float *mean,
+    const float *std,
+    bool swapRB)
+{
+    return crop_resize_normalize<float, float>(
+        inHeight, inWidth, inWidthStride, inData, 3, left, top, cropWidth, cropHeight, outHeight, outWidth, outWidthStride, outPlaneStride, outData, mean, std, swapRB);
+}
+
+template <>
+::ppl::common::RetCode CropResizeNormalize<float, 4, float>(
+    int32_t inHeight,
+    int32_t inWidth,
+    int32_t inWidthStride,
+    const float *inData,
+    int32_t left,
+    int32_t top,
+    int32_t cropWidth,
+    int32_t cropHeight,
+    int32_t outHeight,
+    int32_t outWidth,
+    int32_t outWidthStride,
+    int32_t outPlaneStride,
+    float *outData,
+    const float *mean,
+    const float *std,
+    bool swapRB)
+{
+    return crop_resize_normalize<float, float>(
+        inHeight, inWidth, inWidthStride, inData, 4, left, top, cropWidth, cropHeight, outHeight, outWidth, outWidthStride, outPlaneStride, outData, mean, std, swapRB);
+}
+
+template <>
+::ppl::common::RetCode CropResizeNormalize<uint8_t, 1, uint16_t>(
+    int32_t inHeight,
+    int32_t inWidth,
+    int32_t inWidthStride,
+    const uint8_t *inData,
+    int32_t left,
+    int32_t top,
+    int32_t cropWidth,
+    int32_t cropHeight,
+    int32_t outHeight,
+    int32_t outWidth,
+    int32_t outWidthStride,
+    int32_t outPlaneStride,
+    uint16_t *outData,
+    const float *mean,
+    const float *std,
+    bool swapRB)
+{
+    return crop_resize_normalize<uint8_t, uint16_t>(
+        inHeight, inWidth, inWidthStride, inData, 1, left, top, cropWidth, cropHeight, outHeight, outWidth, outWidthStride, outPlaneStride, outData, mean, std, swapRB);
+}
+
+template <>
+::ppl::common::RetCode CropResizeNormalize<uint8_t, 3, uint16_t>(
+    int32_t inHeight,
+    int32_t inWidth,
+    int32_t inWidthStride,
+    const uint8_t *inData,
+    int32_t left,
+    int32_t top,
+    int32_t cropWidth,
+    int32_t cropHeight,
+    int32_t outHeight,
+    int32_t outWidth,
+    int32_t outWidthStride,
+    int32_t outPlaneStride,
+    uint16_t *outData,
+    const float *mean,
+    const float *std,
+    bool swapRB)
+{
+    return crop_resize_normalize<uint8_t, uint16_t>(
+        inHeight, inWidth, inWidthStride, inData, 3, left, top, cropWidth, cropHeight, outHeight, outWidth, outWidthStride, outPlaneStride, outData, mean, std, swapRB);
+}
+
+template <>
+::ppl::common::RetCode CropResizeNormalize<uint8_t, 4, uint16_t>(
+    int32_t inHeight,
+    int32_t inWidth,
+    int32_t inWidthStride,
+    const uint8_t *inData,
+    int32_t left,
+    int32_t top,
+    int32_t cropWidth,
+    int32_t cropHeight,
+    int32_t outHeight,
+    int32_t outWidth,
+    int32_t outWidthStride,
+    int32_t outPlaneStride,
+    uint16_t *outData,
+    const float *mean,
+    const float *std,
+    bool swapRB)
+{
+    return crop_resize_normalize<uint8_t, uint16_t>(
+        inHeight, inWidth, inWidthStride, inData, 4, left, top, cropWidth, cropHeight, outHeight, outWidth, outWidthStride, outPlaneStride, outData, mean, std, swapRB);
+}
+
+template <>
+::ppl::common::RetCode CropResizeNormalize<float, 1, uint16_t>(
+    int32_t inHeight,
+    int32_t inWidth,
+    int32_t inWidthStride,
+    const float *inData,
+    int32_t left,
+    int32_t top,
+    int32_t cropWidth,
+    int32_t cropHeight,
+    int32_t outHeight,
+    int32_t outWidth,
+    int32_t outWidthStride,
+    int32_t outPlaneStride,
+    uint16_t *outData,
+    const float *mean,
+    const float *std,
+    bool swapRB)
+{
+    return crop_resize_normalize<float, uint16_t>(
+        inHeight, inWidth, inWidthStride, inData, 1, left, top, cropWidth, cropHeight, outHeight, outWidth, outWidthStride, outPlaneStride, outData, mean, std, swapRB);
+}
+
+template <>
+::ppl::common::RetCode CropResizeNormalize<float, 3, uint16_t>(
+    int32_t inHeight,
+    int32_t inWidth,
+    int32_t inWidthStride,
+    const float *inData,
+    int32_t left,
+    int32_t top,
+    int32_t cropWidth,
+    int32_t cropHeight,
+    int32_t outHeight,
+    int32_t outWidth,
+    int32_t outWidthStride,
+    int32_t outPlaneStride,
+    uint16_t *outData,
+    const float *mean,
+    const float *std,
+    bool swapRB)
+{
+    return crop_resize_normalize<float, uint16_t>(
+        inHeight, inWidth, inWidthStride, inData, 3, left, top, cropWidth, cropHeight, outHeight, outWidth, outWidthStride, outPlaneStride, outData, mean, std, swapRB);
+}
+
+template <>
+::ppl::common::RetCode CropResizeNormalize<float, 4, uint16_t>(
+    int32_t inHeight,
+    int32_t inWidth,
+    int32_t inWidthStride,
+    const float *inData,
+    int32_t left,
+    int32_t top,
+    int32_t cropWidth,
+    int32_t cropHeight,
+    int32_t outHeight,
+    int32_t outWidth,
+    int32_t outWidthStride,
+    int32_t outPlaneStride,
+    uint16_t *outData,
+    const float *mean,
+    const float *std,
+    bool swapRB)
+{
+    return crop_resize_normalize<float, uint16_t>(
+        inHeight, inWidth, inWidthStride, inData, 4, left, top, cropWidth, cropHeight, outHeight, outWidth, outWidthStride, outPlaneStride, outData, mean, std, swapRB);
+}
+
+}
+}
+} // namespace ppl::cv::x86
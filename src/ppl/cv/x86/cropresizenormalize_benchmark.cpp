@@ -0,0 +1,89 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+#include <benchmark/benchmark.h>
+#include "ppl/cv/x86/cropresizenormalize.h"
+#include <memory>
+#include <vector>
+#include "ppl/cv/debug.h"
+
+namespace {
+
+// A center crop of the shorter side resized to a network input of
+// outSize x outSize.
+template<typename TSrc, int32_t nc, typename TDst>
+void BM_CropResizeNormalize_ppl_x86(benchmark::State &state) {
+    int32_t inWidth = state.range(0);
+    int32_t inHeight = state.range(1);
+    int32_t outSize = state.range(2);
+    int32_t cropSize = inWidth < inHeight ? inWidth : inHeight;
+    int32_t left = (inWidth - cropSize) / 2;
+    int32_t top = (inHeight - cropSize) / 2;
+    int32_t planes = nc == 1 ? 1 : 3;
+    const float mean[3] = {123.675f, 116.28f, 103.53f};
+    const float std[3]  = {58.395f, 57.12f, 57.375f};
+    std::unique_ptr<TSrc[]> src(new TSrc[inWidth * inHeight * nc]);
+    std::unique_ptr<TDst[]> dst(new TDst[outSize * outSize * planes]);
+    ppl::cv::debug::randomFill<TSrc>(src.get(), inWidth * inHeight * nc, 0, 255);
+    for (auto _ : state) {
+        ppl::cv::x86::CropResizeNormalize<TSrc, nc, TDst>(inHeight, inWidth, inWidth * nc, src.get(),
+                                                          left, top, cropSize, cropSize,
+                                                          outSize, outSize, outSize, outSize * outSize, dst.get(),
+                                                          mean, std, true);
+    }
+    state.SetItemsProcessed(state.iterations() * 1);
+}
+
+using namespace ppl::cv::debug;
+BENCHMARK_TEMPLATE(BM_CropResizeNormalize_ppl_x86, uint8_t, c3, float)->Args({1920, 1080, 224})->Args({1920, 1080, 640})->Args({3840, 2160, 1280});
+BENCHMARK_TEMPLATE(BM_CropResizeNormalize_ppl_x86, uint8_t, c4, float)->Args({1920, 1080, 224})->Args({1920, 1080, 640})->Args({3840, 2160, 1280});
+BENCHMARK_TEMPLATE(BM_CropResizeNormalize_ppl_x86, uint8_t, c3, uint16_t)->Args({1920, 1080, 224})->Args({1920, 1080, 640})->Args({3840, 2160, 1280});
+BENCHMARK_TEMPLATE(BM_CropResizeNormalize_ppl_x86, float, c3, float)->Args({1920, 1080, 224})->Args({1920, 1080, 640})->Args({3840, 2160, 1280});
+
+#ifdef PPLCV_BENCHMARK_OPENCV
+// The unfused chain the operator replaces, each step a pass over memory.
+template<typename TSrc, int32_t nc>
+void BM_CropResizeNormalize_opencv_x86(benchmark::State &state) {
+    int32_t inWidth = state.range(0);
+    int32_t inHeight = state.range(1);
+    int32_t outSize = state.range(2);
+    int32_t cropSize = inWidth < inHeight ? inWidth : inHeight;
+    int32_t left = (inWidth - cropSize) / 2;
+    int32_t top = (inHeight - cropSize) / 2;
+    const double mean[3] = {123.675, 116.28, 103.53};
+    const double std[3]  = {58.395, 57.12, 57.375};
+    std::unique_ptr<TSrc[]> src(new TSrc[inWidth * inHeight * nc]);
+    ppl::cv::debug::randomFill<TSrc>(src.get(), inWidth * inHeight * nc, 0, 255);
+    cv::Mat srcMat(inHeight, inWidth, CV_MAKETYPE(cv::DataType<TSrc>::depth, nc), src.get(), sizeof(TSrc) * inWidth * nc);
+    cv::Mat resized, color, converted;
+    std::vector<cv::Mat> planes;
+    for (auto _ : state) {
+        cv::resize(srcMat(cv::Rect(left, top, cropSize, cropSize)), resized, cv::Size(outSize, outSize), 0, 0, cv::INTER_LINEAR);
+        cv::cvtColor(resized, color, nc == 3 ? cv::COLOR_BGR2RGB : cv::COLOR_BGRA2RGB);
+        color.convertTo(converted, CV_32F);
+        cv::split(converted, planes);
+        for (int32_t p = 0; p < 3; ++p) {
+            planes[p].convertTo(planes[p], CV_32F, 1.0 / std[p], -mean[p] / std[p]);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * 1);
+}
+
+BENCHMARK_TEMPLATE(BM_CropResizeNormalize_opencv_x86, uint8_t, c3)->Args({1920, 1080, 224})->Args({1920, 1080, 640})->Args({3840, 2160, 1280});
+BENCHMARK_TEMPLATE(BM_CropResizeNormalize_opencv_x86, uint8_t, c4)->Args({1920, 1080, 224})->Args({1920, 1080, 640})->Args({3840, 2160, 1280});
+BENCHMARK_TEMPLATE(BM_CropResizeNormalize_opencv_x86, float, c3)->Args({1920, 1080, 224})->Args({1920, 1080, 640})->Args({3840, 2160, 1280});
+#endif //! PPLCV_BENCHMARK_OPENCV
+}
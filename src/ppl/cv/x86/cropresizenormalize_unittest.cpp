@@ -0,0 +1,116 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+#include "ppl/cv/x86/cropresizenormalize.h"
+#include "ppl/cv/x86/test.h"
+#include <opencv2/imgproc.hpp>
+#include <memory>
+#include <vector>
+#include <gtest/gtest.h>
+#include "ppl/cv/debug.h"
+#include "ppl/common/retcode.h"
+
+// OpenCV runs the unfused chain: crop, resize, channel swap, convert,
+// normalize and split. A uint8_t pixel resized 1 off by ResizeLinear moves
+// the result by 1 / std.
+template<typename TSrc, int32_t nc, typename TDst>
+void CropResizeNormalizeTest(int32_t inHeight, int32_t inWidth, int32_t left, int32_t top,
+                             int32_t cropWidth, int32_t cropHeight,
+                             int32_t outHeight, int32_t outWidth, bool swapRB, float diff) {
+    const int32_t planes = nc == 1 ? 1 : 3;
+    const float mean[3] = {123.675f, 116.28f, 103.53f};
+    const float std[3]  = {58.395f, 57.12f, 57.375f};
+    std::unique_ptr<TSrc[]> src(new TSrc[inWidth * inHeight * nc]);
+    std::unique_ptr<TDst[]> dst(new TDst[outWidth * outHeight * planes]);
+    ppl::cv::debug::randomFill<TSrc>(src.get(), inWidth * inHeight * nc, 0, 255);
+
+    cv::Mat src_opencv(inHeight, inWidth, CV_MAKETYPE(cv::DataType<TSrc>::depth, nc), src.get(), sizeof(TSrc) * inWidth * nc);
+    cv::Mat resized, color, converted;
+    cv::resize(src_opencv(cv::Rect(left, top, cropWidth, cropHeight)), resized, cv::Size(outWidth, outHeight), 0, 0, cv::INTER_LINEAR);
+    if (nc == 1 || (nc == 3 && !swapRB)) {
+        color = resized;
+    } else if (nc == 3) {
+        cv::cvtColor(resized, color, cv::COLOR_BGR2RGB);
+    } else {
+        cv::cvtColor(resized, color, swapRB ? cv::COLOR_BGRA2RGB : cv::COLOR_BGRA2BGR);
+    }
+    color.convertTo(converted, CV_32F);
+    std::vector<cv::Mat> dst_ref;
+    cv::split(converted, dst_ref);
+
+    auto rst = ppl::cv::x86::CropResizeNormalize<TSrc, nc, TDst>(inHeight, inWidth, inWidth * nc, src.get(),
+                                                                 left, top, cropWidth, cropHeight,
+                                                                 outHeight, outWidth, outWidth, outHeight * outWidth, dst.get(),
+                                                                 mean, std, swapRB);
+    EXPECT_EQ(rst, ppl::common::RC_SUCCESS);
+
+    for (int32_t p = 0; p < planes; ++p) {
+        cv::Mat expected = (dst_ref[p] - mean[p]) / std[p];
+        cv::Mat plane(outHeight, outWidth, CV_MAKETYPE(sizeof(TDst) == 2 ? CV_16F : CV_32F, 1), dst.get() + p * outHeight * outWidth);
+        cv::Mat result;
+        plane.convertTo(result, CV_32F);
+        checkResult<float, 1>(expected.ptr<float>(), result.ptr<float>(),
+                              outHeight, outWidth,
+                              outWidth, outWidth,
+                              diff);
+    }
+}
+
+TEST(CROP_RESIZE_NORMALIZE_UINT8, x86)
+{
+    CropResizeNormalizeTest<uint8_t, 1, float>(480, 640, 17, 9, 600, 420, 224, 224, false, 0.02f);
+    CropResizeNormalizeTest<uint8_t, 3, float>(480, 640, 17, 9, 600, 420, 224, 224, true, 0.02f);
+    CropResizeNormalizeTest<uint8_t, 3, float>(720, 1080, 0, 0, 1080, 720, 360, 540, false, 0.02f);
+    CropResizeNormalizeTest<uint8_t, 3, float>(720, 1080, 180, 0, 720, 720, 800, 800, true, 0.02f);
+    CropResizeNormalizeTest<uint8_t, 4, float>(480, 640, 17, 9, 600, 420, 224, 224, true, 0.02f);
+    CropResizeNormalizeTest<uint8_t, 4, float>(720, 1080, 0, 0, 1080, 720, 360, 540, false, 0.02f);
+
+    CropResizeNormalizeTest<uint8_t, 1, uint16_t>(480, 640, 17, 9, 600, 420, 224, 224, false, 0.02f);
+    CropResizeNormalizeTest<uint8_t, 3, uint16_t>(720, 1080, 180, 0, 720, 720, 320, 320, true, 0.02f);
+    CropResizeNormalizeTest<uint8_t, 4, uint16_t>(480, 640, 17, 9, 600, 420, 224, 224, true, 0.02f);
+}
+
+TEST(CROP_RESIZE_NORMALIZE_FP32, x86)
+{
+    CropResizeNormalizeTest<float, 1, float>(480, 640, 17, 9, 600, 420, 224, 224, false, 1e-4f);
+    CropResizeNormalizeTest<float, 3, float>(480, 640, 17, 9, 600, 420, 224, 224, true, 1e-4f);
+    CropResizeNormalizeTest<float, 3, float>(720, 1080, 0, 0, 1080, 720, 360, 540, false, 1e-4f);
+    CropResizeNormalizeTest<float, 3, float>(720, 1080, 180, 0, 720, 720, 800, 800, true, 1e-4f);
+    CropResizeNormalizeTest<float, 4, float>(480, 640, 17, 9, 600, 420, 224, 224, true, 1e-4f);
+    CropResizeNormalizeTest<float, 4, float>(720, 1080, 0, 0, 1080, 720, 360, 540, false, 1e-4f);
+
+    CropResizeNormalizeTest<float, 1, uint16_t>(480, 640, 17, 9, 600, 420, 224, 224, false, 2e-3f);
+    CropResizeNormalizeTest<float, 3, uint16_t>(720, 1080, 180, 0, 720, 720, 320, 320, true, 2e-3f);
+    CropResizeNormalizeTest<float, 4, uint16_t>(480, 640, 17, 9, 600, 420, 224, 224, true, 2e-3f);
+}
+
+TEST(CROP_RESIZE_NORMALIZE_INVALID, x86)
+{
+    const float mean[3] = {0.f, 0.f, 0.f};
+    const float std[3]  = {1.f, 0.f, 1.f};
+    const float ones[3] = {1.f, 1.f, 1.f};
+    std::unique_ptr<uint8_t[]> src(new uint8_t[64 * 64 * 3]);
+    std::unique_ptr<float[]> dst(new float[32 * 32 * 3]);
+    // the region leaves the image
+    EXPECT_EQ((ppl::cv::x86::CropResizeNormalize<uint8_t, 3, float>(64, 64, 64 * 3, src.get(), 40, 0, 32, 32, 32, 32, 32, 32 * 32, dst.get(), mean, ones, false)),
+              ppl::common::RC_INVALID_VALUE);
+    // the planes overlap
+    EXPECT_EQ((ppl::cv::x86::CropResizeNormalize<uint8_t, 3, float>(64, 64, 64 * 3, src.get(), 0, 0, 32, 32, 32, 32, 32, 32 * 31, dst.get(), mean, ones, false)),
+              ppl::common::RC_INVALID_VALUE);
+    // a zero std
+    EXPECT_EQ((ppl::cv::x86::CropResizeNormalize<uint8_t, 3, float>(64, 64, 64 * 3, src.get(), 0, 0, 32, 32, 32, 32, 32, 32 * 32, dst.get(), mean, std, false)),
+              ppl::common::RC_INVALID_VALUE);
+}
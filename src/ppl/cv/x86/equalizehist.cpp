@@ -16,24 +16,82 @@
 // under the License.
 
 #include "ppl/cv/x86/equalizehist.h"
+#include "ppl/cv/x86/calchist.h"
+#include "ppl/cv/x86/parallel.hpp"
+#include "ppl/cv/x86/fma/internal_fma.hpp"
 #include "ppl/cv/types.h"
 #include "ppl/common/sys.h"
+#include "ppl/common/x86/sysinfo.h"
+#include "ppl/cv/x86/isa.hpp"
 #include "ppl/common/log.h"
 #include <string.h>
 #include <cmath>
 #include <algorithm>
+#include <smmintrin.h>
 
 namespace ppl {
 namespace cv {
 namespace x86 {
 
+// Table lookup on 16 pixels per step: pshufb reads the 16 sub-tables of the
+// LUT with the low nibble of the index, then a blend tree keyed on bits 4..7
+// of the index picks the sub-table.
+static void equalizehist_lut_u8(
+    int32_t width,
+    const uint8_t* in,
+    const uint8_t* lut,
+    uint8_t* out)
+{
+    int32_t w = 0;
+    if (isa_supported(ppl::common::ISA_X86_FMA)) {
+        w = fma::equalizehist_lut_u8_fma(width, in, lut, out);
+    }
+
+    if (w <= width - 16) {
+        __m128i v_lut[16];
+        for (int32_t i = 0; i < 16; ++i) {
+            v_lut[i] = _mm_loadu_si128((const __m128i*)(lut + i * 16));
+        }
+        const __m128i v_low = _mm_set1_epi8(0x0F);
+        for (; w <= width - 16; w += 16) {
+            __m128i v_idx = _mm_loadu_si128((const __m128i*)(in + w));
+            __m128i v_lo  = _mm_and_si128(v_idx, v_low);
+            // blendv only looks at the top bit of each byte, so shifting the
+            // 16-bit lanes left moves index bit 4, 5, 6 into that position
+            __m128i v_b4 = _mm_slli_epi16(v_idx, 3);
+            __m128i v_b5 = _mm_slli_epi16(v_idx, 2);
+            __m128i v_b6 = _mm_slli_epi16(v_idx, 1);
+            __m128i v_sel[2];
+            for (int32_t i = 0; i < 2; ++i) {
+                __m128i v_q[2];
+                for (int32_t j = 0; j < 2; ++j) {
+                    __m128i v_p[2];
+                    for (int32_t k = 0; k < 2; ++k) {
+                        int32_t t = ((i * 2 + j) * 2 + k) * 2;
+                        v_p[k]    = _mm_blendv_epi8(_mm_shuffle_epi8(v_lut[t], v_lo),
+                                                    _mm_shuffle_epi8(v_lut[t + 1], v_lo),
+                                                    v_b4);
+                    }
+                    v_q[j] = _mm_blendv_epi8(v_p[0], v_p[1], v_b5);
+                }
+                v_sel[i] = _mm_blendv_epi8(v_q[0], v_q[1], v_b6);
+            }
+            _mm_storeu_si128((__m128i*)(out + w), _mm_blendv_epi8(v_sel[0], v_sel[1], v_idx));
+        }
+    }
+    for (; w < width; ++w) {
+        out[w] = lut[in[w]];
+    }
+}
+
 ::ppl::common::RetCode EqualizeHist(
     int32_t inHeight,
     int32_t inWidth,
     int32_t inWidthStride,
     const uint8_t* inData,
     int32_t outWidthStride,
-    uint8_t* outData)
+    uint8_t* outData,
+    const int32_t* inHist)
 {
     if (nullptr == inData || nullptr == outData) {
         return ppl::common::RC_INVALID_VALUE;
@@ -42,42 +100,61 @@ namespace x86 {
         return ppl::common::RC_INVALID_VALUE;
     }
     const int32_t hist_sz = 256;
-    int32_t hist[hist_sz] = {
-        0,
-    };
-    int32_t lut[hist_sz];
+    int32_t hist[hist_sz];
+    uint8_t lut[hist_sz];
 
-    for (int32_t h = 0; h < inHeight; ++h)
-        for (int32_t w = 0; w < inWidth; ++w) {
-            int32_t inIdx = h * inWidthStride + w;
-            int32_t value = inData[inIdx];
-            hist[value]++;
-        }
+    if (nullptr == inHist) {
+        CalcHist<uint8_t>(inHeight, inWidth, inWidthStride, inData, hist);
+        inHist = hist;
+    }
+
+    int64_t total = 0;
+    for (int32_t i = 0; i < hist_sz; ++i) {
+        total += inHist[i];
+    }
+    if (total <= 0) {
+        return ppl::common::RC_INVALID_VALUE;
+    }
 
     int32_t i = 0;
-    while (!hist[i])
+    while (!inHist[i])
         ++i;
 
-    int32_t total = inHeight * inWidth;
-    float scale   = (hist_sz - 1.f) / (total - hist[i]);
-
-    int32_t sum = 0;
-    for (lut[i++] = 0; i < hist_sz; ++i) {
-        sum += hist[i];
-        lut[i] = std::round(sum * scale);
+    if (inHist[i] == total) {
+        // a single-valued image is mapped onto itself
+        memset(lut, i, sizeof(lut));
+    } else {
+        float scale = (hist_sz - 1.f) / (total - inHist[i]);
+        int64_t sum = 0;
+        memset(lut, 0, sizeof(lut));
+        for (++i; i < hist_sz; ++i) {
+            sum += inHist[i];
+            lut[i] = (uint8_t)std::min<float>(std::round(sum * scale), 255.f);
+        }
     }
 
-    for (int32_t h = 0; h < inHeight; ++h) {
-        for (int32_t w = 0; w < inWidth; ++w) {
-            int32_t inIdx   = h * inWidthStride + w;
-            int32_t outIdx  = h * outWidthStride + w;
-            int32_t value   = inData[inIdx];
-            outData[outIdx] = lut[value];
+    parallel_for_rows(inHeight, inWidth, [&](int32_t begin, int32_t end) {
+        for (int32_t h = begin; h < end; ++h) {
+            equalizehist_lut_u8(inWidth,
+                                inData + (int64_t)h * inWidthStride,
+                                lut,
+                                outData + (int64_t)h * outWidthStride);
         }
-    }
+    });
     return ppl::common::RC_SUCCESS;
 }
 
+::ppl::common::RetCode EqualizeHist(
+    int32_t inHeight,
+    int32_t inWidth,
+    int32_t inWidthStride,
+    const uint8_t* inData,
+    int32_t outWidthStride,
+    uint8_t* outData)
+{
+    return EqualizeHist(inHeight, inWidth, inWidthStride, inData, outWidthStride, outData, nullptr);
+}
+
 }
 }
 } // namespace ppl::cv::x86
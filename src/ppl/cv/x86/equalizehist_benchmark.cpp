@@ -16,6 +16,7 @@
 // under the License.
 
 #include "ppl/cv/x86/equalizehist.h"
+#include "ppl/cv/x86/calchist.h"
 #include "ppl/cv/types.h"
 #include "ppl/cv/debug.h"
 #include <memory>
@@ -23,30 +24,79 @@
 
 namespace {
 
+// A synthetic "natural" image: a flat background covering most of the frame,
+// a smooth gradient object in the middle and a little sensor noise. Long runs
+// of one value are what make scalar histograms stall.
+void fillNaturalImage(uint8_t *data, int height, int width)
+{
+    uint8_t noise[64];
+    ppl::cv::debug::randomFill<uint8_t>(noise, 64, 0, 3);
+    for (int i = 0; i < height; ++i) {
+        for (int j = 0; j < width; ++j) {
+            bool object = i > height / 4 && i < height * 3 / 4 && j > width / 3 && j < width * 2 / 3;
+            int value = object ? 40 + (i + j) * 160 / (height + width) : 235;
+            data[i * width + j] = value + (((i * 7 + j * 13) & 63) < 8 ? noise[(i + j) & 63] : 0);
+        }
+    }
+}
+
+template<bool natural>
 void BM_EqualizeHist_ppl_x86(benchmark::State &state) {
     int32_t width = state.range(0);
     int32_t height = state.range(1);
     std::unique_ptr<uint8_t[]> src(new uint8_t[width * height]);
     std::unique_ptr<uint8_t[]> dst(new uint8_t[width * height]);
-    ppl::cv::debug::randomFill<uint8_t>(src.get(), width * height, 0, 255);
+    if (natural) {
+        fillNaturalImage(src.get(), height, width);
+    } else {
+        ppl::cv::debug::randomFill<uint8_t>(src.get(), width * height, 0, 255);
+    }
     for (auto _ : state) {
         ppl::cv::x86::EqualizeHist(height, width, width, src.get(), width, dst.get());
     }
     state.SetItemsProcessed(state.iterations() * 1);
 }
 
+// the histogram is already known, e.g. from CalcHist for another purpose
+template<bool natural>
+void BM_EqualizeHistWithHist_ppl_x86(benchmark::State &state) {
+    int32_t width = state.range(0);
+    int32_t height = state.range(1);
+    std::unique_ptr<uint8_t[]> src(new uint8_t[width * height]);
+    std::unique_ptr<uint8_t[]> dst(new uint8_t[width * height]);
+    int32_t hist[256];
+    if (natural) {
+        fillNaturalImage(src.get(), height, width);
+    } else {
+        ppl::cv::debug::randomFill<uint8_t>(src.get(), width * height, 0, 255);
+    }
+    ppl::cv::x86::CalcHist<uint8_t>(height, width, width, src.get(), hist);
+    for (auto _ : state) {
+        ppl::cv::x86::EqualizeHist(height, width, width, src.get(), width, dst.get(), hist);
+    }
+    state.SetItemsProcessed(state.iterations() * 1);
+}
+
 using namespace ppl::cv::debug;
 
-BENCHMARK(BM_EqualizeHist_ppl_x86)->Args({320, 240})->Args({640, 480})->Args({1280, 720})->Args({1920, 1080})->Args({3840, 2160});
+BENCHMARK_TEMPLATE(BM_EqualizeHist_ppl_x86, false)->Args({320, 240})->Args({640, 480})->Args({1280, 720})->Args({1920, 1080})->Args({3840, 2160});
+BENCHMARK_TEMPLATE(BM_EqualizeHist_ppl_x86, true)->Args({320, 240})->Args({640, 480})->Args({1280, 720})->Args({1920, 1080})->Args({3840, 2160});
+BENCHMARK_TEMPLATE(BM_EqualizeHistWithHist_ppl_x86, false)->Args({320, 240})->Args({640, 480})->Args({1280, 720})->Args({1920, 1080})->Args({3840, 2160});
+BENCHMARK_TEMPLATE(BM_EqualizeHistWithHist_ppl_x86, true)->Args({320, 240})->Args({640, 480})->Args({1280, 720})->Args({1920, 1080})->Args({3840, 2160});
 
 #ifdef PPLCV_BENCHMARK_OPENCV
+template<bool natural>
 static void BM_EqualizeHist_opencv_x86(benchmark::State &state)
 {
     int32_t width = state.range(0);
     int32_t height = state.range(1);
     std::unique_ptr<uint8_t[]> src(new uint8_t[width * height]);
     std::unique_ptr<uint8_t[]> dst(new uint8_t[width * height]);
-    ppl::cv::debug::randomFill<uint8_t>(src.get(), width * height, 0, 255);
+    if (natural) {
+        fillNaturalImage(src.get(), height, width);
+    } else {
+        ppl::cv::debug::randomFill<uint8_t>(src.get(), width * height, 0, 255);
+    }
     cv::Mat srcMat(height, width, CV_MAKETYPE(cv::DataType<uint8_t>::depth, 1), src.get());
     cv::Mat dstMat(height, width, CV_MAKETYPE(cv::DataType<uint8_t>::depth, 1), dst.get());
     for (auto _ : state) {
@@ -55,7 +105,8 @@ static void BM_EqualizeHist_opencv_x86(benchmark::State &state)
     state.SetItemsProcessed(state.iterations() * 1);
 }
 
-BENCHMARK(BM_EqualizeHist_opencv_x86)->Args({320, 240})->Args({640, 480})->Args({1280, 720})->Args({1920, 1080})->Args({3840, 2160});
+BENCHMARK_TEMPLATE(BM_EqualizeHist_opencv_x86, false)->Args({320, 240})->Args({640, 480})->Args({1280, 720})->Args({1920, 1080})->Args({3840, 2160});
+BENCHMARK_TEMPLATE(BM_EqualizeHist_opencv_x86, true)->Args({320, 240})->Args({640, 480})->Args({1280, 720})->Args({1920, 1080})->Args({3840, 2160});
 
 #endif //! PPLCV_BENCHMARK_OPENCV
 }
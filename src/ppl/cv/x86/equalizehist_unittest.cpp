@@ -16,22 +16,29 @@
 // under the License.
 
 #include "ppl/cv/x86/equalizehist.h"
+#include "ppl/cv/x86/calchist.h"
 #include "ppl/cv/x86/test.h"
 #include <memory>
 #include <gtest/gtest.h>
 #include "ppl/cv/debug.h"
 #include <opencv2/imgproc.hpp>
 
-void EqualizeHistTest(int32_t height, int32_t width) {
+void EqualizeHistTest(int32_t height, int32_t width, uint8_t min = 0, uint8_t max = 255) {
     std::unique_ptr<uint8_t[]> src(new uint8_t[width * height]);
     std::unique_ptr<uint8_t[]> dst_ref(new uint8_t[width * height]);
     std::unique_ptr<uint8_t[]> dst(new uint8_t[width * height]);
-    ppl::cv::debug::randomFill<uint8_t>(src.get(), width * height, 0, 255);
+    ppl::cv::debug::randomFill<uint8_t>(src.get(), width * height, min, max);
     cv::Mat srcMat(height, width, CV_MAKETYPE(cv::DataType<uint8_t>::depth, 1), src.get());
     cv::Mat dstMat(height, width, CV_MAKETYPE(cv::DataType<uint8_t>::depth, 1), dst_ref.get());
     cv::equalizeHist(srcMat, dstMat);
     ppl::cv::x86::EqualizeHist(height, width, width, src.get(), width, dst.get());
     checkResult<uint8_t, 1>(dst.get(), dst_ref.get(), height, width, width, width, 1.01f);
+
+    // with the histogram from CalcHist
+    int32_t hist[256];
+    ppl::cv::x86::CalcHist<uint8_t>(height, width, width, src.get(), hist);
+    ppl::cv::x86::EqualizeHist(height, width, width, src.get(), width, dst.get(), hist);
+    checkResult<uint8_t, 1>(dst.get(), dst_ref.get(), height, width, width, width, 1.01f);
 }
 
 TEST(EqualizeHist_UINT8, x86)
@@ -41,3 +48,16 @@ TEST(EqualizeHist_UINT8, x86)
     EqualizeHistTest(1080, 1920);
 }
 
+TEST(EqualizeHist_UINT8_ODD_SIZE, x86)
+{
+    EqualizeHistTest(1, 1);
+    EqualizeHistTest(7, 13);
+    EqualizeHistTest(481, 643);
+}
+
+TEST(EqualizeHist_UINT8_NARROW_RANGE, x86)
+{
+    EqualizeHistTest(480, 640, 100, 100);
+    EqualizeHistTest(480, 640, 100, 103);
+}
+
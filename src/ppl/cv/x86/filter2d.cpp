@@ -17,11 +17,13 @@
 
 #include "ppl/cv/x86/filter2d.h"
 #include "ppl/cv/x86/fma/internal_fma.hpp"
+#include "ppl/cv/x86/avx512/internal_avx512.hpp"
 #include "ppl/cv/x86/copymakeborder.h"
 #include "ppl/cv/types.h"
 #include "ppl/cv/x86/util.hpp"
 #include "ppl/common/sys.h"
 #include "ppl/common/x86/sysinfo.h"
+#include "ppl/cv/x86/isa.hpp"
 #include <string.h>
 #include <cmath>
 #include <limits.h>
@@ -43,6 +45,14 @@ static uint8_t sat_cast(int32_t data)
     return (uint8_t)val;
 }
 
+// The FMA kernels read the border from the image rows themselves, so they
+// can't do BORDER_CONSTANT and need an image at least as large as the kernel.
+// Other cases are filtered on a bordered copy of the image.
+static bool fma_filter2d_supported(int32_t height, int32_t width, int32_t kernel_len, BorderType border_type)
+{
+    return border_type != ppl::cv::BORDER_CONSTANT && height >= kernel_len && width >= kernel_len;
+}
+
 void convolution_b(
     int32_t imageInSizeX,
     int32_t imageInSizeY,
@@ -175,9 +185,14 @@ template <>
     int32_t bsrcWidth  = width + 2 * radius;
     int32_t cn         = 1;
 
+    if (isa_supported(ppl::common::ISA_X86_AVX512)) {
+        avx512::convolution_f(height, width, inWidthStride, inData, kernel_len, filter, outWidthStride, outData, cn, border_type);
+        return ppl::common::RC_SUCCESS;
+    }
+
     int32_t bsrcWidthStep = (bsrcWidth)*cn;
     float *bsrc           = (float *)malloc(bsrcHeight * bsrcWidth * cn * sizeof(float));
-    if (ppl::common::CpuSupports(ppl::common::ISA_X86_FMA)) {
+    if (isa_supported(ppl::common::ISA_X86_FMA) && fma_filter2d_supported(height, width, kernel_len, border_type)) {
         if (kernel_len == 5)
             fma::convolution_f<5>(bsrcWidth, bsrcHeight, bsrcWidthStep, bsrc, filter, outWidthStride, outData, cn, inData, height, width, inWidthStride, border_type);
         else if (kernel_len == 7)
@@ -220,10 +235,15 @@ template <>
     int32_t bsrcWidth  = width + 2 * radius;
     int32_t cn         = 3;
 
+    if (isa_supported(ppl::common::ISA_X86_AVX512)) {
+        avx512::convolution_f(height, width, inWidthStride, inData, kernel_len, filter, outWidthStride, outData, cn, border_type);
+        return ppl::common::RC_SUCCESS;
+    }
+
     int32_t bsrcWidthStep = (bsrcWidth)*cn;
     float *bsrc           = (float *)malloc(bsrcHeight * bsrcWidth * cn * sizeof(float));
 
-    if (ppl::common::CpuSupports(ppl::common::ISA_X86_FMA)) {
+    if (isa_supported(ppl::common::ISA_X86_FMA) && fma_filter2d_supported(height, width, kernel_len, border_type)) {
         if (kernel_len == 5)
             fma::convolution_f<5>(bsrcWidth, bsrcHeight, bsrcWidthStep, bsrc, filter, outWidthStride, outData, cn, inData, height, width, inWidthStride, border_type);
         else if (kernel_len == 7)
@@ -266,10 +286,15 @@ template <>
     int32_t bsrcWidth  = width + 2 * radius;
     int32_t cn         = 4;
 
+    if (isa_supported(ppl::common::ISA_X86_AVX512)) {
+        avx512::convolution_f(height, width, inWidthStride, inData, kernel_len, filter, outWidthStride, outData, cn, border_type);
+        return ppl::common::RC_SUCCESS;
+    }
+
     int32_t bsrcWidthStep = (bsrcWidth)*cn;
     float *bsrc           = (float *)malloc(bsrcHeight * bsrcWidth * cn * sizeof(float));
 
-    if (ppl::common::CpuSupports(ppl::common::ISA_X86_FMA)) {
+    if (isa_supported(ppl::common::ISA_X86_FMA) && fma_filter2d_supported(height, width, kernel_len, border_type)) {
         if (kernel_len == 5)
             fma::convolution_f<5>(bsrcWidth, bsrcHeight, bsrcWidthStep, bsrc, filter, outWidthStride, outData, cn, inData, height, width, inWidthStride, border_type);
         else if (kernel_len == 7)
@@ -312,10 +337,15 @@ template <>
     int32_t bsrcWidth  = width + 2 * radius;
     int32_t cn         = 1;
 
+    if (isa_supported(ppl::common::ISA_X86_AVX512)) {
+        avx512::convolution_b(height, width, inWidthStride, inData, kernel_len, filter, outWidthStride, outData, cn, border_type);
+        return ppl::common::RC_SUCCESS;
+    }
+
     int32_t bsrcWidthStep = (bsrcWidth)*cn;
     uint8_t *bsrc         = (uint8_t *)malloc(bsrcHeight * bsrcWidth * cn * sizeof(uint8_t));
 
-    if (ppl::common::CpuSupports(ppl::common::ISA_X86_FMA)) {
+    if (isa_supported(ppl::common::ISA_X86_FMA) && fma_filter2d_supported(height, width, kernel_len, border_type)) {
         if (kernel_len == 5)
             fma::convolution_b<5>(bsrcWidth, bsrcHeight, bsrcWidthStep, bsrc, filter, outWidthStride, outData, cn, inData, height, width, inWidthStride, border_type);
         else if (kernel_len == 7)
@@ -356,10 +386,14 @@ template <>
     int32_t bsrcHeight    = height + 2 * radius;
     int32_t bsrcWidth     = width + 2 * radius;
     int32_t cn            = 3;
+    if (isa_supported(ppl::common::ISA_X86_AVX512)) {
+        avx512::convolution_b(height, width, inWidthStride, inData, kernel_len, filter, outWidthStride, outData, cn, border_type);
+        return ppl::common::RC_SUCCESS;
+    }
     int32_t bsrcWidthStep = (bsrcWidth)*cn;
     uint8_t *bsrc         = (uint8_t *)malloc(bsrcHeight * bsrcWidth * cn * sizeof(uint8_t));
 
-    if (ppl::common::CpuSupports(ppl::common::ISA_X86_FMA)) {
+    if (isa_supported(ppl::common::ISA_X86_FMA) && fma_filter2d_supported(height, width, kernel_len, border_type)) {
         if (kernel_len == 5)
             fma::convolution_b<5>(bsrcWidth, bsrcHeight, bsrcWidthStep, bsrc, filter, outWidthStride, outData, cn, inData, height, width, inWidthStride, border_type);
         else if (kernel_len == 7)
@@ -402,10 +436,15 @@ template <>
     int32_t bsrcWidth  = width + 2 * radius;
     int32_t cn         = 4;
 
+    if (isa_supported(ppl::common::ISA_X86_AVX512)) {
+        avx512::convolution_b(height, width, inWidthStride, inData, kernel_len, filter, outWidthStride, outData, cn, border_type);
+        return ppl::common::RC_SUCCESS;
+    }
+
     int32_t bsrcWidthStep = (bsrcWidth)*cn;
     uint8_t *bsrc         = (uint8_t *)malloc(bsrcHeight * bsrcWidth * cn * sizeof(uint8_t));
 
-    if (ppl::common::CpuSupports(ppl::common::ISA_X86_FMA)) {
+    if (isa_supported(ppl::common::ISA_X86_FMA) && fma_filter2d_supported(height, width, kernel_len, border_type)) {
         if (kernel_len == 5)
             fma::convolution_b<5>(bsrcWidth, bsrcHeight, bsrcWidthStep, bsrc, filter, outWidthStride, outData, cn, inData, height, width, inWidthStride, border_type);
         else if (kernel_len == 7)
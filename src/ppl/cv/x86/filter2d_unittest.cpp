@@ -16,7 +16,9 @@
 // under the License.
 
 #include "ppl/cv/x86/filter2d.h"
+#include "ppl/cv/x86/isa.h"
 #include "ppl/cv/x86/test.h"
+#include "ppl/common/x86/sysinfo.h"
 #include <memory>
 #include <gtest/gtest.h>
 #include "ppl/cv/debug.h"
@@ -60,3 +62,60 @@ TEST(FILTER2D_UINT8, x86)
     Filter2DTest<uint8_t, 3, 5>(720, 1080, 2.0);
     Filter2DTest<uint8_t, 3, 7>(720, 1080, 2.0);
 }
+
+// Every tier SetIsaMask() can pin, AVX-512, FMA and SSE, gives the result of
+// OpenCV, for every border and for images smaller than the kernel.
+template<typename T, int32_t nc, int32_t filter_size>
+void Filter2DIsaTest(int32_t height, int32_t width, ppl::cv::BorderType border_type, float diff) {
+    std::unique_ptr<T[]> src(new T[width * height * nc]);
+    std::unique_ptr<T[]> dst_ref(new T[width * height * nc]);
+    std::unique_ptr<T[]> dst(new T[width * height * nc]);
+    std::unique_ptr<float[]> filter(new float[filter_size * filter_size]);
+    ppl::cv::debug::randomFill<T>(src.get(), width * height * nc, 0, 255);
+    ppl::cv::debug::randomFill<float>(filter.get(), filter_size * filter_size, 0, 1.0 / (filter_size * filter_size));
+
+    cv::Mat src_opencv(height, width, CV_MAKETYPE(cv::DataType<T>::depth, nc), src.get(), sizeof(T) * width * nc);
+    cv::Mat dst_opencv(height, width, CV_MAKETYPE(cv::DataType<T>::depth, nc), dst_ref.get(), sizeof(T) * width * nc);
+    cv::Mat filter_opencv(filter_size, filter_size, CV_32FC1, filter.get());
+    cv::filter2D(src_opencv, dst_opencv, -1, filter_opencv, cv::Point(-1, -1), 0, (int)border_type);
+
+    const uint32_t masks[] = {0xffffffffu, ~(uint32_t)ppl::common::ISA_X86_AVX512, (uint32_t)ppl::common::ISA_X86_SSE41};
+    for (uint32_t mask : masks) {
+        ppl::cv::x86::SetIsaMask(mask);
+        ppl::cv::x86::Filter2D<T, nc>(height, width, width * nc,
+                                src.get(), filter_size, filter.get(), width * nc,
+                                dst.get(), border_type);
+        checkResult<T, nc>(dst_ref.get(), dst.get(),
+                        height, width,
+                        width * nc, width * nc,
+                        diff);
+    }
+    ppl::cv::x86::SetIsaMask(0xffffffffu);
+}
+
+template<typename T, int32_t nc>
+void Filter2DIsaTests(float diff) {
+    const ppl::cv::BorderType border_types[] = {ppl::cv::BORDER_REFLECT_101, ppl::cv::BORDER_REFLECT,
+                                                ppl::cv::BORDER_REPLICATE, ppl::cv::BORDER_CONSTANT};
+    for (ppl::cv::BorderType border_type : border_types) {
+        Filter2DIsaTest<T, nc, 3>(241, 321, border_type, diff);
+        Filter2DIsaTest<T, nc, 5>(241, 321, border_type, diff);
+        Filter2DIsaTest<T, nc, 7>(241, 321, border_type, diff);
+        Filter2DIsaTest<T, nc, 9>(241, 321, border_type, diff);
+        Filter2DIsaTest<T, nc, 7>(5, 4, border_type, diff);
+    }
+}
+
+TEST(FILTER2D_ISA_FP32, x86)
+{
+    Filter2DIsaTests<float, 1>(1e-3f);
+    Filter2DIsaTests<float, 3>(1e-3f);
+    Filter2DIsaTests<float, 4>(1e-3f);
+}
+
+TEST(FILTER2D_ISA_UINT8, x86)
+{
+    Filter2DIsaTests<uint8_t, 1>(1.01f);
+    Filter2DIsaTests<uint8_t, 3>(1.01f);
+    Filter2DIsaTests<uint8_t, 4>(1.01f);
+}
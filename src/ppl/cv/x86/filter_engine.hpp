@@ -0,0 +1,325 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#ifndef PPL_CV_X86_FILTER_ENGINE_HPP_
+#define PPL_CV_X86_FILTER_ENGINE_HPP_
+
+#include "ppl/cv/types.h"
+#include "ppl/common/sys.h"
+#include "ppl/cv/x86/parallel.hpp"
+
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+
+namespace ppl {
+namespace cv {
+namespace x86 {
+
+// Output rows handed to a column filter per call. A band keeps the filtered
+// rows of kHeight + FILTER_ENGINE_CHUNK_ROWS - 1 source rows, which stays in
+// L2 for the widths the filters see.
+#define FILTER_ENGINE_CHUNK_ROWS 8
+#define FILTER_ENGINE_ROW_ALIGN  64
+
+// Index of the pixel that stands for pixel p of a line of len pixels,
+// -1 when it is the border value of BORDER_CONSTANT.
+inline int32_t border_interpolate(int32_t p, int32_t len, BorderType border_type)
+{
+    if ((uint32_t)p < (uint32_t)len) {
+        return p;
+    }
+    if (border_type == ppl::cv::BORDER_CONSTANT) {
+        return -1;
+    }
+    if (border_type == ppl::cv::BORDER_REPLICATE) {
+        return p < 0 ? 0 : len - 1;
+    }
+    if (border_type == ppl::cv::BORDER_WRAP) {
+        p %= len;
+        return p < 0 ? p + len : p;
+    }
+    if (len == 1) {
+        return 0;
+    }
+    int32_t delta = border_type == ppl::cv::BORDER_REFLECT_101;
+    do {
+        p = p < 0 ? -p - 1 + delta : 2 * len - p - 1 - delta;
+    } while ((uint32_t)p >= (uint32_t)len);
+    return p;
+}
+
+inline bool filter_border_supported(BorderType border_type)
+{
+    return border_type == ppl::cv::BORDER_CONSTANT ||
+           border_type == ppl::cv::BORDER_REPLICATE ||
+           border_type == ppl::cv::BORDER_REFLECT ||
+           border_type == ppl::cv::BORDER_WRAP ||
+           border_type == ppl::cv::BORDER_REFLECT_101;
+}
+
+// Copies source rows into a row extended by kWidth / 2 pixels on the left and
+// (kWidth - 1) / 2 on the right, which is what the row filters read.
+template <typename T>
+class FilterRowBorder {
+public:
+    FilterRowBorder(int32_t width, int32_t channels, int32_t kWidth, BorderType border_type, T border_value)
+        : width(width)
+        , channels(channels)
+        , left(kWidth / 2)
+        , right(kWidth - 1 - kWidth / 2)
+        , border_value(border_value)
+        , tab((left + right) * channels)
+    {
+        for (int32_t i = 0; i < left + right; i++) {
+            int32_t x  = i < left ? i - left : width + i - left;
+            int32_t sx = border_interpolate(x, width, border_type);
+            for (int32_t c = 0; c < channels; c++) {
+                tab[i * channels + c] = sx < 0 ? -1 : sx * channels + c;
+            }
+        }
+    }
+
+    int32_t padded_width() const
+    {
+        return width + left + right;
+    }
+
+    void operator()(const T *src, T *row) const
+    {
+        memcpy(row + left * channels, src, width * channels * sizeof(T));
+        T *right_row = row + (width + left) * channels;
+        for (int32_t i = 0; i < left * channels; i++) {
+            row[i] = tab[i] < 0 ? border_value : src[tab[i]];
+        }
+        for (int32_t i = 0; i < right * channels; i++) {
+            int32_t j    = tab[left * channels + i];
+            right_row[i] = j < 0 ? border_value : src[j];
+        }
+    }
+
+    void fill(T *row) const
+    {
+        std::fill(row, row + padded_width() * channels, border_value);
+    }
+
+private:
+    int32_t width;
+    int32_t channels;
+    int32_t left;
+    int32_t right;
+    T border_value;
+    std::vector<int32_t> tab;
+};
+
+// Streams the rows of one band through a ring of kHeight + chunk - 1 rows.
+// make_row(sy, row) fills the ring row of source row sy, const_row stands for
+// the rows of BORDER_CONSTANT outside the image, and consume(rows, y, count)
+// gets output rows y .. y + count - 1 with rows[0] the top of the window of
+// row y. Every band fills its own ring, from kHeight / 2 rows above its first
+// row, so bands never wait for each other.
+template <typename MT, typename MakeRow, typename Consume>
+void filter_engine_band(
+    int32_t height,
+    int32_t kHeight,
+    BorderType border_type,
+    int32_t begin,
+    int32_t end,
+    MT *ring,
+    int32_t ring_step,
+    const MT *const_row,
+    const MT **rows,
+    const MakeRow &make_row,
+    Consume &consume)
+{
+    const int32_t ring_rows = kHeight + FILTER_ENGINE_CHUNK_ROWS - 1;
+    const int32_t anchor    = kHeight / 2;
+    const int32_t first     = begin - anchor;
+    int32_t next            = first;
+
+    for (int32_t y = begin; y < end;) {
+        int32_t count = std::min(FILTER_ENGINE_CHUNK_ROWS, end - y);
+        int32_t last  = y + count - 1 + kHeight - 1 - anchor;
+        for (; next <= last; next++) {
+            int32_t sy = border_interpolate(next, height, border_type);
+            if (sy >= 0) {
+                make_row(sy, ring + (next - first) % ring_rows * ring_step);
+            }
+        }
+        for (int32_t k = 0; k < count + kHeight - 1; k++) {
+            int32_t r  = y - anchor + k;
+            int32_t sy = border_interpolate(r, height, border_type);
+            rows[k]    = sy < 0 ? const_row : ring + (r - first) % ring_rows * ring_step;
+        }
+        consume(rows, y, count);
+        y += count;
+    }
+}
+
+// x86 counterpart of arm/filter_engine.hpp for kernels that split into a row
+// and a column pass:
+//   void RowFilter::operator()(const ST *src, MT *dst, int32_t width, int32_t cn) const
+// filters one row extended by the border, `width` pixels of `cn` channels, and
+//   void ColumnFilter::operator()(const MT **src, DT *dst, int32_t dststep, int32_t count, int32_t width)
+// writes `count` output rows, src[i] being the top row of the window of row i
+// and `width` counting elements. Row buffers are aligned to 64 bytes. The
+// column filter is copied for every band, so it may keep state between calls.
+template <typename ST, typename MT, typename DT, typename RowFilter, typename ColumnFilter>
+class SeparableFilterEngine {
+public:
+    SeparableFilterEngine(
+        int32_t height,
+        int32_t width,
+        int32_t channels,
+        int32_t kHeight,
+        int32_t kWidth,
+        BorderType border_type,
+        ST border_value,
+        const RowFilter &rowFilter,
+        const ColumnFilter &columnFilter)
+        : height(height)
+        , width(width)
+        , channels(channels)
+        , kHeight(kHeight)
+        , kWidth(kWidth)
+        , border_type(border_type)
+        , border(width, channels, kWidth, border_type, border_value)
+        , rowFilter(rowFilter)
+        , columnFilter(columnFilter) {}
+
+    void process(const ST *src, int32_t inWidthStride, DT *dst, int32_t outWidthStride) const
+    {
+        parallel_for_rows(height, (int64_t)width * channels * (kWidth + kHeight), [&](int32_t begin, int32_t end) {
+            process_rows(src, inWidthStride, dst, outWidthStride, begin, end);
+        });
+    }
+
+    void process_rows(const ST *src, int32_t inWidthStride, DT *dst, int32_t outWidthStride, int32_t begin, int32_t end) const
+    {
+        const int32_t ring_rows  = kHeight + FILTER_ENGINE_CHUNK_ROWS - 1;
+        const int32_t ring_bytes = (width * channels * sizeof(MT) + FILTER_ENGINE_ROW_ALIGN - 1) / FILTER_ENGINE_ROW_ALIGN * FILTER_ENGINE_ROW_ALIGN;
+        const int32_t pad_bytes  = (border.padded_width() * channels * sizeof(ST) + FILTER_ENGINE_ROW_ALIGN - 1) / FILTER_ENGINE_ROW_ALIGN * FILTER_ENGINE_ROW_ALIGN;
+        uint8_t *buffer          = (uint8_t *)ppl::common::AlignedAlloc((ring_rows + 1) * ring_bytes + pad_bytes, FILTER_ENGINE_ROW_ALIGN);
+        MT *ring                 = (MT *)buffer;
+        MT *const_row            = (MT *)(buffer + ring_rows * ring_bytes);
+        ST *padded               = (ST *)(buffer + (ring_rows + 1) * ring_bytes);
+        std::vector<const MT *> rows(ring_rows);
+
+        if (border_type == ppl::cv::BORDER_CONSTANT) {
+            border.fill(padded);
+            rowFilter(padded, const_row, width, channels);
+        }
+
+        ColumnFilter column = columnFilter;
+        auto make_row       = [&](int32_t sy, MT *row) {
+            border(src + (int64_t)sy * inWidthStride, padded);
+            rowFilter(padded, row, width, channels);
+        };
+        auto consume = [&](const MT **window, int32_t y, int32_t count) {
+            column(window, dst + (int64_t)y * outWidthStride, outWidthStride, count, width * channels);
+        };
+        filter_engine_band(height, kHeight, border_type, begin, end, ring, ring_bytes / (int32_t)sizeof(MT), const_row, rows.data(), make_row, consume);
+
+        ppl::common::AlignedFree(buffer);
+    }
+
+private:
+    int32_t height;
+    int32_t width;
+    int32_t channels;
+    int32_t kHeight;
+    int32_t kWidth;
+    BorderType border_type;
+    FilterRowBorder<ST> border;
+    RowFilter rowFilter;
+    ColumnFilter columnFilter;
+};
+
+// Kernels that do not split: the ring keeps the source rows extended by the
+// border and
+//   void Filter::operator()(const ST **src, DT *dst, int32_t dststep, int32_t count, int32_t width, int32_t cn)
+// writes `count` output rows from the kHeight rows starting at src[i].
+template <typename ST, typename DT, typename Filter>
+class FilterEngine {
+public:
+    FilterEngine(
+        int32_t height,
+        int32_t width,
+        int32_t channels,
+        int32_t kHeight,
+        int32_t kWidth,
+        BorderType border_type,
+        ST border_value,
+        const Filter &filter)
+        : height(height)
+        , width(width)
+        , channels(channels)
+        , kHeight(kHeight)
+        , kWidth(kWidth)
+        , border_type(border_type)
+        , border(width, channels, kWidth, border_type, border_value)
+        , filter(filter) {}
+
+    void process(const ST *src, int32_t inWidthStride, DT *dst, int32_t outWidthStride) const
+    {
+        parallel_for_rows(height, (int64_t)width * channels * kWidth * kHeight, [&](int32_t begin, int32_t end) {
+            process_rows(src, inWidthStride, dst, outWidthStride, begin, end);
+        });
+    }
+
+    void process_rows(const ST *src, int32_t inWidthStride, DT *dst, int32_t outWidthStride, int32_t begin, int32_t end) const
+    {
+        const int32_t ring_rows  = kHeight + FILTER_ENGINE_CHUNK_ROWS - 1;
+        const int32_t ring_bytes = (border.padded_width() * channels * sizeof(ST) + FILTER_ENGINE_ROW_ALIGN - 1) / FILTER_ENGINE_ROW_ALIGN * FILTER_ENGINE_ROW_ALIGN;
+        uint8_t *buffer          = (uint8_t *)ppl::common::AlignedAlloc((ring_rows + 1) * ring_bytes, FILTER_ENGINE_ROW_ALIGN);
+        ST *ring                 = (ST *)buffer;
+        ST *const_row            = (ST *)(buffer + ring_rows * ring_bytes);
+        std::vector<const ST *> rows(ring_rows);
+
+        if (border_type == ppl::cv::BORDER_CONSTANT) {
+            border.fill(const_row);
+        }
+
+        Filter band_filter = filter;
+        auto make_row      = [&](int32_t sy, ST *row) {
+            border(src + (int64_t)sy * inWidthStride, row);
+        };
+        auto consume = [&](const ST **window, int32_t y, int32_t count) {
+            band_filter(window, dst + (int64_t)y * outWidthStride, outWidthStride, count, width, channels);
+        };
+        filter_engine_band(height, kHeight, border_type, begin, end, ring, ring_bytes / (int32_t)sizeof(ST), const_row, rows.data(), make_row, consume);
+
+        ppl::common::AlignedFree(buffer);
+    }
+
+private:
+    int32_t height;
+    int32_t width;
+    int32_t channels;
+    int32_t kHeight;
+    int32_t kWidth;
+    BorderType border_type;
+    FilterRowBorder<ST> border;
+    Filter filter;
+};
+
+}
+}
+} // namespace ppl::cv::x86
+
+#endif //! PPL_CV_X86_FILTER_ENGINE_HPP_
@@ -0,0 +1,160 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+#include "ppl/cv/x86/fma/internal_fma.hpp"
+#include "ppl/cv/x86/fma/intrinutils_fma.hpp"
+#include <immintrin.h>
+
+namespace ppl {
+namespace cv {
+namespace x86 {
+namespace fma {
+
+// eight pixels from the low half of `data`
+static inline void crn_store8_u8(__m128i data, __m256 scale, __m256 bias, float *dst)
+{
+    __m256 m_value = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(data));
+    _mm256_storeu_ps(dst, _mm256_fmadd_ps(m_value, scale, bias));
+}
+
+static inline void crn_store32_u8(__m256i data, __m256 scale, __m256 bias, float *dst)
+{
+    __m128i m_lo = _mm256_castsi256_si128(data);
+    __m128i m_hi = _mm256_extracti128_si256(data, 1);
+    crn_store8_u8(m_lo, scale, bias, dst + 0);
+    crn_store8_u8(_mm_srli_si128(m_lo, 8), scale, bias, dst + 8);
+    crn_store8_u8(m_hi, scale, bias, dst + 16);
+    crn_store8_u8(_mm_srli_si128(m_hi, 8), scale, bias, dst + 24);
+}
+
+int32_t crop_resize_normalize_row_u8_fma(
+    const uint8_t *src,
+    int32_t channels,
+    int32_t width,
+    const float *scale,
+    const float *bias,
+    float *const *dst)
+{
+    int32_t planes = channels == 1 ? 1 : 3;
+    __m256 m_scale[3], m_bias[3];
+    for (int32_t c = 0; c < planes; ++c) {
+        m_scale[c] = _mm256_set1_ps(scale[c]);
+        m_bias[c]  = _mm256_set1_ps(bias[c]);
+    }
+
+    int32_t w = 0;
+    if (1 == channels) {
+        for (; w <= width - 16; w += 16) {
+            __m128i m_data = _mm_loadu_si128((const __m128i *)(src + w));
+            crn_store8_u8(m_data, m_scale[0], m_bias[0], dst[0] + w);
+            crn_store8_u8(_mm_srli_si128(m_data, 8), m_scale[0], m_bias[0], dst[0] + w + 8);
+        }
+    } else if (3 == channels) {
+        for (; w <= width - 32; w += 32) {
+            __m256i m_data[3];
+            v_load_deinterleave(src + w * 3, m_data[0], m_data[1], m_data[2]);
+            for (int32_t c = 0; c < 3; ++c) {
+                crn_store32_u8(m_data[c], m_scale[c], m_bias[c], dst[c] + w);
+            }
+        }
+    } else {
+        for (; w <= width - 32; w += 32) {
+            __m256i m_data[4];
+            v_load_deinterleave(src + w * 4, m_data[0], m_data[1], m_data[2], m_data[3]);
+            for (int32_t c = 0; c < 3; ++c) {
+                crn_store32_u8(m_data[c], m_scale[c], m_bias[c], dst[c] + w);
+            }
+        }
+    }
+    return w;
+}
+
+int32_t crop_resize_normalize_row_fp32_fma(
+    const float *src,
+    int32_t channels,
+    int32_t width,
+    const float *scale,
+    const float *bias,
+    float *const *dst)
+{
+    int32_t planes = channels == 1 ? 1 : 3;
+    __m256 m_scale[3], m_bias[3];
+    for (int32_t c = 0; c < planes; ++c) {
+        m_scale[c] = _mm256_set1_ps(scale[c]);
+        m_bias[c]  = _mm256_set1_ps(bias[c]);
+    }
+
+    int32_t w = 0;
+    if (1 == channels) {
+        for (; w <= width - 8; w += 8) {
+            _mm256_storeu_ps(dst[0] + w, _mm256_fmadd_ps(_mm256_loadu_ps(src + w), m_scale[0], m_bias[0]));
+        }
+    } else if (3 == channels) {
+        for (; w <= width - 8; w += 8) {
+            __m256 m_data[3];
+            v_load_deinterleave(src + w * 3, m_data[0], m_data[1], m_data[2]);
+            for (int32_t c = 0; c < 3; ++c) {
+                _mm256_storeu_ps(dst[c] + w, _mm256_fmadd_ps(m_data[c], m_scale[c], m_bias[c]));
+            }
+        }
+    } else {
+        for (; w <= width - 8; w += 8) {
+            __m256 m_data[4];
+            v_load_deinterleave(src + w * 4, m_data[0], m_data[1], m_data[2], m_data[3]);
+            for (int32_t c = 0; c < 3; ++c) {
+                _mm256_storeu_ps(dst[c] + w, _mm256_fmadd_ps(m_data[c], m_scale[c], m_bias[c]));
+            }
+        }
+    }
+    return w;
+}
+
+// the float to half conversion of cropresizenormalize.cpp, eight at a time
+static inline __m256i crn_half8(__m256 value)
+{
+    __m256i m_bits   = _mm256_castps_si256(value);
+    __m256i m_sign   = _mm256_and_si256(m_bits, _mm256_set1_epi32(0x80000000));
+    __m256i m_abs    = _mm256_xor_si256(m_bits, m_sign);
+    __m256 m_magic   = _mm256_set1_ps(0.5f);
+    __m256i m_odd    = _mm256_and_si256(_mm256_srli_epi32(m_abs, 13), _mm256_set1_epi32(1));
+    __m256i m_rebias = _mm256_set1_epi32((int32_t)(((uint32_t)(15 - 127) << 23) + 0xfff));
+
+    __m256i m_normal    = _mm256_srli_epi32(_mm256_add_epi32(_mm256_add_epi32(m_abs, m_rebias), m_odd), 13);
+    __m256i m_subnormal = _mm256_sub_epi32(_mm256_castps_si256(_mm256_add_ps(_mm256_castsi256_ps(m_abs), m_magic)), _mm256_castps_si256(m_magic));
+    __m256i m_inf_nan   = _mm256_blendv_epi8(_mm256_set1_epi32(0x7c00), _mm256_set1_epi32(0x7e00), _mm256_cmpgt_epi32(m_abs, _mm256_set1_epi32(255 << 23)));
+
+    __m256i m_half = _mm256_blendv_epi8(m_subnormal, m_normal, _mm256_cmpgt_epi32(m_abs, _mm256_set1_epi32((113 << 23) - 1)));
+    m_half         = _mm256_blendv_epi8(m_half, m_inf_nan, _mm256_cmpgt_epi32(m_abs, _mm256_set1_epi32(((127 + 16) << 23) - 1)));
+    return _mm256_or_si256(m_half, _mm256_srli_epi32(m_sign, 16));
+}
+
+int32_t crop_resize_normalize_half_row_fma(
+    const float *src,
+    int32_t width,
+    uint16_t *dst)
+{
+    int32_t w = 0;
+    for (; w <= width - 16; w += 16) {
+        __m256i m_half = _mm256_packus_epi32(crn_half8(_mm256_loadu_ps(src + w)), crn_half8(_mm256_loadu_ps(src + w + 8)));
+        _mm256_storeu_si256((__m256i *)(dst + w), _mm256_permute4x64_epi64(m_half, 0xd8));
+    }
+    return w;
+}
+
+}
+}
+}
+} // namespace ppl::cv::x86::fma
@@ -0,0 +1,70 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "ppl/cv/x86/fma/internal_fma.hpp"
+#include <stdint.h>
+#include <immintrin.h>
+
+namespace ppl {
+namespace cv {
+namespace x86 {
+namespace fma {
+
+// Same lookup as the SSE path of equalizehist.cpp on 32 pixels per step:
+// pshufb reads the 16 sub-tables with the low nibble, then a blend tree keyed
+// on bits 4..7 of the index picks the sub-table.
+int32_t equalizehist_lut_u8_fma(
+    int32_t width,
+    const uint8_t *in,
+    const uint8_t *lut,
+    uint8_t *out)
+{
+    __m256i v_lut[16];
+    for (int32_t i = 0; i < 16; ++i) {
+        v_lut[i] = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)(lut + i * 16)));
+    }
+    const __m256i v_low = _mm256_set1_epi8(0x0F);
+
+    int32_t w = 0;
+    for (; w <= width - 32; w += 32) {
+        __m256i v_idx = _mm256_loadu_si256((const __m256i *)(in + w));
+        __m256i v_lo  = _mm256_and_si256(v_idx, v_low);
+        __m256i v_b4  = _mm256_slli_epi16(v_idx, 3);
+        __m256i v_b5  = _mm256_slli_epi16(v_idx, 2);
+        __m256i v_b6  = _mm256_slli_epi16(v_idx, 1);
+        // reduce the tree as soon as a pair is ready to keep few registers live
+        __m256i v_sel[2];
+        for (int32_t i = 0; i < 2; ++i) {
+            __m256i v_q[2];
+            for (int32_t j = 0; j < 2; ++j) {
+                __m256i v_p[2];
+                for (int32_t k = 0; k < 2; ++k) {
+                    int32_t t = ((i * 2 + j) * 2 + k) * 2;
+                    v_p[k]    = _mm256_blendv_epi8(_mm256_shuffle_epi8(v_lut[t], v_lo),
+                                                   _mm256_shuffle_epi8(v_lut[t + 1], v_lo),
+                                                   v_b4);
+                }
+                v_q[j] = _mm256_blendv_epi8(v_p[0], v_p[1], v_b5);
+            }
+            v_sel[i] = _mm256_blendv_epi8(v_q[0], v_q[1], v_b6);
+        }
+        _mm256_storeu_si256((__m256i *)(out + w), _mm256_blendv_epi8(v_sel[0], v_sel[1], v_idx));
+    }
+    return w;
+}
+
+}}}} // namespace ppl::cv::x86::fma
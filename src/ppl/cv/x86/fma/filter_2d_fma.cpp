@@ -562,10 +562,10 @@ void convolution_f_r(
                     sum3 += f * src[src_start];
                 }
             }
-            imageOut[x + y0 * outWidthStride] = sat_cast(senseRound_f(sum0));
-            imageOut[x + y1 * outWidthStride] = sat_cast(senseRound_f(sum1));
-            imageOut[x + y2 * outWidthStride] = sat_cast(senseRound_f(sum2));
-            imageOut[x + y3 * outWidthStride] = sat_cast(senseRound_f(sum3));
+            imageOut[x + y0 * outWidthStride] = sum0;
+            imageOut[x + y1 * outWidthStride] = sum1;
+            imageOut[x + y2 * outWidthStride] = sum2;
+            imageOut[x + y3 * outWidthStride] = sum3;
         }
 
         for (x = left; x <= left + imageOutInnerX * cn - 16; x += 16) {
@@ -651,10 +651,10 @@ void convolution_f_r(
                     sum3 += f * src[(fy + y3 - top) * srcWidthStride + x - left + fx * cn];
                 }
             }
-            imageOut[x + y0 * outWidthStride] = sat_cast(senseRound_f(sum0));
-            imageOut[x + y1 * outWidthStride] = sat_cast(senseRound_f(sum1));
-            imageOut[x + y2 * outWidthStride] = sat_cast(senseRound_f(sum2));
-            imageOut[x + y3 * outWidthStride] = sat_cast(senseRound_f(sum3));
+            imageOut[x + y0 * outWidthStride] = sum0;
+            imageOut[x + y1 * outWidthStride] = sum1;
+            imageOut[x + y2 * outWidthStride] = sum2;
+            imageOut[x + y3 * outWidthStride] = sum3;
         }
         for (; x < imageOutSizeX * cn; x++) {
             //four rows
@@ -675,10 +675,10 @@ void convolution_f_r(
                     sum3 += f * src[src_start];
                 }
             }
-            imageOut[x + y0 * outWidthStride] = sat_cast(senseRound_f(sum0));
-            imageOut[x + y1 * outWidthStride] = sat_cast(senseRound_f(sum1));
-            imageOut[x + y2 * outWidthStride] = sat_cast(senseRound_f(sum2));
-            imageOut[x + y3 * outWidthStride] = sat_cast(senseRound_f(sum3));
+            imageOut[x + y0 * outWidthStride] = sum0;
+            imageOut[x + y1 * outWidthStride] = sum1;
+            imageOut[x + y2 * outWidthStride] = sum2;
+            imageOut[x + y3 * outWidthStride] = sum3;
         }
     }
     for (y = (imageOutInnerY) / 4 * 4 + top; y < imageOutInnerY + top; y++) {
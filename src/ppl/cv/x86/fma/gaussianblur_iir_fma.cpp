@@ -0,0 +1,157 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "ppl/cv/x86/fma/internal_fma.hpp"
+#include <immintrin.h>
+
+namespace ppl {
+namespace cv {
+namespace x86 {
+namespace fma {
+
+// at most 64 lanes, as in gaussianblur_iir.cpp
+#define IIR_MAX_CHUNKS 8
+// positions read ahead, the lines of a column strip being a row apart
+#define IIR_PREFETCH   16
+
+int32_t gaussian_iir_yvv_lines_fma(
+    const float *coeffs,
+    const float *const *rows,
+    int32_t count,
+    int32_t lanes,
+    float *dst)
+{
+    __m256 m_b  = _mm256_set1_ps(coeffs[0]);
+    __m256 m_d1 = _mm256_set1_ps(coeffs[1]);
+    __m256 m_d2 = _mm256_set1_ps(coeffs[2]);
+    __m256 m_d3 = _mm256_set1_ps(coeffs[3]);
+    __m256 state[IIR_MAX_CHUNKS][3];
+    int32_t chunks = lanes / 8;
+
+    for (int32_t c = 0; c < chunks; ++c) {
+        state[c][0] = state[c][1] = state[c][2] = _mm256_loadu_ps(rows[0] + c * 8);
+    }
+    for (int32_t p = 0; p < count; ++p) {
+        const float *src  = rows[p];
+        float *out        = dst + (int64_t)p * lanes;
+        const float *next = rows[p + IIR_PREFETCH < count ? p + IIR_PREFETCH : count - 1];
+        for (int32_t i = 0; i < chunks * 8; i += 16) {
+            _mm_prefetch((const char *)(next + i), _MM_HINT_T0);
+        }
+        for (int32_t c = 0; c < chunks; ++c) {
+            __m256 *s   = state[c];
+            __m256 m_fb = _mm256_fmadd_ps(m_d3, s[2], _mm256_fmadd_ps(m_d2, s[1], _mm256_mul_ps(m_d1, s[0])));
+            __m256 m_w  = _mm256_fmsub_ps(m_b, _mm256_loadu_ps(src + c * 8), m_fb);
+            s[2]        = s[1];
+            s[1]        = s[0];
+            s[0]        = m_w;
+            _mm256_storeu_ps(out + c * 8, m_w);
+        }
+    }
+
+    for (int32_t c = 0; c < chunks; ++c) {
+        state[c][0] = state[c][1] = state[c][2] = _mm256_loadu_ps(dst + (int64_t)(count - 1) * lanes + c * 8);
+    }
+    for (int32_t p = count - 1; p >= 0; --p) {
+        float *out = dst + (int64_t)p * lanes;
+        for (int32_t c = 0; c < chunks; ++c) {
+            __m256 *s   = state[c];
+            __m256 m_fb = _mm256_fmadd_ps(m_d3, s[2], _mm256_fmadd_ps(m_d2, s[1], _mm256_mul_ps(m_d1, s[0])));
+            __m256 m_y  = _mm256_fmsub_ps(m_b, _mm256_loadu_ps(out + c * 8), m_fb);
+            s[2]        = s[1];
+            s[1]        = s[0];
+            s[0]        = m_y;
+            _mm256_storeu_ps(out + c * 8, m_y);
+        }
+    }
+    return chunks * 8;
+}
+
+int32_t gaussian_iir_deriche_lines_fma(
+    const float *coeffs,
+    const float *const *rows,
+    int32_t count,
+    int32_t lanes,
+    float *dst)
+{
+    __m256 m_c[2][8];
+    for (int32_t k = 0; k < 2; ++k) {
+        for (int32_t j = 0; j < 8; ++j) {
+            m_c[k][j] = _mm256_set1_ps(coeffs[k * 8 + j]);
+        }
+    }
+    // per chunk: the last 2 inputs, then the last 2 outputs of each section
+    __m256 state[IIR_MAX_CHUNKS][6];
+    int32_t chunks = lanes / 8;
+
+    for (int32_t c = 0; c < chunks; ++c) {
+        __m256 m_x  = _mm256_loadu_ps(rows[0] + c * 8);
+        state[c][0] = state[c][1] = m_x;
+        state[c][2] = state[c][3] = _mm256_mul_ps(m_x, m_c[0][6]);
+        state[c][4] = state[c][5] = _mm256_mul_ps(m_x, m_c[1][6]);
+    }
+    for (int32_t p = 0; p < count; ++p) {
+        const float *src  = rows[p];
+        float *out        = dst + (int64_t)p * lanes;
+        const float *next = rows[p + IIR_PREFETCH < count ? p + IIR_PREFETCH : count - 1];
+        for (int32_t i = 0; i < chunks * 8; i += 16) {
+            _mm_prefetch((const char *)(next + i), _MM_HINT_T0);
+        }
+        for (int32_t c = 0; c < chunks; ++c) {
+            __m256 *s  = state[c];
+            __m256 m_x = _mm256_loadu_ps(src + c * 8);
+            __m256 m_y[2];
+            for (int32_t k = 0; k < 2; ++k) {
+                const __m256 *m_k = m_c[k];
+                __m256 m_ff  = _mm256_fmadd_ps(m_k[1], s[0], _mm256_mul_ps(m_k[0], m_x));
+                m_y[k]       = _mm256_fnmadd_ps(m_k[2], s[2 + k * 2], _mm256_fnmadd_ps(m_k[3], s[3 + k * 2], m_ff));
+                s[3 + k * 2] = s[2 + k * 2];
+                s[2 + k * 2] = m_y[k];
+            }
+            s[0] = m_x;
+            _mm256_storeu_ps(out + c * 8, _mm256_add_ps(m_y[0], m_y[1]));
+        }
+    }
+
+    for (int32_t c = 0; c < chunks; ++c) {
+        __m256 m_x  = _mm256_loadu_ps(rows[count - 1] + c * 8);
+        state[c][0] = state[c][1] = m_x;
+        state[c][2] = state[c][3] = _mm256_mul_ps(m_x, m_c[0][7]);
+        state[c][4] = state[c][5] = _mm256_mul_ps(m_x, m_c[1][7]);
+    }
+    for (int32_t p = count - 1; p >= 0; --p) {
+        const float *src = rows[p];
+        float *out       = dst + (int64_t)p * lanes;
+        for (int32_t c = 0; c < chunks; ++c) {
+            __m256 *s = state[c];
+            __m256 m_y[2];
+            for (int32_t k = 0; k < 2; ++k) {
+                const __m256 *m_k = m_c[k];
+                __m256 m_ff  = _mm256_fmadd_ps(m_k[5], s[1], _mm256_mul_ps(m_k[4], s[0]));
+                m_y[k]       = _mm256_fnmadd_ps(m_k[2], s[2 + k * 2], _mm256_fnmadd_ps(m_k[3], s[3 + k * 2], m_ff));
+                s[3 + k * 2] = s[2 + k * 2];
+                s[2 + k * 2] = m_y[k];
+            }
+            s[1] = s[0];
+            s[0] = _mm256_loadu_ps(src + c * 8);
+            _mm256_storeu_ps(out + c * 8, _mm256_add_ps(_mm256_loadu_ps(out + c * 8), _mm256_add_ps(m_y[0], m_y[1])));
+        }
+    }
+    return chunks * 8;
+}
+
+}}}} // namespace ppl::cv::x86::fma
@@ -38,6 +38,14 @@ int32_t resize_linear_twoline_fp32_fma(
     float *row_1,
     float *out_data);
 
+int32_t resize_linear_w_oneline_fp32_fma(
+    int32_t max_length,
+    int32_t channels,
+    const float *in_data,
+    const int32_t *w_offset,
+    const float *w_coeff,
+    float *row);
+
 int32_t resize_linear_w_oneline_c1_u8_fma(
     int32_t in_width,
     const uint8_t *in_data,
@@ -92,6 +100,54 @@ int32_t resize_linear_shrink2_oneline_c4_kernel_u8_fma(
     int32_t out_width,
     uint8_t *out_ptr);
 
+int32_t resize_area_box_v_u8_fma(
+    const uint8_t *src,
+    int32_t stride,
+    int32_t rows,
+    int32_t length,
+    uint16_t *sum);
+
+int32_t resize_area_v_u8_fma(
+    const uint8_t *src,
+    int32_t stride,
+    const float *coeff,
+    int32_t taps,
+    int32_t length,
+    float *row);
+
+int32_t resize_area_v_fp32_fma(
+    const float *src,
+    int32_t stride,
+    const float *coeff,
+    int32_t taps,
+    int32_t length,
+    float *row);
+
+// One row of interleaved pixels to planar floats: dst[c][w] is channel c of
+// pixel w times scale[c] plus bias[c]. The 4th channel of 4 channel pixels is
+// dropped. Returns the number of pixels done.
+int32_t crop_resize_normalize_row_u8_fma(
+    const uint8_t *src,
+    int32_t channels,
+    int32_t width,
+    const float *scale,
+    const float *bias,
+    float *const *dst);
+
+int32_t crop_resize_normalize_row_fp32_fma(
+    const float *src,
+    int32_t channels,
+    int32_t width,
+    const float *scale,
+    const float *bias,
+    float *const *dst);
+
+// IEEE half-precision conversion rounding to nearest even, as F16C does
+int32_t crop_resize_normalize_half_row_fma(
+    const float *src,
+    int32_t width,
+    uint16_t *dst);
+
 template <int32_t dstcn, int32_t blueIdx>
 ::ppl::common::RetCode i420_2_rgb(
     int32_t height,
@@ -177,6 +233,7 @@ template <typename T, int32_t nc, ppl::cv::BorderType borderMode>
     int32_t inHeight,
     int32_t inWidth,
     int32_t inWidthStride,
+    int32_t rowBegin,
     int32_t outHeight,
     int32_t outWidth,
     int32_t outWidthStride,
@@ -190,6 +247,7 @@ template <typename T, int32_t nc, ppl::cv::BorderType borderMode>
     int32_t inHeight,
     int32_t inWidth,
     int32_t inWidthStride,
+    int32_t rowBegin,
     int32_t outHeight,
     int32_t outWidth,
     int32_t outWidthStride,
@@ -306,5 +364,48 @@ void mergeSOA2AOS(
     int32_t outWidthStride,
     T *out);
 
+int32_t equalizehist_lut_u8_fma(
+    int32_t width,
+    const uint8_t *in,
+    const uint8_t *lut,
+    uint8_t *out);
+
+void jpeg_idct_8x8_u8_fma(
+    const int16_t *data,
+    const uint16_t *dequant_table,
+    int32_t out_stride,
+    uint8_t *output);
+
+void jpeg_fdct_8x8_u8_fma(
+    const uint8_t *input,
+    int32_t in_stride,
+    const float *reciprocals,
+    int16_t *output);
+
+int32_t jpeg_ycrcb_2_bgr_u8_fma(
+    int32_t width,
+    const uint8_t *y,
+    const uint8_t *cb,
+    const uint8_t *cr,
+    uint8_t *dst);
+
+// Recursive Gaussian over `count` positions of `lanes` independent lines,
+// rows[p] pointing at the samples of position p and dst receiving `count`
+// rows of `lanes` floats. coeffs as laid out in gaussianblur_iir.cpp. Returns
+// the number of lanes done, from lane 0.
+int32_t gaussian_iir_yvv_lines_fma(
+    const float *coeffs,
+    const float *const *rows,
+    int32_t count,
+    int32_t lanes,
+    float *dst);
+
+int32_t gaussian_iir_deriche_lines_fma(
+    const float *coeffs,
+    const float *const *rows,
+    int32_t count,
+    int32_t lanes,
+    float *dst);
+
 }}}} // namespace ppl::cv::x86::fma
 #endif //! PPL_CV_X86_INTERNAL_FMA_H_
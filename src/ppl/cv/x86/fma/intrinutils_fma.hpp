@@ -81,6 +81,25 @@ inline void v_load_deinterleave(const uchar *ptr, __m256i &a, __m256i &b, __m256
     d = _mm256_unpackhi_epi32(phl, phh);
 }
 
+inline void v_load_deinterleave(const float *ptr, __m256 &a, __m256 &b, __m256 &c)
+{
+    const __m256i a_idx = _mm256_set_epi32(5, 2, 7, 4, 1, 6, 3, 0);
+    const __m256i b_idx = _mm256_set_epi32(6, 3, 0, 5, 2, 7, 4, 1);
+    const __m256i c_idx = _mm256_set_epi32(7, 4, 1, 6, 3, 0, 5, 2);
+
+    __m256 p0 = _mm256_loadu_ps(ptr);
+    __m256 p1 = _mm256_loadu_ps(ptr + 8);
+    __m256 p2 = _mm256_loadu_ps(ptr + 16);
+
+    __m256 a0 = _mm256_blend_ps(_mm256_blend_ps(p0, p1, 0x92), p2, 0x24);
+    __m256 b0 = _mm256_blend_ps(_mm256_blend_ps(p2, p0, 0x92), p1, 0x24);
+    __m256 c0 = _mm256_blend_ps(_mm256_blend_ps(p1, p2, 0x92), p0, 0x24);
+
+    a = _mm256_permutevar8x32_ps(a0, a_idx);
+    b = _mm256_permutevar8x32_ps(b0, b_idx);
+    c = _mm256_permutevar8x32_ps(c0, c_idx);
+}
+
 inline void v_load_deinterleave(const float *ptr, __m256 &a, __m256 &b, __m256 &c, __m256 &d)
 {
     __m256i p0 = _mm256_loadu_si256((const __m256i *)ptr);
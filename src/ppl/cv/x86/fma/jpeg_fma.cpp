@@ -0,0 +1,322 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "ppl/cv/x86/fma/internal_fma.hpp"
+#include <stdint.h>
+#include <immintrin.h>
+
+namespace ppl {
+namespace cv {
+namespace x86 {
+namespace fma {
+
+#define FLOAT2FLOAT(x) ((int32_t) (((x) * 4096 + 0.5)))
+
+// One 1-D islow idct on 8 columns at once, the same integer arithmetic as
+// IDCT_1D in imgcodecs/jpeg.cpp, so the results are bit exact. bias is added
+// to the even part before the descaling shift.
+template <int32_t shift>
+static inline void idct_1d_avx2(const __m256i s[8], __m256i bias, __m256i d[8])
+{
+    __m256i p1 = _mm256_mullo_epi32(_mm256_add_epi32(s[2], s[6]),
+                                    _mm256_set1_epi32(FLOAT2FLOAT(0.5411961f)));
+    __m256i t2 = _mm256_add_epi32(p1, _mm256_mullo_epi32(s[6],
+                                  _mm256_set1_epi32(FLOAT2FLOAT(-1.847759065f))));
+    __m256i t3 = _mm256_add_epi32(p1, _mm256_mullo_epi32(s[2],
+                                  _mm256_set1_epi32(FLOAT2FLOAT(0.765366865f))));
+    __m256i t0 = _mm256_slli_epi32(_mm256_add_epi32(s[0], s[4]), 12);
+    __m256i t1 = _mm256_slli_epi32(_mm256_sub_epi32(s[0], s[4]), 12);
+    t0 = _mm256_add_epi32(t0, bias);
+    t1 = _mm256_add_epi32(t1, bias);
+    __m256i x0 = _mm256_add_epi32(t0, t3);
+    __m256i x3 = _mm256_sub_epi32(t0, t3);
+    __m256i x1 = _mm256_add_epi32(t1, t2);
+    __m256i x2 = _mm256_sub_epi32(t1, t2);
+
+    // odd part
+    __m256i p3 = _mm256_add_epi32(s[7], s[3]);
+    __m256i p4 = _mm256_add_epi32(s[5], s[1]);
+    p1 = _mm256_add_epi32(s[7], s[1]);
+    __m256i p2 = _mm256_add_epi32(s[5], s[3]);
+    __m256i p5 = _mm256_mullo_epi32(_mm256_add_epi32(p3, p4),
+                                    _mm256_set1_epi32(FLOAT2FLOAT(1.175875602f)));
+    t0 = _mm256_mullo_epi32(s[7], _mm256_set1_epi32(FLOAT2FLOAT(0.298631336f)));
+    t1 = _mm256_mullo_epi32(s[5], _mm256_set1_epi32(FLOAT2FLOAT(2.053119869f)));
+    t2 = _mm256_mullo_epi32(s[3], _mm256_set1_epi32(FLOAT2FLOAT(3.072711026f)));
+    t3 = _mm256_mullo_epi32(s[1], _mm256_set1_epi32(FLOAT2FLOAT(1.501321110f)));
+    p1 = _mm256_add_epi32(p5, _mm256_mullo_epi32(p1,
+                          _mm256_set1_epi32(FLOAT2FLOAT(-0.899976223f))));
+    p2 = _mm256_add_epi32(p5, _mm256_mullo_epi32(p2,
+                          _mm256_set1_epi32(FLOAT2FLOAT(-2.562915447f))));
+    p3 = _mm256_mullo_epi32(p3, _mm256_set1_epi32(FLOAT2FLOAT(-1.961570560f)));
+    p4 = _mm256_mullo_epi32(p4, _mm256_set1_epi32(FLOAT2FLOAT(-0.390180644f)));
+    t3 = _mm256_add_epi32(t3, _mm256_add_epi32(p1, p4));
+    t2 = _mm256_add_epi32(t2, _mm256_add_epi32(p2, p3));
+    t1 = _mm256_add_epi32(t1, _mm256_add_epi32(p2, p4));
+    t0 = _mm256_add_epi32(t0, _mm256_add_epi32(p1, p3));
+
+    d[0] = _mm256_srai_epi32(_mm256_add_epi32(x0, t3), shift);
+    d[7] = _mm256_srai_epi32(_mm256_sub_epi32(x0, t3), shift);
+    d[1] = _mm256_srai_epi32(_mm256_add_epi32(x1, t2), shift);
+    d[6] = _mm256_srai_epi32(_mm256_sub_epi32(x1, t2), shift);
+    d[2] = _mm256_srai_epi32(_mm256_add_epi32(x2, t1), shift);
+    d[5] = _mm256_srai_epi32(_mm256_sub_epi32(x2, t1), shift);
+    d[3] = _mm256_srai_epi32(_mm256_add_epi32(x3, t0), shift);
+    d[4] = _mm256_srai_epi32(_mm256_sub_epi32(x3, t0), shift);
+}
+
+static inline void transpose_8x8_epi32(__m256i r[8])
+{
+    __m256i t0 = _mm256_unpacklo_epi32(r[0], r[1]);
+    __m256i t1 = _mm256_unpackhi_epi32(r[0], r[1]);
+    __m256i t2 = _mm256_unpacklo_epi32(r[2], r[3]);
+    __m256i t3 = _mm256_unpackhi_epi32(r[2], r[3]);
+    __m256i t4 = _mm256_unpacklo_epi32(r[4], r[5]);
+    __m256i t5 = _mm256_unpackhi_epi32(r[4], r[5]);
+    __m256i t6 = _mm256_unpacklo_epi32(r[6], r[7]);
+    __m256i t7 = _mm256_unpackhi_epi32(r[6], r[7]);
+    __m256i u0 = _mm256_unpacklo_epi64(t0, t2);
+    __m256i u1 = _mm256_unpackhi_epi64(t0, t2);
+    __m256i u2 = _mm256_unpacklo_epi64(t1, t3);
+    __m256i u3 = _mm256_unpackhi_epi64(t1, t3);
+    __m256i u4 = _mm256_unpacklo_epi64(t4, t6);
+    __m256i u5 = _mm256_unpackhi_epi64(t4, t6);
+    __m256i u6 = _mm256_unpacklo_epi64(t5, t7);
+    __m256i u7 = _mm256_unpackhi_epi64(t5, t7);
+    r[0] = _mm256_permute2x128_si256(u0, u4, 0x20);
+    r[1] = _mm256_permute2x128_si256(u1, u5, 0x20);
+    r[2] = _mm256_permute2x128_si256(u2, u6, 0x20);
+    r[3] = _mm256_permute2x128_si256(u3, u7, 0x20);
+    r[4] = _mm256_permute2x128_si256(u0, u4, 0x31);
+    r[5] = _mm256_permute2x128_si256(u1, u5, 0x31);
+    r[6] = _mm256_permute2x128_si256(u2, u6, 0x31);
+    r[7] = _mm256_permute2x128_si256(u3, u7, 0x31);
+}
+
+void jpeg_idct_8x8_u8_fma(
+    const int16_t *data,
+    const uint16_t *dequant_table,
+    int32_t out_stride,
+    uint8_t *output)
+{
+    __m256i rows[8], cols[8];
+    for (int32_t i = 0; i < 8; ++i) {
+        __m128i coeffs = _mm_loadu_si128((const __m128i *)(data + i * 8));
+        if (dequant_table != nullptr) {
+            coeffs = _mm_mullo_epi16(coeffs, _mm_loadu_si128((const __m128i *)(dequant_table + i * 8)));
+        }
+        rows[i] = _mm256_cvtepi16_epi32(coeffs);
+    }
+
+    // columns, keeping 2 extra bits of precision; the dc-only shortcut of the
+    // scalar code gives the same values, so it is not needed here.
+    idct_1d_avx2<10>(rows, _mm256_set1_epi32(512), cols);
+    transpose_8x8_epi32(cols);
+    // rows, rounding and adding 128 before the shift.
+    idct_1d_avx2<17>(cols, _mm256_set1_epi32(65536 + (128 << 17)), rows);
+    transpose_8x8_epi32(rows);
+
+    // saturating packs clamp to [0, 255], the dwords are reordered to rows.
+    const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+    for (int32_t i = 0; i < 8; i += 4) {
+        __m256i p01 = _mm256_packs_epi32(rows[i], rows[i + 1]);
+        __m256i p23 = _mm256_packs_epi32(rows[i + 2], rows[i + 3]);
+        __m256i b   = _mm256_permutevar8x32_epi32(_mm256_packus_epi16(p01, p23), order);
+        __m128i lo  = _mm256_castsi256_si128(b);
+        __m128i hi  = _mm256_extracti128_si256(b, 1);
+        _mm_storel_epi64((__m128i *)(output), lo);
+        _mm_storel_epi64((__m128i *)(output + out_stride), _mm_unpackhi_epi64(lo, lo));
+        _mm_storel_epi64((__m128i *)(output + out_stride * 2), hi);
+        _mm_storel_epi64((__m128i *)(output + out_stride * 3), _mm_unpackhi_epi64(hi, hi));
+        output += out_stride * 4;
+    }
+}
+
+#define FDCT_CONST_BITS 13
+#define FDCT_PASS1_BITS 2
+
+// One 1-D islow forward dct on 8 lanes, the same integer arithmetic as
+// fdct1D in imgcodecs/jpeg.cpp, so the results are bit exact.
+template <int32_t pass>
+static inline void fdct_1d_avx2(const __m256i s[8], __m256i d[8])
+{
+    const int32_t shift = pass == 1 ? FDCT_CONST_BITS - FDCT_PASS1_BITS :
+                                      FDCT_CONST_BITS + FDCT_PASS1_BITS;
+    const __m256i round = _mm256_set1_epi32(1 << (shift - 1));
+    __m256i tmp0 = _mm256_add_epi32(s[0], s[7]);
+    __m256i tmp7 = _mm256_sub_epi32(s[0], s[7]);
+    __m256i tmp1 = _mm256_add_epi32(s[1], s[6]);
+    __m256i tmp6 = _mm256_sub_epi32(s[1], s[6]);
+    __m256i tmp2 = _mm256_add_epi32(s[2], s[5]);
+    __m256i tmp5 = _mm256_sub_epi32(s[2], s[5]);
+    __m256i tmp3 = _mm256_add_epi32(s[3], s[4]);
+    __m256i tmp4 = _mm256_sub_epi32(s[3], s[4]);
+
+    // even part
+    __m256i tmp10 = _mm256_add_epi32(tmp0, tmp3);
+    __m256i tmp13 = _mm256_sub_epi32(tmp0, tmp3);
+    __m256i tmp11 = _mm256_add_epi32(tmp1, tmp2);
+    __m256i tmp12 = _mm256_sub_epi32(tmp1, tmp2);
+    if (pass == 1) {
+        d[0] = _mm256_slli_epi32(_mm256_add_epi32(tmp10, tmp11), FDCT_PASS1_BITS);
+        d[4] = _mm256_slli_epi32(_mm256_sub_epi32(tmp10, tmp11), FDCT_PASS1_BITS);
+    }
+    else {
+        tmp10 = _mm256_add_epi32(tmp10, _mm256_set1_epi32(1 << (FDCT_PASS1_BITS - 1)));
+        d[0] = _mm256_srai_epi32(_mm256_add_epi32(tmp10, tmp11), FDCT_PASS1_BITS);
+        d[4] = _mm256_srai_epi32(_mm256_sub_epi32(tmp10, tmp11), FDCT_PASS1_BITS);
+    }
+    __m256i z1 = _mm256_add_epi32(_mm256_mullo_epi32(_mm256_add_epi32(tmp12, tmp13),
+                                  _mm256_set1_epi32(4433)), round);
+    d[2] = _mm256_srai_epi32(_mm256_add_epi32(z1, _mm256_mullo_epi32(tmp13,
+                             _mm256_set1_epi32(6270))), shift);
+    d[6] = _mm256_srai_epi32(_mm256_sub_epi32(z1, _mm256_mullo_epi32(tmp12,
+                             _mm256_set1_epi32(15137))), shift);
+
+    // odd part
+    z1 = _mm256_add_epi32(tmp4, tmp7);
+    __m256i z2 = _mm256_add_epi32(tmp5, tmp6);
+    __m256i z3 = _mm256_add_epi32(tmp4, tmp6);
+    __m256i z4 = _mm256_add_epi32(tmp5, tmp7);
+    __m256i z5 = _mm256_mullo_epi32(_mm256_add_epi32(z3, z4), _mm256_set1_epi32(9633));
+    tmp4 = _mm256_mullo_epi32(tmp4, _mm256_set1_epi32(2446));
+    tmp5 = _mm256_mullo_epi32(tmp5, _mm256_set1_epi32(16819));
+    tmp6 = _mm256_mullo_epi32(tmp6, _mm256_set1_epi32(25172));
+    tmp7 = _mm256_mullo_epi32(tmp7, _mm256_set1_epi32(12299));
+    z1 = _mm256_mullo_epi32(z1, _mm256_set1_epi32(-7373));
+    z2 = _mm256_mullo_epi32(z2, _mm256_set1_epi32(-20995));
+    z3 = _mm256_add_epi32(_mm256_mullo_epi32(z3, _mm256_set1_epi32(-16069)), z5);
+    z4 = _mm256_add_epi32(_mm256_mullo_epi32(z4, _mm256_set1_epi32(-3196)), z5);
+    z3 = _mm256_add_epi32(z3, round);
+    z4 = _mm256_add_epi32(z4, round);
+    d[7] = _mm256_srai_epi32(_mm256_add_epi32(_mm256_add_epi32(tmp4, z1), z3), shift);
+    d[5] = _mm256_srai_epi32(_mm256_add_epi32(_mm256_add_epi32(tmp5, z2), z4), shift);
+    d[3] = _mm256_srai_epi32(_mm256_add_epi32(_mm256_add_epi32(tmp6, z2), z3), shift);
+    d[1] = _mm256_srai_epi32(_mm256_add_epi32(_mm256_add_epi32(tmp7, z1), z4), shift);
+}
+
+void jpeg_fdct_8x8_u8_fma(
+    const uint8_t *input,
+    int32_t in_stride,
+    const float *reciprocals,
+    int16_t *output)
+{
+    __m256i rows[8];
+    const __m256i center = _mm256_set1_epi32(128);
+    for (int32_t i = 0; i < 8; ++i) {
+        __m128i samples = _mm_loadl_epi64((const __m128i *)(input + i * in_stride));
+        rows[i] = _mm256_sub_epi32(_mm256_cvtepu8_epi32(samples), center);
+    }
+
+    // rows, as columns of the transposed block, then columns.
+    transpose_8x8_epi32(rows);
+    fdct_1d_avx2<1>(rows, rows);
+    transpose_8x8_epi32(rows);
+    fdct_1d_avx2<2>(rows, rows);
+
+    // the same quantization of the magnitudes as the sse code, a pair of
+    // rows is packed and its qwords are reordered.
+    const __m256 half = _mm256_set1_ps(0.5f);
+    for (int32_t i = 0; i < 8; i += 2) {
+        __m256 values0 = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_abs_epi32(rows[i])),
+                                       _mm256_loadu_ps(reciprocals + i * 8));
+        __m256 values1 = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_abs_epi32(rows[i + 1])),
+                                       _mm256_loadu_ps(reciprocals + i * 8 + 8));
+        __m256i quotients0 = _mm256_sign_epi32(_mm256_cvttps_epi32(
+                                 _mm256_add_ps(values0, half)), rows[i]);
+        __m256i quotients1 = _mm256_sign_epi32(_mm256_cvttps_epi32(
+                                 _mm256_add_ps(values1, half)), rows[i + 1]);
+        __m256i packed = _mm256_packs_epi32(quotients0, quotients1);
+        _mm256_storeu_si256((__m256i *)(output + i * 8),
+                            _mm256_permute4x64_epi64(packed, 0xd8));
+    }
+}
+
+// Same reduced-precision arithmetic as YCrCb2BGR::process8Elements in
+// imgcodecs/jpeg.cpp on 16 samples per register.
+static inline void ycrcb_16_elements_avx2(
+    const uint8_t *y,
+    const uint8_t *cb,
+    const uint8_t *cr,
+    __m256i &b16s,
+    __m256i &g16s,
+    __m256i &r16s)
+{
+    const __m128i sign_flip = _mm_set1_epi8(-0x80);
+    __m256i yw  = _mm256_or_si256(_mm256_slli_epi16(_mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)y)), 8),
+                                  _mm256_set1_epi16(128));
+    __m256i cbw = _mm256_slli_epi16(_mm256_cvtepu8_epi16(_mm_xor_si128(_mm_loadu_si128((const __m128i *)cb), sign_flip)), 8);
+    __m256i crw = _mm256_slli_epi16(_mm256_cvtepu8_epi16(_mm_xor_si128(_mm_loadu_si128((const __m128i *)cr), sign_flip)), 8);
+
+    __m256i yws = _mm256_srli_epi16(yw, 4);
+    __m256i cb0 = _mm256_mulhi_epi16(_mm256_set1_epi16(-(int16_t)(0.34414f * 4096.0f + 0.5f)), cbw);
+    __m256i cr0 = _mm256_mulhi_epi16(_mm256_set1_epi16((int16_t)(1.40200f * 4096.0f + 0.5f)), crw);
+    __m256i cb1 = _mm256_mulhi_epi16(cbw, _mm256_set1_epi16((int16_t)(1.77200f * 4096.0f + 0.5f)));
+    __m256i cr1 = _mm256_mulhi_epi16(crw, _mm256_set1_epi16(-(int16_t)(0.71414f * 4096.0f + 0.5f)));
+    b16s = _mm256_srai_epi16(_mm256_add_epi16(yws, cb1), 4);
+    g16s = _mm256_srai_epi16(_mm256_add_epi16(_mm256_add_epi16(cb0, yws), cr1), 4);
+    r16s = _mm256_srai_epi16(_mm256_add_epi16(cr0, yws), 4);
+}
+
+// Stores 32 pixels of 3 planes interleaved, each 128-bit lane shuffles the
+// 48 bytes of its 16 pixels.
+static inline void store_interleave_3x32_u8_avx2(
+    uint8_t *dst,
+    __m256i b,
+    __m256i g,
+    __m256i r)
+{
+    const __m256i b0 = _mm256_broadcastsi128_si256(_mm_setr_epi8(0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1, -1, 5));
+    const __m256i g0 = _mm256_broadcastsi128_si256(_mm_setr_epi8(-1, 0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1, -1));
+    const __m256i r0 = _mm256_broadcastsi128_si256(_mm_setr_epi8(-1, -1, 0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1));
+    const __m256i b1 = _mm256_broadcastsi128_si256(_mm_setr_epi8(-1, -1, 6, -1, -1, 7, -1, -1, 8, -1, -1, 9, -1, -1, 10, -1));
+    const __m256i g1 = _mm256_broadcastsi128_si256(_mm_setr_epi8(5, -1, -1, 6, -1, -1, 7, -1, -1, 8, -1, -1, 9, -1, -1, 10));
+    const __m256i r1 = _mm256_broadcastsi128_si256(_mm_setr_epi8(-1, 5, -1, -1, 6, -1, -1, 7, -1, -1, 8, -1, -1, 9, -1, -1));
+    const __m256i b2 = _mm256_broadcastsi128_si256(_mm_setr_epi8(-1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15, -1, -1));
+    const __m256i g2 = _mm256_broadcastsi128_si256(_mm_setr_epi8(-1, -1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15, -1));
+    const __m256i r2 = _mm256_broadcastsi128_si256(_mm_setr_epi8(10, -1, -1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15));
+
+    __m256i o0 = _mm256_or_si256(_mm256_or_si256(_mm256_shuffle_epi8(b, b0), _mm256_shuffle_epi8(g, g0)), _mm256_shuffle_epi8(r, r0));
+    __m256i o1 = _mm256_or_si256(_mm256_or_si256(_mm256_shuffle_epi8(b, b1), _mm256_shuffle_epi8(g, g1)), _mm256_shuffle_epi8(r, r1));
+    __m256i o2 = _mm256_or_si256(_mm256_or_si256(_mm256_shuffle_epi8(b, b2), _mm256_shuffle_epi8(g, g2)), _mm256_shuffle_epi8(r, r2));
+    _mm256_storeu_si256((__m256i *)(dst), _mm256_permute2x128_si256(o0, o1, 0x20));
+    _mm256_storeu_si256((__m256i *)(dst + 32), _mm256_permute2x128_si256(o2, o0, 0x30));
+    _mm256_storeu_si256((__m256i *)(dst + 64), _mm256_permute2x128_si256(o1, o2, 0x31));
+}
+
+int32_t jpeg_ycrcb_2_bgr_u8_fma(
+    int32_t width,
+    const uint8_t *y,
+    const uint8_t *cb,
+    const uint8_t *cr,
+    uint8_t *dst)
+{
+    int32_t i = 0;
+    for (; i + 32 <= width; i += 32, dst += 96) {
+        __m256i b16s0, g16s0, r16s0, b16s1, g16s1, r16s1;
+        ycrcb_16_elements_avx2(y + i, cb + i, cr + i, b16s0, g16s0, r16s0);
+        ycrcb_16_elements_avx2(y + i + 16, cb + i + 16, cr + i + 16, b16s1, g16s1, r16s1);
+        // packus works within the 128-bit lanes, restore the sample order.
+        __m256i b8s = _mm256_permute4x64_epi64(_mm256_packus_epi16(b16s0, b16s1), 0xD8);
+        __m256i g8s = _mm256_permute4x64_epi64(_mm256_packus_epi16(g16s0, g16s1), 0xD8);
+        __m256i r8s = _mm256_permute4x64_epi64(_mm256_packus_epi16(r16s0, r16s1), 0xD8);
+        store_interleave_3x32_u8_avx2(dst, b8s, g8s, r8s);
+    }
+    return i;
+}
+
+}}}} // namespace ppl::cv::x86::fma
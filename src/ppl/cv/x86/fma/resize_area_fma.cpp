@@ -0,0 +1,119 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include <immintrin.h>
+#include "internal_fma.hpp"
+
+namespace ppl {
+namespace cv {
+namespace x86 {
+namespace fma {
+
+// Vertical passes of ResizeArea; each returns how many elements it filled.
+
+int32_t resize_area_box_v_u8_fma(
+    const uint8_t *src,
+    int32_t stride,
+    int32_t rows,
+    int32_t length,
+    uint16_t *sum)
+{
+    int32_t i = 0;
+    for (; i <= length - 32; i += 32) {
+        __m256i m_sum_0 = _mm256_setzero_si256();
+        __m256i m_sum_1 = _mm256_setzero_si256();
+        for (int32_t r = 0; r < rows; ++r) {
+            const uint8_t *p = src + r * stride + i;
+            m_sum_0          = _mm256_add_epi16(m_sum_0, _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(p + 0))));
+            m_sum_1          = _mm256_add_epi16(m_sum_1, _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(p + 16))));
+        }
+        _mm256_storeu_si256((__m256i *)(sum + i + 0), m_sum_0);
+        _mm256_storeu_si256((__m256i *)(sum + i + 16), m_sum_1);
+    }
+    return i;
+}
+
+int32_t resize_area_v_u8_fma(
+    const uint8_t *src,
+    int32_t stride,
+    const float *coeff,
+    int32_t taps,
+    int32_t length,
+    float *row)
+{
+    int32_t i = 0;
+    for (; i <= length - 32; i += 32) {
+        __m256 m_sum_0 = _mm256_setzero_ps();
+        __m256 m_sum_1 = _mm256_setzero_ps();
+        __m256 m_sum_2 = _mm256_setzero_ps();
+        __m256 m_sum_3 = _mm256_setzero_ps();
+        for (int32_t t = 0; t < taps; ++t) {
+            if (0 == coeff[t]) {
+                continue;
+            }
+            const uint8_t *p = src + t * stride + i;
+            __m256 m_coeff   = _mm256_set1_ps(coeff[t]);
+            m_sum_0          = _mm256_fmadd_ps(_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(p + 0)))), m_coeff, m_sum_0);
+            m_sum_1          = _mm256_fmadd_ps(_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(p + 8)))), m_coeff, m_sum_1);
+            m_sum_2          = _mm256_fmadd_ps(_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(p + 16)))), m_coeff, m_sum_2);
+            m_sum_3          = _mm256_fmadd_ps(_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(p + 24)))), m_coeff, m_sum_3);
+        }
+        _mm256_storeu_ps(row + i + 0, m_sum_0);
+        _mm256_storeu_ps(row + i + 8, m_sum_1);
+        _mm256_storeu_ps(row + i + 16, m_sum_2);
+        _mm256_storeu_ps(row + i + 24, m_sum_3);
+    }
+    return i;
+}
+
+int32_t resize_area_v_fp32_fma(
+    const float *src,
+    int32_t stride,
+    const float *coeff,
+    int32_t taps,
+    int32_t length,
+    float *row)
+{
+    int32_t i = 0;
+    for (; i <= length - 32; i += 32) {
+        __m256 m_sum_0 = _mm256_setzero_ps();
+        __m256 m_sum_1 = _mm256_setzero_ps();
+        __m256 m_sum_2 = _mm256_setzero_ps();
+        __m256 m_sum_3 = _mm256_setzero_ps();
+        for (int32_t t = 0; t < taps; ++t) {
+            if (0 == coeff[t]) {
+                continue;
+            }
+            const float *p = src + t * stride + i;
+            __m256 m_coeff = _mm256_set1_ps(coeff[t]);
+            m_sum_0        = _mm256_fmadd_ps(_mm256_loadu_ps(p + 0), m_coeff, m_sum_0);
+            m_sum_1        = _mm256_fmadd_ps(_mm256_loadu_ps(p + 8), m_coeff, m_sum_1);
+            m_sum_2        = _mm256_fmadd_ps(_mm256_loadu_ps(p + 16), m_coeff, m_sum_2);
+            m_sum_3        = _mm256_fmadd_ps(_mm256_loadu_ps(p + 24), m_coeff, m_sum_3);
+        }
+        _mm256_storeu_ps(row + i + 0, m_sum_0);
+        _mm256_storeu_ps(row + i + 8, m_sum_1);
+        _mm256_storeu_ps(row + i + 16, m_sum_2);
+        _mm256_storeu_ps(row + i + 24, m_sum_3);
+    }
+    return i;
+}
+
+}
+}
+}
+} // namespace ppl::cv::x86::fma
@@ -20,6 +20,7 @@
 #include "internal_fma.hpp"
 #include "ppl/common/sys.h"
 #include "ppl/common/x86/sysinfo.h"
+#include "ppl/cv/x86/isa.hpp"
 
 namespace ppl {
 namespace cv {
@@ -38,7 +39,7 @@ int32_t resize_linear_twoline_fp32_fma(
     float *row_1,
     float *out_data)
 {
-    bool bSupportFMA = ppl::common::CpuSupports(ppl::common::ISA_X86_FMA);
+    bool bSupportFMA = isa_supported(ppl::common::ISA_X86_FMA);
     if (!bSupportFMA) {
         return 0;
     }
@@ -97,6 +98,52 @@ int32_t resize_linear_twoline_fp32_fma(
     return i;
 }
 
+// Computes the horizontal pass exactly as resize_linear_twoline_fp32_fma()
+// does, so a cached row holds the same values whichever kernel produced it.
+int32_t resize_linear_w_oneline_fp32_fma(
+    int32_t max_length,
+    int32_t channels,
+    const float *in_data,
+    const int32_t *w_offset,
+    const float *w_coeff,
+    float *row)
+{
+    bool bSupportFMA = isa_supported(ppl::common::ISA_X86_FMA);
+    if (!bSupportFMA) {
+        return 0;
+    }
+
+    __m256 m_one = _mm256_set1_ps(1.0f);
+
+    int32_t i = 0;
+    for (; i <= max_length - 8; i += 8) {
+        __m256 m_data_0 = _mm256_set_ps(in_data[w_offset[i + 7]],
+                                        in_data[w_offset[i + 6]],
+                                        in_data[w_offset[i + 5]],
+                                        in_data[w_offset[i + 4]],
+                                        in_data[w_offset[i + 3]],
+                                        in_data[w_offset[i + 2]],
+                                        in_data[w_offset[i + 1]],
+                                        in_data[w_offset[i + 0]]);
+        __m256 m_data_1 = _mm256_set_ps(in_data[w_offset[i + 7] + channels],
+                                        in_data[w_offset[i + 6] + channels],
+                                        in_data[w_offset[i + 5] + channels],
+                                        in_data[w_offset[i + 4] + channels],
+                                        in_data[w_offset[i + 3] + channels],
+                                        in_data[w_offset[i + 2] + channels],
+                                        in_data[w_offset[i + 1] + channels],
+                                        in_data[w_offset[i + 0] + channels]);
+
+        __m256 m_w_coeff_0 = _mm256_load_ps(w_coeff + i);
+        __m256 m_w_coeff_1 = _mm256_sub_ps(m_one, m_w_coeff_0);
+
+        __m256 m_rst_row = _mm256_fmadd_ps(m_data_0, m_w_coeff_0, _mm256_mul_ps(m_data_1, m_w_coeff_1));
+
+        _mm256_store_ps(row + i, m_rst_row);
+    }
+    return i;
+}
+
 }
 }
 }
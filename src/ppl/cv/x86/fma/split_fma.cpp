@@ -48,27 +48,17 @@ template <>
     int outWidthStride,
     float** out)
 {
-    __m256i r_idx_vec = _mm256_set_epi32(5, 2, 7, 4, 1, 6, 3, 0);
-    __m256i g_idx_vec = _mm256_set_epi32(6, 3, 0, 5, 2, 7, 4, 1);
-    __m256i b_idx_vec = _mm256_set_epi32(7, 4, 1, 6, 3, 0, 5, 2);
     for (int h = 0; h < height; ++h) {
         const float* base_in = in + h * inWidthStride;
         float* base_r = out[0] + h * outWidthStride;
         float* base_g = out[1] + h * outWidthStride;
         float* base_b = out[2] + h * outWidthStride;
         for (int w = 0; w < width / YMM_FP32_LANE_NUM * YMM_FP32_LANE_NUM; w += YMM_FP32_LANE_NUM) {
-            __m256 data0_vec = _mm256_loadu_ps(base_in + 3 * w);
-            __m256 data1_vec = _mm256_loadu_ps(base_in + 3 * w + 8);
-            __m256 data2_vec = _mm256_loadu_ps(base_in + 3 * w + 16);
-            __m256 r_vec = _mm256_blend_ps(data0_vec, data1_vec, 0x92);
-            r_vec        = _mm256_blend_ps(r_vec, data2_vec, 0x24);
-            __m256 g_vec = _mm256_blend_ps(data2_vec, data0_vec, 0x92);
-            g_vec        = _mm256_blend_ps(g_vec, data1_vec, 0x24);
-            __m256 b_vec = _mm256_blend_ps(data1_vec, data2_vec, 0x92);
-            b_vec        = _mm256_blend_ps(b_vec, data0_vec, 0x24);
-            _mm256_storeu_ps(base_r + w, _mm256_permutevar8x32_ps(r_vec, r_idx_vec));
-            _mm256_storeu_ps(base_g + w, _mm256_permutevar8x32_ps(g_vec, g_idx_vec));
-            _mm256_storeu_ps(base_b + w, _mm256_permutevar8x32_ps(b_vec, b_idx_vec));
+            __m256 r_vec, g_vec, b_vec;
+            v_load_deinterleave(base_in + 3 * w, r_vec, g_vec, b_vec);
+            _mm256_storeu_ps(base_r + w, r_vec);
+            _mm256_storeu_ps(base_g + w, g_vec);
+            _mm256_storeu_ps(base_b + w, b_vec);
         }
         for (int w = width / YMM_FP32_LANE_NUM * YMM_FP32_LANE_NUM; w < width; ++w) {
             base_r[w] = base_in[3 * w];
@@ -56,6 +56,7 @@ template <typename T, int32_t nc, ppl::cv::BorderType borderMode>
     int32_t inHeight,
     int32_t inWidth,
     int32_t inWidthStride,
+    int32_t rowBegin,
     int32_t outHeight,
     int32_t outWidth,
     int32_t outWidthStride,
@@ -71,8 +72,8 @@ template <typename T, int32_t nc, ppl::cv::BorderType borderMode>
         bdelta[x] = saturate_cast(M[3] * x * 1024);
     }
     for (int32_t i = 0; i < outHeight; i++) {
-        int32_t base_x    = saturate_cast((M[1] * i + M[2]) * 1024) + 512;
-        int32_t base_y    = saturate_cast((M[4] * i + M[5]) * 1024) + 512;
+        int32_t base_x    = saturate_cast((M[1] * (rowBegin + i) + M[2]) * 1024) + 512;
+        int32_t base_y    = saturate_cast((M[4] * (rowBegin + i) + M[5]) * 1024) + 512;
         __m256i baseX_vec = _mm256_set1_epi32(base_x);
         __m256i baseY_vec = _mm256_set1_epi32(base_y);
         for (int32_t block_j = 0; block_j < round_up(outWidth, 8); block_j += 8) {
@@ -126,6 +127,7 @@ template <int32_t nc, ppl::cv::BorderType borderMode>
     int32_t inHeight,
     int32_t inWidth,
     int32_t inWidthStride,
+    int32_t rowBegin,
     int32_t outHeight,
     int32_t outWidth,
     int32_t outWidthStride,
@@ -141,8 +143,8 @@ template <int32_t nc, ppl::cv::BorderType borderMode>
     __m256 m3_vec       = _mm256_set1_ps(M[3]);
     __m256 m0_vec       = _mm256_set1_ps(M[0]);
     for (int32_t i = 0; i < outHeight; i++) {
-        float base_x     = M[1] * i + M[2];
-        float base_y     = M[4] * i + M[5];
+        float base_x     = M[1] * (rowBegin + i) + M[2];
+        float base_y     = M[4] * (rowBegin + i) + M[5];
         __m256 baseX_vec = _mm256_set1_ps(base_x);
         __m256 baseY_vec = _mm256_set1_ps(base_y);
         for (int32_t block_j = 0; block_j < round_up(outWidth, 8); block_j += 8) {
@@ -277,6 +279,7 @@ template <int32_t nc, ppl::cv::BorderType borderMode>
     int32_t inHeight,
     int32_t inWidth,
     int32_t inWidthStride,
+    int32_t rowBegin,
     int32_t outHeight,
     int32_t outWidth,
     int32_t outWidthStride,
@@ -294,8 +297,8 @@ template <int32_t nc, ppl::cv::BorderType borderMode>
     __m256 m3_vec                   = _mm256_set1_ps(M[3]);
     __m256 m0_vec                   = _mm256_set1_ps(M[0]);
     for (int32_t i = 0; i < outHeight; i++) {
-        float base_x     = M[1] * i + M[2];
-        float base_y     = M[4] * i + M[5];
+        float base_x     = M[1] * (rowBegin + i) + M[2];
+        float base_y     = M[4] * (rowBegin + i) + M[5];
         __m256 baseX_vec = _mm256_set1_ps(base_x);
         __m256 baseY_vec = _mm256_set1_ps(base_y);
         for (int32_t block_j = 0; block_j < round_up(outWidth, 8); block_j += 8) {
@@ -436,6 +439,7 @@ template <typename T, int32_t nc, ppl::cv::BorderType borderMode>
     int32_t inHeight,
     int32_t inWidth,
     int32_t inWidthStride,
+    int32_t rowBegin,
     int32_t outHeight,
     int32_t outWidth,
     int32_t outWidthStride,
@@ -444,58 +448,58 @@ template <typename T, int32_t nc, ppl::cv::BorderType borderMode>
     const double *M,
     T delta)
 {
-    return warpaffine_linear<nc, borderMode>(inHeight, inWidth, inWidthStride, outHeight, outWidth, outWidthStride, dst, src, M, delta);
+    return warpaffine_linear<nc, borderMode>(inHeight, inWidth, inWidthStride, rowBegin, outHeight, outWidth, outWidthStride, dst, src, M, delta);
 }
 
-template ::ppl::common::RetCode warpaffine_linear<float, 1, BORDER_CONSTANT>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, float *dst, const float *src, const double *M, float delta);
-template ::ppl::common::RetCode warpaffine_linear<float, 2, BORDER_CONSTANT>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, float *dst, const float *src, const double *M, float delta);
-template ::ppl::common::RetCode warpaffine_linear<float, 3, BORDER_CONSTANT>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, float *dst, const float *src, const double *M, float delta);
-template ::ppl::common::RetCode warpaffine_linear<float, 4, BORDER_CONSTANT>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, float *dst, const float *src, const double *M, float delta);
-template ::ppl::common::RetCode warpaffine_linear<uint8_t, 1, BORDER_CONSTANT>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, uint8_t *dst, const uint8_t *src, const double *M, uint8_t delta);
-template ::ppl::common::RetCode warpaffine_linear<uint8_t, 2, BORDER_CONSTANT>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, uint8_t *dst, const uint8_t *src, const double *M, uint8_t delta);
-template ::ppl::common::RetCode warpaffine_linear<uint8_t, 3, BORDER_CONSTANT>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, uint8_t *dst, const uint8_t *src, const double *M, uint8_t delta);
-template ::ppl::common::RetCode warpaffine_linear<uint8_t, 4, BORDER_CONSTANT>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, uint8_t *dst, const uint8_t *src, const double *M, uint8_t delta);
-template ::ppl::common::RetCode warpaffine_linear<float, 1, BORDER_TRANSPARENT>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, float *dst, const float *src, const double *M, float delta);
-template ::ppl::common::RetCode warpaffine_linear<float, 2, BORDER_TRANSPARENT>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, float *dst, const float *src, const double *M, float delta);
-template ::ppl::common::RetCode warpaffine_linear<float, 3, BORDER_TRANSPARENT>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, float *dst, const float *src, const double *M, float delta);
-template ::ppl::common::RetCode warpaffine_linear<float, 4, BORDER_TRANSPARENT>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, float *dst, const float *src, const double *M, float delta);
-template ::ppl::common::RetCode warpaffine_linear<uint8_t, 1, BORDER_TRANSPARENT>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, uint8_t *dst, const uint8_t *src, const double *M, uint8_t delta);
-template ::ppl::common::RetCode warpaffine_linear<uint8_t, 2, BORDER_TRANSPARENT>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, uint8_t *dst, const uint8_t *src, const double *M, uint8_t delta);
-template ::ppl::common::RetCode warpaffine_linear<uint8_t, 3, BORDER_TRANSPARENT>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, uint8_t *dst, const uint8_t *src, const double *M, uint8_t delta);
-template ::ppl::common::RetCode warpaffine_linear<uint8_t, 4, BORDER_TRANSPARENT>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, uint8_t *dst, const uint8_t *src, const double *M, uint8_t delta);
-template ::ppl::common::RetCode warpaffine_linear<float, 1, BORDER_REPLICATE>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, float *dst, const float *src, const double *M, float delta);
-template ::ppl::common::RetCode warpaffine_linear<float, 2, BORDER_REPLICATE>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, float *dst, const float *src, const double *M, float delta);
-template ::ppl::common::RetCode warpaffine_linear<float, 3, BORDER_REPLICATE>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, float *dst, const float *src, const double *M, float delta);
-template ::ppl::common::RetCode warpaffine_linear<float, 4, BORDER_REPLICATE>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, float *dst, const float *src, const double *M, float delta);
-template ::ppl::common::RetCode warpaffine_linear<uint8_t, 1, BORDER_REPLICATE>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, uint8_t *dst, const uint8_t *src, const double *M, uint8_t delta);
-template ::ppl::common::RetCode warpaffine_linear<uint8_t, 2, BORDER_REPLICATE>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, uint8_t *dst, const uint8_t *src, const double *M, uint8_t delta);
-template ::ppl::common::RetCode warpaffine_linear<uint8_t, 3, BORDER_REPLICATE>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, uint8_t *dst, const uint8_t *src, const double *M, uint8_t delta);
-template ::ppl::common::RetCode warpaffine_linear<uint8_t, 4, BORDER_REPLICATE>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, uint8_t *dst, const uint8_t *src, const double *M, uint8_t delta);
+template ::ppl::common::RetCode warpaffine_linear<float, 1, BORDER_CONSTANT>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t rowBegin, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, float *dst, const float *src, const double *M, float delta);
+template ::ppl::common::RetCode warpaffine_linear<float, 2, BORDER_CONSTANT>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t rowBegin, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, float *dst, const float *src, const double *M, float delta);
+template ::ppl::common::RetCode warpaffine_linear<float, 3, BORDER_CONSTANT>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t rowBegin, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, float *dst, const float *src, const double *M, float delta);
+template ::ppl::common::RetCode warpaffine_linear<float, 4, BORDER_CONSTANT>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t rowBegin, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, float *dst, const float *src, const double *M, float delta);
+template ::ppl::common::RetCode warpaffine_linear<uint8_t, 1, BORDER_CONSTANT>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t rowBegin, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, uint8_t *dst, const uint8_t *src, const double *M, uint8_t delta);
+template ::ppl::common::RetCode warpaffine_linear<uint8_t, 2, BORDER_CONSTANT>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t rowBegin, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, uint8_t *dst, const uint8_t *src, const double *M, uint8_t delta);
+template ::ppl::common::RetCode warpaffine_linear<uint8_t, 3, BORDER_CONSTANT>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t rowBegin, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, uint8_t *dst, const uint8_t *src, const double *M, uint8_t delta);
+template ::ppl::common::RetCode warpaffine_linear<uint8_t, 4, BORDER_CONSTANT>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t rowBegin, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, uint8_t *dst, const uint8_t *src, const double *M, uint8_t delta);
+template ::ppl::common::RetCode warpaffine_linear<float, 1, BORDER_TRANSPARENT>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t rowBegin, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, float *dst, const float *src, const double *M, float delta);
+template ::ppl::common::RetCode warpaffine_linear<float, 2, BORDER_TRANSPARENT>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t rowBegin, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, float *dst, const float *src, const double *M, float delta);
+template ::ppl::common::RetCode warpaffine_linear<float, 3, BORDER_TRANSPARENT>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t rowBegin, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, float *dst, const float *src, const double *M, float delta);
+template ::ppl::common::RetCode warpaffine_linear<float, 4, BORDER_TRANSPARENT>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t rowBegin, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, float *dst, const float *src, const double *M, float delta);
+template ::ppl::common::RetCode warpaffine_linear<uint8_t, 1, BORDER_TRANSPARENT>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t rowBegin, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, uint8_t *dst, const uint8_t *src, const double *M, uint8_t delta);
+template ::ppl::common::RetCode warpaffine_linear<uint8_t, 2, BORDER_TRANSPARENT>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t rowBegin, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, uint8_t *dst, const uint8_t *src, const double *M, uint8_t delta);
+template ::ppl::common::RetCode warpaffine_linear<uint8_t, 3, BORDER_TRANSPARENT>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t rowBegin, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, uint8_t *dst, const uint8_t *src, const double *M, uint8_t delta);
+template ::ppl::common::RetCode warpaffine_linear<uint8_t, 4, BORDER_TRANSPARENT>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t rowBegin, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, uint8_t *dst, const uint8_t *src, const double *M, uint8_t delta);
+template ::ppl::common::RetCode warpaffine_linear<float, 1, BORDER_REPLICATE>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t rowBegin, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, float *dst, const float *src, const double *M, float delta);
+template ::ppl::common::RetCode warpaffine_linear<float, 2, BORDER_REPLICATE>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t rowBegin, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, float *dst, const float *src, const double *M, float delta);
+template ::ppl::common::RetCode warpaffine_linear<float, 3, BORDER_REPLICATE>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t rowBegin, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, float *dst, const float *src, const double *M, float delta);
+template ::ppl::common::RetCode warpaffine_linear<float, 4, BORDER_REPLICATE>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t rowBegin, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, float *dst, const float *src, const double *M, float delta);
+template ::ppl::common::RetCode warpaffine_linear<uint8_t, 1, BORDER_REPLICATE>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t rowBegin, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, uint8_t *dst, const uint8_t *src, const double *M, uint8_t delta);
+template ::ppl::common::RetCode warpaffine_linear<uint8_t, 2, BORDER_REPLICATE>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t rowBegin, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, uint8_t *dst, const uint8_t *src, const double *M, uint8_t delta);
+template ::ppl::common::RetCode warpaffine_linear<uint8_t, 3, BORDER_REPLICATE>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t rowBegin, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, uint8_t *dst, const uint8_t *src, const double *M, uint8_t delta);
+template ::ppl::common::RetCode warpaffine_linear<uint8_t, 4, BORDER_REPLICATE>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t rowBegin, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, uint8_t *dst, const uint8_t *src, const double *M, uint8_t delta);
 
-template ::ppl::common::RetCode warpaffine_nearest<float, 1, BORDER_CONSTANT>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, float *dst, const float *src, const double *M, float delta);
-template ::ppl::common::RetCode warpaffine_nearest<float, 2, BORDER_CONSTANT>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, float *dst, const float *src, const double *M, float delta);
-template ::ppl::common::RetCode warpaffine_nearest<float, 3, BORDER_CONSTANT>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, float *dst, const float *src, const double *M, float delta);
-template ::ppl::common::RetCode warpaffine_nearest<float, 4, BORDER_CONSTANT>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, float *dst, const float *src, const double *M, float delta);
-template ::ppl::common::RetCode warpaffine_nearest<uint8_t, 1, BORDER_CONSTANT>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, uint8_t *dst, const uint8_t *src, const double *M, uint8_t delta);
-template ::ppl::common::RetCode warpaffine_nearest<uint8_t, 2, BORDER_CONSTANT>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, uint8_t *dst, const uint8_t *src, const double *M, uint8_t delta);
-template ::ppl::common::RetCode warpaffine_nearest<uint8_t, 3, BORDER_CONSTANT>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, uint8_t *dst, const uint8_t *src, const double *M, uint8_t delta);
-template ::ppl::common::RetCode warpaffine_nearest<uint8_t, 4, BORDER_CONSTANT>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, uint8_t *dst, const uint8_t *src, const double *M, uint8_t delta);
-template ::ppl::common::RetCode warpaffine_nearest<float, 1, BORDER_TRANSPARENT>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, float *dst, const float *src, const double *M, float delta);
-template ::ppl::common::RetCode warpaffine_nearest<float, 2, BORDER_TRANSPARENT>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, float *dst, const float *src, const double *M, float delta);
-template ::ppl::common::RetCode warpaffine_nearest<float, 3, BORDER_TRANSPARENT>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, float *dst, const float *src, const double *M, float delta);
-template ::ppl::common::RetCode warpaffine_nearest<float, 4, BORDER_TRANSPARENT>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, float *dst, const float *src, const double *M, float delta);
-template ::ppl::common::RetCode warpaffine_nearest<uint8_t, 1, BORDER_TRANSPARENT>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, uint8_t *dst, const uint8_t *src, const double *M, uint8_t delta);
-template ::ppl::common::RetCode warpaffine_nearest<uint8_t, 2, BORDER_TRANSPARENT>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, uint8_t *dst, const uint8_t *src, const double *M, uint8_t delta);
-template ::ppl::common::RetCode warpaffine_nearest<uint8_t, 3, BORDER_TRANSPARENT>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, uint8_t *dst, const uint8_t *src, const double *M, uint8_t delta);
-template ::ppl::common::RetCode warpaffine_nearest<uint8_t, 4, BORDER_TRANSPARENT>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, uint8_t *dst, const uint8_t *src, const double *M, uint8_t delta);
-template ::ppl::common::RetCode warpaffine_nearest<float, 1, BORDER_REPLICATE>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, float *dst, const float *src, const double *M, float delta);
-template ::ppl::common::RetCode warpaffine_nearest<float, 2, BORDER_REPLICATE>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, float *dst, const float *src, const double *M, float delta);
-template ::ppl::common::RetCode warpaffine_nearest<float, 3, BORDER_REPLICATE>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, float *dst, const float *src, const double *M, float delta);
-template ::ppl::common::RetCode warpaffine_nearest<float, 4, BORDER_REPLICATE>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, float *dst, const float *src, const double *M, float delta);
-template ::ppl::common::RetCode warpaffine_nearest<uint8_t, 1, BORDER_REPLICATE>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, uint8_t *dst, const uint8_t *src, const double *M, uint8_t delta);
-template ::ppl::common::RetCode warpaffine_nearest<uint8_t, 2, BORDER_REPLICATE>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, uint8_t *dst, const uint8_t *src, const double *M, uint8_t delta);
-template ::ppl::common::RetCode warpaffine_nearest<uint8_t, 3, BORDER_REPLICATE>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, uint8_t *dst, const uint8_t *src, const double *M, uint8_t delta);
-template ::ppl::common::RetCode warpaffine_nearest<uint8_t, 4, BORDER_REPLICATE>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, uint8_t *dst, const uint8_t *src, const double *M, uint8_t delta);
+template ::ppl::common::RetCode warpaffine_nearest<float, 1, BORDER_CONSTANT>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t rowBegin, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, float *dst, const float *src, const double *M, float delta);
+template ::ppl::common::RetCode warpaffine_nearest<float, 2, BORDER_CONSTANT>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t rowBegin, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, float *dst, const float *src, const double *M, float delta);
+template ::ppl::common::RetCode warpaffine_nearest<float, 3, BORDER_CONSTANT>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t rowBegin, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, float *dst, const float *src, const double *M, float delta);
+template ::ppl::common::RetCode warpaffine_nearest<float, 4, BORDER_CONSTANT>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t rowBegin, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, float *dst, const float *src, const double *M, float delta);
+template ::ppl::common::RetCode warpaffine_nearest<uint8_t, 1, BORDER_CONSTANT>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t rowBegin, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, uint8_t *dst, const uint8_t *src, const double *M, uint8_t delta);
+template ::ppl::common::RetCode warpaffine_nearest<uint8_t, 2, BORDER_CONSTANT>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t rowBegin, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, uint8_t *dst, const uint8_t *src, const double *M, uint8_t delta);
+template ::ppl::common::RetCode warpaffine_nearest<uint8_t, 3, BORDER_CONSTANT>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t rowBegin, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, uint8_t *dst, const uint8_t *src, const double *M, uint8_t delta);
+template ::ppl::common::RetCode warpaffine_nearest<uint8_t, 4, BORDER_CONSTANT>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t rowBegin, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, uint8_t *dst, const uint8_t *src, const double *M, uint8_t delta);
+template ::ppl::common::RetCode warpaffine_nearest<float, 1, BORDER_TRANSPARENT>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t rowBegin, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, float *dst, const float *src, const double *M, float delta);
+template ::ppl::common::RetCode warpaffine_nearest<float, 2, BORDER_TRANSPARENT>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t rowBegin, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, float *dst, const float *src, const double *M, float delta);
+template ::ppl::common::RetCode warpaffine_nearest<float, 3, BORDER_TRANSPARENT>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t rowBegin, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, float *dst, const float *src, const double *M, float delta);
+template ::ppl::common::RetCode warpaffine_nearest<float, 4, BORDER_TRANSPARENT>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t rowBegin, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, float *dst, const float *src, const double *M, float delta);
+template ::ppl::common::RetCode warpaffine_nearest<uint8_t, 1, BORDER_TRANSPARENT>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t rowBegin, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, uint8_t *dst, const uint8_t *src, const double *M, uint8_t delta);
+template ::ppl::common::RetCode warpaffine_nearest<uint8_t, 2, BORDER_TRANSPARENT>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t rowBegin, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, uint8_t *dst, const uint8_t *src, const double *M, uint8_t delta);
+template ::ppl::common::RetCode warpaffine_nearest<uint8_t, 3, BORDER_TRANSPARENT>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t rowBegin, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, uint8_t *dst, const uint8_t *src, const double *M, uint8_t delta);
+template ::ppl::common::RetCode warpaffine_nearest<uint8_t, 4, BORDER_TRANSPARENT>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t rowBegin, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, uint8_t *dst, const uint8_t *src, const double *M, uint8_t delta);
+template ::ppl::common::RetCode warpaffine_nearest<float, 1, BORDER_REPLICATE>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t rowBegin, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, float *dst, const float *src, const double *M, float delta);
+template ::ppl::common::RetCode warpaffine_nearest<float, 2, BORDER_REPLICATE>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t rowBegin, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, float *dst, const float *src, const double *M, float delta);
+template ::ppl::common::RetCode warpaffine_nearest<float, 3, BORDER_REPLICATE>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t rowBegin, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, float *dst, const float *src, const double *M, float delta);
+template ::ppl::common::RetCode warpaffine_nearest<float, 4, BORDER_REPLICATE>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t rowBegin, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, float *dst, const float *src, const double *M, float delta);
+template ::ppl::common::RetCode warpaffine_nearest<uint8_t, 1, BORDER_REPLICATE>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t rowBegin, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, uint8_t *dst, const uint8_t *src, const double *M, uint8_t delta);
+template ::ppl::common::RetCode warpaffine_nearest<uint8_t, 2, BORDER_REPLICATE>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t rowBegin, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, uint8_t *dst, const uint8_t *src, const double *M, uint8_t delta);
+template ::ppl::common::RetCode warpaffine_nearest<uint8_t, 3, BORDER_REPLICATE>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t rowBegin, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, uint8_t *dst, const uint8_t *src, const double *M, uint8_t delta);
+template ::ppl::common::RetCode warpaffine_nearest<uint8_t, 4, BORDER_REPLICATE>(int32_t inHeight, int32_t inWidth, int32_t inWidthStride, int32_t rowBegin, int32_t outHeight, int32_t outWidth, int32_t outWidthStride, uint8_t *dst, const uint8_t *src, const double *M, uint8_t delta);
 }
 }
 }
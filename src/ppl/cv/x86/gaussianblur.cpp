@@ -20,9 +20,11 @@
 #include "ppl/cv/types.h"
 #include "ppl/common/sys.h"
 #include "ppl/common/x86/sysinfo.h"
+#include "ppl/cv/x86/isa.hpp"
 #include <string.h>
 #include <cmath>
-#include "ppl/cv/x86/copymakeborder.h"
+#include "ppl/cv/x86/parallel.hpp"
+#include "ppl/cv/x86/filter_engine.hpp"
 #include <limits.h>
 #include <immintrin.h>
 #include <algorithm>
@@ -32,7 +34,7 @@ namespace ppl {
 namespace cv {
 namespace x86 {
 
-int32_t borderInterpolate(int32_t p, int32_t len, BorderType borderType = BORDER_REFLECT_101)
+static int32_t borderInterpolate(int32_t p, int32_t len, BorderType borderType = BORDER_REFLECT_101)
 {
     if (borderType == ppl::cv::BORDER_REFLECT_101) {
         do p = p < 0 ? (-p) : 2 * len - p - 2;
@@ -208,12 +210,14 @@ static void createGaussianKernels(std::vector<float> &k, int32_t ksize, double s
     k = getGaussianKernel(sigma, ksize);
 }
 
+namespace {
+
 struct RowVec_32f {
     RowVec_32f(const std::vector<float> &_kernel)
     {
         kernel      = _kernel;
         core        = 1;
-        bSupportAVX = ppl::common::CpuSupports(ppl::common::ISA_X86_AVX);
+        bSupportAVX = isa_supported(ppl::common::ISA_X86_AVX);
     }
 
     void operator()(const float *_src, float *_dst, int32_t width, int32_t cn) const
@@ -244,10 +248,18 @@ struct SymmColumnVec_32f {
     {
         kernel      = _kernel;
         core        = 1;
-        bSupportAVX = ppl::common::CpuSupports(ppl::common::ISA_X86_AVX);
+        bSupportAVX = isa_supported(ppl::common::ISA_X86_AVX);
+    }
+
+    void operator()(const float **src, float *dst, int32_t dststep, int32_t count, int32_t width) const
+    {
+        int32_t ksize2 = kernel.size() / 2;
+        for (; count-- > 0; src++, dst += dststep) {
+            row(src + ksize2, dst, width);
+        }
     }
 
-    void operator()(float **_src, float *_dst, int32_t width) const
+    void row(const float **_src, float *_dst, int32_t width) const
     {
         int32_t ksize2    = (kernel.size()) / 2;
         const float *ky   = &kernel[ksize2];
@@ -277,7 +289,7 @@ struct RowVec_32f_k3 {
     {
         kernel      = _kernel;
         core        = 1;
-        bSupportAVX = ppl::common::CpuSupports(ppl::common::ISA_X86_AVX);
+        bSupportAVX = isa_supported(ppl::common::ISA_X86_AVX);
     }
 
     void operator()(const float **_src, float *_dst, int32_t width, int32_t cn, int32_t dstep) const
@@ -317,7 +329,7 @@ struct RowVec_32f_k3_raw {
     {
         kernel      = _kernel;
         core        = 1;
-        bSupportAVX = ppl::common::CpuSupports(ppl::common::ISA_X86_AVX);
+        bSupportAVX = isa_supported(ppl::common::ISA_X86_AVX);
     }
 
     void operator()(const float **_src, float *_dst, int32_t width, int32_t cn, int32_t dstep) const
@@ -350,7 +362,7 @@ struct RowVec_32f_k5_raw {
     {
         kernel      = _kernel;
         core        = 1;
-        bSupportAVX = ppl::common::CpuSupports(ppl::common::ISA_X86_AVX);
+        bSupportAVX = isa_supported(ppl::common::ISA_X86_AVX);
     }
 
     void operator()(const float **_src, float *_dst, int32_t width, int32_t cn, int32_t dstep) const
@@ -388,7 +400,7 @@ struct RowVec_32f_k5 {
     {
         kernel      = _kernel;
         core        = 1;
-        bSupportAVX = ppl::common::CpuSupports(ppl::common::ISA_X86_AVX);
+        bSupportAVX = isa_supported(ppl::common::ISA_X86_AVX);
     }
 
     void operator()(const float **_src, float *_dst, int32_t width, int32_t cn, int32_t dstep) const
@@ -517,7 +529,15 @@ struct SymmColumnVec_32s8u {
         delta = (float)(_delta / (1 << _bits));
     }
 
-    void operator()(int32_t **_src, uint8_t *dst, int32_t width) const
+    void operator()(const int32_t **src, uint8_t *dst, int32_t dststep, int32_t count, int32_t width) const
+    {
+        int32_t ksize2 = kernel.size() / 2;
+        for (; count-- > 0; src++, dst += dststep) {
+            row(src + ksize2, dst, width);
+        }
+    }
+
+    void row(const int32_t **_src, uint8_t *dst, int32_t width) const
     {
         int32_t ksize2      = kernel.size() / 2;
         const float *ky     = &kernel[ksize2];
@@ -600,6 +620,8 @@ struct SymmColumnVec_32s8u {
     float delta;
     std::vector<float> kernel;
 };
+} // namespace
+
 void x86GaussianBlur_fs3(
     int32_t height,
     int32_t width,
@@ -643,19 +665,25 @@ void x86GaussianBlur_fs3(
         leftrightBor[i + lrheight] = left_right + (i)*lrstep + 3 * radius * cn;
     }
 
-    RowVec_32f_k3 rowVecOp = RowVec_32f_k3(kernel);
-    int32_t i              = 0;
-    for (; i <= innerHeight - 9; i += 9) {
-        const float **src = pReRowFilter + i + radius;
-        float *dst        = outData + (i + radius) * outWidthStride + radius * cn;
-        rowVecOp.operator()((const float **)src, dst, innerWidth, cn, outWidthStride);
-    }
+    RowVec_32f_k3 rowVecOp         = RowVec_32f_k3(kernel);
     RowVec_32f_k3_raw rowVecOp_raw = RowVec_32f_k3_raw(kernel);
-    for (; i < innerHeight; i++) {
-        const float **src = pReRowFilter + i + radius;
-        float *dst        = outData + (i + radius) * outWidthStride + radius * cn;
-        rowVecOp_raw.operator()((const float **)src, dst, innerWidth, cn, outWidthStride);
-    }
+    // the blocked operator computes 9 rows per call; each band runs whole
+    // blocks from its own start row and finishes its tail with the raw one.
+    parallel_for_rows(innerHeight, innerWidth * cn * kernel_len, [&](int32_t begin, int32_t end) {
+        int32_t i = begin;
+        for (; i <= end - 9; i += 9) {
+            const float **src = pReRowFilter + i + radius;
+            float *dst        = outData + (i + radius) * outWidthStride + radius * cn;
+            rowVecOp.operator()((const float **)src, dst, innerWidth, cn, outWidthStride);
+        }
+        for (; i < end; i++) {
+            const float **src = pReRowFilter + i + radius;
+            float *dst        = outData + (i + radius) * outWidthStride + radius * cn;
+            rowVecOp_raw.operator()((const float **)src, dst, innerWidth, cn, outWidthStride);
+        }
+    }, 9);
+
+    int32_t i = 0;
 
     for (i = 0; i < radius; i++) {
         const float **src = updownBor + i + radius;
@@ -725,20 +753,25 @@ void x86GaussianBlur_fs5(
         leftrightBor[i + lrheight] = left_right + (i)*lrstep + 3 * radius * cn;
     }
 
-    RowVec_32f_k5 rowVecOp = RowVec_32f_k5(kernel);
-    int32_t i              = 0;
-    for (; i <= innerHeight - 10; i += 10) {
-        const float **src = pReRowFilter + i + radius;
-        float *dst        = outData + (i + radius) * outWidthStride + radius * cn;
-        rowVecOp.operator()((const float **)src, dst, innerWidth, cn, outWidthStride);
-    }
-
+    RowVec_32f_k5 rowVecOp         = RowVec_32f_k5(kernel);
     RowVec_32f_k5_raw rowVecOp_raw = RowVec_32f_k5_raw(kernel);
-    for (; i < innerHeight; i++) {
-        const float **src = pReRowFilter + i + radius;
-        float *dst        = outData + (i + radius) * outWidthStride + radius * cn;
-        rowVecOp_raw.operator()((const float **)src, dst, innerWidth, cn, outWidthStride);
-    }
+    // the blocked operator computes 10 rows per call; each band runs whole
+    // blocks from its own start row and finishes its tail with the raw one.
+    parallel_for_rows(innerHeight, innerWidth * cn * kernel_len, [&](int32_t begin, int32_t end) {
+        int32_t i = begin;
+        for (; i <= end - 10; i += 10) {
+            const float **src = pReRowFilter + i + radius;
+            float *dst        = outData + (i + radius) * outWidthStride + radius * cn;
+            rowVecOp.operator()((const float **)src, dst, innerWidth, cn, outWidthStride);
+        }
+        for (; i < end; i++) {
+            const float **src = pReRowFilter + i + radius;
+            float *dst        = outData + (i + radius) * outWidthStride + radius * cn;
+            rowVecOp_raw.operator()((const float **)src, dst, innerWidth, cn, outWidthStride);
+        }
+    }, 10);
+
+    int32_t i = 0;
 
     for (i = 0; i < radius; i++) {
         const float **src = updownBor + i + radius;
@@ -767,6 +800,8 @@ void x86GaussianBlur_fs5(
     free(leftrightBor);
 }
 
+// Any kernel and border: rows stream through the filter engine instead of a
+// bordered copy of the whole image.
 template <int cn>
 void x86GaussianBlur_flarge(
     int32_t height,
@@ -781,99 +816,11 @@ void x86GaussianBlur_flarge(
 {
     std::vector<float> kernel;
     createGaussianKernels(kernel, kernel_len, sigma, sense32F);
+    kernel_len = kernel.size();
 
-    int32_t radius     = kernel_len / 2;
-    int32_t bsrcHeight = height + 2 * radius;
-    int32_t bsrcWidth  = width + 2 * radius;
-
-    int32_t bsrcWidthStep = (bsrcWidth + 7) / 8 * 8 * cn;
-    float *bsrc           = (float *)_mm_malloc(bsrcHeight * bsrcWidthStep * sizeof(float), 64);
-    // makeborder<float>(inData,height,width, inWidthStride,
-    //         bsrc, bsrcHeight, bsrcWidth, bsrcWidthStep, cn);
-    CopyMakeBorder<float, cn>(height, width, inWidthStride, inData, bsrcHeight, bsrcWidth, bsrcWidthStep, bsrc, border_type);
-    float *resultRowFilter = bsrc;
-    float **pReRowFilter   = (float **)malloc(bsrcHeight * sizeof(resultRowFilter));
-    for (int32_t i = 0; i < bsrcHeight; i++) {
-        pReRowFilter[i] = resultRowFilter + (i)*bsrcWidthStep;
-    }
-
-    RowVec_32f rowVecOp = RowVec_32f(kernel);
-    for (int32_t i = 0; i < bsrcHeight; i++) {
-        float *src = bsrc + i * bsrcWidthStep;
-        float *dst = resultRowFilter + i * bsrcWidthStep;
-        rowVecOp.operator()(src, dst, width, cn);
-    }
-
-    SymmColumnVec_32f colVecOp = SymmColumnVec_32f(kernel);
-
-    for (int32_t i = 0; i < height; i++) {
-        float **src = pReRowFilter + i + radius;
-        float *dst  = outData + i * outWidthStride;
-        colVecOp.operator()(src, dst, width *cn);
-    }
-
-    _mm_free(bsrc);
-    free(pReRowFilter);
-    bsrc         = NULL;
-    pReRowFilter = NULL;
-}
-
-template<int cn>
-void x86GaussianBlur_f_vector(
-    int32_t height,
-    int32_t width,
-    const float *inData,
-    int32_t kernel_len,
-    float sigma,
-    float *outData,
-    ppl::cv::BorderType border_type)
-{
-    std::vector<float> kernel;
-    createGaussianKernels(kernel, kernel_len, sigma, sense32F);
-
-    int32_t radius    = kernel_len / 2;
-    int32_t radius_cn = radius * cn;
-    int32_t pad_size  = 3 * radius_cn * 2;
-    float*  pad_data   = (float *) malloc(pad_size * sizeof(inData));
-
-    int32_t i, j, size = sizeof(float);
-    int32_t length     = width ^ 1 ? width : height;
-    int32_t length_cn  = length * cn;
-    // make border
-    for (i = 0; i < radius; i++) {
-        j = borderInterpolate(i - radius, length, border_type);
-        memcpy(pad_data + i * cn, inData + j * cn, cn * size);
-
-        j = borderInterpolate(length + i, length, border_type);
-        memcpy(pad_data + 5 * radius_cn + i * cn, inData + j * cn, cn * size);
-    }
-    memcpy(pad_data + radius_cn, inData, 2 * radius_cn * size);
-    memcpy(pad_data + 3 * radius_cn, inData + length_cn - 2 * radius_cn, 2 * radius_cn * size);
-
-    // do gaussianblur on pad data
-    for (i = 0; i < radius_cn; i++) {
-        float* src0 = pad_data + i;
-        float* src1 = pad_data + 3 * radius_cn + i;
-        float res0 = 0, res1 = 0;
-        for (j = 0; j < kernel_len; j++, src0 += cn, src1 += cn) {
-            res0 += src0[0] * kernel[j];
-            res1 += src1[0] * kernel[j];
-        }
-        outData[i] = res0;
-        outData[length_cn - radius_cn + i] = res1;
-    }
-
-    // do gaussianblur on src data
-    for (i = 0;i < length_cn - 2 * radius_cn; i++) {
-        const float* src = inData + i;
-        float res = 0;
-        for (j = 0; j < kernel_len; j++, src += cn) {
-            res += src[0] * kernel[j];
-        }
-        outData[radius_cn + i] = res;
-    }
-
-    free(pad_data);
+    SeparableFilterEngine<float, float, float, RowVec_32f, SymmColumnVec_32f> engine(
+        height, width, cn, kernel_len, kernel_len, border_type, 0.f, RowVec_32f(kernel), SymmColumnVec_32f(kernel));
+    engine.process(inData, inWidthStride, outData, outWidthStride);
 }
 
 template <int cn>
@@ -888,18 +835,12 @@ void x86GaussianBlur_f(
     float *outData,
     ppl::cv::BorderType border_type)
 {
-    // only one element
-    if (height == 1 && width == 1) {
-        outData[0] = inData[0];
-        return;
-    }
-    // vector
-    if (height == 1 || width == 1) {
-        x86GaussianBlur_f_vector<cn>(height, width, inData, kernel_len, sigma, outData, border_type);
-        return;
-    }
     int32_t radius = kernel_len / 2;
-    if (radius == 1 && border_type == ppl::cv::BORDER_REFLECT_101)
+    // the on-the-fly border of the 3x3 and 5x5 kernels reads 2 * radius rows
+    // and columns, and their inner part needs one more
+    if (height < kernel_len || width < kernel_len)
+        x86GaussianBlur_flarge<cn>(height, width, inWidthStride, inData, kernel_len, sigma, outWidthStride, outData, border_type);
+    else if (radius == 1 && border_type == ppl::cv::BORDER_REFLECT_101)
         x86GaussianBlur_fs3(height, width, inWidthStride, inData, kernel_len, sigma, outWidthStride, outData, cn);
     else if (radius == 2 && border_type == ppl::cv::BORDER_REFLECT_101)
         x86GaussianBlur_fs5(height, width, inWidthStride, inData, kernel_len, sigma, outWidthStride, outData, cn);
@@ -921,6 +862,7 @@ void x86GaussianBlur_b(
 {
     std::vector<float> kernel_f;
     createGaussianKernels(kernel_f, kernel_len, sigma, sense8U);
+    kernel_len = kernel_f.size();
 
     std::vector<int32_t> kernel(kernel_f.size());
     int32_t bits = 8;
@@ -928,41 +870,9 @@ void x86GaussianBlur_b(
         kernel[i] = kernel_f[i] * (1 << bits);
     }
 
-    int32_t radius     = kernel_len / 2;
-    int32_t bsrcHeight = height + 2 * radius;
-    int32_t bsrcWidth  = width + 2 * radius;
-
-    int32_t bsrcWidthStep = (bsrcWidth)*cn;
-    uint8_t *bsrc           = (uint8_t *)malloc(bsrcHeight * bsrcWidth * cn * sizeof(uint8_t));
-    CopyMakeBorder<uint8_t, cn>(height, width, inWidthStride, inData, bsrcHeight, bsrcWidth, bsrcWidthStep, bsrc, border_type);
-
-    int32_t alignWidth       = (width + 3) / 4 * 4;
-    int32_t rfstep           = alignWidth * cn;
-    int32_t *resultRowFilter = (int32_t *)_mm_malloc(bsrcHeight * alignWidth * cn * sizeof(int32_t), 32);
-
-    RowVec_8u32s rowVecOp = RowVec_8u32s(kernel);
-
-    for (int32_t i = 0; i < bsrcHeight; i++) {
-        uint8_t *src   = bsrc + i * bsrcWidthStep;
-        int32_t *dst = resultRowFilter + i * rfstep;
-        rowVecOp.operator()(src, dst, width, cn);
-    }
-    SymmColumnVec_32s8u colVecOp = SymmColumnVec_32s8u(kernel, bits * 2, 0);
-    int32_t **pReRowFilter       = (int32_t **)malloc(bsrcHeight * sizeof(resultRowFilter));
-    for (int32_t i = 0; i < bsrcHeight; i++) {
-        pReRowFilter[i] = resultRowFilter + (i)*rfstep;
-    }
-    for (int32_t i = 0; i < height; i++) {
-        int32_t **src = pReRowFilter + i + radius;
-        uint8_t *dst    = outData + i * outWidthStride;
-        colVecOp.operator()(src, dst, width *cn);
-    }
-    free(bsrc);
-    _mm_free(resultRowFilter);
-    free(pReRowFilter);
-    bsrc            = NULL;
-    resultRowFilter = NULL;
-    pReRowFilter    = NULL;
+    SeparableFilterEngine<uint8_t, int32_t, uint8_t, RowVec_8u32s, SymmColumnVec_32s8u> engine(
+        height, width, cn, kernel_len, kernel_len, border_type, 0, RowVec_8u32s(kernel), SymmColumnVec_32s8u(kernel, bits * 2, 0));
+    engine.process(inData, inWidthStride, outData, outWidthStride);
 }
 
 template <>
@@ -983,7 +893,10 @@ template <>
     if (width == 0 || height == 0 || inWidthStride < width || outWidthStride == 0) {
         return ppl::common::RC_INVALID_VALUE;
     }
-    bool bSupportAVX = ppl::common::CpuSupports(ppl::common::ISA_X86_AVX);
+    if (!filter_border_supported(border_type)) {
+        return ppl::common::RC_INVALID_VALUE;
+    }
+    bool bSupportAVX = isa_supported(ppl::common::ISA_X86_AVX);
     if (bSupportAVX) {
         x86GaussianBlur_f_avx<3>(height, width, inWidthStride, inData, kernel_len, sigma, outWidthStride, outData, border_type);
     } else {
@@ -1010,7 +923,10 @@ template <>
     if (width == 0 || height == 0 || inWidthStride < width || outWidthStride == 0) {
         return ppl::common::RC_INVALID_VALUE;
     }
-    bool bSupportAVX = ppl::common::CpuSupports(ppl::common::ISA_X86_AVX);
+    if (!filter_border_supported(border_type)) {
+        return ppl::common::RC_INVALID_VALUE;
+    }
+    bool bSupportAVX = isa_supported(ppl::common::ISA_X86_AVX);
     if (bSupportAVX) {
         x86GaussianBlur_f_avx<1>(height, width, inWidthStride, inData, kernel_len, sigma, outWidthStride, outData, border_type);
     } else {
@@ -1036,7 +952,10 @@ template <>
     if (width == 0 || height == 0 || inWidthStride < width || outWidthStride == 0) {
         return ppl::common::RC_INVALID_VALUE;
     }
-    bool bSupportAVX = ppl::common::CpuSupports(ppl::common::ISA_X86_AVX);
+    if (!filter_border_supported(border_type)) {
+        return ppl::common::RC_INVALID_VALUE;
+    }
+    bool bSupportAVX = isa_supported(ppl::common::ISA_X86_AVX);
     if (bSupportAVX) {
         x86GaussianBlur_f_avx<4>(height, width, inWidthStride, inData, kernel_len, sigma, outWidthStride, outData, border_type);
     } else {
@@ -1063,6 +982,9 @@ template <>
     if (width == 0 || height == 0 || inWidthStride < width || outWidthStride == 0) {
         return ppl::common::RC_INVALID_VALUE;
     }
+    if (!filter_border_supported(border_type)) {
+        return ppl::common::RC_INVALID_VALUE;
+    }
     x86GaussianBlur_b<uint8_t, 3>(height, width, inWidthStride, inData, kernel_len, sigma, outWidthStride, outData, border_type);
     return ppl::common::RC_SUCCESS;
 }
@@ -1084,6 +1006,9 @@ template <>
     if (width == 0 || height == 0 || inWidthStride < width || outWidthStride == 0) {
         return ppl::common::RC_INVALID_VALUE;
     }
+    if (!filter_border_supported(border_type)) {
+        return ppl::common::RC_INVALID_VALUE;
+    }
     x86GaussianBlur_b<uint8_t, 1>(height, width, inWidthStride, inData, kernel_len, sigma, outWidthStride, outData, border_type);
     return ppl::common::RC_SUCCESS;
 }
@@ -1105,6 +1030,9 @@ template <>
     if (width == 0 || height == 0 || inWidthStride < width || outWidthStride == 0) {
         return ppl::common::RC_INVALID_VALUE;
     }
+    if (!filter_border_supported(border_type)) {
+        return ppl::common::RC_INVALID_VALUE;
+    }
     x86GaussianBlur_b<uint8_t, 4>(height, width, inWidthStride, inData, kernel_len, sigma, outWidthStride, outData, border_type);
     return ppl::common::RC_SUCCESS;
 }
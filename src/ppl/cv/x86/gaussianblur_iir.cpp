@@ -0,0 +1,538 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "ppl/cv/x86/gaussianblur.h"
+#include "ppl/cv/x86/fma/internal_fma.hpp"
+#include "ppl/cv/x86/filter_engine.hpp"
+#include "ppl/cv/x86/isa.hpp"
+#include "ppl/cv/types.h"
+#include "ppl/common/sys.h"
+#include "ppl/common/x86/sysinfo.h"
+#include <string.h>
+#include <cmath>
+#include <complex>
+#include <immintrin.h>
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+
+namespace ppl {
+namespace cv {
+namespace x86 {
+
+// Lines filtered together: image rows are blocked by GAUSSIAN_IIR_ROWS so that
+// a block gives GAUSSIAN_IIR_ROWS * channels lanes, and columns are split into
+// strips of GAUSSIAN_IIR_STRIP floats, which keeps a strip of a 1080 row image
+// in L2.
+#define GAUSSIAN_IIR_ROWS      8
+#define GAUSSIAN_IIR_STRIP     64
+#define GAUSSIAN_IIR_MAX_LANES 64
+#define GAUSSIAN_IIR_PREFETCH  16
+
+// Coefficients of the recursions, laid out as the line kernels read them.
+// GAUSSIAN_IIR_FAST, van Vliet, Young and Verbeek (1998), a 3 pole cascade:
+//   w[n] = B x[n] - d1 w[n-1] - d2 w[n-2] - d3 w[n-3], then the same backward,
+//   coeffs = {B, d1, d2, d3}.
+// GAUSSIAN_IIR_ACCURATE, Deriche (1993), the sum of a causal and an
+// anti-causal 4th order filter, each split into two 2nd order sections:
+//   y[n] = n0 x[n] + n1 x[n-1] - d1 y[n-1] - d2 y[n-2],
+//   y[n] = m1 x[n+1] + m2 x[n+2] - d1 y[n+1] - d2 y[n+2],
+//   coeffs = {n0, n1, d1, d2, m1, m2, causal gain, anti-causal gain} for each
+//   section, the gains being the steady responses to a constant input.
+static void gaussian_iir_coeffs(float sigma, GaussianIIRType type, float *coeffs)
+{
+    double s = sigma;
+    if (type == ppl::cv::GAUSSIAN_IIR_FAST) {
+        // poles of the unit filter, raised to 1 / q so that the variance of the
+        // forward-backward pair, sum(2 d / (d - 1)^2), is sigma^2
+        const std::complex<double> poles[3] = {{1.41650, 1.00829}, {1.41650, -1.00829}, {1.86543, 0}};
+        std::complex<double> d[3];
+        double q = s / 2;
+        for (int32_t iter = 0; iter < 32; ++iter) {
+            double var = 0, dvar = 0;
+            for (int32_t k = 0; k < 3; ++k) {
+                d[k] = std::polar(std::pow(std::abs(poles[k]), 1 / q), std::arg(poles[k]) / q);
+                var += (2. * d[k] / ((d[k] - 1.) * (d[k] - 1.))).real();
+                // d(d)/dq = -d log(pole) / q^2
+                std::complex<double> dd = -d[k] * std::log(poles[k]) / (q * q);
+                dvar += (-2. * (d[k] + 1.) / ((d[k] - 1.) * (d[k] - 1.) * (d[k] - 1.)) * dd).real();
+            }
+            double step = (var - s * s) / dvar;
+            q -= step;
+            if (std::fabs(step) < 1e-9 * q) {
+                break;
+            }
+        }
+        for (int32_t k = 0; k < 3; ++k) {
+            d[k] = std::polar(std::pow(std::abs(poles[k]), 1 / q), std::arg(poles[k]) / q);
+        }
+        // 1 + a1 z^-1 + a2 z^-2 + a3 z^-3 = (1 - z^-1 / d0)(1 - z^-1 / d1)(1 - z^-1 / d2)
+        std::complex<double> a[4] = {1., 0., 0., 0.};
+        for (int32_t k = 0; k < 3; ++k) {
+            for (int32_t j = k + 1; j > 0; --j) {
+                a[j] -= a[j - 1] / d[k];
+            }
+        }
+        coeffs[0] = (float)(a[0] + a[1] + a[2] + a[3]).real();
+        coeffs[1] = (float)a[1].real();
+        coeffs[2] = (float)a[2].real();
+        coeffs[3] = (float)a[3].real();
+        return;
+    }
+
+    // each of the two cosine-sine terms of the causal response is a 2nd order
+    // section of its own; summing the sections instead of running their 4th
+    // order product keeps float round-off at 1e-3 of a level at sigma 20
+    const double a[2] = {1.680, -0.6803};
+    const double b[2] = {3.735, -0.2598};
+    const double e[2] = {1.783, 1.723};
+    const double w[2] = {0.6318, 1.997};
+    double sec[2][6], sum = 0;
+    for (int32_t k = 0; k < 2; ++k) {
+        double r  = std::exp(-e[k] / s);
+        double n0 = a[k];
+        double n1 = r * (b[k] * std::sin(w[k] / s) - a[k] * std::cos(w[k] / s));
+        double d1 = -2 * r * std::cos(w[k] / s);
+        double d2 = r * r;
+        sec[k][0] = n0;
+        sec[k][1] = n1;
+        sec[k][2] = d1;
+        sec[k][3] = d2;
+        sec[k][4] = n1 - d1 * n0;
+        sec[k][5] = -d2 * n0;
+        sum += (n0 + n1 + sec[k][4] + sec[k][5]) / (1 + d1 + d2);
+    }
+
+    // normalize the response to unit sum
+    for (int32_t k = 0; k < 2; ++k) {
+        double *c    = sec[k];
+        double sum_d = 1 + c[2] + c[3];
+        float *out   = coeffs + k * 8;
+        out[0]       = (float)(c[0] / sum);
+        out[1]       = (float)(c[1] / sum);
+        out[2]       = (float)c[2];
+        out[3]       = (float)c[3];
+        out[4]       = (float)(c[4] / sum);
+        out[5]       = (float)(c[5] / sum);
+        out[6]       = (float)((c[0] + c[1]) / sum / sum_d);
+        out[7]       = (float)((c[4] + c[5]) / sum / sum_d);
+    }
+}
+
+// Extra samples run through at each end of a line. The Deriche recursions start
+// exactly from their steady state for replicated and zero borders; the others
+// need the border itself, 4 sigma of it leaving a 3e-5 tail.
+static int32_t gaussian_iir_pad(float sigma, GaussianIIRType type, BorderType border_type)
+{
+    if (type == ppl::cv::GAUSSIAN_IIR_ACCURATE) {
+        if (border_type == ppl::cv::BORDER_REPLICATE) {
+            return 0;
+        }
+        if (border_type == ppl::cv::BORDER_CONSTANT) {
+            return 1;
+        }
+    }
+    return (int32_t)std::ceil(4 * sigma);
+}
+
+// The positions of a column strip are an image row apart, too far for the
+// hardware prefetcher to follow.
+static inline void gaussian_iir_prefetch(const float *next, int32_t n)
+{
+    for (int32_t i = 0; i < n; i += 16) {
+        _mm_prefetch((const char *)(next + i), _MM_HINT_T0);
+    }
+}
+
+static void gaussian_iir_yvv_lines(
+    const float *coeffs,
+    const float *const *rows,
+    int32_t count,
+    int32_t lanes,
+    int32_t begin,
+    float *dst)
+{
+    __m128 m_b  = _mm_set1_ps(coeffs[0]);
+    __m128 m_d1 = _mm_set1_ps(coeffs[1]);
+    __m128 m_d2 = _mm_set1_ps(coeffs[2]);
+    __m128 m_d3 = _mm_set1_ps(coeffs[3]);
+    __m128 state[GAUSSIAN_IIR_MAX_LANES / 4][3];
+    int32_t chunks = (lanes - begin) / 4;
+
+    for (int32_t c = 0; c < chunks; ++c) {
+        state[c][0] = state[c][1] = state[c][2] = _mm_loadu_ps(rows[0] + begin + c * 4);
+    }
+    for (int32_t p = 0; p < count; ++p) {
+        const float *src = rows[p] + begin;
+        float *out       = dst + (int64_t)p * lanes + begin;
+        gaussian_iir_prefetch(rows[std::min(p + GAUSSIAN_IIR_PREFETCH, count - 1)] + begin, chunks * 4);
+        for (int32_t c = 0; c < chunks; ++c) {
+            __m128 *s   = state[c];
+            __m128 m_fb = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m_d1, s[0]), _mm_mul_ps(m_d2, s[1])), _mm_mul_ps(m_d3, s[2]));
+            __m128 m_w  = _mm_sub_ps(_mm_mul_ps(m_b, _mm_loadu_ps(src + c * 4)), m_fb);
+            s[2]        = s[1];
+            s[1]        = s[0];
+            s[0]        = m_w;
+            _mm_storeu_ps(out + c * 4, m_w);
+        }
+    }
+
+    for (int32_t c = 0; c < chunks; ++c) {
+        state[c][0] = state[c][1] = state[c][2] = _mm_loadu_ps(dst + (int64_t)(count - 1) * lanes + begin + c * 4);
+    }
+    for (int32_t p = count - 1; p >= 0; --p) {
+        float *out = dst + (int64_t)p * lanes + begin;
+        for (int32_t c = 0; c < chunks; ++c) {
+            __m128 *s   = state[c];
+            __m128 m_fb = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m_d1, s[0]), _mm_mul_ps(m_d2, s[1])), _mm_mul_ps(m_d3, s[2]));
+            __m128 m_y  = _mm_sub_ps(_mm_mul_ps(m_b, _mm_loadu_ps(out + c * 4)), m_fb);
+            s[2]        = s[1];
+            s[1]        = s[0];
+            s[0]        = m_y;
+            _mm_storeu_ps(out + c * 4, m_y);
+        }
+    }
+}
+
+static void gaussian_iir_deriche_lines(
+    const float *coeffs,
+    const float *const *rows,
+    int32_t count,
+    int32_t lanes,
+    int32_t begin,
+    float *dst)
+{
+    __m128 m_c[2][8];
+    for (int32_t k = 0; k < 2; ++k) {
+        for (int32_t j = 0; j < 8; ++j) {
+            m_c[k][j] = _mm_set1_ps(coeffs[k * 8 + j]);
+        }
+    }
+    // per chunk: the last 2 inputs, then the last 2 outputs of each section
+    __m128 state[GAUSSIAN_IIR_MAX_LANES / 4][6];
+    int32_t chunks = (lanes - begin) / 4;
+
+    for (int32_t c = 0; c < chunks; ++c) {
+        __m128 m_x  = _mm_loadu_ps(rows[0] + begin + c * 4);
+        state[c][0] = state[c][1] = m_x;
+        state[c][2] = state[c][3] = _mm_mul_ps(m_x, m_c[0][6]);
+        state[c][4] = state[c][5] = _mm_mul_ps(m_x, m_c[1][6]);
+    }
+    for (int32_t p = 0; p < count; ++p) {
+        const float *src = rows[p] + begin;
+        float *out       = dst + (int64_t)p * lanes + begin;
+        gaussian_iir_prefetch(rows[std::min(p + GAUSSIAN_IIR_PREFETCH, count - 1)] + begin, chunks * 4);
+        for (int32_t c = 0; c < chunks; ++c) {
+            __m128 *s  = state[c];
+            __m128 m_x = _mm_loadu_ps(src + c * 4);
+            __m128 m_y[2];
+            for (int32_t k = 0; k < 2; ++k) {
+                const __m128 *m_k = m_c[k];
+                __m128 m_ff = _mm_add_ps(_mm_mul_ps(m_k[0], m_x), _mm_mul_ps(m_k[1], s[0]));
+                __m128 m_fb = _mm_add_ps(_mm_mul_ps(m_k[2], s[2 + k * 2]), _mm_mul_ps(m_k[3], s[3 + k * 2]));
+                m_y[k]      = _mm_sub_ps(m_ff, m_fb);
+                s[3 + k * 2] = s[2 + k * 2];
+                s[2 + k * 2] = m_y[k];
+            }
+            s[0] = m_x;
+            _mm_storeu_ps(out + c * 4, _mm_add_ps(m_y[0], m_y[1]));
+        }
+    }
+
+    for (int32_t c = 0; c < chunks; ++c) {
+        __m128 m_x  = _mm_loadu_ps(rows[count - 1] + begin + c * 4);
+        state[c][0] = state[c][1] = m_x;
+        state[c][2] = state[c][3] = _mm_mul_ps(m_x, m_c[0][7]);
+        state[c][4] = state[c][5] = _mm_mul_ps(m_x, m_c[1][7]);
+    }
+    for (int32_t p = count - 1; p >= 0; --p) {
+        const float *src = rows[p] + begin;
+        float *out       = dst + (int64_t)p * lanes + begin;
+        for (int32_t c = 0; c < chunks; ++c) {
+            __m128 *s = state[c];
+            __m128 m_y[2];
+            for (int32_t k = 0; k < 2; ++k) {
+                const __m128 *m_k = m_c[k];
+                __m128 m_ff = _mm_add_ps(_mm_mul_ps(m_k[4], s[0]), _mm_mul_ps(m_k[5], s[1]));
+                __m128 m_fb = _mm_add_ps(_mm_mul_ps(m_k[2], s[2 + k * 2]), _mm_mul_ps(m_k[3], s[3 + k * 2]));
+                m_y[k]      = _mm_sub_ps(m_ff, m_fb);
+                s[3 + k * 2] = s[2 + k * 2];
+                s[2 + k * 2] = m_y[k];
+            }
+            s[1] = s[0];
+            s[0] = _mm_loadu_ps(src + c * 4);
+            _mm_storeu_ps(out + c * 4, _mm_add_ps(_mm_loadu_ps(out + c * 4), _mm_add_ps(m_y[0], m_y[1])));
+        }
+    }
+}
+
+// Filters `lanes` independent lines, a multiple of 4: rows[p] points at the
+// samples of position p of all of them, and dst receives `count` rows of
+// `lanes` floats.
+static void gaussian_iir_lines(
+    const float *coeffs,
+    GaussianIIRType type,
+    bool use_fma,
+    const float *const *rows,
+    int32_t count,
+    int32_t lanes,
+    float *dst)
+{
+    int32_t begin = 0;
+    if (use_fma) {
+        begin = type == ppl::cv::GAUSSIAN_IIR_FAST
+                    ? fma::gaussian_iir_yvv_lines_fma(coeffs, rows, count, lanes, dst)
+                    : fma::gaussian_iir_deriche_lines_fma(coeffs, rows, count, lanes, dst);
+    }
+    if (begin < lanes) {
+        if (type == ppl::cv::GAUSSIAN_IIR_FAST) {
+            gaussian_iir_yvv_lines(coeffs, rows, count, lanes, begin, dst);
+        } else {
+            gaussian_iir_deriche_lines(coeffs, rows, count, lanes, begin, dst);
+        }
+    }
+}
+
+static inline void gaussian_iir_store(const float *src, int32_t n, float *dst)
+{
+    memcpy(dst, src, n * sizeof(float));
+}
+
+static inline void gaussian_iir_store(const float *src, int32_t n, uint8_t *dst)
+{
+    int32_t i = 0;
+    for (; i <= n - 8; i += 8) {
+        __m128i m_lo = _mm_cvtps_epi32(_mm_loadu_ps(src + i));
+        __m128i m_hi = _mm_cvtps_epi32(_mm_loadu_ps(src + i + 4));
+        __m128i m_u8 = _mm_packus_epi16(_mm_packs_epi32(m_lo, m_hi), m_lo);
+        _mm_storel_epi64((__m128i *)(dst + i), m_u8);
+    }
+    for (; i < n; ++i) {
+        int32_t v = _mm_cvtss_si32(_mm_set_ss(src[i]));
+        dst[i]    = (uint8_t)std::min(std::max(v, 0), 255);
+    }
+}
+
+template <typename T, int32_t nc>
+static ::ppl::common::RetCode gaussian_blur_iir(
+    int32_t height,
+    int32_t width,
+    int32_t inWidthStride,
+    const T *inData,
+    float sigma,
+    int32_t outWidthStride,
+    T *outData,
+    GaussianIIRType type,
+    BorderType border_type)
+{
+    if (inData == nullptr || outData == nullptr) {
+        return ppl::common::RC_INVALID_VALUE;
+    }
+    if (height <= 0 || width <= 0 || inWidthStride < width * nc || outWidthStride < width * nc) {
+        return ppl::common::RC_INVALID_VALUE;
+    }
+    if (!(sigma >= 0.5f) || std::isinf(sigma) || !filter_border_supported(border_type) ||
+        (type != ppl::cv::GAUSSIAN_IIR_FAST && type != ppl::cv::GAUSSIAN_IIR_ACCURATE)) {
+        return ppl::common::RC_INVALID_VALUE;
+    }
+
+    float coeffs[16];
+    gaussian_iir_coeffs(sigma, type, coeffs);
+    const bool use_fma     = isa_supported(ppl::common::ISA_X86_FMA);
+    const int32_t row_len  = width * nc;
+    const int32_t cols     = (row_len + 3) / 4 * 4;
+    const float zeros[GAUSSIAN_IIR_MAX_LANES] = {0};
+
+    // float output whose rows are whole vectors holds the rows pass itself,
+    // which saves allocating and faulting in a second image
+    const bool in_place  = std::is_same<T, float>::value && cols == row_len;
+    const int32_t stride = in_place ? outWidthStride : (row_len + 15) / 16 * 16;
+    float *image         = in_place ? (float *)outData
+                                    : (float *)ppl::common::AlignedAlloc((int64_t)height * stride * sizeof(float), 64);
+
+    // rows, GAUSSIAN_IIR_ROWS at a time with their pixels interleaved so that
+    // every position of the block is one vector row
+    const int32_t hpad = gaussian_iir_pad(sigma, type, border_type);
+    parallel_for_rows(height, (int64_t)row_len * 2, [&](int32_t begin, int32_t end) {
+        const int32_t lanes = GAUSSIAN_IIR_ROWS * nc;
+        const int32_t count = width + 2 * hpad;
+        float *block        = (float *)ppl::common::AlignedAlloc(((int64_t)width + count) * lanes * sizeof(float), 64);
+        float *line         = block + (int64_t)width * lanes;
+        std::vector<const float *> rows(count);
+        for (int32_t p = 0; p < count; ++p) {
+            int32_t x = border_interpolate(p - hpad, width, border_type);
+            rows[p]   = x < 0 ? zeros : block + (int64_t)x * lanes;
+        }
+
+        for (int32_t y = begin; y < end; y += GAUSSIAN_IIR_ROWS) {
+            int32_t num_rows = std::min(GAUSSIAN_IIR_ROWS, end - y);
+            const T *src[GAUSSIAN_IIR_ROWS];
+            for (int32_t r = 0; r < GAUSSIAN_IIR_ROWS; ++r) {
+                src[r] = inData + (int64_t)(y + std::min(r, num_rows - 1)) * inWidthStride;
+            }
+            float *b = block;
+            for (int32_t x = 0; x < row_len; x += nc) {
+                for (int32_t r = 0; r < GAUSSIAN_IIR_ROWS; ++r) {
+                    for (int32_t c = 0; c < nc; ++c) {
+                        *b++ = src[r][x + c];
+                    }
+                }
+            }
+
+            gaussian_iir_lines(coeffs, type, use_fma, rows.data(), count, lanes, line);
+
+            for (int32_t r = 0; r < num_rows; ++r) {
+                float *dst     = image + (int64_t)(y + r) * stride;
+                const float *l = line + (int64_t)hpad * lanes + r * nc;
+                for (int32_t x = 0; x < row_len; x += nc, l += lanes) {
+                    for (int32_t c = 0; c < nc; ++c) {
+                        dst[x + c] = l[c];
+                    }
+                }
+                if (!in_place) {
+                    memset(dst + row_len, 0, (stride - row_len) * sizeof(float));
+                }
+            }
+        }
+        ppl::common::AlignedFree(block);
+    }, GAUSSIAN_IIR_ROWS);
+
+    // columns, a strip of GAUSSIAN_IIR_STRIP floats at a time
+    const int32_t vpad       = gaussian_iir_pad(sigma, type, border_type);
+    const int32_t num_strips = (cols + GAUSSIAN_IIR_STRIP - 1) / GAUSSIAN_IIR_STRIP;
+    parallel_for_rows(num_strips, (int64_t)height * GAUSSIAN_IIR_STRIP * 2, [&](int32_t begin, int32_t end) {
+        const int32_t count = height + 2 * vpad;
+        float *line         = (float *)ppl::common::AlignedAlloc((int64_t)count * GAUSSIAN_IIR_STRIP * sizeof(float), 64);
+        std::vector<const float *> rows(count);
+
+        for (int32_t s = begin; s < end; ++s) {
+            int32_t x0    = s * GAUSSIAN_IIR_STRIP;
+            int32_t lanes = std::min(GAUSSIAN_IIR_STRIP, cols - x0);
+            for (int32_t p = 0; p < count; ++p) {
+                int32_t y = border_interpolate(p - vpad, height, border_type);
+                rows[p]   = y < 0 ? zeros : image + (int64_t)y * stride + x0;
+            }
+
+            gaussian_iir_lines(coeffs, type, use_fma, rows.data(), count, lanes, line);
+
+            int32_t n = std::min(lanes, row_len - x0);
+            for (int32_t y = 0; y < height; ++y) {
+                gaussian_iir_store(line + (int64_t)(vpad + y) * lanes, n, outData + (int64_t)y * outWidthStride + x0);
+            }
+        }
+        ppl::common::AlignedFree(line);
+    });
+
+    if (!in_place) {
+        ppl::common::AlignedFree(image);
+    }
+    return ppl::common::RC_SUCCESS;
+}
+
+template <>
+::ppl::common::RetCode GaussianBlurIIR<float, 1>(
+    int32_t height,
+    int32_t width,
+    int32_t inWidthStride,
+    const float *inData,
+    float sigma,
+    int32_t outWidthStride,
+    float *outData,
+    GaussianIIRType type,
+    BorderType border_type)
+{
+    return gaussian_blur_iir<float, 1>(height, width, inWidthStride, inData, sigma, outWidthStride, outData, type, border_type);
+}
+
+template <>
+::ppl::common::RetCode GaussianBlurIIR<float, 3>(
+    int32_t height,
+    int32_t width,
+    int32_t inWidthStride,
+    const float *inData,
+    float sigma,
+    int32_t outWidthStride,
+    float *outData,
+    GaussianIIRType type,
+    BorderType border_type)
+{
+    return gaussian_blur_iir<float, 3>(height, width, inWidthStride, inData, sigma, outWidthStride, outData, type, border_type);
+}
+
+template <>
+::ppl::common::RetCode GaussianBlurIIR<float, 4>(
+    int32_t height,
+    int32_t width,
+    int32_t inWidthStride,
+    const float *inData,
+    float sigma,
+    int32_t outWidthStride,
+    float *outData,
+    GaussianIIRType type,
+    BorderType border_type)
+{
+    return gaussian_blur_iir<float, 4>(height, width, inWidthStride, inData, sigma, outWidthStride, outData, type, border_type);
+}
+
+template <>
+::ppl::common::RetCode GaussianBlurIIR<uint8_t, 1>(
+    int32_t height,
+    int32_t width,
+    int32_t inWidthStride,
+    const uint8_t *inData,
+    float sigma,
+    int32_t outWidthStride,
+    uint8_t *outData,
+    GaussianIIRType type,
+    BorderType border_type)
+{
+    return gaussian_blur_iir<uint8_t, 1>(height, width, inWidthStride, inData, sigma, outWidthStride, outData, type, border_type);
+}
+
+template <>
+::ppl::common::RetCode GaussianBlurIIR<uint8_t, 3>(
+    int32_t height,
+    int32_t width,
+    int32_t inWidthStride,
+    const uint8_t *inData,
+    float sigma,
+    int32_t outWidthStride,
+    uint8_t *outData,
+    GaussianIIRType type,
+    BorderType border_type)
+{
+    return gaussian_blur_iir<uint8_t, 3>(height, width, inWidthStride, inData, sigma, outWidthStride, outData, type, border_type);
+}
+
+template <>
+::ppl::common::RetCode GaussianBlurIIR<uint8_t, 4>(
+    int32_t height,
+    int32_t width,
+    int32_t inWidthStride,
+    const uint8_t *inData,
+    float sigma,
+    int32_t outWidthStride,
+    uint8_t *outData,
+    GaussianIIRType type,
+    BorderType border_type)
+{
+    return gaussian_blur_iir<uint8_t, 4>(height, width, inWidthStride, inData, sigma, outWidthStride, outData, type, border_type);
+}
+
+}
+}
+} // namespace ppl::cv::x86
@@ -0,0 +1,88 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+#include <benchmark/benchmark.h>
+#include "ppl/cv/x86/gaussianblur.h"
+#include "ppl/cv/debug.h"
+namespace {
+
+template<typename T, int32_t nc, int32_t sigma, ppl::cv::GaussianIIRType type>
+void BM_GaussianBlurIIR_ppl_x86(benchmark::State &state) {
+    int32_t width = state.range(0);
+    int32_t height = state.range(1);
+    std::unique_ptr<T[]> src(new T[width * height * nc]);
+    std::unique_ptr<T[]> dst(new T[width * height * nc]);
+    ppl::cv::debug::randomFill<T>(src.get(), width * height * nc, 0, 255);
+    for (auto _ : state) {
+        ppl::cv::x86::GaussianBlurIIR<T, nc>(height, width, width * nc, src.get(), sigma, width * nc, dst.get(), type, ppl::cv::BORDER_DEFAULT);
+    }
+    state.SetItemsProcessed(state.iterations() * 1);
+}
+
+// the direct filter at the same sigma, kernel of radius 3 sigma
+template<typename T, int32_t nc, int32_t sigma>
+void BM_GaussianBlurDirect_ppl_x86(benchmark::State &state) {
+    int32_t width = state.range(0);
+    int32_t height = state.range(1);
+    std::unique_ptr<T[]> src(new T[width * height * nc]);
+    std::unique_ptr<T[]> dst(new T[width * height * nc]);
+    ppl::cv::debug::randomFill<T>(src.get(), width * height * nc, 0, 255);
+    for (auto _ : state) {
+        ppl::cv::x86::GaussianBlur<T, nc>(height, width, width * nc, src.get(), 6 * sigma + 1, sigma, width * nc, dst.get(), ppl::cv::BORDER_DEFAULT);
+    }
+    state.SetItemsProcessed(state.iterations() * 1);
+}
+
+using namespace ppl::cv::debug;
+BENCHMARK_TEMPLATE(BM_GaussianBlurIIR_ppl_x86, float, c1, 3, ppl::cv::GAUSSIAN_IIR_ACCURATE)->Args({640, 480})->Args({1920, 1080});
+BENCHMARK_TEMPLATE(BM_GaussianBlurIIR_ppl_x86, float, c1, 20, ppl::cv::GAUSSIAN_IIR_ACCURATE)->Args({640, 480})->Args({1920, 1080});
+BENCHMARK_TEMPLATE(BM_GaussianBlurIIR_ppl_x86, float, c1, 20, ppl::cv::GAUSSIAN_IIR_FAST)->Args({640, 480})->Args({1920, 1080});
+BENCHMARK_TEMPLATE(BM_GaussianBlurIIR_ppl_x86, float, c3, 20, ppl::cv::GAUSSIAN_IIR_ACCURATE)->Args({640, 480})->Args({1920, 1080});
+BENCHMARK_TEMPLATE(BM_GaussianBlurIIR_ppl_x86, uint8_t, c1, 20, ppl::cv::GAUSSIAN_IIR_ACCURATE)->Args({640, 480})->Args({1920, 1080});
+BENCHMARK_TEMPLATE(BM_GaussianBlurIIR_ppl_x86, uint8_t, c3, 3, ppl::cv::GAUSSIAN_IIR_ACCURATE)->Args({640, 480})->Args({1920, 1080});
+BENCHMARK_TEMPLATE(BM_GaussianBlurIIR_ppl_x86, uint8_t, c3, 20, ppl::cv::GAUSSIAN_IIR_ACCURATE)->Args({640, 480})->Args({1920, 1080});
+BENCHMARK_TEMPLATE(BM_GaussianBlurIIR_ppl_x86, uint8_t, c3, 20, ppl::cv::GAUSSIAN_IIR_FAST)->Args({640, 480})->Args({1920, 1080});
+BENCHMARK_TEMPLATE(BM_GaussianBlurDirect_ppl_x86, float, c1, 3)->Args({640, 480})->Args({1920, 1080});
+BENCHMARK_TEMPLATE(BM_GaussianBlurDirect_ppl_x86, float, c1, 20)->Args({640, 480})->Args({1920, 1080});
+BENCHMARK_TEMPLATE(BM_GaussianBlurDirect_ppl_x86, uint8_t, c3, 3)->Args({640, 480})->Args({1920, 1080});
+BENCHMARK_TEMPLATE(BM_GaussianBlurDirect_ppl_x86, uint8_t, c3, 20)->Args({640, 480})->Args({1920, 1080});
+
+#ifdef PPLCV_BENCHMARK_OPENCV
+template<typename T, int32_t nc, int32_t sigma>
+static void BM_GaussianBlurIIR_opencv_x86(benchmark::State &state)
+{
+    int32_t width = state.range(0);
+    int32_t height = state.range(1);
+    std::unique_ptr<T[]> src(new T[width * height * nc]);
+    std::unique_ptr<T[]> dst(new T[width * height * nc]);
+    ppl::cv::debug::randomFill<T>(src.get(), width * height * nc, 0, 255);
+    cv::Mat src_opencv(height, width, CV_MAKETYPE(cv::DataType<T>::depth, nc), src.get(), sizeof(T) * width * nc);
+    cv::Mat dst_opencv(height, width, CV_MAKETYPE(cv::DataType<T>::depth, nc), dst.get(), sizeof(T) * width * nc);
+    for (auto _ : state) {
+        cv::GaussianBlur(src_opencv, dst_opencv, cv::Size(0, 0), sigma, sigma, 4);
+    }
+    state.SetItemsProcessed(state.iterations() * 1);
+
+}
+
+BENCHMARK_TEMPLATE(BM_GaussianBlurIIR_opencv_x86, float, c1, 3)->Args({640, 480})->Args({1920, 1080});
+BENCHMARK_TEMPLATE(BM_GaussianBlurIIR_opencv_x86, float, c1, 20)->Args({640, 480})->Args({1920, 1080});
+BENCHMARK_TEMPLATE(BM_GaussianBlurIIR_opencv_x86, float, c3, 20)->Args({640, 480})->Args({1920, 1080});
+BENCHMARK_TEMPLATE(BM_GaussianBlurIIR_opencv_x86, uint8_t, c1, 20)->Args({640, 480})->Args({1920, 1080});
+BENCHMARK_TEMPLATE(BM_GaussianBlurIIR_opencv_x86, uint8_t, c3, 3)->Args({640, 480})->Args({1920, 1080});
+BENCHMARK_TEMPLATE(BM_GaussianBlurIIR_opencv_x86, uint8_t, c3, 20)->Args({640, 480})->Args({1920, 1080});
+#endif //! PPLCV_BENCHMARK_OPENCV
+}
@@ -0,0 +1,114 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "ppl/cv/x86/gaussianblur.h"
+#include "ppl/cv/debug.h"
+#include "ppl/cv/x86/test.h"
+#include <gtest/gtest.h>
+#include <cmath>
+
+// OpenCV with a kernel of radius 4 sigma, the reach GaussianBlurIIR pads its
+// borders with, is the reference.
+template<typename T, ppl::cv::BorderType border_type, ppl::cv::GaussianIIRType type, int c>
+class gaussblur_iir_ : public  ::testing::TestWithParam<std::tuple<Size, float>> {
+public:
+    using GaussblurIIRParameter = std::tuple<Size, float>;
+    gaussblur_iir_()
+    {
+    }
+    ~gaussblur_iir_()
+    {
+    }
+
+    void apply(const GaussblurIIRParameter &param)
+    {
+        Size size = std::get<0>(param);
+        float sigma = std::get<1>(param);
+        int kernel = 2 * (int)std::ceil(4 * sigma) + 1;
+        std::unique_ptr<T[]> src(new T[size.width * size.height * c]);
+        std::unique_ptr<T[]> dst_ref(new T[size.width * size.height * c]);
+        std::unique_ptr<T[]> dst(new T[size.width * size.height * c]);
+        ppl::cv::debug::randomFill<T>(src.get(), size.width * size.height * c, 0, 255);
+        cv::Mat src_opencv(size.height, size.width, CV_MAKETYPE(cv::DataType<T>::depth, c), src.get(), sizeof(T) * size.width * c);
+        cv::Mat dst_opencv(size.height, size.width, CV_MAKETYPE(cv::DataType<T>::depth, c), dst_ref.get(), sizeof(T) * size.width * c);
+        int cv_bordertype = 4;
+        if(border_type == ppl::cv::BORDER_REFLECT_101) {
+            cv_bordertype = 4;
+        } else if(border_type == ppl::cv::BORDER_REFLECT) {
+            cv_bordertype = 2;
+        } else if(border_type == ppl::cv::BORDER_REPLICATE) {
+            cv_bordertype = 1;
+        } else if(border_type == ppl::cv::BORDER_WRAP) {
+            cv_bordertype = 3;
+        } else if(border_type == ppl::cv::BORDER_CONSTANT) {
+            cv_bordertype = 0;
+        }
+        if (border_type == ppl::cv::BORDER_WRAP) {
+            // OpenCV filters reject BORDER_WRAP, so filter a wrapped copy and crop it.
+            int radius = kernel / 2;
+            cv::Mat padded, filtered;
+            cv::copyMakeBorder(src_opencv, padded, radius, radius, radius, radius, cv::BORDER_WRAP);
+            cv::GaussianBlur(padded, filtered, cv::Size(kernel, kernel), sigma, sigma, cv::BORDER_REPLICATE);
+            filtered(cv::Rect(radius, radius, size.width, size.height)).copyTo(dst_opencv);
+        } else {
+            cv::GaussianBlur(src_opencv, dst_opencv, cv::Size(kernel, kernel), sigma, sigma, cv_bordertype);
+        }
+        ppl::cv::x86::GaussianBlurIIR<T, c>(size.height, size.width, size.width * c, src.get(), sigma, size.width * c, dst.get(), type, border_type);
+
+        // the fast cascade is within 1.5% of the peak of the Gaussian
+        float diff = type == ppl::cv::GAUSSIAN_IIR_ACCURATE ? 1.01f : 2.01f;
+        checkResult<T, c>(dst_ref.get(), dst.get(),
+                        size.height, size.width,
+                        size.width * c, size.width * c, diff);
+    }
+};
+
+#define R(name, t, b, type, c, sigmas) \
+    using name = gaussblur_iir_<t, b, type, c>; \
+    TEST_P(name, abc) \
+    { \
+        this->apply(GetParam());\
+    }\
+    INSTANTIATE_TEST_CASE_P(standard, name,\
+                            ::testing::Combine(\
+                            ::testing::Values(Size{320, 240}, Size{321, 241}, Size{17, 9}),\
+                            sigmas));
+
+#define ACCURATE_SIGMAS ::testing::Values(1.0f, 3.0f, 7.5f)
+#define FAST_SIGMAS ::testing::Values(3.0f, 7.5f)
+
+R(gaussianblur_iir_f32c1_reflect_101, float, ppl::cv::BORDER_REFLECT_101, ppl::cv::GAUSSIAN_IIR_ACCURATE, 1, ACCURATE_SIGMAS)
+R(gaussianblur_iir_f32c3_reflect_101, float, ppl::cv::BORDER_REFLECT_101, ppl::cv::GAUSSIAN_IIR_ACCURATE, 3, ACCURATE_SIGMAS)
+R(gaussianblur_iir_f32c4_reflect_101, float, ppl::cv::BORDER_REFLECT_101, ppl::cv::GAUSSIAN_IIR_ACCURATE, 4, ACCURATE_SIGMAS)
+R(gaussianblur_iir_u8c1_reflect_101, uint8_t, ppl::cv::BORDER_REFLECT_101, ppl::cv::GAUSSIAN_IIR_ACCURATE, 1, ACCURATE_SIGMAS)
+R(gaussianblur_iir_u8c3_reflect_101, uint8_t, ppl::cv::BORDER_REFLECT_101, ppl::cv::GAUSSIAN_IIR_ACCURATE, 3, ACCURATE_SIGMAS)
+R(gaussianblur_iir_u8c4_reflect_101, uint8_t, ppl::cv::BORDER_REFLECT_101, ppl::cv::GAUSSIAN_IIR_ACCURATE, 4, ACCURATE_SIGMAS)
+
+R(gaussianblur_iir_f32c1_reflect, float, ppl::cv::BORDER_REFLECT, ppl::cv::GAUSSIAN_IIR_ACCURATE, 1, ACCURATE_SIGMAS)
+R(gaussianblur_iir_u8c3_reflect, uint8_t, ppl::cv::BORDER_REFLECT, ppl::cv::GAUSSIAN_IIR_ACCURATE, 3, ACCURATE_SIGMAS)
+R(gaussianblur_iir_f32c1_replicate, float, ppl::cv::BORDER_REPLICATE, ppl::cv::GAUSSIAN_IIR_ACCURATE, 1, ACCURATE_SIGMAS)
+R(gaussianblur_iir_u8c3_replicate, uint8_t, ppl::cv::BORDER_REPLICATE, ppl::cv::GAUSSIAN_IIR_ACCURATE, 3, ACCURATE_SIGMAS)
+R(gaussianblur_iir_f32c1_constant, float, ppl::cv::BORDER_CONSTANT, ppl::cv::GAUSSIAN_IIR_ACCURATE, 1, ACCURATE_SIGMAS)
+R(gaussianblur_iir_u8c3_constant, uint8_t, ppl::cv::BORDER_CONSTANT, ppl::cv::GAUSSIAN_IIR_ACCURATE, 3, ACCURATE_SIGMAS)
+R(gaussianblur_iir_f32c1_wrap, float, ppl::cv::BORDER_WRAP, ppl::cv::GAUSSIAN_IIR_ACCURATE, 1, ACCURATE_SIGMAS)
+R(gaussianblur_iir_u8c3_wrap, uint8_t, ppl::cv::BORDER_WRAP, ppl::cv::GAUSSIAN_IIR_ACCURATE, 3, ACCURATE_SIGMAS)
+
+R(gaussianblur_iir_fast_f32c1_reflect_101, float, ppl::cv::BORDER_REFLECT_101, ppl::cv::GAUSSIAN_IIR_FAST, 1, FAST_SIGMAS)
+R(gaussianblur_iir_fast_f32c4_reflect_101, float, ppl::cv::BORDER_REFLECT_101, ppl::cv::GAUSSIAN_IIR_FAST, 4, FAST_SIGMAS)
+R(gaussianblur_iir_fast_u8c1_reflect_101, uint8_t, ppl::cv::BORDER_REFLECT_101, ppl::cv::GAUSSIAN_IIR_FAST, 1, FAST_SIGMAS)
+R(gaussianblur_iir_fast_u8c3_replicate, uint8_t, ppl::cv::BORDER_REPLICATE, ppl::cv::GAUSSIAN_IIR_FAST, 3, FAST_SIGMAS)
+R(gaussianblur_iir_fast_u8c4_constant, uint8_t, ppl::cv::BORDER_CONSTANT, ppl::cv::GAUSSIAN_IIR_FAST, 4, FAST_SIGMAS)
@@ -48,8 +48,21 @@ public:
             cv_bordertype = 2;
         } else if(border_type == ppl::cv::BORDER_REPLICATE) {
             cv_bordertype = 1;
+        } else if(border_type == ppl::cv::BORDER_WRAP) {
+            cv_bordertype = 3;
+        } else if(border_type == ppl::cv::BORDER_CONSTANT) {
+            cv_bordertype = 0;
+        }
+        if (border_type == ppl::cv::BORDER_WRAP) {
+            // OpenCV filters reject BORDER_WRAP, so filter a wrapped copy and crop it.
+            int radius = kernel / 2;
+            cv::Mat padded, filtered;
+            cv::copyMakeBorder(src_opencv, padded, radius, radius, radius, radius, cv::BORDER_WRAP);
+            cv::GaussianBlur(padded, filtered, cv::Size(kernel, kernel), 0, 0, cv::BORDER_REPLICATE);
+            filtered(cv::Rect(radius, radius, size.width, size.height)).copyTo(dst_opencv);
+        } else {
+            cv::GaussianBlur(src_opencv, dst_opencv, cv::Size(kernel, kernel), 0, 0, cv_bordertype);
         }
-        cv::GaussianBlur(src_opencv, dst_opencv, cv::Size(kernel, kernel), 0, 0, cv_bordertype);
         ppl::cv::x86::GaussianBlur<T, c>(size.height, size.width, size.width * c, src.get(), kernel, 0.0f, size.width * c, dst.get(), border_type);
 
         checkResult<T, c>(dst_ref.get(), dst.get(),
@@ -89,3 +102,17 @@ R(gaussianblur_f32c4_replicate, float, ppl::cv::BORDER_REPLICATE, 4)
 R(gaussianblur_u8c1_replicate, uint8_t, ppl::cv::BORDER_REPLICATE, 1)
 R(gaussianblur_u8c3_replicate, uint8_t, ppl::cv::BORDER_REPLICATE, 3)
 R(gaussianblur_u8c4_replicate, uint8_t, ppl::cv::BORDER_REPLICATE, 4)
+
+R(gaussianblur_f32c1_constant, float, ppl::cv::BORDER_CONSTANT, 1)
+R(gaussianblur_f32c3_constant, float, ppl::cv::BORDER_CONSTANT, 3)
+R(gaussianblur_f32c4_constant, float, ppl::cv::BORDER_CONSTANT, 4)
+R(gaussianblur_u8c1_constant, uint8_t, ppl::cv::BORDER_CONSTANT, 1)
+R(gaussianblur_u8c3_constant, uint8_t, ppl::cv::BORDER_CONSTANT, 3)
+R(gaussianblur_u8c4_constant, uint8_t, ppl::cv::BORDER_CONSTANT, 4)
+
+R(gaussianblur_f32c1_wrap, float, ppl::cv::BORDER_WRAP, 1)
+R(gaussianblur_f32c3_wrap, float, ppl::cv::BORDER_WRAP, 3)
+R(gaussianblur_f32c4_wrap, float, ppl::cv::BORDER_WRAP, 4)
+R(gaussianblur_u8c1_wrap, uint8_t, ppl::cv::BORDER_WRAP, 1)
+R(gaussianblur_u8c3_wrap, uint8_t, ppl::cv::BORDER_WRAP, 3)
+R(gaussianblur_u8c4_wrap, uint8_t, ppl::cv::BORDER_WRAP, 4)
@@ -16,376 +16,602 @@
 // under the License.
 
 #include "ppl/cv/x86/guidedfilter.h"
-#include "ppl/cv/x86/convertto.h"
-#include "ppl/cv/x86/split.h"
-#include "ppl/cv/x86/merge.h"
-#include "ppl/cv/x86/boxfilter.h"
-#include "ppl/cv/x86/arithmetic.h"
-#include "ppl/cv/x86/setvalue.h"
+#include "ppl/cv/x86/filter_engine.hpp"
+#include "ppl/cv/x86/parallel.hpp"
+#include "ppl/cv/x86/util.hpp"
 #include "ppl/cv/types.h"
+
 #include <string.h>
+#include <immintrin.h>
 #include <cmath>
 
-#include <limits.h>
-#include <assert.h>
 #include <algorithm>
 #include <memory>
-#include <ppl/common/sys.h>
-
 #include <vector>
-#include <stack>
+
 namespace ppl {
 namespace cv {
 namespace x86 {
 
-template <>
-::ppl::common::RetCode GuidedFilter<float, 1, 1>(
+// The guided filter of He, Sun and Tang, "Guided Image Filtering", with
+// radius r, guide I of k channels and source p of m channels:
+//   a = (cov(I, I) + eps)^-1 cov(I, p), b = mean(p) - a^T mean(I),
+//   q = mean(a)^T I + mean(b),
+// every mean taken over the (2r + 1)^2 window around a pixel. The window
+// sums are kept as running sums, so the cost does not grow with r, and
+// nothing the size of the image is allocated: every band of output rows is
+// cut into strips of columns and streams the rows of a strip through
+//   - a ring of the per pixel statistics (I, p, I I^T, I p) of the 2r + 2
+//     source rows around a row of coefficients and their running column sum,
+//   - a ring of the 2r + 2 rows of coefficients (a, b) around an output row
+//     and their running column sum,
+// each slid along the row by a running row sum. A strip computes the
+// coefficients of r columns and rows beyond the pixels it writes, whose
+// statistics come from the reflected image, which gives the same (a, b) as
+// the mirrored pixel does for both supported borders.
+//
+// I and p are measured from the first pixel of the images, which keeps
+// I I^T - mean(I) mean(I)^T from cancelling in float for images with a large
+// offset.
+//
+// With subsample > 1 the coefficients are computed on I and p shrunk by that
+// factor with a window of r / subsample, and are upsampled bilinearly before
+// forming q from the full resolution guide: the fast guided filter of He and
+// Sun, "Fast Guided Filter", 2015.
+
+#define GUIDED_FILTER_STRIP_WIDTH 256
+#define GUIDED_FILTER_RESUM_ROWS  64
+
+// Per pixel statistics, in vectors of 4 floats:
+//   k = 1: I, p, I * I, I * p
+//   k = 3, m = 1: I and p, I * I, I * rotated I (I0 I1, I1 I2, I2 I0), I * p
+//   k = 3, m = 3: I, I * I, I * rotated I, p, I * p0, I * p1, I * p2
+// and coefficients: a, k per channel of p, then b.
+template <int32_t k, int32_t m>
+struct GuidedFilterLayout {
+    enum {
+        F = k == 1 ? 4 : (m == 1 ? 16 : 28),
+        G = (k * m + m + 3) & ~3,
+    };
+};
+
+// Statistics of `count` pixels of one row, the pixel of column j taken from
+// column xs[j] of the guide and source rows.
+template <typename TI, int32_t k, int32_t m>
+static void guided_filter_stats(
+    const TI* guided,
+    const TI* src,
+    const int32_t* xs,
+    int32_t count,
+    const float* center,
+    float* stats)
+{
+    typedef GuidedFilterLayout<k, m> L;
+    if (k == 1) {
+        for (int32_t j = 0; j < count; ++j) {
+            float I = (float)guided[xs[j]] - center[0];
+            float p = (float)src[xs[j]] - center[1];
+            _mm_storeu_ps(stats + j * L::F, _mm_setr_ps(I, p, I * I, I * p));
+        }
+        return;
+    }
+    const __m128 center_I = _mm_setr_ps(center[0], center[1], center[2], m == 1 ? center[3] : 0.f);
+    const __m128 center_p = m == 1 ? _mm_setzero_ps() : _mm_setr_ps(center[3], center[4], center[5], 0.f);
+    const __m128 mask_I   = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+    for (int32_t j = 0; j < count; ++j) {
+        const TI* g = guided + xs[j] * 3;
+        const TI* s = src + xs[j] * m;
+        float* f    = stats + j * L::F;
+        __m128 I    = _mm_sub_ps(_mm_setr_ps(g[0], g[1], g[2], m == 1 ? (float)s[0] : 0.f), center_I);
+        __m128 I3   = _mm_and_ps(I, mask_I);
+        _mm_storeu_ps(f, I);
+        _mm_storeu_ps(f + 4, _mm_mul_ps(I3, I3));
+        _mm_storeu_ps(f + 8, _mm_mul_ps(I3, _mm_shuffle_ps(I3, I3, _MM_SHUFFLE(3, 0, 2, 1))));
+        if (m == 1) {
+            _mm_storeu_ps(f + 12, _mm_mul_ps(I3, _mm_shuffle_ps(I, I, _MM_SHUFFLE(3, 3, 3, 3))));
+        } else {
+            __m128 p = _mm_sub_ps(_mm_setr_ps(s[0], s[1], s[2], 0.f), center_p);
+            _mm_storeu_ps(f + 12, p);
+            _mm_storeu_ps(f + 16, _mm_mul_ps(I3, _mm_shuffle_ps(p, p, _MM_SHUFFLE(0, 0, 0, 0))));
+            _mm_storeu_ps(f + 20, _mm_mul_ps(I3, _mm_shuffle_ps(p, p, _MM_SHUFFLE(1, 1, 1, 1))));
+            _mm_storeu_ps(f + 24, _mm_mul_ps(I3, _mm_shuffle_ps(p, p, _MM_SHUFFLE(2, 2, 2, 2))));
+        }
+    }
+}
+
+// sum[i] += add[i] - sub[i], sub may be null
+static void guided_filter_accumulate(float* sum, const float* add, const float* sub, int32_t len)
+{
+    int32_t i = 0;
+    if (sub) {
+        for (; i < len; i += 4) {
+            __m128 v = _mm_sub_ps(_mm_loadu_ps(add + i), _mm_loadu_ps(sub + i));
+            _mm_storeu_ps(sum + i, _mm_add_ps(_mm_loadu_ps(sum + i), v));
+        }
+    } else {
+        for (; i < len; i += 4) {
+            _mm_storeu_ps(sum + i, _mm_add_ps(_mm_loadu_ps(sum + i), _mm_loadu_ps(add + i)));
+        }
+    }
+}
+
+// Slides a window of `ksize` vectors of `n` floats along `sum`, writing the
+// window sums of `count` positions, scaled by `scale`.
+template <int32_t n>
+static void guided_filter_row_sum(const float* sum, int32_t count, int32_t ksize, float scale, float* dst)
+{
+    __m128 h[n / 4];
+    for (int32_t i = 0; i < n / 4; ++i) {
+        h[i] = _mm_setzero_ps();
+    }
+    for (int32_t j = 0; j < ksize; ++j) {
+        for (int32_t i = 0; i < n / 4; ++i) {
+            h[i] = _mm_add_ps(h[i], _mm_loadu_ps(sum + j * n + 4 * i));
+        }
+    }
+    __m128 s = _mm_set1_ps(scale);
+    for (int32_t j = 0;; ++j) {
+        for (int32_t i = 0; i < n / 4; ++i) {
+            _mm_storeu_ps(dst + j * n + 4 * i, _mm_mul_ps(h[i], s));
+        }
+        if (j + 1 == count) {
+            break;
+        }
+        const float* add = sum + (j + ksize) * n;
+        const float* sub = sum + j * n;
+        for (int32_t i = 0; i < n / 4; ++i) {
+            h[i] = _mm_add_ps(h[i], _mm_sub_ps(_mm_loadu_ps(add + 4 * i), _mm_loadu_ps(sub + 4 * i)));
+        }
+    }
+}
+
+// Coefficients of 4 pixels from their mean statistics, one pixel per lane.
+template <int32_t k, int32_t m>
+static void guided_filter_solve(const __m128* f, __m128 eps, __m128* ab)
+{
+    const __m128 one = _mm_set1_ps(1.f);
+    if (k == 1) {
+        __m128 inv_var = _mm_div_ps(one, _mm_add_ps(_mm_sub_ps(f[2], _mm_mul_ps(f[0], f[0])), eps));
+        __m128 a       = _mm_mul_ps(_mm_sub_ps(f[3], _mm_mul_ps(f[0], f[1])), inv_var);
+        ab[0]          = a;
+        ab[1]          = _mm_sub_ps(f[1], _mm_mul_ps(a, f[0]));
+        return;
+    }
+    const __m128* mI = f;
+    const __m128* II = f + 4;
+    const __m128* mp = m == 1 ? f + 3 : f + 12;
+    const __m128* Ip = m == 1 ? f + 12 : f + 16;
+    // symmetric 3x3 inverse from the cofactors
+    __m128 s00 = _mm_add_ps(_mm_sub_ps(II[0], _mm_mul_ps(mI[0], mI[0])), eps);
+    __m128 s11 = _mm_add_ps(_mm_sub_ps(II[1], _mm_mul_ps(mI[1], mI[1])), eps);
+    __m128 s22 = _mm_add_ps(_mm_sub_ps(II[2], _mm_mul_ps(mI[2], mI[2])), eps);
+    __m128 s01 = _mm_sub_ps(II[4], _mm_mul_ps(mI[0], mI[1]));
+    __m128 s12 = _mm_sub_ps(II[5], _mm_mul_ps(mI[1], mI[2]));
+    __m128 s02 = _mm_sub_ps(II[6], _mm_mul_ps(mI[0], mI[2]));
+    __m128 i00 = _mm_sub_ps(_mm_mul_ps(s11, s22), _mm_mul_ps(s12, s12));
+    __m128 i01 = _mm_sub_ps(_mm_mul_ps(s02, s12), _mm_mul_ps(s01, s22));
+    __m128 i02 = _mm_sub_ps(_mm_mul_ps(s01, s12), _mm_mul_ps(s02, s11));
+    __m128 i11 = _mm_sub_ps(_mm_mul_ps(s00, s22), _mm_mul_ps(s02, s02));
+    __m128 i12 = _mm_sub_ps(_mm_mul_ps(s02, s01), _mm_mul_ps(s00, s12));
+    __m128 i22 = _mm_sub_ps(_mm_mul_ps(s00, s11), _mm_mul_ps(s01, s01));
+    __m128 det = _mm_add_ps(_mm_mul_ps(s00, i00), _mm_add_ps(_mm_mul_ps(s01, i01), _mm_mul_ps(s02, i02)));
+    __m128 inv_det = _mm_div_ps(one, det);
+    for (int32_t c = 0; c < m; ++c) {
+        const __m128* ip = Ip + c * 4;
+        __m128 c0 = _mm_mul_ps(_mm_sub_ps(ip[0], _mm_mul_ps(mI[0], mp[c])), inv_det);
+        __m128 c1 = _mm_mul_ps(_mm_sub_ps(ip[1], _mm_mul_ps(mI[1], mp[c])), inv_det);
+        __m128 c2 = _mm_mul_ps(_mm_sub_ps(ip[2], _mm_mul_ps(mI[2], mp[c])), inv_det);
+        __m128 a0 = _mm_add_ps(_mm_mul_ps(i00, c0), _mm_add_ps(_mm_mul_ps(i01, c1), _mm_mul_ps(i02, c2)));
+        __m128 a1 = _mm_add_ps(_mm_mul_ps(i01, c0), _mm_add_ps(_mm_mul_ps(i11, c1), _mm_mul_ps(i12, c2)));
+        __m128 a2 = _mm_add_ps(_mm_mul_ps(i02, c0), _mm_add_ps(_mm_mul_ps(i12, c1), _mm_mul_ps(i22, c2)));
+        ab[c * k]     = a0;
+        ab[c * k + 1] = a1;
+        ab[c * k + 2] = a2;
+        __m128 b      = _mm_sub_ps(mp[c], _mm_mul_ps(a0, mI[0]));
+        b             = _mm_sub_ps(b, _mm_mul_ps(a1, mI[1]));
+        ab[k * m + c] = _mm_sub_ps(b, _mm_mul_ps(a2, mI[2]));
+    }
+}
+
+// Coefficients of `count` pixels, rounded up to 4, from their mean statistics.
+template <int32_t k, int32_t m>
+static void guided_filter_coefficients(const float* stats, int32_t count, float eps, float* ab)
+{
+    typedef GuidedFilterLayout<k, m> L;
+    __m128 veps = _mm_set1_ps(eps);
+    for (int32_t j = 0; j < count; j += 4) {
+        __m128 f[L::F], o[L::G];
+        const float* s = stats + j * L::F;
+        for (int32_t i = 0; i < L::F; i += 4) {
+            f[i]     = _mm_loadu_ps(s + i);
+            f[i + 1] = _mm_loadu_ps(s + L::F + i);
+            f[i + 2] = _mm_loadu_ps(s + 2 * L::F + i);
+            f[i + 3] = _mm_loadu_ps(s + 3 * L::F + i);
+            _MM_TRANSPOSE4_PS(f[i], f[i + 1], f[i + 2], f[i + 3]);
+        }
+        guided_filter_solve<k, m>(f, veps, o);
+        for (int32_t i = k * m + m; i < L::G; ++i) {
+            o[i] = _mm_setzero_ps();
+        }
+        float* d = ab + j * L::G;
+        for (int32_t i = 0; i < L::G; i += 4) {
+            _MM_TRANSPOSE4_PS(o[i], o[i + 1], o[i + 2], o[i + 3]);
+            _mm_storeu_ps(d + i, o[i]);
+            _mm_storeu_ps(d + L::G + i, o[i + 1]);
+            _mm_storeu_ps(d + 2 * L::G + i, o[i + 2]);
+            _mm_storeu_ps(d + 3 * L::G + i, o[i + 3]);
+        }
+    }
+}
+
+// Runs the filter over output rows [begin, end) of a height x width image and
+// hands consume(y, x0, x1, coeff) the mean coefficients of columns [x0, x1)
+// of row y, GuidedFilterLayout<k, m>::G floats per pixel.
+template <typename TI, int32_t k, int32_t m, typename Consume>
+static void guided_filter_band(
     int32_t height,
     int32_t width,
     int32_t inWidthStride,
-    const float* inImage,
+    const TI* src,
     int32_t guidedWidthStride,
-    const float* guidedImage,
-    int32_t outWidthStride,
-    float* outImage,
+    const TI* guided,
     int32_t radius,
     float eps,
-    BorderType border_type)
+    const float* center,
+    BorderType border_type,
+    int32_t begin,
+    int32_t end,
+    const Consume& consume)
 {
-    if (nullptr == inImage || nullptr == outImage || nullptr == guidedImage) {
-        return ppl::common::RC_INVALID_VALUE;
+    typedef GuidedFilterLayout<k, m> L;
+    const int32_t ksize     = 2 * radius + 1;
+    const int32_t ring_rows = ksize + 1;
+    const int32_t resum     = std::max(GUIDED_FILTER_RESUM_ROWS, 4 * ksize);
+    const float inv_area    = 1.f / ((float)ksize * ksize);
+    const int32_t strip     = std::min(width, std::max(GUIDED_FILTER_STRIP_WIDTH, 4 * radius));
+    // the statistics span 2r columns more than the coefficients, and those
+    // 2r more than the output
+    const int32_t stats_cols = strip + 4 * radius;
+    const int32_t coeff_cols = (strip + 2 * radius + 3) & ~3;
+    const int64_t stats_step = (int64_t)stats_cols * L::F;
+    const int64_t coeff_step = (int64_t)coeff_cols * L::G;
+
+    std::vector<int32_t> xs(stats_cols);
+    std::unique_ptr<float[]> stats_ring(new float[ring_rows * stats_step]);
+    std::unique_ptr<float[]> stats_sum(new float[stats_step]);
+    std::unique_ptr<float[]> stats_mean(new float[coeff_cols * L::F]);
+    std::unique_ptr<float[]> coeff_ring(new float[ring_rows * coeff_step]);
+    std::unique_ptr<float[]> coeff_sum(new float[coeff_step]);
+    std::unique_ptr<float[]> coeff_mean(new float[strip * L::G]);
+
+    // ring rows of the statistics of source row y and of the coefficients of row y
+    auto stats_row = [&](int32_t y) {
+        return stats_ring.get() + (y - begin + 2 * ring_rows) % ring_rows * stats_step;
+    };
+    auto coeff_row = [&](int32_t y) {
+        return coeff_ring.get() + (y - begin + 2 * ring_rows) % ring_rows * coeff_step;
+    };
+    // sums the ksize rows of a ring ending at row `last`
+    for (int32_t x0 = 0; x0 < width; x0 += strip) {
+        const int32_t x1  = std::min(width, x0 + strip);
+        const int32_t nx  = x1 - x0;
+        const int32_t nx1 = nx + 2 * radius;
+        const int32_t nx0 = nx + 4 * radius;
+        for (int32_t j = 0; j < nx0; ++j) {
+            xs[j] = border_interpolate(x0 - 2 * radius + j, width, border_type);
+        }
+        auto make_stats = [&](int32_t y) {
+            int32_t sy = border_interpolate(y, height, border_type);
+            guided_filter_stats<TI, k, m>(guided + (int64_t)sy * guidedWidthStride, src + (int64_t)sy * inWidthStride, xs.data(), nx0, center, stats_row(y));
+        };
+
+        // coefficient rows begin - r .. end - 1 + r, each from the statistics
+        // of the source rows within r of it. The running column sums are
+        // summed afresh from the rings every `resum` rows, which bounds the
+        // rounding they collect.
+        for (int32_t y = begin - radius; y < end + radius; ++y) {
+            if (y == begin - radius) {
+                for (int32_t sy = y - radius; sy < y + radius; ++sy) {
+                    make_stats(sy);
+                }
+            }
+            make_stats(y + radius);
+            if ((y - begin + radius) % resum == 0) {
+                memset(stats_sum.get(), 0, nx0 * L::F * sizeof(float));
+                for (int32_t sy = y - radius; sy <= y + radius; ++sy) {
+                    guided_filter_accumulate(stats_sum.get(), stats_row(sy), nullptr, nx0 * L::F);
+                }
+            } else {
+                guided_filter_accumulate(stats_sum.get(), stats_row(y + radius), stats_row(y - radius - 1), nx0 * L::F);
+            }
+            guided_filter_row_sum<L::F>(stats_sum.get(), nx1, ksize, inv_area, stats_mean.get());
+            guided_filter_coefficients<k, m>(stats_mean.get(), nx1, eps, coeff_row(y));
+
+            // output row y - r once the coefficients of its window are in the ring
+            int32_t oy = y - radius;
+            if (oy < begin) {
+                continue;
+            }
+            if ((oy - begin) % resum == 0) {
+                memset(coeff_sum.get(), 0, nx1 * L::G * sizeof(float));
+                for (int32_t cy = oy - radius; cy <= y; ++cy) {
+                    guided_filter_accumulate(coeff_sum.get(), coeff_row(cy), nullptr, nx1 * L::G);
+                }
+            } else {
+                guided_filter_accumulate(coeff_sum.get(), coeff_row(y), coeff_row(y - ksize), nx1 * L::G);
+            }
+            guided_filter_row_sum<L::G>(coeff_sum.get(), nx, ksize, inv_area, coeff_mean.get());
+            consume(oy, x0, x1, coeff_mean.get());
+        }
     }
-    if (width <= 0 || height <= 0 || inWidthStride < width || outWidthStride < width || guidedWidthStride <= 0) {
-        return ppl::common::RC_INVALID_VALUE;
+}
+
+static inline void guided_filter_store(float v, float* dst)
+{
+    *dst = v;
+}
+
+static inline void guided_filter_store(float v, uint8_t* dst)
+{
+    *dst = sat_cast_u8(_mm_cvtss_si32(_mm_set_ss(v)));
+}
+
+// q of `count` pixels from their mean coefficients and the guide.
+template <typename T, int32_t k, int32_t m>
+static inline void guided_filter_output(const float* coeff, const T* guided, const float* center, int32_t count, T* dst)
+{
+    typedef GuidedFilterLayout<k, m> L;
+    for (int32_t x = 0; x < count; ++x) {
+        const float* ab = coeff + x * L::G;
+        float I[k];
+        for (int32_t i = 0; i < k; ++i) {
+            I[i] = (float)guided[x * k + i] - center[i];
+        }
+        for (int32_t c = 0; c < m; ++c) {
+            float v = ab[k * m + c] + center[k + c];
+            for (int32_t i = 0; i < k; ++i) {
+                v += ab[c * k + i] * I[i];
+            }
+            guided_filter_store(v, dst + x * m + c);
+        }
     }
-    if (border_type != ppl::cv::BORDER_REFLECT && border_type != ppl::cv::BORDER_REFLECT101) {
-        return ppl::common::RC_INVALID_VALUE;
+}
+
+static inline void guided_filter_add_row(const float* src, int32_t len, float* sum)
+{
+    int32_t i = 0;
+    for (; i <= len - 4; i += 4) {
+        _mm_storeu_ps(sum + i, _mm_add_ps(_mm_loadu_ps(sum + i), _mm_loadu_ps(src + i)));
+    }
+    for (; i < len; ++i) {
+        sum[i] += src[i];
     }
-    const int32_t kernelSize = 2 * radius + 1;
-
-    std::unique_ptr<float[]> mean_I(new float[height * width]);
-    std::unique_ptr<float[]> mean_II(new float[height * width]);
-    BoxFilter<float, 1>(height, width, guidedWidthStride, guidedImage, kernelSize, kernelSize, true, width, mean_I.get(), border_type);
-    Mul<float, 1>(height, width, guidedWidthStride, guidedImage, guidedWidthStride, guidedImage, outWidthStride, outImage);
-    BoxFilter<float, 1>(height, width, outWidthStride, outImage, kernelSize, kernelSize, true, width, mean_II.get(), border_type);
-    Mls<float, 1>(height, width, width, mean_I.get(), width, mean_I.get(), width, mean_II.get());
-    std::unique_ptr<float[]>& var_I = mean_II;
-    SetTo<float, 1>(height, width, outWidthStride, outImage, eps);
-    Add<float, 1>(height, width, width, var_I.get(), outWidthStride, outImage, width, var_I.get());
-
-    std::unique_ptr<float[]> mean_P(new float[height * width]);
-    BoxFilter<float, 1>(height, width, inWidthStride, inImage, kernelSize, kernelSize, true, width, mean_P.get(), border_type);
-    Mul<float, 1>(height, width, inWidthStride, inImage, guidedWidthStride, guidedImage, outWidthStride, outImage);
-    std::unique_ptr<float[]> mean_IP(new float[height * width]);
-    BoxFilter<float, 1>(height, width, outWidthStride, outImage, kernelSize, kernelSize, true, width, mean_IP.get(), border_type);
-    Mls<float, 1>(height, width, width, mean_I.get(), width, mean_P.get(), width, mean_IP.get());
-    std::unique_ptr<float[]>& cov_Ip = mean_IP;
-
-    std::unique_ptr<float[]>& a = cov_Ip;
-    Div<float, 1>(height, width, width, cov_Ip.get(), width, var_I.get(), width, a.get());
-    Mls<float, 1>(height, width, width, a.get(), width, mean_I.get(), width, mean_P.get());
-    std::unique_ptr<float[]>& b = mean_P;
-
-    BoxFilter<float, 1>(height, width, width, a.get(), kernelSize, kernelSize, true, width, var_I.get(), border_type);
-    BoxFilter<float, 1>(height, width, width, b.get(), kernelSize, kernelSize, true, outWidthStride, outImage, border_type);
-
-    Mla<float, 1>(height, width, guidedWidthStride, guidedImage, width, var_I.get(), outWidthStride, outImage);
-    return ppl::common::RC_SUCCESS;
 }
 
-template <typename T>
-class simpleMemoryPool {
-public:
-    // block_size is elements in one block
-    simpleMemoryPool(int32_t block_size, int32_t max_block_num)
-    {
-        m_block_size    = block_size * sizeof(T);
-        m_max_block_num = max_block_num;
-        m_data          = (uint8_t*)ppl::common::AlignedAlloc((m_block_size * m_max_block_num), 64);
-        m_allocated.resize(m_max_block_num, false);
-        m_used_block_num     = 0;
-        m_max_used_block_num = 0;
+static inline void guided_filter_add_row(const uint8_t* src, int32_t len, float* sum)
+{
+    int32_t i = 0;
+    for (; i <= len - 4; i += 4) {
+        __m128i v = _mm_cvtepu8_epi32(_mm_cvtsi32_si128(*(const int32_t*)(src + i)));
+        _mm_storeu_ps(sum + i, _mm_add_ps(_mm_loadu_ps(sum + i), _mm_cvtepi32_ps(v)));
     }
-    ~simpleMemoryPool()
-    {
-        if (m_data != nullptr) {
-            ppl::common::AlignedFree(m_data);
-        }
+    for (; i < len; ++i) {
+        sum[i] += src[i];
     }
-    T* fastMalloc()
-    {
-        if (m_recently_used.empty() == true) {
-            for (int32_t i = 0; i < m_max_block_num; i++) {
-                if (m_allocated[i] == false) {
-                    m_allocated[i] = true;
-                    m_used_block_num++;
-                    m_max_used_block_num = std::max(m_max_used_block_num, m_used_block_num);
-                    return (T*)(m_data + i * m_block_size);
+}
+
+// Shrinks an image by `factor`, every pixel the mean of its block.
+template <typename T, int32_t cn>
+static void guided_filter_shrink(
+    int32_t height,
+    int32_t width,
+    int32_t inWidthStride,
+    const T* src,
+    int32_t factor,
+    int32_t outHeight,
+    int32_t outWidth,
+    float* dst)
+{
+    parallel_for_rows(outHeight, (int64_t)outWidth * factor * factor * cn, [&](int32_t begin, int32_t end) {
+        std::vector<float> sum(width * cn);
+        for (int32_t i = begin; i < end; ++i) {
+            int32_t y0 = i * factor;
+            int32_t y1 = std::min(height, y0 + factor);
+            std::fill(sum.begin(), sum.end(), 0.f);
+            for (int32_t y = y0; y < y1; ++y) {
+                guided_filter_add_row(src + (int64_t)y * inWidthStride, width * cn, sum.data());
+            }
+            float* d = dst + (int64_t)i * outWidth * cn;
+            for (int32_t j = 0; j < outWidth; ++j) {
+                int32_t x0 = j * factor;
+                int32_t x1 = std::min(width, x0 + factor);
+                float inv  = 1.f / ((y1 - y0) * (x1 - x0));
+                for (int32_t c = 0; c < cn; ++c) {
+                    float v = 0.f;
+                    for (int32_t x = x0; x < x1; ++x) {
+                        v += sum[x * cn + c];
+                    }
+                    d[j * cn + c] = v * inv;
                 }
             }
-            return nullptr;
         }
-        int32_t i = m_recently_used.top();
-        m_recently_used.pop();
-        m_allocated[i] = true;
-        m_used_block_num++;
-        m_max_used_block_num = std::max(m_max_used_block_num, m_used_block_num);
-        return (T*)(m_data + i * m_block_size);
-    }
-    void fastFree(T* addr_f)
-    {
-        uint8_t* addr = (uint8_t*)addr_f;
-        assert(addr >= m_data && addr < m_data + m_max_block_num * m_block_size);
-        assert((addr - m_data) % m_block_size == 0);
-        int32_t i      = (addr - m_data) / m_block_size;
-        m_allocated[i] = false;
-        m_used_block_num--;
-        m_recently_used.push(i);
-    }
-    int32_t getMaxUsedBlockNum(void)
-    {
-        return m_max_used_block_num;
-    }
+    });
+}
 
-private:
-    int32_t m_block_size;
-    int32_t m_max_block_num;
-    uint8_t* m_data;
-    std::vector<bool> m_allocated;
-    std::stack<int32_t> m_recently_used;
-    int32_t m_used_block_num;
-    int32_t m_max_used_block_num;
-};
+// Source position and weight of the next source pixel for bilinear
+// upsampling of `len` pixels from `src_len`.
+static void guided_filter_upsample_table(int32_t len, int32_t src_len, int32_t* pos, float* weight)
+{
+    double scale = (double)src_len / len;
+    for (int32_t i = 0; i < len; ++i) {
+        double f  = (i + 0.5) * scale - 0.5;
+        int32_t s = (int32_t)std::floor(f);
+        float w   = (float)(f - s);
+        if (s < 0) {
+            s = 0;
+            w = 0.f;
+        }
+        if (s >= src_len - 1) {
+            s = src_len - 1;
+            w = 0.f;
+        }
+        pos[i]    = s;
+        weight[i] = w;
+    }
+}
 
-template <>
-::ppl::common::RetCode GuidedFilter<float, 3, 3>(
+template <typename T, int32_t m, int32_t k>
+static ::ppl::common::RetCode guided_filter(
     int32_t height,
     int32_t width,
     int32_t inWidthStride,
-    const float* inImage,
+    const T* src,
     int32_t guidedWidthStride,
-    const float* guidedImage,
+    const T* guided,
     int32_t outWidthStride,
-    float* outImage,
+    T* dst,
     int32_t radius,
     float eps,
-    BorderType border_type)
+    BorderType border_type,
+    int32_t subsample)
 {
-    if (nullptr == inImage || nullptr == outImage || nullptr == guidedImage) {
+    if (nullptr == src || nullptr == dst || nullptr == guided) {
         return ppl::common::RC_INVALID_VALUE;
     }
-    if (width <= 0 || height <= 0 || inWidthStride < width || outWidthStride < width || guidedWidthStride <= 0) {
+    if (width <= 0 || height <= 0 || inWidthStride < width * m || outWidthStride < width * m || guidedWidthStride < width * k) {
         return ppl::common::RC_INVALID_VALUE;
     }
     if (border_type != ppl::cv::BORDER_REFLECT && border_type != ppl::cv::BORDER_REFLECT101) {
         return ppl::common::RC_INVALID_VALUE;
     }
-    int32_t kernelSize = 2 * radius + 1;
-
-    simpleMemoryPool<float> mp(width * height, 25);
-
-    float* guidedR = mp.fastMalloc();
-    float* guidedG = mp.fastMalloc();
-    float* guidedB = mp.fastMalloc();
-    Split3Channels(height, width, guidedWidthStride, guidedImage, width, guidedR, guidedG, guidedB);
-
-    float* meanGuidedR = mp.fastMalloc();
-    float* meanGuidedG = mp.fastMalloc();
-    float* meanGuidedB = mp.fastMalloc();
-    BoxFilter<float, 1>(height, width, width, guidedR, kernelSize, kernelSize, true, width, meanGuidedR, border_type);
-    BoxFilter<float, 1>(height, width, width, guidedG, kernelSize, kernelSize, true, width, meanGuidedG, border_type);
-    BoxFilter<float, 1>(height, width, width, guidedB, kernelSize, kernelSize, true, width, meanGuidedB, border_type);
-
-    float* GuidedRxGuidedR = mp.fastMalloc();
-    float* GuidedRxGuidedG = mp.fastMalloc();
-    float* GuidedRxGuidedB = mp.fastMalloc();
-    float* GuidedGxGuidedG = mp.fastMalloc();
-    float* GuidedGxGuidedB = mp.fastMalloc();
-    float* GuidedBxGuidedB = mp.fastMalloc();
-    Mul<float, 1>(height, width, width, guidedR, width, guidedR, width, GuidedRxGuidedR);
-    Mul<float, 1>(height, width, width, guidedR, width, guidedG, width, GuidedRxGuidedG);
-    Mul<float, 1>(height, width, width, guidedR, width, guidedB, width, GuidedRxGuidedB);
-    Mul<float, 1>(height, width, width, guidedG, width, guidedG, width, GuidedGxGuidedG);
-    Mul<float, 1>(height, width, width, guidedG, width, guidedB, width, GuidedGxGuidedB);
-    Mul<float, 1>(height, width, width, guidedB, width, guidedB, width, GuidedBxGuidedB);
-
-    float* varGuidedRR = mp.fastMalloc();
-    BoxFilter<float, 1>(height, width, width, GuidedRxGuidedR, kernelSize, kernelSize, true, width, varGuidedRR, border_type);
-    mp.fastFree(GuidedRxGuidedR);
-    float* varGuidedRG = mp.fastMalloc();
-    BoxFilter<float, 1>(height, width, width, GuidedRxGuidedG, kernelSize, kernelSize, true, width, varGuidedRG, border_type);
-    mp.fastFree(GuidedRxGuidedG);
-    float* varGuidedRB = mp.fastMalloc();
-    BoxFilter<float, 1>(height, width, width, GuidedRxGuidedB, kernelSize, kernelSize, true, width, varGuidedRB, border_type);
-    mp.fastFree(GuidedRxGuidedB);
-    float* varGuidedGG = mp.fastMalloc();
-    BoxFilter<float, 1>(height, width, width, GuidedGxGuidedG, kernelSize, kernelSize, true, width, varGuidedGG, border_type);
-    mp.fastFree(GuidedGxGuidedG);
-    float* varGuidedGB = mp.fastMalloc();
-    BoxFilter<float, 1>(height, width, width, GuidedGxGuidedB, kernelSize, kernelSize, true, width, varGuidedGB, border_type);
-    mp.fastFree(GuidedGxGuidedB);
-    float* varGuidedBB = mp.fastMalloc();
-    BoxFilter<float, 1>(height, width, width, GuidedBxGuidedB, kernelSize, kernelSize, true, width, varGuidedBB, border_type);
-    mp.fastFree(GuidedBxGuidedB);
-
-    // stay here
-    Mls<float, 1>(height, width, width, meanGuidedR, width, meanGuidedR, width, varGuidedRR);
-    Mls<float, 1>(height, width, width, meanGuidedR, width, meanGuidedG, width, varGuidedRG);
-    Mls<float, 1>(height, width, width, meanGuidedR, width, meanGuidedB, width, varGuidedRB);
-    Mls<float, 1>(height, width, width, meanGuidedG, width, meanGuidedG, width, varGuidedGG);
-    Mls<float, 1>(height, width, width, meanGuidedG, width, meanGuidedB, width, varGuidedGB);
-    Mls<float, 1>(height, width, width, meanGuidedB, width, meanGuidedB, width, varGuidedBB);
-
-    float* epsImage = mp.fastMalloc();
-    SetTo<float, 1>(height, width, width, epsImage, eps);
-    Add<float, 1>(height, width, width, varGuidedRR, width, epsImage, width, varGuidedRR);
-    Add<float, 1>(height, width, width, varGuidedGG, width, epsImage, width, varGuidedGG);
-    Add<float, 1>(height, width, width, varGuidedBB, width, epsImage, width, varGuidedBB);
-    mp.fastFree(epsImage);
-
-    float* invVarGuidedRR = mp.fastMalloc();
-    float* invVarGuidedRG = mp.fastMalloc();
-    float* invVarGuidedRB = mp.fastMalloc();
-    float* invVarGuidedGG = mp.fastMalloc();
-    float* invVarGuidedGB = mp.fastMalloc();
-    float* invVarGuidedBB = mp.fastMalloc();
-    Mul<float, 1>(height, width, width, varGuidedGG, width, varGuidedBB, width, invVarGuidedRR);
-    Mul<float, 1>(height, width, width, varGuidedGB, width, varGuidedRB, width, invVarGuidedRG);
-    Mul<float, 1>(height, width, width, varGuidedRG, width, varGuidedGB, width, invVarGuidedRB);
-    Mul<float, 1>(height, width, width, varGuidedRR, width, varGuidedBB, width, invVarGuidedGG);
-    Mul<float, 1>(height, width, width, varGuidedRB, width, varGuidedRG, width, invVarGuidedGB);
-    Mul<float, 1>(height, width, width, varGuidedRR, width, varGuidedGG, width, invVarGuidedBB);
-
-    Mls<float, 1>(height, width, width, varGuidedGB, width, varGuidedGB, width, invVarGuidedRR);
-    Mls<float, 1>(height, width, width, varGuidedRG, width, varGuidedBB, width, invVarGuidedRG);
-    mp.fastFree(varGuidedBB);
-    Mls<float, 1>(height, width, width, varGuidedGG, width, varGuidedRB, width, invVarGuidedRB);
-    mp.fastFree(varGuidedGG);
-    Mls<float, 1>(height, width, width, varGuidedRB, width, varGuidedRB, width, invVarGuidedGG);
-    Mls<float, 1>(height, width, width, varGuidedRR, width, varGuidedGB, width, invVarGuidedGB);
-    mp.fastFree(varGuidedGB);
-    Mls<float, 1>(height, width, width, varGuidedRG, width, varGuidedRG, width, invVarGuidedBB);
-
-    float* convDet = mp.fastMalloc();
-    Mul<float, 1>(height, width, width, invVarGuidedRR, width, varGuidedRR, width, convDet);
-    mp.fastFree(varGuidedRR);
-    Mla<float, 1>(height, width, width, invVarGuidedRG, width, varGuidedRG, width, convDet);
-    mp.fastFree(varGuidedRG);
-    Mla<float, 1>(height, width, width, invVarGuidedRB, width, varGuidedRB, width, convDet);
-    mp.fastFree(varGuidedRB);
-
-    Div<float, 1>(height, width, width, invVarGuidedRR, width, convDet, width, invVarGuidedRR);
-    Div<float, 1>(height, width, width, invVarGuidedRG, width, convDet, width, invVarGuidedRG);
-    Div<float, 1>(height, width, width, invVarGuidedRB, width, convDet, width, invVarGuidedRB);
-    Div<float, 1>(height, width, width, invVarGuidedGG, width, convDet, width, invVarGuidedGG);
-    Div<float, 1>(height, width, width, invVarGuidedGB, width, convDet, width, invVarGuidedGB);
-    Div<float, 1>(height, width, width, invVarGuidedBB, width, convDet, width, invVarGuidedBB);
-    mp.fastFree(convDet);
-
-    float* srcR = mp.fastMalloc();
-    float* srcG = mp.fastMalloc();
-    float* srcB = mp.fastMalloc();
-    Split3Channels(height, width, inWidthStride, inImage, width, srcR, srcG, srcB);
-    float* srcArray[3] = {srcR, srcG, srcB};
-    float* dstR        = mp.fastMalloc();
-    float* dstG        = mp.fastMalloc();
-    float* dstB        = mp.fastMalloc();
-    float* dstArray[3] = {dstR, dstG, dstB};
-    float* workspace   = nullptr;
-
-    for (int32_t i = 0; i < 3; ++i) {
-        float* curChannelImage            = srcArray[i];
-        float* meanCurChannelImage        = mp.fastMalloc();
-        float* varGuidedRxCurChannelImage = mp.fastMalloc();
-        float* varGuidedGxCurChannelImage = mp.fastMalloc();
-        float* varGuidedBxCurChannelImage = mp.fastMalloc();
-        workspace                         = mp.fastMalloc();
-        BoxFilter<float, 1>(height, width, width, curChannelImage, kernelSize, kernelSize, true, width, meanCurChannelImage, border_type);
-        Mul<float, 1>(height, width, width, guidedR, width, curChannelImage, width, workspace);
-        BoxFilter<float, 1>(height, width, width, workspace, kernelSize, kernelSize, true, width, varGuidedRxCurChannelImage, border_type);
-        Mul<float, 1>(height, width, width, guidedG, width, curChannelImage, width, workspace);
-        BoxFilter<float, 1>(height, width, width, workspace, kernelSize, kernelSize, true, width, varGuidedGxCurChannelImage, border_type);
-        Mul<float, 1>(height, width, width, guidedB, width, curChannelImage, width, workspace);
-        BoxFilter<float, 1>(height, width, width, workspace, kernelSize, kernelSize, true, width, varGuidedBxCurChannelImage, border_type);
-        mp.fastFree(workspace);
-
-        Mls<float, 1>(height, width, width, meanGuidedR, width, meanCurChannelImage, width, varGuidedRxCurChannelImage);
-        Mls<float, 1>(height, width, width, meanGuidedG, width, meanCurChannelImage, width, varGuidedGxCurChannelImage);
-        Mls<float, 1>(height, width, width, meanGuidedB, width, meanCurChannelImage, width, varGuidedBxCurChannelImage);
-
-        float* workspaceR = mp.fastMalloc();
-        float* workspaceG = mp.fastMalloc();
-        float* workspaceB = mp.fastMalloc();
-        Mul<float, 1>(height, width, width, invVarGuidedRR, width, varGuidedRxCurChannelImage, width, workspaceR);
-        Mul<float, 1>(height, width, width, invVarGuidedRG, width, varGuidedRxCurChannelImage, width, workspaceG);
-        Mul<float, 1>(height, width, width, invVarGuidedRB, width, varGuidedRxCurChannelImage, width, workspaceB);
-        mp.fastFree(varGuidedRxCurChannelImage);
-
-        Mla<float, 1>(height, width, width, invVarGuidedRG, width, varGuidedGxCurChannelImage, width, workspaceR);
-        Mla<float, 1>(height, width, width, invVarGuidedGG, width, varGuidedGxCurChannelImage, width, workspaceG);
-        Mla<float, 1>(height, width, width, invVarGuidedGB, width, varGuidedGxCurChannelImage, width, workspaceB);
-        mp.fastFree(varGuidedGxCurChannelImage);
-
-        Mla<float, 1>(height, width, width, invVarGuidedRB, width, varGuidedBxCurChannelImage, width, workspaceR);
-        Mla<float, 1>(height, width, width, invVarGuidedGB, width, varGuidedBxCurChannelImage, width, workspaceG);
-        Mla<float, 1>(height, width, width, invVarGuidedBB, width, varGuidedBxCurChannelImage, width, workspaceB);
-        mp.fastFree(varGuidedBxCurChannelImage);
-
-        Mls<float, 1>(height, width, width, workspaceR, width, meanGuidedR, width, meanCurChannelImage);
-        Mls<float, 1>(height, width, width, workspaceG, width, meanGuidedG, width, meanCurChannelImage);
-        Mls<float, 1>(height, width, width, workspaceB, width, meanGuidedB, width, meanCurChannelImage);
-
-        workspace = mp.fastMalloc();
-        BoxFilter<float, 1>(height, width, width, workspaceR, kernelSize, kernelSize, true, width, workspace, border_type);
-        mp.fastFree(workspaceR);
-        Mul<float, 1>(height, width, width, workspace, width, guidedR, width, dstArray[i]);
-        BoxFilter<float, 1>(height, width, width, workspaceG, kernelSize, kernelSize, true, width, workspace, border_type);
-        mp.fastFree(workspaceG);
-        Mla<float, 1>(height, width, width, workspace, width, guidedG, width, dstArray[i]);
-        BoxFilter<float, 1>(height, width, width, workspaceB, kernelSize, kernelSize, true, width, workspace, border_type);
-        mp.fastFree(workspaceB);
-        Mla<float, 1>(height, width, width, workspace, width, guidedB, width, dstArray[i]);
-        BoxFilter<float, 1>(height, width, width, meanCurChannelImage, kernelSize, kernelSize, true, width, workspace, border_type);
-        mp.fastFree(meanCurChannelImage);
-        Add<float, 1>(height, width, width, workspace, width, dstArray[i], width, dstArray[i]);
-        mp.fastFree(workspace);
+    if (radius < 0 || subsample < 1) {
+        return ppl::common::RC_INVALID_VALUE;
+    }
+    typedef GuidedFilterLayout<k, m> L;
+    float center[k + m];
+    for (int32_t i = 0; i < k; ++i) {
+        center[i] = guided[i];
+    }
+    for (int32_t c = 0; c < m; ++c) {
+        center[k + c] = src[c];
     }
-    Merge3Channels(height, width, width, dstArray[0], dstArray[1], dstArray[2], outWidthStride, outImage);
+
+    if (subsample == 1) {
+        parallel_for_rows(height, (int64_t)width * L::F, [&](int32_t begin, int32_t end) {
+            guided_filter_band<T, k, m>(height, width, inWidthStride, src, guidedWidthStride, guided, radius, eps, center, border_type, begin, end, [&](int32_t y, int32_t x0, int32_t x1, const float* coeff) {
+                guided_filter_output<T, k, m>(coeff, guided + (int64_t)y * guidedWidthStride + x0 * k, center, x1 - x0, dst + (int64_t)y * outWidthStride + x0 * m);
+            });
+        });
+        return ppl::common::RC_SUCCESS;
+    }
+
+    const int32_t small_height = (height + subsample - 1) / subsample;
+    const int32_t small_width  = (width + subsample - 1) / subsample;
+    const int32_t small_radius = std::max(std::min(radius, 1), (radius + subsample / 2) / subsample);
+    std::unique_ptr<float[]> small_src(new float[(int64_t)small_height * small_width * m]);
+    std::unique_ptr<float[]> small_guided(new float[(int64_t)small_height * small_width * k]);
+    std::unique_ptr<float[]> small_coeff(new float[(int64_t)small_height * small_width * L::G]);
+    guided_filter_shrink<T, m>(height, width, inWidthStride, src, subsample, small_height, small_width, small_src.get());
+    guided_filter_shrink<T, k>(height, width, guidedWidthStride, guided, subsample, small_height, small_width, small_guided.get());
+
+    parallel_for_rows(small_height, (int64_t)small_width * L::F, [&](int32_t begin, int32_t end) {
+        guided_filter_band<float, k, m>(small_height, small_width, small_width * m, small_src.get(), small_width * k, small_guided.get(), small_radius, eps, center, border_type, begin, end, [&](int32_t y, int32_t x0, int32_t x1, const float* coeff) {
+            memcpy(small_coeff.get() + ((int64_t)y * small_width + x0) * L::G, coeff, (x1 - x0) * L::G * sizeof(float));
+        });
+    });
+
+    std::vector<int32_t> xs(width), ys(height);
+    std::vector<float> wx(width), wy(height);
+    guided_filter_upsample_table(width, small_width, xs.data(), wx.data());
+    guided_filter_upsample_table(height, small_height, ys.data(), wy.data());
+    parallel_for_rows(height, (int64_t)width * L::G, [&](int32_t begin, int32_t end) {
+        // a row of coefficients interpolated between two small rows, and
+        // the difference of every small column to the next one
+        std::unique_ptr<float[]> line(new float[small_width * L::G]);
+        std::unique_ptr<float[]> slope(new float[small_width * L::G]);
+        std::unique_ptr<float[]> coeff(new float[GUIDED_FILTER_STRIP_WIDTH * L::G]);
+        for (int32_t y = begin; y < end; ++y) {
+            const float* r0 = small_coeff.get() + (int64_t)ys[y] * small_width * L::G;
+            const float* r1 = ys[y] + 1 < small_height ? r0 + small_width * L::G : r0;
+            __m128 w1       = _mm_set1_ps(wy[y]);
+            for (int32_t i = 0; i < small_width * L::G; i += 4) {
+                __m128 v0 = _mm_loadu_ps(r0 + i);
+                __m128 v1 = _mm_loadu_ps(r1 + i);
+                _mm_storeu_ps(line.get() + i, _mm_add_ps(v0, _mm_mul_ps(_mm_sub_ps(v1, v0), w1)));
+            }
+            for (int32_t i = 0; i < (small_width - 1) * L::G; i += 4) {
+                _mm_storeu_ps(slope.get() + i, _mm_sub_ps(_mm_loadu_ps(line.get() + L::G + i), _mm_loadu_ps(line.get() + i)));
+            }
+            memset(slope.get() + (small_width - 1) * L::G, 0, L::G * sizeof(float));
+            for (int32_t x0 = 0; x0 < width; x0 += GUIDED_FILTER_STRIP_WIDTH) {
+                int32_t x1 = std::min(width, x0 + GUIDED_FILTER_STRIP_WIDTH);
+                for (int32_t x = x0; x < x1; ++x) {
+                    const float* c = line.get() + xs[x] * L::G;
+                    const float* d = slope.get() + xs[x] * L::G;
+                    __m128 w       = _mm_set1_ps(wx[x]);
+                    for (int32_t i = 0; i < L::G; i += 4) {
+                        _mm_storeu_ps(coeff.get() + (x - x0) * L::G + i, _mm_add_ps(_mm_loadu_ps(c + i), _mm_mul_ps(_mm_loadu_ps(d + i), w)));
+                    }
+                }
+                guided_filter_output<T, k, m>(coeff.get(), guided + (int64_t)y * guidedWidthStride + x0 * k, center, x1 - x0, dst + (int64_t)y * outWidthStride + x0 * m);
+            }
+        }
+    });
     return ppl::common::RC_SUCCESS;
 }
 
 template <>
-::ppl::common::RetCode GuidedFilter<uint8_t, 3, 3>(
+::ppl::common::RetCode GuidedFilter<float, 1, 1>(
     int32_t height,
     int32_t width,
     int32_t inWidthStride,
-    const uint8_t* inImage,
+    const float* inImage,
     int32_t guidedWidthStride,
-    const uint8_t* guidedImage,
+    const float* guidedImage,
     int32_t outWidthStride,
-    uint8_t* outImage,
+    float* outImage,
     int32_t radius,
     float eps,
-    BorderType border_type)
+    BorderType border_type,
+    int32_t subsample)
 {
-    if (nullptr == inImage || nullptr == outImage || nullptr == guidedImage) {
-        return ppl::common::RC_INVALID_VALUE;
-    }
-    if (width <= 0 || height <= 0 || inWidthStride < width || outWidthStride < width || guidedWidthStride <= 0) {
-        return ppl::common::RC_INVALID_VALUE;
-    }
-    if (border_type != ppl::cv::BORDER_REFLECT && border_type != ppl::cv::BORDER_REFLECT101) {
-        return ppl::common::RC_INVALID_VALUE;
-    }
+    return guided_filter<float, 1, 1>(height, width, inWidthStride, inImage, guidedWidthStride, guidedImage, outWidthStride, outImage, radius, eps, border_type, subsample);
+}
 
-    std::unique_ptr<float[]> srcImageFP32(new float[height * width * 3]);
-    std::unique_ptr<float[]> guidedImageFP32(new float[height * width * 3]);
-    std::unique_ptr<float[]> dstImageFP32(new float[height * width * 3]);
-    ConvertTo<uint8_t, 3, float>(height, width, inWidthStride, inImage, 1.0f, width * 3, srcImageFP32.get());
-    ConvertTo<uint8_t, 3, float>(height, width, guidedWidthStride, guidedImage, 1.0f, width * 3, guidedImageFP32.get());
-    GuidedFilter<float, 3, 3>(height, width, inWidthStride, srcImageFP32.get(), guidedWidthStride, guidedImageFP32.get(), outWidthStride, dstImageFP32.get(), radius, eps, border_type);
-    ConvertTo<float, 3, uint8_t>(height, width, width * 3, dstImageFP32.get(), 1.0f, outWidthStride, outImage);
-    return ppl::common::RC_SUCCESS;
+template <>
+::ppl::common::RetCode GuidedFilter<float, 3, 3>(
+    int32_t height,
+    int32_t width,
+    int32_t inWidthStride,
+    const float* inImage,
+    int32_t guidedWidthStride,
+    const float* guidedImage,
+    int32_t outWidthStride,
+    float* outImage,
+    int32_t radius,
+    float eps,
+    BorderType border_type,
+    int32_t subsample)
+{
+    return guided_filter<float, 3, 3>(height, width, inWidthStride, inImage, guidedWidthStride, guidedImage, outWidthStride, outImage, radius, eps, border_type, subsample);
+}
+
+template <>
+::ppl::common::RetCode GuidedFilter<float, 1, 3>(
+    int32_t height,
+    int32_t width,
+    int32_t inWidthStride,
+    const float* inImage,
+    int32_t guidedWidthStride,
+    const float* guidedImage,
+    int32_t outWidthStride,
+    float* outImage,
+    int32_t radius,
+    float eps,
+    BorderType border_type,
+    int32_t subsample)
+{
+    return guided_filter<float, 1, 3>(height, width, inWidthStride, inImage, guidedWidthStride, guidedImage, outWidthStride, outImage, radius, eps, border_type, subsample);
 }
 
 template <>
@@ -400,210 +626,28 @@ template <>
     uint8_t* outImage,
     int32_t radius,
     float eps,
-    BorderType border_type)
+    BorderType border_type,
+    int32_t subsample)
 {
-    if (nullptr == inImage || nullptr == outImage || nullptr == guidedImage) {
-        return ppl::common::RC_INVALID_VALUE;
-    }
-    if (width <= 0 || height <= 0 || inWidthStride < width || outWidthStride < width || guidedWidthStride <= 0) {
-        return ppl::common::RC_INVALID_VALUE;
-    }
-    if (border_type != ppl::cv::BORDER_REFLECT && border_type != ppl::cv::BORDER_REFLECT101) {
-        return ppl::common::RC_INVALID_VALUE;
-    }
-
-    std::unique_ptr<float[]> srcImageFP32(new float[height * width * 1]);
-    std::unique_ptr<float[]> guidedImageFP32(new float[height * width * 1]);
-    std::unique_ptr<float[]> dstImageFP32(new float[height * width * 1]);
-    ConvertTo<uint8_t, 1, float>(height, width, inWidthStride, inImage, 1.0f, width, srcImageFP32.get());
-    ConvertTo<uint8_t, 1, float>(height, width, guidedWidthStride, guidedImage, 1.0f, width * 1, guidedImageFP32.get());
-    GuidedFilter<float, 1, 1>(height, width, inWidthStride, srcImageFP32.get(), guidedWidthStride, guidedImageFP32.get(), outWidthStride, dstImageFP32.get(), radius, eps, border_type);
-    ConvertTo<float, 1, uint8_t>(height, width, width, dstImageFP32.get(), 1.0f, outWidthStride, outImage);
-    return ppl::common::RC_SUCCESS;
+    return guided_filter<uint8_t, 1, 1>(height, width, inWidthStride, inImage, guidedWidthStride, guidedImage, outWidthStride, outImage, radius, eps, border_type, subsample);
 }
 
 template <>
-::ppl::common::RetCode GuidedFilter<float, 1, 3>(
+::ppl::common::RetCode GuidedFilter<uint8_t, 3, 3>(
     int32_t height,
     int32_t width,
     int32_t inWidthStride,
-    const float* inImage,
+    const uint8_t* inImage,
     int32_t guidedWidthStride,
-    const float* guidedImage,
+    const uint8_t* guidedImage,
     int32_t outWidthStride,
-    float* outImage,
+    uint8_t* outImage,
     int32_t radius,
     float eps,
-    BorderType border_type)
+    BorderType border_type,
+    int32_t subsample)
 {
-    if (nullptr == inImage || nullptr == outImage || nullptr == guidedImage) {
-        return ppl::common::RC_INVALID_VALUE;
-    }
-    if (width <= 0 || height <= 0 || inWidthStride < width || outWidthStride < width || guidedWidthStride <= 0) {
-        return ppl::common::RC_INVALID_VALUE;
-    }
-    if (border_type != ppl::cv::BORDER_REFLECT && border_type != ppl::cv::BORDER_REFLECT101) {
-        return ppl::common::RC_INVALID_VALUE;
-    }
-    int32_t kernelSize = 2 * radius + 1;
-
-    simpleMemoryPool<float> mp(width * height, 20);
-
-    float* guidedR = mp.fastMalloc();
-    float* guidedG = mp.fastMalloc();
-    float* guidedB = mp.fastMalloc();
-    Split3Channels(height, width, guidedWidthStride, guidedImage, width, guidedR, guidedG, guidedB);
-
-    float* meanGuidedR = mp.fastMalloc();
-    float* meanGuidedG = mp.fastMalloc();
-    float* meanGuidedB = mp.fastMalloc();
-    BoxFilter<float, 1>(height, width, width, guidedR, kernelSize, kernelSize, true, width, meanGuidedR, border_type);
-    BoxFilter<float, 1>(height, width, width, guidedG, kernelSize, kernelSize, true, width, meanGuidedG, border_type);
-    BoxFilter<float, 1>(height, width, width, guidedB, kernelSize, kernelSize, true, width, meanGuidedB, border_type);
-
-    float* GuidedRxGuidedR = mp.fastMalloc();
-    float* GuidedRxGuidedG = mp.fastMalloc();
-    float* GuidedRxGuidedB = mp.fastMalloc();
-    float* GuidedGxGuidedG = mp.fastMalloc();
-    float* GuidedGxGuidedB = mp.fastMalloc();
-    float* GuidedBxGuidedB = mp.fastMalloc();
-    Mul<float, 1>(height, width, width, guidedR, width, guidedR, width, GuidedRxGuidedR);
-    Mul<float, 1>(height, width, width, guidedR, width, guidedG, width, GuidedRxGuidedG);
-    Mul<float, 1>(height, width, width, guidedR, width, guidedB, width, GuidedRxGuidedB);
-    Mul<float, 1>(height, width, width, guidedG, width, guidedG, width, GuidedGxGuidedG);
-    Mul<float, 1>(height, width, width, guidedG, width, guidedB, width, GuidedGxGuidedB);
-    Mul<float, 1>(height, width, width, guidedB, width, guidedB, width, GuidedBxGuidedB);
-
-    float* varGuidedRR = mp.fastMalloc();
-    BoxFilter<float, 1>(height, width, width, GuidedRxGuidedR, kernelSize, kernelSize, true, width, varGuidedRR, border_type);
-    mp.fastFree(GuidedRxGuidedR);
-    float* varGuidedRG = mp.fastMalloc();
-    BoxFilter<float, 1>(height, width, width, GuidedRxGuidedG, kernelSize, kernelSize, true, width, varGuidedRG, border_type);
-    mp.fastFree(GuidedRxGuidedG);
-    float* varGuidedRB = mp.fastMalloc();
-    BoxFilter<float, 1>(height, width, width, GuidedRxGuidedB, kernelSize, kernelSize, true, width, varGuidedRB, border_type);
-    mp.fastFree(GuidedRxGuidedB);
-    float* varGuidedGG = mp.fastMalloc();
-    BoxFilter<float, 1>(height, width, width, GuidedGxGuidedG, kernelSize, kernelSize, true, width, varGuidedGG, border_type);
-    mp.fastFree(GuidedGxGuidedG);
-    float* varGuidedGB = mp.fastMalloc();
-    BoxFilter<float, 1>(height, width, width, GuidedGxGuidedB, kernelSize, kernelSize, true, width, varGuidedGB, border_type);
-    mp.fastFree(GuidedGxGuidedB);
-    float* varGuidedBB = mp.fastMalloc();
-    BoxFilter<float, 1>(height, width, width, GuidedBxGuidedB, kernelSize, kernelSize, true, width, varGuidedBB, border_type);
-    mp.fastFree(GuidedBxGuidedB);
-
-    // stay here
-    Mls<float, 1>(height, width, width, meanGuidedR, width, meanGuidedR, width, varGuidedRR);
-    Mls<float, 1>(height, width, width, meanGuidedR, width, meanGuidedG, width, varGuidedRG);
-    Mls<float, 1>(height, width, width, meanGuidedR, width, meanGuidedB, width, varGuidedRB);
-    Mls<float, 1>(height, width, width, meanGuidedG, width, meanGuidedG, width, varGuidedGG);
-    Mls<float, 1>(height, width, width, meanGuidedG, width, meanGuidedB, width, varGuidedGB);
-    Mls<float, 1>(height, width, width, meanGuidedB, width, meanGuidedB, width, varGuidedBB);
-
-    float* epsImage = mp.fastMalloc();
-    SetTo<float, 1>(height, width, width, epsImage, eps);
-    Add<float, 1>(height, width, width, varGuidedRR, width, epsImage, width, varGuidedRR);
-    Add<float, 1>(height, width, width, varGuidedGG, width, epsImage, width, varGuidedGG);
-    Add<float, 1>(height, width, width, varGuidedBB, width, epsImage, width, varGuidedBB);
-    mp.fastFree(epsImage);
-
-    float* invVarGuidedRR = mp.fastMalloc();
-    float* invVarGuidedRG = mp.fastMalloc();
-    float* invVarGuidedRB = mp.fastMalloc();
-    float* invVarGuidedGG = mp.fastMalloc();
-    float* invVarGuidedGB = mp.fastMalloc();
-    float* invVarGuidedBB = mp.fastMalloc();
-    Mul<float, 1>(height, width, width, varGuidedGG, width, varGuidedBB, width, invVarGuidedRR);
-    Mul<float, 1>(height, width, width, varGuidedGB, width, varGuidedRB, width, invVarGuidedRG);
-    Mul<float, 1>(height, width, width, varGuidedRG, width, varGuidedGB, width, invVarGuidedRB);
-    Mul<float, 1>(height, width, width, varGuidedRR, width, varGuidedBB, width, invVarGuidedGG);
-    Mul<float, 1>(height, width, width, varGuidedRB, width, varGuidedRG, width, invVarGuidedGB);
-    Mul<float, 1>(height, width, width, varGuidedRR, width, varGuidedGG, width, invVarGuidedBB);
-
-    Mls<float, 1>(height, width, width, varGuidedGB, width, varGuidedGB, width, invVarGuidedRR);
-    Mls<float, 1>(height, width, width, varGuidedRG, width, varGuidedBB, width, invVarGuidedRG);
-    mp.fastFree(varGuidedBB);
-    Mls<float, 1>(height, width, width, varGuidedGG, width, varGuidedRB, width, invVarGuidedRB);
-    mp.fastFree(varGuidedGG);
-    Mls<float, 1>(height, width, width, varGuidedRB, width, varGuidedRB, width, invVarGuidedGG);
-    Mls<float, 1>(height, width, width, varGuidedRR, width, varGuidedGB, width, invVarGuidedGB);
-    mp.fastFree(varGuidedGB);
-    Mls<float, 1>(height, width, width, varGuidedRG, width, varGuidedRG, width, invVarGuidedBB);
-
-    float* convDet = mp.fastMalloc();
-    Mul<float, 1>(height, width, width, invVarGuidedRR, width, varGuidedRR, width, convDet);
-    mp.fastFree(varGuidedRR);
-    Mla<float, 1>(height, width, width, invVarGuidedRG, width, varGuidedRG, width, convDet);
-    mp.fastFree(varGuidedRG);
-    Mla<float, 1>(height, width, width, invVarGuidedRB, width, varGuidedRB, width, convDet);
-    mp.fastFree(varGuidedRB);
-
-    Div<float, 1>(height, width, width, invVarGuidedRR, width, convDet, width, invVarGuidedRR);
-    Div<float, 1>(height, width, width, invVarGuidedRG, width, convDet, width, invVarGuidedRG);
-    Div<float, 1>(height, width, width, invVarGuidedRB, width, convDet, width, invVarGuidedRB);
-    Div<float, 1>(height, width, width, invVarGuidedGG, width, convDet, width, invVarGuidedGG);
-    Div<float, 1>(height, width, width, invVarGuidedGB, width, convDet, width, invVarGuidedGB);
-    Div<float, 1>(height, width, width, invVarGuidedBB, width, convDet, width, invVarGuidedBB);
-    mp.fastFree(convDet);
-
-    float* workspace = nullptr;
-
-    float* meanImage        = mp.fastMalloc();
-    float* varGuidedRxImage = mp.fastMalloc();
-    float* varGuidedGxImage = mp.fastMalloc();
-    float* varGuidedBxImage = mp.fastMalloc();
-    workspace               = mp.fastMalloc();
-    BoxFilter<float, 1>(height, width, inWidthStride, inImage, kernelSize, kernelSize, true, width, meanImage, border_type);
-    Mul<float, 1>(height, width, width, guidedR, inWidthStride, inImage, width, workspace);
-    BoxFilter<float, 1>(height, width, width, workspace, kernelSize, kernelSize, true, width, varGuidedRxImage, border_type);
-    Mul<float, 1>(height, width, width, guidedG, inWidthStride, inImage, width, workspace);
-    BoxFilter<float, 1>(height, width, width, workspace, kernelSize, kernelSize, true, width, varGuidedGxImage, border_type);
-    Mul<float, 1>(height, width, width, guidedB, inWidthStride, inImage, width, workspace);
-    BoxFilter<float, 1>(height, width, width, workspace, kernelSize, kernelSize, true, width, varGuidedBxImage, border_type);
-    mp.fastFree(workspace);
-
-    Mls<float, 1>(height, width, width, meanGuidedR, width, meanImage, width, varGuidedRxImage);
-    Mls<float, 1>(height, width, width, meanGuidedG, width, meanImage, width, varGuidedGxImage);
-    Mls<float, 1>(height, width, width, meanGuidedB, width, meanImage, width, varGuidedBxImage);
-
-    float* workspaceR = mp.fastMalloc();
-    float* workspaceG = mp.fastMalloc();
-    float* workspaceB = mp.fastMalloc();
-    Mul<float, 1>(height, width, width, invVarGuidedRR, width, varGuidedRxImage, width, workspaceR);
-    Mul<float, 1>(height, width, width, invVarGuidedRG, width, varGuidedRxImage, width, workspaceG);
-    Mul<float, 1>(height, width, width, invVarGuidedRB, width, varGuidedRxImage, width, workspaceB);
-    mp.fastFree(varGuidedRxImage);
-
-    Mla<float, 1>(height, width, width, invVarGuidedRG, width, varGuidedGxImage, width, workspaceR);
-    Mla<float, 1>(height, width, width, invVarGuidedGG, width, varGuidedGxImage, width, workspaceG);
-    Mla<float, 1>(height, width, width, invVarGuidedGB, width, varGuidedGxImage, width, workspaceB);
-    mp.fastFree(varGuidedGxImage);
-
-    Mla<float, 1>(height, width, width, invVarGuidedRB, width, varGuidedBxImage, width, workspaceR);
-    Mla<float, 1>(height, width, width, invVarGuidedGB, width, varGuidedBxImage, width, workspaceG);
-    Mla<float, 1>(height, width, width, invVarGuidedBB, width, varGuidedBxImage, width, workspaceB);
-    mp.fastFree(varGuidedBxImage);
-
-    Mls<float, 1>(height, width, width, workspaceR, width, meanGuidedR, width, meanImage);
-    Mls<float, 1>(height, width, width, workspaceG, width, meanGuidedG, width, meanImage);
-    Mls<float, 1>(height, width, width, workspaceB, width, meanGuidedB, width, meanImage);
-
-    workspace = mp.fastMalloc();
-    BoxFilter<float, 1>(height, width, width, workspaceR, kernelSize, kernelSize, true, width, workspace, border_type);
-    mp.fastFree(workspaceR);
-    Mul<float, 1>(height, width, width, workspace, width, guidedR, outWidthStride, outImage);
-    BoxFilter<float, 1>(height, width, width, workspaceG, kernelSize, kernelSize, true, width, workspace, border_type);
-    mp.fastFree(workspaceG);
-    Mla<float, 1>(height, width, width, workspace, width, guidedG, outWidthStride, outImage);
-    BoxFilter<float, 1>(height, width, width, workspaceB, kernelSize, kernelSize, true, width, workspace, border_type);
-    mp.fastFree(workspaceB);
-    Mla<float, 1>(height, width, width, workspace, width, guidedB, outWidthStride, outImage);
-    BoxFilter<float, 1>(height, width, width, meanImage, kernelSize, kernelSize, true, width, workspace, border_type);
-    mp.fastFree(meanImage);
-    Add<float, 1>(height, width, width, workspace, outWidthStride, outImage, outWidthStride, outImage);
-    mp.fastFree(workspace);
-    return ppl::common::RC_SUCCESS;
+    return guided_filter<uint8_t, 3, 3>(height, width, inWidthStride, inImage, guidedWidthStride, guidedImage, outWidthStride, outImage, radius, eps, border_type, subsample);
 }
 
 template <>
@@ -618,26 +662,10 @@ template <>
     uint8_t* outImage,
     int32_t radius,
     float eps,
-    BorderType border_type)
+    BorderType border_type,
+    int32_t subsample)
 {
-    if (nullptr == inImage || nullptr == outImage || nullptr == guidedImage) {
-        return ppl::common::RC_INVALID_VALUE;
-    }
-    if (width <= 0 || height <= 0 || inWidthStride < width || outWidthStride < width || guidedWidthStride <= 0) {
-        return ppl::common::RC_INVALID_VALUE;
-    }
-    if (border_type != ppl::cv::BORDER_REFLECT && border_type != ppl::cv::BORDER_REFLECT101) {
-        return ppl::common::RC_INVALID_VALUE;
-    }
-
-    std::unique_ptr<float[]> srcImageFP32(new float[height * width * 1]);
-    std::unique_ptr<float[]> guidedImageFP32(new float[height * width * 3]);
-    std::unique_ptr<float[]> dstImageFP32(new float[height * width * 1]);
-    ConvertTo<uint8_t, 1, float>(height, width, inWidthStride, inImage, 1.0f, width, srcImageFP32.get());
-    ConvertTo<uint8_t, 3, float>(height, width, guidedWidthStride, guidedImage, 1.0f, width * 3, guidedImageFP32.get());
-    GuidedFilter<float, 1, 3>(height, width, inWidthStride, srcImageFP32.get(), guidedWidthStride, guidedImageFP32.get(), outWidthStride, dstImageFP32.get(), radius, eps, border_type);
-    ConvertTo<float, 1, uint8_t>(height, width, width, dstImageFP32.get(), 1.0f, outWidthStride, outImage);
-    return ppl::common::RC_SUCCESS;
+    return guided_filter<uint8_t, 1, 3>(height, width, inWidthStride, inImage, guidedWidthStride, guidedImage, outWidthStride, outImage, radius, eps, border_type, subsample);
 }
 
 }
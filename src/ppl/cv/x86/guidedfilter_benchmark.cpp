@@ -45,7 +45,7 @@ public:
         memset(this->dev_guidedImage, 0, inWidth * inHeight * channels * sizeof(T));
     }
 
-    void apply() {
+    void apply(int32_t subsample = 1) {
         int32_t r = 8;
         float eps = 0.4 * 0.4;
         ppl::cv::x86::GuidedFilter<T, channels, channels>(
@@ -59,7 +59,8 @@ public:
             this->dev_oImage,
             r,
             eps,
-            ppl::cv::BORDER_DEFAULT);
+            ppl::cv::BORDER_DEFAULT,
+            subsample);
     }
 
     void apply_opencv() {
@@ -89,6 +90,15 @@ static void BM_GuidedFilter_ppl_x86(benchmark::State &state) {
     state.SetItemsProcessed(state.iterations());
 }
 
+template<typename T, int32_t channels, int32_t subsample>
+static void BM_GuidedFilterSubsample_ppl_x86(benchmark::State &state) {
+    GuidedFilterBenchmark<T, channels> bm(state.range(0), state.range(1), state.range(2), state.range(3));
+    for (auto _: state) {
+        bm.apply(subsample);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
 template<typename T, int32_t channels>
 static void BM_GuidedFilter_opencv_x86(benchmark::State &state) {
     GuidedFilterBenchmark<T, channels> bm(state.range(0), state.range(1), state.range(2), state.range(3));
@@ -101,6 +111,13 @@ static void BM_GuidedFilter_opencv_x86(benchmark::State &state) {
 //ppl.cv
 BENCHMARK_TEMPLATE(BM_GuidedFilter_ppl_x86, float, 3)->Args({320, 240, 320, 320});
 BENCHMARK_TEMPLATE(BM_GuidedFilter_ppl_x86, uint8_t, 3)->Args({320, 240, 320, 320});
+BENCHMARK_TEMPLATE(BM_GuidedFilterSubsample_ppl_x86, uint8_t, 1, 1)->Args({1920, 1080, 1920, 1080})->Args({3840, 2160, 3840, 2160});
+BENCHMARK_TEMPLATE(BM_GuidedFilterSubsample_ppl_x86, uint8_t, 3, 1)->Args({1920, 1080, 1920, 1080})->Args({3840, 2160, 3840, 2160});
+BENCHMARK_TEMPLATE(BM_GuidedFilterSubsample_ppl_x86, uint8_t, 1, 4)->Args({1920, 1080, 1920, 1080})->Args({3840, 2160, 3840, 2160});
+BENCHMARK_TEMPLATE(BM_GuidedFilterSubsample_ppl_x86, uint8_t, 3, 2)->Args({1920, 1080, 1920, 1080})->Args({3840, 2160, 3840, 2160});
+BENCHMARK_TEMPLATE(BM_GuidedFilterSubsample_ppl_x86, uint8_t, 3, 4)->Args({1920, 1080, 1920, 1080})->Args({3840, 2160, 3840, 2160});
+BENCHMARK_TEMPLATE(BM_GuidedFilterSubsample_ppl_x86, float, 3, 1)->Args({1920, 1080, 1920, 1080})->Args({3840, 2160, 3840, 2160});
+BENCHMARK_TEMPLATE(BM_GuidedFilterSubsample_ppl_x86, float, 3, 4)->Args({1920, 1080, 1920, 1080})->Args({3840, 2160, 3840, 2160});
 
 //opencv
 BENCHMARK_TEMPLATE(BM_GuidedFilter_opencv_x86, float, 3)->Args({320, 240, 320, 320});
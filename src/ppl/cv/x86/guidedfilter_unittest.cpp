@@ -20,6 +20,9 @@
 #include <opencv2/ximgproc.hpp>
 #include "ppl/cv/debug.h"
 #include "ppl/cv/x86/test.h"
+#include <algorithm>
+#include <cmath>
+#include <memory>
 
 template<typename T, int32_t c_src, int32_t c_guide>
 class GuidedFilter : public ::testing::TestWithParam<std::tuple<Size, float>> {
@@ -95,3 +98,67 @@ R(GuidedFilter_f32c13, float, 1, 3, 1e-3)
 R(GuidedFilter_u8c11, uint8_t, 1, 1, 2)
 R(GuidedFilter_u8c33, uint8_t, 3, 3, 2)
 R(GuidedFilter_u8c13, uint8_t, 1, 3, 2)
+
+// Smooth shading, a disc and a bright block, plus noise.
+template<typename T, int32_t nc>
+void fillScene(T *data, int32_t height, int32_t width) {
+    std::unique_ptr<T[]> noise(new T[width * height * nc]);
+    ppl::cv::debug::randomFill<T>(noise.get(), width * height * nc, 0, 40);
+    for (int32_t i = 0; i < height; ++i) {
+        for (int32_t j = 0; j < width; ++j) {
+            for (int32_t c = 0; c < nc; ++c) {
+                float v = 60.f + 0.1f * j + 20.f * std::sin(i * 0.02f + c);
+                if ((i - height / 2) * (i - height / 2) + (j - width / 3) * (j - width / 3) < height * height / 16) {
+                    v += 90.f - 30.f * c;
+                }
+                if (j > 2 * width / 3 && i < height / 2) {
+                    v = 200.f - 40.f * c;
+                }
+                v += (float)noise[(i * width + j) * nc + c] - 20.f;
+                data[(i * width + j) * nc + c] = (T)std::min(255.f, std::max(0.f, v));
+            }
+        }
+    }
+}
+
+// The fast guided filter is compared with the full resolution one by PSNR.
+template<typename T, int32_t c_src, int32_t c_guide, int32_t subsample>
+void GuidedFilterFastTest(int32_t height, int32_t width, double min_psnr) {
+    int32_t r = 8;
+    float eps = 0.1 * 0.1 * 255 * 255;
+    std::unique_ptr<T[]> src(new T[width * height * c_src]);
+    std::unique_ptr<T[]> guided(new T[width * height * c_guide]);
+    std::unique_ptr<T[]> dst_ref(new T[width * height * c_src]);
+    std::unique_ptr<T[]> dst(new T[width * height * c_src]);
+    fillScene<T, c_src>(src.get(), height, width);
+    fillScene<T, c_guide>(guided.get(), height, width);
+
+    cv::Mat src_opencv(height, width, CV_MAKETYPE(cv::DataType<T>::depth, c_src), src.get(), sizeof(T) * width * c_src);
+    cv::Mat guided_opencv(height, width, CV_MAKETYPE(cv::DataType<T>::depth, c_guide), guided.get(), sizeof(T) * width * c_guide);
+    cv::Mat dst_opencv(height, width, CV_MAKETYPE(cv::DataType<T>::depth, c_src), dst_ref.get(), sizeof(T) * width * c_src);
+    cv::ximgproc::guidedFilter(guided_opencv, src_opencv, dst_opencv, r, eps, -1);
+
+    ppl::cv::x86::GuidedFilter<T, c_src, c_guide>(height, width, width * c_src, src.get(), width * c_guide, guided.get(),
+                                                  width * c_src, dst.get(), r, eps, ppl::cv::BORDER_REFLECT, subsample);
+
+    double mse = 0;
+    for (int32_t i = 0; i < height * width * c_src; ++i) {
+        double diff = (double)dst_ref[i] - (double)dst[i];
+        mse += diff * diff;
+    }
+    EXPECT_GT(10 * std::log10(255.0 * 255.0 * height * width * c_src / mse), min_psnr);
+}
+
+TEST(GuidedFilter_Fast_FP32, x86)
+{
+    GuidedFilterFastTest<float, 1, 1, 2>(240, 320, 50.0);
+    GuidedFilterFastTest<float, 3, 3, 2>(240, 320, 50.0);
+    GuidedFilterFastTest<float, 1, 3, 4>(240, 320, 45.0);
+}
+
+TEST(GuidedFilter_Fast_U8, x86)
+{
+    GuidedFilterFastTest<uint8_t, 1, 1, 2>(240, 320, 50.0);
+    GuidedFilterFastTest<uint8_t, 3, 3, 4>(240, 320, 45.0);
+    GuidedFilterFastTest<uint8_t, 1, 3, 2>(240, 320, 50.0);
+}
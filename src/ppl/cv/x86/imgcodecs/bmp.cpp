@@ -442,6 +442,7 @@ bool BmpDecoder::readHeader() {
     }
 
     channels_ = colorful ? (bits_per_pixel_ == 32 ? 4 : 3) : 1;
+    depth_ = 8;
     origin_ = height > 0 ? ORIGIN_BL : ORIGIN_TL;
     width_  = abs(width);
     height_ = abs(height);
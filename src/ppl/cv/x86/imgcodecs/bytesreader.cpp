@@ -18,6 +18,12 @@
 #include "bytesreader.h"
 
 #include <string.h>
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#include <algorithm>
 
 #include "codecs.h"
 #include "ppl/common/log.h"
@@ -26,19 +32,99 @@ namespace ppl {
 namespace cv {
 namespace x86 {
 
-BytesReader::BytesReader(FILE* fp) {
+BytesReader::BytesReader(FILE* fp, bool header_only) {
+    mapped_size_ = 0;
+    block_position_ = 0;
+    crc_ = nullptr;
+    if (loadFile(fp, header_only)) {
+        return;
+    }
+
     fp_ = fp;
+    owns_buffer_ = true;
     start_ = new uint8_t[FILE_BLOCK_SIZE];
     current_ = start_;
-    block_position_ = 0;
     is_last_block_ = false;
-    crc_ = nullptr;
 
     readBlock();
 }
 
+BytesReader::BytesReader(const uint8_t* data, uint32_t size) {
+    fp_ = nullptr;
+    owns_buffer_ = false;
+    mapped_size_ = 0;
+    start_ = const_cast<uint8_t*>(data);
+    end_ = start_ + size;
+    current_ = start_;
+    block_position_ = 0;
+    is_last_block_ = true;
+    crc_ = nullptr;
+}
+
 BytesReader::~BytesReader() {
-    delete [] start_;
+#ifndef _WIN32
+    if (mapped_size_ != 0) {
+        munmap(start_, mapped_size_);
+    }
+#endif
+    if (owns_buffer_) {
+        delete [] start_;
+    }
+}
+
+/* The whole file becomes one contiguous block, so the decoders read it in
+ * place through the in-memory paths, without the block refills and the 16MB
+ * block buffer. Mapping costs a few system calls and page faults, which only
+ * pay off for large files, small ones are read with one fread(). Reading a
+ * header maps any file, as it touches only its first pages.
+ */
+bool BytesReader::loadFile(FILE* fp, bool header_only) {
+#ifndef _WIN32
+    struct stat file_stat;
+    int fd = fileno(fp);
+    if (fd < 0 || fstat(fd, &file_stat) != 0 || !S_ISREG(file_stat.st_mode) ||
+        file_stat.st_size <= 0 || file_stat.st_size > UINT32_MAX) {
+        return false;
+    }
+
+    size_t size = file_stat.st_size;
+    uint8_t* data = nullptr;
+    if (size >= FILE_MAP_THRESHOLD || header_only) {
+        void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped == MAP_FAILED) {
+            return false;
+        }
+        // the decoders walk the file once from the beginning.
+        if (!header_only) {
+            madvise(mapped, size, MADV_SEQUENTIAL);
+            madvise(mapped, size, MADV_WILLNEED);
+        }
+        data = (uint8_t*)mapped;
+        mapped_size_ = size;
+        owns_buffer_ = false;
+    }
+    else {
+        data = new uint8_t[size];
+        if (fread(data, 1, size, fp) != size) {
+            delete [] data;
+            rewind(fp);
+            return false;
+        }
+        owns_buffer_ = true;
+    }
+
+    fp_ = nullptr;
+    start_ = data;
+    end_ = start_ + size;
+    current_ = start_;
+    is_last_block_ = true;
+
+    return true;
+#else
+    (void)fp;
+    (void)header_only;
+    return false;
+#endif
 }
 
 uint8_t* BytesReader::data() const {
@@ -52,6 +138,11 @@ uint32_t BytesReader::getPosition() {
 }
 
 void BytesReader::setPosition(uint32_t position) {
+    if (fp_ == nullptr) {
+        current_ = start_ + std::min(position, (uint32_t)(end_ - start_));
+        return;
+    }
+
     uint32_t offset = position % FILE_BLOCK_SIZE;
     uint32_t prev_block_position = block_position_;
     block_position_ = position - offset;
@@ -62,6 +153,15 @@ void BytesReader::setPosition(uint32_t position) {
 }
 
 bool BytesReader::skipBytes(uint32_t size) {
+    if (fp_ == nullptr) {
+        if (size > getValidSize()) {
+            current_ = end_;
+            return false;
+        }
+        current_ += size;
+        return true;
+    }
+
     if (size <= FILE_BLOCK_SIZE - (current_ - start_)) {
         current_ += size;
     }
@@ -80,11 +180,19 @@ bool BytesReader::skipBytes(uint32_t size) {
         readBlock();
         current_ = start_ + offset;
     }
+    if (current_ > end_) {  // beyond the end of the file
+        current_ = end_;
+        return false;
+    }
 
     return true;
 }
 
 void BytesReader::readBlock() {
+    if (fp_ == nullptr) {  // the whole buffer is the only block.
+        return;
+    }
+
     uint32_t readed = fread(start_, 1, FILE_BLOCK_SIZE, fp_);
     if (ferror(fp_)) {
         LOG(ERROR) << "Error in reading the input file.";
@@ -184,6 +292,19 @@ int32_t BytesReader::getDWordBigEndian() {
 }
 
 void BytesReader::getBytes(void* buffer, int32_t count) {
+    if (fp_ == nullptr) {
+        int32_t left = (int32_t)(end_ - current_);
+        if (count > left) {
+            LOG(ERROR) << "Reading " << count << " bytes beyond the input "
+                       << "buffer.";
+            memset((uint8_t*)buffer + left, 0, count - left);
+            count = left;
+        }
+        memcpy(buffer, current_, count);
+        current_ += count;
+        return;
+    }
+
     if (count >= FILE_BLOCK_SIZE) {
         LOG(ERROR) << "The bytes are too big than the buffer.";
     }
@@ -206,7 +327,7 @@ void BytesReader::getBytes(void* buffer, int32_t count) {
 }
 
 uint32_t BytesReader::getValidSize() const {
-    return end_ - current_;
+    return current_ < end_ ? end_ - current_ : 0;
 }
 
 void BytesReader::setCrcChecking(Crc32* crc) {
@@ -30,7 +30,12 @@ namespace x86 {
 
 class BytesReader {
   public:
-    BytesReader(FILE* fp);
+    // Holds a whole regular file in memory when the platform allows, large
+    // ones are mapped and small ones read at once, others are read block by
+    // block. header_only maps files of any size without read-ahead.
+    BytesReader(FILE* fp, bool header_only = false);
+    // Reads a caller-owned buffer in place, it must outlive the reader.
+    BytesReader(const uint8_t* data, uint32_t size);
     ~BytesReader();
 
     uint8_t* data() const;
@@ -48,9 +53,14 @@ class BytesReader {
     uint32_t getValidSize() const;
     void setCrcChecking(Crc32* crc);
     void unsetCrcChecking();
+    bool isInMemory() const {return fp_ == nullptr;}
 
   private:
+    bool loadFile(FILE* fp, bool header_only);
+
     FILE* fp_;
+    bool owns_buffer_;
+    size_t mapped_size_;
     uint8_t* start_;
     uint8_t* end_;
     uint8_t* current_;
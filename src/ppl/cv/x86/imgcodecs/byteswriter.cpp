@@ -17,21 +17,39 @@
 
 #include "byteswriter.h"
 
+#include <stdlib.h>
 #include <string.h>
 #include <assert.h>
 
 #include "codecs.h"
+#include "ppl/common/log.h"
 
 namespace ppl {
 namespace cv {
 namespace x86 {
 
+#define MEMORY_BLOCK_SIZE (1 << 16)
+
 BytesWriter::BytesWriter(FILE* fp) {
     fp_ = fp;
-    start_ = new uchar[FILE_BLOCK_SIZE];
+    start_ = (uchar*)malloc(FILE_BLOCK_SIZE);
     end_ = start_ + FILE_BLOCK_SIZE;
     current_ = start_;
     block_position_ = 0;
+    failed_ = (start_ == nullptr);
+}
+
+BytesWriter::BytesWriter() {
+    fp_ = nullptr;
+    start_ = (uchar*)malloc(MEMORY_BLOCK_SIZE);
+    end_ = start_ + MEMORY_BLOCK_SIZE;
+    current_ = start_;
+    block_position_ = 0;
+    failed_ = (start_ == nullptr);
+}
+
+BytesWriter::~BytesWriter() {
+    free(start_);
 }
 
 int BytesWriter::getPosition() {
@@ -40,19 +58,67 @@ int BytesWriter::getPosition() {
     return position;
 }
 
-void BytesWriter::writeBlock() {
-    int size = (int)(current_ - start_);
+bool BytesWriter::writeBlock() {
+    size_t size = current_ - start_;
+    if (failed_) {
+        current_ = start_;
+        return false;
+    }
+
+    if (fp_ != nullptr) {
+        if (size == 0) {
+            return true;
+        }
 
-    if (size == 0) {
-        return;
+        size_t written = fwrite(start_, 1, size, fp_);
+        current_ = start_;
+        block_position_ += size;
+        if (written != size) {
+            LOG(ERROR) << "failed to write " << size << " bytes to the file.";
+            failed_ = true;
+            return false;
+        }
+        return true;
     }
 
-    fwrite(start_, 1, size, fp_);
-    current_ = start_;
-    block_position_ += size;
+    // the memory buffer doubles when it is full.
+    if (current_ < end_) {
+        return true;
+    }
+    size_t capacity = (end_ - start_) * 2;
+    uchar* buffer = (uchar*)realloc(start_, capacity);
+    if (buffer == nullptr) {
+        LOG(ERROR) << "failed to allocate " << capacity
+                   << " bytes for the encoded data.";
+        failed_ = true;
+        current_ = start_;
+        return false;
+    }
+    start_ = buffer;
+    end_ = buffer + capacity;
+    current_ = buffer + size;
+
+    return true;
+}
+
+uchar* BytesWriter::releaseData(size_t* size) {
+    if (fp_ != nullptr || failed_) {
+        *size = 0;
+        return nullptr;
+    }
+
+    uchar* data = start_;
+    *size = current_ - start_;
+    start_ = nullptr;
+    end_ = nullptr;
+    current_ = nullptr;
+
+    return data;
 }
 
 void BytesWriter::putByte(int value) {
+    if (current_ == nullptr) return;  // no buffer is allocated
+
     *current_++ = (uchar)value;
     if (current_ >= end_) {
         writeBlock();
@@ -61,7 +127,8 @@ void BytesWriter::putByte(int value) {
 
 void BytesWriter::putBytes(const void* buffer, int count) {
     uchar* data = (uchar*)buffer;
-    assert(data && current_ && count >= 0);
+    assert(data && count >= 0);
+    if (current_ == nullptr) return;
 
     while (count) {
         int left = (int)(end_ - current_);
@@ -120,6 +187,44 @@ void BytesWriter::putDWord(int value) {
     }
 }
 
+void BytesWriter::putWordBigEndian(int value) {
+    uchar *current = current_;
+
+    if (current+1 < end_) {
+        current[0] = (uchar)(value >> 8);
+        current[1] = (uchar)value;
+        current_ = current + 2;
+        if (current_ == end_) {
+            writeBlock();
+        }
+    }
+    else {
+        putByte(value >> 8);
+        putByte(value);
+    }
+}
+
+void BytesWriter::putDWordBigEndian(int value) {
+    uchar *current = current_;
+
+    if (current+3 < end_) {
+        current[0] = (uchar)(value >> 24);
+        current[1] = (uchar)(value >> 16);
+        current[2] = (uchar)(value >> 8);
+        current[3] = (uchar)value;
+        current_ = current + 4;
+        if (current_ == end_) {
+            writeBlock();
+        }
+    }
+    else {
+        putByte(value >> 24);
+        putByte(value >> 16);
+        putByte(value >> 8);
+        putByte(value);
+    }
+}
+
 } //! namespace x86
 } //! namespace cv
 } //! namespace ppl
@@ -28,17 +28,26 @@ namespace x86 {
 
 class BytesWriter {
   public:
+    // Writes to a file block by block.
     BytesWriter(FILE* fp);
-    ~BytesWriter() {
-        delete [] start_;
-    }
+    // Writes to a memory buffer growing as needed, which the caller takes
+    // with releaseData().
+    BytesWriter();
+    ~BytesWriter();
 
     int getPosition();
-    void writeBlock();
+    // Writes the buffered block to the file, or grows the memory buffer.
+    // Once it fails, the bytes put after are discarded.
+    bool writeBlock();
     void putByte(int value);
     void putBytes(const void* buffer, int count);
     void putWord(int value);
     void putDWord(int value);
+    void putWordBigEndian(int value);
+    void putDWordBigEndian(int value);
+    bool isFailed() const {return failed_;}
+    // Hands the memory buffer allocated with malloc() over to the caller.
+    uchar* releaseData(size_t* size);
 
   private:
     FILE* fp_;
@@ -46,6 +55,7 @@ class BytesWriter {
     uchar* end_;
     uchar* current_;
     int block_position_;
+    bool failed_;
 };
 
 } //! namespace x86
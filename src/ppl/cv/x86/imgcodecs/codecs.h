@@ -23,6 +23,7 @@ namespace cv {
 namespace x86 {
 
 #define FILE_BLOCK_SIZE (1 << 24)
+#define FILE_MAP_THRESHOLD (1 << 20)
 #define MAX_IMAGE_SIZE (1 << 30)
 
 } //! namespace x86
@@ -19,6 +19,10 @@
 
 #include <stddef.h>
 #include <stdio.h>
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
 
 #include "ppl/common/log.h"
 
@@ -396,9 +400,184 @@ uint32_t crc32Little(uint32_t crc_value, const uint8_t* data, size_t length) {
     return ~crc;
 }
 
+#if defined(__GNUC__)
+#define PCLMUL_FUNCTION __attribute__((target("sse4.1,pclmul")))
+#else
+#define PCLMUL_FUNCTION
+#endif
+
+static bool supportsPclmul() {
+#if defined(_MSC_VER)
+    int cpu_info[4];
+    __cpuid(cpu_info, 1);
+    return (cpu_info[2] & 0x2) != 0;
+#else
+    return __builtin_cpu_supports("pclmul");
+#endif
+}
+
+/* Folds 64 bytes a time with carry-less multiplications, then reduces the
+ * 128 bits to the crc with the Barrett reduction, see "Fast CRC Computation
+ * for Generic Polynomials Using PCLMULQDQ Instruction" by Intel. The constants
+ * are for the bit-reflected polynomial 0xEDB88320. The length is 64 at least,
+ * only the multiple of 16 bytes are processed.
+ */
+PCLMUL_FUNCTION static
+uint32_t crc32Pclmul(uint32_t crc_value, const uint8_t* data, size_t length) {
+    const __m128i k1k2 = _mm_set_epi64x(0x01c6e41596, 0x0154442bd4);
+    const __m128i k3k4 = _mm_set_epi64x(0x00ccaa009e, 0x01751997d0);
+    const __m128i k5k0 = _mm_set_epi64x(0x0000000000, 0x0163cd6124);
+    const __m128i poly = _mm_set_epi64x(0x01f7011641, 0x01db710641);
+    const __m128i mask = _mm_setr_epi32(~0, 0, ~0, 0);
+    __m128i x0, x1, x2, x3, x4, x5, x6, x7, x8;
+
+    x1 = _mm_loadu_si128((const __m128i*)data);
+    x2 = _mm_loadu_si128((const __m128i*)(data + 16));
+    x3 = _mm_loadu_si128((const __m128i*)(data + 32));
+    x4 = _mm_loadu_si128((const __m128i*)(data + 48));
+    x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128(~crc_value));
+    data += 64;
+    length -= 64;
+
+    x0 = k1k2;
+    while (length >= 64) {
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x6 = _mm_clmulepi64_si128(x2, x0, 0x00);
+        x7 = _mm_clmulepi64_si128(x3, x0, 0x00);
+        x8 = _mm_clmulepi64_si128(x4, x0, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x2 = _mm_clmulepi64_si128(x2, x0, 0x11);
+        x3 = _mm_clmulepi64_si128(x3, x0, 0x11);
+        x4 = _mm_clmulepi64_si128(x4, x0, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x5),
+                           _mm_loadu_si128((const __m128i*)data));
+        x2 = _mm_xor_si128(_mm_xor_si128(x2, x6),
+                           _mm_loadu_si128((const __m128i*)(data + 16)));
+        x3 = _mm_xor_si128(_mm_xor_si128(x3, x7),
+                           _mm_loadu_si128((const __m128i*)(data + 32)));
+        x4 = _mm_xor_si128(_mm_xor_si128(x4, x8),
+                           _mm_loadu_si128((const __m128i*)(data + 48)));
+        data += 64;
+        length -= 64;
+    }
+
+    // folding the 4 lanes into one, then the remaining 16 bytes blocks.
+    x0 = k3k4;
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+    while (length >= 16) {
+        x2 = _mm_loadu_si128((const __m128i*)data);
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+        data += 16;
+        length -= 16;
+    }
+
+    // 128 bits to 64 bits.
+    x2 = _mm_clmulepi64_si128(x1, x0, 0x10);
+    x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+    x2 = _mm_srli_si128(x1, 4);
+    x1 = _mm_and_si128(x1, mask);
+    x1 = _mm_clmulepi64_si128(x1, k5k0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    // Barrett reduction to 32 bits.
+    x2 = _mm_and_si128(x1, mask);
+    x2 = _mm_clmulepi64_si128(x2, poly, 0x10);
+    x2 = _mm_and_si128(x2, mask);
+    x2 = _mm_clmulepi64_si128(x2, poly, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    return ~(uint32_t)_mm_extract_epi32(x1, 1);
+}
+
+static
+uint32_t crc32Fast(uint32_t crc_value, const uint8_t* data, size_t length,
+                   bool use_pclmul) {
+    if (use_pclmul && length >= 64) {
+        size_t folded_length = length & ~(size_t)15;
+        crc_value = crc32Pclmul(crc_value, data, folded_length);
+        data   += folded_length;
+        length -= folded_length;
+    }
+
+    return crc32Little(crc_value, data, length);
+}
+
+uint32_t crc32(uint32_t crc_value, const uint8_t* data, size_t length) {
+    static const bool use_pclmul = supportsPclmul();
+
+    return crc32Fast(crc_value, data, length, use_pclmul);
+}
+
+#define ADLER32_BASE 65521
+#define ADLER32_NMAX 5552  // the most bytes before the 32-bit sums overflow
+
+uint32_t adler32(uint32_t adler_value, const uint8_t* data, size_t length) {
+    uint32_t sum1 = adler_value & 0xFFFF;
+    uint32_t sum2 = adler_value >> 16;
+
+    // 32 bytes a time, sum1 by sad, sum2 by the byte weights 32..1.
+    const __m128i weights0 = _mm_setr_epi8(32, 31, 30, 29, 28, 27, 26, 25, 24,
+                                           23, 22, 21, 20, 19, 18, 17);
+    const __m128i weights1 = _mm_setr_epi8(16, 15, 14, 13, 12, 11, 10, 9, 8,
+                                           7, 6, 5, 4, 3, 2, 1);
+    const __m128i zeros = _mm_setzero_si128();
+    const __m128i ones  = _mm_set1_epi16(1);
+    size_t blocks = length >> 5;
+    length &= 31;
+    while (blocks > 0) {
+        uint32_t count = ADLER32_NMAX >> 5;
+        if (count > blocks) count = blocks;
+        blocks -= count;
+
+        __m128i prior_sums1 = _mm_cvtsi32_si128(sum1 * count);
+        __m128i sums2 = _mm_cvtsi32_si128(sum2);
+        __m128i sums1 = zeros;
+        do {
+            __m128i bytes0 = _mm_loadu_si128((const __m128i*)data);
+            __m128i bytes1 = _mm_loadu_si128((const __m128i*)(data + 16));
+            prior_sums1 = _mm_add_epi32(prior_sums1, sums1);
+            sums1 = _mm_add_epi32(sums1, _mm_sad_epu8(bytes0, zeros));
+            sums1 = _mm_add_epi32(sums1, _mm_sad_epu8(bytes1, zeros));
+            __m128i products = _mm_add_epi16(
+                _mm_maddubs_epi16(bytes0, weights0),
+                _mm_maddubs_epi16(bytes1, weights1));
+            sums2 = _mm_add_epi32(sums2, _mm_madd_epi16(products, ones));
+            data += 32;
+        } while (--count);
+
+        sums2 = _mm_add_epi32(sums2, _mm_slli_epi32(prior_sums1, 5));
+        sums1 = _mm_add_epi32(sums1, _mm_shuffle_epi32(sums1, 0x4E));
+        sums1 = _mm_add_epi32(sums1, _mm_shuffle_epi32(sums1, 0xB1));
+        sums2 = _mm_add_epi32(sums2, _mm_shuffle_epi32(sums2, 0x4E));
+        sums2 = _mm_add_epi32(sums2, _mm_shuffle_epi32(sums2, 0xB1));
+        sum1 = (sum1 + (uint32_t)_mm_cvtsi128_si32(sums1)) % ADLER32_BASE;
+        sum2 = (uint32_t)_mm_cvtsi128_si32(sums2) % ADLER32_BASE;
+    }
+
+    while (length-- != 0) {
+        sum1 += *data++;
+        sum2 += sum1;
+    }
+    sum1 %= ADLER32_BASE;
+    sum2 %= ADLER32_BASE;
+
+    return sum1 | (sum2 << 16);
+}
+
 Crc32::Crc32() : data_poiter_(nullptr), data_size_(0), crc_value_(0),
                  crc_length_(0), is_checking_(true) {
     byte_order_ = checkByteOrder();
+    use_pclmul_ = supportsPclmul();
 }
 
 Crc32::Crc32(uint8_t* data_poiter, uint32_t data_size, uint32_t crc_value,
@@ -407,6 +586,7 @@ Crc32::Crc32(uint8_t* data_poiter, uint32_t data_size, uint32_t crc_value,
              crc_value_(crc_value), crc_length_(crc_length),
              is_checking_(is_checking) {
     byte_order_ = checkByteOrder();
+    use_pclmul_ = supportsPclmul();
 }
 
 ByteOrder Crc32::checkByteOrder() {
@@ -463,11 +643,13 @@ bool Crc32::calculateCrc() {
     uint32_t crc;
     if (byte_order_ == LITTLE_ENDIAN_ORDER) {
         if (crc_length_ <= data_size_) {
-            crc = crc32Little(crc_value_, data_poiter_, crc_length_);
+            crc = crc32Fast(crc_value_, data_poiter_, crc_length_,
+                            use_pclmul_);
             crc_length_ = 0;
         }
         else {
-            crc = crc32Little(crc_value_, data_poiter_, data_size_);
+            crc = crc32Fast(crc_value_, data_poiter_, data_size_,
+                            use_pclmul_);
             crc_length_ -= data_size_;
         }
     }
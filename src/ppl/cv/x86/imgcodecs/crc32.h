@@ -18,12 +18,20 @@
 #ifndef __ST_HPC_PPL_CV_X86_IMGCODECS_CRC32_H_
 #define __ST_HPC_PPL_CV_X86_IMGCODECS_CRC32_H_
 
+#include <stddef.h>
 #include <stdint.h>
 
 namespace ppl {
 namespace cv {
 namespace x86 {
 
+// The Adler-32 checksum of a zlib stream, starting from 1.
+uint32_t adler32(uint32_t adler_value, const uint8_t* data, size_t length);
+
+// The CRC32 of png chunks, starting from 0, folded with PCLMULQDQ when the
+// cpu supports it.
+uint32_t crc32(uint32_t crc_value, const uint8_t* data, size_t length);
+
 enum ByteOrder {
   LITTLE_ENDIAN_ORDER = 0,
   BIG_ENDIAN_ORDER    = 1,
@@ -55,6 +63,7 @@ class Crc32 {
     uint32_t crc_length_;
     ByteOrder byte_order_;
     bool is_checking_;
+    bool use_pclmul_;  // folding with PCLMULQDQ on little endian cpus
 };
 
 } //! namespace x86
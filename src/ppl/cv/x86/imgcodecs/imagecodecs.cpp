@@ -43,6 +43,24 @@ uint32_t ImageDecoder::depth() const {
     return depth_;
 }
 
+bool ImageDecoder::setScale(uint32_t denominator) {
+    return denominator == 1;
+}
+
+bool ImageDecoder::setRoi(uint32_t, uint32_t, uint32_t, uint32_t) {
+    return false;
+}
+
+ImageEncoder::ImageEncoder() {
+}
+
+ImageEncoder::~ImageEncoder() {
+}
+
+bool ImageEncoder::setParameter(int32_t key, int32_t value) {
+    return true;
+}
+
 } //! namespace x86
 } //! namespace cv
 } //! namespace ppl
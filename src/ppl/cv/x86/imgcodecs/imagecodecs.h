@@ -34,6 +34,12 @@ class ImageDecoder {
     uint32_t channels() const;
     uint32_t depth() const;
     virtual bool readHeader() = 0;
+    // Decodes to 1/denominator of the size, only 1 is supported by default.
+    virtual bool setScale(uint32_t denominator);
+    // Decodes only the given rectangle of the image, which is in the image.
+    // Unsupported by default, the caller decodes the whole image then.
+    virtual bool setRoi(uint32_t top, uint32_t left, uint32_t height,
+                        uint32_t width);
     virtual bool decodeData(uint32_t stride, uint8_t* image) = 0;
 
   protected:
@@ -43,6 +49,21 @@ class ImageDecoder {
     uint32_t depth_;
 };
 
+class ImageEncoder {
+  public:
+    ImageEncoder();
+    virtual ~ImageEncoder();
+
+    // Sets a parameter of ImwriteFlags, false if the value is invalid. Keys of
+    // other formats are ignored.
+    virtual bool setParameter(int32_t key, int32_t value);
+    // Encodes the image, which has 8 or 16 bits depth and B G R / B G R A
+    // channels, stride is in bytes.
+    virtual bool encodeData(uint32_t height, uint32_t width, uint32_t channels,
+                            uint32_t depth, uint32_t stride,
+                            const uint8_t* image) = 0;
+};
+
 } //! namespace x86
 } //! namespace cv
 } //! namespace ppl
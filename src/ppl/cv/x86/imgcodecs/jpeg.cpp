@@ -19,11 +19,17 @@
 #include "codecs.h"
 
 #include <memory.h>
+#include <math.h>
 #include <immintrin.h>
-#include <thread>
 #include <vector>
 
+#include "ppl/cv/x86/imread.h"
+#include "ppl/cv/x86/imwrite.h"
+#include "ppl/cv/x86/parallel.hpp"
 #include "ppl/cv/x86/intrinutils.hpp"
+#include "ppl/cv/x86/fma/internal_fma.hpp"
+#include "ppl/common/x86/sysinfo.h"
+#include "ppl/cv/x86/isa.hpp"
 #include "ppl/common/log.h"
 
 using namespace ppl::common;
@@ -140,15 +146,15 @@ static uint8_t* resampleRowH2(uint8_t *out, uint8_t *in_near, uint8_t *in_far,
         out[i * 2 + 0] = DIVIDE4(n + input[i - 1]);
         out[i * 2 + 1] = DIVIDE4(n + input[i + 1]);
     }
-    out[i * 2 + 0] = DIVIDE4(input[width - 2] * 3 + input[width - 1] + 2);
+    out[i * 2 + 0] = DIVIDE4(input[width - 2] + input[width - 1] * 3 + 2);
     out[i * 2 + 1] = input[width - 1];
 
     return out;
 }
 
 // generate 2x2 samples for every one in input.
-static uint8_t* resampleRowHV2(uint8_t *out, uint8_t *in_near, uint8_t *in_far,
-                               uint32_t width, uint32_t hs) {
+uint8_t* resampleRowHV2(uint8_t *out, uint8_t *in_near, uint8_t *in_far,
+                        uint32_t width, uint32_t hs) {
     uint32_t i, t0, t1;
     if (width == 1) {
         out[0] = out[1] = DIVIDE4(3 * in_near[0] + in_far[0] + 2);
@@ -168,7 +174,7 @@ static uint8_t* resampleRowHV2(uint8_t *out, uint8_t *in_near, uint8_t *in_far,
     uint8_t* src0 = in_near;
     uint8_t* src1 = in_far;
     uint8_t* dst = out + 1;
-    for (i = 0; i <= width - 16; i += 15) {
+    for (i = 0; i + 16 <= width; i += 15) {
         value_near = _mm_loadu_si128((__m128i const*)src0);
         value_far  = _mm_loadu_si128((__m128i const*)src1);
 
@@ -232,6 +238,7 @@ static uint8_t* resampleRowHV2(uint8_t *out, uint8_t *in_near, uint8_t *in_far,
         dst += 14;
     }
 
+    i = i > 0 ? i : 1;  // narrower than 16 samples, out[0] is done.
     t1 = 3 * in_near[i - 1] + in_far[i - 1];
     for (; i < width; ++i) {
         t0 = t1;
@@ -276,7 +283,7 @@ static void RGB2YSSE(uint8_t* input0, uint8_t* input1, uint8_t* input2,
     __m128i packed29  = _mm_set_epi16(29, 29, 29, 29, 29, 29, 29, 29);
 
     uint32_t index = 0;
-    for (; index <= width - 32; index += 32) {
+    for (; index + 32 <= width; index += 32) {
         rs = _mm_loadu_si128((__m128i const*)input0);
         gs = _mm_loadu_si128((__m128i const*)input1);
         bs = _mm_loadu_si128((__m128i const*)input2);
@@ -320,8 +327,8 @@ static void RGB2YSSE(uint8_t* input0, uint8_t* input1, uint8_t* input2,
 /* This is a reduced-precision calculation of YCbCr-to-BGR introduced
  * to make sure the code produces the same results in both SIMD and scalar.
  */
-YCrCb2BGR::YCrCb2BGR(uint32_t width, uint32_t channels) : width_(width),
-                     channels_(channels) {
+YCrCb2BGR::YCrCb2BGR(uint32_t width, uint32_t channels, bool use_fma) :
+                     width_(width), channels_(channels), use_fma_(use_fma) {
     sign_flip_ = _mm_set1_epi8(-0x80);
     cr_const0_ = _mm_set1_epi16( (int16_t)(1.40200f * 4096.0f + 0.5f));
     cr_const1_ = _mm_set1_epi16(-(int16_t)(0.71414f * 4096.0f + 0.5f));
@@ -369,7 +376,11 @@ void YCrCb2BGR::process8Elements(uint8_t const *y, uint8_t const *pcb,
 void YCrCb2BGR::convertBGR(uint8_t const *y, uint8_t const *pcb,
                            uint8_t const *pcr, uint8_t *dst) {
     uint32_t i = 0;
-    for (; i <= width_ - 32; i += 32, dst += channels_ * 32) {
+    if (use_fma_ && channels_ == 3) {
+        i = fma::jpeg_ycrcb_2_bgr_u8_fma(width_, y, pcb, pcr, dst);
+        dst += i * 3;
+    }
+    for (; i + 32 <= width_; i += 32, dst += channels_ * 32) {
         process8Elements(y, pcb, pcr, i, b16s0_, g16s0_, r16s0_);
         process8Elements(y, pcb, pcr, i + 8, b16s1_, g16s1_, r16s1_);
         __m128i b8s0 = _mm_packus_epi16(b16s0_, b16s1_);
@@ -416,18 +427,21 @@ void YCrCb2BGR::convertBGR(uint8_t const *y, uint8_t const *pcb,
 JpegDecoder::JpegDecoder(BytesReader& file_data) {
     file_data_ = &file_data;
 
-    jpeg_ = (JpegDecodeData*) malloc(sizeof(JpegDecodeData));
+    jpeg_ = (JpegDecodeData*) calloc(1, sizeof(JpegDecodeData));
     if (jpeg_ == nullptr) {
        LOG(ERROR) << "No enough memory to initialize JpegDecoder.";
     }
     jpeg_->marker = NULL_MARKER;
 
-    hardware_threads_ = std::thread::hardware_concurrency();
-    hardware_threads_ = hardware_threads_ == 0 ? 1 : hardware_threads_;
-    hardware_threads_ = hardware_threads_ > 4 ? 4 : hardware_threads_;
+    num_threads_ = GetImdecodeNumThreads();
+    use_fma_ = isa_supported(ISA_X86_FMA);
+    scale_ = 1;
+    roi_   = false;
 }
 
 JpegDecoder::~JpegDecoder() {
+   // the component buffers are left over when only the header is read.
+   freeComponents(jpeg_, 4);
    free(jpeg_);
 }
 
@@ -509,6 +523,7 @@ bool JpegDecoder::parseSOF(JpegDecodeData *jpeg) {
 
     jpeg->components = file_data_->getByte();  // Gray(1), YCbCr/YIQ(3), CMYK(4)
     channels_ = jpeg->components >= 3 ? 3 : 1;
+    depth_ = 8;
     if (jpeg->components != 1 && jpeg->components != 3 &&
         jpeg->components != 4) {
         LOG(ERROR) << "Invalid component count: " << jpeg->components
@@ -599,8 +614,104 @@ bool JpegDecoder::parseSOF(JpegDecodeData *jpeg) {
             (height_ * jpeg->img_comp[i].vsampling + v_max - 1) / v_max;
         jpeg->img_comp[i].w2 = jpeg->mcus_x * jpeg->img_comp[i].hsampling * 8;
         jpeg->img_comp[i].h2 = jpeg->mcus_y * jpeg->img_comp[i].vsampling * 8;
+    }
+
+    return true;
+}
+
+/* In a decoding scaled by 1/n, a block is transformed into (8/n)x(8/n)
+ * pixels. A subsampled component is transformed into up to 8x8 pixels
+ * instead, which saves its upsampling, e.g. the chroma of a 4:2:0 image
+ * decoded at 1/2 comes out of 8x8 idcts at the resolution of the luma.
+ */
+static void setBlockSize(uint32_t block_size, uint32_t ratio,
+                         uint32_t *output_size, uint32_t *upsampling) {
+    uint32_t size = block_size * ratio;
+    if (size <= 8) {
+        *output_size = size;
+        *upsampling  = 1;
+    }
+    else if (size % 8 == 0) {
+        *output_size = 8;
+        *upsampling  = size / 8;
+    }
+    else {
+        *output_size = block_size;
+        *upsampling  = ratio;
+    }
+}
+
+/* Sets the window of mcus to be decoded. In region-of-interest decoding, it
+ * covers the region and an mcu around it, so that the chroma in the region is
+ * upsampled from the same neighbours as in the whole image.
+ */
+bool JpegDecoder::setWindow(JpegDecodeData *jpeg) {
+    if (jpeg->mcu_width < scale_ || jpeg->mcu_height < scale_) {
+        LOG(ERROR) << "No valid frame header is detected.";
+        return false;
+    }
+
+    if (!roi_) {
+        image_height_ = height_;
+        image_width_  = width_;
+        roi_top_  = 0;
+        roi_left_ = 0;
+    }
+
+    uint32_t mcu_width  = jpeg->mcu_width / scale_;
+    uint32_t mcu_height = jpeg->mcu_height / scale_;
+    jpeg->mcu_x0 = roi_left_ / mcu_width;
+    jpeg->mcu_y0 = roi_top_ / mcu_height;
+    jpeg->mcu_x1 = (roi_left_ + width_ + mcu_width - 1) / mcu_width;
+    jpeg->mcu_y1 = (roi_top_ + height_ + mcu_height - 1) / mcu_height;
+    if (roi_) {
+        jpeg->mcu_x0 = jpeg->mcu_x0 > 0 ? jpeg->mcu_x0 - 1 : 0;
+        jpeg->mcu_y0 = jpeg->mcu_y0 > 0 ? jpeg->mcu_y0 - 1 : 0;
+        jpeg->mcu_x1 = jpeg->mcu_x1 < jpeg->mcus_x ? jpeg->mcu_x1 + 1 :
+                       jpeg->mcus_x;
+        jpeg->mcu_y1 = jpeg->mcu_y1 < jpeg->mcus_y ? jpeg->mcu_y1 + 1 :
+                       jpeg->mcus_y;
+    }
+
+    uint32_t right  = jpeg->mcu_x1 * mcu_width;
+    uint32_t bottom = jpeg->mcu_y1 * mcu_height;
+    right  = right < image_width_ ? right : image_width_;
+    bottom = bottom < image_height_ ? bottom : image_height_;
+    window_width_  = right - jpeg->mcu_x0 * mcu_width;
+    window_height_ = bottom - jpeg->mcu_y0 * mcu_height;
+    offset_x_ = roi_left_ - jpeg->mcu_x0 * mcu_width;
+    offset_y_ = roi_top_ - jpeg->mcu_y0 * mcu_height;
+
+    return true;
+}
+
+/* The component buffers are allocated when decoding starts, so that reading
+ * the header alone stays cheap.
+ */
+bool JpegDecoder::allocateComponents(JpegDecodeData *jpeg) {
+    if (!setWindow(jpeg)) {
+        return false;
+    }
+
+    uint32_t block_size = 8 / scale_;
+    for (uint32_t i = 0; i < jpeg->components; ++i) {
+        setBlockSize(block_size,
+                     jpeg->hsampling_max / jpeg->img_comp[i].hsampling,
+                     &jpeg->img_comp[i].block_w, &jpeg->img_comp[i].up_h);
+        setBlockSize(block_size,
+                     jpeg->vsampling_max / jpeg->img_comp[i].vsampling,
+                     &jpeg->img_comp[i].block_h, &jpeg->img_comp[i].up_v);
+        jpeg->img_comp[i].out_w = (jpeg->mcu_x1 - jpeg->mcu_x0) *
+                                  jpeg->img_comp[i].hsampling *
+                                  jpeg->img_comp[i].block_w;
+        jpeg->img_comp[i].out_h = (jpeg->mcu_y1 - jpeg->mcu_y0) *
+                                  jpeg->img_comp[i].vsampling *
+                                  jpeg->img_comp[i].block_h;
+        jpeg->img_comp[i].out_y = (window_height_ + jpeg->img_comp[i].up_v -
+                                   1) / jpeg->img_comp[i].up_v;
         jpeg->img_comp[i].data =
-            (uint8_t*)malloc(jpeg->img_comp[i].w2 * jpeg->img_comp[i].h2 + 15);
+            (uint8_t*)malloc(jpeg->img_comp[i].out_w * jpeg->img_comp[i].out_h +
+                             15);
         if (jpeg->img_comp[i].data == nullptr) {
             freeComponents(jpeg, i + 1);
             LOG(ERROR) << "failed to allocate data buffer for component "
@@ -739,6 +850,10 @@ bool JpegDecoder::buildHuffmanTable(HuffmanLookupTable *huffman_table,
     uint32_t bit_number, i, index = 0;
     // build code length list for each symbol(from JPEG spec).
     for (bit_number = 1; bit_number <= MAX_BITS; ++bit_number) {
+        if (symbol_counts[bit_number - 1] > 256 - index) {
+            LOG(ERROR) << "Too many symbols in the huffman table.";
+            return false;
+        }
         for (i = 0; i < symbol_counts[bit_number - 1]; ++i) {
             bit_lengths[index++] = (uint8_t)bit_number;
         }
@@ -812,9 +927,20 @@ bool JpegDecoder::parseDHT(JpegDecodeData *jpeg) {
 
         uint32_t symbol_counts[16], count = 0;
         for (uint32_t i = 0; i < 16; ++i) {
-            symbol_counts[i] = file_data_->getByte();
+            int32_t symbol_count = file_data_->getByte();
+            if (symbol_count < 0) {
+                LOG(ERROR) << "The DHT segment is truncated.";
+                return false;
+            }
+            symbol_counts[i] = symbol_count;
             count += symbol_counts[i];
         }
+        if (count > 256 || 17 + count > length) {
+            LOG(ERROR) << "Invalid DHT symbol count: " << count
+                       << ", valid value should be not more than 256 and "
+                       << "fit in the segment.";
+            return false;
+        }
 
         uint8_t *symbol;
         if (type == 0) {
@@ -878,7 +1004,7 @@ bool JpegDecoder::parseDNL() {
     }
 
     uint32_t height = file_data_->getWordBigEndian();
-    if (height != height_) {
+    if ((height + scale_ - 1) / scale_ != height_) {
         LOG(ERROR) << "Invalid DNL height: " << height
                    << ", valid value should be " << height_;
         return false;
@@ -889,15 +1015,17 @@ bool JpegDecoder::parseDNL() {
 
 bool JpegDecoder::processOtherSegments(int32_t marker) {
     uint32_t length = file_data_->getWordBigEndian();
+    if (length > 0xFFFF) {  // getByte() returned the end of the data.
+        LOG(ERROR) << "Unexpected end of the jpeg data.";
+        return false;
+    }
     if (length < 2) {
         LOG(ERROR) << "Invalid segment length: " << length
                    << ", valid value should be not less than 2.";
         return false;
     }
 
-    file_data_->skipBytes(length - 2);
-
-    return true;
+    return file_data_->skipBytes(length - 2);
 }
 
 bool JpegDecoder::processSegments(JpegDecodeData *jpeg, uint8_t marker) {
@@ -1003,15 +1131,31 @@ static bool global_prefix = false;
 static __m128i swap_index = _mm_set_epi8(15, 14, 13, 12, 11, 10, 9, 8,
                                          0, 1, 2, 3, 4, 5, 6, 7);
 
+// Loads the next 8 bytes in big-endian order. Near the end of the data the
+// missing bytes read as 0, the input may be a caller's buffer which ends
+// right there.
+inline uint64_t loadBitBuffer(BytesReader* file_data) {
+    uint8_t* current_data = file_data->getCurrentPosition();
+    __m128i value0;
+    if (file_data->getValidSize() >= 16) {
+        value0 = _mm_lddqu_si128((__m128i const*)current_data);
+    }
+    else {
+        uint8_t tail[16] = {0};
+        memcpy(tail, current_data, file_data->getValidSize());
+        value0 = _mm_loadu_si128((__m128i const*)tail);
+    }
+    __m128i value1 = _mm_shuffle_epi8(value0, swap_index);
+
+    return _mm_extract_epi64(value1, 0);
+}
+
 inline void growBitBuffer(BytesReader* file_data, JpegDecodeData *jpeg) {
     uint64_t buffer;
     uint32_t valid_bytes = 0, invalid_bytes = 0;
     bool prefix_ff = global_prefix;
 
-    uint8_t* current_data = file_data->getCurrentPosition();
-    __m128i value0 = _mm_lddqu_si128((__m128i const*)current_data);
-    __m128i value1 = _mm_shuffle_epi8(value0, swap_index);
-    buffer = _mm_extract_epi64(value1, 0);
+    buffer = loadBitBuffer(file_data);
 
     if ((!prefix_ff) && (buffer & 0xFF00000000000000) != 0xFF00000000000000 &&
                         (buffer & 0xFF000000000000) != 0xFF000000000000 &&
@@ -1301,10 +1445,7 @@ inline void growBitBuffer(BytesReader* file_data, JpegDecodeData *jpeg) {
 
             if (processed_bytes == BUFFER_BYTES && index == 0) {
                 file_data->skipBytes(BUFFER_BYTES);
-                uint8_t* current_data = file_data->getCurrentPosition();
-                __m128i value0 = _mm_lddqu_si128((__m128i const*)current_data);
-                __m128i value1 = _mm_shuffle_epi8(value0, swap_index);
-                buffer = _mm_extract_epi64(value1, 0);
+                buffer = loadBitBuffer(file_data);
 
                 processed_bytes = 0;
             }
@@ -1395,12 +1536,13 @@ inline int32_t JpegDecoder::decodeHuffmanData(JpegDecodeData *jpeg,
     }
 
     bits = jpeg->code_buffer >> (BUFFER_BITS - MAX_BITS);
-    for (bit_length = LOOKAHEAD_BITS + 1; ; ++bit_length) {
+    for (bit_length = LOOKAHEAD_BITS + 1; bit_length <= MAX_BITS;
+         ++bit_length) {
         if (bits < huffman_table->max_codes[bit_length]) {
             break;
         }
     }
-    if (bit_length >= 17) {  // error! code not found.
+    if (bit_length > MAX_BITS) {  // error! code not found.
         jpeg->code_bits -= 16;
         return -1;
     }
@@ -1424,6 +1566,7 @@ bool JpegDecoder::decodeBlock(JpegDecodeData *jpeg, int16_t decoded_data[64],
     if (bit_length < 0 || bit_length > 15) {
         LOG(ERROR) << "Invalid bit length of DC value from huffman decoding: "
                    << bit_length << ", valid value: 0-15.";
+        return false;
     }
 
     int32_t value = bit_length ?
@@ -1437,11 +1580,16 @@ bool JpegDecoder::decodeBlock(JpegDecodeData *jpeg, int16_t decoded_data[64],
     do {
         // combined_value: number of zero + bit length of incoming code of the
         // jpeg fixed encoding table.
-        combined_value = decodeHuffmanData(jpeg, huffman_ac);
+        int32_t symbol = decodeHuffmanData(jpeg, huffman_ac);
+        if (symbol < 0) {
+            LOG(ERROR) << "Invalid huffman code of AC value.";
+            return false;
+        }
+        combined_value = symbol;
         zeroes = combined_value >> 4;
         bit_length = combined_value & 15;
         if (bit_length == 0) {
-            if (zeroes != 0xF0) {
+            if (zeroes != 15) {  // 0xF0 is a run of 16 zeroes
                 break;  // end of block
             }
             ac_index += 16;
@@ -1457,11 +1605,11 @@ bool JpegDecoder::decodeBlock(JpegDecodeData *jpeg, int16_t decoded_data[64],
     return true;
 }
 
-void JpegDecoder::idctDecodeBlock(uint8_t *output, int32_t out_stride,
-                                  int16_t data[64]) {
+static void idct8x8(const int16_t data[64], int32_t out_stride,
+                    uint8_t *output) {
     int32_t i, val[64], *v = val;
     uint8_t *o;
-    int16_t *d = data;
+    const int16_t *d = data;
     int32_t scaled = 65536 + (128 << 17);
 
     // columns
@@ -1518,17 +1666,137 @@ void JpegDecoder::idctDecodeBlock(uint8_t *output, int32_t out_stride,
     }
 }
 
+void idctBlock8x8(const int16_t data[64], const uint16_t *dequant_table,
+                  int32_t out_stride, uint8_t *output, bool use_fma) {
+    if (use_fma) {
+        fma::jpeg_idct_8x8_u8_fma(data, dequant_table, out_stride, output);
+        return;
+    }
+    if (dequant_table == nullptr) {
+        idct8x8(data, out_stride, output);
+        return;
+    }
+
+    int16_t dequantized[64];
+    for (int32_t i = 0; i < 64; i += 8) {
+        __m128i input  = _mm_loadu_si128((__m128i const*)(data + i));
+        __m128i coeffs = _mm_loadu_si128((__m128i const*)(dequant_table + i));
+        _mm_storeu_si128((__m128i*)(dequantized + i),
+                         _mm_mullo_epi16(input, coeffs));
+    }
+    idct8x8(dequantized, out_stride, output);
+}
+
+/* Coefficients of the reduced idcts, in which n output samples are computed
+ * from the n lowest frequencies. They are the 8-point idct basis averaged over
+ * the 8/n samples each output covers, so a scaled decoding approximates the
+ * box filtered full decoding, scaled up by 1<<12.
+ */
+struct ReducedIdctTables {
+    int32_t idct4[4][4];
+    int32_t idct2[2][2];
+
+    ReducedIdctTables() {
+        computeTable(&idct4[0][0], 4);
+        computeTable(&idct2[0][0], 2);
+    }
+
+    static void computeTable(int32_t *table, int32_t size) {
+        const double pi = 3.14159265358979323846;
+        int32_t step = 8 / size;
+        for (int32_t n = 0; n < size; ++n) {
+            for (int32_t u = 0; u < size; ++u) {
+                double value = u == 0 ? 0.353553390593273762 :
+                               0.5 * cos((2 * n + 1) * u * pi / (2 * size)) *
+                               sin(step * u * pi / 16) /
+                               (step * sin(u * pi / 16));
+                table[n * size + u] = (int32_t)lround(value * 4096);
+            }
+        }
+    }
+};
+
+static const ReducedIdctTables reduced_idct_tables;
+
+void JpegDecoder::idctDecodeBlock(uint8_t *output, int32_t out_stride,
+                                  int16_t data[64], uint32_t block_w,
+                                  uint32_t block_h) {
+    if (block_w == 8 && block_h == 8) {
+        idctBlock8x8(data, nullptr, out_stride, output, use_fma_);
+        return;
+    }
+    if (block_w == 1 && block_h == 1) {
+        // the block mean, rounded and shifted by 128.
+        output[0] = clampInt8((data[0] + 4 + (128 << 3)) >> 3);
+        return;
+    }
+
+    const int32_t *idct_w = block_w == 8 ? nullptr :
+        (block_w == 4 ? &reduced_idct_tables.idct4[0][0] :
+         &reduced_idct_tables.idct2[0][0]);
+    const int32_t *idct_h = block_h == 8 ? nullptr :
+        (block_h == 4 ? &reduced_idct_tables.idct4[0][0] :
+         &reduced_idct_tables.idct2[0][0]);
+    if (idct_w == nullptr || idct_h == nullptr || block_w == 1 ||
+        block_h == 1) {
+        // mixed 8-point or 1-point sizes, transform at full size and average.
+        uint8_t block[64];
+        idctBlock8x8(data, nullptr, 8, block, use_fma_);
+        uint32_t step_w = 8 / block_w, step_h = 8 / block_h;
+        uint32_t half = (step_w * step_h) >> 1;
+        for (uint32_t n = 0; n < block_h; ++n) {
+            for (uint32_t m = 0; m < block_w; ++m) {
+                uint32_t sum = 0;
+                for (uint32_t y = 0; y < step_h; ++y) {
+                    for (uint32_t x = 0; x < step_w; ++x) {
+                        sum += block[(n * step_h + y) * 8 + m * step_w + x];
+                    }
+                }
+                output[n * out_stride + m] = (sum + half) / (step_w * step_h);
+            }
+        }
+        return;
+    }
+
+    // columns, keeping 2 extra bits of precision.
+    int32_t val[4 * 4];
+    for (uint32_t u = 0; u < block_w; ++u) {
+        for (uint32_t n = 0; n < block_h; ++n) {
+            int32_t sum = 512;
+            for (uint32_t v = 0; v < block_h; ++v) {
+                sum += idct_h[n * block_h + v] * data[v * 8 + u];
+            }
+            val[n * 4 + u] = sum >> 10;
+        }
+    }
+
+    // rows, removing the 1<<14 scale with rounding and adding 128.
+    int32_t scaled = (1 << 13) + (128 << 14);
+    for (uint32_t n = 0; n < block_h; ++n, output += out_stride) {
+        for (uint32_t m = 0; m < block_w; ++m) {
+            int32_t sum = scaled;
+            for (uint32_t u = 0; u < block_w; ++u) {
+                sum += idct_w[m * block_w + u] * val[n * 4 + u];
+            }
+            output[m] = clampInt8(sum >> 14);
+        }
+    }
+}
+
 void JpegDecoder::idctprocess0(JpegDecodeData *jpeg, int16_t* buffer,
                                uint8_t* output, uint32_t height_begin,
                                uint32_t height_end, uint32_t width,
-                               uint32_t width2) {
+                               uint32_t comp_id) {
+    uint32_t width2  = jpeg->img_comp[comp_id].out_w;
+    uint32_t block_w = jpeg->img_comp[comp_id].block_w;
+    uint32_t block_h = jpeg->img_comp[comp_id].block_h;
     buffer += height_begin * width * 64;
     for (uint32_t i = height_begin; i < height_end; i++) {
-        uint8_t* result = output + width2 * i * 8;
+        uint8_t* result = output + width2 * i * block_h;
         for (uint32_t j = 0; j < width; j++) {
-            idctDecodeBlock(result, width2, buffer);
+            idctDecodeBlock(result, width2, buffer, block_w, block_h);
             buffer += 64;
-            result += 8;
+            result += block_w;
         }
     }
 }
@@ -1548,6 +1816,7 @@ bool JpegDecoder::decodeProgressiveDCBlock(JpegDecodeData *jpeg,
         if (bit_length < 0 || bit_length > 15) {
             LOG(ERROR) << "Invalid bit length of DC value from huffman "
                        << "decoding: " << bit_length << ", valid value: 0-15.";
+            return false;
         }
         int32_t value_diff = bit_length ?
                              extendReceive(jpeg, file_data_, bit_length) : 0;
@@ -1585,7 +1854,12 @@ bool JpegDecoder::decodeProgressiveACBlock(JpegDecodeData *jpeg,
         int32_t zig_index, value;
         ac_index = jpeg->index_start;
         do {
-            combined_value = decodeHuffmanData(jpeg, huffman_ac);
+            int32_t symbol = decodeHuffmanData(jpeg, huffman_ac);
+            if (symbol < 0) {
+                LOG(ERROR) << "Invalid huffman code of AC value.";
+                return false;
+            }
+            combined_value = symbol;
             zeroes = (combined_value >> 4) & 15;
             bit_length = combined_value & 15;
             if (bit_length == 0) {
@@ -1629,7 +1903,12 @@ bool JpegDecoder::decodeProgressiveACBlock(JpegDecodeData *jpeg,
         } else {
             ac_index = jpeg->index_start;
             do {
-                combined_value = decodeHuffmanData(jpeg, huffman_ac);
+                int32_t symbol = decodeHuffmanData(jpeg, huffman_ac);
+                if (symbol < 0) {
+                    LOG(ERROR) << "Invalid huffman code of AC value.";
+                    return false;
+                }
+                combined_value = symbol;
                 zeroes = combined_value >> 4;
                 bit_length = combined_value & 15;
                 if (bit_length == 0) {
@@ -1685,124 +1964,253 @@ bool JpegDecoder::decodeProgressiveACBlock(JpegDecodeData *jpeg,
     return true;
 }
 
+/* Skips the entropy-coded data up to the next marker without decoding it,
+ * the marker is left in jpeg->marker as growBitBuffer() does.
+ */
+void JpegDecoder::skipToMarker(JpegDecodeData *jpeg) {
+    if (jpeg->marker != NULL_MARKER) {
+        return;
+    }
+
+    bool prefix_ff = global_prefix;
+    int32_t value;
+    while ((value = file_data_->getByte()) >= 0) {
+        if (prefix_ff) {
+            if (value == 0) {
+                prefix_ff = false;
+            }
+            else if (value != 0xFF) {
+                jpeg->marker = value;
+                jpeg->nomore = 1;
+                break;
+            }
+        }
+        else if (value == 0xFF) {
+            prefix_ff = true;
+        }
+        else {
+            uint8_t* current = file_data_->getCurrentPosition();
+            uint32_t size = file_data_->getValidSize();
+            uint8_t* next = (uint8_t*)memchr(current, 0xFF, size);
+            file_data_->skipBytes(next != nullptr ? next - current : size);
+        }
+    }
+    global_prefix = false;
+}
+
+/* Skips the rest of a scan, restart markers included, once the units in the
+ * window have been decoded.
+ */
+void JpegDecoder::skipScan(JpegDecodeData *jpeg) {
+    skipToMarker(jpeg);
+    while (DRI_RESTART(jpeg->marker)) {
+        jpeg->marker = NULL_MARKER;
+        skipToMarker(jpeg);
+    }
+}
+
+/* Whether any of the units [begin, end) of a scan, which has width units in
+ * a row, is inside the window [x0, x1) x [y0, y1).
+ */
+static bool intersectWindow(uint32_t begin, uint32_t end, uint32_t width,
+                            uint32_t x0, uint32_t x1, uint32_t y0,
+                            uint32_t y1) {
+    uint32_t row0 = begin / width, row1 = (end - 1) / width;
+    uint32_t row_begin = row0 > y0 ? row0 : y0;
+    uint32_t row_end   = row1 + 1 < y1 ? row1 + 1 : y1;
+    for (uint32_t row = row_begin; row < row_end; row++) {
+        uint32_t col0 = row == row0 ? begin % width : 0;
+        uint32_t col1 = row == row1 ? (end - 1) % width + 1 : width;
+        if (col0 < x1 && col1 > x0) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/* In region-of-interest decoding, a restart interval with no unit in the
+ * window is skipped without being decoded. Called at the start of each
+ * interval, it returns the number of units skipped.
+ */
+uint32_t JpegDecoder::skipRestartInterval(JpegDecodeData *jpeg,
+                                          uint32_t index, uint32_t units,
+                                          uint32_t width, uint32_t x0,
+                                          uint32_t x1, uint32_t y0,
+                                          uint32_t y1) {
+    if (!roi_ || jpeg->restart_interval <= 0 ||
+        jpeg->todo != jpeg->restart_interval) {
+        return 0;
+    }
+
+    uint32_t end = index + jpeg->restart_interval;
+    end = end < units ? end : units;
+    if (intersectWindow(index, end, width, x0, x1, y0, y1)) {
+        return 0;
+    }
+
+    skipToMarker(jpeg);
+    if (!DRI_RESTART(jpeg->marker)) {
+        return units - index;  // corrupted data, the scan ends here.
+    }
+    resetJpegDecoder(jpeg);
+
+    return end - index;
+}
+
 bool JpegDecoder::parseEntropyCodedData(JpegDecodeData *jpeg) {
     bool succeeded;
     resetJpegDecoder(jpeg);
     if (!jpeg->progressive) {  // baseline jpeg.
         HuffmanLookupTable *huffman_dc, *huffman_ac;
         uint16_t *dequant_table;
+        int16_t skipped_data[64];
         if (jpeg->scan_n == 1) {  // 1 components, a data block in an mcu.
             uint32_t comp_id = jpeg->order[0];
             uint32_t height = (jpeg->img_comp[comp_id].y + 7) >> 3;
             uint32_t width  = (jpeg->img_comp[comp_id].x + 7) >> 3;
-            size_t size = height * width * 64;
+            // the blocks in the window.
+            uint32_t x0 = jpeg->mcu_x0 * jpeg->img_comp[comp_id].hsampling;
+            uint32_t y0 = jpeg->mcu_y0 * jpeg->img_comp[comp_id].vsampling;
+            uint32_t x1 = jpeg->mcu_x1 * jpeg->img_comp[comp_id].hsampling;
+            uint32_t y1 = jpeg->mcu_y1 * jpeg->img_comp[comp_id].vsampling;
+            x1 = x1 < width ? x1 : width;
+            y1 = y1 < height ? y1 : height;
+            uint32_t window_width = x1 - x0;
+            size_t size = (y1 - y0) * window_width * 64;
             int16_t* buffer = new int16_t[size];
             memset(buffer, 0, size * sizeof(int16_t));
-            int16_t* data = buffer;
             huffman_dc = jpeg->huff_dc + jpeg->img_comp[comp_id].dc_id;
             huffman_ac = jpeg->huff_ac + jpeg->img_comp[comp_id].ac_id;
             dequant_table = jpeg->dequant[jpeg->img_comp[comp_id].quant_id];
-            for (uint32_t i = 0; i < height; ++i) {
-                for (uint32_t j = 0; j < width; ++j) {
-                    succeeded = decodeBlock(jpeg, data, huffman_dc, huffman_ac,
-                                            comp_id, dequant_table);
-                    if (!succeeded) return false;
-                    data += 64;
+            uint32_t units = height * width;
+            uint32_t last = (y1 - 1) * width + x1;
+            for (uint32_t index = 0; index < last; ) {
+                uint32_t skipped = skipRestartInterval(jpeg, index, units,
+                                                       width, x0, x1, y0, y1);
+                if (skipped > 0) {
+                    index += skipped;
+                    continue;
+                }
 
-                    // every data block is an MCU, so countdown the restart
-                    // interval.
-                    if (--jpeg->todo <= 0) {
-                        if (!DRI_RESTART(jpeg->marker)) return false;
-                        resetJpegDecoder(jpeg);
-                    }
+                uint32_t i = index / width, j = index % width;
+                int16_t* data = skipped_data;
+                if (i >= y0 && j >= x0 && j < x1) {
+                    data = buffer + ((i - y0) * window_width + j - x0) * 64;
+                }
+                succeeded = decodeBlock(jpeg, data, huffman_dc, huffman_ac,
+                                        comp_id, dequant_table);
+                if (!succeeded) {
+                    delete [] buffer;
+                    return false;
+                }
+                index++;
+
+                // every data block is an MCU, so countdown the restart
+                // interval.
+                if (--jpeg->todo <= 0) {
+                    skipToMarker(jpeg);
+                    if (!DRI_RESTART(jpeg->marker)) break;  // end of scan
+                    resetJpegDecoder(jpeg);
                 }
             }
-
-            uint8_t* output = jpeg->img_comp[comp_id].data;
-            uint32_t width2 = jpeg->img_comp[comp_id].w2;
-            std::vector<std::thread> threads;
-            uint32_t interval = (height + hardware_threads_ - 1) /
-                                hardware_threads_;
-            for (uint32_t heigh_begin = 0; heigh_begin < height;
-                 heigh_begin += interval) {
-                uint32_t heigh_end = heigh_begin + interval < height ?
-                                     heigh_begin + interval : height;
-                threads.push_back(std::thread(&JpegDecoder::idctprocess0, this,
-                                  jpeg, buffer, output, heigh_begin, heigh_end,
-                                  width, width2));
+            if (last < units) {
+                skipScan(jpeg);
             }
 
-            for (auto &worker: threads) {
-                worker.join();
-            }
+            uint8_t* output = jpeg->img_comp[comp_id].data;
+            height = y1 - y0;
+            parallel_for_rows(height, window_width * 64,
+                [&](int32_t begin, int32_t end) {
+                    idctprocess0(jpeg, buffer, output, begin, end,
+                                 window_width, comp_id);
+                }, 1, num_threads_);
             delete [] buffer;
 
             return true;
         } else {  // n components, interleaved data blocks in an mcu.
             uint32_t i, j, k, x, y;
+            uint32_t x0 = jpeg->mcu_x0, x1 = jpeg->mcu_x1;
+            uint32_t y0 = jpeg->mcu_y0, y1 = jpeg->mcu_y1;
             int16_t** buffer = new int16_t*[jpeg->scan_n];
             for (i = 0; i < jpeg->scan_n; i++) {
-                size_t size = jpeg->img_comp[i].h2 * jpeg->img_comp[i].w2;
+                uint32_t comp_id = jpeg->order[i];
+                size_t size = (y1 - y0) * jpeg->img_comp[comp_id].vsampling *
+                              (x1 - x0) * jpeg->img_comp[comp_id].hsampling *
+                              64;
                 buffer[i] = new int16_t[size];
                 memset(buffer[i], 0, size * sizeof(int16_t));
             }
 
             int16_t* data_ptr;
-            for (i = 0; i < jpeg->mcus_y; ++i) {
-                for (j = 0; j < jpeg->mcus_x; ++j) {
-                    // process scan_n components in order
-                    for (k = 0; k < jpeg->scan_n; ++k) {
-                        uint32_t comp_id = jpeg->order[k];
-                        huffman_dc = jpeg->huff_dc +
-                                     jpeg->img_comp[comp_id].dc_id;
-                        huffman_ac = jpeg->huff_ac +
-                                     jpeg->img_comp[comp_id].ac_id;
-                        dequant_table =
-                                jpeg->dequant[jpeg->img_comp[comp_id].quant_id];
-                        int32_t mcu_width = jpeg->mcus_x *
-                                            jpeg->img_comp[comp_id].hsampling;
-                        int32_t y2 = i * jpeg->img_comp[comp_id].vsampling;
-                        int32_t x2 = j * jpeg->img_comp[comp_id].hsampling;
-                        for (y = 0; y < jpeg->img_comp[comp_id].vsampling; ++y) {
-                            for (x = 0; x < jpeg->img_comp[comp_id].hsampling; ++x) {
-                                data_ptr = buffer[k] + ((y2 + y) * mcu_width + x2 + x) * 64;
-                                succeeded = decodeBlock(jpeg, data_ptr, huffman_dc,
-                                            huffman_ac, comp_id, dequant_table);
-                                if (!succeeded) return false;
+            uint32_t units = jpeg->mcus_y * jpeg->mcus_x;
+            uint32_t last = (y1 - 1) * jpeg->mcus_x + x1;
+            for (uint32_t index = 0; index < last; ) {
+                uint32_t skipped = skipRestartInterval(jpeg, index, units,
+                                                       jpeg->mcus_x, x0, x1,
+                                                       y0, y1);
+                if (skipped > 0) {
+                    index += skipped;
+                    continue;
+                }
+
+                i = index / jpeg->mcus_x;
+                j = index % jpeg->mcus_x;
+                bool in_window = i >= y0 && j >= x0 && j < x1;
+                // process scan_n components in order
+                for (k = 0; k < jpeg->scan_n; ++k) {
+                    uint32_t comp_id = jpeg->order[k];
+                    huffman_dc = jpeg->huff_dc +
+                                 jpeg->img_comp[comp_id].dc_id;
+                    huffman_ac = jpeg->huff_ac +
+                                 jpeg->img_comp[comp_id].ac_id;
+                    dequant_table =
+                            jpeg->dequant[jpeg->img_comp[comp_id].quant_id];
+                    int32_t mcu_width = (x1 - x0) *
+                                        jpeg->img_comp[comp_id].hsampling;
+                    int32_t y2 = (i - y0) * jpeg->img_comp[comp_id].vsampling;
+                    int32_t x2 = (j - x0) * jpeg->img_comp[comp_id].hsampling;
+                    for (y = 0; y < jpeg->img_comp[comp_id].vsampling; ++y) {
+                        for (x = 0; x < jpeg->img_comp[comp_id].hsampling; ++x) {
+                            data_ptr = in_window ? buffer[k] +
+                                       ((y2 + y) * mcu_width + x2 + x) * 64 :
+                                       skipped_data;
+                            succeeded = decodeBlock(jpeg, data_ptr, huffman_dc,
+                                        huffman_ac, comp_id, dequant_table);
+                            if (!succeeded) {
+                                for (k = 0; k < jpeg->scan_n; k++) {
+                                    delete [] buffer[k];
+                                }
+                                delete [] buffer;
+                                return false;
                             }
                         }
                     }
-
-                    // after all interleaved components, that's an interleaved MCU,
-                    // so now count down the restart interval
-                    if (--jpeg->todo <= 0) {
-                        if (!DRI_RESTART(jpeg->marker)) return false;
-                        resetJpegDecoder(jpeg);
-                    }
                 }
+                index++;
+
+                // after all interleaved components, that's an interleaved MCU,
+                // so now count down the restart interval
+                if (--jpeg->todo <= 0) {
+                    skipToMarker(jpeg);
+                    if (!DRI_RESTART(jpeg->marker)) break;  // end of scan
+                    resetJpegDecoder(jpeg);
+                }
+            }
+            if (last < units) {
+                skipScan(jpeg);
             }
 
             for (i = 0; i < jpeg->scan_n; i++) {
                 uint32_t comp_id = jpeg->order[i];
-                uint32_t height = jpeg->mcus_y * jpeg->img_comp[comp_id].vsampling;
-                uint32_t width  = jpeg->mcus_x * jpeg->img_comp[comp_id].hsampling;
+                uint32_t height = (y1 - y0) * jpeg->img_comp[comp_id].vsampling;
+                uint32_t width  = (x1 - x0) * jpeg->img_comp[comp_id].hsampling;
                 uint8_t* output = jpeg->img_comp[comp_id].data;
-                uint32_t width2 = jpeg->img_comp[comp_id].w2;
-                std::vector<std::thread> threads;
-                uint32_t interval = (height + hardware_threads_ - 1) /
-                                     hardware_threads_;
-                for (uint32_t heigh_begin = 0; heigh_begin < height;
-                     heigh_begin += interval) {
-                    uint32_t heigh_end = heigh_begin + interval < height ?
-                                         heigh_begin + interval : height;
-                    threads.push_back(std::thread(&JpegDecoder::idctprocess0,
-                                      this, jpeg, buffer[i], output,
-                                      heigh_begin, heigh_end, width, width2));
-                }
-
-                for (auto &worker: threads) {
-                    worker.join();
-                }
+                parallel_for_rows(height, width * 64,
+                    [&](int32_t begin, int32_t end) {
+                        idctprocess0(jpeg, buffer[i], output, begin, end,
+                                     width, comp_id);
+                    }, 1, num_threads_);
             }
 
             for (i = 0; i < jpeg->scan_n; i++) {
@@ -1820,6 +2228,12 @@ bool JpegDecoder::parseEntropyCodedData(JpegDecodeData *jpeg) {
             // this component has, independent of interleaved MCU blocking.
             uint32_t height = (jpeg->img_comp[comp_id].y + 7) >> 3;
             uint32_t width  = (jpeg->img_comp[comp_id].x + 7) >> 3;
+            uint32_t x0 = jpeg->mcu_x0 * jpeg->img_comp[comp_id].hsampling;
+            uint32_t y0 = jpeg->mcu_y0 * jpeg->img_comp[comp_id].vsampling;
+            uint32_t x1 = jpeg->mcu_x1 * jpeg->img_comp[comp_id].hsampling;
+            uint32_t y1 = jpeg->mcu_y1 * jpeg->img_comp[comp_id].vsampling;
+            x1 = x1 < width ? x1 : width;
+            y1 = y1 < height ? y1 : height;
             HuffmanLookupTable *huffman_dc = nullptr;
             uint32_t ac_id = 0;
             if (jpeg->index_start == 0) {
@@ -1827,59 +2241,88 @@ bool JpegDecoder::parseEntropyCodedData(JpegDecodeData *jpeg) {
             } else {
                 ac_id = jpeg->img_comp[comp_id].ac_id;
             }
-            for (uint32_t i = 0; i < height; ++i) {
-                int16_t *data = jpeg->img_comp[comp_id].coeff +
-                                jpeg->img_comp[comp_id].coeff_w * i * 64;
-                for (uint32_t j = 0; j < width; ++j) {
-                    if (jpeg->index_start == 0) {
-                        succeeded = decodeProgressiveDCBlock(jpeg, data,
-                                        huffman_dc, comp_id, succ_value);
-                        if (!succeeded) return false;
-                    } else {
-                        succeeded = decodeProgressiveACBlock(jpeg, data,
-                                        &jpeg->huff_ac[ac_id]);
-                        if (!succeeded) return false;
-                    }
-                    data += 64;
+            // the blocks out of the window are decoded in the intervals with
+            // blocks in it, as refining scans depend on their coefficients.
+            uint32_t units = height * width;
+            uint32_t last = (y1 - 1) * width + x1;
+            for (uint32_t index = 0; index < last; ) {
+                uint32_t skipped = skipRestartInterval(jpeg, index, units,
+                                                       width, x0, x1, y0, y1);
+                if (skipped > 0) {
+                    index += skipped;
+                    continue;
+                }
 
-                    // every data block is an MCU, so countdown the restart
-                    // interval.
-                    if (--jpeg->todo <= 0) {
-                        if (!DRI_RESTART(jpeg->marker)) return true;
-                        resetJpegDecoder(jpeg);
-                    }
+                uint32_t i = index / width, j = index % width;
+                int16_t *data = jpeg->img_comp[comp_id].coeff +
+                                (jpeg->img_comp[comp_id].coeff_w * i + j) * 64;
+                if (jpeg->index_start == 0) {
+                    succeeded = decodeProgressiveDCBlock(jpeg, data,
+                                    huffman_dc, comp_id, succ_value);
+                    if (!succeeded) return false;
+                } else {
+                    succeeded = decodeProgressiveACBlock(jpeg, data,
+                                    &jpeg->huff_ac[ac_id]);
+                    if (!succeeded) return false;
+                }
+                index++;
+
+                // every data block is an MCU, so countdown the restart
+                // interval.
+                if (--jpeg->todo <= 0) {
+                    skipToMarker(jpeg);
+                    if (!DRI_RESTART(jpeg->marker)) return true;
+                    resetJpegDecoder(jpeg);
                 }
             }
+            if (last < units) {
+                skipScan(jpeg);
+            }
             return true;
         } else {  // n components, DC scan.
             uint32_t i, j, k, x, y;
-            for (i = 0; i < jpeg->mcus_y; ++i) {
-                for (j = 0; j < jpeg->mcus_x; ++j) {
-                    // scan an interleaved mcu, process components in order.
-                    for (k = 0; k < jpeg->scan_n; ++k) {
-                        uint32_t comp_id = jpeg->order[k];
-                        HuffmanLookupTable *huffman_dc =
-                            &jpeg->huff_dc[jpeg->img_comp[comp_id].dc_id];
-                        for (y = 0; y < jpeg->img_comp[comp_id].vsampling; ++y) {
-                            for (x = 0; x < jpeg->img_comp[comp_id].hsampling; ++x) {
-                                int32_t y2 = (i * jpeg->img_comp[comp_id].vsampling + y);
-                                int32_t x2 = (j * jpeg->img_comp[comp_id].hsampling + x);
-                                int16_t *data = jpeg->img_comp[comp_id].coeff +
-                                    (y2 * jpeg->img_comp[comp_id].coeff_w + x2) * 64;
-                                succeeded = decodeProgressiveDCBlock(jpeg, data,
-                                                huffman_dc, comp_id, succ_value);
-                                if (!succeeded) return false;
-                            }
-                        }
-                    }
+            uint32_t units = jpeg->mcus_y * jpeg->mcus_x;
+            uint32_t last = (jpeg->mcu_y1 - 1) * jpeg->mcus_x + jpeg->mcu_x1;
+            for (uint32_t index = 0; index < last; ) {
+                uint32_t skipped = skipRestartInterval(jpeg, index, units,
+                                       jpeg->mcus_x, jpeg->mcu_x0, jpeg->mcu_x1,
+                                       jpeg->mcu_y0, jpeg->mcu_y1);
+                if (skipped > 0) {
+                    index += skipped;
+                    continue;
+                }
 
-                    // after all interleaved components, that's an interleaved MCU,
-                    // so now count down the restart interval
-                    if (--jpeg->todo <= 0) {
-                        if (!DRI_RESTART(jpeg->marker)) return true;
-                        resetJpegDecoder(jpeg);
+                i = index / jpeg->mcus_x;
+                j = index % jpeg->mcus_x;
+                // scan an interleaved mcu, process components in order.
+                for (k = 0; k < jpeg->scan_n; ++k) {
+                    uint32_t comp_id = jpeg->order[k];
+                    HuffmanLookupTable *huffman_dc =
+                        &jpeg->huff_dc[jpeg->img_comp[comp_id].dc_id];
+                    for (y = 0; y < jpeg->img_comp[comp_id].vsampling; ++y) {
+                        for (x = 0; x < jpeg->img_comp[comp_id].hsampling; ++x) {
+                            int32_t y2 = (i * jpeg->img_comp[comp_id].vsampling + y);
+                            int32_t x2 = (j * jpeg->img_comp[comp_id].hsampling + x);
+                            int16_t *data = jpeg->img_comp[comp_id].coeff +
+                                (y2 * jpeg->img_comp[comp_id].coeff_w + x2) * 64;
+                            succeeded = decodeProgressiveDCBlock(jpeg, data,
+                                            huffman_dc, comp_id, succ_value);
+                            if (!succeeded) return false;
+                        }
                     }
                 }
+                index++;
+
+                // after all interleaved components, that's an interleaved MCU,
+                // so now count down the restart interval
+                if (--jpeg->todo <= 0) {
+                    skipToMarker(jpeg);
+                    if (!DRI_RESTART(jpeg->marker)) return true;
+                    resetJpegDecoder(jpeg);
+                }
+            }
+            if (last < units) {
+                skipScan(jpeg);
             }
             return true;
         }
@@ -1898,45 +2341,53 @@ void JpegDecoder::dequantizeData(int16_t *data, uint16_t *dequant_table) {
     }
 }
 
+// Transforms the blocks [width_begin, width_end) of the block rows
+// [height_begin, height_end), the output starts at the block at height_begin
+// of the window and width_begin.
 void JpegDecoder::idctprocess1(JpegDecodeData *jpeg, uint32_t height_begin,
-                               uint32_t height_end, uint32_t width,
-                               uint32_t comp_id, uint32_t width2) {
+                               uint32_t height_end, uint32_t width_begin,
+                               uint32_t width_end, uint32_t comp_id) {
+    uint32_t width2  = jpeg->img_comp[comp_id].out_w;
+    uint32_t block_w = jpeg->img_comp[comp_id].block_w;
+    uint32_t block_h = jpeg->img_comp[comp_id].block_h;
+    uint32_t window_top = jpeg->mcu_y0 * jpeg->img_comp[comp_id].vsampling;
+    uint16_t *dequant_table = jpeg->dequant[jpeg->img_comp[comp_id].quant_id];
     for (uint32_t i = height_begin; i < height_end; i++) {
         uint8_t* result = jpeg->img_comp[comp_id].data +
-                          jpeg->img_comp[comp_id].w2 * i * 8;
+                          width2 * (i - window_top) * block_h;
         int16_t *data = jpeg->img_comp[comp_id].coeff +
-                        jpeg->img_comp[comp_id].coeff_w * i * 64;
+                        (jpeg->img_comp[comp_id].coeff_w * i + width_begin) *
+                        64;
 
-        for (uint32_t j = 0; j < width; j++) {
-            dequantizeData(data,
-                           jpeg->dequant[jpeg->img_comp[comp_id].quant_id]);
-            idctDecodeBlock(result, width2, data);
+        for (uint32_t j = width_begin; j < width_end; j++) {
+            if (block_w == 8 && block_h == 8) {
+                idctBlock8x8(data, dequant_table, width2, result, use_fma_);
+            }
+            else {
+                dequantizeData(data, dequant_table);
+                idctDecodeBlock(result, width2, data, block_w, block_h);
+            }
             data += 64;
-            result += 8;
+            result += block_w;
         }
     }
 }
 
 void JpegDecoder::finishProgressiveJpeg(JpegDecodeData *jpeg) {
     for (uint32_t n = 0; n < jpeg->components; ++n) {
+        // the blocks in the window.
         uint32_t height = (jpeg->img_comp[n].y + 7) >> 3;
         uint32_t width  = (jpeg->img_comp[n].x + 7) >> 3;
-        uint32_t width2 = jpeg->img_comp[n].w2;
-        std::vector<std::thread> threads;
-        int32_t interval = (height + hardware_threads_ - 1) / hardware_threads_;
-
-        for (uint32_t height_begin = 0; height_begin < height;
-             height_begin += interval) {
-             uint32_t height_end = height_begin + interval < height ?
-                                 height_begin + interval : height;
-            threads.push_back(std::thread(&JpegDecoder::idctprocess1, this,
-                              jpeg, height_begin, height_end, width, n,
-                              width2));
-        }
-
-        for (auto &worker: threads) {
-            worker.join();
-        }
+        uint32_t x0 = jpeg->mcu_x0 * jpeg->img_comp[n].hsampling;
+        uint32_t y0 = jpeg->mcu_y0 * jpeg->img_comp[n].vsampling;
+        uint32_t x1 = jpeg->mcu_x1 * jpeg->img_comp[n].hsampling;
+        uint32_t y1 = jpeg->mcu_y1 * jpeg->img_comp[n].vsampling;
+        x1 = x1 < width ? x1 : width;
+        y1 = y1 < height ? y1 : height;
+        parallel_for_rows(y1 - y0, (x1 - x0) * 64,
+            [&](int32_t begin, int32_t end) {
+                idctprocess1(jpeg, y0 + begin, y0 + end, x0, x1, n);
+            }, 1, num_threads_);
     }
 }
 
@@ -1966,17 +2417,18 @@ bool JpegDecoder::convertColor(int32_t stride, uint8_t* image) {
 
         // allocate line buffer big enough for upsampling off the edges
         // with upsample factor of 4
-        jpeg_->img_comp[k].line_buffer = (uint8_t *) malloc(width_ + 3);
+        jpeg_->img_comp[k].line_buffer = (uint8_t *) malloc(window_width_ +
+                                                            3);
         if (!jpeg_->img_comp[k].line_buffer) {
             freeComponents(jpeg_, jpeg_->components);
             LOG(ERROR) << "No enough memory to convert sample.";
             return false;
         }
 
-        sample->hs      = jpeg_->hsampling_max / jpeg_->img_comp[k].hsampling;
-        sample->vs      = jpeg_->vsampling_max / jpeg_->img_comp[k].vsampling;
+        sample->hs      = jpeg_->img_comp[k].up_h;
+        sample->vs      = jpeg_->img_comp[k].up_v;
         sample->ystep   = sample->vs >> 1;
-        sample->w_lores = (width_ + sample->hs - 1) / sample->hs;
+        sample->w_lores = (window_width_ + sample->hs - 1) / sample->hs;
         sample->ypos    = 0;
         sample->line0   = sample->line1 = jpeg_->img_comp[k].data;
 
@@ -1998,27 +2450,31 @@ bool JpegDecoder::convertColor(int32_t stride, uint8_t* image) {
     }
 
     if (target_comps == 3 && jpeg_->components == 3 && !is_rgb) {
-        ycrcb2bgr_ = new YCrCb2BGR(width_, channels_);
+        ycrcb2bgr_ = new YCrCb2BGR(width_, channels_, use_fma_);
     }
 
-    // now go ahead and resample
-    for (uint32_t row = 0; row < height_; ++row) {
-        uint8_t *output_row = image + stride * row;
+    // now go ahead and resample, the rows and columns of the window out of
+    // the region of interest are dropped.
+    for (uint32_t row = 0; row < offset_y_ + height_; ++row) {
+        uint8_t *output_row = image + stride * (row - offset_y_);
         for (k = 0; k < decode_n; ++k) {
             SampleData *sample = &res_comp[k];   // optimize
             int32_t y_bot = sample->ystep >= (sample->vs >> 1);
             output[k] = sample->resample(jpeg_->img_comp[k].line_buffer,
                                      y_bot ? sample->line1 : sample->line0,
                                      y_bot ? sample->line0 : sample->line1,
-                                     sample->w_lores, sample->hs);
+                                     sample->w_lores, sample->hs) + offset_x_;
             if (++sample->ystep >= sample->vs) {
                 sample->ystep = 0;
                 sample->line0 = sample->line1;
-                if (++sample->ypos < jpeg_->img_comp[k].y) {
-                    sample->line1 += jpeg_->img_comp[k].w2;
+                if (++sample->ypos < jpeg_->img_comp[k].out_y) {
+                    sample->line1 += jpeg_->img_comp[k].out_w;
                 }
             }
         }
+        if (row < offset_y_) {
+            continue;
+        }
         if (target_comps == 3) {
             uint8_t *y = output[0];
             if (jpeg_->components == 3) {
@@ -2147,11 +2603,61 @@ bool JpegDecoder::readHeader() {
         return false;
     }
 
+    if (width_ == 0 || height_ == 0 || jpeg_->mcu_width == 0 ||
+        jpeg_->mcu_height == 0) {
+        LOG(ERROR) << "No valid frame header is detected.";
+        return false;
+    }
+
+    return true;
+}
+
+bool JpegDecoder::setScale(uint32_t denominator) {
+    if (denominator != 1 && denominator != 2 && denominator != 4 &&
+        denominator != 8) {
+        LOG(ERROR) << "Invalid scale denominator: " << denominator
+                   << ", valid value: 1, 2, 4, 8.";
+        return false;
+    }
+
+    height_ = (height_ * scale_ + denominator - 1) / denominator;
+    width_  = (width_ * scale_ + denominator - 1) / denominator;
+    scale_  = denominator;
+
+    return true;
+}
+
+bool JpegDecoder::setRoi(uint32_t top, uint32_t left, uint32_t height,
+                         uint32_t width) {
+    if (height == 0 || width == 0 || top + height > height_ ||
+        left + width > width_) {
+        LOG(ERROR) << "The region of interest is out of the image.";
+        return false;
+    }
+
+    roi_ = true;
+    image_height_ = height_;
+    image_width_  = width_;
+    roi_top_  = top;
+    roi_left_ = left;
+    height_ = height;
+    width_  = width;
+
     return true;
 }
 
 bool JpegDecoder::decodeData(uint32_t stride, uint8_t* image) {
-    bool succeeded;
+    if (width_ == 0 || height_ == 0 || jpeg_->mcu_width == 0 ||
+        jpeg_->mcu_height == 0) {
+        LOG(ERROR) << "No valid frame header is detected.";
+        return false;
+    }
+
+    bool succeeded = allocateComponents(jpeg_);
+    if (!succeeded) {
+        return false;
+    }
+
     uint8_t marker = getMarker(jpeg_);
     while (marker != 0xD9) {   // end of image
         if (marker == 0xDA) {  // start of scan
@@ -2195,6 +2701,919 @@ bool JpegDecoder::decodeData(uint32_t stride, uint8_t* image) {
     return true;
 }
 
+/******************************* JPEG encoder *******************************/
+
+// The quantization tables of ITU-T T.81 Annex K for quality 50, in natural
+// order.
+static const uint8_t luminance_quantization[64] = {
+    16,  11,  10,  16,  24,  40,  51,  61,
+    12,  12,  14,  19,  26,  58,  60,  55,
+    14,  13,  16,  24,  40,  57,  69,  56,
+    14,  17,  22,  29,  51,  87,  80,  62,
+    18,  22,  37,  56,  68, 109, 103,  77,
+    24,  35,  55,  64,  81, 104, 113,  92,
+    49,  64,  78,  87, 103, 121, 120, 101,
+    72,  92,  95,  98, 112, 100, 103,  99
+};
+
+static const uint8_t chrominance_quantization[64] = {
+    17,  18,  24,  47,  99,  99,  99,  99,
+    18,  21,  26,  66,  99,  99,  99,  99,
+    24,  26,  56,  99,  99,  99,  99,  99,
+    47,  66,  99,  99,  99,  99,  99,  99,
+    99,  99,  99,  99,  99,  99,  99,  99,
+    99,  99,  99,  99,  99,  99,  99,  99,
+    99,  99,  99,  99,  99,  99,  99,  99,
+    99,  99,  99,  99,  99,  99,  99,  99
+};
+
+// Full-range YCbCr of JFIF scaled by 1 << 14 as the B, G, R weights, and the
+// bias multiplied by 128 in the (R, 128) pairs: 0.5 for rounding, plus 128
+// for Cb and Cr.
+#define YCC_SHIFT 14
+
+static const int16_t ycc_coefficients[3][4] = {
+    { 1868,  9617,  4899,    64},
+    { 8192, -5427, -2765, 16448},
+    {-1332, -6860,  8192, 16448},
+};
+
+static inline __m128i setPairs(int16_t value0, int16_t value1) {
+    return _mm_set1_epi32((int32_t)(((uint32_t)(uint16_t)value1 << 16) |
+                                    (uint16_t)value0));
+}
+
+BGR2YCrCb::BGR2YCrCb(uint32_t width, uint32_t channels) :
+                     width_(width), channels_(channels) {
+    // 8 pixels come from 2 loads, at 8 and 16 bytes apart for BGR and BGRA.
+    if (channels == 3) {
+        bg_shuffle0_ = _mm_setr_epi8(0, -1, 1, -1, 3, -1, 4, -1, 6, -1, 7, -1,
+                                     9, -1, 10, -1);
+        bg_shuffle1_ = _mm_setr_epi8(4, -1, 5, -1, 7, -1, 8, -1, 10, -1, 11,
+                                     -1, 13, -1, 14, -1);
+        rc_shuffle0_ = _mm_setr_epi8(2, -1, -1, -1, 5, -1, -1, -1, 8, -1, -1,
+                                     -1, 11, -1, -1, -1);
+        rc_shuffle1_ = _mm_setr_epi8(6, -1, -1, -1, 9, -1, -1, -1, 12, -1, -1,
+                                     -1, 15, -1, -1, -1);
+    }
+    else {
+        bg_shuffle0_ = _mm_setr_epi8(0, -1, 1, -1, 4, -1, 5, -1, 8, -1, 9, -1,
+                                     12, -1, 13, -1);
+        bg_shuffle1_ = bg_shuffle0_;
+        rc_shuffle0_ = _mm_setr_epi8(2, -1, -1, -1, 6, -1, -1, -1, 10, -1, -1,
+                                     -1, 14, -1, -1, -1);
+        rc_shuffle1_ = rc_shuffle0_;
+    }
+    rc_const_ = setPairs(0, 128);
+    y_bg_  = setPairs(ycc_coefficients[0][0], ycc_coefficients[0][1]);
+    y_rc_  = setPairs(ycc_coefficients[0][2], ycc_coefficients[0][3]);
+    cb_bg_ = setPairs(ycc_coefficients[1][0], ycc_coefficients[1][1]);
+    cb_rc_ = setPairs(ycc_coefficients[1][2], ycc_coefficients[1][3]);
+    cr_bg_ = setPairs(ycc_coefficients[2][0], ycc_coefficients[2][1]);
+    cr_rc_ = setPairs(ycc_coefficients[2][2], ycc_coefficients[2][3]);
+}
+
+BGR2YCrCb::~BGR2YCrCb() {
+}
+
+void BGR2YCrCb::process8Elements(uint8_t const *src, __m128i &y16s,
+                                 __m128i &cb16s, __m128i &cr16s) const {
+    __m128i input0 = _mm_loadu_si128((__m128i const*)src);
+    __m128i input1 = _mm_loadu_si128((__m128i const*)(src +
+                                      (channels_ == 3 ? 8 : 16)));
+    __m128i bg0 = _mm_shuffle_epi8(input0, bg_shuffle0_);
+    __m128i bg1 = _mm_shuffle_epi8(input1, bg_shuffle1_);
+    __m128i rc0 = _mm_or_si128(_mm_shuffle_epi8(input0, rc_shuffle0_),
+                               rc_const_);
+    __m128i rc1 = _mm_or_si128(_mm_shuffle_epi8(input1, rc_shuffle1_),
+                               rc_const_);
+
+    __m128i y0 = _mm_add_epi32(_mm_madd_epi16(bg0, y_bg_),
+                               _mm_madd_epi16(rc0, y_rc_));
+    __m128i y1 = _mm_add_epi32(_mm_madd_epi16(bg1, y_bg_),
+                               _mm_madd_epi16(rc1, y_rc_));
+    __m128i cb0 = _mm_add_epi32(_mm_madd_epi16(bg0, cb_bg_),
+                                _mm_madd_epi16(rc0, cb_rc_));
+    __m128i cb1 = _mm_add_epi32(_mm_madd_epi16(bg1, cb_bg_),
+                                _mm_madd_epi16(rc1, cb_rc_));
+    __m128i cr0 = _mm_add_epi32(_mm_madd_epi16(bg0, cr_bg_),
+                                _mm_madd_epi16(rc0, cr_rc_));
+    __m128i cr1 = _mm_add_epi32(_mm_madd_epi16(bg1, cr_bg_),
+                                _mm_madd_epi16(rc1, cr_rc_));
+
+    y16s  = _mm_packs_epi32(_mm_srai_epi32(y0, YCC_SHIFT),
+                            _mm_srai_epi32(y1, YCC_SHIFT));
+    cb16s = _mm_packs_epi32(_mm_srai_epi32(cb0, YCC_SHIFT),
+                            _mm_srai_epi32(cb1, YCC_SHIFT));
+    cr16s = _mm_packs_epi32(_mm_srai_epi32(cr0, YCC_SHIFT),
+                            _mm_srai_epi32(cr1, YCC_SHIFT));
+}
+
+void BGR2YCrCb::convertYCrCb(uint8_t const *src, uint8_t *y, uint8_t *pcb,
+                             uint8_t *pcr) {
+    __m128i y16s0, cb16s0, cr16s0;
+    __m128i y16s1, cb16s1, cr16s1;
+    uint32_t i = 0;
+    for (; i + 16 <= width_; i += 16, src += channels_ * 16) {
+        process8Elements(src, y16s0, cb16s0, cr16s0);
+        process8Elements(src + channels_ * 8, y16s1, cb16s1, cr16s1);
+        _mm_storeu_si128((__m128i *)(y + i), _mm_packus_epi16(y16s0, y16s1));
+        _mm_storeu_si128((__m128i *)(pcb + i),
+                         _mm_packus_epi16(cb16s0, cb16s1));
+        _mm_storeu_si128((__m128i *)(pcr + i),
+                         _mm_packus_epi16(cr16s0, cr16s1));
+    }
+    if (i + 8 <= width_) {
+        process8Elements(src, y16s0, cb16s0, cr16s0);
+        _mm_storel_epi64((__m128i *)(y + i), _mm_packus_epi16(y16s0, y16s0));
+        _mm_storel_epi64((__m128i *)(pcb + i),
+                         _mm_packus_epi16(cb16s0, cb16s0));
+        _mm_storel_epi64((__m128i *)(pcr + i),
+                         _mm_packus_epi16(cr16s0, cr16s0));
+        i += 8;
+        src += channels_ * 8;
+    }
+
+    for (; i < width_; ++i, src += channels_) {
+        int32_t values[3];
+        for (int32_t j = 0; j < 3; ++j) {
+            values[j] = (src[0] * ycc_coefficients[j][0] +
+                         src[1] * ycc_coefficients[j][1] +
+                         src[2] * ycc_coefficients[j][2] +
+                         128 * ycc_coefficients[j][3]) >> YCC_SHIFT;
+        }
+        y[i]   = clampInt8(values[0]);
+        pcb[i] = clampInt8(values[1]);
+        pcr[i] = clampInt8(values[2]);
+    }
+}
+
+// Chroma downsampling of libjpeg, the biases alternate so that the halves are
+// not all rounded up. 8 samples are output a time.
+static void downsampleH2V1(const uint8_t *input, uint32_t out_width,
+                           uint8_t *output) {
+    const __m128i ones = _mm_set1_epi8(1);
+    const __m128i bias = _mm_set1_epi32(1 << 16);
+    for (uint32_t i = 0; i < out_width; i += 8) {
+        __m128i sums = _mm_maddubs_epi16(
+            _mm_loadu_si128((__m128i const*)(input + i * 2)), ones);
+        sums = _mm_srli_epi16(_mm_add_epi16(sums, bias), 1);
+        _mm_storel_epi64((__m128i *)(output + i), _mm_packus_epi16(sums, sums));
+    }
+}
+
+static void downsampleH2V2(const uint8_t *input0, const uint8_t *input1,
+                           uint32_t out_width, uint8_t *output) {
+    const __m128i ones = _mm_set1_epi8(1);
+    const __m128i bias = _mm_set1_epi32(1 | (2 << 16));
+    for (uint32_t i = 0; i < out_width; i += 8) {
+        __m128i sums0 = _mm_maddubs_epi16(
+            _mm_loadu_si128((__m128i const*)(input0 + i * 2)), ones);
+        __m128i sums1 = _mm_maddubs_epi16(
+            _mm_loadu_si128((__m128i const*)(input1 + i * 2)), ones);
+        __m128i sums = _mm_add_epi16(_mm_add_epi16(sums0, sums1), bias);
+        sums = _mm_srli_epi16(sums, 2);
+        _mm_storel_epi64((__m128i *)(output + i), _mm_packus_epi16(sums, sums));
+    }
+}
+
+/* The islow forward dct of libjpeg(jfdctint.c), the rows are transformed
+ * first and keep PASS1_BITS extra bits, then the columns, with the output
+ * scaled up by 8. 4 lanes of 32-bit integers a time.
+ */
+#define FDCT_CONST_BITS 13
+#define FDCT_PASS1_BITS 2
+#define FIX_0_298631336 2446
+#define FIX_0_390180644 3196
+#define FIX_0_541196100 4433
+#define FIX_0_765366865 6270
+#define FIX_0_899976223 7373
+#define FIX_1_175875602 9633
+#define FIX_1_501321110 12299
+#define FIX_1_847759065 15137
+#define FIX_1_961570560 16069
+#define FIX_2_053119869 16819
+#define FIX_2_562915447 20995
+#define FIX_3_072711026 25172
+
+#define MULTIPLY(x, y) _mm_mullo_epi32(x, _mm_set1_epi32(y))
+
+template <int32_t pass>
+static inline void fdct1D(const __m128i s[8], __m128i d[8]) {
+    const int32_t shift = pass == 1 ? FDCT_CONST_BITS - FDCT_PASS1_BITS :
+                                      FDCT_CONST_BITS + FDCT_PASS1_BITS;
+    const __m128i round = _mm_set1_epi32(1 << (shift - 1));
+    __m128i tmp0 = _mm_add_epi32(s[0], s[7]);
+    __m128i tmp7 = _mm_sub_epi32(s[0], s[7]);
+    __m128i tmp1 = _mm_add_epi32(s[1], s[6]);
+    __m128i tmp6 = _mm_sub_epi32(s[1], s[6]);
+    __m128i tmp2 = _mm_add_epi32(s[2], s[5]);
+    __m128i tmp5 = _mm_sub_epi32(s[2], s[5]);
+    __m128i tmp3 = _mm_add_epi32(s[3], s[4]);
+    __m128i tmp4 = _mm_sub_epi32(s[3], s[4]);
+
+    // even part
+    __m128i tmp10 = _mm_add_epi32(tmp0, tmp3);
+    __m128i tmp13 = _mm_sub_epi32(tmp0, tmp3);
+    __m128i tmp11 = _mm_add_epi32(tmp1, tmp2);
+    __m128i tmp12 = _mm_sub_epi32(tmp1, tmp2);
+    if (pass == 1) {
+        d[0] = _mm_slli_epi32(_mm_add_epi32(tmp10, tmp11), FDCT_PASS1_BITS);
+        d[4] = _mm_slli_epi32(_mm_sub_epi32(tmp10, tmp11), FDCT_PASS1_BITS);
+    }
+    else {
+        const __m128i half = _mm_set1_epi32(1 << (FDCT_PASS1_BITS - 1));
+        tmp10 = _mm_add_epi32(tmp10, half);
+        d[0] = _mm_srai_epi32(_mm_add_epi32(tmp10, tmp11), FDCT_PASS1_BITS);
+        d[4] = _mm_srai_epi32(_mm_sub_epi32(tmp10, tmp11), FDCT_PASS1_BITS);
+    }
+    __m128i z1 = _mm_add_epi32(MULTIPLY(_mm_add_epi32(tmp12, tmp13),
+                                        FIX_0_541196100), round);
+    d[2] = _mm_srai_epi32(_mm_add_epi32(z1, MULTIPLY(tmp13, FIX_0_765366865)),
+                          shift);
+    d[6] = _mm_srai_epi32(_mm_sub_epi32(z1, MULTIPLY(tmp12, FIX_1_847759065)),
+                          shift);
+
+    // odd part
+    z1 = _mm_add_epi32(tmp4, tmp7);
+    __m128i z2 = _mm_add_epi32(tmp5, tmp6);
+    __m128i z3 = _mm_add_epi32(tmp4, tmp6);
+    __m128i z4 = _mm_add_epi32(tmp5, tmp7);
+    __m128i z5 = MULTIPLY(_mm_add_epi32(z3, z4), FIX_1_175875602);
+    tmp4 = MULTIPLY(tmp4, FIX_0_298631336);
+    tmp5 = MULTIPLY(tmp5, FIX_2_053119869);
+    tmp6 = MULTIPLY(tmp6, FIX_3_072711026);
+    tmp7 = MULTIPLY(tmp7, FIX_1_501321110);
+    z1 = MULTIPLY(z1, -FIX_0_899976223);
+    z2 = MULTIPLY(z2, -FIX_2_562915447);
+    z3 = _mm_add_epi32(MULTIPLY(z3, -FIX_1_961570560), z5);
+    z4 = _mm_add_epi32(MULTIPLY(z4, -FIX_0_390180644), z5);
+    z3 = _mm_add_epi32(z3, round);
+    z4 = _mm_add_epi32(z4, round);
+    d[7] = _mm_srai_epi32(_mm_add_epi32(_mm_add_epi32(tmp4, z1), z3), shift);
+    d[5] = _mm_srai_epi32(_mm_add_epi32(_mm_add_epi32(tmp5, z2), z4), shift);
+    d[3] = _mm_srai_epi32(_mm_add_epi32(_mm_add_epi32(tmp6, z2), z3), shift);
+    d[1] = _mm_srai_epi32(_mm_add_epi32(_mm_add_epi32(tmp7, z1), z4), shift);
+}
+
+static inline void transpose4x4(__m128i &r0, __m128i &r1, __m128i &r2,
+                                __m128i &r3) {
+    __m128i t0 = _mm_unpacklo_epi32(r0, r1);
+    __m128i t1 = _mm_unpacklo_epi32(r2, r3);
+    __m128i t2 = _mm_unpackhi_epi32(r0, r1);
+    __m128i t3 = _mm_unpackhi_epi32(r2, r3);
+    r0 = _mm_unpacklo_epi64(t0, t1);
+    r1 = _mm_unpackhi_epi64(t0, t1);
+    r2 = _mm_unpacklo_epi64(t2, t3);
+    r3 = _mm_unpackhi_epi64(t2, t3);
+}
+
+// lo[] and hi[] hold the left and right 4 columns of the 8 rows.
+static inline void transpose8x8(__m128i lo[8], __m128i hi[8]) {
+    transpose4x4(lo[0], lo[1], lo[2], lo[3]);
+    transpose4x4(lo[4], lo[5], lo[6], lo[7]);
+    transpose4x4(hi[0], hi[1], hi[2], hi[3]);
+    transpose4x4(hi[4], hi[5], hi[6], hi[7]);
+    for (int32_t i = 0; i < 4; ++i) {
+        __m128i temp = lo[i + 4];
+        lo[i + 4] = hi[i];
+        hi[i] = temp;
+    }
+}
+
+static void fdct8x8(const uint8_t *input, int32_t in_stride,
+                    const float *reciprocals, int16_t output[64]) {
+    __m128i lo[8], hi[8];
+    const __m128i center = _mm_set1_epi32(128);
+    for (int32_t i = 0; i < 8; ++i) {
+        __m128i samples = _mm_loadl_epi64((__m128i const*)(input +
+                                          i * in_stride));
+        lo[i] = _mm_sub_epi32(_mm_cvtepu8_epi32(samples), center);
+        hi[i] = _mm_sub_epi32(_mm_cvtepu8_epi32(_mm_srli_si128(samples, 4)),
+                              center);
+    }
+
+    // rows, as columns of the transposed block, then columns.
+    transpose8x8(lo, hi);
+    fdct1D<1>(lo, lo);
+    fdct1D<1>(hi, hi);
+    transpose8x8(lo, hi);
+    fdct1D<2>(lo, lo);
+    fdct1D<2>(hi, hi);
+
+    // quantization of the magnitudes, rounding halves away from zero as
+    // libjpeg does, then the signs are restored.
+    const __m128 half = _mm_set1_ps(0.5f);
+    for (int32_t i = 0; i < 8; ++i) {
+        __m128 values0 = _mm_mul_ps(_mm_cvtepi32_ps(_mm_abs_epi32(lo[i])),
+                                    _mm_loadu_ps(reciprocals + i * 8));
+        __m128 values1 = _mm_mul_ps(_mm_cvtepi32_ps(_mm_abs_epi32(hi[i])),
+                                    _mm_loadu_ps(reciprocals + i * 8 + 4));
+        __m128i quotients0 = _mm_sign_epi32(
+            _mm_cvttps_epi32(_mm_add_ps(values0, half)), lo[i]);
+        __m128i quotients1 = _mm_sign_epi32(
+            _mm_cvttps_epi32(_mm_add_ps(values1, half)), hi[i]);
+        _mm_storeu_si128((__m128i *)(output + i * 8),
+                         _mm_packs_epi32(quotients0, quotients1));
+    }
+}
+
+void fdctBlock8x8(const uint8_t *input, int32_t in_stride,
+                  const float *reciprocals, int16_t output[64], bool use_fma) {
+    if (use_fma) {
+        fma::jpeg_fdct_8x8_u8_fma(input, in_stride, reciprocals, output);
+        return;
+    }
+    fdct8x8(input, in_stride, reciprocals, output);
+}
+
+static inline uint32_t countTrailingZeros64(uint64_t value) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    if (_BitScanForward(&index, (unsigned long)value)) {
+        return index;
+    }
+    _BitScanForward(&index, (unsigned long)(value >> 32));
+    return index + 32;
+#else
+    return __builtin_ctzll(value);
+#endif
+}
+
+// The category of a coefficient, the number of bits of its magnitude.
+static inline uint32_t bitLength(uint32_t value) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    return _BitScanReverse(&index, value) ? index + 1 : 0;
+#else
+    return value == 0 ? 0 : 32 - __builtin_clz(value);
+#endif
+}
+
+// Bit k of the mask is set when coefficient k is not zero.
+static inline uint64_t nonzeroMask(const int16_t block[64]) {
+    const __m128i zero = _mm_setzero_si128();
+    uint64_t mask = 0;
+    for (int32_t i = 0; i < 64; i += 16) {
+        __m128i zeros0 = _mm_cmpeq_epi16(
+            _mm_loadu_si128((__m128i const*)(block + i)), zero);
+        __m128i zeros1 = _mm_cmpeq_epi16(
+            _mm_loadu_si128((__m128i const*)(block + i + 8)), zero);
+        uint32_t zeros = _mm_movemask_epi8(_mm_packs_epi16(zeros0, zeros1));
+        mask |= (uint64_t)(~zeros & 0xffff) << i;
+    }
+
+    return mask;
+}
+
+// Symbol statistics of a block in zigzag order for the optimized tables, the
+// same traversal as encodeBlock().
+static inline void countBlock(const int16_t block[64], int32_t &last_dc,
+                              uint32_t *dc_frequencies,
+                              uint32_t *ac_frequencies) {
+    int32_t diff = block[0] - last_dc;
+    last_dc = block[0];
+    dc_frequencies[bitLength(diff < 0 ? -diff : diff)]++;
+
+    uint64_t mask = nonzeroMask(block) >> 1;
+    uint32_t position = 0;
+    while (mask != 0) {
+        uint32_t index = countTrailingZeros64(mask) + 1;
+        mask &= mask - 1;
+        uint32_t run = index - position - 1;
+        position = index;
+        for (; run >= 16; run -= 16) {
+            ac_frequencies[0xf0]++;
+        }
+        int32_t value = block[index];
+        ac_frequencies[(run << 4) | bitLength(value < 0 ? -value : value)]++;
+    }
+    if (position != 63) {
+        ac_frequencies[0]++;
+    }
+}
+
+/* Huffman code lengths of minimal total size limited to 16 bits, as
+ * jpeg_gen_optimal_table() of libjpeg does. A reserved symbol of frequency 1
+ * takes the longest code, so no real code is made up of all ones.
+ */
+static void buildOptimalTable(const uint32_t frequencies[257],
+                              HuffmanEncodeTable &table) {
+    int64_t counts[257];
+    int32_t code_sizes[257], others[257];
+    for (int32_t i = 0; i < 256; ++i) {
+        counts[i] = frequencies[i];
+        code_sizes[i] = 0;
+        others[i] = -1;
+    }
+    counts[256] = 1;
+    code_sizes[256] = 0;
+    others[256] = -1;
+
+    // merges the 2 least frequent trees until 1 is left.
+    while (true) {
+        int32_t c1 = -1, c2 = -1;
+        int64_t value = INT64_MAX;
+        for (int32_t i = 0; i <= 256; ++i) {
+            if (counts[i] != 0 && counts[i] <= value) {
+                value = counts[i];
+                c1 = i;
+            }
+        }
+        value = INT64_MAX;
+        for (int32_t i = 0; i <= 256; ++i) {
+            if (counts[i] != 0 && counts[i] <= value && i != c1) {
+                value = counts[i];
+                c2 = i;
+            }
+        }
+        if (c2 < 0) {
+            break;
+        }
+
+        counts[c1] += counts[c2];
+        counts[c2] = 0;
+        code_sizes[c1]++;
+        while (others[c1] >= 0) {
+            c1 = others[c1];
+            code_sizes[c1]++;
+        }
+        others[c1] = c2;
+        code_sizes[c2]++;
+        while (others[c2] >= 0) {
+            c2 = others[c2];
+            code_sizes[c2]++;
+        }
+    }
+
+    int32_t bits[258] = {0};
+    for (int32_t i = 0; i <= 256; ++i) {
+        if (code_sizes[i] > 0) {
+            bits[code_sizes[i]]++;
+        }
+    }
+    // moves pairs of the longest codes up, one of their prefix down.
+    for (int32_t i = 257; i > 16; --i) {
+        while (bits[i] > 0) {
+            int32_t j = i - 2;
+            while (bits[j] == 0) {
+                j--;
+            }
+            bits[i] -= 2;
+            bits[i - 1]++;
+            bits[j + 1] += 2;
+            bits[j]--;
+        }
+    }
+    int32_t length = 16;
+    while (length > 0 && bits[length] == 0) {
+        length--;
+    }
+    if (length > 0) {
+        bits[length]--;
+    }
+
+    table.bits[0] = 0;
+    for (int32_t i = 1; i <= 16; ++i) {
+        table.bits[i] = (uint8_t)bits[i];
+    }
+    int32_t count = 0;
+    for (int32_t size = 1; size <= 256; ++size) {
+        for (int32_t i = 0; i < 256; ++i) {
+            if (code_sizes[i] == size) {
+                table.values[count++] = (uint8_t)i;
+            }
+        }
+    }
+
+    memset(table.sizes, 0, sizeof(table.sizes));
+    uint32_t code = 0;
+    int32_t index = 0;
+    for (int32_t size = 1; size <= 16; ++size) {
+        for (int32_t i = 0; i < table.bits[size]; ++i) {
+            uint8_t symbol = table.values[index++];
+            table.codes[symbol] = (uint16_t)code++;
+            table.sizes[symbol] = (uint8_t)size;
+        }
+        code <<= 1;
+    }
+}
+
+typedef struct {
+    uint8_t* data;      // JPEG_OUTPUT_SIZE plus room for a mcu
+    uint8_t* current;
+    uint64_t buffer;
+    uint32_t bits;      // number of bits not output in buffer
+} JpegBitWriter;
+
+// value holds size bits, which are at most 27 for a code and the following
+// magnitude, a zero byte is stuffed after each 0xff.
+static inline void putBits(JpegBitWriter &writer, uint32_t value,
+                           uint32_t size) {
+    writer.buffer = (writer.buffer << size) | value;
+    writer.bits += size;
+    if (writer.bits < 32) {
+        return;
+    }
+
+    writer.bits -= 32;
+    uint32_t word = (uint32_t)(writer.buffer >> writer.bits);
+    uint32_t inverted = ~word;
+    uint8_t* current = writer.current;
+    if (((inverted - 0x01010101u) & ~inverted & 0x80808080u) == 0) {
+        current[0] = (uint8_t)(word >> 24);
+        current[1] = (uint8_t)(word >> 16);
+        current[2] = (uint8_t)(word >> 8);
+        current[3] = (uint8_t)word;
+        writer.current = current + 4;
+        return;
+    }
+    for (int32_t shift = 24; shift >= 0; shift -= 8) {
+        uint8_t byte = (uint8_t)(word >> shift);
+        *current++ = byte;
+        if (byte == 0xff) {
+            *current++ = 0;
+        }
+    }
+    writer.current = current;
+}
+
+// Pads the last byte with ones.
+static void flushBits(JpegBitWriter &writer) {
+    uint32_t padding = (8 - (writer.bits & 7)) & 7;
+    putBits(writer, (1u << padding) - 1, padding);
+    while (writer.bits >= 8) {
+        writer.bits -= 8;
+        uint8_t byte = (uint8_t)(writer.buffer >> writer.bits);
+        *writer.current++ = byte;
+        if (byte == 0xff) {
+            *writer.current++ = 0;
+        }
+    }
+}
+
+static inline void encodeBlock(JpegBitWriter &writer, const int16_t block[64],
+                               int32_t &last_dc,
+                               const HuffmanEncodeTable &dc_table,
+                               const HuffmanEncodeTable &ac_table) {
+    // negative values are coded as their ones' complement.
+    int32_t diff = block[0] - last_dc;
+    last_dc = block[0];
+    uint32_t size = bitLength(diff < 0 ? -diff : diff);
+    uint32_t bits = (uint32_t)(diff - (diff < 0)) & ((1u << size) - 1);
+    putBits(writer, ((uint32_t)dc_table.codes[size] << size) | bits,
+            dc_table.sizes[size] + size);
+
+    uint64_t mask = nonzeroMask(block) >> 1;
+    uint32_t position = 0;
+    while (mask != 0) {
+        uint32_t index = countTrailingZeros64(mask) + 1;
+        mask &= mask - 1;
+        uint32_t run = index - position - 1;
+        position = index;
+        for (; run >= 16; run -= 16) {
+            putBits(writer, ac_table.codes[0xf0], ac_table.sizes[0xf0]);
+        }
+        int32_t value = block[index];
+        size = bitLength(value < 0 ? -value : value);
+        bits = (uint32_t)(value - (value < 0)) & ((1u << size) - 1);
+        uint32_t symbol = (run << 4) | size;
+        putBits(writer, ((uint32_t)ac_table.codes[symbol] << size) | bits,
+                ac_table.sizes[symbol] + size);
+    }
+    if (position != 63) {
+        putBits(writer, ac_table.codes[0], ac_table.sizes[0]);
+    }
+}
+
+JpegEncoder::JpegEncoder(BytesWriter& file_data) {
+    file_data_ = &file_data;
+    use_fma_ = isa_supported(ISA_X86_FMA);
+    quality_ = 95;
+    hsampling_ = 2;
+    vsampling_ = 2;
+    mcus_x_ = 0;
+    mcus_y_ = 0;
+    coefficients_ = nullptr;
+}
+
+JpegEncoder::~JpegEncoder() {
+    free(coefficients_);
+}
+
+bool JpegEncoder::setParameter(int32_t key, int32_t value) {
+    if (key == IMWRITE_JPEG_QUALITY) {
+        if (value < 0 || value > 100) {
+            LOG(ERROR) << "Invalid jpeg quality: " << value
+                       << ", it should be in 0-100.";
+            return false;
+        }
+        quality_ = value;
+    }
+    else if (key == IMWRITE_JPEG_SAMPLING_FACTOR) {
+        if (value == IMWRITE_JPEG_SAMPLING_FACTOR_420) {
+            hsampling_ = 2;
+            vsampling_ = 2;
+        }
+        else if (value == IMWRITE_JPEG_SAMPLING_FACTOR_422) {
+            hsampling_ = 2;
+            vsampling_ = 1;
+        }
+        else if (value == IMWRITE_JPEG_SAMPLING_FACTOR_444) {
+            hsampling_ = 1;
+            vsampling_ = 1;
+        }
+        else {
+            LOG(ERROR) << "Invalid jpeg sampling factor: " << value
+                       << ", 4:2:0, 4:2:2 and 4:4:4 are supported.";
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// The tables of Annex K scaled as libjpeg does, limited to 8 bits for the
+// baseline.
+void JpegEncoder::setQuantizationTables() {
+    int32_t quality = quality_ < 1 ? 1 : quality_;
+    int32_t scale = quality < 50 ? 5000 / quality : 200 - quality * 2;
+    const uint8_t* base_tables[2] = {luminance_quantization,
+                                     chrominance_quantization};
+    for (int32_t i = 0; i < 2; ++i) {
+        for (int32_t j = 0; j < 64; ++j) {
+            int32_t value = (base_tables[i][j] * scale + 50) / 100;
+            value = value < 1 ? 1 : (value > 255 ? 255 : value);
+            quant_tables_[i][j] = (uint8_t)value;
+            reciprocals_[i][j] = 1.f / (value * 8);
+        }
+    }
+}
+
+// Transforms and quantizes a block into zigzag order, and counts its symbols.
+static inline int16_t* transformBlock(const uint8_t *input, int32_t stride,
+                                      const float *reciprocals, bool use_fma,
+                                      int32_t &last_dc,
+                                      uint32_t *dc_frequencies,
+                                      uint32_t *ac_frequencies,
+                                      int16_t *coefficients) {
+    int16_t block[64];
+    fdctBlock8x8(input, stride, reciprocals, block, use_fma);
+    for (int32_t i = 0; i < 64; ++i) {
+        coefficients[i] = block[dezigzag_indices[i]];
+    }
+    countBlock(coefficients, last_dc, dc_frequencies, ac_frequencies);
+
+    return coefficients + 64;
+}
+
+/* The image is converted to YCbCr a row of mcus a time, with the right and
+ * bottom edges replicated to whole mcus, the chroma planes are downsampled,
+ * then the blocks are transformed in the order they are encoded.
+ */
+bool JpegEncoder::transformImage(uint32_t height, uint32_t width,
+                                 uint32_t channels, uint32_t stride,
+                                 const uint8_t* image) {
+    uint32_t components = channels == 1 ? 1 : 3;
+    uint32_t hsampling = components == 1 ? 1 : hsampling_;
+    uint32_t vsampling = components == 1 ? 1 : vsampling_;
+    uint32_t mcu_width  = hsampling * 8;
+    uint32_t mcu_height = vsampling * 8;
+    mcus_x_ = (width + mcu_width - 1) / mcu_width;
+    mcus_y_ = (height + mcu_height - 1) / mcu_height;
+    uint32_t padded_width = mcus_x_ * mcu_width;
+    uint32_t chroma_width = mcus_x_ * 8;
+    size_t blocks = (size_t)mcus_x_ * mcus_y_ *
+                    (hsampling * vsampling + components - 1);
+
+    free(coefficients_);
+    coefficients_ = (int16_t*)malloc(blocks * 64 * sizeof(int16_t));
+    size_t plane_size = (size_t)mcu_height * padded_width;
+    uint8_t* buffer = (uint8_t*)malloc(plane_size * components +
+                                       chroma_width * 8 * 2);
+    if (coefficients_ == nullptr || buffer == nullptr) {
+        LOG(ERROR) << "No enough memory to be allocated for jpeg encoding.";
+        free(buffer);
+        return false;
+    }
+    uint8_t* planes[3] = {buffer, buffer + plane_size,
+                          buffer + plane_size * 2};
+    // the full planes of 4:4:4, or the downsampled ones.
+    uint8_t* chroma_planes[2] = {planes[1], planes[2]};
+    uint32_t chroma_stride = padded_width;
+    if (hsampling == 2) {
+        chroma_planes[0] = buffer + plane_size * 3;
+        chroma_planes[1] = chroma_planes[0] + chroma_width * 8;
+        chroma_stride = chroma_width;
+    }
+
+    BGR2YCrCb bgr2ycrcb(width, channels);
+    memset(dc_frequencies_, 0, sizeof(dc_frequencies_));
+    memset(ac_frequencies_, 0, sizeof(ac_frequencies_));
+    int32_t last_dc[3] = {0, 0, 0};
+    int16_t* coefficients = coefficients_;
+    for (uint32_t mcu_y = 0; mcu_y < mcus_y_; ++mcu_y) {
+        for (uint32_t row = 0; row < mcu_height; ++row) {
+            uint32_t y = mcu_y * mcu_height + row;
+            size_t offset = (size_t)row * padded_width;
+            if (y >= height) {
+                for (uint32_t i = 0; i < components; ++i) {
+                    memcpy(planes[i] + offset, planes[i] + offset -
+                           padded_width, padded_width);
+                }
+                continue;
+            }
+
+            const uint8_t* src = image + (size_t)y * stride;
+            if (components == 1) {
+                memcpy(planes[0] + offset, src, width);
+            }
+            else {
+                bgr2ycrcb.convertYCrCb(src, planes[0] + offset,
+                                       planes[1] + offset, planes[2] + offset);
+            }
+            for (uint32_t i = 0; i < components; ++i) {
+                uint8_t* plane_row = planes[i] + offset;
+                memset(plane_row + width, plane_row[width - 1],
+                       padded_width - width);
+            }
+        }
+
+        if (components == 3 && hsampling == 2) {
+            for (uint32_t i = 0; i < 2; ++i) {
+                for (uint32_t row = 0; row < 8; ++row) {
+                    uint8_t* output = chroma_planes[i] + row * chroma_width;
+                    if (vsampling == 2) {
+                        const uint8_t* input = planes[i + 1] +
+                                               (size_t)row * 2 * padded_width;
+                        downsampleH2V2(input, input + padded_width,
+                                       chroma_width, output);
+                    }
+                    else {
+                        downsampleH2V1(planes[i + 1] + (size_t)row *
+                                       padded_width, chroma_width, output);
+                    }
+                }
+            }
+        }
+
+        for (uint32_t mcu_x = 0; mcu_x < mcus_x_; ++mcu_x) {
+            for (uint32_t v = 0; v < vsampling; ++v) {
+                for (uint32_t h = 0; h < hsampling; ++h) {
+                    const uint8_t* input = planes[0] + v * 8 * padded_width +
+                                           (mcu_x * hsampling + h) * 8;
+                    coefficients = transformBlock(input, padded_width,
+                        reciprocals_[0], use_fma_, last_dc[0],
+                        dc_frequencies_[0], ac_frequencies_[0], coefficients);
+                }
+            }
+            for (uint32_t i = 1; i < components; ++i) {
+                coefficients = transformBlock(chroma_planes[i - 1] + mcu_x * 8,
+                    chroma_stride, reciprocals_[1], use_fma_, last_dc[i],
+                    dc_frequencies_[1], ac_frequencies_[1], coefficients);
+            }
+        }
+    }
+    free(buffer);
+
+    return true;
+}
+
+void JpegEncoder::writeHuffmanTable(uint32_t table_class, uint32_t table_id,
+                                    const HuffmanEncodeTable& table) {
+    uint32_t count = 0;
+    for (int32_t i = 1; i <= 16; ++i) {
+        count += table.bits[i];
+    }
+    file_data_->putWordBigEndian(0xFFC4);
+    file_data_->putWordBigEndian(2 + 1 + 16 + count);
+    file_data_->putByte((table_class << 4) | table_id);
+    file_data_->putBytes(table.bits + 1, 16);
+    file_data_->putBytes(table.values, count);
+}
+
+void JpegEncoder::writeHeaders(uint32_t height, uint32_t width,
+                               uint32_t components) {
+    static const uint8_t jfif[14] = {'J', 'F', 'I', 'F', 0, 1, 1, 0, 0, 1, 0,
+                                     1, 0, 0};
+    uint32_t tables = components == 1 ? 1 : 2;
+
+    // SOI, APP0
+    file_data_->putWordBigEndian(0xFFD8);
+    file_data_->putWordBigEndian(0xFFE0);
+    file_data_->putWordBigEndian(2 + 14);
+    file_data_->putBytes(jfif, 14);
+
+    // DQT in zigzag order with 8-bit precision
+    file_data_->putWordBigEndian(0xFFDB);
+    file_data_->putWordBigEndian(2 + tables * 65);
+    for (uint32_t i = 0; i < tables; ++i) {
+        file_data_->putByte(i);
+        for (int32_t j = 0; j < 64; ++j) {
+            file_data_->putByte(quant_tables_[i][dezigzag_indices[j]]);
+        }
+    }
+
+    // SOF0 of baseline, Y(1), Cb(2), Cr(3)
+    file_data_->putWordBigEndian(0xFFC0);
+    file_data_->putWordBigEndian(8 + components * 3);
+    file_data_->putByte(8);
+    file_data_->putWordBigEndian(height);
+    file_data_->putWordBigEndian(width);
+    file_data_->putByte(components);
+    for (uint32_t i = 0; i < components; ++i) {
+        file_data_->putByte(i + 1);
+        file_data_->putByte(i == 0 && components == 3 ?
+                            (hsampling_ << 4) | vsampling_ : 0x11);
+        file_data_->putByte(i == 0 ? 0 : 1);
+    }
+
+    for (uint32_t i = 0; i < tables; ++i) {
+        writeHuffmanTable(0, i, huffman_dc_[i]);
+        writeHuffmanTable(1, i, huffman_ac_[i]);
+    }
+
+    // SOS of all the components, 0-63 of the spectral selection
+    file_data_->putWordBigEndian(0xFFDA);
+    file_data_->putWordBigEndian(6 + components * 2);
+    file_data_->putByte(components);
+    for (uint32_t i = 0; i < components; ++i) {
+        file_data_->putByte(i + 1);
+        file_data_->putByte(i == 0 ? 0x00 : 0x11);
+    }
+    file_data_->putByte(0);
+    file_data_->putByte(63);
+    file_data_->putByte(0);
+}
+
+bool JpegEncoder::encodeBlocks(uint32_t components) {
+    JpegBitWriter writer;
+    writer.data = (uint8_t*)malloc(JPEG_OUTPUT_SIZE + 4096);
+    if (writer.data == nullptr) {
+        LOG(ERROR) << "No enough memory to be allocated for jpeg output.";
+        return false;
+    }
+    writer.current = writer.data;
+    writer.buffer = 0;
+    writer.bits = 0;
+
+    uint32_t luma_blocks = components == 1 ? 1 : hsampling_ * vsampling_;
+    size_t mcus = (size_t)mcus_x_ * mcus_y_;
+    int32_t last_dc[3] = {0, 0, 0};
+    const int16_t* coefficients = coefficients_;
+    for (size_t i = 0; i < mcus; ++i) {
+        for (uint32_t j = 0; j < luma_blocks; ++j, coefficients += 64) {
+            encodeBlock(writer, coefficients, last_dc[0], huffman_dc_[0],
+                        huffman_ac_[0]);
+        }
+        for (uint32_t j = 1; j < components; ++j, coefficients += 64) {
+            encodeBlock(writer, coefficients, last_dc[j], huffman_dc_[1],
+                        huffman_ac_[1]);
+        }
+        if (writer.current - writer.data >= JPEG_OUTPUT_SIZE) {
+            file_data_->putBytes(writer.data, writer.current - writer.data);
+            writer.current = writer.data;
+        }
+    }
+    flushBits(writer);
+    file_data_->putBytes(writer.data, writer.current - writer.data);
+    free(writer.data);
+
+    return true;
+}
+
+bool JpegEncoder::encodeData(uint32_t height, uint32_t width,
+                             uint32_t channels, uint32_t depth,
+                             uint32_t stride, const uint8_t* image) {
+    if (depth != 8) {
+        LOG(ERROR) << "Only 8-bit images can be encoded into jpeg.";
+        return false;
+    }
+    if (height > 65535 || width > 65535) {
+        LOG(ERROR) << "The image of " << height << "x" << width
+                   << " is too large for jpeg, 65535 at most.";
+        return false;
+    }
+
+    uint32_t components = channels == 1 ? 1 : 3;
+    setQuantizationTables();
+    if (!transformImage(height, width, channels, stride, image)) {
+        return false;
+    }
+    for (uint32_t i = 0; i < (components == 1 ? 1u : 2u); ++i) {
+        buildOptimalTable(dc_frequencies_[i], huffman_dc_[i]);
+        buildOptimalTable(ac_frequencies_[i], huffman_ac_[i]);
+    }
+
+    writeHeaders(height, width, components);
+    bool succeeded = encodeBlocks(components);
+    free(coefficients_);
+    coefficients_ = nullptr;
+    file_data_->putWordBigEndian(0xFFD9);
+
+    return succeeded && !file_data_->isFailed();
+}
+
 } //! namespace x86
 } //! namespace cv
 } //! namespace ppl
@@ -20,6 +20,7 @@
 
 #include "imagecodecs.h"
 #include "bytesreader.h"
+#include "byteswriter.h"
 
 #include <stdint.h>
 
@@ -35,6 +36,9 @@ namespace x86 {
 #define MAX_BITS 16
 #define LOOKAHEAD_BITS 9
 
+// entropy-coded bytes buffered by the encoder before being written.
+#define JPEG_OUTPUT_SIZE (1 << 16)
+
 typedef uint8_t *(*resampleRow)(uint8_t *out, uint8_t *in0, uint8_t *in1,
                                 uint32_t width, uint32_t hs);
 
@@ -63,6 +67,9 @@ typedef struct {
     uint32_t hsampling_max, vsampling_max;
     uint32_t mcu_width, mcu_height;
     uint32_t mcus_x, mcus_y;
+    // the window of mcus decoded, [mcu_x0, mcu_x1) x [mcu_y0, mcu_y1), which
+    // is all the mcus except in region-of-interest decoding.
+    uint32_t mcu_x0, mcu_y0, mcu_x1, mcu_y1;
 
     struct {
         uint32_t id;            // component id: Y(1), Cb(2), Cr(3), I(4), Q(5)
@@ -72,6 +79,10 @@ typedef struct {
         int32_t dc_pred;
 
         uint32_t x, y, w2, h2, coeff_w;
+        // size of the idct output of a block, the upsampling factors and the
+        // size of the decoded plane, which are scaled in scaled decoding.
+        uint32_t block_w, block_h, up_h, up_v;
+        uint32_t out_w, out_h, out_y;
         uint8_t *data;    // sequentially stored mcu data of YCrCb
         uint8_t *line_buffer;
         int16_t *coeff;   // progressive only
@@ -99,7 +110,8 @@ typedef struct {
 
 class YCrCb2BGR {
   public:
-    YCrCb2BGR(uint32_t width, uint32_t channels);
+    // use_fma picks the avx2 kernel, the results are the same.
+    YCrCb2BGR(uint32_t width, uint32_t channels, bool use_fma);
     ~YCrCb2BGR();
 
     void convertBGR(uint8_t const *y, uint8_t const *pcb, uint8_t const *pcr,
@@ -112,6 +124,7 @@ class YCrCb2BGR {
 
   private:
     uint32_t width_, channels_;
+    bool use_fma_;
     __m128i sign_flip_;
     __m128i cr_const0_;
     __m128i cr_const1_;
@@ -123,18 +136,73 @@ class YCrCb2BGR {
     __m128i r16s0_, r16s1_;
 };
 
+// The 8x8 islow idct of the decoder, the coefficients are dequantized first
+// when dequant_table is not null. use_fma picks the avx2 kernel, the results
+// are the same.
+void idctBlock8x8(const int16_t data[64], const uint16_t *dequant_table,
+                  int32_t out_stride, uint8_t *output, bool use_fma);
+
+// Full-range BGR(A) to YCbCr of JFIF, the _mm_madd_epi16 kernel of BGR2I420
+// with (B, G) and (R, bias) pairs, the scalar tail gives the same results.
+class BGR2YCrCb {
+  public:
+    BGR2YCrCb(uint32_t width, uint32_t channels);
+    ~BGR2YCrCb();
+
+    void convertYCrCb(uint8_t const *src, uint8_t *y, uint8_t *pcb,
+                      uint8_t *pcr);
+
+  private:
+    void process8Elements(uint8_t const *src, __m128i &y16s, __m128i &cb16s,
+                          __m128i &cr16s) const;
+
+  private:
+    uint32_t width_, channels_;
+    __m128i bg_shuffle0_, bg_shuffle1_;
+    __m128i rc_shuffle0_, rc_shuffle1_;
+    __m128i rc_const_;
+    __m128i y_bg_, y_rc_;
+    __m128i cb_bg_, cb_rc_;
+    __m128i cr_bg_, cr_rc_;
+};
+
+// The 8x8 islow forward dct of the encoder on level shifted samples, the
+// coefficients are quantized with the reciprocals of 8 * quantization steps
+// and rounded half away from zero, in natural order. use_fma picks the avx2
+// kernel, the results are the same.
+void fdctBlock8x8(const uint8_t *input, int32_t in_stride,
+                  const float *reciprocals, int16_t output[64], bool use_fma);
+
+typedef struct {
+    uint8_t  bits[17];      // number of codes of each length
+    uint8_t  values[256];   // symbols in the order of the codes
+    uint16_t codes[256];
+    uint8_t  sizes[256];
+} HuffmanEncodeTable;
+
+// Upsampling of a row of 2x2 subsampled samples, shared with the benchmarks.
+uint8_t* resampleRowHV2(uint8_t *out, uint8_t *in_near, uint8_t *in_far,
+                        uint32_t width, uint32_t hs);
+
 class JpegDecoder : public ImageDecoder {
   public:
     JpegDecoder(BytesReader& file_data);
     ~JpegDecoder();
 
     bool readHeader() override;
+    // Called after readHeader(), the denominator is 1, 2, 4 or 8.
+    bool setScale(uint32_t denominator) override;
+    // Called after readHeader() and setScale().
+    bool setRoi(uint32_t top, uint32_t left, uint32_t height,
+                uint32_t width) override;
     bool decodeData(uint32_t stride, uint8_t* image) override;
 
   private:
     bool parseAPP0(JpegDecodeData *jpeg);
     bool parseAPP14(JpegDecodeData *jpeg);
     bool parseSOF(JpegDecodeData *jpeg);
+    bool setWindow(JpegDecodeData *jpeg);
+    bool allocateComponents(JpegDecodeData *jpeg);
     bool parseSOS(JpegDecodeData *jpeg);
     bool parseDQT(JpegDecodeData *jpeg);
     bool buildHuffmanTable(HuffmanLookupTable *huffman_table, uint32_t *count);
@@ -154,10 +222,11 @@ class JpegDecoder : public ImageDecoder {
                      HuffmanLookupTable *huffman_dc,
                      HuffmanLookupTable *huffman_ac,
                      uint32_t component_id, uint16_t *dequant_table);
-    void idctDecodeBlock(uint8_t *output, int32_t out_stride, int16_t data[64]);
+    void idctDecodeBlock(uint8_t *output, int32_t out_stride, int16_t data[64],
+                         uint32_t block_w, uint32_t block_h);
     void idctprocess0(JpegDecodeData *jpeg, int16_t* buffer, uint8_t* output,
                       uint32_t height_begin, uint32_t height_end,
-                      uint32_t width, uint32_t width2);
+                      uint32_t width, uint32_t comp_id);
     bool decodeProgressiveDCBlock(JpegDecodeData *jpeg,
                                   int16_t decoded_data[64],
                                   HuffmanLookupTable *huffman_dc,
@@ -165,11 +234,16 @@ class JpegDecoder : public ImageDecoder {
     bool decodeProgressiveACBlock(JpegDecodeData *jpeg,
                                   int16_t decoded_data[64],
                                   HuffmanLookupTable *huffman_ac);
+    void skipToMarker(JpegDecodeData *jpeg);
+    void skipScan(JpegDecodeData *jpeg);
+    uint32_t skipRestartInterval(JpegDecodeData *jpeg, uint32_t index,
+                                 uint32_t units, uint32_t width, uint32_t x0,
+                                 uint32_t x1, uint32_t y0, uint32_t y1);
     bool parseEntropyCodedData(JpegDecodeData *jpeg);
     void dequantizeData(int16_t *data, uint16_t *dequant_table);
     void idctprocess1(JpegDecodeData *jpeg, uint32_t height_begin,
-                      uint32_t height_end, uint32_t width, uint32_t comp_id,
-                      uint32_t width2);
+                      uint32_t height_end, uint32_t width_begin,
+                      uint32_t width_end, uint32_t comp_id);
     void finishProgressiveJpeg(JpegDecodeData *jpeg);
     bool convertColor(int32_t stride, uint8_t* image);
 
@@ -177,7 +251,53 @@ class JpegDecoder : public ImageDecoder {
     BytesReader* file_data_;
     JpegDecodeData* jpeg_;
     YCrCb2BGR* ycrcb2bgr_;
-    uint32_t hardware_threads_;
+    // the maximal number of idct bands decoded concurrently.
+    int32_t num_threads_;
+    bool use_fma_;
+    uint32_t scale_;
+    // region-of-interest decoding, height_ and width_ are those of the region
+    // then, the window is the decoded part of the image around it.
+    bool roi_;
+    uint32_t image_height_, image_width_;
+    uint32_t roi_top_, roi_left_;
+    uint32_t window_height_, window_width_;
+    uint32_t offset_y_, offset_x_;
+};
+
+class JpegEncoder : public ImageEncoder {
+  public:
+    JpegEncoder(BytesWriter& file_data);
+    ~JpegEncoder();
+
+    bool setParameter(int32_t key, int32_t value) override;
+    bool encodeData(uint32_t height, uint32_t width, uint32_t channels,
+                    uint32_t depth, uint32_t stride,
+                    const uint8_t* image) override;
+
+  private:
+    void setQuantizationTables();
+    bool transformImage(uint32_t height, uint32_t width, uint32_t channels,
+                        uint32_t stride, const uint8_t* image);
+    void writeHeaders(uint32_t height, uint32_t width, uint32_t components);
+    void writeHuffmanTable(uint32_t table_class, uint32_t table_id,
+                           const HuffmanEncodeTable& table);
+    bool encodeBlocks(uint32_t components);
+
+  private:
+    BytesWriter* file_data_;
+    bool use_fma_;
+    int32_t quality_;
+    uint32_t hsampling_, vsampling_;
+    uint32_t mcus_x_, mcus_y_;
+    uint8_t quant_tables_[2][64];     // in natural order
+    float reciprocals_[2][64];
+    // quantized coefficients of all the blocks in zigzag order, mcu by mcu,
+    // and the frequencies of the symbols for the optimized huffman tables.
+    int16_t* coefficients_;
+    uint32_t dc_frequencies_[2][257];
+    uint32_t ac_frequencies_[2][257];
+    HuffmanEncodeTable huffman_dc_[2];
+    HuffmanEncodeTable huffman_ac_[2];
 };
 
 } //! namespace x86
@@ -21,8 +21,15 @@
 #include <limits.h>
 #include <string.h>
 #include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#include <algorithm>
 
 #include "ppl/cv/types.h"
+#include "ppl/cv/x86/imread.h"
+#include "ppl/cv/x86/imwrite.h"
 #include "ppl/common/log.h"
 
 using namespace ppl::common;
@@ -93,7 +100,10 @@ static const uint8_t default_length_sizes[SYMBOL_NUMBER] = {
     7, 7, 7, 7, 7, 7, 7, 7, 8, 8, 8, 8, 8, 8, 8, 8
 };
 
-static const uint32_t default_distance_sizes = 5;
+static const uint8_t default_distance_sizes[32] = {
+    5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5,
+    5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5
+};
 
 static const int length_base[31] = {
     3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59,
@@ -111,23 +121,63 @@ static const int distance_extra_bits[32] = {
     0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10,
     11, 11, 12, 12, 13, 13};
 
+// The order of the code length code lengths in a dynamic block header.
+static const uint8_t length_dezigzag[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5,
+                                           11, 4, 12, 3, 13, 2, 14, 1, 15};
+
+// Flags of the fast huffman table entries.
+#define ZLIB_LITERAL      0x2000
+#define ZLIB_TWO_LITERALS 0x4000
+#define ZLIB_EXCEPTIONAL  0x8000  // end of block, invalid or long code
+#define ZLIB_LONG_CODE    ZLIB_EXCEPTIONAL
+#define ZLIB_INVALID_CODE (ZLIB_EXCEPTIONAL | 0xFFFF0000)
+
+enum InflateStatus {
+    INFLATE_END_OF_BLOCK = 1,
+    INFLATE_OK = 0,
+    INFLATE_TRUNCATED_DATA = -1,
+    INFLATE_INVALID_LENGTH_CODE = -2,
+    INFLATE_INVALID_DISTANCE_CODE = -3,
+    INFLATE_INVALID_DISTANCE = -4,
+};
+
+// Shuffles repeating the first 2-7 bytes of a match in 16 bytes.
+static const uint8_t match_patterns[8][16] = {
+    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1},
+    {0, 1, 2, 0, 1, 2, 0, 1, 2, 0, 1, 2, 0, 1, 2, 0},
+    {0, 1, 2, 3, 0, 1, 2, 3, 0, 1, 2, 3, 0, 1, 2, 3},
+    {0, 1, 2, 3, 4, 0, 1, 2, 3, 4, 0, 1, 2, 3, 4, 0},
+    {0, 1, 2, 3, 4, 5, 0, 1, 2, 3, 4, 5, 0, 1, 2, 3},
+    {0, 1, 2, 3, 4, 5, 6, 0, 1, 2, 3, 4, 5, 6, 0, 1},
+};
+
 PngDecoder::PngDecoder(BytesReader& file_data) {
     file_data_ = &file_data;
     png_info_.palette_length = 0;
     png_info_.palette = nullptr;
     png_info_.chunk_status = 0;
+    png_info_.window_buffer = nullptr;
     encoded_channels_ = 0;
+    roi_top_  = 0;
+    roi_left_ = 0;
 
     file_data_->setCrcChecking(&crc32_);
     png_info_.fixed_huffman_done = false;
     png_info_.header_after_idat = false;
-    // crc32_.turnOff();
+    if (!GetImdecodeVerifyChecksums()) {
+        crc32_.turnOff();
+    }
 }
 
 PngDecoder::~PngDecoder() {
     if (png_info_.palette != nullptr) {
         delete [] png_info_.palette;
     }
+    if (png_info_.window_buffer != nullptr) {
+        free(png_info_.window_buffer);
+    }
 
     file_data_->unsetCrcChecking();
 }
@@ -222,6 +272,8 @@ bool PngDecoder::parseIHDR(PngInfo& png_info) {
         encoded_channels_ = 4;
     }
 
+    image_height_ = height_;
+    image_width_  = width_;
     if (width_ * channels_ * height_ > MAX_IMAGE_SIZE) {
         LOG(ERROR) << "The target image: " << width_ << " * " << channels_
                    << " * " << height_ << ", it is too large to be decoded.";
@@ -567,7 +619,8 @@ bool PngDecoder::parsePLTE(PngInfo& png_info) {
 
     uint32_t length = png_info.current_chunk.length / 3;
     png_info.palette_length = length;
-    png_info.palette = new uint8_t[1024];
+    // expandPalette() loads 16 bytes from the last entry.
+    png_info.palette = new uint8_t[1024 + 12];
     uint8_t value0, value1, value2;
     for (uint32_t index = 0; index < length * 4; index += 4) {
         value0 = file_data_->getByte();
@@ -734,8 +787,7 @@ bool PngDecoder::parsebKGD(PngInfo& png_info) {
 }
 
 // This function processes one or more IDAT chunk.
-bool PngDecoder::parseIDATs(PngInfo& png_info, uint8_t* image,
-                            uint32_t stride) {
+bool PngDecoder::parseIDATs(PngInfo& png_info) {
     if (color_type_ == INDEXED_COLOR &&
         (!(png_info.chunk_status & HAVE_PLTE))) {
         LOG(ERROR) << "A color palette chunk is needed for indexed color, but "
@@ -752,10 +804,40 @@ bool PngDecoder::parseIDATs(PngInfo& png_info, uint8_t* image,
         if (!succeeded) return false;
     }
 
-    succeeded = inflateImage(png_info, image, stride);
-    if (!succeeded) return false;
-    // skipping 32 bits of the optional ADLER32 checksum in zlib data stream.
+    // an IDAT chunk after the final block only holds the rest of ADLER32.
+    ZlibBuffer &zlib_buffer = png_info.zlib_buffer;
+    if (!zlib_buffer.is_final_block) {
+        succeeded = inflateImage(png_info);
+        if (!succeeded) return false;
+
+        // the ADLER32 checksum starts at the byte boundary after the final
+        // block, its leading bytes may be in the bit buffer already.
+        if (zlib_buffer.bit_number <= 64) {
+            uint32_t ignored_bits = zlib_buffer.bit_number & 7;
+            zlib_buffer.code_buffer >>= ignored_bits;
+            zlib_buffer.bit_number   -= ignored_bits;
+            while (zlib_buffer.bit_number > 0 &&
+                   zlib_buffer.adler32_bytes < 4) {
+                zlib_buffer.transmitted_adler32 =
+                    (zlib_buffer.transmitted_adler32 << 8) |
+                    (uint8_t)zlib_buffer.code_buffer;
+                zlib_buffer.code_buffer >>= 8;
+                zlib_buffer.bit_number   -= 8;
+                zlib_buffer.adler32_bytes++;
+            }
+        }
+    }
+    // reading the rest of the ADLER32 checksum in zlib data stream, and
+    // skipping the bytes after it.
     if (png_info.current_chunk.type == png_IDAT) {
+        while (zlib_buffer.adler32_bytes < 4 &&
+               png_info.current_chunk.length > 0) {
+            zlib_buffer.transmitted_adler32 =
+                (zlib_buffer.transmitted_adler32 << 8) |
+                (uint8_t)file_data_->getByte();
+            png_info.current_chunk.length -= 1;
+            zlib_buffer.adler32_bytes++;
+        }
         file_data_->skipBytes(png_info.current_chunk.length);
     }
 
@@ -803,7 +885,14 @@ bool PngDecoder::parsetUnknownChunk(PngInfo& png_info) {
         bool succeeded = setCrc32();
         if (!succeeded) return false;
 
-        file_data_->skipBytes(png_info.current_chunk.length);
+        // without crc checking, this is where a corrupt length is caught.
+        succeeded = file_data_->skipBytes(png_info.current_chunk.length);
+        if (!succeeded) {
+            LOG(ERROR) << "The chunk " << chunk_name << " with "
+                       << png_info.current_chunk.length
+                       << " bytes runs beyond the end of the data.";
+            return false;
+        }
         // LOG(INFO) << "Encountering an unknown ancillary chunk: " << chunk_name;
 
         png_info.current_chunk.crc = file_data_->getDWordBigEndian();
@@ -866,8 +955,12 @@ bool PngDecoder::isCrcCorrect() {
 }
 
 bool PngDecoder::parseDeflateHeader() {
-    uint8_t cmf = file_data_->getByte();
-    uint8_t flags = file_data_->getByte();
+    // the header is read through the bit buffer like the rest of the stream,
+    // it may be split across IDAT chunks.
+    ZlibBuffer &zlib_buffer = png_info_.zlib_buffer;
+    uint32_t cmf = getNumber(&zlib_buffer, 8);
+    uint32_t flags = getNumber(&zlib_buffer, 8);
+    if (cmf == UINT32_MAX || flags == UINT32_MAX) return false;
     uint32_t compression_method = cmf & 15;
     uint32_t compresson_info = (cmf >> 4) & 15;
     if (compression_method != 8 ||
@@ -887,15 +980,20 @@ bool PngDecoder::parseDeflateHeader() {
                    << "specification.";
         return false;
     }
-    png_info_.current_chunk.length -= 2;
-    png_info_.zlib_buffer.window_size = 1 << (compresson_info + 8);
+    zlib_buffer.window_size = 1 << (compresson_info + 8);
 
     return true;
 }
 
 bool PngDecoder::fillBits(ZlibBuffer *zlib_buffer) {
+    // the bits after the data in the last IDAT chunk read as zeros.
+    if (png_info_.header_after_idat) {
+        return true;
+    }
+
     uint64_t segment;
-    if (png_info_.current_chunk.length > 8) {
+    if (png_info_.current_chunk.length > 8 &&
+        file_data_->getValidSize() >= sizeof(uint64_t)) {
         memcpy(&segment, file_data_->getCurrentPosition(), sizeof(uint64_t));
 
         zlib_buffer->code_buffer |= segment << zlib_buffer->bit_number;
@@ -953,17 +1051,11 @@ bool PngDecoder::parseZlibUncompressedBlock(PngInfo& png_info) {
     if (ignored_bits) {
         getNumber(&zlib_buffer, ignored_bits);
     }
-    uint32_t index = 0;
-    while (zlib_buffer.bit_number > 0 && index < 4) {
-        header[index++] = (uint8_t)(zlib_buffer.code_buffer & 255);
-        zlib_buffer.code_buffer >>= 8;
-        zlib_buffer.bit_number -= 8;
-    }
-    if (zlib_buffer.bit_number == 0 && index < 4) {
-        while (index < 4) {
-            header[index++] = file_data_->getByte();
-            png_info_.current_chunk.length -= 1;
-        }
+    // LEN and NLEN may be split across IDAT chunks too.
+    for (uint32_t index = 0; index < 4; index++) {
+        uint32_t value = getNumber(&zlib_buffer, 8);
+        if (value == UINT32_MAX) return false;
+        header[index] = (uint8_t)value;
     }
     uint32_t len  = header[1] * 256 + header[0];
     uint32_t nlen = header[3] * 256 + header[2];
@@ -971,35 +1063,29 @@ bool PngDecoder::parseZlibUncompressedBlock(PngInfo& png_info) {
         LOG(ERROR) << "Non-compressed block in zlib is corrupt.";
         return false;
     }
-    if (png_info.decompressed_image + len > png_info.decompressed_image_end) {
-        LOG(ERROR) << "No space stores decompressed blocks in zlib.";
-        return false;
-    }
 
-    if (zlib_buffer.bit_number > 0) {
-        uint32_t size = zlib_buffer.bit_number >> 3;
-        memcpy(png_info.decompressed_image, &(zlib_buffer.code_buffer), size);
-        png_info.decompressed_image += size;
+    bool succeeded;
+    if (png_info.decompressed_image + 8 > png_info.decompressed_image_end) {
+        succeeded = flushScanlines(png_info);
+        if (!succeeded) return false;
+    }
+    while (zlib_buffer.bit_number > 0 && len > 0) {
+        *png_info.decompressed_image++ = (uint8_t)zlib_buffer.code_buffer;
+        zlib_buffer.code_buffer >>= 8;
+        zlib_buffer.bit_number -= 8;
+        len--;
+    }
+    // fillBits() may leave the bytes following the valid bits in the buffer,
+    // which are read from the file now.
+    if (zlib_buffer.bit_number == 0) {
         zlib_buffer.code_buffer = 0;
-        zlib_buffer.bit_number = 0;
-        len -= size;
     }
 
-    do {
-        if (len <= png_info.current_chunk.length) {
-            file_data_->getBytes(png_info.decompressed_image, len);
-            png_info.decompressed_image += len;
-            png_info.current_chunk.length -= len;
-            len = 0;
-        }
-        else {
-            file_data_->getBytes(png_info.decompressed_image,
-                                 png_info.current_chunk.length);
-            png_info.decompressed_image += png_info.current_chunk.length;
-            len -= png_info.current_chunk.length;
-
+    uint32_t size;
+    while (len > 0) {
+        if (png_info.current_chunk.length == 0) {
             png_info_.current_chunk.crc = file_data_->getDWordBigEndian();
-            bool succeeded = isCrcCorrect();
+            succeeded = isCrcCorrect();
             if (!succeeded) return false;
 
             getChunkHeader(png_info_);
@@ -1012,7 +1098,21 @@ bool PngDecoder::parseZlibUncompressedBlock(PngInfo& png_info) {
                 return true;
             }
         }
-    } while (len > 0);
+        if (png_info.decompressed_image == png_info.decompressed_image_end) {
+            succeeded = flushScanlines(png_info);
+            if (!succeeded) return false;
+        }
+
+        size = png_info.decompressed_image_end - png_info.decompressed_image;
+        if (size > len) size = len;
+        if (size > png_info.current_chunk.length) {
+            size = png_info.current_chunk.length;
+        }
+        file_data_->getBytes(png_info.decompressed_image, size);
+        png_info.decompressed_image += size;
+        png_info.current_chunk.length -= size;
+        len -= size;
+    }
 
     return true;
 }
@@ -1037,12 +1137,69 @@ static int32_t reverse16Bits(uint16_t input) {
     return input;
 }
 
+static uint32_t createEntry(HuffmanTypes type, int32_t symbol, uint32_t size) {
+    uint32_t entry = size | (size << 5);
+    if (type == LITERAL_LENGTH_CODES) {
+        if (symbol < 256) {
+            entry |= ZLIB_LITERAL | ((uint32_t)symbol << 16);
+        }
+        else if (symbol == 256 || symbol > 285) {
+            entry |= ZLIB_EXCEPTIONAL | ((uint32_t)symbol << 16);
+        }
+        else {
+            uint32_t extra_bits = length_extra_bits[symbol - 257];
+            entry += extra_bits | (extra_bits << 9) |
+                     ((uint32_t)length_base[symbol - 257] << 16);
+        }
+    }
+    else if (type == DISTANCE_CODES) {
+        if (symbol >= 30) {
+            entry |= ZLIB_EXCEPTIONAL | ((uint32_t)symbol << 16);
+        }
+        else {
+            uint32_t extra_bits = distance_extra_bits[symbol];
+            entry += extra_bits | (extra_bits << 9) |
+                     ((uint32_t)distance_base[symbol] << 16);
+        }
+    }
+    else {
+        entry |= (uint32_t)symbol << 16;
+    }
+
+    return entry;
+}
+
+// Two literals whose codes fit in the fast bits together share an entry. The
+// entry of the second one is looked up with the bits after the first code,
+// it is still a single literal as the table is rewritten from the end.
+static void pairLiterals(ZlibHuffman *huffman_coding) {
+    uint32_t* fast = huffman_coding->fast;
+    for (int32_t i = (1 << ZLIB_FAST_BITS) - 1; i >= 0; --i) {
+        uint32_t first = fast[i];
+        if (!(first & ZLIB_LITERAL)) continue;
+
+        uint32_t first_size = first & 31;
+        uint32_t second = fast[i >> first_size];
+        uint32_t second_size = second & 31;
+        if (!(second & ZLIB_LITERAL) ||
+            first_size + second_size > ZLIB_FAST_BITS) {
+            continue;
+        }
+        fast[i] = (first_size + second_size) | (first_size << 5) |
+                  ZLIB_LITERAL | ZLIB_TWO_LITERALS | (first & 0x00FF0000) |
+                  ((second & 0x00FF0000) << 8);
+    }
+}
+
 bool PngDecoder::buildHuffmanCode(ZlibHuffman *huffman_coding,
-                                  const uint8_t *size_list, int32_t number) {
+                                  const uint8_t *size_list, int32_t number,
+                                  HuffmanTypes type) {
     int32_t i, code = 0, next_code[16], sizes[17];
 
     memset(sizes, 0, sizeof(sizes));
-    memset(huffman_coding->fast, 0, sizeof(huffman_coding->fast));
+    for (i = 0; i < (1 << ZLIB_FAST_BITS); ++i) {
+        huffman_coding->fast[i] = ZLIB_LONG_CODE;
+    }
     for (i = 0; i < number; ++i) {
         ++sizes[size_list[i]];
     }
@@ -1077,93 +1234,42 @@ bool PngDecoder::buildHuffmanCode(ZlibHuffman *huffman_coding,
         if (size) {
             int index = next_code[size] - huffman_coding->first_code[size] +
                         huffman_coding->first_symbol[size];
-            uint16_t fast_value = (uint16_t) ((size << 9) | i);
+            uint32_t entry = createEntry(type, i, size);
             huffman_coding->size [index] = (uint8_t)size;
-            huffman_coding->value[index] = (uint16_t)i;
+            huffman_coding->entry[index] = entry;
             if (size <= ZLIB_FAST_BITS) {
                 int32_t j = reverseBits(next_code[size], size);
                 while (j < (1 << ZLIB_FAST_BITS)) {
-                    huffman_coding->fast[j] = fast_value;
+                    huffman_coding->fast[j] = entry;
                     j += (1 << size);
                 }
             }
             ++next_code[size];
         }
     }
-
-    return true;
-}
-
-bool PngDecoder::buildHuffmanCode(ZlibHuffman *huffman_coding,
-                                  const uint32_t size, int32_t number) {
-    int32_t i, code = 0, next_code[16], sizes[17];
-
-    memset(sizes, 0, sizeof(sizes));
-    memset(huffman_coding->fast, 0, sizeof(huffman_coding->fast));
-    for (i = 0; i < number; ++i) {
-        ++sizes[size];
-    }
-    sizes[0] = 0;
-    for (i = 1; i < 16; ++i) {
-        if (sizes[i] > (1 << i)) {
-            LOG(ERROR) << "The size of code lengths in huffman is wrong.";
-            return false;
-        }
-    }
-
-    uint32_t symbol = 0;
-    for (i = 1; i < 16; ++i) {
-        next_code[i] = code;
-        huffman_coding->first_code[i]   = (uint16_t)code;
-        huffman_coding->first_symbol[i] = (uint16_t)symbol;
-        code = (code + sizes[i]);
-        if (sizes[i]) {
-            if (code - 1 >= (1 << i)) {
-                LOG(ERROR) << "The code lengths of huffman are wrong.";
-                return false;
-            }
-        }
-        huffman_coding->max_code[i] = code << (16 - i);
-        code <<= 1;
-        symbol += sizes[i];
-    }
-
-    huffman_coding->max_code[16] = 0x10000;
-    for (i = 0; i < number; ++i) {
-        int index = next_code[size] - huffman_coding->first_code[size] +
-                    huffman_coding->first_symbol[size];
-        uint16_t fast_value = (uint16_t) ((size << 9) | i);
-        huffman_coding->size [index] = (uint8_t)size;
-        huffman_coding->value[index] = (uint16_t)i;
-        if (size <= ZLIB_FAST_BITS) {
-            int32_t j = reverseBits(next_code[size], size);
-            while (j < (1 << ZLIB_FAST_BITS)) {
-                huffman_coding->fast[j] = fast_value;
-                j += (1 << size);
-            }
-        }
-        ++next_code[size];
+    if (type == LITERAL_LENGTH_CODES) {
+        pairLiterals(huffman_coding);
     }
 
     return true;
 }
 
-int32_t PngDecoder::huffmanDecodeSlowly(ZlibBuffer *zlib_buffer,
-                                        ZlibHuffman *huffman_coding) {
-    int32_t bits, size, index;
-    bits = reverse16Bits((uint16_t)(zlib_buffer->code_buffer & 0xFFFF));
-    for (size = ZLIB_FAST_BITS + 1; ; ++size) {
-        if (bits < huffman_coding->max_code[size]) break;
-    }
-    if (size >= 16) return -1; // invalid code!
-    index = (bits >> (16 - size)) - huffman_coding->first_code[size] +
-            huffman_coding->first_symbol[size];
-    if (index >= SYMBOL_NUMBER) return -1;
-    if (huffman_coding->size[index] != size) return -1;
-    zlib_buffer->code_buffer >>= size;
-    zlib_buffer->bit_number   -= size;
+// The entry of a code longer than ZLIB_FAST_BITS.
+static inline
+uint32_t decodeLongCode(const ZlibHuffman *huffman_coding,
+                        uint64_t code_buffer) {
+    int32_t bits = reverse16Bits((uint16_t)(code_buffer & 0xFFFF));
+    int32_t size = ZLIB_FAST_BITS + 1;
+    while (bits >= huffman_coding->max_code[size]) {
+        ++size;
+    }
+    if (size >= 16) return ZLIB_INVALID_CODE;
+    int32_t index = (bits >> (16 - size)) - huffman_coding->first_code[size] +
+                    huffman_coding->first_symbol[size];
+    if (index >= SYMBOL_NUMBER) return ZLIB_INVALID_CODE;
+    if (huffman_coding->size[index] != size) return ZLIB_INVALID_CODE;
 
-    return huffman_coding->value[index];
+    return huffman_coding->entry[index];
 }
 
 int32_t PngDecoder::huffmanDecode(ZlibBuffer *zlib_buffer,
@@ -1172,23 +1278,19 @@ int32_t PngDecoder::huffmanDecode(ZlibBuffer *zlib_buffer,
         fillBits(zlib_buffer);
     }
 
-    uint32_t fast_bits, size;
-    fast_bits = huffman_coding->fast[zlib_buffer->code_buffer & ZLIB_FAST_MASK];
-    if (fast_bits) {
-        size = fast_bits >> 9;
-        zlib_buffer->code_buffer >>= size;
-        zlib_buffer->bit_number   -= size;
-        return fast_bits & 511;
+    uint64_t code_buffer = zlib_buffer->code_buffer;
+    uint32_t entry = huffman_coding->fast[code_buffer & ZLIB_FAST_MASK];
+    if (entry == ZLIB_LONG_CODE) {
+        entry = decodeLongCode(huffman_coding, code_buffer);
     }
+    uint32_t size = (entry >> 5) & 15;
+    if (size == 0 || size > zlib_buffer->bit_number) return -1;
+    zlib_buffer->code_buffer >>= size;
+    zlib_buffer->bit_number   -= size;
 
-    int32_t value = huffmanDecodeSlowly(zlib_buffer, huffman_coding);
-
-    return value;
+    return entry >> 16;
 }
-
 bool PngDecoder::computeDynamicHuffman(ZlibBuffer* zlib_buffer) {
-    const uint8_t length_dezigzag[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5,
-                                         11, 4, 12, 3, 13, 2, 14, 1, 15 };
     uint8_t length_codes[286 + 32 + 137];  //padding for maximum single op
     uint8_t codelength_sizes[19];
 
@@ -1204,7 +1306,8 @@ bool PngDecoder::computeDynamicHuffman(ZlibBuffer* zlib_buffer) {
     }
 
     ZlibHuffman code_length;
-    bool succeeded = buildHuffmanCode(&code_length, codelength_sizes, 19);
+    bool succeeded = buildHuffmanCode(&code_length, codelength_sizes, 19,
+                                      CODE_LENGTH_CODES);
     if (!succeeded) return false;
 
     uint32_t number = 0;
@@ -1253,112 +1356,275 @@ bool PngDecoder::computeDynamicHuffman(ZlibBuffer* zlib_buffer) {
     }
 
     succeeded = buildHuffmanCode(&zlib_buffer->length_huffman, length_codes,
-                                 hlit);
+                                 hlit, LITERAL_LENGTH_CODES);
     if (!succeeded) return false;
 
     succeeded = buildHuffmanCode(&zlib_buffer->distance_huffman,
-                                 length_codes + hlit, hdist);
+                                 length_codes + hlit, hdist, DISTANCE_CODES);
     if (!succeeded) return false;
 
     return true;
 }
 
+// Copies a match of 3-258 bytes 16 bytes a time, which overruns the match by
+// 15 bytes at most. A distance below 16 repeats a pattern of the period.
+static inline
+void copyMatch(uint8_t* output, uint32_t distance, uint32_t length) {
+    const uint8_t* source = output - distance;
+    uint8_t* end = output + length;
+    if (distance >= 16) {
+        do {
+            __m128i value = _mm_loadu_si128((__m128i*)source);
+            _mm_storeu_si128((__m128i*)output, value);
+            source += 16;
+            output += 16;
+        } while (output < end);
+    }
+    else if (distance == 1) {  // run of one byte, common in images.
+        __m128i value = _mm_set1_epi8((char)source[0]);
+        do {
+            _mm_storeu_si128((__m128i*)output, value);
+            output += 16;
+        } while (output < end);
+    }
+    else if (distance >= 8) {
+        uint64_t value;
+        do {
+            memcpy(&value, source, sizeof(uint64_t));
+            memcpy(output, &value, sizeof(uint64_t));
+            source += 8;
+            output += 8;
+        } while (output < end);
+    }
+    else {
+        __m128i value = _mm_loadu_si128((__m128i*)source);
+        value = _mm_shuffle_epi8(value, _mm_loadu_si128(
+                                 (__m128i*)match_patterns[distance]));
+        uint32_t step = 16 - 16 % distance;
+        do {
+            _mm_storeu_si128((__m128i*)output, value);
+            output += step;
+        } while (output < end);
+    }
+}
+
+// Decodes a length/distance pair with the entry of the length code and copies
+// the match, 48 bits in the buffer cover the longest codes and extra bits.
+static inline
+int32_t decodeMatch(const ZlibBuffer* zlib_buffer, uint32_t entry,
+                    uint64_t &code_buffer, uint32_t &bit_number,
+                    uint8_t* &output, const uint8_t* window_start) {
+    uint32_t code_size  = (entry >> 5) & 15;
+    uint32_t size       = entry & 31;
+    uint32_t extra_bits = (entry >> 9) & 15;
+    if (size > bit_number) return INFLATE_TRUNCATED_DATA;
+    uint32_t length = (entry >> 16) + ((uint32_t)(code_buffer >> code_size) &
+                                       ((1 << extra_bits) - 1));
+    code_buffer >>= size;
+    bit_number   -= size;
+
+    const ZlibHuffman* distance_huffman = &zlib_buffer->distance_huffman;
+    entry = distance_huffman->fast[code_buffer & ZLIB_FAST_MASK];
+    if (entry == ZLIB_LONG_CODE) {
+        entry = decodeLongCode(distance_huffman, code_buffer);
+    }
+    if (entry & ZLIB_EXCEPTIONAL) return INFLATE_INVALID_DISTANCE_CODE;
+    code_size  = (entry >> 5) & 15;
+    size       = entry & 31;
+    extra_bits = (entry >> 9) & 15;
+    if (size > bit_number) return INFLATE_TRUNCATED_DATA;
+    uint32_t distance = (entry >> 16) + ((uint32_t)(code_buffer >> code_size) &
+                                         ((1 << extra_bits) - 1));
+    code_buffer >>= size;
+    bit_number   -= size;
+    if (distance > (uint32_t)(output - window_start) ||
+        distance > zlib_buffer->window_size) {
+        return INFLATE_INVALID_DISTANCE;
+    }
+    copyMatch(output, distance, length);
+    output += length;
+
+    return INFLATE_OK;
+}
+
+// Decodes a literal, a match or the end of the block with the entry of the
+// next bits.
+static
+int32_t decodeSymbol(const ZlibBuffer* zlib_buffer, uint32_t entry,
+                     uint64_t &code_buffer, uint32_t &bit_number,
+                     uint8_t* &output, const uint8_t* window_start) {
+    if (entry == ZLIB_LONG_CODE) {
+        entry = decodeLongCode(&zlib_buffer->length_huffman, code_buffer);
+    }
+    if (!(entry & (ZLIB_LITERAL | ZLIB_EXCEPTIONAL))) {
+        return decodeMatch(zlib_buffer, entry, code_buffer, bit_number, output,
+                           window_start);
+    }
+
+    uint32_t size = (entry >> 5) & 15;
+    if (size > bit_number) return INFLATE_TRUNCATED_DATA;
+    if (entry & ZLIB_LITERAL) {
+        *output++ = (uint8_t)(entry >> 16);
+        code_buffer >>= size;
+        bit_number   -= size;
+        return INFLATE_OK;
+    }
+    if ((entry >> 16) == 256 && size) {
+        code_buffer >>= size;
+        bit_number   -= size;
+        return INFLATE_END_OF_BLOCK;
+    }
+
+    return INFLATE_INVALID_LENGTH_CODE;
+}
+
+// Decodes while more than 8 bytes of the IDAT chunk are left, so that the bit
+// buffer is refilled with one unaligned load per match or 3 literal entries,
+// and the output is below output_limit.
+int32_t PngDecoder::inflateFast(ZlibBuffer *zlib_buffer, uint8_t* &output,
+                                uint8_t* output_limit) {
+    if (png_info_.header_after_idat) return INFLATE_OK;
+    uint32_t input_size = std::min(png_info_.current_chunk.length,
+                                   file_data_->getValidSize());
+    if (input_size <= 8) return INFLATE_OK;
+
+    const uint8_t* input_start = file_data_->getCurrentPosition();
+    const uint8_t* input = input_start;
+    const uint8_t* input_limit = input_start + input_size - 8;
+    const uint32_t* length_table = zlib_buffer->length_huffman.fast;
+    const uint32_t* distance_table = zlib_buffer->distance_huffman.fast;
+    const uint8_t* window_start = png_info_.decompressed_image_start;
+    uint64_t code_buffer = zlib_buffer->code_buffer;
+    uint32_t bit_number  = zlib_buffer->bit_number;
+    uint64_t segment;
+    int32_t status = INFLATE_OK;
+
+    while (input < input_limit && output <= output_limit) {
+        memcpy(&segment, input, sizeof(uint64_t));
+        code_buffer |= segment << bit_number;
+        input += 7 - ((bit_number >> 3) & 7);
+        bit_number |= 56;
+
+        uint32_t entry = length_table[code_buffer & ZLIB_FAST_MASK];
+        if (entry & ZLIB_LITERAL) {
+            // a literal entry takes ZLIB_FAST_BITS bits at most.
+            for (int32_t i = 0; i < 3 && (entry & ZLIB_LITERAL); i++) {
+                uint16_t literals = (uint16_t)(entry >> 16);
+                memcpy(output, &literals, sizeof(uint16_t));
+                output += 1 + ((entry >> 14) & 1);
+                code_buffer >>= entry & 31;
+                bit_number   -= entry & 31;
+                entry = length_table[code_buffer & ZLIB_FAST_MASK];
+            }
+            continue;
+        }
+
+        if (entry & ZLIB_EXCEPTIONAL) {
+            status = decodeSymbol(zlib_buffer, entry, code_buffer, bit_number,
+                                  output, window_start);
+            if (status != INFLATE_OK) break;
+            continue;
+        }
+
+        // decodeMatch() without the checks of the bits left.
+        uint32_t extra_bits = (entry >> 9) & 15;
+        uint32_t length = (entry >> 16) + ((uint32_t)(code_buffer >>
+                          ((entry >> 5) & 15)) & ((1 << extra_bits) - 1));
+        code_buffer >>= entry & 31;
+        bit_number   -= entry & 31;
+
+        entry = distance_table[code_buffer & ZLIB_FAST_MASK];
+        if (entry == ZLIB_LONG_CODE) {
+            entry = decodeLongCode(&zlib_buffer->distance_huffman,
+                                   code_buffer);
+        }
+        if (entry & ZLIB_EXCEPTIONAL) {
+            status = INFLATE_INVALID_DISTANCE_CODE;
+            break;
+        }
+        extra_bits = (entry >> 9) & 15;
+        uint32_t distance = (entry >> 16) + ((uint32_t)(code_buffer >>
+                            ((entry >> 5) & 15)) & ((1 << extra_bits) - 1));
+        code_buffer >>= entry & 31;
+        bit_number   -= entry & 31;
+        if (distance > (uint32_t)(output - window_start) ||
+            distance > zlib_buffer->window_size) {
+            status = INFLATE_INVALID_DISTANCE;
+            break;
+        }
+        copyMatch(output, distance, length);
+        output += length;
+    }
+
+    zlib_buffer->code_buffer = code_buffer;
+    zlib_buffer->bit_number  = bit_number;
+    uint32_t consumed_bytes = input - input_start;
+    file_data_->skipBytes(consumed_bytes);
+    png_info_.current_chunk.length -= consumed_bytes;
+
+    return status;
+}
+
 bool PngDecoder::decodeHuffmanData(ZlibBuffer* zlib_buffer) {
     uint8_t *output = png_info_.decompressed_image;
-    uint32_t rounded_length;
+    // a match is 258 bytes at most, its overrun lands in the padding.
+    uint8_t *flush_limit = png_info_.decompressed_image_end - 258;
+    int32_t status;
 
     while (1) {
-        int32_t value = huffmanDecode(zlib_buffer,
-                                      &zlib_buffer->length_huffman);
-        if (value < 256) {
-            if (value < 0) {
-                LOG(ERROR) << "Invalid decoded literal/length code: " << value
-                           << ", valid value: 0-285.";
-                return false;
-            }
-            *output++ = (uint8_t)value;
-        } else {
-            uint32_t length, distance;
-            if (value == 256) {
-                png_info_.decompressed_image = output;
-                return true;
-            }
-            value -= 257;
-            length = length_base[value];
-            if (length_extra_bits[value]) {
-                length += getNumber(zlib_buffer, length_extra_bits[value]);
-            }
-            if (png_info_.decompressed_image_end - output < length) {
-                LOG(ERROR) << "Invalid decoded length: " << length
-                           << ", valid value: 0-"
-                           << png_info_.decompressed_image_end - output;
-                return false;
-            }
-            value = huffmanDecode(zlib_buffer, &zlib_buffer->distance_huffman);
-            if (value < 0) {
-                LOG(ERROR) << "Invalid decoded distance code: " << value
-                           << ", valid value: 0-31.";
-                return false;
+        if (output > flush_limit) {
+            png_info_.decompressed_image = output;
+            bool succeeded = flushScanlines(png_info_);
+            if (!succeeded) return false;
+            output = png_info_.decompressed_image;
+        }
+
+        status = inflateFast(zlib_buffer, output, flush_limit);
+        if (status == INFLATE_OK && output <= flush_limit) {
+            // one symbol a time across the end of the IDAT chunk.
+            if (zlib_buffer->bit_number < 48) {
+                bool succeeded = fillBits(zlib_buffer);
+                if (!succeeded) return false;
             }
-            distance = distance_base[value];
-            if (distance_extra_bits[value]) {
-                distance += getNumber(zlib_buffer, distance_extra_bits[value]);
+            uint32_t entry = zlib_buffer->length_huffman.fast[
+                                 zlib_buffer->code_buffer & ZLIB_FAST_MASK];
+            status = decodeSymbol(zlib_buffer, entry, zlib_buffer->code_buffer,
+                                  zlib_buffer->bit_number, output,
+                                  png_info_.decompressed_image_start);
+        }
+        if (status == INFLATE_END_OF_BLOCK) {
+            png_info_.decompressed_image = output;
+            return true;
+        }
+        if (status != INFLATE_OK) {
+            if (status == INFLATE_TRUNCATED_DATA) {
+                LOG(ERROR) << "The compressed data ends in a huffman code.";
             }
-            if (output - png_info_.decompressed_image_start < distance) {
-                LOG(ERROR) << "Invalid decoded distance: " << distance
-                           << ", valid value: 0-"
-                           << output - png_info_.decompressed_image_start;
-                return false;
+            else if (status == INFLATE_INVALID_LENGTH_CODE) {
+                LOG(ERROR) << "Invalid decoded literal/length code, valid "
+                           << "value: 0-285.";
             }
-            if (distance > zlib_buffer->window_size) {
-                LOG(ERROR) << "Invalid decoded distance: " << distance
-                           << ", valid value: 0-" << zlib_buffer->window_size;
-                return false;
+            else if (status == INFLATE_INVALID_DISTANCE_CODE) {
+                LOG(ERROR) << "Invalid decoded distance code, valid value: "
+                           << "0-29.";
             }
-            uint8_t *copy_address = (uint8_t *) (output - distance);
-            if (distance == 1) {  // run of one byte, common in images.
-                uint8_t source = *copy_address;
-                if (output + length + 8 < png_info_.decompressed_image_end) {
-                    rounded_length = (length + 7) & -8;
-                    memset(output, source, rounded_length);
-                }
-                else {
-                    memset(output, source, length);
-                }
-                output += length;
-            } else {
-                if (distance >= length) {
-                    if (output + length + 8 <
-                        png_info_.decompressed_image_end) {
-                        rounded_length = (length + 7) & -8;
-                        memcpy(output, copy_address, rounded_length);
-                    }
-                    else {
-                        memcpy(output, copy_address, length);
-                    }
-                    output += length;
-                }
-                else {  // 2 <= distance < length
-                    if (length) {
-                        do {
-                            *output++ = *copy_address++;
-                        } while (--length);
-                    }
-                }
+            else {
+                LOG(ERROR) << "Invalid decoded distance, it is beyond the "
+                           << "window or the inflated data.";
             }
+            return false;
         }
     }
 }
 
-bool PngDecoder::inflateImage(PngInfo& png_info, uint8_t* image,
-                              uint32_t stride) {
-    if (png_info.current_chunk.length == 0) {
+bool PngDecoder::inflateImage(PngInfo& png_info) {
+    ZlibBuffer &zlib_buffer = png_info.zlib_buffer;
+    if (png_info.current_chunk.length == 0 && zlib_buffer.bit_number == 0) {
         LOG(ERROR) << "No data in the IDAT chunk is needed to be decompressed.";
         return false;
     }
 
     bool succeeded;
-    ZlibBuffer &zlib_buffer = png_info.zlib_buffer;
     do {
         zlib_buffer.is_final_block = getNumber(&zlib_buffer, 1);
         zlib_buffer.encoding_method = (EncodingMethod)getNumber(&zlib_buffer,
@@ -1372,10 +1638,11 @@ bool PngDecoder::inflateImage(PngInfo& png_info, uint8_t* image,
             case STATIC_HUFFMAN:
                 if (!png_info.fixed_huffman_done) {
                     succeeded = buildHuffmanCode(&zlib_buffer.length_huffman,
-                                  default_length_sizes, SYMBOL_NUMBER);
+                                  default_length_sizes, SYMBOL_NUMBER,
+                                  LITERAL_LENGTH_CODES);
                     if (!succeeded) return false;
                     succeeded = buildHuffmanCode(&zlib_buffer.distance_huffman,
-                                  default_distance_sizes, 32);
+                                  default_distance_sizes, 32, DISTANCE_CODES);
                     if (!succeeded) return false;
                     png_info.fixed_huffman_done = true;
                 }
@@ -1385,6 +1652,7 @@ bool PngDecoder::inflateImage(PngInfo& png_info, uint8_t* image,
             case DYNAMIC_HUFFMAN:
                 succeeded = computeDynamicHuffman(&zlib_buffer);
                 if (!succeeded) return false;
+                png_info.fixed_huffman_done = false;
 
                 succeeded = decodeHuffmanData(&zlib_buffer);
                 if (!succeeded) return false;
@@ -1394,7 +1662,7 @@ bool PngDecoder::inflateImage(PngInfo& png_info, uint8_t* image,
                            << (uint32_t)zlib_buffer.encoding_method
                            << ", valid values: stored section(0)/"
                            << "static huffman(1)/dynamic huffman(2).";
-                break;
+                return false;
         }
 
     } while (!zlib_buffer.is_final_block);
@@ -1430,30 +1698,16 @@ void rowDefilter1C2(uint8_t* input_row, uint32_t row_bytes,
     }
 }
 
+// The rows are padded, the last 16 bytes may pass the end of the row.
 inline
 void rowDefilter2(uint8_t* input_row, uint8_t* prior_row, uint32_t row_bytes,
-                  uint8_t* recon_row, bool overflowed) {
-    uint32_t i = 0;
-    row_bytes -= 16;
-    for (; i < row_bytes; i+= 16) {
-        __m128i input_data = _mm_loadu_si128((__m128i*)(input_row + i));
-        __m128i prior_data = _mm_loadu_si128((__m128i*)(prior_row + i));
-        __m128i current_data = _mm_add_epi8(input_data, prior_data);
-        _mm_storeu_si128((__m128i*)(recon_row + i), current_data);
-    }
-
-    if (overflowed) {
+                  uint8_t* recon_row) {
+    for (uint32_t i = 0; i < row_bytes; i += 16) {
         __m128i input_data = _mm_loadu_si128((__m128i*)(input_row + i));
         __m128i prior_data = _mm_loadu_si128((__m128i*)(prior_row + i));
         __m128i current_data = _mm_add_epi8(input_data, prior_data);
         _mm_storeu_si128((__m128i*)(recon_row + i), current_data);
     }
-    else {
-        row_bytes += 16;
-        for (; i < row_bytes; i++) {
-            recon_row[i] = input_row[i] + prior_row[i];
-        }
-    }
 }
 
 inline
@@ -1485,20 +1739,6 @@ void rowDefilter3C2(uint8_t* input_row, uint8_t* prior_row, uint32_t row_bytes,
     }
 }
 
-inline
-void row0Defilter3(uint8_t* input_row, uint32_t pixel_bytes,
-                   uint32_t row_bytes, uint8_t* recon_row) {
-    uint32_t i = 0;
-    for (; i < pixel_bytes; i++) {
-        recon_row[i] = input_row[i];
-    }
-
-    uint32_t j = 0;
-    for (; i < row_bytes; i++, j++) {
-        recon_row[i] = input_row[i] + (recon_row[j] >> 1);
-    }
-}
-
 inline
 int filterPaeth(int a, int b, int c) {
     int p = a + b - c;
@@ -1584,110 +1824,13 @@ void rowDefilter4C2(uint8_t* input_row, uint8_t* prior_row,
     }
 }
 
-/* process an image with color type 0/3/4, which does not need rgb-> bgr
- * transformation.
+/* defilter a scanline of color type 0/3/4, which does not need rgb-> bgr
+ * transformation. The prior row of the first scanline is zeros.
  */
-bool PngDecoder::deFilterImage(PngInfo& png_info, uint8_t* image,
-                               uint32_t stride) {
-    int bytes = (bit_depth_ == 16 ? 2 : 1);
-    int pixel_bytes = bytes * encoded_channels_;  // 1, 2, 4
-    uint32_t scanline_bytes = ((width_ * encoded_channels_ * bit_depth_ +
-                                7) >> 3) + 1;
-    uint32_t row_bytes = scanline_bytes - 1;
-    uint32_t stride_offset0 = 0;
-    if (bit_depth_ < 8 || color_type_ == 3 ||
-        (color_type_ == 0 && encoded_channels_ + 1 == channels_)) {
-        stride_offset0 = stride - scanline_bytes;  // can't align with 16 bytes
-    }
-
-    uint8_t *input = png_info.decompressed_image_start;
-    uint8_t *recon_row = image + stride_offset0;
-    uint8_t *prior_row;
-    uint8_t filter_type;
-    uint32_t aligned_bytes = (row_bytes + 15) & -16;
-
-    // process the first row.
-    filter_type = *input++;
-    if (filter_type > 4) {
-        LOG(ERROR) << "The readed filter type: " << (uint32_t)filter_type
-                   << ", correct filter type: None(0)/Sub(1)/Up(2)/"
-                   << "Average(3)/Paeth(4)";
-        return false;
-    }
-    switch (filter_type) {
-        case FILTER_NONE:
-        case FILTER_UP:
-            memcpy(recon_row, input, aligned_bytes);
-            break;
-        case FILTER_SUB:
-        case FILTER_PAETH:
-            rowDefilter1(input, pixel_bytes, row_bytes, recon_row);
-            break;
-        case FILTER_AVERAGE:
-            row0Defilter3(input, pixel_bytes, row_bytes, recon_row);
-            break;
-    }
-    input += row_bytes;
-    recon_row += stride;
-
-    // process the most rows.
-    for (uint32_t row = 1; row < height_ - 1; ++row) {
-        prior_row = recon_row - stride;
-        filter_type = *input++;
-        if (filter_type > 4) {
-            LOG(ERROR) << "The readed filter type: " << (uint32_t)filter_type
-                       << ", correct filter type: None(0)/Sub(1)/Up(2)/"
-                       << "Average(3)/Paeth(4)";
-            return false;
-        }
-        switch (filter_type) {
-            case FILTER_NONE:
-                memcpy(recon_row, input, aligned_bytes);
-                break;
-            case FILTER_SUB:
-                if (pixel_bytes == 2) {
-                    rowDefilter1C2(input, row_bytes, recon_row);
-                }
-                else {
-                    rowDefilter1(input, pixel_bytes, row_bytes, recon_row);
-                }
-                break;
-            case FILTER_UP:
-                rowDefilter2(input, prior_row, row_bytes, recon_row,
-                             row < height_ - 15 ? true : false);
-                break;
-            case FILTER_AVERAGE:
-                if (pixel_bytes == 2) {
-                    rowDefilter3C2(input, prior_row, row_bytes, recon_row);
-                }
-                else {
-                    rowDefilter3(input, prior_row, pixel_bytes, row_bytes,
-                                 recon_row);
-                }
-                break;
-            case FILTER_PAETH:
-                if (pixel_bytes == 2) {
-                    rowDefilter4C2(input, prior_row, row_bytes, recon_row);
-                }
-                else {
-                    rowDefilter4(input, prior_row, pixel_bytes, row_bytes,
-                                 recon_row);
-                }
-                break;
-        }
-        input += row_bytes;
-        recon_row += stride;
-    }
-
-    // process the last row.
-    prior_row = recon_row - stride;
-    filter_type = *input++;
-    if (filter_type > 4) {
-        LOG(ERROR) << "The readed filter type: " << (uint32_t)filter_type
-                   << ", correct filter type: None(0)/Sub(1)/Up(2)/"
-                   << "Average(3)/Paeth(4)";
-        return false;
-    }
+static
+void deFilterRow(uint8_t filter_type, uint8_t* input, uint8_t* prior_row,
+                 uint32_t pixel_bytes, uint32_t row_bytes,
+                 uint8_t* recon_row) {
     switch (filter_type) {
         case FILTER_NONE:
             memcpy(recon_row, input, row_bytes);
@@ -1701,7 +1844,7 @@ bool PngDecoder::deFilterImage(PngInfo& png_info, uint8_t* image,
             }
             break;
         case FILTER_UP:
-            rowDefilter2(input, prior_row, row_bytes, recon_row, false);
+            rowDefilter2(input, prior_row, row_bytes, recon_row);
             break;
         case FILTER_AVERAGE:
             if (pixel_bytes == 2) {
@@ -1722,93 +1865,70 @@ bool PngDecoder::deFilterImage(PngInfo& png_info, uint8_t* image,
             }
             break;
     }
+}
 
-    uint32_t stride_offset1 = 0;
-    if ((color_type_ == 0 && encoded_channels_ + 1 == channels_) ||
-        color_type_ == 3) {
-        stride_offset1 = stride - width_ * pixel_bytes;
-    }
-    if (bit_depth_ < 8) {  // unpack 1/2/4-bit into a 8-bit.
-        int index;
-        uint8_t scale = (color_type_ == 0) ? depth_scales[bit_depth_] : 1;
-        uint8_t value;
-        uint8_t* src = image + stride_offset0;
-        uint8_t* dst = image + stride_offset1;
-        for (uint32_t row = 0; row < height_; ++row) {
-            input = src;
-            recon_row = dst;
-
-            if (bit_depth_ == 4) {
-                for (index = width_; index >= 2; index -= 2, ++input) {
-                    value = *input;
-                    recon_row[0] = scale * ((value >> 4));
-                    recon_row[1] = scale * ((value     ) & 0x0f);
-                    recon_row += 2;
-                }
-                if (index > 0) *recon_row++ = scale * ((*input >> 4));
-            } else if (bit_depth_ == 2) {
-                for (index = width_; index >= 4; index -= 4, ++input) {
-                    value = *input;
-                    recon_row[0] = scale * ((value >> 6));
-                    recon_row[1] = scale * ((value >> 4) & 0x03);
-                    recon_row[2] = scale * ((value >> 2) & 0x03);
-                    recon_row[3] = scale * ((value     ) & 0x03);
-                    recon_row += 4;
-                }
-                value = *input;
-                if (index > 0) recon_row[0] = scale * ((value >> 6));
-                if (index > 1) recon_row[1] = scale * ((value >> 4) & 0x03);
-                if (index > 2) recon_row[2] = scale * ((value >> 2) & 0x03);
-            } else if (bit_depth_ == 1) {
-                for (index = width_; index >= 8; index -= 8, ++input) {
-                    value = *input;
-                    recon_row[0] = scale * ((value >> 7));
-                    recon_row[1] = scale * ((value >> 6) & 0x01);
-                    recon_row[2] = scale * ((value >> 5) & 0x01);
-                    recon_row[3] = scale * ((value >> 4) & 0x01);
-                    recon_row[4] = scale * ((value >> 3) & 0x01);
-                    recon_row[5] = scale * ((value >> 2) & 0x01);
-                    recon_row[6] = scale * ((value >> 1) & 0x01);
-                    recon_row[7] = scale * ((value     ) & 0x01);
-                    recon_row += 8;
-                }
-                value = *input;
-                if (index > 0) recon_row[0] = scale * ((value >> 7));
-                if (index > 1) recon_row[1] = scale * ((value >> 6) & 0x01);
-                if (index > 2) recon_row[2] = scale * ((value >> 5) & 0x01);
-                if (index > 3) recon_row[3] = scale * ((value >> 4) & 0x01);
-                if (index > 4) recon_row[4] = scale * ((value >> 3) & 0x01);
-                if (index > 5) recon_row[5] = scale * ((value >> 2) & 0x01);
-                if (index > 6) recon_row[6] = scale * ((value >> 1) & 0x01);
-            }
-            src += stride;
-            dst += stride;
-        }
-    } else if (bit_depth_ == 16) {
-        // force the image data from big-endian to platform-native.
-        uint8_t value0, value1;
-        uint8_t *recon_row = image + stride_offset0;
-        uint16_t *current_row16;
-        for (uint32_t row = 0; row < height_; row++) {
-            current_row16 = (uint16_t*)recon_row;
-            for (uint32_t col = 0, col1 = 0; col < width_; col++, col1 += 2) {
-                value0 = recon_row[col1];
-                value1 = recon_row[col1 + 1];
-                current_row16[col] = (value0 << 8) | value1;
-            }
-            recon_row += stride;
+// unpack 1/2/4-bit samples into 8-bit ones.
+static
+void unpackRow(uint8_t* input, uint32_t width, uint32_t bit_depth,
+               uint8_t scale, uint8_t* recon_row) {
+    int index;
+    uint8_t value;
+    if (bit_depth == 4) {
+        for (index = width; index >= 2; index -= 2, ++input) {
+            value = *input;
+            recon_row[0] = scale * ((value >> 4));
+            recon_row[1] = scale * ((value     ) & 0x0f);
+            recon_row += 2;
         }
+        if (index > 0) *recon_row++ = scale * ((*input >> 4));
+    } else if (bit_depth == 2) {
+        for (index = width; index >= 4; index -= 4, ++input) {
+            value = *input;
+            recon_row[0] = scale * ((value >> 6));
+            recon_row[1] = scale * ((value >> 4) & 0x03);
+            recon_row[2] = scale * ((value >> 2) & 0x03);
+            recon_row[3] = scale * ((value     ) & 0x03);
+            recon_row += 4;
+        }
+        value = *input;
+        if (index > 0) recon_row[0] = scale * ((value >> 6));
+        if (index > 1) recon_row[1] = scale * ((value >> 4) & 0x03);
+        if (index > 2) recon_row[2] = scale * ((value >> 2) & 0x03);
+    } else if (bit_depth == 1) {
+        for (index = width; index >= 8; index -= 8, ++input) {
+            value = *input;
+            recon_row[0] = scale * ((value >> 7));
+            recon_row[1] = scale * ((value >> 6) & 0x01);
+            recon_row[2] = scale * ((value >> 5) & 0x01);
+            recon_row[3] = scale * ((value >> 4) & 0x01);
+            recon_row[4] = scale * ((value >> 3) & 0x01);
+            recon_row[5] = scale * ((value >> 2) & 0x01);
+            recon_row[6] = scale * ((value >> 1) & 0x01);
+            recon_row[7] = scale * ((value     ) & 0x01);
+            recon_row += 8;
+        }
+        value = *input;
+        if (index > 0) recon_row[0] = scale * ((value >> 7));
+        if (index > 1) recon_row[1] = scale * ((value >> 6) & 0x01);
+        if (index > 2) recon_row[2] = scale * ((value >> 5) & 0x01);
+        if (index > 3) recon_row[3] = scale * ((value >> 4) & 0x01);
+        if (index > 4) recon_row[4] = scale * ((value >> 3) & 0x01);
+        if (index > 5) recon_row[5] = scale * ((value >> 2) & 0x01);
+        if (index > 6) recon_row[6] = scale * ((value >> 1) & 0x01);
     }
+}
 
-    if (bit_depth_ < 8) {
-        png_info.defiltered_image = image + stride_offset1;
-    }
-    else {
-        png_info.defiltered_image = image + stride_offset0;
+// force 16-bit samples from big-endian to platform-native.
+static
+void swapRow16(uint8_t* input, uint32_t samples, uint8_t* recon_row) {
+    uint8_t value0, value1;
+    uint16_t *current_row16 = (uint16_t*)recon_row;
+    for (uint32_t col = 0, col1 = 0; col < samples; col++, col1 += 2) {
+        value0 = input[col1];
+        value1 = input[col1 + 1];
+        current_row16[col] = (value0 << 8) | value1;
     }
-
-    return true;
-}
+}
 
 static __m128i rgb2bgrc3_index = _mm_set_epi8(15, 12, 13, 14, 9, 10, 11,
                                               6, 7, 8, 3, 4, 5, 0, 1, 2);
@@ -2356,154 +2476,6 @@ void rowDefilter2ColorC8(uint8_t* input_row, uint8_t* prior_row,
     }
 }
 
-inline
-void row0Defilter3ColorC3(uint8_t* input_row, uint32_t row_bytes,
-                          uint8_t* recon_row) {
-    uint32_t value0, value1, value2;
-    value0 = input_row[0];
-    value1 = input_row[1];
-    value2 = input_row[2];
-    recon_row[0] = value2;
-    recon_row[1] = value1;
-    recon_row[2] = value0;
-
-    uint8_t* input_end    = input_row + row_bytes;
-    uint8_t* before_bytes = recon_row;
-    input_row += 3;
-    recon_row += 3;
-    while (input_row < input_end) {
-        value0 = input_row[0];
-        value1 = input_row[1];
-        value2 = input_row[2];
-        recon_row[0] = value2 + (before_bytes[0] >> 1);
-        recon_row[1] = value1 + (before_bytes[1] >> 1);
-        recon_row[2] = value0 + (before_bytes[2] >> 1);
-        recon_row    += 3;
-        input_row    += 3;
-        before_bytes += 3;
-    }
-}
-
-inline
-void row0Defilter3ColorC4(uint8_t* input_row, uint32_t row_bytes,
-                          uint8_t* recon_row) {
-    uint32_t value0, value1, value2, value3;
-    value0 = input_row[0];
-    value1 = input_row[1];
-    value2 = input_row[2];
-    value3 = input_row[3];
-    recon_row[0] = value2;
-    recon_row[1] = value1;
-    recon_row[2] = value0;
-    recon_row[3] = value3;
-
-    uint8_t* input_end = input_row + row_bytes;
-    uint8_t* before_bytes = recon_row;
-    input_row += 4;
-    recon_row += 4;
-    while (input_row < input_end) {
-        value0 = input_row[0];
-        value1 = input_row[1];
-        value2 = input_row[2];
-        value3 = input_row[3];
-        recon_row[0] = value2 + (before_bytes[0] >> 1);
-        recon_row[1] = value1 + (before_bytes[1] >> 1);
-        recon_row[2] = value0 + (before_bytes[2] >> 1);
-        recon_row[3] = value3 + (before_bytes[3] >> 1);
-        recon_row    += 4;
-        input_row    += 4;
-        before_bytes += 4;
-    }
-}
-
-inline
-void row0Defilter3ColorC6(uint8_t* input_row, uint32_t row_bytes,
-                          uint8_t* recon_row) {
-    uint32_t value0, value1, value2, value3, value4, value5;
-    value0 = input_row[0];
-    value1 = input_row[1];
-    value2 = input_row[2];
-    value3 = input_row[3];
-    value4 = input_row[4];
-    value5 = input_row[5];
-    recon_row[0] = value4;
-    recon_row[1] = value5;
-    recon_row[2] = value2;
-    recon_row[3] = value3;
-    recon_row[4] = value0;
-    recon_row[5] = value1;
-
-    uint8_t* input_end = input_row + row_bytes;
-    uint8_t* before_bytes = recon_row;
-    input_row += 6;
-    recon_row += 6;
-    while (input_row < input_end) {
-        value0 = input_row[0];
-        value1 = input_row[1];
-        value2 = input_row[2];
-        value3 = input_row[3];
-        value4 = input_row[4];
-        value5 = input_row[5];
-        recon_row[0] = value4 + (before_bytes[0] >> 1);
-        recon_row[1] = value5 + (before_bytes[1] >> 1);
-        recon_row[2] = value2 + (before_bytes[2] >> 1);
-        recon_row[3] = value3 + (before_bytes[3] >> 1);
-        recon_row[4] = value0 + (before_bytes[4] >> 1);
-        recon_row[5] = value1 + (before_bytes[5] >> 1);
-        recon_row    += 6;
-        input_row    += 6;
-        before_bytes += 6;
-    }
-}
-
-inline
-void row0Defilter3ColorC8(uint8_t* input_row, uint32_t row_bytes,
-                          uint8_t* recon_row) {
-    uint32_t value0, value1, value2, value3, value4, value5, value6, value7;
-    value0 = input_row[0];
-    value1 = input_row[1];
-    value2 = input_row[2];
-    value3 = input_row[3];
-    value4 = input_row[4];
-    value5 = input_row[5];
-    value6 = input_row[6];
-    value7 = input_row[7];
-    recon_row[0] = value4;
-    recon_row[1] = value5;
-    recon_row[2] = value2;
-    recon_row[3] = value3;
-    recon_row[4] = value0;
-    recon_row[5] = value1;
-    recon_row[6] = value6;
-    recon_row[7] = value7;
-
-    uint8_t* input_end = input_row + row_bytes;
-    uint8_t* before_bytes = recon_row;
-    input_row += 8;
-    recon_row += 8;
-    while (input_row < input_end) {
-        value0 = input_row[0];
-        value1 = input_row[1];
-        value2 = input_row[2];
-        value3 = input_row[3];
-        value4 = input_row[4];
-        value5 = input_row[5];
-        value6 = input_row[6];
-        value7 = input_row[7];
-        recon_row[0] = value4 + (before_bytes[0] >> 1);
-        recon_row[1] = value5 + (before_bytes[1] >> 1);
-        recon_row[2] = value2 + (before_bytes[2] >> 1);
-        recon_row[3] = value3 + (before_bytes[3] >> 1);
-        recon_row[4] = value0 + (before_bytes[4] >> 1);
-        recon_row[5] = value1 + (before_bytes[5] >> 1);
-        recon_row[6] = value6 + (before_bytes[6] >> 1);
-        recon_row[7] = value7 + (before_bytes[7] >> 1);
-        recon_row    += 8;
-        input_row    += 8;
-        before_bytes += 8;
-    }
-}
-
 inline
 __m128i caculateDefilter3(__m128i a4_i16, __m128i b4_i16, __m128i input) {
     __m128i add_i16    = _mm_add_epi16(a4_i16, b4_i16);
@@ -3350,548 +3322,349 @@ void rowDefilter4ColorC8(uint8_t* input_row, uint8_t* prior_row,
     }
 }
 
+/*
+ * defilter a scanline of truecolor or truecolor with alpha, reordering the
+ * channels in a pixel from RGB to BGR. The prior row of the first scanline is
+ * zeros, and the rows are padded for the vector tails.
+ */
 static
-bool deFilterC3TureColor(uint8_t* input, uint32_t height, uint32_t row_bytes,
-                         uint32_t stride, uint8_t* recon_row) {
-    // process the first row.
-    uint8_t filter_type = *input++;
-    if (filter_type > 4) {
-        LOG(ERROR) << "The readed filter type: " << (uint32_t)filter_type
-                   << ", correct filter type: None(0)/Sub(1)/Up(2)/Average(3)/"
-                   << "Paeth(4)";
-        return false;
-    }
+void deFilterRowTrueColor(uint8_t filter_type, uint8_t* input,
+                          uint8_t* prior_row, uint32_t pixel_bytes,
+                          uint32_t row_bytes, uint8_t* recon_row) {
     switch (filter_type) {
         case FILTER_NONE:
-            rowDefilter0ColorC3(input, row_bytes, recon_row, false);
+            if (pixel_bytes == 3) {
+                rowDefilter0ColorC3(input, row_bytes, recon_row, false);
+            }
+            else if (pixel_bytes == 4) {
+                rowDefilter0ColorC4(input, row_bytes, recon_row, false);
+            }
+            else if (pixel_bytes == 6) {
+                rowDefilter0ColorC6(input, row_bytes, recon_row);
+            }
+            else {
+                rowDefilter0ColorC8(input, row_bytes, recon_row);
+            }
             break;
         case FILTER_SUB:
-            rowDefilter1ColorC3(input, row_bytes, recon_row, false);
+            if (pixel_bytes == 3) {
+                rowDefilter1ColorC3(input, row_bytes, recon_row, false);
+            }
+            else if (pixel_bytes == 4) {
+                rowDefilter1ColorC4(input, row_bytes, recon_row, false);
+            }
+            else if (pixel_bytes == 6) {
+                rowDefilter1ColorC6(input, row_bytes, recon_row);
+            }
+            else {
+                rowDefilter1ColorC8(input, row_bytes, recon_row);
+            }
             break;
         case FILTER_UP:
-            rowDefilter0ColorC3(input, row_bytes, recon_row, false);
-            break;
-        case FILTER_PAETH:
-            row0Defilter3ColorC3(input, row_bytes, recon_row);
-            break;
-        case FILTER_AVERAGE:
-            rowDefilter1ColorC3(input, row_bytes, recon_row, false);
-            break;
-    }
-    input += row_bytes;
-    recon_row += stride;
-
-    // process the most rows.
-    uint8_t *prior_row;
-    for (uint32_t row = 1; row < height - 1; ++row) {
-        prior_row = recon_row - stride;
-        filter_type = *input++;
-        if (filter_type > 4) {
-            LOG(ERROR) << "The readed filter type: " << (uint32_t)filter_type
-                       << ", correct filter type: None(0)/Sub(1)/Up(2)/"
-                       << "Average(3)/Paeth(4)";
-            return false;
-        }
-        switch (filter_type) {
-            case FILTER_NONE:
-                rowDefilter0ColorC3(input, row_bytes, recon_row, false);
-                break;
-            case FILTER_SUB:
-                rowDefilter1ColorC3(input, row_bytes, recon_row, false);
-                break;
-            case FILTER_UP:
+            if (pixel_bytes == 3) {
                 rowDefilter2ColorC3(input, prior_row, row_bytes, recon_row,
                                     false);
-                break;
-            case FILTER_AVERAGE:
+            }
+            else if (pixel_bytes == 4) {
+                rowDefilter2ColorC4(input, prior_row, row_bytes, recon_row,
+                                    false);
+            }
+            else if (pixel_bytes == 6) {
+                rowDefilter2ColorC6(input, prior_row, row_bytes, recon_row);
+            }
+            else {
+                rowDefilter2ColorC8(input, prior_row, row_bytes, recon_row);
+            }
+            break;
+        case FILTER_AVERAGE:
+            if (pixel_bytes == 3) {
                 rowDefilter3ColorC3(input, prior_row, row_bytes, recon_row,
                                     false);
-                break;
-            case FILTER_PAETH:
+            }
+            else if (pixel_bytes == 4) {
+                rowDefilter3ColorC4(input, prior_row, row_bytes, recon_row,
+                                    false);
+            }
+            else if (pixel_bytes == 6) {
+                rowDefilter3ColorC6(input, prior_row, row_bytes, recon_row);
+            }
+            else {
+                rowDefilter3ColorC8(input, prior_row, row_bytes, recon_row);
+            }
+            break;
+        case FILTER_PAETH:
+            if (pixel_bytes == 3) {
                 rowDefilter4ColorC3(input, prior_row, row_bytes, recon_row,
                                     false);
-                break;
+            }
+            else if (pixel_bytes == 4) {
+                rowDefilter4ColorC4(input, prior_row, row_bytes, recon_row,
+                                    false);
+            }
+            else if (pixel_bytes == 6) {
+                rowDefilter4ColorC6(input, prior_row, row_bytes, recon_row);
+            }
+            else {
+                rowDefilter4ColorC8(input, prior_row, row_bytes, recon_row);
+            }
+            break;
+    }
+}
+
+void PngDecoder::computeTransparency(PngInfo& png_info, uint8_t* input_row,
+                                     uint8_t* output_row) {
+    if (bit_depth_ <= 8) {
+        uint8_t value0, value1, value2, value3;
+
+        if (color_type_ == GRAY) {
+            for (uint32_t col0 = 0, col1 = 0; col0 < width_; col0++) {
+                 value0 = input_row[col0];
+                 value1 = value0 == png_info.alpha_values[0] ? 0 : 255;
+                 output_row[col1]     = value0;
+                 output_row[col1 + 1] = value1;
+                 col1 += 2;
+            }
+        }
+        else {  // color_type_ == TRUE_COLOR
+            for (uint32_t col0 = 0, col1 = 0; col0 < width_ * 3; col0 += 3) {
+                 value0 = input_row[col0];
+                 value1 = input_row[col0 + 1];
+                 value2 = input_row[col0 + 2];
+                 if (value0 == png_info.alpha_values[0] &&
+                     value1 == png_info.alpha_values[1] &&
+                     value2 == png_info.alpha_values[2]) {
+                     value3 = 0;
+                 }
+                 else {
+                     value3 = 255;
+                 }
+                 output_row[col1]     = value0;
+                 output_row[col1 + 1] = value1;
+                 output_row[col1 + 2] = value2;
+                 output_row[col1 + 3] = value3;
+                 col1 += 4;
+            }
         }
-        input += row_bytes;
-        recon_row += stride;
     }
+    else {  // bit_depth_ == 16
+        uint16_t* input_row16 = (uint16_t*)input_row;
+        uint16_t* output_row16 = (uint16_t*)output_row;
+        uint16_t* alpha_values = (uint16_t*)png_info.alpha_values;
+        uint16_t value0, value1, value2, value3;
 
-    // process the last row.
-    prior_row = recon_row - stride;
-    filter_type = *input++;
-    if (filter_type > 4) {
-        LOG(ERROR) << "The readed filter type: " << (uint32_t)filter_type
-                   << ", correct filter type: None(0)/Sub(1)/Up(2)/"
-                   << "Average(3)/Paeth(4)";
+        if (color_type_ == GRAY) {
+            for (uint32_t col0 = 0, col1 = 0; col0 < width_; col0++) {
+                 value0 = input_row16[col0];
+                 value1 = value0 == alpha_values[0] ? 0 : 65535;
+                 output_row16[col1]     = value0;
+                 output_row16[col1 + 1] = value1;
+                 col1 += 2;
+            }
+        }
+        else {  // color_type_ == TRUE_COLOR
+            for (uint32_t col0 = 0, col1 = 0; col0 < width_ * 3; col0 += 3) {
+                 value0 = input_row16[col0];
+                 value1 = input_row16[col0 + 1];
+                 value2 = input_row16[col0 + 2];
+                 if (value0 == alpha_values[0] &&
+                     value1 == alpha_values[1] &&
+                     value2 == alpha_values[2]) {
+                     value3 = 0;
+                 }
+                 else {
+                     value3 = 65535;
+                 }
+                 output_row16[col1]     = value0;
+                 output_row16[col1 + 1] = value1;
+                 output_row16[col1 + 2] = value2;
+                 output_row16[col1 + 3] = value3;
+                 col1 += 4;
+            }
+        }
+    }
+}
+
+void PngDecoder::expandPalette(PngInfo& png_info, uint8_t* input_row,
+                               uint8_t* output_row) {
+    uint8_t* palette = png_info.palette;
+    uint8_t* dst = output_row;
+    uint32_t index;
+
+    if (channels_ == 3) {
+        uint32_t col = 0;
+        for (; col < width_ - 1; col++) {
+            index = input_row[col];
+            index *= 4;
+            __m128i value = _mm_loadu_si128((__m128i*)(palette + index));
+            __m128 fvalue = _mm_castsi128_ps(value);
+            _mm_store_ss((float*)dst, fvalue);
+            dst += 3;
+        }
+
+        index = input_row[col];
+        index *= 4;
+        uint8_t value0 = palette[index];
+        uint8_t value1 = palette[index + 1];
+        uint8_t value2 = palette[index + 2];
+        dst[0] = value0;
+        dst[1] = value1;
+        dst[2] = value2;
+    }
+    else {  // channels_ == 4
+        for (uint32_t col = 0; col < width_; col++) {
+            index = input_row[col];
+            index *= 4;
+            __m128i value = _mm_loadu_si128((__m128i*)(palette + index));
+            __m128 fvalue = _mm_castsi128_ps(value);
+            _mm_store_ss((float*)dst, fvalue);
+            dst += 4;
+        }
+    }
+}
+
+/*
+ * The window holds the 32K of history back references may reach, a scanline
+ * which is partly inflated, and 64K to inflate into before the complete
+ * scanlines are flushed. The rows follow it.
+ */
+bool PngDecoder::allocateWindow(PngInfo& png_info) {
+    uint32_t scanline_bytes = ((image_width_ * encoded_channels_ * bit_depth_ +
+                                7) >> 3) + 1;
+    uint32_t window_bytes = 32768 + scanline_bytes + 65536;
+    // vector tails and rounded match copies write past the ends.
+    uint32_t padded_window = (window_bytes + 64 + 15) & -16;
+    uint32_t row_bytes = (scanline_bytes + 32 + 15) & -16;
+    uint32_t expanded_bytes = (image_width_ * encoded_channels_ *
+                               (bit_depth_ == 16 ? 2 : 1) + 32 + 15) & -16;
+    uint8_t* buffer = (uint8_t*)malloc(padded_window + row_bytes * 2 +
+                                       expanded_bytes + 15);
+    if (buffer == nullptr) {
+        LOG(ERROR) << "failed to allocate the inflating window.";
         return false;
     }
-    switch (filter_type) {
-        case FILTER_NONE:
-            rowDefilter0ColorC3(input, row_bytes, recon_row, true);
-            break;
-        case FILTER_SUB:
-            rowDefilter1ColorC3(input, row_bytes, recon_row, true);
-            break;
-        case FILTER_UP:
-            rowDefilter2ColorC3(input, prior_row, row_bytes, recon_row, true);
-            break;
-        case FILTER_AVERAGE:
-            rowDefilter3ColorC3(input, prior_row, row_bytes, recon_row, true);
-            break;
-        case FILTER_PAETH:
-            rowDefilter4ColorC3(input, prior_row, row_bytes, recon_row, true);
-            break;
+    png_info.window_buffer = buffer;
+
+    uint8_t* window = (uint8_t*)(((uintptr_t)buffer + 15) & -16);
+    png_info.decompressed_image_start = window;
+    png_info.decompressed_image_end = window + window_bytes;
+    png_info.decompressed_image = window;
+    png_info.scanline = window;
+    png_info.scanline_bytes = scanline_bytes;
+    png_info.row = 0;
+    png_info.prior_row = window + padded_window;
+    png_info.recon_row = png_info.prior_row + row_bytes;
+    png_info.expanded_row = png_info.recon_row + row_bytes;
+    memset(png_info.prior_row, 0, row_bytes);
+
+    return true;
+}
+
+/*
+ * Defilters and stores the complete scanlines in the window, then slides the
+ * window back to the history back references may reach and the partial
+ * scanline.
+ */
+bool PngDecoder::flushScanlines(PngInfo& png_info) {
+    uint8_t* output = png_info.decompressed_image;
+    uint8_t* scanline = png_info.scanline;
+    uint32_t scanline_bytes = png_info.scanline_bytes;
+    bool succeeded;
+    while ((uint32_t)(output - scanline) >= scanline_bytes &&
+           png_info.row < image_height_) {
+        if (crc32_.isChecking()) {
+            png_info.zlib_buffer.adler_value = adler32(
+                png_info.zlib_buffer.adler_value, scanline, scanline_bytes);
+        }
+        succeeded = deFilterScanline(png_info, scanline);
+        if (!succeeded) return false;
+        scanline += scanline_bytes;
+    }
+    if (png_info.row == image_height_ && output > scanline) {
+        LOG(ERROR) << "The inflated data is more than the " << image_height_
+                   << " scanlines of the image.";
+        return false;
+    }
+    png_info.scanline = scanline;
+
+    uint8_t* window = png_info.decompressed_image_start;
+    uint8_t* history = output - png_info.zlib_buffer.window_size;
+    if (history > scanline) history = scanline;
+    if (history > window) {
+        uint32_t shift = history - window;
+        memmove(window, history, output - history);
+        png_info.scanline -= shift;
+        png_info.decompressed_image -= shift;
     }
 
     return true;
 }
 
-static
-bool deFilterC4TureColor(uint8_t* input, uint32_t height, uint32_t row_bytes,
-                         uint32_t stride, uint8_t* recon_row) {
-    // process the first row.
-    uint8_t filter_type = *input++;
+bool PngDecoder::deFilterScanline(PngInfo& png_info, uint8_t* scanline) {
+    uint8_t filter_type = scanline[0];
     if (filter_type > 4) {
         LOG(ERROR) << "The readed filter type: " << (uint32_t)filter_type
-                   << ", correct filter type: None(0)/Sub(1)/Up(2)/Average(3)/"
-                   << "Paeth(4)";
+                   << ", correct filter type: None(0)/Sub(1)/Up(2)/"
+                   << "Average(3)/Paeth(4)";
         return false;
     }
-    switch (filter_type) {
-        case FILTER_NONE:
-            rowDefilter0ColorC4(input, row_bytes, recon_row, false);
-            break;
-        case FILTER_SUB:
-            rowDefilter1ColorC4(input, row_bytes, recon_row, false);
-            break;
-        case FILTER_UP:
-            rowDefilter0ColorC4(input, row_bytes, recon_row, false);
-            break;
-        case FILTER_AVERAGE:
-            row0Defilter3ColorC4(input, row_bytes, recon_row);
-            break;
-        case FILTER_PAETH:
-            rowDefilter1ColorC4(input, row_bytes, recon_row, false);
-            break;
+
+    int bytes = (bit_depth_ == 16 ? 2 : 1);
+    uint32_t pixel_bytes = bytes * encoded_channels_;
+    uint32_t row_bytes = png_info.scanline_bytes - 1;
+    uint8_t* prior_row = png_info.prior_row;
+    uint8_t* recon_row = png_info.recon_row;
+    if (color_type_ == TRUE_COLOR || color_type_ == TRUE_COLOR_WITH_ALPHA) {
+        deFilterRowTrueColor(filter_type, scanline + 1, prior_row, pixel_bytes,
+                             row_bytes, recon_row);
     }
-    input += row_bytes;
-    recon_row += stride;
-
-    // process the most rows.
-    uint8_t *prior_row;
-    for (uint32_t row = 1; row < height - 1; ++row) {
-        prior_row = recon_row - stride;
-        filter_type = *input++;
-        if (filter_type > 4) {
-            LOG(ERROR) << "The readed filter type: " << (uint32_t)filter_type
-                       << ", correct filter type: None(0)/Sub(1)/Up(2)/"
-                       << "Average(3)/Paeth(4)";
-            return false;
-        }
-        switch (filter_type) {
-            case FILTER_NONE:
-                rowDefilter0ColorC4(input, row_bytes, recon_row, false);
-                break;
-            case FILTER_SUB:
-                rowDefilter1ColorC4(input, row_bytes, recon_row, false);
-                break;
-            case FILTER_UP:
-                rowDefilter2ColorC4(input, prior_row, row_bytes, recon_row,
-                                    false);
-                break;
-            case FILTER_AVERAGE:
-                rowDefilter3ColorC4(input, prior_row, row_bytes, recon_row,
-                                    false);
-                break;
-            case FILTER_PAETH:
-                rowDefilter4ColorC4(input, prior_row, row_bytes, recon_row,
-                                    false);
-                break;
-        }
-        input += row_bytes;
-        recon_row += stride;
-    }
-
-    // process the last row.
-    prior_row = recon_row - stride;
-    filter_type = *input++;
-    if (filter_type > 4) {
-        LOG(ERROR) << "The readed filter type: " << (uint32_t)filter_type
-                   << ", correct filter type: None(0)/Sub(1)/Up(2)/"
-                   << "Average(3)/Paeth(4)";
-        return false;
-    }
-    switch (filter_type) {
-        case FILTER_NONE:
-            rowDefilter0ColorC4(input, row_bytes, recon_row, true);
-            break;
-        case FILTER_SUB:
-            rowDefilter1ColorC4(input, row_bytes, recon_row, true);
-            break;
-        case FILTER_UP:
-            rowDefilter2ColorC4(input, prior_row, row_bytes, recon_row, true);
-            break;
-        case FILTER_AVERAGE:
-            rowDefilter3ColorC4(input, prior_row, row_bytes, recon_row, true);
-            break;
-        case FILTER_PAETH:
-            rowDefilter4ColorC4(input, prior_row, row_bytes, recon_row, true);
-            break;
-    }
-
-    return true;
-}
-
-static
-bool deFilterC6TureColor(uint8_t* input, uint32_t height, uint32_t row_bytes,
-                         uint32_t stride, uint8_t* recon_row) {
-    uint8_t filter_type = *input++;
-    if (filter_type > 4) {
-        LOG(ERROR) << "The readed filter type: " << (uint32_t)filter_type
-                   << ", correct filter type: None(0)/Sub(1)/Up(2)/Average(3)/"
-                   << "Paeth(4)";
-        return false;
-    }
-
-    switch (filter_type) {
-        case FILTER_NONE:
-            rowDefilter0ColorC6(input, row_bytes, recon_row);
-            break;
-        case FILTER_SUB:
-            rowDefilter1ColorC6(input, row_bytes, recon_row);
-            break;
-        case FILTER_UP:
-            rowDefilter0ColorC6(input, row_bytes, recon_row);
-            break;
-        case FILTER_AVERAGE:
-            row0Defilter3ColorC6(input, row_bytes, recon_row);
-            break;
-        case FILTER_PAETH:
-            rowDefilter1ColorC6(input, row_bytes, recon_row);
-            break;
-    }
-    input += row_bytes;
-    recon_row += stride;
-
-    uint8_t *prior_row;
-    for (uint32_t row = 1; row < height; ++row) {
-        prior_row = recon_row - stride;
-        filter_type = *input++;
-        if (filter_type > 4) {
-            LOG(ERROR) << "The readed filter type: " << (uint32_t)filter_type
-                       << ", correct filter type: None(0)/Sub(1)/Up(2)/"
-                       << "Average(3)/Paeth(4)";
-            return false;
-        }
-        switch (filter_type) {
-            case FILTER_NONE:
-                rowDefilter0ColorC6(input, row_bytes, recon_row);
-                break;
-            case FILTER_SUB:
-                rowDefilter1ColorC6(input, row_bytes, recon_row);
-                break;
-            case FILTER_UP:
-                rowDefilter2ColorC6(input, prior_row, row_bytes, recon_row);
-                break;
-            case FILTER_AVERAGE:
-                rowDefilter3ColorC6(input, prior_row, row_bytes, recon_row);
-                break;
-            case FILTER_PAETH:
-                rowDefilter4ColorC6(input, prior_row, row_bytes, recon_row);
-                break;
-        }
-        input += row_bytes;
-        recon_row += stride;
+    else {
+        deFilterRow(filter_type, scanline + 1, prior_row, pixel_bytes,
+                    row_bytes, recon_row);
     }
 
-    return true;
-}
-
-static
-bool deFilterC8TureColor(uint8_t* input, uint32_t height, uint32_t row_bytes,
-                         uint32_t stride, uint8_t* recon_row) {
-    uint8_t filter_type = *input++;
-    if (filter_type > 4) {
-        LOG(ERROR) << "The readed filter type: " << (uint32_t)filter_type
-                   << ", correct filter type: None(0)/Sub(1)/Up(2)/Average(3)/"
-                   << "Paeth(4)";
-        return false;
-    }
-
-    switch (filter_type) {
-        case FILTER_NONE:
-            rowDefilter0ColorC8(input, row_bytes, recon_row);
-            break;
-        case FILTER_SUB:
-            rowDefilter1ColorC8(input, row_bytes, recon_row);
-            break;
-        case FILTER_UP:
-            rowDefilter0ColorC8(input, row_bytes, recon_row);
-            break;
-        case FILTER_AVERAGE:
-            row0Defilter3ColorC8(input, row_bytes, recon_row);
-            break;
-        case FILTER_PAETH:
-            rowDefilter1ColorC8(input, row_bytes, recon_row);
-            break;
-    }
-    input += row_bytes;
-    recon_row += stride;
-
-    uint8_t *prior_row;
-    for (uint32_t row = 1; row < height; ++row) {
-        prior_row = recon_row - stride;
-        filter_type = *input++;
-        if (filter_type > 4) {
-            LOG(ERROR) << "The readed filter type: " << (uint32_t)filter_type
-                       << ", correct filter type: None(0)/Sub(1)/Up(2)/"
-                       << "Average(3)/Paeth(4)";
-            return false;
-        }
-        switch (filter_type) {
-            case FILTER_NONE:
-                rowDefilter0ColorC8(input, row_bytes, recon_row);
-                break;
-            case FILTER_SUB:
-                rowDefilter1ColorC8(input, row_bytes, recon_row);
-                break;
-            case FILTER_UP:
-                rowDefilter2ColorC8(input, prior_row, row_bytes, recon_row);
-                break;
-            case FILTER_AVERAGE:
-                rowDefilter3ColorC8(input, prior_row, row_bytes, recon_row);
-                break;
-            case FILTER_PAETH:
-                rowDefilter4ColorC8(input, prior_row, row_bytes, recon_row);
-                break;
-        }
-        input += row_bytes;
-        recon_row += stride;
+    uint32_t row = png_info.row;
+    if (row >= roi_top_ && row < roi_top_ + height_) {
+        storeRow(png_info, recon_row, png_info.image +
+                 (size_t)(row - roi_top_) * png_info.stride);
     }
+    png_info.prior_row = recon_row;
+    png_info.recon_row = prior_row;
+    png_info.row++;
 
     return true;
 }
 
 /*
- * reorder channels in a pixel form RGB to BGR for truecolor or truecolor with
- * alpha.
+ * Unpacks 1/2/4-bit samples, swaps 16-bit ones, then expands the palette or
+ * the transparency of a defiltered row into the output row.
  */
-bool PngDecoder::deFilterImageTrueColor(PngInfo& png_info, uint8_t* image,
-                                        uint32_t stride) {
-    int bytes = (bit_depth_ == 16 ? 2 : 1);
-    int pixel_bytes = bytes * encoded_channels_;  // 3, 4, 6, 8
-    uint32_t row_bytes = width_ * pixel_bytes;
-    uint32_t scanline_bytes = row_bytes + 1;
-    uint32_t stride_offset = 0;
-    if (png_info.chunk_status & HAVE_tRNS) {
-        stride_offset = (stride - scanline_bytes) & -16;  // align with 16 bytes
-    }
-
-    uint8_t *input = png_info.decompressed_image_start;
-    uint8_t *recon_row = image + stride_offset;
-    if (pixel_bytes == 3) {
-        deFilterC3TureColor(input, height_, row_bytes, stride, recon_row);
-    }
-    else if (pixel_bytes == 4) {
-        deFilterC4TureColor(input, height_, row_bytes, stride, recon_row);
-    }
-    else if (pixel_bytes == 6) {
-        deFilterC6TureColor(input, height_, row_bytes, stride, recon_row);
-    }
-    else if (pixel_bytes == 8) {
-        deFilterC8TureColor(input, height_, row_bytes, stride, recon_row);
-    }
-    else {
-        LOG(ERROR) << "The pixel bytes: " << pixel_bytes
-                   << ", correct value: 3/4/6/8";
-        return false;
-    }
-
-    if (bit_depth_ == 16) {
-        // force the image data from big-endian to platform-native.
-        uint8_t value0, value1;
-        recon_row = image + stride_offset;
-        uint16_t *current_row16;
-        for (uint32_t row = 0; row < height_; row++) {
-            current_row16 = (uint16_t*)recon_row;
-            for (uint32_t col = 0, col1 = 0; col < width_; col++, col1 += 2) {
-                value0 = recon_row[col1];
-                value1 = recon_row[col1 + 1];
-                current_row16[col] = (value0 << 8) | value1;
-            }
-            recon_row += stride;
-        }
-    }
-    png_info.defiltered_image = image + stride_offset;
-
-    return true;
-}
-
-bool PngDecoder::computeTransparency(PngInfo& png_info, uint8_t* image,
-                                     uint32_t stride) {
-    if (color_type_ != 0 && color_type_ != 2) {
-        LOG(ERROR) << "The expected color type for expanding alpha: "
-                   << "greyscale(0)/true color(2).";
-        return false;
-    }
-
-    if (bit_depth_ <= 8) {
-        uint8_t* input_row = png_info.defiltered_image;
-        uint8_t* output_row = image;
-        uint8_t value0, value1, value2, value3;
-
-        if (color_type_ == GRAY) {
-            for (uint32_t row = 0; row < height_; row++) {
-                for (uint32_t col0 = 0, col1 = 0; col0 < width_; col0++) {
-                     value0 = input_row[col0];
-                     value1 = value0 == png_info.alpha_values[0] ? 0 : 255;
-                     output_row[col1]     = value0;
-                     output_row[col1 + 1] = value1;
-                     col1 += 2;
-                }
-                input_row  += stride;
-                output_row += stride;
-            }
-        }
-        else if (color_type_ == TRUE_COLOR) {
-            for (uint32_t row = 0; row < height_; row++) {
-                for (uint32_t col0 = 0, col1 = 0; col0 < width_ * 3;
-                     col0 += 3) {
-                     value0 = input_row[col0];
-                     value1 = input_row[col0 + 1];
-                     value2 = input_row[col0 + 2];
-                     if (value0 == png_info.alpha_values[0] &&
-                         value1 == png_info.alpha_values[1] &&
-                         value2 == png_info.alpha_values[2]) {
-                         value3 = 0;
-                     }
-                     else {
-                         value3 = 255;
-                     }
-                     output_row[col1]     = value0;
-                     output_row[col1 + 1] = value1;
-                     output_row[col1 + 2] = value2;
-                     output_row[col1 + 3] = value3;
-                     col1 += 4;
-                }
-                input_row  += stride;
-                output_row += stride;
-            }
-        }
-        else {
-        }
-    }
-    else {  // bit_depth_ == 16
-        uint16_t* input_row = (uint16_t*)(png_info.defiltered_image);
-        uint16_t* output_row = (uint16_t*)image;
-        uint16_t* alpha_values = (uint16_t*)png_info.alpha_values;
-        uint16_t value0, value1, value2, value3;
-
-        if (color_type_ == GRAY) {
-            for (uint32_t row = 0; row < height_; row++) {
-                for (uint32_t col0 = 0, col1 = 0; col0 < width_; col0++) {
-                     value0 = input_row[col0];
-                     value1 = value0 == alpha_values[0] ? 0 : 65535;
-                     output_row[col1]     = value0;
-                     output_row[col1 + 1] = value1;
-                     col1 += 2;
-                }
-                input_row  += stride;
-                output_row += stride;
-            }
-        }
-        else if (color_type_ == TRUE_COLOR) {
-            for (uint32_t row = 0; row < height_; row++) {
-                for (uint32_t col0 = 0, col1 = 0; col0 < width_ * 3;
-                     col0 += 3) {
-                     value0 = input_row[col0];
-                     value1 = input_row[col0 + 1];
-                     value2 = input_row[col0 + 2];
-                     if (value0 == alpha_values[0] &&
-                         value1 == alpha_values[1] &&
-                         value2 == alpha_values[2]) {
-                         value3 = 0;
-                     }
-                     else {
-                         value3 = 65535;
-                     }
-                     output_row[col1]     = value0;
-                     output_row[col1 + 1] = value1;
-                     output_row[col1 + 2] = value2;
-                     output_row[col1 + 3] = value3;
-                     col1 += 4;
-                }
-                input_row  += stride;
-                output_row += stride;
-            }
-        }
-        else {
-        }
+void PngDecoder::storeRow(PngInfo& png_info, uint8_t* recon_row,
+                          uint8_t* output_row) {
+    uint8_t* input_row = recon_row;
+    if (bit_depth_ < 8) {
+        uint8_t scale = (color_type_ == GRAY) ? depth_scales[bit_depth_] : 1;
+        unpackRow(recon_row, image_width_, bit_depth_, scale,
+                  png_info.expanded_row);
+        input_row = png_info.expanded_row;
     }
-
-    return true;
-}
-
-bool PngDecoder::expandPalette(PngInfo& png_info, uint8_t* image,
-                               uint32_t stride) {
-    if (color_type_ != INDEXED_COLOR) {
-        LOG(ERROR) << "The expected color type for expanding palette: "
-                   << "indexed-colour(3).";
-        return false;
+    else if (bit_depth_ == 16) {
+        swapRow16(recon_row, image_width_ * encoded_channels_,
+                  png_info.expanded_row);
+        input_row = png_info.expanded_row;
     }
 
-    uint8_t* input_row = png_info_.defiltered_image;
-    uint8_t* palette = png_info.palette;
-    uint8_t* output_row = image;
-    uint32_t index;
-
-    if (channels_ == 3) {
-        for (uint32_t row = 0; row < height_; row++) {
-            uint8_t* src = input_row;
-            uint8_t* dst = output_row;
-            uint32_t col = 0;
-            for (; col < width_ - 1; col++) {
-                index = src[col];
-                index *= 4;
-                __m128i value = _mm_loadu_si128((__m128i*)(palette + index));
-                __m128 fvalue = _mm_castsi128_ps(value);
-                _mm_store_ss((float*)dst, fvalue);
-                dst += 3;
-            }
-
-            index = src[col];
-            index *= 4;
-            uint8_t value0 = palette[index];
-            uint8_t value1 = palette[index + 1];
-            uint8_t value2 = palette[index + 2];
-            dst[0] = value0;
-            dst[1] = value1;
-            dst[2] = value2;
-
-            input_row  += stride;
-            output_row += stride;
-        }
+    int bytes = (bit_depth_ == 16 ? 2 : 1);
+    uint32_t pixel_bytes = bytes * encoded_channels_;
+    input_row += roi_left_ * pixel_bytes;
+    if (color_type_ == INDEXED_COLOR) {
+        expandPalette(png_info, input_row, output_row);
     }
-    else if (channels_ == 4) {
-        for (uint32_t row = 0; row < height_; row++) {
-            uint8_t* src = input_row;
-            uint8_t* dst = output_row;
-            for (uint32_t col = 0; col < width_; col++) {
-                index = src[col];
-                index *= 4;
-                __m128i value = _mm_loadu_si128((__m128i*)(palette + index));
-                __m128 fvalue = _mm_castsi128_ps(value);
-                _mm_store_ss((float*)dst, fvalue);
-                dst += 4;
-            }
-            input_row  += stride;
-            output_row += stride;
-        }
+    else if (encoded_channels_ + 1 == channels_) {
+        computeTransparency(png_info, input_row, output_row);
     }
     else {
+        memcpy(output_row, input_row, width_ * pixel_bytes);
     }
-
-    return true;
 }
 
 bool PngDecoder::readHeader() {
@@ -3988,6 +3761,22 @@ bool PngDecoder::readHeader() {
     return true;
 }
 
+bool PngDecoder::setRoi(uint32_t top, uint32_t left, uint32_t height,
+                        uint32_t width) {
+    if (height == 0 || width == 0 || top + height > image_height_ ||
+        left + width > image_width_) {
+        LOG(ERROR) << "The region of interest is out of the image.";
+        return false;
+    }
+
+    roi_top_  = top;
+    roi_left_ = left;
+    height_ = height;
+    width_  = width;
+
+    return true;
+}
+
 bool PngDecoder::decodeData(uint32_t stride, uint8_t* image) {
     if (png_info_.current_chunk.type != png_IDAT) {
         LOG(ERROR) << "encountering the chunk: "
@@ -3996,16 +3785,17 @@ bool PngDecoder::decodeData(uint32_t stride, uint8_t* image) {
         return false;
     }
 
-    uint32_t decompressed_image_size = (((width_ * encoded_channels_ *
-                                          bit_depth_ + 7) >> 3) + 1) * height_;
-    png_info_.decompressed_image_end = image + stride * height_;
-    png_info_.decompressed_image_start = png_info_.decompressed_image_end -
-                                         decompressed_image_size;
-    png_info_.decompressed_image = png_info_.decompressed_image_start;
+    bool succeeded = allocateWindow(png_info_);
+    if (!succeeded) return false;
+    png_info_.image = image;
+    png_info_.stride = stride;
     png_info_.zlib_buffer.bit_number = 0;
     png_info_.zlib_buffer.code_buffer = 0;
+    png_info_.zlib_buffer.is_final_block = false;
+    png_info_.zlib_buffer.adler_value = 1;
+    png_info_.zlib_buffer.transmitted_adler32 = 0;
+    png_info_.zlib_buffer.adler32_bytes = 0;
 
-    bool succeeded;
     while (png_info_.current_chunk.type != png_IEND) {
         switch (png_info_.current_chunk.type) {
             case png_tIME:
@@ -4037,7 +3827,7 @@ bool PngDecoder::decodeData(uint32_t stride, uint8_t* image) {
                 }
                 break;
             case png_IDAT:
-                succeeded = parseIDATs(png_info_, image, stride);
+                succeeded = parseIDATs(png_info_);
                 if (!succeeded) return false;
                 break;
             default:
@@ -4054,30 +3844,1202 @@ bool PngDecoder::decodeData(uint32_t stride, uint8_t* image) {
     succeeded = parseIEND(png_info_);
     if (!succeeded) return false;
 
-    if (color_type_ != TRUE_COLOR && color_type_ != TRUE_COLOR_WITH_ALPHA) {
-        succeeded = deFilterImage(png_info_, image, stride);
+    succeeded = flushScanlines(png_info_);
+    if (!succeeded) return false;
+    if (png_info_.row < image_height_) {
+        LOG(ERROR) << "The image data ends at scanline " << png_info_.row
+                   << ", the image height: " << image_height_;
+        return false;
     }
-    else {  // truecolour or truecolor with alpha.
-        succeeded = deFilterImageTrueColor(png_info_, image, stride);
+
+    // ADLER32 is optional in png, it is checked when the stream carries it.
+    ZlibBuffer &zlib_buffer = png_info_.zlib_buffer;
+    if (crc32_.isChecking() && zlib_buffer.adler32_bytes == 4 &&
+        zlib_buffer.adler_value != zlib_buffer.transmitted_adler32) {
+        LOG(ERROR) << "The ADLER32 of the zlib stream mismatchs, calculated "
+                   << "value: " << zlib_buffer.adler_value
+                   << ", transmitted value: "
+                   << zlib_buffer.transmitted_adler32;
+        return false;
     }
-    if (!succeeded) return false;
 
-    if (color_type_ == GRAY || color_type_ == TRUE_COLOR) {
-        if (encoded_channels_ + 1 == channels_) {
-            succeeded = computeTransparency(png_info_, image, stride);
-            if (!succeeded) return false;
+    return true;
+}
+
+/******************************** png encoder ********************************/
+
+#define DEFLATE_WINDOW_MASK (DEFLATE_WINDOW_SIZE - 1)
+#define DEFLATE_WINDOW_CAPACITY (DEFLATE_WINDOW_SIZE + DEFLATE_INPUT_SIZE)
+#define DEFLATE_WINDOW_PADDING 16
+#define DEFLATE_HASH_SIZE (1 << DEFLATE_HASH_BITS)
+#define DEFLATE_MIN_MATCH 3
+#define DEFLATE_MAX_MATCH 258
+#define DEFLATE_LOOKAHEAD (DEFLATE_MAX_MATCH + DEFLATE_MIN_MATCH + 1)
+#define DEFLATE_TOO_FAR 4096  // a 3 bytes match farther costs more than literals
+#define DEFLATE_STORED_SIZE 65535
+#define PNG_IDAT_SIZE (1 << 16)
+
+static const DeflateLevel deflate_levels[10] = {
+    {0, 0, 0, 0},           // stored
+    {0, 0, 0, 0},           // runs only
+    {4, 5, 16, 8},          // greedy
+    {4, 6, 32, 32},
+    {4, 4, 16, 16},         // lazy
+    {8, 16, 32, 32},
+    {8, 16, 128, 128},
+    {8, 32, 128, 256},
+    {32, 128, 258, 1024},
+    {32, 258, 258, 4096},
+};
+
+// Codes of match lengths - 3, and of distances - 1, the ones beyond 255 are
+// indexed with 256 + ((distance - 1) >> 7). The fixed huffman codes are
+// bit reversed as they are sent.
+struct DeflateTables {
+    uint8_t length_codes[256];
+    uint8_t distance_codes[512];
+    uint16_t fixed_literal_codes[SYMBOL_NUMBER];
+    uint16_t fixed_distance_codes[32];
+
+    DeflateTables();
+};
+
+static void computeCanonicalCodes(const uint8_t* lengths, uint32_t number,
+                                  uint16_t* codes) {
+    uint32_t counts[16] = {0};
+    uint32_t next_codes[16] = {0};
+    for (uint32_t i = 0; i < number; i++) {
+        counts[lengths[i]]++;
+    }
+    counts[0] = 0;
+
+    uint32_t code = 0;
+    for (uint32_t bits = 1; bits < 16; bits++) {
+        code = (code + counts[bits - 1]) << 1;
+        next_codes[bits] = code;
+    }
+    for (uint32_t i = 0; i < number; i++) {
+        uint32_t length = lengths[i];
+        codes[i] = length == 0 ? 0 :
+                   (uint16_t)reverseBits(next_codes[length]++, length);
+    }
+}
+
+DeflateTables::DeflateTables() {
+    for (int32_t code = 0; code < 28; code++) {
+        for (int32_t i = 0; i < (1 << length_extra_bits[code]); i++) {
+            length_codes[length_base[code] - DEFLATE_MIN_MATCH + i] = code;
         }
     }
-    else if (color_type_ == INDEXED_COLOR) {
-        succeeded = expandPalette(png_info_, image, stride);
-        if (!succeeded) return false;
+    length_codes[DEFLATE_MAX_MATCH - DEFLATE_MIN_MATCH] = 28;
+
+    for (int32_t code = 0; code < 30; code++) {
+        for (int32_t i = 0; i < (1 << distance_extra_bits[code]); i++) {
+            int32_t distance = distance_base[code] - 1 + i;
+            if (distance < 256) {
+                distance_codes[distance] = code;
+            }
+            else {
+                distance_codes[256 + (distance >> 7)] = code;
+            }
+        }
+    }
+
+    computeCanonicalCodes(default_length_sizes, SYMBOL_NUMBER,
+                          fixed_literal_codes);
+    computeCanonicalCodes(default_distance_sizes, 32, fixed_distance_codes);
+}
+
+static const DeflateTables deflate_tables;
+
+static inline
+uint32_t distanceCode(uint32_t distance) {
+    distance--;
+    if (distance < 256) {
+        return deflate_tables.distance_codes[distance];
     }
     else {
+        return deflate_tables.distance_codes[256 + (distance >> 7)];
+    }
+}
+
+static inline
+uint32_t countTrailingZeros(uint32_t value) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, value);
+    return index;
+#else
+    return __builtin_ctz(value);
+#endif
+}
+
+// Bytes of data0 the same as the ones of data1, at most limit, 16 bytes
+// a time.
+static inline
+uint32_t matchLength(const uint8_t* data0, const uint8_t* data1,
+                     uint32_t limit) {
+    uint32_t length = 0;
+    while (length < limit) {
+        __m128i value0 = _mm_loadu_si128((const __m128i*)(data0 + length));
+        __m128i value1 = _mm_loadu_si128((const __m128i*)(data1 + length));
+        uint32_t mask = _mm_movemask_epi8(_mm_cmpeq_epi8(value0, value1)) ^
+                        0xFFFF;
+        if (mask != 0) {
+            length += countTrailingZeros(mask);
+            return length < limit ? length : limit;
+        }
+        length += 16;
+    }
+
+    return limit;
+}
+
+static inline
+uint32_t hashBytes(const uint8_t* data) {
+    uint32_t value;
+    memcpy(&value, data, sizeof(uint32_t));
+
+    return (value * 2654435761u) >> (32 - DEFLATE_HASH_BITS);
+}
+
+// Moffat and Katajainen's in-place computation of minimum redundancy codes,
+// weights in ascending order are replaced with their code lengths.
+static void calculateMinimumRedundancy(uint32_t* weights, int32_t number) {
+    if (number == 1) {
+        weights[0] = 1;
+        return;
+    }
+
+    int32_t root = 0, leaf = 2, next;
+    weights[0] += weights[1];
+    for (next = 1; next < number - 1; next++) {
+        if (leaf >= number || weights[root] < weights[leaf]) {
+            weights[next] = weights[root];
+            weights[root++] = next;
+        }
+        else {
+            weights[next] = weights[leaf++];
+        }
+        if (leaf >= number ||
+            (root < next && weights[root] < weights[leaf])) {
+            weights[next] += weights[root];
+            weights[root++] = next;
+        }
+        else {
+            weights[next] += weights[leaf++];
+        }
+    }
+
+    weights[number - 2] = 0;
+    for (next = number - 3; next >= 0; next--) {
+        weights[next] = weights[weights[next]] + 1;
+    }
+
+    int32_t available = 1, used = 0, depth = 0;
+    root = number - 2;
+    next = number - 1;
+    while (available > 0) {
+        while (root >= 0 && (int32_t)weights[root] == depth) {
+            used++;
+            root--;
+        }
+        while (available > used) {
+            weights[next--] = depth;
+            available--;
+        }
+        available = 2 * used;
+        depth++;
+        used = 0;
     }
+}
+
+// Code lengths of the symbols no longer than max_length, the longest codes
+// are shortened and the shorter ones lengthened until the kraft sum is 1.
+static void computeCodeLengths(const uint32_t* frequencies, uint32_t number,
+                               uint32_t max_length, uint8_t* lengths) {
+    uint64_t keys[SYMBOL_NUMBER];
+    uint32_t weights[SYMBOL_NUMBER];
+    uint32_t used = 0;
+    memset(lengths, 0, number);
+    for (uint32_t i = 0; i < number; i++) {
+        if (frequencies[i] != 0) {
+            keys[used++] = ((uint64_t)frequencies[i] << 16) | i;
+        }
+    }
+    if (used == 0) {
+        return;
+    }
+
+    std::sort(keys, keys + used);
+    for (uint32_t i = 0; i < used; i++) {
+        weights[i] = (uint32_t)(keys[i] >> 16);
+    }
+    calculateMinimumRedundancy(weights, used);
+
+    uint32_t counts[16] = {0};
+    for (uint32_t i = 0; i < used; i++) {
+        counts[std::min(weights[i], max_length)]++;
+    }
+    uint32_t total = 0;
+    for (uint32_t i = 1; i <= max_length; i++) {
+        total += counts[i] << (max_length - i);
+    }
+    while (total > (1u << max_length)) {
+        counts[max_length]--;
+        for (uint32_t i = max_length - 1; i > 0; i--) {
+            if (counts[i] != 0) {
+                counts[i]--;
+                counts[i + 1] += 2;
+                break;
+            }
+        }
+        total--;
+    }
+
+    // the least frequent symbols get the longest codes.
+    uint32_t index = 0;
+    for (uint32_t length = max_length; length > 0; length--) {
+        for (uint32_t i = 0; i < counts[length]; i++) {
+            lengths[keys[index++] & 0xFFFF] = length;
+        }
+    }
+}
+
+// A complete code needs 2 symbols at least, unused ones are added.
+static void ensureTwoCodes(uint32_t* frequencies, uint32_t number) {
+    uint32_t used = 0;
+    for (uint32_t i = 0; i < number; i++) {
+        used += frequencies[i] != 0;
+    }
+    for (uint32_t i = 0; used < 2 && i < number; i++) {
+        if (frequencies[i] == 0) {
+            frequencies[i] = 1;
+            used++;
+        }
+    }
+}
+
+// Run length codes of the code lengths with 16(repeats the previous length
+// 3-6 times), 17(3-10 zeros) and 18(11-138 zeros).
+static uint32_t encodeCodeLengths(const uint8_t* lengths, uint32_t number,
+                                  uint8_t* symbols, uint8_t* extras) {
+    uint32_t count = 0;
+    uint32_t i = 0;
+    while (i < number) {
+        uint8_t length = lengths[i];
+        uint32_t run = 1;
+        while (i + run < number && lengths[i + run] == length) {
+            run++;
+        }
+        i += run;
+
+        if (length == 0) {
+            while (run >= 11) {
+                uint32_t repeats = std::min(run, 138u);
+                symbols[count] = 18;
+                extras[count++] = repeats - 11;
+                run -= repeats;
+            }
+            if (run >= 3) {
+                symbols[count] = 17;
+                extras[count++] = run - 3;
+                run = 0;
+            }
+        }
+        else {
+            symbols[count] = length;
+            extras[count++] = 0;
+            run--;
+            while (run >= 3) {
+                uint32_t repeats = std::min(run, 6u);
+                symbols[count] = 16;
+                extras[count++] = repeats - 3;
+                run -= repeats;
+            }
+        }
+        while (run > 0) {
+            symbols[count] = length;
+            extras[count++] = 0;
+            run--;
+        }
+    }
+
+    return count;
+}
+
+DeflateEncoder::DeflateEncoder() : level_(0), window_(nullptr),
+        hash_heads_(nullptr), hash_chains_(nullptr), symbol_values_(nullptr),
+        symbol_distances_(nullptr), output_(nullptr) {
+}
+
+DeflateEncoder::~DeflateEncoder() {
+    free(window_);
+    free(hash_heads_);
+    free(hash_chains_);
+    free(symbol_values_);
+    free(symbol_distances_);
+    free(output_);
+}
+
+bool DeflateEncoder::initialize(int32_t level) {
+    level_ = level;
+    parameters_ = deflate_levels[level];
+
+    window_ = (uint8_t*)malloc(DEFLATE_WINDOW_CAPACITY +
+                               DEFLATE_WINDOW_PADDING);
+    output_capacity_ = PNG_IDAT_SIZE * 2;
+    output_ = (uint8_t*)malloc(output_capacity_);
+    if (window_ == nullptr || output_ == nullptr) {
+        LOG(ERROR) << "No enough memory to be allocated for deflate.";
+        return false;
+    }
+    memset(window_, 0, DEFLATE_WINDOW_CAPACITY + DEFLATE_WINDOW_PADDING);
+    if (level > 0) {
+        symbol_values_ = (uint8_t*)malloc(DEFLATE_WINDOW_CAPACITY);
+        symbol_distances_ = (uint16_t*)malloc(DEFLATE_WINDOW_CAPACITY *
+                                              sizeof(uint16_t));
+        if (symbol_values_ == nullptr || symbol_distances_ == nullptr) {
+            LOG(ERROR) << "No enough memory to be allocated for deflate.";
+            return false;
+        }
+    }
+    if (level > 1) {
+        hash_heads_ = (uint32_t*)calloc(DEFLATE_HASH_SIZE, sizeof(uint32_t));
+        hash_chains_ = (uint32_t*)malloc(DEFLATE_WINDOW_SIZE *
+                                         sizeof(uint32_t));
+        if (hash_heads_ == nullptr || hash_chains_ == nullptr) {
+            LOG(ERROR) << "No enough memory to be allocated for deflate.";
+            return false;
+        }
+    }
+
+    window_start_ = 0;
+    window_end_ = 0;
+    block_start_ = 0;
+    position_ = 0;
+    symbol_number_ = 0;
+    memset(literal_frequencies_, 0, sizeof(literal_frequencies_));
+    memset(distance_frequencies_, 0, sizeof(distance_frequencies_));
+    adler_value_ = 1;
+    bit_buffer_ = 0;
+    bit_number_ = 0;
+    output_size_ = 0;
+
+    // CMF: deflate with a 32K window, FLG: the level and the check bits.
+    uint32_t level_flag = level <= 1 ? 0 : (level <= 5 ? 1 :
+                                           (level == 6 ? 2 : 3));
+    uint32_t header = (0x78 << 8) | (level_flag << 6);
+    header += (31 - header % 31) % 31;
+    putBits(header >> 8, 8);
+    putBits(header & 0xFF, 8);
+
+    return true;
+}
+
+inline
+void DeflateEncoder::putBits(uint32_t value, uint32_t bit_number) {
+    bit_buffer_ |= (uint64_t)value << bit_number_;
+    bit_number_ += bit_number;
+    if (bit_number_ >= 32) {
+        uint32_t word = (uint32_t)bit_buffer_;
+        memcpy(output_ + output_size_, &word, sizeof(uint32_t));
+        output_size_ += 4;
+        bit_buffer_ >>= 32;
+        bit_number_ -= 32;
+    }
+}
+
+void DeflateEncoder::alignToByte() {
+    putBits(0, (8 - (bit_number_ & 7)) & 7);
+    while (bit_number_ > 0) {
+        output_[output_size_++] = (uint8_t)bit_buffer_;
+        bit_buffer_ >>= 8;
+        bit_number_ -= 8;
+    }
+}
+
+bool DeflateEncoder::reserveOutput(uint32_t size) {
+    uint32_t needed = output_size_ + size + 16;
+    if (needed <= output_capacity_) {
+        return true;
+    }
+
+    uint32_t capacity = std::max(needed, output_capacity_ * 2);
+    uint8_t* output = (uint8_t*)realloc(output_, capacity);
+    if (output == nullptr) {
+        LOG(ERROR) << "No enough memory to be allocated for deflate.";
+        return false;
+    }
+    output_ = output;
+    output_capacity_ = capacity;
+
+    return true;
+}
+
+inline
+void DeflateEncoder::putLiteral(uint8_t value) {
+    symbol_values_[symbol_number_] = value;
+    symbol_distances_[symbol_number_++] = 0;
+    literal_frequencies_[value]++;
+}
+
+inline
+void DeflateEncoder::putMatch(uint32_t length, uint32_t distance) {
+    symbol_values_[symbol_number_] = length - DEFLATE_MIN_MATCH;
+    symbol_distances_[symbol_number_++] = distance;
+    literal_frequencies_[257 +
+        deflate_tables.length_codes[length - DEFLATE_MIN_MATCH]]++;
+    distance_frequencies_[distanceCode(distance)]++;
+}
+
+// Returns the previous position + 1 with the same hash.
+inline
+uint32_t DeflateEncoder::insertHash(uint32_t position) {
+    uint32_t hash = hashBytes(window_ + position);
+    uint32_t stream_position = window_start_ + position;
+    uint32_t candidate = hash_heads_[hash];
+    hash_chains_[stream_position & DEFLATE_WINDOW_MASK] = candidate;
+    hash_heads_[hash] = stream_position + 1;
+
+    return candidate;
+}
+
+// Walks the hash chain from candidate for a match longer than
+// previous_length, returns its length or 0.
+uint32_t DeflateEncoder::findLongestMatch(uint32_t position,
+                                          uint32_t candidate,
+                                          uint32_t previous_length,
+                                          uint32_t* distance) {
+    uint32_t max_length = std::min(window_end_ - position,
+                                   (uint32_t)DEFLATE_MAX_MATCH);
+    if (previous_length >= max_length) {
+        return 0;
+    }
+
+    uint32_t chain_length = parameters_.chain_length;
+    if (previous_length >= parameters_.good_length) {
+        chain_length >>= 2;
+    }
+    uint32_t nice_length = std::min((uint32_t)parameters_.nice_length,
+                                    max_length);
+    uint32_t stream_position = window_start_ + position;
+    const uint8_t* current = window_ + position;
+    uint32_t best_length = previous_length;
+    uint32_t found_length = 0;
+    while (candidate != 0 && chain_length-- > 0) {
+        uint32_t match_position = candidate - 1;
+        uint32_t match_distance = stream_position - match_position;
+        if (match_distance > DEFLATE_WINDOW_SIZE) {
+            break;
+        }
+
+        const uint8_t* match = current - match_distance;
+        if (match[best_length] == current[best_length] &&
+            match[0] == current[0] && match[1] == current[1]) {
+            uint32_t length = matchLength(current, match, max_length);
+            if (length > best_length) {
+                best_length = length;
+                found_length = length;
+                *distance = match_distance;
+                if (length >= nice_length) {
+                    break;
+                }
+            }
+        }
+
+        uint32_t next = hash_chains_[match_position & DEFLATE_WINDOW_MASK];
+        if (next >= candidate) {
+            break;
+        }
+        candidate = next;
+    }
+
+    return found_length;
+}
+
+// Level 1, only runs of the same byte are matched, which is close to storing
+// for natural images while masks shrink a lot. Starts of runs are searched
+// 14 positions a time, with the bytes before them compared in a vector.
+void DeflateEncoder::findRuns(uint32_t limit) {
+    uint32_t position = position_;
+    if (window_start_ + position == 0 && position < limit) {
+        putLiteral(window_[position++]);
+    }
+
+    while (position < limit) {
+        uint32_t start = position;
+        while (position < limit) {
+            __m128i current = _mm_loadu_si128((const __m128i*)(window_ +
+                                                               position));
+            __m128i before = _mm_loadu_si128((const __m128i*)(window_ +
+                                                              position - 1));
+            uint32_t mask = _mm_movemask_epi8(_mm_cmpeq_epi8(current,
+                                                             before));
+            mask &= (mask >> 1) & (mask >> 2) & 0x3FFF;
+            if (mask != 0) {
+                position += countTrailingZeros(mask);
+                break;
+            }
+            position += 14;
+        }
+        position = std::min(position, limit);
+        for (; start < position; start++) {
+            putLiteral(window_[start]);
+        }
+        if (position == limit) {
+            break;
+        }
+
+        uint32_t max_length = std::min(window_end_ - position,
+                                       (uint32_t)DEFLATE_MAX_MATCH);
+        uint32_t length = matchLength(window_ + position,
+                                      window_ + position - 1, max_length);
+        if (length >= DEFLATE_MIN_MATCH) {
+            putMatch(length, 1);
+            position += length;
+        }
+        else {
+            putLiteral(window_[position]);
+            position++;
+        }
+    }
+    position_ = position;
+}
+
+// Levels 2-3, the longest match found at a position is taken.
+void DeflateEncoder::findGreedyMatches(uint32_t limit) {
+    uint32_t position = position_;
+    while (position < limit) {
+        uint32_t length = 0, distance = 0;
+        if (position + 4 <= window_end_) {
+            uint32_t candidate = insertHash(position);
+            if (candidate != 0) {
+                length = findLongestMatch(position, candidate,
+                                          DEFLATE_MIN_MATCH - 1, &distance);
+            }
+        }
+        if (length == DEFLATE_MIN_MATCH && distance > DEFLATE_TOO_FAR) {
+            length = 0;
+        }
+
+        if (length >= DEFLATE_MIN_MATCH) {
+            putMatch(length, distance);
+            uint32_t end = position + length;
+            if (length <= parameters_.lazy_length) {
+                for (position++; position < end && position + 4 <= window_end_;
+                     position++) {
+                    insertHash(position);
+                }
+            }
+            position = end;
+        }
+        else {
+            putLiteral(window_[position]);
+            position++;
+        }
+    }
+    position_ = position;
+}
+
+// Levels 4-9, a match is emitted only if the next position does not start
+// a longer one. The pending match is settled at the limit, so that a block
+// covers whole symbols.
+void DeflateEncoder::findLazyMatches(uint32_t limit) {
+    uint32_t position = position_;
+    uint32_t previous_length = 0, previous_distance = 0;
+    bool match_available = false;
+    while (position < limit) {
+        uint32_t length = 0, distance = 0;
+        if (position + 4 <= window_end_) {
+            uint32_t candidate = insertHash(position);
+            if (candidate != 0 && previous_length < parameters_.lazy_length) {
+                length = findLongestMatch(position, candidate,
+                             std::max(previous_length,
+                                      (uint32_t)DEFLATE_MIN_MATCH - 1),
+                             &distance);
+                if (length == DEFLATE_MIN_MATCH &&
+                    distance > DEFLATE_TOO_FAR) {
+                    length = 0;
+                }
+            }
+        }
+
+        if (previous_length >= DEFLATE_MIN_MATCH && length == 0) {
+            putMatch(previous_length, previous_distance);
+            uint32_t end = position - 1 + previous_length;
+            for (position++; position < end && position + 4 <= window_end_;
+                 position++) {
+                insertHash(position);
+            }
+            position = end;
+            match_available = false;
+            previous_length = 0;
+        }
+        else {
+            if (match_available) {
+                putLiteral(window_[position - 1]);
+            }
+            match_available = true;
+            previous_length = length;
+            previous_distance = distance;
+            position++;
+        }
+    }
+
+    if (match_available) {
+        if (previous_length >= DEFLATE_MIN_MATCH) {
+            putMatch(previous_length, previous_distance);
+            uint32_t end = position - 1 + previous_length;
+            for (; position < end && position + 4 <= window_end_; position++) {
+                insertHash(position);
+            }
+            position = end;
+        }
+        else {
+            putLiteral(window_[position - 1]);
+        }
+    }
+    position_ = position;
+}
+
+void DeflateEncoder::writeSymbols(const uint16_t* literal_codes,
+                                  const uint8_t* literal_lengths,
+                                  const uint16_t* distance_codes,
+                                  const uint8_t* distance_lengths) {
+    for (uint32_t i = 0; i < symbol_number_; i++) {
+        uint32_t value = symbol_values_[i];
+        uint32_t distance = symbol_distances_[i];
+        if (distance == 0) {
+            putBits(literal_codes[value], literal_lengths[value]);
+        }
+        else {
+            uint32_t code = deflate_tables.length_codes[value];
+            putBits(literal_codes[257 + code], literal_lengths[257 + code]);
+            putBits(value + DEFLATE_MIN_MATCH - length_base[code],
+                    length_extra_bits[code]);
+            code = distanceCode(distance);
+            putBits(distance_codes[code], distance_lengths[code]);
+            putBits(distance - distance_base[code], distance_extra_bits[code]);
+        }
+    }
+    putBits(literal_codes[256], literal_lengths[256]);
+}
+
+void DeflateEncoder::writeStoredBlocks(bool final_block) {
+    uint32_t block_size = position_ - block_start_;
+    const uint8_t* data = window_ + block_start_;
+    do {
+        uint32_t size = std::min(block_size, (uint32_t)DEFLATE_STORED_SIZE);
+        block_size -= size;
+        putBits(final_block && block_size == 0 ? 1 : 0, 1);
+        putBits(STORED_SECTION, 2);
+        alignToByte();
+        output_[output_size_++] = (uint8_t)size;
+        output_[output_size_++] = (uint8_t)(size >> 8);
+        output_[output_size_++] = (uint8_t)~size;
+        output_[output_size_++] = (uint8_t)(~size >> 8);
+        memcpy(output_ + output_size_, data, size);
+        output_size_ += size;
+        data += size;
+    } while (block_size > 0);
+}
+
+// Emits the bytes from block_start_ to position_ as the smallest one of
+// stored, fixed huffman and dynamic huffman blocks.
+bool DeflateEncoder::flushBlock(bool final_block) {
+    uint32_t block_size = position_ - block_start_;
+    uint32_t stored_number = std::max((block_size + DEFLATE_STORED_SIZE - 1) /
+                                      DEFLATE_STORED_SIZE, 1u);
+    uint64_t stored_bits = ((uint64_t)block_size + stored_number * 5) * 8;
+    uint64_t fixed_bits = UINT64_MAX, dynamic_bits = UINT64_MAX;
+
+    uint8_t literal_lengths[SYMBOL_NUMBER], distance_lengths[32];
+    uint8_t length_lengths[19];
+    uint8_t length_symbols[286 + 30], length_extras[286 + 30];
+    uint32_t literal_number = 0, distance_number = 0;
+    uint32_t length_symbol_number = 0, length_order_number = 0;
+    if (level_ > 0) {
+        literal_frequencies_[256] = 1;
+
+        uint64_t extra_bits = 0;
+        for (uint32_t code = 0; code < 29; code++) {
+            extra_bits += (uint64_t)literal_frequencies_[257 + code] *
+                          length_extra_bits[code];
+        }
+        for (uint32_t code = 0; code < 30; code++) {
+            extra_bits += (uint64_t)distance_frequencies_[code] *
+                          distance_extra_bits[code];
+        }
+
+        fixed_bits = 3 + extra_bits;
+        for (uint32_t i = 0; i < 286; i++) {
+            fixed_bits += (uint64_t)literal_frequencies_[i] *
+                          default_length_sizes[i];
+        }
+        for (uint32_t i = 0; i < 30; i++) {
+            fixed_bits += (uint64_t)distance_frequencies_[i] *
+                          default_distance_sizes[i];
+        }
+
+        uint32_t literal_counts[SYMBOL_NUMBER], distance_counts[32];
+        memcpy(literal_counts, literal_frequencies_, sizeof(literal_counts));
+        memcpy(distance_counts, distance_frequencies_,
+               sizeof(distance_counts));
+        ensureTwoCodes(literal_counts, 286);
+        ensureTwoCodes(distance_counts, 30);
+        computeCodeLengths(literal_counts, 286, 15, literal_lengths);
+        computeCodeLengths(distance_counts, 30, 15, distance_lengths);
+        literal_lengths[286] = literal_lengths[287] = 0;
+        distance_lengths[30] = distance_lengths[31] = 0;
+
+        literal_number = 286;
+        while (literal_number > 257 && literal_lengths[literal_number - 1] == 0) {
+            literal_number--;
+        }
+        distance_number = 30;
+        while (distance_number > 1 &&
+               distance_lengths[distance_number - 1] == 0) {
+            distance_number--;
+        }
+        uint8_t code_lengths[286 + 30];
+        memcpy(code_lengths, literal_lengths, literal_number);
+        memcpy(code_lengths + literal_number, distance_lengths,
+               distance_number);
+        length_symbol_number = encodeCodeLengths(code_lengths,
+                                   literal_number + distance_number,
+                                   length_symbols, length_extras);
+
+        uint32_t length_counts[19] = {0};
+        for (uint32_t i = 0; i < length_symbol_number; i++) {
+            length_counts[length_symbols[i]]++;
+        }
+        ensureTwoCodes(length_counts, 19);
+        computeCodeLengths(length_counts, 19, 7, length_lengths);
+        length_order_number = 19;
+        while (length_order_number > 4 &&
+               length_lengths[length_dezigzag[length_order_number - 1]] ==
+               0) {
+            length_order_number--;
+        }
+
+        dynamic_bits = 3 + 14 + 3 * length_order_number + extra_bits +
+                       length_counts[16] * 2 + length_counts[17] * 3 +
+                       length_counts[18] * 7;
+        for (uint32_t i = 0; i < 19; i++) {
+            dynamic_bits += (uint64_t)length_counts[i] * length_lengths[i];
+        }
+        for (uint32_t i = 0; i < 286; i++) {
+            dynamic_bits += (uint64_t)literal_frequencies_[i] *
+                            literal_lengths[i];
+        }
+        for (uint32_t i = 0; i < 30; i++) {
+            dynamic_bits += (uint64_t)distance_frequencies_[i] *
+                            distance_lengths[i];
+        }
+    }
+
+    uint64_t huffman_bits = std::min(fixed_bits, dynamic_bits);
+    if (stored_bits <= huffman_bits) {
+        if (!reserveOutput(stored_bits >> 3)) {
+            return false;
+        }
+        writeStoredBlocks(final_block);
+    }
+    else if (fixed_bits <= dynamic_bits) {
+        if (!reserveOutput(fixed_bits >> 3)) {
+            return false;
+        }
+        putBits(final_block ? 1 : 0, 1);
+        putBits(STATIC_HUFFMAN, 2);
+        writeSymbols(deflate_tables.fixed_literal_codes, default_length_sizes,
+                     deflate_tables.fixed_distance_codes,
+                     default_distance_sizes);
+    }
+    else {
+        if (!reserveOutput(dynamic_bits >> 3)) {
+            return false;
+        }
+        uint16_t literal_codes[SYMBOL_NUMBER], distance_codes[32];
+        uint16_t length_codes[19];
+        computeCanonicalCodes(literal_lengths, SYMBOL_NUMBER, literal_codes);
+        computeCanonicalCodes(distance_lengths, 32, distance_codes);
+        computeCanonicalCodes(length_lengths, 19, length_codes);
+
+        putBits(final_block ? 1 : 0, 1);
+        putBits(DYNAMIC_HUFFMAN, 2);
+        putBits(literal_number - 257, 5);
+        putBits(distance_number - 1, 5);
+        putBits(length_order_number - 4, 4);
+        for (uint32_t i = 0; i < length_order_number; i++) {
+            putBits(length_lengths[length_dezigzag[i]], 3);
+        }
+        for (uint32_t i = 0; i < length_symbol_number; i++) {
+            uint32_t symbol = length_symbols[i];
+            putBits(length_codes[symbol], length_lengths[symbol]);
+            if (symbol >= 16) {
+                putBits(length_extras[i], symbol == 16 ? 2 :
+                                          (symbol == 17 ? 3 : 7));
+            }
+        }
+        writeSymbols(literal_codes, literal_lengths, distance_codes,
+                     distance_lengths);
+    }
+
+    block_start_ = position_;
+    symbol_number_ = 0;
+    memset(literal_frequencies_, 0, sizeof(literal_frequencies_));
+    memset(distance_frequencies_, 0, sizeof(distance_frequencies_));
 
     return true;
 }
 
+// Keeps the last DEFLATE_WINDOW_SIZE bytes before position_ as history, the
+// hash tables hold stream positions and stay valid.
+void DeflateEncoder::slideWindow() {
+    uint32_t offset = position_ - DEFLATE_WINDOW_SIZE;
+    memmove(window_, window_ + offset, window_end_ - offset);
+    window_start_ += offset;
+    window_end_   -= offset;
+    position_     -= offset;
+    block_start_   = position_;
+}
+
+bool DeflateEncoder::compress(const uint8_t* data, uint32_t size) {
+    adler_value_ = adler32(adler_value_, data, size);
+
+    while (size > 0) {
+        uint32_t count = std::min(size, DEFLATE_WINDOW_CAPACITY - window_end_);
+        memcpy(window_ + window_end_, data, count);
+        window_end_ += count;
+        data += count;
+        size -= count;
+        if (window_end_ < DEFLATE_WINDOW_CAPACITY) {
+            break;
+        }
+
+        // leaves a lookahead so that matches are not cut at the end.
+        uint32_t limit = window_end_ - DEFLATE_LOOKAHEAD;
+        if (level_ == 0) {
+            position_ = window_end_;
+        }
+        else if (level_ == 1) {
+            findRuns(limit);
+        }
+        else if (level_ < 4) {
+            findGreedyMatches(limit);
+        }
+        else {
+            findLazyMatches(limit);
+        }
+        if (!flushBlock(false)) {
+            return false;
+        }
+        slideWindow();
+    }
+
+    return true;
+}
+
+bool DeflateEncoder::finish() {
+    if (level_ == 0) {
+        position_ = window_end_;
+    }
+    else if (level_ == 1) {
+        findRuns(window_end_);
+    }
+    else if (level_ < 4) {
+        findGreedyMatches(window_end_);
+    }
+    else {
+        findLazyMatches(window_end_);
+    }
+    if (!flushBlock(true) || !reserveOutput(8)) {
+        return false;
+    }
+
+    alignToByte();
+    output_[output_size_++] = (uint8_t)(adler_value_ >> 24);
+    output_[output_size_++] = (uint8_t)(adler_value_ >> 16);
+    output_[output_size_++] = (uint8_t)(adler_value_ >> 8);
+    output_[output_size_++] = (uint8_t)adler_value_;
+
+    return true;
+}
+
+// Shuffles of B G R (A) pixels into R G B (A) ones, 16 bits samples are also
+// turned big endian. A row is converted 12 bytes a time for 3 channels,
+// 16 bytes a time otherwise.
+static const uint8_t png_shuffles[2][5][16] = {
+    {{0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15},
+     {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15},
+     {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15},
+     {2, 1, 0, 5, 4, 3, 8, 7, 6, 11, 10, 9, 12, 13, 14, 15},
+     {2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15}},
+    {{0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15},
+     {1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14},
+     {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15},
+     {5, 4, 3, 2, 1, 0, 11, 10, 9, 8, 7, 6, 12, 13, 14, 15},
+     {5, 4, 3, 2, 1, 0, 7, 6, 13, 12, 11, 10, 9, 8, 15, 14}},
+};
+
+static
+void convertRow(const uint8_t* input_row, uint32_t row_bytes,
+                uint32_t channels, uint32_t depth, uint8_t* output_row) {
+    if (channels == 1 && depth == 8) {
+        memcpy(output_row, input_row, row_bytes);
+        return;
+    }
+
+    const uint8_t* shuffle = png_shuffles[depth >> 4][channels];
+    __m128i index = _mm_loadu_si128((const __m128i*)shuffle);
+    uint32_t step = channels == 3 ? 12 : 16;
+    uint32_t i = 0;
+    for (; i + 16 <= row_bytes; i += step) {
+        __m128i pixels = _mm_loadu_si128((const __m128i*)(input_row + i));
+        _mm_storeu_si128((__m128i*)(output_row + i),
+                         _mm_shuffle_epi8(pixels, index));
+    }
+
+    uint32_t pixel_bytes = channels * (depth >> 3);
+    for (; i < row_bytes; i += pixel_bytes) {
+        for (uint32_t j = 0; j < pixel_bytes; j++) {
+            output_row[i + j] = input_row[i + shuffle[j]];
+        }
+    }
+}
+
+static inline
+__m128i predictPaeth(__m128i a, __m128i b, __m128i c) {
+    __m128i zeros = _mm_setzero_si128();
+    __m128i predictions[2];
+    for (int32_t i = 0; i < 2; i++) {
+        __m128i a_i16 = i == 0 ? _mm_unpacklo_epi8(a, zeros) :
+                                 _mm_unpackhi_epi8(a, zeros);
+        __m128i b_i16 = i == 0 ? _mm_unpacklo_epi8(b, zeros) :
+                                 _mm_unpackhi_epi8(b, zeros);
+        __m128i c_i16 = i == 0 ? _mm_unpacklo_epi8(c, zeros) :
+                                 _mm_unpackhi_epi8(c, zeros);
+        __m128i pa = _mm_sub_epi16(b_i16, c_i16);
+        __m128i pb = _mm_sub_epi16(a_i16, c_i16);
+        __m128i pc = _mm_abs_epi16(_mm_add_epi16(pa, pb));
+        pa = _mm_abs_epi16(pa);
+        pb = _mm_abs_epi16(pb);
+        __m128i min_ab = _mm_min_epi16(pa, pb);
+        __m128i target_ab = _mm_blendv_epi8(b_i16, a_i16,
+                                            _mm_cmpeq_epi16(min_ab, pa));
+        __m128i min_abc = _mm_min_epi16(min_ab, pc);
+        predictions[i] = _mm_blendv_epi8(c_i16, target_ab,
+                                         _mm_cmpeq_epi16(min_ab, min_abc));
+    }
+
+    return _mm_packus_epi16(predictions[0], predictions[1]);
+}
+
+// Residuals of 16 bytes with the filter, the bytes before the row are 0.
+static inline
+__m128i filterBytes(const uint8_t* current_row, const uint8_t* prior_row,
+                    uint32_t bytes_per_pixel, int32_t filter) {
+    __m128i x = _mm_loadu_si128((const __m128i*)current_row);
+    if (filter == FILTER_NONE) {
+        return x;
+    }
+    __m128i a = _mm_loadu_si128((const __m128i*)(current_row -
+                                                 bytes_per_pixel));
+    if (filter == FILTER_SUB) {
+        return _mm_sub_epi8(x, a);
+    }
+    __m128i b = _mm_loadu_si128((const __m128i*)prior_row);
+    if (filter == FILTER_UP) {
+        return _mm_sub_epi8(x, b);
+    }
+    if (filter == FILTER_AVERAGE) {
+        __m128i rounding = _mm_and_si128(_mm_xor_si128(a, b),
+                                         _mm_set1_epi8(1));
+        return _mm_sub_epi8(x, _mm_sub_epi8(_mm_avg_epu8(a, b), rounding));
+    }
+    __m128i c = _mm_loadu_si128((const __m128i*)(prior_row -
+                                                 bytes_per_pixel));
+    return _mm_sub_epi8(x, predictPaeth(a, b, c));
+}
+
+// Sums of absolute residuals as signed bytes, in 2 64-bit lanes.
+static inline
+__m128i sumResiduals(__m128i sum, __m128i residuals, __m128i mask) {
+    residuals = _mm_and_si128(_mm_abs_epi8(residuals), mask);
+
+    return _mm_add_epi64(sum, _mm_sad_epu8(residuals, _mm_setzero_si128()));
+}
+
+// Picks the filter whose residuals have the smallest sum of absolute values
+// as signed bytes, the heuristic recommended by the png specification. All
+// the filters are evaluated in one pass over the row.
+static
+int32_t chooseFilter(const uint8_t* current_row, const uint8_t* prior_row,
+                     uint32_t row_bytes, uint32_t bytes_per_pixel) {
+    static const uint8_t tail_masks[32] = {
+        0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+        0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+    __m128i ones = _mm_set1_epi8(1);
+    __m128i sums[5];
+    for (int32_t filter = FILTER_NONE; filter <= FILTER_PAETH; filter++) {
+        sums[filter] = _mm_setzero_si128();
+    }
+
+    for (uint32_t i = 0; i < row_bytes; i += 16) {
+        __m128i mask = _mm_set1_epi8(-1);
+        if (i + 16 > row_bytes) {
+            mask = _mm_loadu_si128((const __m128i*)(tail_masks + 16 -
+                                                    (row_bytes - i)));
+        }
+        const uint8_t* current = current_row + i;
+        const uint8_t* prior = prior_row + i;
+        __m128i x = _mm_loadu_si128((const __m128i*)current);
+        __m128i a = _mm_loadu_si128((const __m128i*)(current -
+                                                     bytes_per_pixel));
+        __m128i b = _mm_loadu_si128((const __m128i*)prior);
+        __m128i c = _mm_loadu_si128((const __m128i*)(prior -
+                                                     bytes_per_pixel));
+        __m128i average = _mm_sub_epi8(_mm_avg_epu8(a, b),
+                              _mm_and_si128(_mm_xor_si128(a, b), ones));
+        sums[FILTER_NONE] = sumResiduals(sums[FILTER_NONE], x, mask);
+        sums[FILTER_SUB] = sumResiduals(sums[FILTER_SUB],
+                                        _mm_sub_epi8(x, a), mask);
+        sums[FILTER_UP] = sumResiduals(sums[FILTER_UP],
+                                       _mm_sub_epi8(x, b), mask);
+        sums[FILTER_AVERAGE] = sumResiduals(sums[FILTER_AVERAGE],
+                                            _mm_sub_epi8(x, average), mask);
+        sums[FILTER_PAETH] = sumResiduals(sums[FILTER_PAETH],
+                                 _mm_sub_epi8(x, predictPaeth(a, b, c)),
+                                 mask);
+    }
+
+    int32_t best_filter = FILTER_NONE;
+    uint64_t best_sum = UINT64_MAX;
+    for (int32_t filter = FILTER_NONE; filter <= FILTER_PAETH; filter++) {
+        uint64_t halves[2];
+        _mm_storeu_si128((__m128i*)halves, sums[filter]);
+        uint64_t sum = halves[0] + halves[1];
+        if (sum < best_sum) {
+            best_sum = sum;
+            best_filter = filter;
+        }
+    }
+
+    return best_filter;
+}
+
+static
+void filterRow(const uint8_t* current_row, const uint8_t* prior_row,
+               uint32_t row_bytes, uint32_t bytes_per_pixel, int32_t filter,
+               uint8_t* output_row) {
+    for (uint32_t i = 0; i < row_bytes; i += 16) {
+        _mm_storeu_si128((__m128i*)(output_row + i),
+                         filterBytes(current_row + i, prior_row + i,
+                                     bytes_per_pixel, filter));
+    }
+}
+
+PngEncoder::PngEncoder(BytesWriter& file_data) {
+    file_data_ = &file_data;
+    compression_level_ = 1;
+}
+
+PngEncoder::~PngEncoder() {
+}
+
+bool PngEncoder::setParameter(int32_t key, int32_t value) {
+    if (key == IMWRITE_PNG_COMPRESSION) {
+        if (value < 0 || value > 9) {
+            LOG(ERROR) << "Invalid png compression level: " << value
+                       << ", it should be in 0-9.";
+            return false;
+        }
+        compression_level_ = value;
+    }
+
+    return true;
+}
+
+void PngEncoder::writeChunk(uint32_t chunk_type, const uint8_t* data,
+                            uint32_t size) {
+    uint8_t type[4] = {(uint8_t)(chunk_type >> 24),
+                       (uint8_t)(chunk_type >> 16),
+                       (uint8_t)(chunk_type >> 8), (uint8_t)chunk_type};
+    uint32_t crc = crc32(0, type, 4);
+    crc = crc32(crc, data, size);
+
+    file_data_->putDWordBigEndian(size);
+    file_data_->putBytes(type, 4);
+    if (size > 0) {
+        file_data_->putBytes(data, size);
+    }
+    file_data_->putDWordBigEndian(crc);
+}
+
+bool PngEncoder::encodeData(uint32_t height, uint32_t width,
+                            uint32_t channels, uint32_t depth,
+                            uint32_t stride, const uint8_t* image) {
+    static const uint8_t signature[8] = {137, 80, 78, 71, 13, 10, 26, 10};
+    uint8_t color_type = channels == 1 ? GRAY :
+                         (channels == 3 ? TRUE_COLOR : TRUE_COLOR_WITH_ALPHA);
+    uint8_t header[13] = {
+        (uint8_t)(width >> 24), (uint8_t)(width >> 16),
+        (uint8_t)(width >> 8), (uint8_t)width,
+        (uint8_t)(height >> 24), (uint8_t)(height >> 16),
+        (uint8_t)(height >> 8), (uint8_t)height,
+        (uint8_t)depth, color_type, DEFLATE, ADAPTIVE, NO_INTRLACE};
+    file_data_->putBytes(signature, 8);
+    writeChunk(png_IHDR, header, 13);
+
+    // 2 raw rows with 16 zero bytes before them for the left neighbours,
+    // and a filtered row led by the filter type, all padded for SIMD.
+    uint32_t bytes_per_pixel = channels * (depth >> 3);
+    uint32_t row_bytes = width * bytes_per_pixel;
+    uint32_t row_capacity = row_bytes + 32;
+    uint8_t* buffer = (uint8_t*)malloc(row_capacity * 3);
+    if (buffer == nullptr) {
+        LOG(ERROR) << "No enough memory to be allocated for png rows.";
+        return false;
+    }
+    memset(buffer, 0, row_capacity * 3);
+    uint8_t* current_row = buffer + 16;
+    uint8_t* prior_row = buffer + row_capacity + 16;
+    uint8_t* filtered_row = buffer + row_capacity * 2 + 15;
+
+    bool succeeded = deflater_.initialize(compression_level_);
+    for (uint32_t row = 0; succeeded && row < height; row++) {
+        convertRow(image + (size_t)row * stride, row_bytes, channels, depth,
+                   current_row);
+        int32_t filter = FILTER_NONE;
+        if (compression_level_ > 0) {
+            filter = chooseFilter(current_row, prior_row, row_bytes,
+                                  bytes_per_pixel);
+        }
+        filtered_row[0] = filter;
+        filterRow(current_row, prior_row, row_bytes, bytes_per_pixel, filter,
+                  filtered_row + 1);
+
+        succeeded = deflater_.compress(filtered_row, row_bytes + 1);
+        if (deflater_.outputSize() >= PNG_IDAT_SIZE) {
+            writeChunk(png_IDAT, deflater_.output(), deflater_.outputSize());
+            deflater_.clearOutput();
+        }
+        std::swap(current_row, prior_row);
+    }
+    free(buffer);
+
+    if (!succeeded || !deflater_.finish()) {
+        return false;
+    }
+    writeChunk(png_IDAT, deflater_.output(), deflater_.outputSize());
+    deflater_.clearOutput();
+    writeChunk(png_IEND, nullptr, 0);
+
+    return !file_data_->isFailed();
+}
+
 } //! namespace x86
 } //! namespace cv
 } //! namespace ppl
\ No newline at end of file
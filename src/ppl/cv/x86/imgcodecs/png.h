@@ -20,6 +20,7 @@
 
 #include "imagecodecs.h"
 #include "bytesreader.h"
+#include "byteswriter.h"
 #include "crc32.h"
 
 #include <string>
@@ -29,9 +30,12 @@ namespace cv {
 namespace x86 {
 
 #define PNG_SHIFT_SIZE 56
-#define ZLIB_FAST_BITS 9
+#define ZLIB_FAST_BITS 11
 #define ZLIB_FAST_MASK ((1 << ZLIB_FAST_BITS) - 1)
 #define SYMBOL_NUMBER 288
+#define DEFLATE_WINDOW_SIZE (1 << 15)
+#define DEFLATE_INPUT_SIZE (1 << 17)
+#define DEFLATE_HASH_BITS 15
 
 enum ColorTypes {
     GRAY = 0,
@@ -70,14 +74,24 @@ struct PngTime {
    uint8_t second;  // second of minute, 0 - 60 (for leap seconds)
 };
 
-// zlib-style huffman encoding, jpegs packs from left, zlib from right
+enum HuffmanTypes {
+    CODE_LENGTH_CODES = 0,
+    LITERAL_LENGTH_CODES = 1,
+    DISTANCE_CODES = 2,
+};
+
+// zlib-style huffman encoding, jpegs packs from left, zlib from right.
+// The fast table is indexed with the next ZLIB_FAST_BITS bits, an entry holds
+// bits 0-4: the bits consumed, codes and extra bits; bits 5-8: the bits of
+// the first code; bits 9-12: the extra bits; bits 13-15: flags; bits 16-31:
+// one or two literals, the length/distance base or the symbol.
 struct ZlibHuffman {
-   uint16_t fast[1 << ZLIB_FAST_BITS];
+   uint32_t fast[1 << ZLIB_FAST_BITS];
    uint16_t first_code[16];
    uint16_t first_symbol[16];
    int32_t max_code[17];
    uint8_t size[SYMBOL_NUMBER];
-   uint16_t value[SYMBOL_NUMBER];
+   uint32_t entry[SYMBOL_NUMBER];
 };
 
 struct ZlibBuffer {
@@ -88,6 +102,10 @@ struct ZlibBuffer {
     EncodingMethod encoding_method;
     uint32_t window_size;
     ZlibHuffman length_huffman, distance_huffman;
+
+    uint32_t adler_value;          // of the inflated data so far
+    uint32_t transmitted_adler32;  // at the end of the zlib stream
+    uint32_t adler32_bytes;        // the transmitted bytes read so far
 };
 
 struct DataChunk {
@@ -102,10 +120,21 @@ struct PngInfo {
     uint32_t palette_length;
     uint8_t alpha_values[6];
     uint8_t chunk_status;
-    uint8_t* decompressed_image_start;
+    // The inflated stream goes to a sliding window, which keeps the 32K back
+    // references reach and a few scanlines. Complete scanlines are defiltered
+    // and stored while they are still in cache.
+    uint8_t* window_buffer;             // owns the window and the rows
+    uint8_t* decompressed_image_start;  // the window
     uint8_t* decompressed_image_end;
-    uint8_t* decompressed_image;
-    uint8_t* defiltered_image;
+    uint8_t* decompressed_image;        // where the next inflated byte goes
+    uint8_t* scanline;                  // the first scanline not defiltered
+    uint32_t scanline_bytes;            // filter type byte and row bytes
+    uint32_t row;                       // image row of the scanline
+    uint8_t* prior_row;                 // defiltered previous scanline
+    uint8_t* recon_row;
+    uint8_t* expanded_row;              // 1/2/4-bit unpacked, 16-bit swapped
+    uint8_t* image;
+    uint32_t stride;
     ZlibBuffer zlib_buffer;
     bool fixed_huffman_done;
     bool header_after_idat;
@@ -117,6 +146,9 @@ class PngDecoder : public ImageDecoder {
     ~PngDecoder();
 
     bool readHeader() override;
+    // Called after readHeader().
+    bool setRoi(uint32_t top, uint32_t left, uint32_t height,
+                uint32_t width) override;
     bool decodeData(uint32_t stride, uint8_t* image) override;
 
   private:
@@ -137,7 +169,7 @@ class PngDecoder : public ImageDecoder {
     bool parsetRNS(PngInfo& png_info);
     bool parsehIST(PngInfo& png_info);
     bool parsebKGD(PngInfo& png_info);
-    bool parseIDATs(PngInfo& png_info, uint8_t* image, uint32_t stride);
+    bool parseIDATs(PngInfo& png_info);
     bool parseIEND(PngInfo& png_info);
     bool parsetUnknownChunk(PngInfo& png_info);
 
@@ -150,22 +182,22 @@ class PngDecoder : public ImageDecoder {
     uint32_t getNumber(ZlibBuffer *zlib_buffer, uint32_t bit_number);
     bool parseZlibUncompressedBlock(PngInfo& png_info);
     bool buildHuffmanCode(ZlibHuffman *huffman_coding, const uint8_t *sizelist,
-                          int32_t number);
-    bool buildHuffmanCode(ZlibHuffman *huffman_coding, const uint32_t size,
-                          int32_t number);
-    int32_t huffmanDecodeSlowly(ZlibBuffer *zlib_buffer,
-                                ZlibHuffman *huffman_coding);
+                          int32_t number, HuffmanTypes type);
     int32_t huffmanDecode(ZlibBuffer *zlib_buffer,
                           ZlibHuffman *huffman_coding);
     bool computeDynamicHuffman(ZlibBuffer *zlib_buffer);
+    int32_t inflateFast(ZlibBuffer *zlib_buffer, uint8_t* &output,
+                        uint8_t* output_limit);
     bool decodeHuffmanData(ZlibBuffer *zlib_buffer);
-    bool inflateImage(PngInfo& png_info, uint8_t* image, uint32_t stride);
-    bool deFilterImage(PngInfo& png_info, uint8_t* image, uint32_t stride);
-    bool deFilterImageTrueColor(PngInfo& png_info, uint8_t* image,
-                                uint32_t stride);
-    bool computeTransparency(PngInfo& png_info, uint8_t* image,
-                             uint32_t stride);
-    bool expandPalette(PngInfo& png_info, uint8_t* image, uint32_t stride);
+    bool inflateImage(PngInfo& png_info);
+    bool allocateWindow(PngInfo& png_info);
+    bool flushScanlines(PngInfo& png_info);
+    bool deFilterScanline(PngInfo& png_info, uint8_t* scanline);
+    void storeRow(PngInfo& png_info, uint8_t* recon_row, uint8_t* output_row);
+    void computeTransparency(PngInfo& png_info, uint8_t* input_row,
+                             uint8_t* output_row);
+    void expandPalette(PngInfo& png_info, uint8_t* input_row,
+                       uint8_t* output_row);
 
   private:
     BytesReader* file_data_;
@@ -177,6 +209,99 @@ class PngDecoder : public ImageDecoder {
     uint8_t filter_method_;
     uint8_t interlace_method_;
     uint32_t encoded_channels_;
+    uint32_t image_height_, image_width_;
+    uint32_t roi_top_, roi_left_;
+};
+
+// Parameters of a compression level, as the configuration table of zlib.
+struct DeflateLevel {
+    uint16_t good_length;   // searches a quarter of the chain beyond it
+    uint16_t lazy_length;   // no lazy evaluation beyond it
+    uint16_t nice_length;   // stops searching beyond it
+    uint16_t chain_length;  // the most candidates to be checked
+};
+
+// A zlib stream compressor. The input is gathered in a window holding
+// DEFLATE_WINDOW_SIZE bytes of history and up to DEFLATE_INPUT_SIZE new
+// bytes, the symbols of the new bytes make up a deflate block, which is
+// stored or huffman coded with the fixed or the optimal dynamic codes,
+// whichever is the smallest.
+class DeflateEncoder {
+  public:
+    DeflateEncoder();
+    ~DeflateEncoder();
+
+    // 0 stores the data, 1 only encodes runs of the same byte, 2-3 take
+    // the first match, 4-9 evaluate matches lazily.
+    bool initialize(int32_t level);
+    // The compressed data are appended to the output.
+    bool compress(const uint8_t* data, uint32_t size);
+    // Ends the stream with the final block and the ADLER32.
+    bool finish();
+    const uint8_t* output() const {return output_;}
+    uint32_t outputSize() const {return output_size_;}
+    void clearOutput() {output_size_ = 0;}
+
+  private:
+    void findRuns(uint32_t limit);
+    void findGreedyMatches(uint32_t limit);
+    void findLazyMatches(uint32_t limit);
+    uint32_t insertHash(uint32_t position);
+    uint32_t findLongestMatch(uint32_t position, uint32_t candidate,
+                              uint32_t previous_length, uint32_t* distance);
+    void putLiteral(uint8_t value);
+    void putMatch(uint32_t length, uint32_t distance);
+    bool flushBlock(bool final_block);
+    void writeStoredBlocks(bool final_block);
+    void writeSymbols(const uint16_t* literal_codes,
+                      const uint8_t* literal_lengths,
+                      const uint16_t* distance_codes,
+                      const uint8_t* distance_lengths);
+    void slideWindow();
+    bool reserveOutput(uint32_t size);
+    void putBits(uint32_t value, uint32_t bit_number);
+    void alignToByte();
+
+  private:
+    int32_t level_;
+    DeflateLevel parameters_;
+    uint8_t* window_;
+    uint32_t window_start_;  // stream position of window_[0]
+    uint32_t window_end_;    // bytes in the window
+    uint32_t block_start_;   // where the current block starts in the window
+    uint32_t position_;      // the next byte to be matched in the window
+    uint32_t* hash_heads_;   // stream positions + 1, 0 for none
+    uint32_t* hash_chains_;
+    uint8_t* symbol_values_;     // literals, or match lengths - 3
+    uint16_t* symbol_distances_; // 0 for literals
+    uint32_t symbol_number_;
+    uint32_t literal_frequencies_[SYMBOL_NUMBER];
+    uint32_t distance_frequencies_[32];
+    uint32_t adler_value_;
+    uint64_t bit_buffer_;
+    uint32_t bit_number_;
+    uint8_t* output_;
+    uint32_t output_size_;
+    uint32_t output_capacity_;
+};
+
+class PngEncoder : public ImageEncoder {
+  public:
+    PngEncoder(BytesWriter& file_data);
+    ~PngEncoder();
+
+    bool setParameter(int32_t key, int32_t value) override;
+    bool encodeData(uint32_t height, uint32_t width, uint32_t channels,
+                    uint32_t depth, uint32_t stride,
+                    const uint8_t* image) override;
+
+  private:
+    void writeChunk(uint32_t chunk_type, const uint8_t* data, uint32_t size);
+
+  private:
+    BytesWriter* file_data_;
+    DeflateEncoder deflater_;
+    int32_t compression_level_;
 };
 
 } //! namespace x86
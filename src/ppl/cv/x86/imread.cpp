@@ -16,6 +16,7 @@
 // under the License.
 
 #include "ppl/cv/x86/imread.h"
+#include "ppl/cv/x86/parallel.h"
 #include "imgcodecs/bytesreader.h"
 #include "imgcodecs/imagecodecs.h"
 #include "imgcodecs/bmp.h"
@@ -26,6 +27,8 @@
 #include <stdio.h>
 #include <string.h>
 #include <assert.h>
+#include <stdint.h>
+#include <atomic>
 
 #include "ppl/common/log.h"
 
@@ -66,41 +69,24 @@ bool detectFormat(BytesReader& file_data, ImageFormats* image_format) {
     return false;
 }
 
-RetCode Imread(const char* file_name, int* height, int* width, int* channels,
-               int* stride, uchar** image) {
-    assert(file_name != nullptr);
-    assert(height != nullptr);
-    assert(width != nullptr);
-    assert(channels != nullptr);
-    assert(stride != nullptr);
-    assert(image != nullptr);
-
-    RetCode code = RC_SUCCESS;
-    FILE* fp = fopen(file_name, "rb");
-    if (fp == nullptr) {
-        LOG(ERROR) << "failed to open the input file: " << file_name;
-        return RC_OTHER_ERROR;
-    }
-
-    BytesReader file_data(fp);
-    ImageFormats image_format;
-    bool succeeded = detectFormat(file_data, &image_format);
+static ImageDecoder* createDecoder(BytesReader& file_data,
+                                   ImageFormats* image_format) {
+    bool succeeded = detectFormat(file_data, image_format);
     if (succeeded == false) {
-        if (image_format == UNSUPPORTED) {
+        if (*image_format == UNSUPPORTED) {
             LOG(ERROR) << "unsupported image format.";
         }
-        fclose(fp);
-        return RC_OTHER_ERROR;
+        return nullptr;
     }
 
     ImageDecoder* decoder = nullptr;
-    if (image_format == BMP) {
+    if (*image_format == BMP) {
         decoder = new BmpDecoder(file_data);
     }
-    else if (image_format == JPEG) {
+    else if (*image_format == JPEG) {
         decoder = new JpegDecoder(file_data);
     }
-    else if (image_format == PNG) {
+    else if (*image_format == PNG) {
         decoder = new PngDecoder(file_data);
     }
     else {
@@ -109,41 +95,466 @@ RetCode Imread(const char* file_name, int* height, int* width, int* channels,
     succeeded = decoder->readHeader();
     if (succeeded == false) {
         LOG(ERROR) << "failed to read file header.";
-        fclose(fp);
+        delete decoder;
+        return nullptr;
+    }
+
+    return decoder;
+}
+
+// The stride Imread() allocates with, rows of 8-bit samples aligned with 4
+// bytes.
+static int getDecodingStride(const ImageDecoder* decoder) {
+    int stride = (decoder->width() * decoder->channels() + 3) & -4;
+
+    return stride;
+}
+
+static bool isValidScale(int scale) {
+    return scale == 1 || scale == 2 || scale == 4 || scale == 8;
+}
+
+// Only the jpeg decoder decodes at a reduced size, by 1/2, 1/4 and 1/8.
+static RetCode setDecodingScale(ImageDecoder* decoder, int scale) {
+    if (scale == 1) {
+        return RC_SUCCESS;
+    }
+
+    bool succeeded = decoder->setScale(scale);
+    if (succeeded == false) {
+        LOG(ERROR) << "decoding at 1/" << scale
+                   << " of the size is not supported by the image format.";
+        return RC_UNSUPPORTED;
+    }
+
+    return RC_SUCCESS;
+}
+
+static RetCode decodeImage(BytesReader& file_data, int* height, int* width,
+                           int* channels, int* stride, uchar** image,
+                           int scale) {
+    ImageFormats image_format;
+    ImageDecoder* decoder = createDecoder(file_data, &image_format);
+    if (decoder == nullptr) {
         return RC_OTHER_ERROR;
     }
+    RetCode code = setDecodingScale(decoder, scale);
+    if (code != RC_SUCCESS) {
+        delete decoder;
+        return code;
+    }
 
     *height   = decoder->height();
     *width    = decoder->width();
     *channels = decoder->channels();
-    if (image_format == PNG) {
-        int bytes = (decoder->depth() == 16 ? 2 : 1);
-        *stride = (decoder->width() * decoder->channels() * bytes + 1 + 15) &
-                   -16;
-    }
-    else {
-        *stride = (decoder->width() * decoder->channels() + 3) & -4;
-    }
+    *stride   = getDecodingStride(decoder);
     size_t size = (*stride) * (*height);
     assert(size < MAX_IMAGE_SIZE);
     (*image) = (uchar*)malloc(size);
     if (*image == nullptr) {
         LOG(ERROR) << "failed to allocate memory for the image.";
-        fclose(fp);
+        delete decoder;
         return RC_OUT_OF_MEMORY;
     }
 
-    succeeded = decoder->decodeData(*stride, (*image));
+    bool succeeded = decoder->decodeData(*stride, (*image));
+    delete decoder;
     if (succeeded == false) {
         LOG(ERROR) << "failed to decode the file data.";
-        fclose(fp);
+        free(*image);
+        *image = nullptr;
+        return RC_OTHER_ERROR;
+    }
+
+    return RC_SUCCESS;
+}
+
+static RetCode decodeImage(BytesReader& file_data, int* height, int* width,
+                           int* channels, int stride, uchar* image,
+                           size_t image_size, int scale) {
+    ImageFormats image_format;
+    ImageDecoder* decoder = createDecoder(file_data, &image_format);
+    if (decoder == nullptr) {
+        return RC_OTHER_ERROR;
+    }
+    RetCode code = setDecodingScale(decoder, scale);
+    if (code != RC_SUCCESS) {
+        delete decoder;
+        return code;
+    }
+
+    *height   = decoder->height();
+    *width    = decoder->width();
+    *channels = decoder->channels();
+    size_t row_bytes = (size_t)(*width) * (*channels);
+    if ((size_t)stride < row_bytes ||
+        image_size < (size_t)stride * (*height - 1) + row_bytes) {
+        LOG(ERROR) << "the output buffer can't hold a " << *height << "x"
+                   << *width << "x" << *channels << " image.";
+        delete decoder;
+        return RC_INVALID_VALUE;
+    }
+
+    bool succeeded = decoder->decodeData(stride, image);
+    delete decoder;
+    if (succeeded == false) {
+        LOG(ERROR) << "failed to decode the image data.";
+        return RC_OTHER_ERROR;
+    }
+
+    return RC_SUCCESS;
+}
+
+static RetCode checkRoi(const ImageDecoder* decoder, int top, int left,
+                        int height, int width) {
+    if (top < 0 || left < 0 || height <= 0 || width <= 0 ||
+        (int64_t)top + height > decoder->height() ||
+        (int64_t)left + width > decoder->width()) {
+        LOG(ERROR) << "the region of interest " << height << "x" << width
+                   << " at (" << top << ", " << left << ") is out of the "
+                   << decoder->height() << "x" << decoder->width() << " image.";
+        return RC_INVALID_VALUE;
+    }
+
+    return RC_SUCCESS;
+}
+
+/* Decodes the region of interest into image. A decoder which doesn't decode a
+ * region decodes the whole image into a temporary buffer, from which the
+ * region is copied.
+ */
+static RetCode decodeRoi(ImageDecoder* decoder, int top, int left, int height,
+                         int width, int stride, uchar* image) {
+    int pixel_bytes = decoder->channels();
+    int decoding_stride = getDecodingStride(decoder);
+    int image_height = decoder->height();
+
+    bool succeeded = decoder->setRoi(top, left, height, width);
+    if (succeeded) {
+        succeeded = decoder->decodeData(stride, image);
+    }
+    else {
+        size_t size = (size_t)decoding_stride * image_height;
+        assert(size < MAX_IMAGE_SIZE);
+        uchar* buffer = (uchar*)malloc(size);
+        if (buffer == nullptr) {
+            LOG(ERROR) << "failed to allocate memory for the image.";
+            return RC_OUT_OF_MEMORY;
+        }
+        succeeded = decoder->decodeData(decoding_stride, buffer);
+        if (succeeded) {
+            uchar* src = buffer + (size_t)top * decoding_stride +
+                         left * pixel_bytes;
+            for (int row = 0; row < height; ++row) {
+                memcpy(image + (size_t)row * stride,
+                       src + (size_t)row * decoding_stride,
+                       (size_t)width * pixel_bytes);
+            }
+        }
+        free(buffer);
+    }
+    if (succeeded == false) {
+        LOG(ERROR) << "failed to decode the image data.";
+        return RC_OTHER_ERROR;
+    }
+
+    return RC_SUCCESS;
+}
+
+static RetCode decodeImageRoi(BytesReader& file_data, int top, int left,
+                              int height, int width, int* channels,
+                              int* stride, uchar** image) {
+    ImageFormats image_format;
+    ImageDecoder* decoder = createDecoder(file_data, &image_format);
+    if (decoder == nullptr) {
+        return RC_OTHER_ERROR;
+    }
+    RetCode code = checkRoi(decoder, top, left, height, width);
+    if (code != RC_SUCCESS) {
+        delete decoder;
+        return code;
+    }
+
+    *channels = decoder->channels();
+    *stride   = (width * (*channels) + 3) & -4;
+    *image = (uchar*)malloc((size_t)(*stride) * height);
+    if (*image == nullptr) {
+        LOG(ERROR) << "failed to allocate memory for the image.";
+        delete decoder;
+        return RC_OUT_OF_MEMORY;
+    }
+
+    code = decodeRoi(decoder, top, left, height, width, *stride, *image);
+    delete decoder;
+    if (code != RC_SUCCESS) {
+        free(*image);
+        *image = nullptr;
+    }
+
+    return code;
+}
+
+static RetCode decodeImageRoi(BytesReader& file_data, int top, int left,
+                              int height, int width, int* channels, int stride,
+                              uchar* image, size_t image_size) {
+    ImageFormats image_format;
+    ImageDecoder* decoder = createDecoder(file_data, &image_format);
+    if (decoder == nullptr) {
+        return RC_OTHER_ERROR;
+    }
+    RetCode code = checkRoi(decoder, top, left, height, width);
+    if (code != RC_SUCCESS) {
+        delete decoder;
+        return code;
+    }
+
+    *channels = decoder->channels();
+    size_t row_bytes = (size_t)width * (*channels);
+    if ((size_t)stride < row_bytes ||
+        image_size < (size_t)stride * (height - 1) + row_bytes) {
+        LOG(ERROR) << "the output buffer can't hold a " << height << "x"
+                   << width << "x" << *channels << " image.";
+        delete decoder;
+        return RC_INVALID_VALUE;
+    }
+
+    code = decodeRoi(decoder, top, left, height, width, stride, image);
+    delete decoder;
+
+    return code;
+}
+
+static RetCode probeImage(BytesReader& file_data, int* height, int* width,
+                          int* channels, int* depth, int* stride) {
+    ImageFormats image_format;
+    ImageDecoder* decoder = createDecoder(file_data, &image_format);
+    if (decoder == nullptr) {
         return RC_OTHER_ERROR;
     }
+
+    *height   = decoder->height();
+    *width    = decoder->width();
+    *channels = decoder->channels();
+    *depth    = decoder->depth();
+    *stride   = getDecodingStride(decoder);
+    delete decoder;
+
+    return RC_SUCCESS;
+}
+
+RetCode Imread(const char* file_name, int* height, int* width, int* channels,
+               int* stride, uchar** image) {
+    return Imread(file_name, height, width, channels, stride, image, 1);
+}
+
+RetCode Imread(const char* file_name, int* height, int* width, int* channels,
+               int* stride, uchar** image, int scale) {
+    assert(file_name != nullptr);
+    assert(height != nullptr);
+    assert(width != nullptr);
+    assert(channels != nullptr);
+    assert(stride != nullptr);
+    assert(image != nullptr);
+    if (!isValidScale(scale)) {
+        LOG(ERROR) << "invalid scale: " << scale << ", valid value: 1, 2, 4, 8.";
+        return RC_INVALID_VALUE;
+    }
+
+    FILE* fp = fopen(file_name, "rb");
+    if (fp == nullptr) {
+        LOG(ERROR) << "failed to open the input file: " << file_name;
+        return RC_OTHER_ERROR;
+    }
+
+    RetCode code;
+    {
+        BytesReader file_data(fp);
+        code = decodeImage(file_data, height, width, channels, stride, image,
+                           scale);
+    }
     fclose(fp);
 
     return code;
 }
 
+RetCode Imdecode(const uchar* data, size_t size, int* height, int* width,
+                 int* channels, int* stride, uchar** image) {
+    return Imdecode(data, size, height, width, channels, stride, image, 1);
+}
+
+RetCode Imdecode(const uchar* data, size_t size, int* height, int* width,
+                 int* channels, int* stride, uchar** image, int scale) {
+    assert(height != nullptr);
+    assert(width != nullptr);
+    assert(channels != nullptr);
+    assert(stride != nullptr);
+    assert(image != nullptr);
+    if (data == nullptr || size < 8 || size > UINT32_MAX) {
+        LOG(ERROR) << "invalid input buffer of " << size << " bytes.";
+        return RC_INVALID_VALUE;
+    }
+    if (!isValidScale(scale)) {
+        LOG(ERROR) << "invalid scale: " << scale << ", valid value: 1, 2, 4, 8.";
+        return RC_INVALID_VALUE;
+    }
+
+    BytesReader file_data(data, (uint32_t)size);
+    return decodeImage(file_data, height, width, channels, stride, image,
+                       scale);
+}
+
+RetCode Imdecode(const uchar* data, size_t size, int* height, int* width,
+                 int* channels, int stride, uchar* image, size_t imageSize) {
+    return Imdecode(data, size, height, width, channels, stride, image,
+                    imageSize, 1);
+}
+
+RetCode Imdecode(const uchar* data, size_t size, int* height, int* width,
+                 int* channels, int stride, uchar* image, size_t imageSize,
+                 int scale) {
+    assert(height != nullptr);
+    assert(width != nullptr);
+    assert(channels != nullptr);
+    assert(image != nullptr);
+    if (data == nullptr || size < 8 || size > UINT32_MAX) {
+        LOG(ERROR) << "invalid input buffer of " << size << " bytes.";
+        return RC_INVALID_VALUE;
+    }
+    if (!isValidScale(scale)) {
+        LOG(ERROR) << "invalid scale: " << scale << ", valid value: 1, 2, 4, 8.";
+        return RC_INVALID_VALUE;
+    }
+
+    BytesReader file_data(data, (uint32_t)size);
+    return decodeImage(file_data, height, width, channels, stride, image,
+                       imageSize, scale);
+}
+
+RetCode ImreadRoi(const char* file_name, int top, int left, int height,
+                  int width, int* channels, int* stride, uchar** image) {
+    assert(file_name != nullptr);
+    assert(channels != nullptr);
+    assert(stride != nullptr);
+    assert(image != nullptr);
+
+    FILE* fp = fopen(file_name, "rb");
+    if (fp == nullptr) {
+        LOG(ERROR) << "failed to open the input file: " << file_name;
+        return RC_OTHER_ERROR;
+    }
+
+    RetCode code;
+    {
+        BytesReader file_data(fp);
+        code = decodeImageRoi(file_data, top, left, height, width, channels,
+                              stride, image);
+    }
+    fclose(fp);
+
+    return code;
+}
+
+RetCode ImdecodeRoi(const uchar* data, size_t size, int top, int left,
+                    int height, int width, int* channels, int* stride,
+                    uchar** image) {
+    assert(channels != nullptr);
+    assert(stride != nullptr);
+    assert(image != nullptr);
+    if (data == nullptr || size < 8 || size > UINT32_MAX) {
+        LOG(ERROR) << "invalid input buffer of " << size << " bytes.";
+        return RC_INVALID_VALUE;
+    }
+
+    BytesReader file_data(data, (uint32_t)size);
+    return decodeImageRoi(file_data, top, left, height, width, channels,
+                          stride, image);
+}
+
+RetCode ImdecodeRoi(const uchar* data, size_t size, int top, int left,
+                    int height, int width, int* channels, int stride,
+                    uchar* image, size_t imageSize) {
+    assert(channels != nullptr);
+    assert(image != nullptr);
+    if (data == nullptr || size < 8 || size > UINT32_MAX) {
+        LOG(ERROR) << "invalid input buffer of " << size << " bytes.";
+        return RC_INVALID_VALUE;
+    }
+
+    BytesReader file_data(data, (uint32_t)size);
+    return decodeImageRoi(file_data, top, left, height, width, channels,
+                          stride, image, imageSize);
+}
+
+RetCode ImreadInfo(const char* file_name, int* height, int* width,
+                   int* channels, int* depth, int* stride) {
+    assert(file_name != nullptr);
+    assert(height != nullptr);
+    assert(width != nullptr);
+    assert(channels != nullptr);
+    assert(depth != nullptr);
+    assert(stride != nullptr);
+
+    FILE* fp = fopen(file_name, "rb");
+    if (fp == nullptr) {
+        LOG(ERROR) << "failed to open the input file: " << file_name;
+        return RC_OTHER_ERROR;
+    }
+
+    RetCode code;
+    {
+        BytesReader file_data(fp, true);
+        code = probeImage(file_data, height, width, channels, depth, stride);
+    }
+    fclose(fp);
+
+    return code;
+}
+
+RetCode ImdecodeInfo(const uchar* data, size_t size, int* height, int* width,
+                     int* channels, int* depth, int* stride) {
+    assert(height != nullptr);
+    assert(width != nullptr);
+    assert(channels != nullptr);
+    assert(depth != nullptr);
+    assert(stride != nullptr);
+    if (data == nullptr || size < 8 || size > UINT32_MAX) {
+        LOG(ERROR) << "invalid input buffer of " << size << " bytes.";
+        return RC_INVALID_VALUE;
+    }
+
+    BytesReader file_data(data, (uint32_t)size);
+    return probeImage(file_data, height, width, channels, depth, stride);
+}
+
+static std::atomic<int> decoding_threads(0);
+
+RetCode SetImdecodeNumThreads(int numThreads) {
+    if (numThreads < 0) {
+        LOG(ERROR) << "invalid number of threads: " << numThreads;
+        return RC_INVALID_VALUE;
+    }
+    decoding_threads.store(numThreads);
+
+    return RC_SUCCESS;
+}
+
+int GetImdecodeNumThreads() {
+    int num_threads = decoding_threads.load();
+    return num_threads > 0 ? num_threads : GetNumThreads();
+}
+
+static std::atomic<bool> verifying_checksums(true);
+
+RetCode SetImdecodeVerifyChecksums(bool verify) {
+    verifying_checksums.store(verify);
+
+    return RC_SUCCESS;
+}
+
+bool GetImdecodeVerifyChecksums() {
+    return verifying_checksums.load();
+}
+
 }  // namespace x86
 }  // namespace cv
 }  // namespace ppl
@@ -23,6 +23,9 @@
 #include <stdio.h>
 #include <assert.h>
 #include <string.h>
+#include <algorithm>
+#include <string>
+#include <vector>
 
 #include "opencv2/imgproc.hpp"
 #include "opencv2/imgcodecs.hpp"
@@ -33,6 +36,7 @@
 #include "ppl/cv/x86/imgcodecs/bmp.h"
 #include "ppl/cv/x86/imgcodecs/jpeg.h"
 #include "ppl/cv/cuda/utility/infrastructure.hpp"
+#include "ppl/common/x86/sysinfo.h"
 
 using namespace ppl::cv::debug;
 
@@ -356,6 +360,19 @@ RUN_BMP_BENCHMARK(3, 16, ppl::cv::x86::BMP_RGB)
 RUN_BMP_BENCHMARK(3, 24, ppl::cv::x86::BMP_RGB)
 RUN_BMP_BENCHMARK(4, 32, ppl::cv::x86::BMP_RGB)
 
+// 24-bit bitmaps decode with little more than a copy, so reading the file
+// dominates: tiny files are read at once, large ones are memory mapped.
+#define RUN_BMP_FILE_BENCHMARK(width, height)                                  \
+BENCHMARK_TEMPLATE(BM_ImreadBmp_opencv_x86, 3, 24, ppl::cv::x86::BMP_RGB)->    \
+                   Args({width, height});                                      \
+BENCHMARK_TEMPLATE(BM_ImreadBmp_ppl_x86, 3, 24, ppl::cv::x86::BMP_RGB)->       \
+                   Args({width, height});
+
+RUN_BMP_FILE_BENCHMARK(32, 32)
+RUN_BMP_FILE_BENCHMARK(128, 128)
+RUN_BMP_FILE_BENCHMARK(3840, 2160)
+RUN_BMP_FILE_BENCHMARK(7680, 4320)
+
 /***************************** Jpeg benchmark *****************************/
 
 template <int channels>
@@ -589,4 +606,387 @@ BENCHMARK_TEMPLATE(BM_ImreadPNG_ppl_x86, uchar)->Args({15})->UseManualTime();  \
 BENCHMARK_TEMPLATE(BM_ImreadPNG_opencv_x86, uchar)->Args({16});                \
 BENCHMARK_TEMPLATE(BM_ImreadPNG_ppl_x86, uchar)->Args({16})->UseManualTime();
 
-RUN_PNG_BENCHMARK(uchar)
\ No newline at end of file
+RUN_PNG_BENCHMARK(uchar)
+/***************************** Imdecode benchmark *****************************/
+
+std::vector<uchar> readFileData(const std::string& file_name) {
+    std::vector<uchar> data;
+    FILE* fp = fopen(file_name.c_str(), "rb");
+    if (fp == nullptr) return data;
+    fseek(fp, 0, SEEK_END);
+    data.resize(ftell(fp));
+    fseek(fp, 0, SEEK_SET);
+    size_t size = fread(data.data(), 1, data.size(), fp);
+    data.resize(size);
+    fclose(fp);
+
+    return data;
+}
+
+std::string getImageName(bool is_png, int index) {
+    if (is_png) {
+        return "data/pngs/png" + std::to_string(index) + ".png";
+    }
+    else {
+        return "data/jpegs/progressive" + std::to_string(index) + ".jpg";
+    }
+}
+
+// caller_buffer: decoding into a buffer reused across calls, which skips the
+// allocation and the page faults of a fresh image.
+template <bool is_png, bool caller_buffer>
+void BM_Imdecode_ppl_x86(benchmark::State &state) {
+    std::vector<uchar> data = readFileData(getImageName(is_png,
+                                                        state.range(0)));
+    int height, width, channels, stride;
+    uchar* image = nullptr;
+    ppl::cv::x86::Imdecode(data.data(), data.size(), &height, &width,
+                           &channels, &stride, &image);
+    size_t image_size = (size_t)stride * height;
+
+    for (auto _ : state) {
+        if (caller_buffer) {
+            ppl::cv::x86::Imdecode(data.data(), data.size(), &height, &width,
+                                   &channels, stride, image, image_size);
+        }
+        else {
+            uchar* decoded = nullptr;
+            ppl::cv::x86::Imdecode(data.data(), data.size(), &height, &width,
+                                   &channels, &stride, &decoded);
+            free(decoded);
+        }
+    }
+    free(image);
+    state.SetItemsProcessed(state.iterations() * 1);
+}
+
+template <bool is_png>
+void BM_Imdecode_opencv_x86(benchmark::State &state) {
+    std::vector<uchar> data = readFileData(getImageName(is_png,
+                                                        state.range(0)));
+    cv::Mat buffer(1, data.size(), CV_8UC1, data.data());
+    for (auto _ : state) {
+        cv::Mat cv_dst = cv::imdecode(buffer, cv::IMREAD_UNCHANGED);
+    }
+    state.SetItemsProcessed(state.iterations() * 1);
+}
+
+BENCHMARK_TEMPLATE(BM_Imdecode_opencv_x86, false)->DenseRange(0, 10);
+BENCHMARK_TEMPLATE(BM_Imdecode_ppl_x86, false, false)->DenseRange(0, 10);
+BENCHMARK_TEMPLATE(BM_Imdecode_ppl_x86, false, true)->DenseRange(0, 10);
+BENCHMARK_TEMPLATE(BM_Imdecode_opencv_x86, true)->DenseRange(0, 16);
+BENCHMARK_TEMPLATE(BM_Imdecode_ppl_x86, true, false)->DenseRange(0, 16);
+BENCHMARK_TEMPLATE(BM_Imdecode_ppl_x86, true, true)->DenseRange(0, 16);
+
+/**************************** ImreadInfo benchmark ****************************/
+
+template <bool is_png>
+void BM_ImreadInfo_ppl_x86(benchmark::State &state) {
+    std::string file_name = getImageName(is_png, state.range(0));
+    int height, width, channels, depth, stride;
+    for (auto _ : state) {
+        ppl::cv::x86::ImreadInfo(file_name.c_str(), &height, &width, &channels,
+                                 &depth, &stride);
+    }
+    state.SetItemsProcessed(state.iterations() * 1);
+}
+
+template <bool is_png>
+void BM_ImdecodeInfo_ppl_x86(benchmark::State &state) {
+    std::vector<uchar> data = readFileData(getImageName(is_png,
+                                                        state.range(0)));
+    int height, width, channels, depth, stride;
+    for (auto _ : state) {
+        ppl::cv::x86::ImdecodeInfo(data.data(), data.size(), &height, &width,
+                                   &channels, &depth, &stride);
+    }
+    state.SetItemsProcessed(state.iterations() * 1);
+}
+
+BENCHMARK_TEMPLATE(BM_ImreadInfo_ppl_x86, false)->DenseRange(0, 10);
+BENCHMARK_TEMPLATE(BM_ImdecodeInfo_ppl_x86, false)->DenseRange(0, 10);
+BENCHMARK_TEMPLATE(BM_ImreadInfo_ppl_x86, true)->DenseRange(0, 16);
+BENCHMARK_TEMPLATE(BM_ImdecodeInfo_ppl_x86, true)->DenseRange(0, 16);
+
+/************************* scaled Imdecode benchmark *************************/
+
+// Decoding jpeg images at 1/1, 1/2, 1/4 and 1/8 of the size.
+void BM_ImdecodeScale_ppl_x86(benchmark::State &state) {
+    std::vector<uchar> data = readFileData(getImageName(false,
+                                                        state.range(0)));
+    int scale = state.range(1);
+    int height, width, channels, stride;
+    for (auto _ : state) {
+        uchar* decoded = nullptr;
+        ppl::cv::x86::Imdecode(data.data(), data.size(), &height, &width,
+                               &channels, &stride, &decoded, scale);
+        free(decoded);
+    }
+    state.SetItemsProcessed(state.iterations() * 1);
+}
+
+void BM_ImdecodeScale_opencv_x86(benchmark::State &state) {
+    std::vector<uchar> data = readFileData(getImageName(false,
+                                                        state.range(0)));
+    int scale = state.range(1);
+    int flag = scale == 8 ? cv::IMREAD_REDUCED_COLOR_8 :
+               scale == 4 ? cv::IMREAD_REDUCED_COLOR_4 :
+               scale == 2 ? cv::IMREAD_REDUCED_COLOR_2 : cv::IMREAD_COLOR;
+    cv::Mat buffer(1, data.size(), CV_8UC1, data.data());
+    for (auto _ : state) {
+        cv::Mat cv_dst = cv::imdecode(buffer, flag);
+    }
+    state.SetItemsProcessed(state.iterations() * 1);
+}
+
+#define RUN_SCALE_BENCHMARK(index)                                             \
+BENCHMARK(BM_ImdecodeScale_opencv_x86)->Args({index, 1})->Args({index, 2})->   \
+    Args({index, 4})->Args({index, 8});                                        \
+BENCHMARK(BM_ImdecodeScale_ppl_x86)->Args({index, 1})->Args({index, 2})->      \
+    Args({index, 4})->Args({index, 8});
+
+RUN_SCALE_BENCHMARK(5)
+RUN_SCALE_BENCHMARK(6)
+RUN_SCALE_BENCHMARK(9)
+
+/**************************** ImdecodeRoi benchmark ***************************/
+
+// Decoding a 256x256 region at the top left, the center and the bottom right
+// of a jpeg image, position 0/1/2, against cropping a full decoding.
+template <bool crop>
+void BM_ImdecodeRoi_ppl_x86(benchmark::State &state) {
+    std::vector<uchar> data = readFileData(getImageName(false,
+                                                        state.range(0)));
+    int position = state.range(1);
+    int height, width, channels, depth, stride;
+    ppl::cv::x86::ImdecodeInfo(data.data(), data.size(), &height, &width,
+                               &channels, &depth, &stride);
+    int roi_height = std::min(height, 256);
+    int roi_width  = std::min(width, 256);
+    int top  = (height - roi_height) * position / 2;
+    int left = (width - roi_width) * position / 2;
+
+    for (auto _ : state) {
+        uchar* decoded = nullptr;
+        if (crop) {
+            ppl::cv::x86::Imdecode(data.data(), data.size(), &height, &width,
+                                   &channels, &stride, &decoded);
+        }
+        else {
+            ppl::cv::x86::ImdecodeRoi(data.data(), data.size(), top, left,
+                                      roi_height, roi_width, &channels,
+                                      &stride, &decoded);
+        }
+        free(decoded);
+    }
+    state.SetItemsProcessed(state.iterations() * 1);
+}
+
+#define RUN_ROI_BENCHMARK(index)                                               \
+BENCHMARK_TEMPLATE(BM_ImdecodeRoi_ppl_x86, true)->Args({index, 0});            \
+BENCHMARK_TEMPLATE(BM_ImdecodeRoi_ppl_x86, false)->Args({index, 0})->          \
+    Args({index, 1})->Args({index, 2});
+
+RUN_ROI_BENCHMARK(5)
+RUN_ROI_BENCHMARK(6)
+RUN_ROI_BENCHMARK(9)
+
+/*************************** jpeg stages benchmark ***************************/
+
+// The stages of decoding a 4:2:0 jpeg image of the given size. The entropy
+// stage is approximated by a decoding at 1/8, whose idct, upsampling and
+// color conversion handle 1/64 of the samples.
+void BM_JpegEntropy_ppl_x86(benchmark::State &state) {
+    std::vector<uchar> data = readFileData(getImageName(false,
+                                                        state.range(0)));
+    int height, width, channels, stride;
+    for (auto _ : state) {
+        uchar* decoded = nullptr;
+        ppl::cv::x86::Imdecode(data.data(), data.size(), &height, &width,
+                               &channels, &stride, &decoded, 8);
+        free(decoded);
+    }
+    state.SetItemsProcessed(state.iterations() * 1);
+}
+
+template <bool use_fma>
+void BM_JpegIdct_ppl_x86(benchmark::State &state) {
+    if (use_fma && !ppl::common::CpuSupports(ppl::common::ISA_X86_FMA)) {
+        state.SkipWithError("avx2 and fma are not supported.");
+        return;
+    }
+    int width  = state.range(0);
+    int height = state.range(1);
+    // luma and two quarter size chroma planes.
+    int blocks = (width >> 3) * (height >> 3) * 3 / 2;
+    std::vector<int16_t> coeffs((size_t)blocks * 64, 0);
+    std::vector<uint8_t> output((size_t)blocks * 64);
+    uint16_t dequant_table[64];
+    for (int i = 0; i < 64; i++) {
+        dequant_table[i] = 2 + i / 4;
+    }
+    // typical blocks have a few low frequency coefficients.
+    for (int i = 0; i < blocks; i++) {
+        randomFill<int16_t>(coeffs.data() + i * 64, 10, -64, 64);
+    }
+
+    for (auto _ : state) {
+        for (int i = 0; i < blocks; i++) {
+            ppl::cv::x86::idctBlock8x8(coeffs.data() + i * 64, dequant_table,
+                                       8, output.data() + i * 64, use_fma);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * 1);
+}
+
+void BM_JpegUpsample_ppl_x86(benchmark::State &state) {
+    int width  = state.range(0);
+    int height = state.range(1);
+    int chroma_width = (width + 1) >> 1;
+    std::vector<uint8_t> chroma((size_t)chroma_width * 2);
+    std::vector<uint8_t> output(width + 3);
+    randomFill<uint8_t>(chroma.data(), chroma.size(), 0, 255);
+
+    for (auto _ : state) {
+        // two chroma planes, every row interpolated from two lowres rows.
+        for (int row = 0; row < height * 2; row++) {
+            ppl::cv::x86::resampleRowHV2(output.data(), chroma.data(),
+                                         chroma.data() + chroma_width,
+                                         chroma_width, 2);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * 1);
+}
+
+template <bool use_fma>
+void BM_JpegColor_ppl_x86(benchmark::State &state) {
+    if (use_fma && !ppl::common::CpuSupports(ppl::common::ISA_X86_FMA)) {
+        state.SkipWithError("avx2 and fma are not supported.");
+        return;
+    }
+    int width  = state.range(0);
+    int height = state.range(1);
+    std::vector<uint8_t> planes((size_t)width * 3);
+    std::vector<uint8_t> output((size_t)width * 3);
+    randomFill<uint8_t>(planes.data(), planes.size(), 0, 255);
+    ppl::cv::x86::YCrCb2BGR ycrcb2bgr(width, 3, use_fma);
+
+    for (auto _ : state) {
+        for (int row = 0; row < height; row++) {
+            ycrcb2bgr.convertBGR(planes.data(), planes.data() + width,
+                                 planes.data() + width * 2, output.data());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * 1);
+}
+
+BENCHMARK(BM_JpegEntropy_ppl_x86)->Args({5})->Args({6})->Args({9});
+BENCHMARK_TEMPLATE(BM_JpegIdct_ppl_x86, false)->Args({640, 480})->
+    Args({1920, 1080});
+BENCHMARK_TEMPLATE(BM_JpegIdct_ppl_x86, true)->Args({640, 480})->
+    Args({1920, 1080});
+BENCHMARK(BM_JpegUpsample_ppl_x86)->Args({640, 480})->Args({1920, 1080});
+BENCHMARK_TEMPLATE(BM_JpegColor_ppl_x86, false)->Args({640, 480})->
+    Args({1920, 1080});
+BENCHMARK_TEMPLATE(BM_JpegColor_ppl_x86, true)->Args({640, 480})->
+    Args({1920, 1080});
+
+/*************************** png inflate benchmark ***************************/
+
+// A highly compressed png, smooth gradients at level 9 which are mostly long
+// matches, or a barely compressed one, noise at level 1 which is mostly
+// literals. OpenCV inflates with zlib.
+std::vector<uchar> createPngData(int width, int height, bool compressible) {
+    cv::Mat src;
+    int level;
+    if (compressible) {
+        src.create(height, width, CV_8UC3);
+        for (int row = 0; row < height; row++) {
+            uchar* pixels = src.ptr<uchar>(row);
+            for (int col = 0; col < width; col++) {
+                pixels[col * 3]     = (uchar)(col * 255 / width);
+                pixels[col * 3 + 1] = (uchar)(row * 255 / height);
+                pixels[col * 3 + 2] = (uchar)((col / 64 + row / 64) * 16);
+            }
+        }
+        level = 9;
+    }
+    else {
+        src = createSourceImage(height, width, CV_8UC3);
+        level = 1;
+    }
+
+    std::vector<uchar> data;
+    std::vector<int> params = {cv::IMWRITE_PNG_COMPRESSION, level};
+    cv::imencode(".png", src, data, params);
+
+    return data;
+}
+
+void BM_PngInflate_ppl_x86(benchmark::State &state) {
+    std::vector<uchar> data = createPngData(state.range(0), state.range(1),
+                                            state.range(2));
+    int height, width, channels, stride;
+    uchar* image = nullptr;
+    ppl::cv::x86::Imdecode(data.data(), data.size(), &height, &width,
+                           &channels, &stride, &image);
+    size_t image_size = (size_t)stride * height;
+
+    for (auto _ : state) {
+        ppl::cv::x86::Imdecode(data.data(), data.size(), &height, &width,
+                               &channels, stride, image, image_size);
+    }
+    free(image);
+    state.SetItemsProcessed(state.iterations() * 1);
+    state.SetBytesProcessed(state.iterations() * image_size);
+}
+
+void BM_PngInflate_opencv_x86(benchmark::State &state) {
+    std::vector<uchar> data = createPngData(state.range(0), state.range(1),
+                                            state.range(2));
+    cv::Mat buffer(1, data.size(), CV_8UC1, data.data());
+    cv::Mat cv_dst;
+    for (auto _ : state) {
+        cv::imdecode(buffer, cv::IMREAD_UNCHANGED, &cv_dst);
+    }
+    state.SetItemsProcessed(state.iterations() * 1);
+    state.SetBytesProcessed(state.iterations() * cv_dst.total() *
+                            cv_dst.elemSize());
+}
+
+#define RUN_INFLATE_BENCHMARK(compressible)                                    \
+BENCHMARK(BM_PngInflate_opencv_x86)->Args({1920, 1080, compressible})->        \
+    Args({4000, 3000, compressible});                                          \
+BENCHMARK(BM_PngInflate_ppl_x86)->Args({1920, 1080, compressible})->           \
+    Args({4000, 3000, compressible});
+
+RUN_INFLATE_BENCHMARK(1)
+RUN_INFLATE_BENCHMARK(0)
+
+/************************** png checksums benchmark **************************/
+
+template <bool verify>
+void BM_PngChecksums_ppl_x86(benchmark::State &state) {
+    std::vector<uchar> data = createPngData(state.range(0), state.range(1),
+                                            false);
+    int height, width, channels, stride;
+    uchar* image = nullptr;
+    ppl::cv::x86::Imdecode(data.data(), data.size(), &height, &width,
+                           &channels, &stride, &image);
+    size_t image_size = (size_t)stride * height;
+
+    ppl::cv::x86::SetImdecodeVerifyChecksums(verify);
+    for (auto _ : state) {
+        ppl::cv::x86::Imdecode(data.data(), data.size(), &height, &width,
+                               &channels, stride, image, image_size);
+    }
+    ppl::cv::x86::SetImdecodeVerifyChecksums(true);
+    free(image);
+    state.SetItemsProcessed(state.iterations() * 1);
+    state.SetBytesProcessed(state.iterations() * data.size());
+}
+
+BENCHMARK_TEMPLATE(BM_PngChecksums_ppl_x86, true)->Args({1920, 1080})->
+    Args({4000, 3000});
+BENCHMARK_TEMPLATE(BM_PngChecksums_ppl_x86, false)->Args({1920, 1080})->
+    Args({4000, 3000});
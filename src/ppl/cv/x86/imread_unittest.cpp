@@ -16,11 +16,16 @@
 // under the License.
 
 #include "ppl/cv/x86/imread.h"
+#include "ppl/cv/x86/imwrite.h"
+#include "ppl/cv/x86/isa.h"
+#include "ppl/cv/x86/parallel.h"
+#include "ppl/common/x86/sysinfo.h"
 
 #include <stdio.h>
 #include <assert.h>
 #include <string.h>
 #include <string>
+#include <vector>
 #include <assert.h>
 
 #include <tuple>
@@ -562,6 +567,119 @@ INSTANTIATE_TEST_CASE_P(IsEqual, PplCvX86ImreadJpegTest1,
     }
 );
 
+// Every tier SetIsaMask() can pin decodes the same image, the AVX2 idct and
+// YCrCb to BGR conversion of the FMA tier included, which OpenCV decodes up to
+// the rounding of the idct and of the chroma upsampling.
+bool decodeJpegWithIsas(const std::vector<uchar>& data) {
+    const uint32_t masks[] = {0xffffffffu,
+                              ~(uint32_t)ppl::common::ISA_X86_AVX512,
+                              (uint32_t)ppl::common::ISA_X86_SSE41};
+    cv::Mat cv_dst = cv::imdecode(data, cv::IMREAD_UNCHANGED);
+    cv::Mat dst0;
+    bool identity = true;
+    for (uint32_t mask : masks) {
+        ppl::cv::x86::SetIsaMask(mask);
+        int height, width, channels, stride;
+        uchar* image = nullptr;
+        ppl::common::RetCode code = ppl::cv::x86::Imdecode(data.data(),
+            data.size(), &height, &width, &channels, &stride, &image);
+        if (code != ppl::common::RC_SUCCESS) {
+            std::cout << "failed to decode the image with the isa mask 0x"
+                      << std::hex << mask << std::dec << "." << std::endl;
+            identity = false;
+            break;
+        }
+
+        cv::Mat dst(height, width, CV_MAKETYPE(CV_8U, channels), image,
+                    stride);
+        if (dst0.empty()) {
+            dst0 = dst.clone();
+            identity = dst.size() == cv_dst.size() &&
+                       dst.type() == cv_dst.type() &&
+                       cv::norm(cv_dst, dst, cv::NORM_INF) <= 4;
+        }
+        else if (cv::norm(dst0, dst, cv::NORM_INF) != 0) {
+            std::cout << "the isa mask 0x" << std::hex << mask << std::dec
+                      << " decodes a different image." << std::endl;
+            identity = false;
+        }
+        free(image);
+        if (!identity) break;
+    }
+    ppl::cv::x86::SetIsaMask(0xffffffffu);
+
+    return identity;
+}
+
+class PplCvX86ImreadJpegIsaTest : public ::testing::TestWithParam<Parameters1> {
+  public:
+    PplCvX86ImreadJpegIsaTest() {
+        const Parameters1& parameters = GetParam();
+        channels = std::get<0>(parameters);
+        size     = std::get<1>(parameters);
+    }
+
+    ~PplCvX86ImreadJpegIsaTest() {
+    }
+
+    bool apply();
+
+  private:
+    int channels;
+    cv::Size size;
+};
+
+// 4:2:0 baseline images from OpenCV, 4:2:2 and 4:4:4 ones from Imencode().
+bool PplCvX86ImreadJpegIsaTest::apply() {
+    cv::Mat src = createSourceImage(size.height, size.width,
+                                    CV_MAKETYPE(cv::DataType<uchar>::depth,
+                                    channels));
+    std::vector<uchar> data;
+    bool succeeded = cv::imencode(".jpg", src, data);
+    if (succeeded == false) {
+        std::cout << "failed to encode the image." << std::endl;
+        return false;
+    }
+    bool identity = decodeJpegWithIsas(data);
+
+    int samplings[2] = {ppl::cv::x86::IMWRITE_JPEG_SAMPLING_FACTOR_422,
+                        ppl::cv::x86::IMWRITE_JPEG_SAMPLING_FACTOR_444};
+    for (int i = 0; i < 2 && identity; i++) {
+        int params[] = {ppl::cv::x86::IMWRITE_JPEG_SAMPLING_FACTOR,
+                        samplings[i]};
+        size_t size0;
+        uchar* data0 = nullptr;
+        ppl::common::RetCode code = ppl::cv::x86::Imencode<uchar>(
+            ppl::cv::JPEG, src.rows, src.cols, channels, src.step, src.data,
+            2, params, &size0, &data0);
+        if (code != ppl::common::RC_SUCCESS) {
+            std::cout << "failed to encode the image." << std::endl;
+            return false;
+        }
+        identity = decodeJpegWithIsas(std::vector<uchar>(data0,
+                                                         data0 + size0));
+        free(data0);
+    }
+
+    return identity;
+}
+
+TEST_P(PplCvX86ImreadJpegIsaTest, Standard) {
+    bool identity = this->apply();
+    EXPECT_TRUE(identity);
+}
+
+INSTANTIATE_TEST_CASE_P(IsEqual, PplCvX86ImreadJpegIsaTest,
+    ::testing::Combine(
+        ::testing::Values(1, 3),
+        ::testing::Values(cv::Size{1, 1}, cv::Size{33, 7},
+                          cv::Size{321, 240}, cv::Size{1283, 720})),
+    [](const testing::TestParamInfo<PplCvX86ImreadJpegIsaTest::ParamType>&
+        info) {
+        return convertToStringJpeg(info.param);
+    }
+);
+
 /***************************** Png unittest *****************************/
 
 using Parameters1 = std::tuple<int, cv::Size>;
@@ -724,3 +842,647 @@ INSTANTIATE_TEST_CASE_P(IsEqual, PplCvX86ImreadPngTest1 ## T,                  \
 );
 
 PNG_UNITTEST1(uchar)
+
+void checkInflatedPng(const std::string& name) {
+    std::string png_image = "data/pngs/inflate_" + name + ".png";
+    cv::Mat cv_dst = cv::imread(png_image, cv::IMREAD_UNCHANGED);
+    int height, width, channels, stride;
+    uchar* image = nullptr;
+    ppl::common::RetCode code = ppl::cv::x86::Imread(png_image.c_str(),
+        &height, &width, &channels, &stride, &image);
+    ASSERT_EQ(code, ppl::common::RC_SUCCESS) << png_image;
+    ASSERT_EQ(height, cv_dst.rows) << png_image;
+    ASSERT_EQ(width, cv_dst.cols) << png_image;
+    ASSERT_EQ(channels, cv_dst.channels()) << png_image;
+
+    float epsilon = EPSILON_1F;
+    bool identity = checkDataIdentity<uchar>(cv_dst.data, image, height,
+                                             width, channels, cv_dst.step,
+                                             stride, epsilon);
+    free(image);
+    EXPECT_TRUE(identity) << png_image;
+}
+
+/* Small crafted images for the corners of the streaming inflater:
+ * inflate_stored_block: a stored block between two fixed huffman blocks;
+ * inflate_adler32_idat: the last IDAT holds nothing but the ADLER32;
+ * inflate_fixed_after_dynamic: fixed, dynamic and fixed huffman blocks;
+ * inflate_up_short_rows: Up filtered rows of 5 bytes;
+ * inflate_avg_first_row, inflate_paeth_first_row: Average or Paeth on the
+ *   first row of 3-channel images;
+ * inflate_window_wrap: matches 18KB back while the 32KB window turns over
+ *   several times;
+ * inflate_one_byte_idats: every byte of the zlib stream, the header and the
+ *   LEN/NLEN of a stored block included, in an IDAT of its own.
+ */
+TEST(PplCvX86ImreadPngInflateTest, Standard) {
+    const char* names[] = {"stored_block", "adler32_idat",
+                           "fixed_after_dynamic", "up_short_rows",
+                           "avg_first_row", "paeth_first_row", "window_wrap",
+                           "one_byte_idats"};
+    for (const char* name : names) {
+        checkInflatedPng(name);
+    }
+}
+
+/* zlib streams for the fast path of decodeHuffmanData():
+ * inflate_literal_pairs: literals only with codes of 1-15 bits, two short
+ *   ones share an entry of the multi-symbol table;
+ * inflate_distance_one: runs of one byte, 317KB of matches at distance 1
+ *   which cross the end of the inflating window several times;
+ * inflate_short_distances: repeated patterns of 2-15 bytes, matches at
+ *   distances below 8 and below 16 over 472KB;
+ * inflate_match_at_end: one color, the last match ends at the last byte of
+ *   the image.
+ */
+TEST(PplCvX86ImreadPngInflateTest, FastPath) {
+    const char* names[] = {"literal_pairs", "distance_one", "short_distances",
+                           "match_at_end"};
+    for (const char* name : names) {
+        checkInflatedPng(name);
+    }
+}
+
+/***************************** Imdecode unittest *****************************/
+
+bool readFileData(const std::string& file_name, std::vector<uchar>& data) {
+    FILE* fp = fopen(file_name.c_str(), "rb");
+    if (fp == nullptr) {
+        std::cout << "failed to open " << file_name << "." << std::endl;
+        return false;
+    }
+    fseek(fp, 0, SEEK_END);
+    long size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    data.resize(size);
+    size_t read_size = fread(data.data(), 1, size, fp);
+    fclose(fp);
+
+    return read_size == (size_t)size;
+}
+
+// progressive images dequantize in the idct, see decodeJpegWithIsas().
+TEST(PplCvX86ImreadJpegIsaFileTest, Standard) {
+    for (int i = 0; i < 11; i++) {
+        std::string jpeg_image = "data/jpegs/progressive" + std::to_string(i) +
+                                 ".jpg";
+        std::vector<uchar> data;
+        ASSERT_TRUE(readFileData(jpeg_image, data)) << jpeg_image;
+        EXPECT_TRUE(decodeJpegWithIsas(data)) << jpeg_image;
+    }
+}
+
+class PplCvX86ImdecodeTest : public ::testing::TestWithParam<Parameters1> {
+  public:
+    PplCvX86ImdecodeTest() {
+        const Parameters1& parameters = GetParam();
+        channels = std::get<0>(parameters);
+        size     = std::get<1>(parameters);
+    }
+
+    ~PplCvX86ImdecodeTest() {
+    }
+
+    bool apply(const std::string& file_name);
+
+  private:
+    int channels;
+    cv::Size size;
+};
+
+bool PplCvX86ImdecodeTest::apply(const std::string& file_name) {
+    std::vector<uchar> data;
+    if (!readFileData(file_name, data)) return false;
+
+    int height0, width0, channels0, stride0;
+    uchar* image0 = nullptr;
+    ppl::common::RetCode code = ppl::cv::x86::Imread(file_name.c_str(),
+        &height0, &width0, &channels0, &stride0, &image0);
+    if (code != ppl::common::RC_SUCCESS) return false;
+
+    // decoding into a library-allocated image.
+    int height1, width1, channels1, stride1;
+    uchar* image1 = nullptr;
+    code = ppl::cv::x86::Imdecode(data.data(), data.size(), &height1, &width1,
+                                  &channels1, &stride1, &image1);
+    bool identity = code == ppl::common::RC_SUCCESS && height1 == height0 &&
+                    width1 == width0 && channels1 == channels0;
+    if (identity) {
+        identity = checkDataIdentity<uchar>(image0, image1, height0, width0,
+                                            channels0, stride0, stride1,
+                                            EPSILON_1F);
+    }
+    if (image1 != nullptr) {
+        free(image1);
+    }
+
+    // decoding into a caller buffer, with the stride of Imread and with an
+    // unaligned buffer and stride.
+    int strides[2] = {stride0, stride0 + 5};
+    int offsets[2] = {0, 1};
+    for (int i = 0; i < 2 && identity; i++) {
+        size_t image_size = (size_t)strides[i] * height0;
+        std::vector<uchar> buffer(image_size + 16);
+        uchar* image2 = buffer.data() + offsets[i];
+        code = ppl::cv::x86::Imdecode(data.data(), data.size(), &height1,
+                                      &width1, &channels1, strides[i], image2,
+                                      image_size);
+        identity = code == ppl::common::RC_SUCCESS;
+        if (identity) {
+            identity = checkDataIdentity<uchar>(image0, image2, height0,
+                                                width0, channels0, stride0,
+                                                strides[i], EPSILON_1F);
+        }
+    }
+
+    // a buffer too small for the image is rejected.
+    if (identity) {
+        uchar buffer[16];
+        code = ppl::cv::x86::Imdecode(data.data(), data.size(), &height1,
+                                      &width1, &channels1, stride0, buffer,
+                                      sizeof(buffer));
+        identity = code == ppl::common::RC_INVALID_VALUE &&
+                   height1 == height0 && width1 == width0;
+    }
+    free(image0);
+
+    return identity;
+}
+
+TEST_P(PplCvX86ImdecodeTest, Standard) {
+    for (int i = 0; i < 11; i++) {
+        std::string jpeg_image = "data/jpegs/progressive" + std::to_string(i) +
+                                 ".jpg";
+        EXPECT_TRUE(this->apply(jpeg_image)) << jpeg_image;
+    }
+    for (int i = 0; i < 17; i++) {
+        std::string png_image = "data/pngs/png" + std::to_string(i) + ".png";
+        EXPECT_TRUE(this->apply(png_image)) << png_image;
+    }
+}
+
+INSTANTIATE_TEST_CASE_P(IsEqual, PplCvX86ImdecodeTest,
+    ::testing::Combine(
+        ::testing::Values(1),
+        ::testing::Values(cv::Size{1, 1})),
+    [](const testing::TestParamInfo<PplCvX86ImdecodeTest::ParamType>& info) {
+        return convertToStringJpeg(info.param);
+    }
+);
+
+/**************************** ImreadInfo unittest ****************************/
+
+class PplCvX86ImreadInfoTest : public ::testing::TestWithParam<Parameters1> {
+  public:
+    PplCvX86ImreadInfoTest() {
+        const Parameters1& parameters = GetParam();
+        channels = std::get<0>(parameters);
+        size     = std::get<1>(parameters);
+    }
+
+    ~PplCvX86ImreadInfoTest() {
+    }
+
+    bool apply(const std::string& file_name);
+
+  private:
+    int channels;
+    cv::Size size;
+};
+
+bool PplCvX86ImreadInfoTest::apply(const std::string& file_name) {
+    int height0, width0, channels0, stride0;
+    uchar* image0 = nullptr;
+    ppl::common::RetCode code = ppl::cv::x86::Imread(file_name.c_str(),
+        &height0, &width0, &channels0, &stride0, &image0);
+    if (code != ppl::common::RC_SUCCESS) return false;
+    free(image0);
+
+    int height1, width1, channels1, depth1, stride1;
+    code = ppl::cv::x86::ImreadInfo(file_name.c_str(), &height1, &width1,
+                                    &channels1, &depth1, &stride1);
+    bool identity = code == ppl::common::RC_SUCCESS && height1 == height0 &&
+                    width1 == width0 && channels1 == channels0 &&
+                    stride1 == stride0 && (depth1 == 8 || depth1 == 16);
+
+    std::vector<uchar> data;
+    if (!readFileData(file_name, data)) return false;
+    int height2, width2, channels2, depth2, stride2;
+    code = ppl::cv::x86::ImdecodeInfo(data.data(), data.size(), &height2,
+                                      &width2, &channels2, &depth2, &stride2);
+    identity &= code == ppl::common::RC_SUCCESS && height2 == height1 &&
+                width2 == width1 && channels2 == channels1 &&
+                depth2 == depth1 && stride2 == stride1;
+
+    return identity;
+}
+
+TEST_P(PplCvX86ImreadInfoTest, Standard) {
+    for (int i = 0; i < 11; i++) {
+        std::string jpeg_image = "data/jpegs/progressive" + std::to_string(i) +
+                                 ".jpg";
+        EXPECT_TRUE(this->apply(jpeg_image)) << jpeg_image;
+    }
+    for (int i = 0; i < 17; i++) {
+        std::string png_image = "data/pngs/png" + std::to_string(i) + ".png";
+        EXPECT_TRUE(this->apply(png_image)) << png_image;
+    }
+}
+
+INSTANTIATE_TEST_CASE_P(IsEqual, PplCvX86ImreadInfoTest,
+    ::testing::Combine(
+        ::testing::Values(1),
+        ::testing::Values(cv::Size{1, 1})),
+    [](const testing::TestParamInfo<PplCvX86ImreadInfoTest::ParamType>& info) {
+        return convertToStringJpeg(info.param);
+    }
+);
+
+/************************** scaled Imread unittest ***************************/
+
+class PplCvX86ImreadScaleTest : public ::testing::TestWithParam<Parameters1> {
+  public:
+    PplCvX86ImreadScaleTest() {
+        const Parameters1& parameters = GetParam();
+        channels = std::get<0>(parameters);
+        size     = std::get<1>(parameters);
+    }
+
+    ~PplCvX86ImreadScaleTest() {
+    }
+
+    bool apply(const std::string& file_name, int scale);
+
+  private:
+    int channels;
+    cv::Size size;
+};
+
+/* The reduced idcts drop the high frequencies and the chroma is not
+ * upsampled, so a scaled image only approximates the box filtered full size
+ * image, the mean absolute difference is checked.
+ */
+bool PplCvX86ImreadScaleTest::apply(const std::string& file_name, int scale) {
+    int height0, width0, channels0, stride0;
+    uchar* image0 = nullptr;
+    ppl::common::RetCode code = ppl::cv::x86::Imread(file_name.c_str(),
+        &height0, &width0, &channels0, &stride0, &image0);
+    if (code != ppl::common::RC_SUCCESS) return false;
+
+    int height1, width1, channels1, stride1;
+    uchar* image1 = nullptr;
+    code = ppl::cv::x86::Imread(file_name.c_str(), &height1, &width1,
+                                &channels1, &stride1, &image1, scale);
+    bool identity = code == ppl::common::RC_SUCCESS &&
+                    height1 == (height0 + scale - 1) / scale &&
+                    width1 == (width0 + scale - 1) / scale &&
+                    channels1 == channels0;
+    if (identity) {
+        int height = height0 / scale;
+        int width  = width0 / scale;
+        cv::Mat src(height * scale, width * scale,
+                    CV_MAKETYPE(cv::DataType<uchar>::depth, channels0), image0,
+                    stride0);
+        cv::Mat dst(height, width,
+                    CV_MAKETYPE(cv::DataType<uchar>::depth, channels1), image1,
+                    stride1);
+        cv::Mat cv_dst;
+        cv::resize(src, cv_dst, cv::Size(width, height), 0, 0,
+                   cv::INTER_AREA);
+        double difference = cv::norm(cv_dst, dst, cv::NORM_L1) /
+                            ((double)height * width * channels0);
+        identity = difference < 3.0;
+    }
+
+    // the caller buffer version decodes the same image.
+    if (identity) {
+        std::vector<uchar> data;
+        if (!readFileData(file_name, data)) return false;
+        size_t image_size = (size_t)stride1 * height1;
+        std::vector<uchar> image2(image_size);
+        int height2, width2, channels2;
+        code = ppl::cv::x86::Imdecode(data.data(), data.size(), &height2,
+                                      &width2, &channels2, stride1,
+                                      image2.data(), image_size, scale);
+        identity = code == ppl::common::RC_SUCCESS && height2 == height1 &&
+                   width2 == width1 && channels2 == channels1;
+        if (identity) {
+            identity = checkDataIdentity<uchar>(image1, image2.data(), height1,
+                                                width1, channels1, stride1,
+                                                stride1, EPSILON_1F);
+        }
+    }
+    free(image0);
+    if (image1 != nullptr) {
+        free(image1);
+    }
+
+    return identity;
+}
+
+TEST_P(PplCvX86ImreadScaleTest, Standard) {
+    for (int i = 0; i < 11; i++) {
+        std::string jpeg_image = "data/jpegs/progressive" + std::to_string(i) +
+                                 ".jpg";
+        for (int scale = 2; scale <= 8; scale *= 2) {
+            EXPECT_TRUE(this->apply(jpeg_image, scale)) << jpeg_image
+                << ", scale: 1/" << scale;
+        }
+    }
+
+    int height, width, channels, stride;
+    uchar* image = nullptr;
+    EXPECT_EQ(ppl::cv::x86::Imread("data/jpegs/progressive0.jpg", &height,
+              &width, &channels, &stride, &image, 3),
+              ppl::common::RC_INVALID_VALUE);
+    EXPECT_EQ(ppl::cv::x86::Imread("data/pngs/png0.png", &height, &width,
+              &channels, &stride, &image, 2), ppl::common::RC_UNSUPPORTED);
+}
+
+INSTANTIATE_TEST_CASE_P(IsEqual, PplCvX86ImreadScaleTest,
+    ::testing::Combine(
+        ::testing::Values(1),
+        ::testing::Values(cv::Size{1, 1})),
+    [](const testing::TestParamInfo<PplCvX86ImreadScaleTest::ParamType>& info) {
+        return convertToStringJpeg(info.param);
+    }
+);
+
+/**************************** ImreadRoi unittest *****************************/
+
+class PplCvX86ImreadRoiTest : public ::testing::TestWithParam<Parameters1> {
+  public:
+    PplCvX86ImreadRoiTest() {
+        const Parameters1& parameters = GetParam();
+        channels = std::get<0>(parameters);
+        size     = std::get<1>(parameters);
+    }
+
+    ~PplCvX86ImreadRoiTest() {
+    }
+
+    bool apply(const std::vector<uchar>& data);
+    bool apply();
+
+  private:
+    int channels;
+    cv::Size size;
+};
+
+// The regions decoded from data must be the same as those cropped out of the
+// whole image.
+bool PplCvX86ImreadRoiTest::apply(const std::vector<uchar>& data) {
+    int height0, width0, channels0, stride0;
+    uchar* image0 = nullptr;
+    ppl::common::RetCode code = ppl::cv::x86::Imdecode(data.data(),
+        data.size(), &height0, &width0, &channels0, &stride0, &image0);
+    if (code != ppl::common::RC_SUCCESS) return false;
+    int height1, width1, channels1, depth1, stride1;
+    code = ppl::cv::x86::ImdecodeInfo(data.data(), data.size(), &height1,
+                                      &width1, &channels1, &depth1, &stride1);
+    if (code != ppl::common::RC_SUCCESS) return false;
+    // 16-bit png images are compared byte by byte.
+    int pixel_bytes = channels0 * depth1 / 8;
+
+    int rois[][4] = {{0, 0, height0, width0},
+                     {0, 0, 1, 1},
+                     {height0 - 1, width0 - 1, 1, 1},
+                     {0, 0, (height0 + 1) / 2, (width0 + 1) / 2},
+                     {height0 / 3, width0 / 3, height0 / 3 + 1,
+                      width0 / 3 + 1},
+                     {height0 / 2, width0 / 4, height0 - height0 / 2,
+                      width0 / 2},
+                     {17, 33, height0 > 48 ? 31 : height0 - 17,
+                      width0 > 80 ? 47 : width0 - 33},
+                     {height0 - height0 / 5, 0, height0 / 5, width0}};
+    bool identity = true;
+    for (int i = 0; i < 8 && identity; i++) {
+        int top = rois[i][0], left = rois[i][1];
+        int height = rois[i][2], width = rois[i][3];
+        if (top < 0 || left < 0 || height <= 0 || width <= 0) continue;
+
+        uchar* image1 = nullptr;
+        code = ppl::cv::x86::ImdecodeRoi(data.data(), data.size(), top, left,
+                                         height, width, &channels1, &stride1,
+                                         &image1);
+        identity = code == ppl::common::RC_SUCCESS && channels1 == channels0;
+        uchar* crop = image0 + (size_t)top * stride0 + left * pixel_bytes;
+        if (identity) {
+            identity = checkDataIdentity<uchar>(crop, image1, height, width,
+                                                pixel_bytes, stride0, stride1,
+                                                EPSILON_1F);
+        }
+        if (image1 != nullptr) {
+            free(image1);
+        }
+
+        if (identity) {
+            int stride2 = width * pixel_bytes + 3;
+            std::vector<uchar> image2((size_t)stride2 * height);
+            code = ppl::cv::x86::ImdecodeRoi(data.data(), data.size(), top,
+                                             left, height, width, &channels1,
+                                             stride2, image2.data(),
+                                             image2.size());
+            identity = code == ppl::common::RC_SUCCESS;
+            if (identity) {
+                identity = checkDataIdentity<uchar>(crop, image2.data(),
+                                                    height, width, pixel_bytes,
+                                                    stride0, stride2,
+                                                    EPSILON_1F);
+            }
+        }
+    }
+
+    // a region out of the image is rejected.
+    if (identity) {
+        uchar* image1 = nullptr;
+        code = ppl::cv::x86::ImdecodeRoi(data.data(), data.size(), 1, 0,
+                                         height0, width0, &channels1, &stride1,
+                                         &image1);
+        identity = code == ppl::common::RC_INVALID_VALUE;
+    }
+    free(image0);
+
+    return identity;
+}
+
+// baseline jpeg images without and with restart markers.
+bool PplCvX86ImreadRoiTest::apply() {
+    cv::Mat src = createSourceImage(size.height, size.width,
+                                    CV_MAKETYPE(cv::DataType<uchar>::depth,
+                                    channels));
+    bool identity = true;
+    int intervals[3] = {0, 1, 5};
+    for (int i = 0; i < 3 && identity; i++) {
+        std::vector<uchar> data;
+        std::vector<int> params = {cv::IMWRITE_JPEG_RST_INTERVAL,
+                                   intervals[i]};
+        bool succeeded = cv::imencode(".jpg", src, data, params);
+        if (succeeded == false) {
+            std::cout << "failed to encode the image." << std::endl;
+            return false;
+        }
+        identity = apply(data);
+    }
+
+    return identity;
+}
+
+TEST_P(PplCvX86ImreadRoiTest, Standard) {
+    bool identity = this->apply();
+    EXPECT_TRUE(identity);
+}
+
+TEST_P(PplCvX86ImreadRoiTest, Files) {
+    for (int i = 0; i < 11; i++) {
+        std::string jpeg_image = "data/jpegs/progressive" + std::to_string(i) +
+                                 ".jpg";
+        std::vector<uchar> data;
+        ASSERT_TRUE(readFileData(jpeg_image, data)) << jpeg_image;
+        EXPECT_TRUE(this->apply(data)) << jpeg_image;
+    }
+    for (int i = 0; i < 17; i++) {
+        std::string png_image = "data/pngs/png" + std::to_string(i) + ".png";
+        std::vector<uchar> data;
+        ASSERT_TRUE(readFileData(png_image, data)) << png_image;
+        EXPECT_TRUE(this->apply(data)) << png_image;
+    }
+
+    int channels, stride;
+    uchar* image = nullptr;
+    EXPECT_EQ(ppl::cv::x86::ImreadRoi("data/jpegs/progressive0.jpg", 10, 20, 30,
+              40, &channels, &stride, &image), ppl::common::RC_SUCCESS);
+    free(image);
+}
+
+INSTANTIATE_TEST_CASE_P(IsEqual, PplCvX86ImreadRoiTest,
+    ::testing::Combine(
+        ::testing::Values(1, 3),
+        ::testing::Values(cv::Size{321, 240}, cv::Size{642, 480},
+                          cv::Size{1283, 720}, cv::Size{1920, 1080})),
+    [](const testing::TestParamInfo<PplCvX86ImreadRoiTest::ParamType>& info) {
+        return convertToStringJpeg(info.param);
+    }
+);
+
+/************************* Imdecode threads unittest *************************/
+
+bool decodeWithThreads(const std::vector<uchar>& data, int num_threads,
+                       std::vector<uchar>& image) {
+    ppl::cv::x86::SetImdecodeNumThreads(num_threads);
+    int height, width, channels, stride;
+    uchar* decoded = nullptr;
+    ppl::common::RetCode code = ppl::cv::x86::Imdecode(data.data(),
+        data.size(), &height, &width, &channels, &stride, &decoded);
+    if (code != ppl::common::RC_SUCCESS) return false;
+
+    // the padding at the end of the rows is not written.
+    int row_bytes = width * channels;
+    image.resize((size_t)row_bytes * height);
+    for (int row = 0; row < height; row++) {
+        memcpy(image.data() + (size_t)row * row_bytes,
+               decoded + (size_t)row * stride, row_bytes);
+    }
+    free(decoded);
+
+    return true;
+}
+
+TEST(PplCvX86ImdecodeThreadsTest, Standard) {
+    EXPECT_EQ(ppl::cv::x86::SetImdecodeNumThreads(-1),
+              ppl::common::RC_INVALID_VALUE);
+    EXPECT_EQ(ppl::cv::x86::SetImdecodeNumThreads(0), ppl::common::RC_SUCCESS);
+    EXPECT_EQ(ppl::cv::x86::GetImdecodeNumThreads(),
+              ppl::cv::x86::GetNumThreads());
+
+    std::vector<std::vector<uchar>> files;
+    for (int i = 0; i < 11; i++) {
+        std::string jpeg_image = "data/jpegs/progressive" + std::to_string(i) +
+                                 ".jpg";
+        std::vector<uchar> data;
+        ASSERT_TRUE(readFileData(jpeg_image, data)) << jpeg_image;
+        files.push_back(data);
+    }
+    cv::Mat src = createSourceImage(1080, 1920, CV_8UC3);
+    std::vector<uchar> baseline;
+    cv::imencode(".jpg", src, baseline);
+    files.push_back(baseline);
+
+    // the idct bands are decoded by the worker pool.
+    ppl::cv::x86::SetNumThreads(4);
+    for (size_t i = 0; i < files.size(); i++) {
+        std::vector<uchar> image0, image1;
+        ASSERT_TRUE(decodeWithThreads(files[i], 1, image0)) << i;
+        ASSERT_TRUE(decodeWithThreads(files[i], 4, image1)) << i;
+        EXPECT_TRUE(image0 == image1) << i;
+    }
+    ppl::cv::x86::SetNumThreads(0);
+    ppl::cv::x86::SetImdecodeNumThreads(0);
+}
+
+/************************ Imdecode checksums unittest ************************/
+
+uint32_t computeCrc32(const uchar* data, size_t size) {
+    uint32_t crc = 0xFFFFFFFF;
+    for (size_t i = 0; i < size; i++) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+        }
+    }
+
+    return ~crc;
+}
+
+uint32_t readBigEndian(const uchar* data) {
+    return ((uint32_t)data[0] << 24) | ((uint32_t)data[1] << 16) |
+           ((uint32_t)data[2] << 8) | data[3];
+}
+
+// Flips the last byte of the zlib stream, which is in the ADLER32 checksum,
+// and updates the crc of its IDAT chunk when fixing_crc is true.
+void corruptAdler32(std::vector<uchar>& data, bool fixing_crc) {
+    size_t offset = 8, last_idat = 0;
+    while (offset + 12 <= data.size()) {
+        uint32_t length = readBigEndian(data.data() + offset);
+        if (memcmp(data.data() + offset + 4, "IDAT", 4) == 0 && length > 0) {
+            last_idat = offset;
+        }
+        offset += length + 12;
+    }
+    uint32_t length = readBigEndian(data.data() + last_idat);
+    uchar* chunk = data.data() + last_idat + 4;
+    chunk[4 + length - 1] ^= 0x5A;
+    if (fixing_crc) {
+        uint32_t crc = computeCrc32(chunk, length + 4);
+        chunk[length + 4] = (uchar)(crc >> 24);
+        chunk[length + 5] = (uchar)(crc >> 16);
+        chunk[length + 6] = (uchar)(crc >> 8);
+        chunk[length + 7] = (uchar)crc;
+    }
+}
+
+TEST(PplCvX86ImdecodeChecksumsTest, Standard) {
+    EXPECT_TRUE(ppl::cv::x86::GetImdecodeVerifyChecksums());
+
+    // long enough for the folded crc and several blocks of ADLER32.
+    cv::Mat src = createSourceImage(480, 640, CV_8UC3);
+    std::vector<uchar> data;
+    cv::imencode(".png", src, data);
+    std::vector<uchar> image0, image1;
+    ASSERT_TRUE(decodeWithThreads(data, 0, image0));
+    std::vector<uchar> expected(src.data, src.data + src.total() * 3);
+    EXPECT_TRUE(image0 == expected);
+
+    for (int fixing_crc = 0; fixing_crc < 2; fixing_crc++) {
+        std::vector<uchar> corrupt_data = data;
+        corruptAdler32(corrupt_data, fixing_crc);
+
+        EXPECT_FALSE(decodeWithThreads(corrupt_data, 0, image1)) << fixing_crc;
+        ppl::cv::x86::SetImdecodeVerifyChecksums(false);
+        EXPECT_FALSE(ppl::cv::x86::GetImdecodeVerifyChecksums());
+        ASSERT_TRUE(decodeWithThreads(corrupt_data, 0, image1)) << fixing_crc;
+        EXPECT_TRUE(image0 == image1) << fixing_crc;
+        ppl::cv::x86::SetImdecodeVerifyChecksums(true);
+    }
+}
@@ -0,0 +1,238 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "ppl/cv/x86/imwrite.h"
+#include "imgcodecs/byteswriter.h"
+#include "imgcodecs/imagecodecs.h"
+#include "imgcodecs/png.h"
+#include "imgcodecs/jpeg.h"
+#include "imgcodecs/codecs.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+#include <assert.h>
+#include <stdint.h>
+
+#include "ppl/common/log.h"
+
+using namespace ppl::common;
+
+namespace ppl {
+namespace cv {
+namespace x86 {
+
+// The format is decided by the extension of the file name.
+static ImageFormats detectFormat(const char* file_name) {
+    const char* extension = strrchr(file_name, '.');
+    if (extension == nullptr) {
+        return UNSUPPORTED;
+    }
+
+    char lower[6] = {0};
+    size_t length = strlen(extension);
+    if (length > 5) {
+        return UNSUPPORTED;
+    }
+    for (size_t i = 0; i < length; i++) {
+        lower[i] = (char)tolower((unsigned char)extension[i]);
+    }
+    if (strcmp(lower, ".png") == 0) {
+        return PNG;
+    }
+    if (strcmp(lower, ".jpg") == 0 || strcmp(lower, ".jpeg") == 0) {
+        return JPEG;
+    }
+
+    return UNSUPPORTED;
+}
+
+static ImageEncoder* createEncoder(BytesWriter& file_data,
+                                   ImageFormats image_format) {
+    ImageEncoder* encoder = nullptr;
+    if (image_format == PNG) {
+        encoder = new PngEncoder(file_data);
+    }
+    else if (image_format == JPEG) {
+        encoder = new JpegEncoder(file_data);
+    }
+    else {
+        LOG(ERROR) << "unsupported image format for encoding.";
+    }
+
+    return encoder;
+}
+
+template <typename T>
+static RetCode checkImage(int height, int width, int channels, int stride,
+                          const T* image, int params_number,
+                          const int* params) {
+    if (image == nullptr || height <= 0 || width <= 0) {
+        LOG(ERROR) << "invalid image of " << height << "x" << width << ".";
+        return RC_INVALID_VALUE;
+    }
+    if (channels != 1 && channels != 3 && channels != 4) {
+        LOG(ERROR) << "invalid channels: " << channels
+                   << ", valid value: 1, 3, 4.";
+        return RC_INVALID_VALUE;
+    }
+    if (stride < width * channels) {
+        LOG(ERROR) << "invalid stride: " << stride << ", it should be "
+                   << "width * channels at least.";
+        return RC_INVALID_VALUE;
+    }
+    if ((size_t)height * width * channels * sizeof(T) > MAX_IMAGE_SIZE) {
+        LOG(ERROR) << "the image of " << height << "x" << width << "x"
+                   << channels << " is too large to be encoded.";
+        return RC_INVALID_VALUE;
+    }
+    if (params_number < 0 || (params_number & 1) != 0 ||
+        (params_number > 0 && params == nullptr)) {
+        LOG(ERROR) << "invalid parameters, they should be key and value "
+                   << "pairs.";
+        return RC_INVALID_VALUE;
+    }
+
+    return RC_SUCCESS;
+}
+
+template <typename T>
+static RetCode encodeImage(BytesWriter& file_data, ImageFormats image_format,
+                           int height, int width, int channels, int stride,
+                           const T* image, int params_number,
+                           const int* params) {
+    if (image_format == JPEG && sizeof(T) != 1) {
+        LOG(ERROR) << "only 8-bit images can be encoded into jpeg.";
+        return RC_UNSUPPORTED;
+    }
+
+    ImageEncoder* encoder = createEncoder(file_data, image_format);
+    if (encoder == nullptr) {
+        return RC_UNSUPPORTED;
+    }
+
+    for (int i = 0; i < params_number; i += 2) {
+        bool succeeded = encoder->setParameter(params[i], params[i + 1]);
+        if (succeeded == false) {
+            delete encoder;
+            return RC_INVALID_VALUE;
+        }
+    }
+
+    bool succeeded = encoder->encodeData(height, width, channels,
+                                         sizeof(T) * 8, stride * sizeof(T),
+                                         (const uint8_t*)image);
+    delete encoder;
+    if (succeeded == false) {
+        LOG(ERROR) << "failed to encode the image data.";
+        return RC_OTHER_ERROR;
+    }
+
+    return RC_SUCCESS;
+}
+
+template <typename T>
+RetCode Imwrite(const char* fileName, int height, int width, int channels,
+                int stride, const T* image, int paramsNumber,
+                const int* params) {
+    assert(fileName != nullptr);
+    RetCode code = checkImage(height, width, channels, stride, image,
+                              paramsNumber, params);
+    if (code != RC_SUCCESS) {
+        return code;
+    }
+
+    ImageFormats image_format = detectFormat(fileName);
+    if (image_format == UNSUPPORTED) {
+        LOG(ERROR) << "unsupported image format of the file: " << fileName;
+        return RC_UNSUPPORTED;
+    }
+
+    FILE* fp = fopen(fileName, "wb");
+    if (fp == nullptr) {
+        LOG(ERROR) << "failed to open the output file: " << fileName;
+        return RC_OTHER_ERROR;
+    }
+
+    {
+        BytesWriter file_data(fp);
+        code = encodeImage(file_data, image_format, height, width, channels,
+                           stride, image, paramsNumber, params);
+        if (code == RC_SUCCESS && !file_data.writeBlock()) {
+            code = RC_OTHER_ERROR;
+        }
+    }
+    if (fclose(fp) != 0 && code == RC_SUCCESS) {
+        LOG(ERROR) << "failed to close the output file: " << fileName;
+        code = RC_OTHER_ERROR;
+    }
+
+    return code;
+}
+
+template <typename T>
+RetCode Imwrite(const char* fileName, int height, int width, int channels,
+                int stride, const T* image) {
+    return Imwrite(fileName, height, width, channels, stride, image, 0,
+                   nullptr);
+}
+
+template <typename T>
+RetCode Imencode(ImageFormats format, int height, int width, int channels,
+                 int stride, const T* image, int paramsNumber,
+                 const int* params, size_t* size, uchar** data) {
+    assert(size != nullptr);
+    assert(data != nullptr);
+    RetCode code = checkImage(height, width, channels, stride, image,
+                              paramsNumber, params);
+    if (code != RC_SUCCESS) {
+        return code;
+    }
+    if (format != PNG && format != JPEG) {
+        LOG(ERROR) << "unsupported image format for encoding.";
+        return RC_UNSUPPORTED;
+    }
+
+    BytesWriter file_data;
+    if (file_data.isFailed()) {
+        LOG(ERROR) << "failed to allocate memory for the encoded data.";
+        return RC_OUT_OF_MEMORY;
+    }
+    code = encodeImage(file_data, format, height, width, channels, stride,
+                       image, paramsNumber, params);
+    if (code != RC_SUCCESS) {
+        return code;
+    }
+
+    *data = file_data.releaseData(size);
+    if (*data == nullptr) {
+        return RC_OUT_OF_MEMORY;
+    }
+
+    return RC_SUCCESS;
+}
+
+template ::ppl::common::RetCode Imwrite<uchar>(const char* fileName, int height, int width, int channels, int stride, const uchar* image, int paramsNumber, const int* params);
+template ::ppl::common::RetCode Imwrite<ushort>(const char* fileName, int height, int width, int channels, int stride, const ushort* image, int paramsNumber, const int* params);
+template ::ppl::common::RetCode Imwrite<uchar>(const char* fileName, int height, int width, int channels, int stride, const uchar* image);
+template ::ppl::common::RetCode Imwrite<ushort>(const char* fileName, int height, int width, int channels, int stride, const ushort* image);
+template ::ppl::common::RetCode Imencode<uchar>(ImageFormats format, int height, int width, int channels, int stride, const uchar* image, int paramsNumber, const int* params, size_t* size, uchar** data);
+template ::ppl::common::RetCode Imencode<ushort>(ImageFormats format, int height, int width, int channels, int stride, const ushort* image, int paramsNumber, const int* params, size_t* size, uchar** data);
+
+} //! namespace x86
+} //! namespace cv
+} //! namespace ppl
@@ -0,0 +1,151 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "ppl/cv/x86/imwrite.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+#include "opencv2/imgproc.hpp"
+#include "opencv2/imgcodecs.hpp"
+#include "benchmark/benchmark.h"
+
+#include "ppl/cv/debug.h"
+#include "ppl/cv/cuda/utility/infrastructure.hpp"
+
+using namespace ppl::cv::debug;
+
+/****************************** Png benchmark ******************************/
+
+// Smooth gradients as a natural image, or a mask of 0 and 255 in blocks.
+cv::Mat createPngImage(int width, int height, int channels, bool mask) {
+    cv::Mat src(height, width, CV_MAKETYPE(CV_8U, channels));
+    for (int row = 0; row < height; row++) {
+        uchar* pixels = src.ptr<uchar>(row);
+        for (int col = 0; col < width; col++) {
+            for (int channel = 0; channel < channels; channel++) {
+                int value;
+                if (mask) {
+                    value = ((col / 97 + row / 61) & 1) ? 255 : 0;
+                }
+                else {
+                    value = (col * (channel + 1) + row * 2) / 7 +
+                            rand() % 5;
+                }
+                pixels[col * channels + channel] = (uchar)value;
+            }
+        }
+    }
+
+    return src;
+}
+
+void BM_PngEncode_ppl_x86(benchmark::State &state) {
+    cv::Mat src = createPngImage(state.range(0), state.range(1),
+                                 state.range(2), state.range(3));
+    int params[] = {ppl::cv::x86::IMWRITE_PNG_COMPRESSION,
+                    (int)state.range(4)};
+    size_t size = 0;
+    for (auto _ : state) {
+        uchar* data = nullptr;
+        ppl::cv::x86::Imencode<uchar>(ppl::cv::PNG, src.rows, src.cols,
+                                      src.channels(), src.step, src.data, 2,
+                                      params, &size, &data);
+        free(data);
+    }
+    state.counters["Size"] = size;
+    state.SetItemsProcessed(state.iterations() * 1);
+    state.SetBytesProcessed(state.iterations() * src.total() *
+                            src.elemSize());
+}
+
+void BM_PngEncode_opencv_x86(benchmark::State &state) {
+    cv::Mat src = createPngImage(state.range(0), state.range(1),
+                                 state.range(2), state.range(3));
+    std::vector<int> params = {cv::IMWRITE_PNG_COMPRESSION,
+                               (int)state.range(4)};
+    std::vector<uchar> data;
+    for (auto _ : state) {
+        cv::imencode(".png", src, data, params);
+    }
+    state.counters["Size"] = data.size();
+    state.SetItemsProcessed(state.iterations() * 1);
+    state.SetBytesProcessed(state.iterations() * src.total() *
+                            src.elemSize());
+}
+
+#define RUN_BENCHMARK(channels, mask, level)                                   \
+BENCHMARK(BM_PngEncode_opencv_x86)->Args({1920, 1080, channels, mask,          \
+    level})->Args({4000, 3000, channels, mask, level});                        \
+BENCHMARK(BM_PngEncode_ppl_x86)->Args({1920, 1080, channels, mask, level})->   \
+    Args({4000, 3000, channels, mask, level});
+
+RUN_BENCHMARK(1, true, 1)
+RUN_BENCHMARK(3, false, 1)
+RUN_BENCHMARK(4, false, 1)
+RUN_BENCHMARK(3, false, 6)
+
+/***************************** Jpeg benchmark ******************************/
+
+// The huffman tables of ppl are always optimized, OpenCV(libjpeg-turbo) runs
+// with and without its optimized tables.
+void BM_JpegEncode_ppl_x86(benchmark::State &state) {
+    cv::Mat src = createPngImage(state.range(0), state.range(1),
+                                 state.range(2), false);
+    int params[] = {ppl::cv::x86::IMWRITE_JPEG_QUALITY, (int)state.range(3),
+                    ppl::cv::x86::IMWRITE_JPEG_SAMPLING_FACTOR,
+                    ppl::cv::x86::IMWRITE_JPEG_SAMPLING_FACTOR_420};
+    size_t size = 0;
+    for (auto _ : state) {
+        uchar* data = nullptr;
+        ppl::cv::x86::Imencode<uchar>(ppl::cv::JPEG, src.rows, src.cols,
+                                      src.channels(), src.step, src.data, 4,
+                                      params, &size, &data);
+        free(data);
+    }
+    state.counters["Size"] = size;
+    state.SetItemsProcessed(state.iterations() * 1);
+    state.SetBytesProcessed(state.iterations() * src.total() *
+                            src.elemSize());
+}
+
+void BM_JpegEncode_opencv_x86(benchmark::State &state) {
+    cv::Mat src = createPngImage(state.range(0), state.range(1),
+                                 state.range(2), false);
+    std::vector<int> params = {cv::IMWRITE_JPEG_QUALITY, (int)state.range(3),
+                               cv::IMWRITE_JPEG_OPTIMIZE, (int)state.range(4)};
+    std::vector<uchar> data;
+    for (auto _ : state) {
+        cv::imencode(".jpg", src, data, params);
+    }
+    state.counters["Size"] = data.size();
+    state.SetItemsProcessed(state.iterations() * 1);
+    state.SetBytesProcessed(state.iterations() * src.total() *
+                            src.elemSize());
+}
+
+#define RUN_JPEG_BENCHMARK(channels, quality)                                  \
+BENCHMARK(BM_JpegEncode_opencv_x86)->Args({1920, 1080, channels, quality, 0})  \
+    ->Args({1920, 1080, channels, quality, 1})->Args({4000, 3000, channels,    \
+    quality, 0})->Args({4000, 3000, channels, quality, 1});                    \
+BENCHMARK(BM_JpegEncode_ppl_x86)->Args({1920, 1080, channels, quality})->      \
+    Args({4000, 3000, channels, quality});
+
+RUN_JPEG_BENCHMARK(1, 95)
+RUN_JPEG_BENCHMARK(3, 75)
+RUN_JPEG_BENCHMARK(3, 95)
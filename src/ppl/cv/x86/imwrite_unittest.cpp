@@ -0,0 +1,406 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "ppl/cv/x86/imwrite.h"
+#include "ppl/cv/x86/imread.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include <tuple>
+#include <algorithm>
+#include <sstream>
+
+#include "opencv2/imgproc.hpp"
+#include "opencv2/imgcodecs.hpp"
+#include "gtest/gtest.h"
+
+#include "ppl/cv/cuda/utility/infrastructure.hpp"
+
+// Random pixels, or a mask of 0 and the maximum value in blocks, which is
+// mostly runs.
+template <typename T>
+cv::Mat createImwriteImage(int height, int width, int channels, bool mask) {
+    cv::Mat image = createSourceImage(height, width,
+                        CV_MAKETYPE(cv::DataType<T>::depth, channels));
+    if (mask) {
+        for (int row = 0; row < height; row++) {
+            T* pixels = image.ptr<T>(row);
+            for (int col = 0; col < width * channels; col++) {
+                pixels[col] = ((col / channels / 13 + row / 17) & 1) ?
+                              (T)~0 : 0;
+            }
+        }
+    }
+
+    return image;
+}
+
+using Parameters = std::tuple<int, int, bool, cv::Size>;
+inline std::string convertToStringPng(const Parameters& parameters) {
+    std::ostringstream formatted;
+
+    int channels = std::get<0>(parameters);
+    formatted << "Channels" << channels << "_";
+
+    int level = std::get<1>(parameters);
+    formatted << "Level" << level << "_";
+
+    bool mask = std::get<2>(parameters);
+    formatted << (mask ? "Mask" : "Random") << "_";
+
+    cv::Size size = std::get<3>(parameters);
+    formatted << size.width << "x";
+    formatted << size.height;
+
+    return formatted.str();
+}
+
+template <typename T>
+class PplCvX86ImwritePngTest : public ::testing::TestWithParam<Parameters> {
+  public:
+    PplCvX86ImwritePngTest() {
+        const Parameters& parameters = GetParam();
+        channels = std::get<0>(parameters);
+        level    = std::get<1>(parameters);
+        mask     = std::get<2>(parameters);
+        size     = std::get<3>(parameters);
+    }
+
+    ~PplCvX86ImwritePngTest() {
+    }
+
+    bool apply();
+
+  private:
+    int channels;
+    int level;
+    bool mask;
+    cv::Size size;
+};
+
+template <typename T>
+bool PplCvX86ImwritePngTest<T>::apply() {
+    cv::Mat src = createImwriteImage<T>(size.height, size.width, channels,
+                                        mask);
+    int params[] = {ppl::cv::x86::IMWRITE_PNG_COMPRESSION, level};
+
+    size_t size0;
+    uchar* data0 = nullptr;
+    ppl::common::RetCode code = ppl::cv::x86::Imencode<T>(ppl::cv::PNG,
+        src.rows, src.cols, channels, src.step / sizeof(T),
+        (const T*)src.data, 2, params, &size0, &data0);
+    if (code != ppl::common::RC_SUCCESS) {
+        std::cout << "failed to encode the image." << std::endl;
+        return false;
+    }
+    cv::Mat buffer(1, size0, CV_8UC1, data0);
+    cv::Mat cv_dst0 = cv::imdecode(buffer, cv::IMREAD_UNCHANGED);
+    bool identity0 = cv_dst0.size() == src.size() &&
+                     cv_dst0.type() == src.type() &&
+                     cv::norm(src, cv_dst0, cv::NORM_INF) == 0;
+    free(data0);
+
+    std::string file_name("test.png");
+    code = ppl::cv::x86::Imwrite<T>(file_name.c_str(), src.rows, src.cols,
+                                    channels, src.step / sizeof(T),
+                                    (const T*)src.data, 2, params);
+    if (code != ppl::common::RC_SUCCESS) {
+        std::cout << "failed to write the image to test.png." << std::endl;
+        return false;
+    }
+    cv::Mat cv_dst1 = cv::imread(file_name, cv::IMREAD_UNCHANGED);
+    bool identity1 = cv_dst1.size() == src.size() &&
+                     cv_dst1.type() == src.type() &&
+                     cv::norm(src, cv_dst1, cv::NORM_INF) == 0;
+    int result = remove(file_name.c_str());
+    if (result != 0) {
+        std::cout << "failed to delete test.png." << std::endl;
+    }
+
+    return identity0 && identity1;
+}
+
+#define PNG_UNITTEST(T)                                                        \
+using PplCvX86ImwritePngTest ## T = PplCvX86ImwritePngTest<T>;                 \
+TEST_P(PplCvX86ImwritePngTest ## T, Standard) {                                \
+    bool identity = this->apply();                                             \
+    EXPECT_TRUE(identity);                                                     \
+}                                                                              \
+                                                                               \
+INSTANTIATE_TEST_CASE_P(IsEqual, PplCvX86ImwritePngTest ## T,                  \
+    ::testing::Combine(                                                        \
+        ::testing::Values(1, 3, 4),                                            \
+        ::testing::Values(0, 1, 3, 6, 9),                                      \
+        ::testing::Values(false, true),                                        \
+        ::testing::Values(cv::Size{1, 1}, cv::Size{7, 3},                      \
+                          cv::Size{321, 240}, cv::Size{1283, 720})),           \
+    [](const testing::TestParamInfo<PplCvX86ImwritePngTest ## T::ParamType>&   \
+        info) {                                                                \
+        return convertToStringPng(info.param);                                 \
+    }                                                                          \
+);
+
+PNG_UNITTEST(uchar)
+PNG_UNITTEST(ushort)
+
+using JpegParameters = std::tuple<int, int, int, bool, cv::Size>;
+inline std::string convertToStringJpeg(const JpegParameters& parameters) {
+    std::ostringstream formatted;
+
+    int channels = std::get<0>(parameters);
+    formatted << "Channels" << channels << "_";
+
+    int quality = std::get<1>(parameters);
+    formatted << "Quality" << quality << "_";
+
+    int sampling = std::get<2>(parameters);
+    formatted << "Sampling" << std::hex << sampling << std::dec << "_";
+
+    bool mask = std::get<3>(parameters);
+    formatted << (mask ? "Mask" : "Random") << "_";
+
+    cv::Size size = std::get<4>(parameters);
+    formatted << size.width << "x";
+    formatted << size.height;
+
+    return formatted.str();
+}
+
+class PplCvX86ImwriteJpegTest :
+    public ::testing::TestWithParam<JpegParameters> {
+  public:
+    PplCvX86ImwriteJpegTest() {
+        const JpegParameters& parameters = GetParam();
+        channels = std::get<0>(parameters);
+        quality  = std::get<1>(parameters);
+        sampling = std::get<2>(parameters);
+        mask     = std::get<3>(parameters);
+        size     = std::get<4>(parameters);
+    }
+
+    ~PplCvX86ImwriteJpegTest() {
+    }
+
+    bool apply();
+
+  private:
+    int channels;
+    int quality;
+    int sampling;
+    bool mask;
+    cv::Size size;
+};
+
+// The decoded images are compared with the ones of OpenCV at the same quality
+// with its default 4:2:0 subsampling, which loses the most. A sample of a tiny
+// image moves the psnr a lot, so more is tolerated there.
+bool PplCvX86ImwriteJpegTest::apply() {
+    cv::Mat src = createImwriteImage<uchar>(size.height, size.width, channels,
+                                            mask);
+    cv::Mat bgr = src;
+    if (channels == 4) {
+        cv::cvtColor(src, bgr, cv::COLOR_BGRA2BGR);
+    }
+    int params[] = {ppl::cv::x86::IMWRITE_JPEG_QUALITY, quality,
+                    ppl::cv::x86::IMWRITE_JPEG_SAMPLING_FACTOR, sampling};
+
+    std::vector<uchar> cv_data;
+    cv::imencode(".jpg", bgr, cv_data, {cv::IMWRITE_JPEG_QUALITY, quality});
+    cv::Mat cv_dst = cv::imdecode(cv_data, cv::IMREAD_UNCHANGED);
+    double cv_psnr = std::min(cv::PSNR(bgr, cv_dst), 45.0);
+    double tolerance = size.area() < 64 ? 2.0 : 0.5;
+
+    size_t size0;
+    uchar* data0 = nullptr;
+    ppl::common::RetCode code = ppl::cv::x86::Imencode<uchar>(ppl::cv::JPEG,
+        src.rows, src.cols, channels, src.step, src.data, 4, params, &size0,
+        &data0);
+    if (code != ppl::common::RC_SUCCESS) {
+        std::cout << "failed to encode the image." << std::endl;
+        return false;
+    }
+    cv::Mat buffer(1, size0, CV_8UC1, data0);
+    cv::Mat dst0 = cv::imdecode(buffer, cv::IMREAD_UNCHANGED);
+    bool close0 = dst0.size() == bgr.size() && dst0.type() == bgr.type() &&
+                  cv::PSNR(bgr, dst0) >= cv_psnr - tolerance;
+    free(data0);
+
+    std::string file_name("test.jpg");
+    code = ppl::cv::x86::Imwrite<uchar>(file_name.c_str(), src.rows, src.cols,
+                                        channels, src.step, src.data, 4,
+                                        params);
+    if (code != ppl::common::RC_SUCCESS) {
+        std::cout << "failed to write the image to test.jpg." << std::endl;
+        return false;
+    }
+    cv::Mat dst1 = cv::imread(file_name, cv::IMREAD_UNCHANGED);
+    bool close1 = dst1.size() == bgr.size() && dst1.type() == bgr.type() &&
+                  cv::PSNR(bgr, dst1) >= cv_psnr - tolerance;
+    int result = remove(file_name.c_str());
+    if (result != 0) {
+        std::cout << "failed to delete test.jpg." << std::endl;
+    }
+
+    return close0 && close1;
+}
+
+TEST_P(PplCvX86ImwriteJpegTest, Standard) {
+    bool close = this->apply();
+    EXPECT_TRUE(close);
+}
+
+INSTANTIATE_TEST_CASE_P(IsClose, PplCvX86ImwriteJpegTest,
+    ::testing::Combine(
+        ::testing::Values(1, 3, 4),
+        ::testing::Values(0, 50, 95, 100),
+        ::testing::Values(ppl::cv::x86::IMWRITE_JPEG_SAMPLING_FACTOR_420,
+                          ppl::cv::x86::IMWRITE_JPEG_SAMPLING_FACTOR_422,
+                          ppl::cv::x86::IMWRITE_JPEG_SAMPLING_FACTOR_444),
+        ::testing::Values(false, true),
+        ::testing::Values(cv::Size{1, 1}, cv::Size{7, 3},
+                          cv::Size{321, 240}, cv::Size{1283, 720})),
+    [](const testing::TestParamInfo<PplCvX86ImwriteJpegTest::ParamType>&
+        info) {
+        return convertToStringJpeg(info.param);
+    }
+);
+
+class PplCvX86ImwriteJpegRoundTripTest :
+    public ::testing::TestWithParam<JpegParameters> {
+  public:
+    PplCvX86ImwriteJpegRoundTripTest() {
+        const JpegParameters& parameters = GetParam();
+        channels = std::get<0>(parameters);
+        quality  = std::get<1>(parameters);
+        sampling = std::get<2>(parameters);
+        mask     = std::get<3>(parameters);
+        size     = std::get<4>(parameters);
+    }
+
+    ~PplCvX86ImwriteJpegRoundTripTest() {
+    }
+
+    bool apply();
+
+  private:
+    int channels;
+    int quality;
+    int sampling;
+    bool mask;
+    cv::Size size;
+};
+
+// Imdecode() reads what Imencode() writes as OpenCV does, up to the rounding
+// of the idct and of the chroma upsampling.
+bool PplCvX86ImwriteJpegRoundTripTest::apply() {
+    cv::Mat src = createImwriteImage<uchar>(size.height, size.width, channels,
+                                            mask);
+    int params[] = {ppl::cv::x86::IMWRITE_JPEG_QUALITY, quality,
+                    ppl::cv::x86::IMWRITE_JPEG_SAMPLING_FACTOR, sampling};
+
+    size_t size0;
+    uchar* data0 = nullptr;
+    ppl::common::RetCode code = ppl::cv::x86::Imencode<uchar>(ppl::cv::JPEG,
+        src.rows, src.cols, channels, src.step, src.data, 4, params, &size0,
+        &data0);
+    if (code != ppl::common::RC_SUCCESS) {
+        std::cout << "failed to encode the image." << std::endl;
+        return false;
+    }
+    cv::Mat buffer(1, size0, CV_8UC1, data0);
+    cv::Mat cv_dst = cv::imdecode(buffer, cv::IMREAD_UNCHANGED);
+
+    int height, width, dst_channels, stride;
+    uchar* image = nullptr;
+    code = ppl::cv::x86::Imdecode(data0, size0, &height, &width,
+                                  &dst_channels, &stride, &image);
+    free(data0);
+    if (code != ppl::common::RC_SUCCESS) {
+        std::cout << "failed to decode the image." << std::endl;
+        return false;
+    }
+    cv::Mat dst(height, width, CV_MAKETYPE(CV_8U, dst_channels), image,
+                stride);
+    bool close = dst.size() == cv_dst.size() && dst.type() == cv_dst.type() &&
+                 cv::norm(cv_dst, dst, cv::NORM_INF) <= 4;
+    free(image);
+
+    return close;
+}
+
+TEST_P(PplCvX86ImwriteJpegRoundTripTest, Standard) {
+    bool close = this->apply();
+    EXPECT_TRUE(close);
+}
+
+// libjpeg replicates chroma rows narrower than 3 samples instead of
+// interpolating them, so the images are at least 5 pixels wide.
+INSTANTIATE_TEST_CASE_P(IsClose, PplCvX86ImwriteJpegRoundTripTest,
+    ::testing::Combine(
+        ::testing::Values(1, 3, 4),
+        ::testing::Values(0, 50, 90, 100),
+        ::testing::Values(ppl::cv::x86::IMWRITE_JPEG_SAMPLING_FACTOR_420,
+                          ppl::cv::x86::IMWRITE_JPEG_SAMPLING_FACTOR_422,
+                          ppl::cv::x86::IMWRITE_JPEG_SAMPLING_FACTOR_444),
+        ::testing::Values(false, true),
+        ::testing::Values(cv::Size{23, 17}, cv::Size{320, 240},
+                          cv::Size{643, 481})),
+    [](const testing::TestParamInfo<
+        PplCvX86ImwriteJpegRoundTripTest::ParamType>& info) {
+        return convertToStringJpeg(info.param);
+    }
+);
+
+TEST(PplCvX86ImwriteInvalidTest, Standard) {
+    cv::Mat src = createSourceImage(48, 64, CV_8UC3);
+    size_t size;
+    uchar* data = nullptr;
+    EXPECT_EQ(ppl::cv::x86::Imencode<uchar>(ppl::cv::BMP, src.rows, src.cols,
+                  3, src.step, src.data, 0, nullptr, &size, &data),
+              ppl::common::RC_UNSUPPORTED);
+    cv::Mat src16 = createSourceImage(48, 64, CV_16UC1);
+    EXPECT_EQ(ppl::cv::x86::Imencode<ushort>(ppl::cv::JPEG, src16.rows,
+                  src16.cols, 1, src16.cols, (const ushort*)src16.data, 0,
+                  nullptr, &size, &data),
+              ppl::common::RC_UNSUPPORTED);
+    EXPECT_EQ(ppl::cv::x86::Imwrite<uchar>("test.bmp", src.rows, src.cols, 3,
+                                           src.step, src.data),
+              ppl::common::RC_UNSUPPORTED);
+    EXPECT_EQ(ppl::cv::x86::Imencode<uchar>(ppl::cv::PNG, src.rows, src.cols,
+                  2, src.step, src.data, 0, nullptr, &size, &data),
+              ppl::common::RC_INVALID_VALUE);
+
+    int params[] = {ppl::cv::x86::IMWRITE_PNG_COMPRESSION, 10};
+    EXPECT_EQ(ppl::cv::x86::Imencode<uchar>(ppl::cv::PNG, src.rows, src.cols,
+                  3, src.step, src.data, 2, params, &size, &data),
+              ppl::common::RC_INVALID_VALUE);
+    EXPECT_EQ(ppl::cv::x86::Imencode<uchar>(ppl::cv::PNG, src.rows, src.cols,
+                  3, src.step, src.data, 1, params, &size, &data),
+              ppl::common::RC_INVALID_VALUE);
+
+    int quality[] = {ppl::cv::x86::IMWRITE_JPEG_QUALITY, 101};
+    EXPECT_EQ(ppl::cv::x86::Imencode<uchar>(ppl::cv::JPEG, src.rows, src.cols,
+                  3, src.step, src.data, 2, quality, &size, &data),
+              ppl::common::RC_INVALID_VALUE);
+    int sampling[] = {ppl::cv::x86::IMWRITE_JPEG_SAMPLING_FACTOR, 0x411111};
+    EXPECT_EQ(ppl::cv::x86::Imencode<uchar>(ppl::cv::JPEG, src.rows, src.cols,
+                  3, src.step, src.data, 2, sampling, &size, &data),
+              ppl::common::RC_INVALID_VALUE);
+}
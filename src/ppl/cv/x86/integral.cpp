@@ -16,98 +16,435 @@
 // under the License.
 
 #include "ppl/cv/x86/integral.h"
+#include "ppl/cv/x86/parallel.hpp"
 #include "ppl/cv/types.h"
 #include <string.h>
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+#include <smmintrin.h>
 
 namespace ppl {
 namespace cv {
 namespace x86 {
 
+// The diagonal sums of the tilted integral are differences of two large
+// running sums, so float images keep them in double.
+template <typename TDst>
+struct IntegralDiagType {
+    typedef TDst type;
+};
+template <>
+struct IntegralDiagType<float> {
+    typedef double type;
+};
+
+// One row of the integral: the prefix sum of the input row added to the
+// integral row above it. `prefix` receives the row prefix sums when the
+// tilted integral needs them.
 template <typename TSrc, typename TDst, int32_t cn>
-void IntegralImage(
-    int32_t height,
+static void integral_sum_row(
+    const TSrc *src,
     int32_t width,
-    int32_t inWidthStride,
-    const TSrc *in,
-    int32_t outWidthStride,
-    TDst *out)
-{
-    int32_t outWidth = width + 1;
-    memset(out, 0, sizeof(TDst) * outWidth * cn);
-    for (int32_t h = 0; h < height; h++) {
-        TDst sum[cn] = {0};
-        memset(out + (h + 1) * outWidthStride, 0, sizeof(TDst) * cn);
-        for (int32_t w = 0; w < width; w++) {
+    const TDst *above,
+    TDst *dst,
+    TDst *prefix)
+{
+    TDst sum[cn] = {0};
+    for (int32_t w = 0; w < width; w++) {
+        for (int32_t c = 0; c < cn; c++) {
+            sum[c] += src[w * cn + c];
+            dst[w * cn + c] = above[w * cn + c] + sum[c];
+        }
+        if (prefix) {
             for (int32_t c = 0; c < cn; c++) {
-                TSrc in_v = in[h * inWidthStride + w * cn + c];
-                sum[c] += in_v;
-                out[(h + 1) * outWidthStride + (w + 1) * cn + c] = sum[c];
+                prefix[w * cn + c] = sum[c];
             }
         }
     }
+}
+
+static inline __m128i integral_prefix_epi16(__m128i v)
+{
+    v = _mm_add_epi16(v, _mm_slli_si128(v, 2));
+    v = _mm_add_epi16(v, _mm_slli_si128(v, 4));
+    return _mm_add_epi16(v, _mm_slli_si128(v, 8));
+}
+
+static inline void integral_store_epi32(
+    __m128i s,
+    const int32_t *above,
+    int32_t *dst,
+    int32_t *prefix)
+{
+    if (prefix) {
+        _mm_storeu_si128((__m128i *)prefix, s);
+    }
+    _mm_storeu_si128((__m128i *)dst, _mm_add_epi32(_mm_loadu_si128((const __m128i *)above), s));
+}
+
+// 16 pixels per step: the prefix within each half is taken in 16 bits by
+// shift-adds, then widened and offset by the running total of the row.
+template <>
+void integral_sum_row<uint8_t, int32_t, 1>(
+    const uint8_t *src,
+    int32_t width,
+    const int32_t *above,
+    int32_t *dst,
+    int32_t *prefix)
+{
+    __m128i zero  = _mm_setzero_si128();
+    __m128i carry = _mm_setzero_si128();
+    int32_t w     = 0;
+    for (; w <= width - 16; w += 16) {
+        __m128i v  = _mm_loadu_si128((const __m128i *)(src + w));
+        __m128i lo = integral_prefix_epi16(_mm_unpacklo_epi8(v, zero));
+        __m128i hi = integral_prefix_epi16(_mm_unpackhi_epi8(v, zero));
+        __m128i t  = _mm_shufflehi_epi16(lo, 0xff);
+        hi         = _mm_add_epi16(hi, _mm_unpackhi_epi64(t, t));
 
-    for (int32_t w = 0; w < width * cn; w++) {
-        TDst sum = (TDst)0;
-        for (int32_t h = 0; h < height; h++) {
-            TDst in_v = out[(h + 1) * outWidthStride + cn + w];
-            sum += in_v;
-            out[(h + 1) * outWidthStride + cn + w] = sum;
+        __m128i s0 = _mm_add_epi32(carry, _mm_unpacklo_epi16(lo, zero));
+        __m128i s1 = _mm_add_epi32(carry, _mm_unpackhi_epi16(lo, zero));
+        __m128i s2 = _mm_add_epi32(carry, _mm_unpacklo_epi16(hi, zero));
+        __m128i s3 = _mm_add_epi32(carry, _mm_unpackhi_epi16(hi, zero));
+        carry      = _mm_shuffle_epi32(s3, 0xff);
+
+        integral_store_epi32(s0, above + w, dst + w, prefix ? prefix + w : nullptr);
+        integral_store_epi32(s1, above + w + 4, dst + w + 4, prefix ? prefix + w + 4 : nullptr);
+        integral_store_epi32(s2, above + w + 8, dst + w + 8, prefix ? prefix + w + 8 : nullptr);
+        integral_store_epi32(s3, above + w + 12, dst + w + 12, prefix ? prefix + w + 12 : nullptr);
+    }
+    int32_t sum = _mm_cvtsi128_si32(carry);
+    for (; w < width; w++) {
+        sum += src[w];
+        dst[w] = above[w] + sum;
+        if (prefix) {
+            prefix[w] = sum;
         }
     }
 }
 
+// One pixel is one vector, so the row prefix is a single running add.
+template <>
+void integral_sum_row<uint8_t, int32_t, 4>(
+    const uint8_t *src,
+    int32_t width,
+    const int32_t *above,
+    int32_t *dst,
+    int32_t *prefix)
+{
+    __m128i sum = _mm_setzero_si128();
+    int32_t w   = 0;
+    for (; w <= width - 4; w += 4) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(src + w * 4));
+        for (int32_t i = 0; i < 4; i++) {
+            sum = _mm_add_epi32(sum, _mm_cvtepu8_epi32(v));
+            v   = _mm_srli_si128(v, 4);
+            integral_store_epi32(sum, above + (w + i) * 4, dst + (w + i) * 4, prefix ? prefix + (w + i) * 4 : nullptr);
+        }
+    }
+    for (; w < width; w++) {
+        int32_t pixel;
+        memcpy(&pixel, src + w * 4, sizeof(pixel));
+        sum = _mm_add_epi32(sum, _mm_cvtepu8_epi32(_mm_cvtsi32_si128(pixel)));
+        integral_store_epi32(sum, above + w * 4, dst + w * 4, prefix ? prefix + w * 4 : nullptr);
+    }
+}
+
+// Squared sums are stored in double as in OpenCV, which is exact for uint8_t
+// images up to 2^53 / 255^2 pixels; the row sums of uint8_t squares are
+// integers, so they add up in int64_t off the latency chain of double adds.
+template <typename TSrc>
+struct IntegralSqType {
+    typedef double type;
+};
+template <>
+struct IntegralSqType<uint8_t> {
+    typedef int64_t type;
+};
+
+template <typename TSrc, int32_t cn>
+static void integral_sqsum_row(
+    const TSrc *src,
+    int32_t width,
+    const double *above,
+    double *dst)
+{
+    typedef typename IntegralSqType<TSrc>::type TSq;
+    TSq sum[cn] = {0};
+    for (int32_t w = 0; w < width; w++) {
+        for (int32_t c = 0; c < cn; c++) {
+            TSq v = src[w * cn + c];
+            sum[c] += v * v;
+            dst[w * cn + c] = above[w * cn + c] + (double)sum[c];
+        }
+    }
+}
+
+// The tilted integral T(X, Y) sums the pixels (x, y) with y < Y and
+// |x - X + 1| <= Y - y - 1, a cone opening upwards from (X - 1, Y - 1).
+// With R_y the prefix sums of row y, T = A - B where
+//     A(X, Y) = A(X + 1, Y - 1) + R_{Y-1}(X - 1)
+//     B(X, Y) = B(X - 1, Y - 1) + R_{Y-1}(X - 2)
+// sum the right and the left edges of the cone along the two diagonals.
+// Past the last column A(X, Y) is the plain integral S(W, Y), which is also
+// A(W, Y), and B(X, Y) is zero for X < 2.
+template <typename TDst, typename TDiag, int32_t cn>
+static void integral_tilted_row(
+    const TDst *prefix,
+    int32_t width,
+    const TDiag *a_above,
+    const TDiag *b_above,
+    TDiag *a,
+    TDiag *b,
+    TDst *tilted)
+{
+    const int32_t last = width * cn;
+    for (int32_t c = 0; c < cn; c++) {
+        a[c] = a_above[cn + c];
+        b[c] = 0;
+        tilted[c] = (TDst)a[c];
+    }
+    if (width >= 2) {
+        for (int32_t c = 0; c < cn; c++) {
+            a[cn + c] = a_above[2 * cn + c] + prefix[c];
+            b[cn + c] = 0;
+            tilted[cn + c] = (TDst)a[cn + c];
+        }
+    }
+    for (int32_t i = 2 * cn; i < last; i++) {
+        a[i] = a_above[i + cn] + prefix[i - cn];
+        b[i] = b_above[i - cn] + prefix[i - 2 * cn];
+        tilted[i] = (TDst)(a[i] - b[i]);
+    }
+    for (int32_t c = 0; c < cn; c++) {
+        a[last + c] = a_above[last + c] + prefix[last - cn + c];
+        b[last + c] = width >= 2 ? b_above[last - cn + c] + prefix[last - 2 * cn + c] : 0;
+        tilted[last + c] = (TDst)(a[last + c] - b[last + c]);
+    }
+}
+
+// Row-streaming integral: every output row is the row above plus the prefix
+// sums of one input row, so the output is written once, top to bottom, and
+// the row above is still in cache. Integer images run in bands, each band
+// starting from a zero row; the integrals of the rows above a band are then
+// added back in a fix-up pass. Float images keep one band, so the rounding
+// neither differs from the serial order nor depends on the thread count.
+// `border` selects the (h + 1) x (w + 1) layout of OpenCV, which is also the
+// only layout of the squared and the tilted integrals.
 template <typename TSrc, typename TDst, int32_t cn>
-void IntegralImageDeprecate(
+static void integral_image(
     int32_t height,
     int32_t width,
     int32_t inWidthStride,
     const TSrc *in,
+    bool border,
     int32_t outWidthStride,
-    TDst *out)
+    TDst *out,
+    int32_t sqWidthStride,
+    double *sq,
+    int32_t tiltedWidthStride,
+    TDst *tilted)
 {
-    //integral by row
-    for (int32_t h = 0; h < height; h++) {
-        TDst sum[cn] = {0};
-        for (int32_t w = 0; w < width; w++) {
-            for (int32_t c = 0; c < cn; c++) {
-                TSrc in_v = in[h * inWidthStride + w * cn + c];
-                sum[c] += in_v;
-                out[h * outWidthStride + w * cn + c] = sum[c];
+    typedef typename IntegralDiagType<TDst>::type TDiag;
+    const int32_t row_len  = width * cn;
+    const int32_t out_len = (width + 1) * cn;
+
+    if (border) {
+        memset(out, 0, sizeof(TDst) * out_len);
+        for (int32_t h = 1; h <= height; h++) {
+            memset(out + h * outWidthStride, 0, sizeof(TDst) * cn);
+        }
+        if (sq) {
+            memset(sq, 0, sizeof(double) * out_len);
+            for (int32_t h = 1; h <= height; h++) {
+                memset(sq + h * sqWidthStride, 0, sizeof(double) * cn);
+            }
+        }
+        if (tilted) {
+            memset(tilted, 0, sizeof(TDst) * out_len);
+        }
+    }
+    if (height <= 0 || width <= 0) {
+        return;
+    }
+    auto sum_row = [&](int32_t h) {
+        return border ? out + (h + 1) * outWidthStride + cn : out + h * outWidthStride;
+    };
+    auto sq_row = [&](int32_t h) {
+        return sq + (h + 1) * sqWidthStride + cn;
+    };
+    auto tilted_row = [&](int32_t h) {
+        return tilted + (h + 1) * tiltedWidthStride;
+    };
+
+    int32_t num_bands = std::is_integral<TDst>::value ? parallel_num_bands(height, row_len, 1) : 1;
+    auto band_begin   = [&](int32_t band) {
+        return (int32_t)((int64_t)height * band / num_bands);
+    };
+
+    std::vector<TDst> zeros(row_len, 0);
+    std::vector<double> zeros_sq(sq ? row_len : 0, 0.0);
+    std::vector<TDst> prefix(tilted ? (size_t)num_bands * row_len : 0);
+    // per band two pairs of diagonal rows, A then B, used in turn; pair 0
+    // starts as the zero row above the band
+    std::vector<TDiag> diag(tilted ? (size_t)num_bands * 4 * out_len : 0, 0);
+    auto band_diag = [&](int32_t band, int32_t pair) {
+        return diag.data() + ((size_t)band * 2 + pair) * 2 * out_len;
+    };
+
+    parallel_run(num_bands, [&](int32_t band) {
+        int32_t begin       = band_begin(band);
+        int32_t end         = band_begin(band + 1);
+        TDst *band_prefix   = tilted ? prefix.data() + (size_t)band * row_len : nullptr;
+        for (int32_t h = begin; h < end; h++) {
+            const TSrc *src = in + h * inWidthStride;
+            integral_sum_row<TSrc, TDst, cn>(src, width, h == begin ? zeros.data() : sum_row(h - 1), sum_row(h), band_prefix);
+            if (sq) {
+                integral_sqsum_row<TSrc, cn>(src, width, h == begin ? zeros_sq.data() : sq_row(h - 1), sq_row(h));
+            }
+            if (tilted) {
+                TDiag *above = band_diag(band, (h - begin) & 1);
+                TDiag *cur   = band_diag(band, (h - begin + 1) & 1);
+                integral_tilted_row<TDst, TDiag, cn>(band_prefix, width, above, above + out_len, cur, cur + out_len, tilted_row(h));
             }
         }
+    });
+    if (num_bands <= 1) {
+        return;
     }
 
-    for (int32_t w = 0; w < width * cn; w++) {
-        TDst sum = (TDst)0;
-        for (int32_t h = 0; h < height; h++) {
-            TDst in_v = out[h * outWidthStride + w];
-            sum += in_v;
-            out[h * outWidthStride + w] = sum;
+    // The integrals of all the rows above each band, chained band by band:
+    // the plain sums add up directly, the diagonal sums of the band above
+    // shift by its height along their diagonals.
+    std::vector<TDst> carry(((size_t)num_bands) * row_len, 0);
+    std::vector<double> carry_sq(sq ? (size_t)num_bands * row_len : 0, 0.0);
+    std::vector<TDiag> carry_diag(tilted ? (size_t)num_bands * 2 * out_len : 0, 0);
+    for (int32_t band = 1; band < num_bands; band++) {
+        int32_t last = band_begin(band) - 1;
+        int32_t rows = band_begin(band) - band_begin(band - 1);
+        const TDst *above = carry.data() + (size_t)(band - 1) * row_len;
+        TDst *cur         = carry.data() + (size_t)band * row_len;
+        for (int32_t i = 0; i < row_len; i++) {
+            cur[i] = sum_row(last)[i] + above[i];
+        }
+        if (sq) {
+            const double *above_sq = carry_sq.data() + (size_t)(band - 1) * row_len;
+            double *cur_sq         = carry_sq.data() + (size_t)band * row_len;
+            for (int32_t i = 0; i < row_len; i++) {
+                cur_sq[i] = sq_row(last)[i] + above_sq[i];
+            }
+        }
+        if (tilted) {
+            const TDiag *local_a = band_diag(band - 1, rows & 1);
+            const TDiag *local_b = local_a + out_len;
+            const TDiag *above_a = carry_diag.data() + (size_t)(band - 1) * 2 * out_len;
+            const TDiag *above_b = above_a + out_len;
+            TDiag *cur_a         = carry_diag.data() + (size_t)band * 2 * out_len;
+            TDiag *cur_b         = cur_a + out_len;
+            for (int32_t x = 0; x <= width; x++) {
+                for (int32_t c = 0; c < cn; c++) {
+                    cur_a[x * cn + c] = local_a[x * cn + c] + above_a[std::min(x + rows, width) * cn + c];
+                    cur_b[x * cn + c] = local_b[x * cn + c] + (x >= rows ? above_b[(x - rows) * cn + c] : 0);
+                }
+            }
         }
     }
+
+    parallel_run(num_bands - 1, [&](int32_t task) {
+        int32_t band         = task + 1;
+        int32_t begin        = band_begin(band);
+        int32_t end          = band_begin(band + 1);
+        const TDst *carry_s  = carry.data() + (size_t)band * row_len;
+        const double *carry_q = sq ? carry_sq.data() + (size_t)band * row_len : nullptr;
+        const TDiag *carry_a = tilted ? carry_diag.data() + (size_t)band * 2 * out_len : nullptr;
+        const TDiag *carry_b = tilted ? carry_a + out_len : nullptr;
+        for (int32_t h = begin; h < end; h++) {
+            TDst *dst = sum_row(h);
+            for (int32_t i = 0; i < row_len; i++) {
+                dst[i] += carry_s[i];
+            }
+            if (sq) {
+                double *dst_sq = sq_row(h);
+                for (int32_t i = 0; i < row_len; i++) {
+                    dst_sq[i] += carry_q[i];
+                }
+            }
+            if (tilted) {
+                TDst *dst_t = tilted_row(h);
+                int32_t d   = h + 1 - begin;
+                for (int32_t x = 0; x <= width; x++) {
+                    for (int32_t c = 0; c < cn; c++) {
+                        TDiag a = carry_a[std::min(x + d, width) * cn + c];
+                        TDiag b = x >= d ? carry_b[(x - d) * cn + c] : 0;
+                        dst_t[x * cn + c] += (TDst)(a - b);
+                    }
+                }
+            }
+        }
+    });
 }
 
-template <>
-::ppl::common::RetCode Integral<float, float, 1>(
+template <typename TSrc, typename TDst, int32_t cn>
+static ::ppl::common::RetCode integral(
     int32_t inHeight,
     int32_t inWidth,
     int32_t inWidthStride,
-    const float *inData,
+    const TSrc *inData,
     int32_t outHeight,
     int32_t outWidth,
     int32_t outWidthStride,
-    float *outData)
+    TDst *outData)
 {
     if ((outHeight == inHeight) && (outWidth == inWidth)) {
-        IntegralImageDeprecate<float, float, 1>(inHeight, inWidth, inWidthStride, inData, outWidthStride, outData);
+        integral_image<TSrc, TDst, cn>(inHeight, inWidth, inWidthStride, inData, false, outWidthStride, outData, 0, nullptr, 0, nullptr);
     } else if ((outHeight == (inHeight + 1)) && (outWidth == (inWidth + 1))) {
-        IntegralImage<float, float, 1>(inHeight, inWidth, inWidthStride, inData, outWidthStride, outData);
+        integral_image<TSrc, TDst, cn>(inHeight, inWidth, inWidthStride, inData, true, outWidthStride, outData, 0, nullptr, 0, nullptr);
     } else {
         return ppl::common::RC_INVALID_VALUE;
     }
     return ppl::common::RC_SUCCESS;
 }
 
+template <typename TSrc, typename TDst, int32_t cn>
+static ::ppl::common::RetCode integral(
+    int32_t inHeight,
+    int32_t inWidth,
+    int32_t inWidthStride,
+    const TSrc *inData,
+    int32_t outHeight,
+    int32_t outWidth,
+    int32_t outWidthStride,
+    TDst *outData,
+    int32_t outSqWidthStride,
+    double *outSqData,
+    int32_t outTiltedWidthStride,
+    TDst *outTiltedData)
+{
+    if (inData == nullptr || outData == nullptr) {
+        return ppl::common::RC_INVALID_VALUE;
+    }
+    if ((outHeight != (inHeight + 1)) || (outWidth != (inWidth + 1))) {
+        return ppl::common::RC_INVALID_VALUE;
+    }
+    integral_image<TSrc, TDst, cn>(inHeight, inWidth, inWidthStride, inData, true, outWidthStride, outData, outSqWidthStride, outSqData, outTiltedWidthStride, outTiltedData);
+    return ppl::common::RC_SUCCESS;
+}
+
+template <>
+::ppl::common::RetCode Integral<float, float, 1>(
+    int32_t inHeight,
+    int32_t inWidth,
+    int32_t inWidthStride,
+    const float *inData,
+    int32_t outHeight,
+    int32_t outWidth,
+    int32_t outWidthStride,
+    float *outData)
+{
+    return integral<float, float, 1>(inHeight, inWidth, inWidthStride, inData, outHeight, outWidth, outWidthStride, outData);
+}
+
 template <>
 ::ppl::common::RetCode Integral<float, float, 3>(
     int32_t inHeight,
@@ -119,14 +456,7 @@ template <>
     int32_t outWidthStride,
     float *outData)
 {
-    if ((outHeight == inHeight) && (outWidth == inWidth)) {
-        IntegralImageDeprecate<float, float, 3>(inHeight, inWidth, inWidthStride, inData, outWidthStride, outData);
-    } else if ((outHeight == (inHeight + 1)) && (outWidth == (inWidth + 1))) {
-        IntegralImage<float, float, 3>(inHeight, inWidth, inWidthStride, inData, outWidthStride, outData);
-    } else {
-        return ppl::common::RC_INVALID_VALUE;
-    }
-    return ppl::common::RC_SUCCESS;
+    return integral<float, float, 3>(inHeight, inWidth, inWidthStride, inData, outHeight, outWidth, outWidthStride, outData);
 }
 
 template <>
@@ -140,14 +470,7 @@ template <>
     int32_t outWidthStride,
     float *outData)
 {
-    if ((outHeight == inHeight) && (outWidth == inWidth)) {
-        IntegralImageDeprecate<float, float, 4>(inHeight, inWidth, inWidthStride, inData, outWidthStride, outData);
-    } else if ((outHeight == (inHeight + 1)) && (outWidth == (inWidth + 1))) {
-        IntegralImage<float, float, 4>(inHeight, inWidth, inWidthStride, inData, outWidthStride, outData);
-    } else {
-        return ppl::common::RC_INVALID_VALUE;
-    }
-    return ppl::common::RC_SUCCESS;
+    return integral<float, float, 4>(inHeight, inWidth, inWidthStride, inData, outHeight, outWidth, outWidthStride, outData);
 }
 
 template <>
@@ -161,14 +484,7 @@ template <>
     int32_t outWidthStride,
     int32_t *outData)
 {
-    if ((outHeight == inHeight) && (outWidth == inWidth)) {
-        IntegralImageDeprecate<uint8_t, int32_t, 1>(inHeight, inWidth, inWidthStride, inData, outWidthStride, outData);
-    } else if ((outHeight == (inHeight + 1)) && (outWidth == (inWidth + 1))) {
-        IntegralImage<uint8_t, int32_t, 1>(inHeight, inWidth, inWidthStride, inData, outWidthStride, outData);
-    } else {
-        return ppl::common::RC_INVALID_VALUE;
-    }
-    return ppl::common::RC_SUCCESS;
+    return integral<uint8_t, int32_t, 1>(inHeight, inWidth, inWidthStride, inData, outHeight, outWidth, outWidthStride, outData);
 }
 
 template <>
@@ -182,14 +498,7 @@ template <>
     int32_t outWidthStride,
     int32_t *outData)
 {
-    if ((outHeight == inHeight) && (outWidth == inWidth)) {
-        IntegralImageDeprecate<uint8_t, int32_t, 3>(inHeight, inWidth, inWidthStride, inData, outWidthStride, outData);
-    } else if ((outHeight == (inHeight + 1)) && (outWidth == (inWidth + 1))) {
-        IntegralImage<uint8_t, int32_t, 3>(inHeight, inWidth, inWidthStride, inData, outWidthStride, outData);
-    } else {
-        return ppl::common::RC_INVALID_VALUE;
-    }
-    return ppl::common::RC_SUCCESS;
+    return integral<uint8_t, int32_t, 3>(inHeight, inWidth, inWidthStride, inData, outHeight, outWidth, outWidthStride, outData);
 }
 
 template <>
@@ -203,14 +512,115 @@ template <>
     int32_t outWidthStride,
     int32_t *outData)
 {
-    if ((outHeight == inHeight) && (outWidth == inWidth)) {
-        IntegralImageDeprecate<uint8_t, int32_t, 4>(inHeight, inWidth, inWidthStride, inData, outWidthStride, outData);
-    } else if ((outHeight == (inHeight + 1)) && (outWidth == (inWidth + 1))) {
-        IntegralImage<uint8_t, int32_t, 4>(inHeight, inWidth, inWidthStride, inData, outWidthStride, outData);
-    } else {
-        return ppl::common::RC_INVALID_VALUE;
-    }
-    return ppl::common::RC_SUCCESS;
+    return integral<uint8_t, int32_t, 4>(inHeight, inWidth, inWidthStride, inData, outHeight, outWidth, outWidthStride, outData);
+}
+
+template <>
+::ppl::common::RetCode Integral<float, float, 1>(
+    int32_t inHeight,
+    int32_t inWidth,
+    int32_t inWidthStride,
+    const float *inData,
+    int32_t outHeight,
+    int32_t outWidth,
+    int32_t outWidthStride,
+    float *outData,
+    int32_t outSqWidthStride,
+    double *outSqData,
+    int32_t outTiltedWidthStride,
+    float *outTiltedData)
+{
+    return integral<float, float, 1>(inHeight, inWidth, inWidthStride, inData, outHeight, outWidth, outWidthStride, outData, outSqWidthStride, outSqData, outTiltedWidthStride, outTiltedData);
+}
+
+template <>
+::ppl::common::RetCode Integral<float, float, 3>(
+    int32_t inHeight,
+    int32_t inWidth,
+    int32_t inWidthStride,
+    const float *inData,
+    int32_t outHeight,
+    int32_t outWidth,
+    int32_t outWidthStride,
+    float *outData,
+    int32_t outSqWidthStride,
+    double *outSqData,
+    int32_t outTiltedWidthStride,
+    float *outTiltedData)
+{
+    return integral<float, float, 3>(inHeight, inWidth, inWidthStride, inData, outHeight, outWidth, outWidthStride, outData, outSqWidthStride, outSqData, outTiltedWidthStride, outTiltedData);
+}
+
+template <>
+::ppl::common::RetCode Integral<float, float, 4>(
+    int32_t inHeight,
+    int32_t inWidth,
+    int32_t inWidthStride,
+    const float *inData,
+    int32_t outHeight,
+    int32_t outWidth,
+    int32_t outWidthStride,
+    float *outData,
+    int32_t outSqWidthStride,
+    double *outSqData,
+    int32_t outTiltedWidthStride,
+    float *outTiltedData)
+{
+    return integral<float, float, 4>(inHeight, inWidth, inWidthStride, inData, outHeight, outWidth, outWidthStride, outData, outSqWidthStride, outSqData, outTiltedWidthStride, outTiltedData);
+}
+
+template <>
+::ppl::common::RetCode Integral<uint8_t, int32_t, 1>(
+    int32_t inHeight,
+    int32_t inWidth,
+    int32_t inWidthStride,
+    const uint8_t *inData,
+    int32_t outHeight,
+    int32_t outWidth,
+    int32_t outWidthStride,
+    int32_t *outData,
+    int32_t outSqWidthStride,
+    double *outSqData,
+    int32_t outTiltedWidthStride,
+    int32_t *outTiltedData)
+{
+    return integral<uint8_t, int32_t, 1>(inHeight, inWidth, inWidthStride, inData, outHeight, outWidth, outWidthStride, outData, outSqWidthStride, outSqData, outTiltedWidthStride, outTiltedData);
+}
+
+template <>
+::ppl::common::RetCode Integral<uint8_t, int32_t, 3>(
+    int32_t inHeight,
+    int32_t inWidth,
+    int32_t inWidthStride,
+    const uint8_t *inData,
+    int32_t outHeight,
+    int32_t outWidth,
+    int32_t outWidthStride,
+    int32_t *outData,
+    int32_t outSqWidthStride,
+    double *outSqData,
+    int32_t outTiltedWidthStride,
+    int32_t *outTiltedData)
+{
+    return integral<uint8_t, int32_t, 3>(inHeight, inWidth, inWidthStride, inData, outHeight, outWidth, outWidthStride, outData, outSqWidthStride, outSqData, outTiltedWidthStride, outTiltedData);
+}
+
+template <>
+::ppl::common::RetCode Integral<uint8_t, int32_t, 4>(
+    int32_t inHeight,
+    int32_t inWidth,
+    int32_t inWidthStride,
+    const uint8_t *inData,
+    int32_t outHeight,
+    int32_t outWidth,
+    int32_t outWidthStride,
+    int32_t *outData,
+    int32_t outSqWidthStride,
+    double *outSqData,
+    int32_t outTiltedWidthStride,
+    int32_t *outTiltedData)
+{
+    return integral<uint8_t, int32_t, 4>(inHeight, inWidth, inWidthStride, inData, outHeight, outWidth, outWidthStride, outData, outSqWidthStride, outSqData, outTiltedWidthStride, outTiltedData);
 }
 
 }
@@ -37,6 +37,24 @@ void BM_Integral_ppl_x86(benchmark::State &state) {
     state.SetItemsProcessed(state.iterations() * 1);
 }
 
+template<typename TSrc, typename TDst, int32_t nc>
+void BM_IntegralSqTilted_ppl_x86(benchmark::State &state) {
+    int32_t width = state.range(0);
+    int32_t height = state.range(1);
+    int32_t outHeight = height + 1;
+    int32_t outWidth = width + 1;
+    std::unique_ptr<TSrc[]> src(new TSrc[width * height * nc]);
+    std::unique_ptr<TDst[]> sum(new TDst[outHeight * outWidth * nc]);
+    std::unique_ptr<double[]> sqsum(new double[outHeight * outWidth * nc]);
+    std::unique_ptr<TDst[]> tilted(new TDst[outHeight * outWidth * nc]);
+    ppl::cv::debug::randomFill<TSrc>(src.get(), width * height * nc, 0, 255);
+    for (auto _ : state) {
+        ppl::cv::x86::Integral<TSrc, TDst, nc>(height, width, width * nc, src.get(), outHeight, outWidth,
+                                               outWidth * nc, sum.get(), outWidth * nc, sqsum.get(), outWidth * nc, tilted.get());
+    }
+    state.SetItemsProcessed(state.iterations() * 1);
+}
+
 using namespace ppl::cv::debug;
 
 BENCHMARK_TEMPLATE(BM_Integral_ppl_x86, float, float, 1)->Args({320, 240})->Args({640, 480})->Args({1280, 720})->Args({1920, 1080})->Args({3840, 2160});
@@ -45,6 +63,9 @@ BENCHMARK_TEMPLATE(BM_Integral_ppl_x86, float, float, 4)->Args({320, 240})->Args
 BENCHMARK_TEMPLATE(BM_Integral_ppl_x86, uint8_t, int32_t, 1)->Args({320, 240})->Args({640, 480})->Args({1280, 720})->Args({1920, 1080})->Args({3840, 2160});
 BENCHMARK_TEMPLATE(BM_Integral_ppl_x86, uint8_t, int32_t, 3)->Args({320, 240})->Args({640, 480})->Args({1280, 720})->Args({1920, 1080})->Args({3840, 2160});
 BENCHMARK_TEMPLATE(BM_Integral_ppl_x86, uint8_t, int32_t, 4)->Args({320, 240})->Args({640, 480})->Args({1280, 720})->Args({1920, 1080})->Args({3840, 2160});
+BENCHMARK_TEMPLATE(BM_IntegralSqTilted_ppl_x86, float, float, 1)->Args({640, 480})->Args({1920, 1080})->Args({3840, 2160});
+BENCHMARK_TEMPLATE(BM_IntegralSqTilted_ppl_x86, uint8_t, int32_t, 1)->Args({640, 480})->Args({1920, 1080})->Args({3840, 2160});
+BENCHMARK_TEMPLATE(BM_IntegralSqTilted_ppl_x86, uint8_t, int32_t, 3)->Args({640, 480})->Args({1920, 1080})->Args({3840, 2160});
 
 #ifdef PPLCV_BENCHMARK_OPENCV
 template<typename TSrc, typename TDst, int32_t nc>
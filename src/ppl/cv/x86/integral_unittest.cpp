@@ -18,6 +18,7 @@
 #include "ppl/cv/x86/integral.h"
 #include "ppl/cv/x86/test.h"
 #include <memory>
+#include <type_traits>
 #include <gtest/gtest.h>
 #include "ppl/cv/debug.h"
 
@@ -40,6 +41,40 @@ void IntegralTest(int32_t height, int32_t width) {
                     1.0f);
 }
 
+template<typename TSrc, typename TDst, int32_t nc>
+void IntegralSqTiltedTest(int32_t height, int32_t width) {
+    int32_t outHeight = height + 1;
+    int32_t outWidth = width + 1;
+    std::unique_ptr<TSrc[]> src(new TSrc[width * height * nc]);
+    std::unique_ptr<TDst[]> sum(new TDst[outHeight * outWidth * nc]);
+    std::unique_ptr<double[]> sqsum(new double[outHeight * outWidth * nc]);
+    std::unique_ptr<TDst[]> tilted(new TDst[outHeight * outWidth * nc]);
+    ppl::cv::debug::randomFill<TSrc>(src.get(), width * height * nc, 0, 255);
+    cv::Mat srcMat(height, width, CV_MAKETYPE(cv::DataType<TSrc>::depth, nc), src.get());
+    cv::Mat sumMat, sqsumMat, tiltedMat;
+    ppl::cv::x86::Integral<TSrc, TDst, nc>(height, width, width * nc, src.get(), outHeight, outWidth,
+                                           outWidth * nc, sum.get(),
+                                           outWidth * nc, sqsum.get(),
+                                           outWidth * nc, tilted.get());
+    cv::integral(srcMat, sumMat, sqsumMat, tiltedMat, cv::DataType<TDst>::depth, CV_64F);
+    // OpenCV walks its own float recurrence for the tilted sums, while ppl.cv
+    // differences two diagonal sums kept in double.
+    float tilted_THR = std::is_same<TDst, float>::value ? 8.0f : 1.0f;
+
+    checkResult<TDst, nc>(sum.get(), sumMat.ptr<TDst>(),
+                    outHeight, outWidth,
+                    outWidth * nc, outWidth * nc,
+                    1.0f);
+    checkResult<double, nc>(sqsum.get(), sqsumMat.ptr<double>(),
+                    outHeight, outWidth,
+                    outWidth * nc, outWidth * nc,
+                    1.0f);
+    checkResult<TDst, nc>(tilted.get(), tiltedMat.ptr<TDst>(),
+                    outHeight, outWidth,
+                    outWidth * nc, outWidth * nc,
+                    tilted_THR);
+}
+
 
 TEST(Integral_FP32, x86)
 {
@@ -60,3 +95,18 @@ TEST(Integral_UINT8, x86)
     IntegralTest<uint8_t, int32_t, 4>(64, 72);
     IntegralTest<uint8_t, int32_t, 4>(72, 108);
 }
+
+TEST(IntegralSqTilted_FP32, x86)
+{
+    IntegralSqTiltedTest<float, float, 1>(64, 72);
+    IntegralSqTiltedTest<float, float, 3>(72, 108);
+    IntegralSqTiltedTest<float, float, 4>(72, 108);
+}
+
+TEST(IntegralSqTilted_UINT8, x86)
+{
+    IntegralSqTiltedTest<uint8_t, int32_t, 1>(64, 72);
+    IntegralSqTiltedTest<uint8_t, int32_t, 1>(1080, 1920);
+    IntegralSqTiltedTest<uint8_t, int32_t, 3>(72, 108);
+    IntegralSqTiltedTest<uint8_t, int32_t, 4>(72, 108);
+}
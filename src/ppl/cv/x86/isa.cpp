@@ -0,0 +1,47 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "ppl/cv/x86/isa.h"
+#include "ppl/cv/x86/isa.hpp"
+
+#include <atomic>
+
+namespace ppl {
+namespace cv {
+namespace x86 {
+
+static std::atomic<uint32_t> g_isa_mask(0xffffffffu);
+
+::ppl::common::RetCode SetIsaMask(uint32_t isa_mask)
+{
+    g_isa_mask.store(isa_mask);
+    return ppl::common::RC_SUCCESS;
+}
+
+uint32_t GetIsaMask()
+{
+    return g_isa_mask.load();
+}
+
+bool isa_supported(uint32_t isa)
+{
+    return (g_isa_mask.load() & isa) == isa && ppl::common::CpuSupports(isa);
+}
+
+} // namespace x86
+} // namespace cv
+} // namespace ppl
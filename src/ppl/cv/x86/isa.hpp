@@ -0,0 +1,36 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#ifndef __ST_HPC_PPL_CV_X86_ISA_HPP_
+#define __ST_HPC_PPL_CV_X86_ISA_HPP_
+
+#include "ppl/common/x86/sysinfo.h"
+#include <stdint.h>
+
+namespace ppl {
+namespace cv {
+namespace x86 {
+
+// Whether kernels may dispatch to code built for `isa`: the cpu has it and
+// SetIsaMask() has not ruled it out.
+bool isa_supported(uint32_t isa);
+
+} // namespace x86
+} // namespace cv
+} // namespace ppl
+
+#endif //! __ST_HPC_PPL_CV_X86_ISA_HPP_
@@ -0,0 +1,161 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+#include <benchmark/benchmark.h>
+#include "ppl/cv/x86/isa.h"
+#include "ppl/cv/x86/split.h"
+#include "ppl/cv/x86/resize.h"
+#include "ppl/cv/x86/warpaffine.h"
+#include "ppl/cv/x86/filter2d.h"
+#include "ppl/cv/x86/gaussianblur.h"
+#include "ppl/cv/x86/cvtcolor.h"
+#include "ppl/common/x86/sysinfo.h"
+#include "ppl/cv/debug.h"
+#include <memory>
+namespace {
+
+// range(0) picks the tier: 0 everything the cpu has, 1 without AVX-512,
+// 2 SSE only.
+void setTier(int64_t tier) {
+    uint32_t masks[] = {
+        0xffffffffu,
+        ~(uint32_t)ppl::common::ISA_X86_AVX512,
+        ~(uint32_t)(ppl::common::ISA_X86_AVX512 | ppl::common::ISA_X86_FMA | ppl::common::ISA_X86_AVX2 | ppl::common::ISA_X86_AVX),
+    };
+    ppl::cv::x86::SetIsaMask(masks[tier]);
+}
+
+template<typename T>
+void BM_Split3Channels_isa_ppl_x86(benchmark::State &state) {
+    int32_t width = 3840;
+    int32_t height = 2160;
+    std::unique_ptr<T[]> src(new T[width * height * 3]);
+    std::unique_ptr<T[]> dst(new T[width * height * 3]);
+    ppl::cv::debug::randomFill<T>(src.get(), width * height * 3, 0, 255);
+    T *out = dst.get();
+    setTier(state.range(0));
+    for (auto _ : state) {
+        ppl::cv::x86::Split3Channels<T>(height, width, width * 3, src.get(), width, out, out + width * height, out + 2 * width * height);
+    }
+    setTier(0);
+    state.SetItemsProcessed(state.iterations() * 1);
+}
+
+void BM_NV122BGR_isa_ppl_x86(benchmark::State &state) {
+    int32_t width = 3840;
+    int32_t height = 2160;
+    std::unique_ptr<uint8_t[]> src(new uint8_t[width * height * 3 / 2]);
+    std::unique_ptr<uint8_t[]> dst(new uint8_t[width * height * 3]);
+    ppl::cv::debug::randomFill<uint8_t>(src.get(), width * height * 3 / 2, 0, 255);
+    setTier(state.range(0));
+    for (auto _ : state) {
+        ppl::cv::x86::NV122BGR<uint8_t>(height, width, width, src.get(), width * 3, dst.get());
+    }
+    setTier(0);
+    state.SetItemsProcessed(state.iterations() * 1);
+}
+
+void BM_BGR2NV12_isa_ppl_x86(benchmark::State &state) {
+    int32_t width = 3840;
+    int32_t height = 2160;
+    std::unique_ptr<uint8_t[]> src(new uint8_t[width * height * 3]);
+    std::unique_ptr<uint8_t[]> dst(new uint8_t[width * height * 3 / 2]);
+    ppl::cv::debug::randomFill<uint8_t>(src.get(), width * height * 3, 0, 255);
+    setTier(state.range(0));
+    for (auto _ : state) {
+        ppl::cv::x86::BGR2NV12<uint8_t>(height, width, width * 3, src.get(), width, dst.get());
+    }
+    setTier(0);
+    state.SetItemsProcessed(state.iterations() * 1);
+}
+
+template<int32_t nc>
+void BM_ResizeLinear_isa_ppl_x86(benchmark::State &state) {
+    int32_t width = 3840;
+    int32_t height = 2160;
+    int32_t out_width = 1280;
+    int32_t out_height = 720;
+    std::unique_ptr<float[]> src(new float[width * height * nc]);
+    std::unique_ptr<float[]> dst(new float[out_width * out_height * nc]);
+    ppl::cv::debug::randomFill<float>(src.get(), width * height * nc, 0, 255);
+    setTier(state.range(0));
+    for (auto _ : state) {
+        ppl::cv::x86::ResizeLinear<float, nc>(height, width, width * nc, src.get(), out_height, out_width, out_width * nc, dst.get());
+    }
+    setTier(0);
+    state.SetItemsProcessed(state.iterations() * 1);
+}
+
+template<typename T, int32_t nc>
+void BM_WarpAffineLinear_isa_ppl_x86(benchmark::State &state) {
+    int32_t width = 3840;
+    int32_t height = 2160;
+    std::unique_ptr<T[]> src(new T[width * height * nc]);
+    std::unique_ptr<T[]> dst(new T[width * height * nc]);
+    ppl::cv::debug::randomFill<T>(src.get(), width * height * nc, 0, 255);
+    double M[6] = {0.9, 0.1, -10.0, -0.12, 1.05, 20.0};
+    setTier(state.range(0));
+    for (auto _ : state) {
+        ppl::cv::x86::WarpAffineLinear<T, nc>(height, width, width * nc, src.get(), height, width, width * nc, dst.get(), M, ppl::cv::BORDER_CONSTANT, 0);
+    }
+    setTier(0);
+    state.SetItemsProcessed(state.iterations() * 1);
+}
+
+template<typename T, int32_t nc>
+void BM_Filter2D_isa_ppl_x86(benchmark::State &state) {
+    int32_t width = 3840;
+    int32_t height = 2160;
+    std::unique_ptr<T[]> src(new T[width * height * nc]);
+    std::unique_ptr<T[]> dst(new T[width * height * nc]);
+    ppl::cv::debug::randomFill<T>(src.get(), width * height * nc, 0, 255);
+    float kernel[25];
+    ppl::cv::debug::randomFill<float>(kernel, 25, 0, 1);
+    setTier(state.range(0));
+    for (auto _ : state) {
+        ppl::cv::x86::Filter2D<T, nc>(height, width, width * nc, src.get(), 5, kernel, width * nc, dst.get(), ppl::cv::BORDER_REFLECT_101);
+    }
+    setTier(0);
+    state.SetItemsProcessed(state.iterations() * 1);
+}
+
+template<int32_t nc>
+void BM_GaussianBlur_isa_ppl_x86(benchmark::State &state) {
+    int32_t width = 3840;
+    int32_t height = 2160;
+    std::unique_ptr<float[]> src(new float[width * height * nc]);
+    std::unique_ptr<float[]> dst(new float[width * height * nc]);
+    ppl::cv::debug::randomFill<float>(src.get(), width * height * nc, 0, 255);
+    setTier(state.range(0));
+    for (auto _ : state) {
+        ppl::cv::x86::GaussianBlur<float, nc>(height, width, width * nc, src.get(), 5, 0.0f, width * nc, dst.get(), ppl::cv::BORDER_DEFAULT);
+    }
+    setTier(0);
+    state.SetItemsProcessed(state.iterations() * 1);
+}
+
+using namespace ppl::cv::debug;
+BENCHMARK_TEMPLATE(BM_Split3Channels_isa_ppl_x86, uint8_t)->Arg(0)->Arg(1)->Arg(2)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_Split3Channels_isa_ppl_x86, float)->Arg(0)->Arg(1)->Arg(2)->UseRealTime();
+BENCHMARK(BM_NV122BGR_isa_ppl_x86)->Arg(0)->Arg(1)->Arg(2)->UseRealTime();
+BENCHMARK(BM_BGR2NV12_isa_ppl_x86)->Arg(0)->Arg(1)->Arg(2)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ResizeLinear_isa_ppl_x86, c3)->Arg(0)->Arg(1)->Arg(2)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_WarpAffineLinear_isa_ppl_x86, float, c3)->Arg(0)->Arg(1)->Arg(2)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_WarpAffineLinear_isa_ppl_x86, uint8_t, c3)->Arg(0)->Arg(1)->Arg(2)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_Filter2D_isa_ppl_x86, float, c3)->Arg(0)->Arg(1)->Arg(2)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_Filter2D_isa_ppl_x86, uint8_t, c3)->Arg(0)->Arg(1)->Arg(2)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_GaussianBlur_isa_ppl_x86, c3)->Arg(0)->Arg(1)->Arg(2)->UseRealTime();
+}
@@ -0,0 +1,152 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "ppl/cv/x86/isa.h"
+#include "ppl/cv/x86/split.h"
+#include "ppl/cv/x86/merge.h"
+#include "ppl/cv/x86/resize.h"
+#include "ppl/cv/x86/warpaffine.h"
+#include "ppl/cv/x86/filter2d.h"
+#include "ppl/cv/x86/gaussianblur.h"
+#include "ppl/cv/x86/cvtcolor.h"
+#include "ppl/common/x86/sysinfo.h"
+#include "ppl/cv/debug.h"
+#include "ppl/cv/x86/test.h"
+#include <gtest/gtest.h>
+#include <functional>
+#include <type_traits>
+#include <memory>
+
+TEST(isa, mask)
+{
+    EXPECT_EQ(ppl::cv::x86::GetIsaMask(), 0xffffffffu);
+    EXPECT_EQ(ppl::cv::x86::SetIsaMask(ppl::common::ISA_X86_SSE41), ppl::common::RC_SUCCESS);
+    EXPECT_EQ(ppl::cv::x86::GetIsaMask(), (uint32_t)ppl::common::ISA_X86_SSE41);
+    EXPECT_EQ(ppl::cv::x86::SetIsaMask(0xffffffffu), ppl::common::RC_SUCCESS);
+    EXPECT_EQ(ppl::cv::x86::GetIsaMask(), 0xffffffffu);
+}
+
+// The AVX-512 kernels have to give the results of the FMA/AVX kernels they
+// take over from. Integer kernels match exactly; float kernels may round
+// differently where the compiler fuses a multiply-add in one tier only.
+template <typename T, int32_t c>
+void checkIsaInvariant(
+    int32_t height,
+    int32_t width,
+    const std::function<void(T *)> &func,
+    float diff_THR = 1.0f)
+{
+    std::unique_ptr<T[]> dst_ref(new T[height * width * c]);
+    std::unique_ptr<T[]> dst(new T[height * width * c]);
+
+    ppl::cv::x86::SetIsaMask(~(uint32_t)ppl::common::ISA_X86_AVX512);
+    func(dst_ref.get());
+    ppl::cv::x86::SetIsaMask(0xffffffffu);
+    func(dst.get());
+
+    checkResult<T, c>(dst_ref.get(), dst.get(), height, width, width * c, width * c, diff_THR);
+}
+
+template <typename T, int32_t c>
+class isa_ : public ::testing::TestWithParam<Size> {
+public:
+    void apply(const Size &size)
+    {
+        int32_t height = size.height;
+        int32_t width  = size.width;
+        float diff     = std::is_same<T, float>::value ? 1e-3f : 1.0f;
+        std::unique_ptr<T[]> src(new T[height * width * 4]);
+        ppl::cv::debug::randomFill<T>(src.get(), height * width * 4, 0, 255);
+        const T *in = src.get();
+
+        if (c == 3) {
+            checkIsaInvariant<T, 1>(height * 3, width, [&](T *out) {
+                ppl::cv::x86::Split3Channels<T>(height, width, width * 3, in, width, out, out + height * width, out + 2 * height * width);
+            });
+            checkIsaInvariant<T, 3>(height, width, [&](T *out) {
+                ppl::cv::x86::Merge3Channels<T>(height, width, width, in, in + height * width, in + 2 * height * width, width * 3, out);
+            });
+        } else if (c == 4) {
+            checkIsaInvariant<T, 1>(height * 4, width, [&](T *out) {
+                ppl::cv::x86::Split4Channels<T>(height, width, width * 4, in, width, out, out + height * width, out + 2 * height * width, out + 3 * height * width);
+            });
+            checkIsaInvariant<T, 4>(height, width, [&](T *out) {
+                ppl::cv::x86::Merge4Channels<T>(height, width, width, in, in + height * width, in + 2 * height * width, in + 3 * height * width, width * 4, out);
+            });
+        }
+        checkIsaInvariant<T, c>(height * 2 / 3, width * 3 / 4, [&](T *out) {
+            ppl::cv::x86::ResizeLinear<T, c>(height, width, width * c, in, height * 2 / 3, width * 3 / 4, width * 3 / 4 * c, out);
+        }, diff);
+        double M[6] = {0.9, 0.1, -10.0, -0.12, 1.05, 20.0};
+        checkIsaInvariant<T, c>(height, width, [&](T *out) {
+            ppl::cv::x86::WarpAffineLinear<T, c>(height, width, width * c, in, height, width, width * c, out, M, ppl::cv::BORDER_REPLICATE, 0);
+        }, diff);
+        float kernel[25];
+        for (int32_t i = 0; i < 25; ++i) {
+            kernel[i] = (i % 5 - 2) / 13.0f;
+        }
+        checkIsaInvariant<T, c>(height, width, [&](T *out) {
+            ppl::cv::x86::Filter2D<T, c>(height, width, width * c, in, 5, kernel, width * c, out, ppl::cv::BORDER_REFLECT_101);
+        }, diff);
+        checkIsaInvariant<T, c>(height, width, [&](T *out) {
+            ppl::cv::x86::GaussianBlur<T, c>(height, width, width * c, in, 5, 0.0f, width * c, out, ppl::cv::BORDER_REFLECT_101);
+        }, diff);
+    }
+};
+
+#define R(name, t, c)                                                                        \
+    using name = isa_<t, c>;                                                                 \
+    TEST_P(name, abc)                                                                        \
+    {                                                                                        \
+        this->apply(GetParam());                                                             \
+    }                                                                                        \
+    INSTANTIATE_TEST_CASE_P(standard, name,                                                  \
+                            ::testing::Values(Size{320, 240}, Size{643, 361}, Size{1283, 723}));
+
+R(isa_f32c1, float, 1)
+R(isa_f32c3, float, 3)
+R(isa_f32c4, float, 4)
+R(isa_u8c1, uint8_t, 1)
+R(isa_u8c3, uint8_t, 3)
+R(isa_u8c4, uint8_t, 4)
+
+TEST(isa, yuv420)
+{
+    const int32_t height = 722, width = 1282;
+    std::unique_ptr<uint8_t[]> src(new uint8_t[height * width * 4]);
+    ppl::cv::debug::randomFill<uint8_t>(src.get(), height * width * 4, 0, 255);
+    const uint8_t *in = src.get();
+
+    checkIsaInvariant<uint8_t, 3>(height, width, [&](uint8_t *out) {
+        ppl::cv::x86::NV122BGR<uint8_t>(height, width, width, in, width * 3, out);
+    });
+    checkIsaInvariant<uint8_t, 4>(height, width, [&](uint8_t *out) {
+        ppl::cv::x86::NV212RGBA<uint8_t>(height, width, width, in, width * 4, out);
+    });
+    checkIsaInvariant<uint8_t, 3>(height, width, [&](uint8_t *out) {
+        ppl::cv::x86::I4202BGR<uint8_t>(height, width, width, in, width * 3, out);
+    });
+    checkIsaInvariant<uint8_t, 1>(height * 3 / 2, width, [&](uint8_t *out) {
+        ppl::cv::x86::BGR2NV12<uint8_t>(height, width, width * 3, in, width, out);
+    });
+    checkIsaInvariant<uint8_t, 1>(height * 3 / 2, width, [&](uint8_t *out) {
+        ppl::cv::x86::RGBA2NV21<uint8_t>(height, width, width * 4, in, width, out);
+    });
+    checkIsaInvariant<uint8_t, 1>(height * 3 / 2, width, [&](uint8_t *out) {
+        ppl::cv::x86::BGR2I420<uint8_t>(height, width, width * 3, in, width, out);
+    });
+}
@@ -14,275 +14,125 @@
 // KIND, either express or implied.  See the License for the
 // specific language governing permissions and limitations
 // under the License.
-
 #include "ppl/cv/x86/laplacian.h"
+#include "ppl/cv/x86/filter_engine.hpp"
 #include "ppl/cv/types.h"
+#include "ppl/common/retcode.h"
 #include <string.h>
 #include <cmath>
 #include <algorithm>
+#include <immintrin.h>
 
 namespace ppl {
 namespace cv {
 namespace x86 {
 
-inline static uint8_t sat_cast(int32_t data)
+static inline __m128 load_ps(const float *src)
 {
-    int32_t val;
-    val = data > 255 ? 255 : data;
-    val = (data < 0) ? 0 : val;
-    return val;
+    return _mm_loadu_ps(src);
 }
 
-void x86laplacian_c_1(
-    int32_t height,
-    int32_t width,
-    int32_t inWidthStride,
-    int32_t outWidthStride,
-    const uint8_t* inData,
-    uint8_t* outData,
-    double scale,
-    double delta,
-    int32_t cn)
+static inline __m128 load_ps(const uint8_t *src)
 {
-    for (int32_t i = 0; i < width * cn; ++i) {
-        int16_t temp = -4 * inData[i] + inData[i + inWidthStride] * 2;
-        if (i < cn) {
-            temp += inData[i + cn] * 2;
-        } else if (i >= (width - 1) * cn) {
-            temp += inData[i - cn] * 2;
-        } else {
-            temp += inData[i - cn] + inData[i + cn];
-        }
-        outData[i] = sat_cast(scale * temp + delta);
-    }
-
-    for (int32_t i = 1; i < height - 1; ++i) {
-        int32_t j;
-        for (j = 0; j < cn; ++j) {
-            int16_t temp = -4 * inData[i * inWidthStride + j] +
-                           2 * inData[i * inWidthStride + j + cn] +
-                           inData[(i - 1) * inWidthStride + j] +
-                           inData[(i + 1) * inWidthStride + j];
-            outData[i * outWidthStride + j] = sat_cast(scale * temp + delta);
-        }
-        for (j = cn; j < (width - 1) * cn; ++j) {
-            int16_t temp = -4 * inData[i * inWidthStride + j] +
-                           inData[i * inWidthStride + j - cn] +
-                           inData[i * inWidthStride + j + cn] +
-                           inData[(i - 1) * inWidthStride + j] +
-                           inData[(i + 1) * inWidthStride + j];
-            outData[i * outWidthStride + j] = sat_cast(scale * temp + delta);
-        }
-        for (j = (width - 1) * cn; j < width * cn; ++j) {
-            int16_t temp = -4 * inData[i * inWidthStride + j] +
-                           2 * inData[i * inWidthStride + j - cn] +
-                           inData[(i - 1) * inWidthStride + j] +
-                           inData[(i + 1) * inWidthStride + j];
-            outData[i * outWidthStride + j] = sat_cast(scale * temp + delta);
-        }
-    }
-
-    int32_t bottom_offset = (height - 1) * inWidthStride;
-    for (int32_t i = 0; i < width * cn; ++i) {
-        int16_t temp = -4 * inData[bottom_offset + i] + inData[bottom_offset + i - inWidthStride] * 2;
-        if (i < cn) {
-            temp += inData[bottom_offset + i + cn] * 2;
-        } else if (i >= (width - 1) * cn) {
-            temp += inData[bottom_offset + i - cn] * 2;
-        } else {
-            temp += inData[bottom_offset + i - cn] + inData[bottom_offset + i + cn];
-        }
-        outData[(height - 1) * outWidthStride + i] = sat_cast(scale * temp + delta);
-    }
+    return _mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_cvtsi32_si128(*(const int32_t *)src)));
 }
 
-void x86laplacian_c_3(
-    int32_t height,
-    int32_t width,
-    int32_t inWidthStride,
-    int32_t outWidthStride,
-    const uint8_t* inData,
-    uint8_t* outData,
-    double scale,
-    double delta,
-    int32_t cn)
+static inline void store_ps(float *dst, __m128 v)
 {
-    for (int32_t i = 0; i < width * cn; ++i) {
-        int16_t temp = -8 * inData[i];
-        if (i < cn) {
-            temp += inData[i + inWidthStride + cn] * 8;
-        } else if (i >= (width - 1) * cn) {
-            temp += inData[i + inWidthStride - cn] * 8;
-        } else {
-            temp += inData[i + inWidthStride - cn] * 4 +
-                    inData[i + inWidthStride + cn] * 4;
-        }
-        outData[i] = sat_cast(scale * temp + delta);
-    }
-
-    for (int32_t i = 1; i < height - 1; ++i) {
-        int32_t j;
-        for (j = 0; j < cn; ++j) {
-            int16_t temp = -8 * inData[i * inWidthStride + j] +
-                           4 * inData[(i - 1) * inWidthStride + j + cn] +
-                           4 * inData[(i + 1) * inWidthStride + j + cn];
-            outData[i * outWidthStride + j] = sat_cast(scale * temp + delta);
-        }
-        for (j = cn; j < (width - 1) * cn; ++j) {
-            int16_t temp = -8 * inData[i * inWidthStride + j] +
-                           2 * inData[(i - 1) * inWidthStride + j - cn] +
-                           2 * inData[(i - 1) * inWidthStride + j + cn] +
-                           2 * inData[(i + 1) * inWidthStride + j - cn] +
-                           2 * inData[(i + 1) * inWidthStride + j + cn];
-            outData[i * outWidthStride + j] = sat_cast(scale * temp + delta);
-        }
-        for (j = (width - 1) * cn; j < width * cn; ++j) {
-            int16_t temp = -8 * inData[i * inWidthStride + j] +
-                           4 * inData[(i - 1) * inWidthStride + j - cn] +
-                           4 * inData[(i + 1) * inWidthStride + j - cn];
-            outData[i * outWidthStride + j] = sat_cast(scale * temp + delta);
-        }
-    }
-
-    int32_t bottom_offset = (height - 1) * inWidthStride;
-    for (int32_t i = 0; i < width * cn; ++i) {
-        int16_t temp = -8 * inData[bottom_offset + i];
-        if (i < cn) {
-            temp += inData[bottom_offset + i - inWidthStride + cn] * 8;
-        } else if (i >= (width - 1) * cn) {
-            temp += inData[bottom_offset + i - inWidthStride - cn] * 8;
-        } else {
-            temp += inData[bottom_offset + i - inWidthStride - cn] * 4 +
-                    inData[bottom_offset + i - inWidthStride + cn] * 4;
-        }
-        outData[(height - 1) * outWidthStride + i] = sat_cast(scale * temp + delta);
-    }
+    _mm_storeu_ps(dst, v);
 }
 
-void x86laplacian_f_1(
-    int32_t height,
-    int32_t width,
-    int32_t inWidthStride,
-    int32_t outWidthStride,
-    const float* inData,
-    float* outData,
-    double scale,
-    double delta,
-    int32_t cn)
+static inline void store_ps(uint8_t *dst, __m128 v)
 {
-    for (int32_t i = 0; i < width * cn; ++i) {
-        float temp = -4 * inData[i] + inData[i + inWidthStride] * 2;
-        if (i < cn) {
-            temp += inData[i + cn] * 2;
-        } else if (i >= (width - 1) * cn) {
-            temp += inData[i - cn] * 2;
-        } else {
-            temp += inData[i - cn] + inData[i + cn];
-        }
-        outData[i] = scale * temp + delta;
-    }
+    __m128i i32 = _mm_cvtps_epi32(v);
+    __m128i u8  = _mm_packus_epi16(_mm_packs_epi32(i32, i32), i32);
+    *(int32_t *)dst = _mm_cvtsi128_si32(u8);
+}
 
-    for (int32_t i = 1; i < height - 1; ++i) {
-        int32_t j;
-        for (j = 0; j < cn; ++j) {
-            float temp = -4 * inData[i * inWidthStride + j] +
-                         2 * inData[i * inWidthStride + j + cn] +
-                         inData[(i - 1) * inWidthStride + j] +
-                         inData[(i + 1) * inWidthStride + j];
-            outData[i * outWidthStride + j] = scale * temp + delta;
-        }
-        for (j = cn; j < (width - 1) * cn; ++j) {
-            float temp = -4 * inData[i * inWidthStride + j] +
-                         inData[i * inWidthStride + j - cn] +
-                         inData[i * inWidthStride + j + cn] +
-                         inData[(i - 1) * inWidthStride + j] +
-                         inData[(i + 1) * inWidthStride + j];
-            outData[i * outWidthStride + j] = scale * temp + delta;
-        }
-        for (j = (width - 1) * cn; j < width * cn; ++j) {
-            float temp = -4 * inData[i * inWidthStride + j] +
-                         2 * inData[i * inWidthStride + j - cn] +
-                         inData[(i - 1) * inWidthStride + j] +
-                         inData[(i + 1) * inWidthStride + j];
-            outData[i * outWidthStride + j] = scale * temp + delta;
-        }
-    }
+static inline void store_ss(float *dst, float v)
+{
+    *dst = v;
+}
 
-    int32_t bottom_offset = (height - 1) * inWidthStride;
-    for (int32_t i = 0; i < width * cn; ++i) {
-        float temp = -4 * inData[bottom_offset + i] + inData[bottom_offset + i - inWidthStride] * 2;
-        if (i < cn) {
-            temp += inData[bottom_offset + i + cn] * 2;
-        } else if (i >= (width - 1) * cn) {
-            temp += inData[bottom_offset + i - cn] * 2;
-        } else {
-            temp += inData[bottom_offset + i - cn] + inData[bottom_offset + i + cn];
-        }
-        outData[(height - 1) * outWidthStride + i] = scale * temp + delta;
-    }
+static inline void store_ss(uint8_t *dst, float v)
+{
+    int32_t i = _mm_cvtss_si32(_mm_set_ss(v));
+    *dst      = (uint8_t)std::min(std::max(i, 0), 255);
 }
 
-void x86laplacian_f_3(
+// 3x3 aperture of the Laplacian on rows extended by one pixel each side:
+// ksize 1 is [0 1 0; 1 -4 1; 0 1 0], ksize 3 is [2 0 2; 0 -8 0; 2 0 2].
+// Sums are exact in float for both data types.
+template <typename T>
+struct LaplacianFilter {
+    LaplacianFilter(int32_t _ksize, double _scale, double _delta)
+        : ksize(_ksize)
+        , scale(_scale)
+        , delta(_delta) {}
+
+    void operator()(const T **src, T *dst, int32_t dststep, int32_t count, int32_t width, int32_t cn) const
+    {
+        __m128 scale4 = _mm_set1_ps(scale);
+        __m128 delta4 = _mm_set1_ps(delta);
+        int32_t len   = width * cn;
+        for (; count-- > 0; src++, dst += dststep) {
+            const T *S0 = src[0], *S1 = src[1], *S2 = src[2];
+            int32_t i   = 0;
+            if (ksize == 1) {
+                __m128 m4 = _mm_set1_ps(-4.f);
+                for (; i <= len - 4; i += 4) {
+                    __m128 s = _mm_add_ps(_mm_add_ps(load_ps(S1 + i), load_ps(S1 + i + 2 * cn)),
+                                          _mm_add_ps(load_ps(S0 + i + cn), load_ps(S2 + i + cn)));
+                    s        = _mm_add_ps(s, _mm_mul_ps(load_ps(S1 + i + cn), m4));
+                    store_ps(dst + i, _mm_add_ps(_mm_mul_ps(s, scale4), delta4));
+                }
+                for (; i < len; i++) {
+                    float s = (float)S1[i] + S1[i + 2 * cn] + S0[i + cn] + S2[i + cn] - 4.f * S1[i + cn];
+                    store_ss(dst + i, s * scale + delta);
+                }
+            } else {
+                __m128 m2 = _mm_set1_ps(2.f), m8 = _mm_set1_ps(-8.f);
+                for (; i <= len - 4; i += 4) {
+                    __m128 s = _mm_add_ps(_mm_add_ps(load_ps(S0 + i), load_ps(S0 + i + 2 * cn)),
+                                          _mm_add_ps(load_ps(S2 + i), load_ps(S2 + i + 2 * cn)));
+                    s        = _mm_add_ps(_mm_mul_ps(s, m2), _mm_mul_ps(load_ps(S1 + i + cn), m8));
+                    store_ps(dst + i, _mm_add_ps(_mm_mul_ps(s, scale4), delta4));
+                }
+                for (; i < len; i++) {
+                    float s = 2.f * ((float)S0[i] + S0[i + 2 * cn] + S2[i] + S2[i + 2 * cn]) - 8.f * S1[i + cn];
+                    store_ss(dst + i, s * scale + delta);
+                }
+            }
+        }
+    }
+    int32_t ksize;
+    float scale;
+    float delta;
+};
+
+template <typename T, int32_t nc>
+static ::ppl::common::RetCode laplacian(
     int32_t height,
     int32_t width,
     int32_t inWidthStride,
+    const T* inData,
     int32_t outWidthStride,
-    const float* inData,
-    float* outData,
+    T* outData,
+    int32_t ksize,
     double scale,
     double delta,
-    int32_t cn)
+    BorderType border_type)
 {
-    for (int32_t i = 0; i < width * cn; ++i) {
-        float temp = -8 * inData[i];
-        if (i < cn) {
-            temp += inData[i + inWidthStride + cn] * 8;
-        } else if (i >= (width - 1) * cn) {
-            temp += inData[i + inWidthStride - cn] * 8;
-        } else {
-            temp += inData[i + inWidthStride - cn] * 4 +
-                    inData[i + inWidthStride + cn] * 4;
-        }
-        outData[i] = scale * temp + delta;
-    }
-
-    for (int32_t i = 1; i < height - 1; ++i) {
-        int32_t j;
-        for (j = 0; j < cn; ++j) {
-            float temp = -8 * inData[i * inWidthStride + j] +
-                         4 * inData[(i - 1) * inWidthStride + j + cn] +
-                         4 * inData[(i + 1) * inWidthStride + j + cn];
-            outData[i * outWidthStride + j] = scale * temp + delta;
-        }
-        for (j = cn; j < (width - 1) * cn; ++j) {
-            float temp = -8 * inData[i * inWidthStride + j] +
-                         2 * inData[(i - 1) * inWidthStride + j - cn] +
-                         2 * inData[(i - 1) * inWidthStride + j + cn] +
-                         2 * inData[(i + 1) * inWidthStride + j - cn] +
-                         2 * inData[(i + 1) * inWidthStride + j + cn];
-            outData[i * outWidthStride + j] = scale * temp + delta;
-        }
-        for (j = (width - 1) * cn; j < width * cn; ++j) {
-            float temp = -8 * inData[i * inWidthStride + j] +
-                         4 * inData[(i - 1) * inWidthStride + j - cn] +
-                         4 * inData[(i + 1) * inWidthStride + j - cn];
-            outData[i * outWidthStride + j] = scale * temp + delta;
-        }
+    if (inData == nullptr || outData == nullptr) {
+        return ppl::common::RC_INVALID_VALUE;
     }
-
-    int32_t bottom_offset = (height - 1) * inWidthStride;
-    for (int32_t i = 0; i < width * cn; ++i) {
-        float temp = -8 * inData[bottom_offset + i];
-        if (i < cn) {
-            temp += inData[bottom_offset + i - inWidthStride + cn] * 8;
-        } else if (i >= (width - 1) * cn) {
-            temp += inData[bottom_offset + i - inWidthStride - cn] * 8;
-        } else {
-            temp += inData[bottom_offset + i - inWidthStride - cn] * 4 +
-                    inData[bottom_offset + i - inWidthStride + cn] * 4;
-        }
-        outData[(height - 1) * outWidthStride + i] = scale * temp + delta;
+    if (height <= 0 || width <= 0 || inWidthStride < width * nc || outWidthStride < width * nc ||
+        (ksize != 1 && ksize != 3) || !filter_border_supported(border_type)) {
+        return ppl::common::RC_INVALID_VALUE;
     }
+    FilterEngine<T, T, LaplacianFilter<T>> engine(height, width, nc, 3, 3, border_type, 0, LaplacianFilter<T>(ksize, scale, delta));
+    engine.process(inData, inWidthStride, outData, outWidthStride);
+    return ppl::common::RC_SUCCESS;
 }
 
 template <>
@@ -298,18 +148,7 @@ template <>
     double delta,
     BorderType border_type)
 {
-    if (inData == nullptr || outData == nullptr) {
-        return ppl::common::RC_INVALID_VALUE;
-    }
-    if (height <= 1 || width <= 1 || (ksize != 1 && ksize != 3) || border_type != ppl::cv::BORDER_REFLECT_101) {
-        return ppl::common::RC_INVALID_VALUE;
-    } 
-    if (ksize == 1) {
-        x86laplacian_c_1(height, width, inWidthStride, outWidthStride, inData, outData, scale, delta, 1);
-    } else if (ksize == 3) {
-        x86laplacian_c_3(height, width, inWidthStride, outWidthStride, inData, outData, scale, delta, 1);
-    }
-    return ppl::common::RC_SUCCESS;
+    return laplacian<uint8_t, 1>(height, width, inWidthStride, inData, outWidthStride, outData, ksize, scale, delta, border_type);
 }
 
 template <>
@@ -325,18 +164,7 @@ template <>
     double delta,
     BorderType border_type)
 {
-    if (inData == nullptr || outData == nullptr) {
-        return ppl::common::RC_INVALID_VALUE;
-    }
-    if (height <= 1 || width <= 1 || (ksize != 1 && ksize != 3) || border_type != ppl::cv::BORDER_REFLECT_101) {
-        return ppl::common::RC_INVALID_VALUE;
-    } 
-    if (ksize == 1) {
-        x86laplacian_c_1(height, width, inWidthStride, outWidthStride, inData, outData, scale, delta, 3);
-    } else if (ksize == 3) {
-        x86laplacian_c_3(height, width, inWidthStride, outWidthStride, inData, outData, scale, delta, 3);
-    }
-    return ppl::common::RC_SUCCESS;
+    return laplacian<uint8_t, 3>(height, width, inWidthStride, inData, outWidthStride, outData, ksize, scale, delta, border_type);
 }
 
 template <>
@@ -352,18 +180,7 @@ template <>
     double delta,
     BorderType border_type)
 {
-    if (inData == nullptr || outData == nullptr) {
-        return ppl::common::RC_INVALID_VALUE;
-    }
-    if (height <= 1 || width <= 1 || (ksize != 1 && ksize != 3) || border_type != ppl::cv::BORDER_REFLECT_101) {
-        return ppl::common::RC_INVALID_VALUE;
-    } 
-    if (ksize == 1) {
-        x86laplacian_c_1(height, width, inWidthStride, outWidthStride, inData, outData, scale, delta, 4);
-    } else if (ksize == 3) {
-        x86laplacian_c_3(height, width, inWidthStride, outWidthStride, inData, outData, scale, delta, 4);
-    }
-    return ppl::common::RC_SUCCESS;
+    return laplacian<uint8_t, 4>(height, width, inWidthStride, inData, outWidthStride, outData, ksize, scale, delta, border_type);
 }
 
 template <>
@@ -379,18 +196,7 @@ template <>
     double delta,
     BorderType border_type)
 {
-    if (inData == nullptr || outData == nullptr) {
-        return ppl::common::RC_INVALID_VALUE;
-    }
-    if (height <= 1 || width <= 1 || (ksize != 1 && ksize != 3) || border_type != ppl::cv::BORDER_REFLECT_101) {
-        return ppl::common::RC_INVALID_VALUE;
-    } 
-    if (ksize == 1) {
-        x86laplacian_f_1(height, width, inWidthStride, outWidthStride, inData, outData, scale, delta, 1);
-    } else if (ksize == 3) {
-        x86laplacian_f_3(height, width, inWidthStride, outWidthStride, inData, outData, scale, delta, 1);
-    }
-    return ppl::common::RC_SUCCESS;
+    return laplacian<float, 1>(height, width, inWidthStride, inData, outWidthStride, outData, ksize, scale, delta, border_type);
 }
 
 template <>
@@ -406,18 +212,7 @@ template <>
     double delta,
     BorderType border_type)
 {
-    if (inData == nullptr || outData == nullptr) {
-        return ppl::common::RC_INVALID_VALUE;
-    }
-    if (height <= 1 || width <= 1 || (ksize != 1 && ksize != 3) || border_type != ppl::cv::BORDER_REFLECT_101) {
-        return ppl::common::RC_INVALID_VALUE;
-    } 
-    if (ksize == 1) {
-        x86laplacian_f_1(height, width, inWidthStride, outWidthStride, inData, outData, scale, delta, 3);
-    } else if (ksize == 3) {
-        x86laplacian_f_3(height, width, inWidthStride, outWidthStride, inData, outData, scale, delta, 3);
-    }
-    return ppl::common::RC_SUCCESS;
+    return laplacian<float, 3>(height, width, inWidthStride, inData, outWidthStride, outData, ksize, scale, delta, border_type);
 }
 
 template <>
@@ -433,18 +228,7 @@ template <>
     double delta,
     BorderType border_type)
 {
-    if (inData == nullptr || outData == nullptr) {
-        return ppl::common::RC_INVALID_VALUE;
-    }
-    if (height <= 1 || width <= 1 || (ksize != 1 && ksize != 3) || border_type != ppl::cv::BORDER_REFLECT_101) {
-        return ppl::common::RC_INVALID_VALUE;
-    } 
-    if (ksize == 1) {
-        x86laplacian_f_1(height, width, inWidthStride, outWidthStride, inData, outData, scale, delta, 4);
-    } else if (ksize == 3) {
-        x86laplacian_f_3(height, width, inWidthStride, outWidthStride, inData, outData, scale, delta, 4);
-    }
-    return ppl::common::RC_SUCCESS;
+    return laplacian<float, 4>(height, width, inWidthStride, inData, outWidthStride, outData, ksize, scale, delta, border_type);
 }
 
 }
@@ -22,7 +22,8 @@
 #include "ppl/cv/debug.h"
 
 template<typename T, int32_t filter_size, int32_t nc>
-void LaplacianTest(int32_t height, int32_t width, double scale, double delta, T diff) {
+void LaplacianTest(int32_t height, int32_t width, double scale, double delta, T diff,
+                   ppl::cv::BorderType border_type = ppl::cv::BORDER_REFLECT_101) {
     std::unique_ptr<T[]> src(new T[width * height * nc]);
     std::unique_ptr<T[]> dst_ref(new T[width * height * nc]);
     std::unique_ptr<T[]> dst(new T[width * height * nc]);
@@ -30,9 +31,18 @@ void LaplacianTest(int32_t height, int32_t width, double scale, double delta, T
     cv::Mat src_opencv(height, width, CV_MAKETYPE(cv::DataType<T>::depth, nc), src.get(), sizeof(T) * width * nc);
     cv::Mat dst_opencv(height, width, CV_MAKETYPE(cv::DataType<T>::depth, nc), dst_ref.get(), sizeof(T) * width * nc);
 
-    cv::Laplacian(src_opencv, dst_opencv, cv::DataType<T>::depth, filter_size, scale, delta);
+    if (border_type == ppl::cv::BORDER_WRAP) {
+        // OpenCV filters reject BORDER_WRAP, so filter a wrapped copy and crop it.
+        int32_t radius = filter_size > 1 ? filter_size / 2 : 1;
+        cv::Mat padded, filtered;
+        cv::copyMakeBorder(src_opencv, padded, radius, radius, radius, radius, cv::BORDER_WRAP);
+        cv::Laplacian(padded, filtered, cv::DataType<T>::depth, filter_size, scale, delta, cv::BORDER_REPLICATE);
+        filtered(cv::Rect(radius, radius, width, height)).copyTo(dst_opencv);
+    } else {
+        cv::Laplacian(src_opencv, dst_opencv, cv::DataType<T>::depth, filter_size, scale, delta, (int)border_type);
+    }
     ppl::cv::x86::Laplacian<T, nc>(height, width, width * nc, src.get(), width * nc, dst.get(),
-                            filter_size, scale, delta, ppl::cv::BORDER_REFLECT_101);
+                            filter_size, scale, delta, border_type);
 
     checkResult<T, nc>(dst_ref.get(), dst.get(),
                     height, width,
@@ -60,3 +70,17 @@ TEST(Laplacian_UINT8, x86)
     LaplacianTest<uint8_t, 3, 3>(720, 1080, 2, 1, 1);
     LaplacianTest<uint8_t, 3, 4>(720, 1080, 2, 1, 1);
 }
+
+TEST(Laplacian_Border, x86)
+{
+    const ppl::cv::BorderType border_types[] = {ppl::cv::BORDER_CONSTANT, ppl::cv::BORDER_REPLICATE,
+                                                ppl::cv::BORDER_REFLECT, ppl::cv::BORDER_WRAP};
+    for (ppl::cv::BorderType border_type : border_types) {
+        LaplacianTest<float, 1, 1>(241, 321, 2.0, 1.0, 1, border_type);
+        LaplacianTest<float, 3, 3>(241, 321, 2.0, 1.0, 1, border_type);
+        LaplacianTest<float, 3, 4>(1, 17, 2.0, 1.0, 1, border_type);
+        LaplacianTest<uint8_t, 1, 3>(241, 321, 2, 1, 1, border_type);
+        LaplacianTest<uint8_t, 3, 1>(241, 321, 2, 1, 1, border_type);
+        LaplacianTest<uint8_t, 3, 4>(17, 1, 2, 1, 1, border_type);
+    }
+}
@@ -16,14 +16,309 @@
 // under the License.
 
 #include "ppl/cv/x86/meanstddev.h"
+#include "ppl/cv/x86/parallel.hpp"
 #include <cmath>
 #include <cstdlib>
 #include <algorithm>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+#include <smmintrin.h>
 
 namespace ppl {
 namespace cv {
 namespace x86 {
 
+// 16-bit lane sums of uint8_t values overflow after 257 blocks, flush them
+// to 64-bit before that.
+#define MEANSTDDEV_U8_BLOCKS (256)
+
+// Sums of one band of rows, merged in row order so that the result does not
+// depend on which thread finishes first.
+template <typename Acc>
+struct MeanStdDevPartial {
+    int32_t begin;
+    Acc sum[4];
+    Acc sqsum[4];
+    int64_t count;
+};
+
+// Byte k * 16 + i of a block of 16 pixels belongs to pixel (k * 16 + i) / channels.
+template <int32_t channels>
+static inline __m128i meanstddev_expand_mask_u8(__m128i mask, int32_t k)
+{
+    static const int8_t index_c3[3][16] = {
+        {0, 0, 0, 1, 1, 1, 2, 2, 2, 3, 3, 3, 4, 4, 4, 5},
+        {5, 5, 6, 6, 6, 7, 7, 7, 8, 8, 8, 9, 9, 9, 10, 10},
+        {10, 11, 11, 11, 12, 12, 12, 13, 13, 13, 14, 14, 14, 15, 15, 15}};
+    static const int8_t index_c4[4][16] = {
+        {0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3},
+        {4, 4, 4, 4, 5, 5, 5, 5, 6, 6, 6, 6, 7, 7, 7, 7},
+        {8, 8, 8, 8, 9, 9, 9, 9, 10, 10, 10, 10, 11, 11, 11, 11},
+        {12, 12, 12, 12, 13, 13, 13, 13, 14, 14, 14, 14, 15, 15, 15, 15}};
+    if (channels == 3) {
+        return _mm_shuffle_epi8(mask, _mm_loadu_si128((const __m128i*)index_c3[k]));
+    }
+    if (channels == 4) {
+        return _mm_shuffle_epi8(mask, _mm_loadu_si128((const __m128i*)index_c4[k]));
+    }
+    return mask;
+}
+
+// Float k * 4 + i of a block of 4 pixels belongs to pixel (k * 4 + i) / channels.
+template <int32_t channels>
+static inline __m128i meanstddev_expand_mask_fp32(__m128i mask, int32_t k)
+{
+    if (channels == 3) {
+        switch (k) {
+            case 0: return _mm_shuffle_epi32(mask, _MM_SHUFFLE(1, 0, 0, 0));
+            case 1: return _mm_shuffle_epi32(mask, _MM_SHUFFLE(2, 2, 1, 1));
+            default: return _mm_shuffle_epi32(mask, _MM_SHUFFLE(3, 3, 3, 2));
+        }
+    }
+    if (channels == 4) {
+        switch (k) {
+            case 0: return _mm_shuffle_epi32(mask, _MM_SHUFFLE(0, 0, 0, 0));
+            case 1: return _mm_shuffle_epi32(mask, _MM_SHUFFLE(1, 1, 1, 1));
+            case 2: return _mm_shuffle_epi32(mask, _MM_SHUFFLE(2, 2, 2, 2));
+            default: return _mm_shuffle_epi32(mask, _MM_SHUFFLE(3, 3, 3, 3));
+        }
+    }
+    return mask;
+}
+
+// Exact sums of rows [begin, end). Every byte of a block of 16 pixels keeps
+// its own lane: values in 16-bit and squares in 32-bit, both flushed to
+// 64-bit before they can overflow. Masked out pixels are zeroed, not skipped.
+template <int32_t channels, bool use_mask>
+static void meanstddev_rows_u8(
+    int32_t begin,
+    int32_t end,
+    int32_t width,
+    int32_t srcStride,
+    const uint8_t* inData,
+    int32_t maskStride,
+    const uint8_t* mask,
+    MeanStdDevPartial<uint64_t>* partial)
+{
+    uint64_t lane_sum[16 * channels]   = {0};
+    uint64_t lane_sqsum[16 * channels] = {0};
+    uint64_t zeros                     = 0;
+
+    __m128i v_zero = _mm_setzero_si128();
+    __m128i v_one  = _mm_set1_epi8(1);
+    for (int32_t y = begin; y < end; ++y) {
+        const uint8_t* base_in   = inData + y * srcStride;
+        const uint8_t* base_mask = use_mask ? mask + y * maskStride : nullptr;
+
+        int32_t x = 0;
+        while (x <= width - 16) {
+            __m128i v_sum[channels][2], v_sqsum[channels][4];
+            __m128i v_zeros = v_zero;
+            for (int32_t k = 0; k < channels; ++k) {
+                v_sum[k][0] = v_sum[k][1] = v_zero;
+                v_sqsum[k][0] = v_sqsum[k][1] = v_sqsum[k][2] = v_sqsum[k][3] = v_zero;
+            }
+
+            int32_t block_end = std::min(width - 15, x + 16 * MEANSTDDEV_U8_BLOCKS);
+            for (; x < block_end; x += 16) {
+                __m128i v_mask = v_zero;
+                if (use_mask) {
+                    v_mask  = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(base_mask + x)), v_zero);
+                    v_zeros = _mm_add_epi64(v_zeros, _mm_sad_epu8(_mm_and_si128(v_mask, v_one), v_zero));
+                }
+                for (int32_t k = 0; k < channels; ++k) {
+                    __m128i v_src = _mm_loadu_si128((const __m128i*)(base_in + x * channels + k * 16));
+                    if (use_mask) {
+                        v_src = _mm_andnot_si128(meanstddev_expand_mask_u8<channels>(v_mask, k), v_src);
+                    }
+                    __m128i v_lo    = _mm_unpacklo_epi8(v_src, v_zero);
+                    __m128i v_hi    = _mm_unpackhi_epi8(v_src, v_zero);
+                    __m128i v_sq_lo = _mm_mullo_epi16(v_lo, v_lo);
+                    __m128i v_sq_hi = _mm_mullo_epi16(v_hi, v_hi);
+                    v_sum[k][0]     = _mm_add_epi16(v_sum[k][0], v_lo);
+                    v_sum[k][1]     = _mm_add_epi16(v_sum[k][1], v_hi);
+                    v_sqsum[k][0]   = _mm_add_epi32(v_sqsum[k][0], _mm_unpacklo_epi16(v_sq_lo, v_zero));
+                    v_sqsum[k][1]   = _mm_add_epi32(v_sqsum[k][1], _mm_unpackhi_epi16(v_sq_lo, v_zero));
+                    v_sqsum[k][2]   = _mm_add_epi32(v_sqsum[k][2], _mm_unpacklo_epi16(v_sq_hi, v_zero));
+                    v_sqsum[k][3]   = _mm_add_epi32(v_sqsum[k][3], _mm_unpackhi_epi16(v_sq_hi, v_zero));
+                }
+            }
+
+            for (int32_t k = 0; k < channels; ++k) {
+                uint16_t sum[16];
+                uint32_t sqsum[16];
+                _mm_storeu_si128((__m128i*)sum, v_sum[k][0]);
+                _mm_storeu_si128((__m128i*)(sum + 8), v_sum[k][1]);
+                for (int32_t i = 0; i < 4; ++i) {
+                    _mm_storeu_si128((__m128i*)(sqsum + i * 4), v_sqsum[k][i]);
+                }
+                for (int32_t i = 0; i < 16; ++i) {
+                    lane_sum[k * 16 + i] += sum[i];
+                    lane_sqsum[k * 16 + i] += sqsum[i];
+                }
+            }
+            zeros += _mm_cvtsi128_si64(v_zeros) + _mm_extract_epi64(v_zeros, 1);
+        }
+
+        for (; x < width; ++x) {
+            uint32_t keep = use_mask ? base_mask[x] != 0 : 1;
+            for (int32_t c = 0; c < channels; ++c) {
+                uint32_t v = base_in[x * channels + c] * keep;
+                lane_sum[c] += v;
+                lane_sqsum[c] += v * v;
+            }
+            zeros += 1 - keep;
+        }
+    }
+
+    for (int32_t c = 0; c < channels; ++c) {
+        partial->sum[c]   = 0;
+        partial->sqsum[c] = 0;
+    }
+    for (int32_t i = 0; i < 16 * channels; ++i) {
+        partial->sum[i % channels] += lane_sum[i];
+        partial->sqsum[i % channels] += lane_sqsum[i];
+    }
+    partial->count = (int64_t)(end - begin) * width - zeros;
+}
+
+// Sums of rows [begin, end) in double, of the values minus `shift`, which
+// keeps the sum of squares close to the variance instead of to the squared
+// mean. Each row is summed on its own first, so rounding errors grow with the
+// width and the height rather than with the number of pixels.
+template <int32_t channels, bool use_mask>
+static void meanstddev_rows_fp32(
+    int32_t begin,
+    int32_t end,
+    int32_t width,
+    int32_t srcStride,
+    const float* inData,
+    int32_t maskStride,
+    const uint8_t* mask,
+    const float* shift,
+    MeanStdDevPartial<double>* partial)
+{
+    double lane_sum[4 * channels]   = {0};
+    double lane_sqsum[4 * channels] = {0};
+    int64_t zeros                   = 0;
+
+    __m128d v_shift[channels][2];
+    for (int32_t k = 0; k < channels; ++k) {
+        v_shift[k][0] = _mm_setr_pd(shift[(k * 4 + 0) % channels], shift[(k * 4 + 1) % channels]);
+        v_shift[k][1] = _mm_setr_pd(shift[(k * 4 + 2) % channels], shift[(k * 4 + 3) % channels]);
+    }
+
+    __m128i v_zero = _mm_setzero_si128();
+    for (int32_t y = begin; y < end; ++y) {
+        const float* base_in     = inData + y * srcStride;
+        const uint8_t* base_mask = use_mask ? mask + y * maskStride : nullptr;
+
+        __m128d v_sum[channels][2], v_sqsum[channels][2];
+        __m128i v_zeros = v_zero;
+        for (int32_t k = 0; k < channels; ++k) {
+            v_sum[k][0] = v_sum[k][1] = _mm_setzero_pd();
+            v_sqsum[k][0] = v_sqsum[k][1] = _mm_setzero_pd();
+        }
+
+        int32_t x = 0;
+        for (; x <= width - 4; x += 4) {
+            __m128i v_mask = v_zero;
+            if (use_mask) {
+                v_mask  = _mm_cvtepu8_epi32(_mm_cvtsi32_si128(*(const int32_t*)(base_mask + x)));
+                v_mask  = _mm_cmpeq_epi32(v_mask, v_zero);
+                v_zeros = _mm_sub_epi32(v_zeros, v_mask);
+            }
+            for (int32_t k = 0; k < channels; ++k) {
+                __m128 v_src  = _mm_loadu_ps(base_in + x * channels + k * 4);
+                __m128d v_lo  = _mm_sub_pd(_mm_cvtps_pd(v_src), v_shift[k][0]);
+                __m128d v_hi  = _mm_sub_pd(_mm_cvtps_pd(_mm_movehl_ps(v_src, v_src)), v_shift[k][1]);
+                if (use_mask) {
+                    __m128i v_mask_k = meanstddev_expand_mask_fp32<channels>(v_mask, k);
+                    v_lo             = _mm_andnot_pd(_mm_castsi128_pd(_mm_unpacklo_epi32(v_mask_k, v_mask_k)), v_lo);
+                    v_hi             = _mm_andnot_pd(_mm_castsi128_pd(_mm_unpackhi_epi32(v_mask_k, v_mask_k)), v_hi);
+                }
+                v_sum[k][0]   = _mm_add_pd(v_sum[k][0], v_lo);
+                v_sum[k][1]   = _mm_add_pd(v_sum[k][1], v_hi);
+                v_sqsum[k][0] = _mm_add_pd(v_sqsum[k][0], _mm_mul_pd(v_lo, v_lo));
+                v_sqsum[k][1] = _mm_add_pd(v_sqsum[k][1], _mm_mul_pd(v_hi, v_hi));
+            }
+        }
+
+        double row_sum[4 * channels], row_sqsum[4 * channels];
+        for (int32_t k = 0; k < channels; ++k) {
+            _mm_storeu_pd(row_sum + k * 4 + 0, v_sum[k][0]);
+            _mm_storeu_pd(row_sum + k * 4 + 2, v_sum[k][1]);
+            _mm_storeu_pd(row_sqsum + k * 4 + 0, v_sqsum[k][0]);
+            _mm_storeu_pd(row_sqsum + k * 4 + 2, v_sqsum[k][1]);
+        }
+        for (; x < width; ++x) {
+            double keep = use_mask ? base_mask[x] != 0 : 1;
+            for (int32_t c = 0; c < channels; ++c) {
+                double v = ((double)base_in[x * channels + c] - shift[c]) * keep;
+                row_sum[c] += v;
+                row_sqsum[c] += v * v;
+            }
+            zeros += 1 - (int32_t)keep;
+        }
+        for (int32_t i = 0; i < 4 * channels; ++i) {
+            lane_sum[i] += row_sum[i];
+            lane_sqsum[i] += row_sqsum[i];
+        }
+        int32_t row_zeros[4];
+        _mm_storeu_si128((__m128i*)row_zeros, v_zeros);
+        zeros += row_zeros[0] + row_zeros[1] + row_zeros[2] + row_zeros[3];
+    }
+
+    for (int32_t c = 0; c < channels; ++c) {
+        partial->sum[c]   = 0;
+        partial->sqsum[c] = 0;
+    }
+    for (int32_t i = 0; i < 4 * channels; ++i) {
+        partial->sum[i % channels] += lane_sum[i];
+        partial->sqsum[i % channels] += lane_sqsum[i];
+    }
+    partial->count = (int64_t)(end - begin) * width - zeros;
+}
+
+template <int32_t channels>
+static void meanstddev_rows(
+    int32_t begin,
+    int32_t end,
+    int32_t width,
+    int32_t srcStride,
+    const uint8_t* inData,
+    int32_t maskStride,
+    const uint8_t* mask,
+    const float*, // integer sums are exact and need no shift
+    MeanStdDevPartial<uint64_t>* partial)
+{
+    if (mask) {
+        meanstddev_rows_u8<channels, true>(begin, end, width, srcStride, inData, maskStride, mask, partial);
+    } else {
+        meanstddev_rows_u8<channels, false>(begin, end, width, srcStride, inData, maskStride, mask, partial);
+    }
+}
+
+template <int32_t channels>
+static void meanstddev_rows(
+    int32_t begin,
+    int32_t end,
+    int32_t width,
+    int32_t srcStride,
+    const float* inData,
+    int32_t maskStride,
+    const uint8_t* mask,
+    const float* shift,
+    MeanStdDevPartial<double>* partial)
+{
+    if (mask) {
+        meanstddev_rows_fp32<channels, true>(begin, end, width, srcStride, inData, maskStride, mask, shift, partial);
+    } else {
+        meanstddev_rows_fp32<channels, false>(begin, end, width, srcStride, inData, maskStride, mask, shift, partial);
+    }
+}
+
 template <typename T, int32_t channels>
 ::ppl::common::RetCode MeanStdDev(
     int32_t height,
@@ -42,46 +337,57 @@ template <typename T, int32_t channels>
         return ppl::common::RC_INVALID_VALUE;
     } 
 
-    float sum[channels]   = {0};
-    float sqsum[channels] = {0};
-
-    int32_t count = 0;
-    if (nullptr == mask) {
-        count = height * width;
-        for (int32_t y = 0; y < height; ++y) {
-            const T* base_in = inData + y * srcStride;
-            for (int32_t x = 0; x < width; ++x) {
-                for (int32_t c = 0; c < channels; c++) {
-                    float v = (float)(base_in[channels * x + c]);
-                    sum[c] += v;
-                    sqsum[c] += v * v;
-                }
-            }
+    typedef typename std::conditional<std::is_same<T, float>::value, double, uint64_t>::type Acc;
+
+    // integer sums are exact and need no shift
+    float shift[channels] = {0};
+    if (std::is_same<T, float>::value) {
+        for (int32_t c = 0; c < channels; ++c) {
+            shift[c] = (float)inData[c];
         }
-    } else {
-        for (int32_t y = 0; y < height; ++y) {
-            const T* base_in         = inData + y * srcStride;
-            const uint8_t* base_mask = mask + y * maskStride;
-            for (int32_t x = 0; x < width; ++x) {
-                if (base_mask[x]) {
-                    for (int32_t c = 0; c < channels; c++) {
-                        float v = (float)(base_in[channels * x + c]);
-                        sum[c] += v;
-                        sqsum[c] += v * v;
-                    }
-                    count++;
-                }
-            }
+    }
+
+    std::mutex merge_mutex;
+    std::vector<MeanStdDevPartial<Acc>> partials;
+    parallel_for_rows(height, (int64_t)width * channels, [&](int32_t begin, int32_t end) {
+        MeanStdDevPartial<Acc> partial;
+        partial.begin = begin;
+        meanstddev_rows<channels>(begin, end, width, srcStride, inData, maskStride, mask, shift, &partial);
+        std::lock_guard<std::mutex> lock(merge_mutex);
+        partials.push_back(partial);
+    });
+    std::sort(partials.begin(), partials.end(), [](const MeanStdDevPartial<Acc>& a, const MeanStdDevPartial<Acc>& b) {
+        return a.begin < b.begin;
+    });
+
+    Acc sum[channels]   = {0};
+    Acc sqsum[channels] = {0};
+    int64_t count       = 0;
+    for (const MeanStdDevPartial<Acc>& partial : partials) {
+        for (int32_t c = 0; c < channels; ++c) {
+            sum[c] += partial.sum[c];
+            sqsum[c] += partial.sqsum[c];
+        }
+        count += partial.count;
+    }
+
+    // an empty mask selects nothing, report zeros rather than NaN
+    if (0 == count) {
+        for (int32_t i = 0; i < channels; i++) {
+            mean[i]   = 0.0f;
+            stddev[i] = 0.0f;
         }
+        return ppl::common::RC_SUCCESS;
     }
 
-    float scale = 1. / count;
+    double scale = 1.0 / count;
     for (int32_t i = 0; i < channels; i++) {
-        mean[i]        = (float)sum[i] * scale;
-        float variance = std::max(sqsum[i] * scale - (mean[i]) * (mean[i]), 0.0f);
-        stddev[i]      = std::sqrt(variance);
+        double shifted_mean = (double)sum[i] * scale;
+        double variance     = std::max((double)sqsum[i] * scale - shifted_mean * shifted_mean, 0.0);
+        mean[i]             = (float)(shift[i] + shifted_mean);
+        stddev[i]           = (float)std::sqrt(variance);
     }
-    return 0;
+    return ppl::common::RC_SUCCESS;
 }
 
 template ::ppl::common::RetCode MeanStdDev<uint8_t, 1>(
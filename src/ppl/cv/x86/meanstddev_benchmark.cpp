@@ -65,12 +65,12 @@ static void BM_MeanStdDev_ppl_x86(benchmark::State &state) {
     state.SetBytesProcessed(state.iterations() * state.range(0) * state.range(1) * sizeof(T) * channels);
 }
 
-BENCHMARK_TEMPLATE(BM_MeanStdDev_ppl_x86, float, c1)->Args({320, 240})->Args({640, 480});
-BENCHMARK_TEMPLATE(BM_MeanStdDev_ppl_x86, float, c3)->Args({320, 240})->Args({640, 480});
-BENCHMARK_TEMPLATE(BM_MeanStdDev_ppl_x86, float, c4)->Args({320, 240})->Args({640, 480}); 
-BENCHMARK_TEMPLATE(BM_MeanStdDev_ppl_x86, uint8_t, c1)->Args({320, 240})->Args({640, 480});
-BENCHMARK_TEMPLATE(BM_MeanStdDev_ppl_x86, uint8_t, c3)->Args({320, 240})->Args({640, 480});
-BENCHMARK_TEMPLATE(BM_MeanStdDev_ppl_x86, uint8_t, c4)->Args({320, 240})->Args({640, 480});
+BENCHMARK_TEMPLATE(BM_MeanStdDev_ppl_x86, float, c1)->Args({320, 240})->Args({640, 480})->Args({3840, 2160})->Args({7680, 4320});
+BENCHMARK_TEMPLATE(BM_MeanStdDev_ppl_x86, float, c3)->Args({320, 240})->Args({640, 480})->Args({3840, 2160})->Args({7680, 4320});
+BENCHMARK_TEMPLATE(BM_MeanStdDev_ppl_x86, float, c4)->Args({320, 240})->Args({640, 480})->Args({3840, 2160})->Args({7680, 4320}); 
+BENCHMARK_TEMPLATE(BM_MeanStdDev_ppl_x86, uint8_t, c1)->Args({320, 240})->Args({640, 480})->Args({3840, 2160})->Args({7680, 4320});
+BENCHMARK_TEMPLATE(BM_MeanStdDev_ppl_x86, uint8_t, c3)->Args({320, 240})->Args({640, 480})->Args({3840, 2160})->Args({7680, 4320});
+BENCHMARK_TEMPLATE(BM_MeanStdDev_ppl_x86, uint8_t, c4)->Args({320, 240})->Args({640, 480})->Args({3840, 2160})->Args({7680, 4320});
 
 #ifdef PPLCV_BENCHMARK_OPENCV
 template<typename T, int32_t channels>
@@ -82,11 +82,11 @@ static void BM_MeanStdDev_opencv_x86(benchmark::State &state) {
     state.SetItemsProcessed(state.iterations());
     state.SetBytesProcessed(state.iterations() * state.range(0) * state.range(1) * sizeof(T) * channels);
 }
-BENCHMARK_TEMPLATE(BM_MeanStdDev_opencv_x86, float, c1)->Args({320, 240})->Args({640, 480});
-BENCHMARK_TEMPLATE(BM_MeanStdDev_opencv_x86, float, c3)->Args({320, 240})->Args({640, 480});
-BENCHMARK_TEMPLATE(BM_MeanStdDev_opencv_x86, float, c4)->Args({320, 240})->Args({640, 480}); 
-BENCHMARK_TEMPLATE(BM_MeanStdDev_opencv_x86, uint8_t, c1)->Args({320, 240})->Args({640, 480});
-BENCHMARK_TEMPLATE(BM_MeanStdDev_opencv_x86, uint8_t, c3)->Args({320, 240})->Args({640, 480});
-BENCHMARK_TEMPLATE(BM_MeanStdDev_opencv_x86, uint8_t, c4)->Args({320, 240})->Args({640, 480});
+BENCHMARK_TEMPLATE(BM_MeanStdDev_opencv_x86, float, c1)->Args({320, 240})->Args({640, 480})->Args({3840, 2160})->Args({7680, 4320});
+BENCHMARK_TEMPLATE(BM_MeanStdDev_opencv_x86, float, c3)->Args({320, 240})->Args({640, 480})->Args({3840, 2160})->Args({7680, 4320});
+BENCHMARK_TEMPLATE(BM_MeanStdDev_opencv_x86, float, c4)->Args({320, 240})->Args({640, 480})->Args({3840, 2160})->Args({7680, 4320}); 
+BENCHMARK_TEMPLATE(BM_MeanStdDev_opencv_x86, uint8_t, c1)->Args({320, 240})->Args({640, 480})->Args({3840, 2160})->Args({7680, 4320});
+BENCHMARK_TEMPLATE(BM_MeanStdDev_opencv_x86, uint8_t, c3)->Args({320, 240})->Args({640, 480})->Args({3840, 2160})->Args({7680, 4320});
+BENCHMARK_TEMPLATE(BM_MeanStdDev_opencv_x86, uint8_t, c4)->Args({320, 240})->Args({640, 480})->Args({3840, 2160})->Args({7680, 4320});
 #endif //! PPLCV_BENCHMARK_OPENCV
 
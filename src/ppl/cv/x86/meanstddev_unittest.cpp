@@ -77,3 +77,78 @@ TEST(MeanStdDevTest_FP32, x86)
     MeanStdDevTest<float, 4, false>(480, 640, 0.1);
 }
 
+// Two-pass reference in double, independent of the accumulation order.
+template<typename T, int32_t nc>
+void MeanStdDevReference(int32_t height, int32_t width, const T* src, const uint8_t* mask,
+                         double* mean, double* stddev) {
+    double sum[nc] = {0};
+    double sqsum[nc] = {0};
+    int64_t count = 0;
+    for (int32_t i = 0; i < height; ++i) {
+        double row_sum[nc] = {0};
+        for (int32_t j = 0; j < width; ++j) {
+            if (mask && !mask[i * width + j]) continue;
+            for (int32_t c = 0; c < nc; ++c) {
+                row_sum[c] += src[(i * width + j) * nc + c];
+            }
+            count++;
+        }
+        for (int32_t c = 0; c < nc; ++c) {
+            sum[c] += row_sum[c];
+        }
+    }
+    for (int32_t c = 0; c < nc; ++c) {
+        mean[c] = sum[c] / count;
+    }
+    for (int32_t i = 0; i < height; ++i) {
+        double row_sqsum[nc] = {0};
+        for (int32_t j = 0; j < width; ++j) {
+            if (mask && !mask[i * width + j]) continue;
+            for (int32_t c = 0; c < nc; ++c) {
+                double d = src[(i * width + j) * nc + c] - mean[c];
+                row_sqsum[c] += d * d;
+            }
+        }
+        for (int32_t c = 0; c < nc; ++c) {
+            sqsum[c] += row_sqsum[c];
+        }
+    }
+    for (int32_t c = 0; c < nc; ++c) {
+        stddev[c] = std::sqrt(sqsum[c] / count);
+    }
+}
+
+// 8K frames hold more than 2^24 values per channel, which a float running sum
+// can no longer count exactly.
+template<typename T, int32_t nc, bool use_mask>
+void MeanStdDevAccuracyTest(int32_t height, int32_t width, float low, float high) {
+    std::unique_ptr<T[]> src(new T[width * height * nc]);
+    std::unique_ptr<uint8_t[]> mask(new uint8_t[width * height]);
+    ppl::cv::debug::randomFill<T>(src.get(), width * height * nc, low, high);
+    ppl::cv::debug::randomFill<uint8_t>(mask.get(), width * height, 0, 3);
+
+    float mean[nc], stddev[nc];
+    double mean_ref[nc], stddev_ref[nc];
+    auto rst = ppl::cv::x86::MeanStdDev<T, nc>(height, width, width * nc, src.get(), mean, stddev,
+                                               width, use_mask ? mask.get() : nullptr);
+    EXPECT_EQ(rst, ppl::common::RC_SUCCESS);
+    MeanStdDevReference<T, nc>(height, width, src.get(), use_mask ? mask.get() : nullptr,
+                               mean_ref, stddev_ref);
+    for (int32_t i = 0; i < nc; ++i) {
+        EXPECT_NEAR(mean[i], mean_ref[i], std::fabs(mean_ref[i]) * 1e-6 + 1e-6);
+        EXPECT_NEAR(stddev[i], stddev_ref[i], stddev_ref[i] * 1e-5 + 1e-6);
+    }
+}
+
+TEST(MeanStdDevTest_ACCURACY, x86)
+{
+    MeanStdDevAccuracyTest<uint8_t, 1, false>(4320, 7680, 0, 255);
+    MeanStdDevAccuracyTest<uint8_t, 3, false>(4320, 7680, 0, 255);
+    MeanStdDevAccuracyTest<uint8_t, 4, true>(4320, 7680, 0, 255);
+
+    MeanStdDevAccuracyTest<float, 1, false>(4320, 7680, 0, 255);
+    MeanStdDevAccuracyTest<float, 3, true>(4320, 7680, 0, 255);
+    // a large mean with a small spread
+    MeanStdDevAccuracyTest<float, 1, false>(4320, 7680, 1000, 1001);
+    MeanStdDevAccuracyTest<float, 4, true>(4320, 7680, 1000, 1001);
+}
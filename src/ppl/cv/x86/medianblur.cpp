@@ -17,7 +17,14 @@
 
 #include "ppl/cv/x86/medianblur.h"
 #include "ppl/cv/x86/copymakeborder.h"
+#include "ppl/cv/x86/parallel.hpp"
 #include "ppl/cv/types.h"
+#include "ppl/common/sys.h"
+
+#include <string.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <immintrin.h>
 
 namespace ppl {
 namespace cv {
@@ -54,6 +61,354 @@ T findKth(T* a, int32_t n, int32_t k)
         return findKth(a, pos + 1, k);
 }
 
+// Rows [begin, end) of the generic path: quickselect over the ksize x ksize
+// window of every pixel and channel.
+template <typename T, int32_t cn>
+static void median_blur_select(
+    const T* buffer,
+    int32_t bufferStride,
+    int32_t begin,
+    int32_t end,
+    int32_t width,
+    int32_t ksize,
+    int32_t outWidthStride,
+    T* outData)
+{
+    T* temp          = (T*)malloc(ksize * ksize * sizeof(T));
+    int32_t area     = ksize * ksize;
+    int32_t midIndex = (area >> 1) + 1;
+    for (int32_t i = begin; i < end; ++i) {
+        for (int32_t j = 0; j < width; ++j) {
+            for (int32_t c = 0; c < cn; ++c) {
+                for (int32_t ky = 0; ky < ksize; ++ky) {
+                    for (int32_t kx = 0; kx < ksize; ++kx) {
+                        temp[ky * ksize + kx] = buffer[(i + ky) * bufferStride + (j + kx) * cn + c];
+                    }
+                }
+                outData[i * outWidthStride + j * cn + c] = findKth(temp, area, midIndex);
+            }
+        }
+    }
+    free(temp);
+}
+
+// Compare-exchange primitives for the sorting networks below, on one byte or
+// on 16 bytes at once.
+struct MedianSortU8 {
+    typedef uint8_t type;
+    static inline void sort(uint8_t& a, uint8_t& b)
+    {
+        uint8_t t = std::min(a, b);
+        b         = std::max(a, b);
+        a         = t;
+    }
+};
+
+struct MedianSortU8x16 {
+    typedef __m128i type;
+    static inline void sort(__m128i& a, __m128i& b)
+    {
+        __m128i t = _mm_min_epu8(a, b);
+        b         = _mm_max_epu8(a, b);
+        a         = t;
+    }
+};
+
+// Median selection networks for 3x3 and 5x5 windows, p holds the window in
+// row-major order and is clobbered.
+template <typename Op>
+static inline typename Op::type median_network_3x3(typename Op::type* p)
+{
+    Op::sort(p[1], p[2]); Op::sort(p[4], p[5]); Op::sort(p[7], p[8]); Op::sort(p[0], p[1]);
+    Op::sort(p[3], p[4]); Op::sort(p[6], p[7]); Op::sort(p[1], p[2]); Op::sort(p[4], p[5]);
+    Op::sort(p[7], p[8]); Op::sort(p[0], p[3]); Op::sort(p[5], p[8]); Op::sort(p[4], p[7]);
+    Op::sort(p[3], p[6]); Op::sort(p[1], p[4]); Op::sort(p[2], p[5]); Op::sort(p[4], p[7]);
+    Op::sort(p[4], p[2]); Op::sort(p[6], p[4]); Op::sort(p[4], p[2]);
+    return p[4];
+}
+
+template <typename Op>
+static inline typename Op::type median_network_5x5(typename Op::type* p)
+{
+    Op::sort(p[1], p[2]);   Op::sort(p[0], p[1]);   Op::sort(p[1], p[2]);   Op::sort(p[4], p[5]);
+    Op::sort(p[3], p[4]);   Op::sort(p[4], p[5]);   Op::sort(p[0], p[3]);   Op::sort(p[2], p[5]);
+    Op::sort(p[2], p[3]);   Op::sort(p[1], p[4]);   Op::sort(p[1], p[2]);   Op::sort(p[3], p[4]);
+    Op::sort(p[7], p[8]);   Op::sort(p[6], p[7]);   Op::sort(p[7], p[8]);   Op::sort(p[10], p[11]);
+    Op::sort(p[9], p[10]);  Op::sort(p[10], p[11]); Op::sort(p[6], p[9]);   Op::sort(p[8], p[11]);
+    Op::sort(p[8], p[9]);   Op::sort(p[7], p[10]);  Op::sort(p[7], p[8]);   Op::sort(p[9], p[10]);
+    Op::sort(p[0], p[6]);   Op::sort(p[4], p[10]);  Op::sort(p[4], p[6]);   Op::sort(p[2], p[8]);
+    Op::sort(p[2], p[4]);   Op::sort(p[6], p[8]);   Op::sort(p[1], p[7]);   Op::sort(p[5], p[11]);
+    Op::sort(p[5], p[7]);   Op::sort(p[3], p[9]);   Op::sort(p[3], p[5]);   Op::sort(p[7], p[9]);
+    Op::sort(p[1], p[2]);   Op::sort(p[3], p[4]);   Op::sort(p[5], p[6]);   Op::sort(p[7], p[8]);
+    Op::sort(p[9], p[10]);  Op::sort(p[13], p[14]); Op::sort(p[12], p[13]); Op::sort(p[13], p[14]);
+    Op::sort(p[16], p[17]); Op::sort(p[15], p[16]); Op::sort(p[16], p[17]); Op::sort(p[12], p[15]);
+    Op::sort(p[14], p[17]); Op::sort(p[14], p[15]); Op::sort(p[13], p[16]); Op::sort(p[13], p[14]);
+    Op::sort(p[15], p[16]); Op::sort(p[19], p[20]); Op::sort(p[18], p[19]); Op::sort(p[19], p[20]);
+    Op::sort(p[21], p[22]); Op::sort(p[23], p[24]); Op::sort(p[21], p[23]); Op::sort(p[22], p[24]);
+    Op::sort(p[22], p[23]); Op::sort(p[18], p[21]); Op::sort(p[20], p[23]); Op::sort(p[20], p[21]);
+    Op::sort(p[19], p[22]); Op::sort(p[22], p[24]); Op::sort(p[19], p[20]); Op::sort(p[21], p[22]);
+    Op::sort(p[23], p[24]); Op::sort(p[12], p[18]); Op::sort(p[16], p[22]); Op::sort(p[16], p[18]);
+    Op::sort(p[14], p[20]); Op::sort(p[20], p[24]); Op::sort(p[14], p[16]); Op::sort(p[18], p[20]);
+    Op::sort(p[22], p[24]); Op::sort(p[13], p[19]); Op::sort(p[17], p[23]); Op::sort(p[17], p[19]);
+    Op::sort(p[15], p[21]); Op::sort(p[15], p[17]); Op::sort(p[19], p[21]); Op::sort(p[13], p[14]);
+    Op::sort(p[15], p[16]); Op::sort(p[17], p[18]); Op::sort(p[19], p[20]); Op::sort(p[21], p[22]);
+    Op::sort(p[23], p[24]); Op::sort(p[0], p[12]);  Op::sort(p[8], p[20]);  Op::sort(p[8], p[12]);
+    Op::sort(p[4], p[16]);  Op::sort(p[16], p[24]); Op::sort(p[12], p[16]); Op::sort(p[2], p[14]);
+    Op::sort(p[10], p[22]); Op::sort(p[10], p[14]); Op::sort(p[6], p[18]);  Op::sort(p[6], p[10]);
+    Op::sort(p[10], p[12]); Op::sort(p[1], p[13]);  Op::sort(p[9], p[21]);  Op::sort(p[9], p[13]);
+    Op::sort(p[5], p[17]);  Op::sort(p[13], p[17]); Op::sort(p[3], p[15]);  Op::sort(p[11], p[23]);
+    Op::sort(p[11], p[15]); Op::sort(p[7], p[19]);  Op::sort(p[7], p[11]);  Op::sort(p[11], p[13]);
+    Op::sort(p[11], p[12]);
+    return p[12];
+}
+
+template <int32_t ksize, typename Op>
+struct MedianNetwork;
+
+template <typename Op>
+struct MedianNetwork<3, Op> {
+    static inline typename Op::type run(typename Op::type* p)
+    {
+        return median_network_3x3<Op>(p);
+    }
+};
+
+template <typename Op>
+struct MedianNetwork<5, Op> {
+    static inline typename Op::type run(typename Op::type* p)
+    {
+        return median_network_5x5<Op>(p);
+    }
+};
+
+// Rows [begin, end) of the 3x3 and 5x5 paths. Interleaved channels are
+// filtered together: the horizontal neighbours of a byte sit cn bytes away.
+template <int32_t ksize, int32_t cn>
+static void median_blur_network_u8(
+    const uint8_t* buffer,
+    int32_t bufferStride,
+    int32_t begin,
+    int32_t end,
+    int32_t width,
+    int32_t outWidthStride,
+    uint8_t* outData)
+{
+    const int32_t length = width * cn;
+    for (int32_t i = begin; i < end; ++i) {
+        const uint8_t* src = buffer + i * bufferStride;
+        uint8_t* dst       = outData + i * outWidthStride;
+        int32_t j          = 0;
+        if (length >= 16) {
+            for (;; j += 16) {
+                // the last block overlaps the previous one instead of running a scalar tail
+                j = std::min(j, length - 16);
+                __m128i p[ksize * ksize];
+                for (int32_t ky = 0; ky < ksize; ++ky) {
+                    for (int32_t kx = 0; kx < ksize; ++kx) {
+                        p[ky * ksize + kx] = _mm_loadu_si128((const __m128i*)(src + ky * bufferStride + j + kx * cn));
+                    }
+                }
+                _mm_storeu_si128((__m128i*)(dst + j), MedianNetwork<ksize, MedianSortU8x16>::run(p));
+                if (j == length - 16) {
+                    break;
+                }
+            }
+            j = length;
+        }
+        for (; j < length; ++j) {
+            uint8_t p[ksize * ksize];
+            for (int32_t ky = 0; ky < ksize; ++ky) {
+                for (int32_t kx = 0; kx < ksize; ++kx) {
+                    p[ky * ksize + kx] = src[ky * bufferStride + j + kx * cn];
+                }
+            }
+            dst[j] = MedianNetwork<ksize, MedianSortU8>::run(p);
+        }
+    }
+}
+
+// dst += add - sub on a 16-bin histogram.
+static inline void median_hist_update(uint16_t* dst, const uint16_t* add, const uint16_t* sub)
+{
+    __m128i d0 = _mm_loadu_si128((const __m128i*)dst);
+    __m128i d1 = _mm_loadu_si128((const __m128i*)(dst + 8));
+    d0         = _mm_add_epi16(d0, _mm_sub_epi16(_mm_loadu_si128((const __m128i*)add), _mm_loadu_si128((const __m128i*)sub)));
+    d1         = _mm_add_epi16(d1, _mm_sub_epi16(_mm_loadu_si128((const __m128i*)(add + 8)), _mm_loadu_si128((const __m128i*)(sub + 8))));
+    _mm_storeu_si128((__m128i*)dst, d0);
+    _mm_storeu_si128((__m128i*)(dst + 8), d1);
+}
+
+static inline void median_hist_add(uint16_t* dst, const uint16_t* add)
+{
+    __m128i d0 = _mm_add_epi16(_mm_loadu_si128((const __m128i*)dst), _mm_loadu_si128((const __m128i*)add));
+    __m128i d1 = _mm_add_epi16(_mm_loadu_si128((const __m128i*)(dst + 8)), _mm_loadu_si128((const __m128i*)(add + 8)));
+    _mm_storeu_si128((__m128i*)dst, d0);
+    _mm_storeu_si128((__m128i*)(dst + 8), d1);
+}
+
+// Finds the first bin of a 16-bin histogram at which the running count, which
+// starts from `sum`, exceeds `half`, and advances `sum` to the count before
+// that bin. Branch free: prefix sums, an unsigned compare and a byte sum.
+static inline int32_t median_hist_search(const uint16_t* hist, int32_t& sum, int32_t half)
+{
+    __m128i lo = _mm_loadu_si128((const __m128i*)hist);
+    __m128i hi = _mm_loadu_si128((const __m128i*)(hist + 8));
+    lo         = _mm_add_epi16(lo, _mm_slli_si128(lo, 2));
+    hi         = _mm_add_epi16(hi, _mm_slli_si128(hi, 2));
+    lo         = _mm_add_epi16(lo, _mm_slli_si128(lo, 4));
+    hi         = _mm_add_epi16(hi, _mm_slli_si128(hi, 4));
+    lo         = _mm_add_epi16(lo, _mm_slli_si128(lo, 8));
+    hi         = _mm_add_epi16(hi, _mm_slli_si128(hi, 8));
+    lo         = _mm_add_epi16(lo, _mm_set1_epi16((int16_t)sum));
+    hi         = _mm_add_epi16(hi, _mm_shuffle_epi32(_mm_shufflehi_epi16(lo, 0xff), 0xff));
+
+    __m128i v_half = _mm_set1_epi16((int16_t)half);
+    __m128i le_lo  = _mm_cmpeq_epi16(_mm_min_epu16(lo, v_half), lo);
+    __m128i le_hi  = _mm_cmpeq_epi16(_mm_min_epu16(hi, v_half), hi);
+    // running counts never decrease, so the bins at or below half form a prefix
+    __m128i le     = _mm_and_si128(_mm_packs_epi16(le_lo, le_hi), _mm_set1_epi8(1));
+    __m128i count  = _mm_sad_epu8(le, _mm_setzero_si128());
+    int32_t bin    = _mm_cvtsi128_si32(count) + _mm_extract_epi16(count, 4);
+
+    uint16_t prefix[16];
+    _mm_storeu_si128((__m128i*)prefix, lo);
+    _mm_storeu_si128((__m128i*)(prefix + 8), hi);
+    sum = bin > 0 ? prefix[bin - 1] : sum;
+    return bin;
+}
+
+// Number of output columns handled at once by the histogram path, chosen so
+// that the column histograms of a stripe stay in L2.
+#define MEDIAN_HIST_STRIPE_ELEMENTS 768
+
+// Rows [begin, end) of the constant time path (Perreault & Hebert). Every
+// buffer column keeps a 16 bin coarse and a 16x16 bin fine histogram of the
+// ksize rows around the current one. Sliding the window right adds one column
+// histogram and removes another; fine bins are only brought up to date when
+// the median search enters their coarse bin. The cost per pixel does not
+// depend on ksize.
+template <int32_t cn>
+static void median_blur_histogram_u8(
+    const uint8_t* buffer,
+    int32_t bufferStride,
+    int32_t begin,
+    int32_t end,
+    int32_t width,
+    int32_t ksize,
+    int32_t outWidthStride,
+    uint8_t* outData)
+{
+    const int32_t half   = ksize * ksize / 2;
+    const int32_t stripe = std::max(MEDIAN_HIST_STRIPE_ELEMENTS / cn - (ksize - 1), 16);
+
+    int32_t max_columns = (std::min(stripe, width) + ksize - 1) * cn;
+    uint16_t* coarse    = (uint16_t*)ppl::common::AlignedAlloc(max_columns * (16 + 256) * sizeof(uint16_t), 64);
+    uint16_t* fine      = coarse + max_columns * 16;
+
+    uint16_t kernel_coarse[16];
+    uint16_t kernel_fine[16 * 16];
+    int32_t last_update[16];
+
+    for (int32_t x0 = 0; x0 < width; x0 += stripe) {
+        int32_t stripe_width = std::min(stripe, width - x0);
+        int32_t columns      = (stripe_width + ksize - 1) * cn;
+        const uint8_t* src   = buffer + x0 * cn;
+        memset(coarse, 0, columns * 16 * sizeof(uint16_t));
+        memset(fine, 0, columns * 256 * sizeof(uint16_t));
+
+        for (int32_t ky = 0; ky < ksize - 1; ++ky) {
+            const uint8_t* row = src + (begin + ky) * bufferStride;
+            for (int32_t e = 0; e < columns; ++e) {
+                coarse[e * 16 + (row[e] >> 4)]++;
+                fine[e * 256 + row[e]]++;
+            }
+        }
+
+        for (int32_t i = begin; i < end; ++i) {
+            // slide the column histograms down: drop row i - 1, take in row i + ksize - 1
+            const uint8_t* row = src + (i + ksize - 1) * bufferStride;
+            if (i > begin) {
+                const uint8_t* top = src + (i - 1) * bufferStride;
+                for (int32_t e = 0; e < columns; ++e) {
+                    coarse[e * 16 + (top[e] >> 4)]--;
+                    fine[e * 256 + top[e]]--;
+                    coarse[e * 16 + (row[e] >> 4)]++;
+                    fine[e * 256 + row[e]]++;
+                }
+            } else {
+                for (int32_t e = 0; e < columns; ++e) {
+                    coarse[e * 16 + (row[e] >> 4)]++;
+                    fine[e * 256 + row[e]]++;
+                }
+            }
+
+            uint8_t* dst = outData + i * outWidthStride + x0 * cn;
+            for (int32_t c = 0; c < cn; ++c) {
+                memset(kernel_coarse, 0, sizeof(kernel_coarse));
+                for (int32_t k = 0; k < ksize; ++k) {
+                    median_hist_add(kernel_coarse, coarse + (k * cn + c) * 16);
+                }
+                for (int32_t b = 0; b < 16; ++b) {
+                    last_update[b] = -ksize;
+                }
+
+                for (int32_t x = 0; x < stripe_width; ++x) {
+                    if (x > 0) {
+                        median_hist_update(kernel_coarse, coarse + ((x + ksize - 1) * cn + c) * 16, coarse + ((x - 1) * cn + c) * 16);
+                    }
+
+                    int32_t sum = 0;
+                    int32_t b   = median_hist_search(kernel_coarse, sum, half);
+
+                    uint16_t* bin = kernel_fine + b * 16;
+                    if (x - last_update[b] >= ksize) {
+                        memset(bin, 0, 16 * sizeof(uint16_t));
+                        for (int32_t k = 0; k < ksize; ++k) {
+                            median_hist_add(bin, fine + ((x + k) * cn + c) * 256 + b * 16);
+                        }
+                    } else {
+                        for (int32_t j = last_update[b] + 1; j <= x; ++j) {
+                            median_hist_update(bin, fine + ((j + ksize - 1) * cn + c) * 256 + b * 16, fine + ((j - 1) * cn + c) * 256 + b * 16);
+                        }
+                    }
+                    last_update[b] = x;
+
+                    int32_t f = median_hist_search(bin, sum, half);
+                    dst[x * cn + c] = (uint8_t)(b * 16 + f);
+                }
+            }
+        }
+    }
+    ppl::common::AlignedFree(coarse);
+}
+
+// Float images keep the generic path, uint8_t ones use the sorting networks
+// or the histogram path depending on ksize.
+template <typename T, int32_t cn>
+struct MedianBlurRows {
+    static void run(const T* buffer, int32_t bufferStride, int32_t begin, int32_t end, int32_t width, int32_t ksize, int32_t outWidthStride, T* outData)
+    {
+        median_blur_select<T, cn>(buffer, bufferStride, begin, end, width, ksize, outWidthStride, outData);
+    }
+};
+
+template <int32_t cn>
+struct MedianBlurRows<uint8_t, cn> {
+    static void run(const uint8_t* buffer, int32_t bufferStride, int32_t begin, int32_t end, int32_t width, int32_t ksize, int32_t outWidthStride, uint8_t* outData)
+    {
+        if (ksize == 3) {
+            median_blur_network_u8<3, cn>(buffer, bufferStride, begin, end, width, outWidthStride, outData);
+        } else if (ksize == 5) {
+            median_blur_network_u8<5, cn>(buffer, bufferStride, begin, end, width, outWidthStride, outData);
+        } else if (ksize <= 255) {
+            median_blur_histogram_u8<cn>(buffer, bufferStride, begin, end, width, ksize, outWidthStride, outData);
+        } else {
+            // bin counts of the histogram path are 16 bits wide
+            median_blur_select<uint8_t, cn>(buffer, bufferStride, begin, end, width, ksize, outWidthStride, outData);
+        }
+    }
+};
+
 template <typename T, int32_t cn>
 ::ppl::common::RetCode MedianBlur(
     int32_t height,
@@ -71,6 +426,9 @@ template <typename T, int32_t cn>
     if (height <= 0 || width <= 0 || inWidthStride < width) {
         return ppl::common::RC_INVALID_VALUE;
     }
+    if (ksize <= 0 || (ksize & 1) == 0) {
+        return ppl::common::RC_INVALID_VALUE;
+    }
     if (border_type != ppl::cv::BORDER_REFLECT_101 && border_type != ppl::cv::BORDER_REFLECT &&
         border_type != ppl::cv::BORDER_CONSTANT && border_type != ppl::cv::BORDER_REPLICATE) {
         return ppl::common::RC_INVALID_VALUE;
@@ -78,27 +436,15 @@ template <typename T, int32_t cn>
     int32_t radius_x = ksize / 2;
     int32_t radius_y = ksize / 2;
 
-    T* buffer = (T*)malloc((height + 2 * radius_y) * (width + 2 * radius_x) * sizeof(T) * cn);
-    T* temp   = (T*)malloc(ksize * ksize * sizeof(T));
+    int32_t bufferStride = (width + 2 * radius_x) * cn;
+    T* buffer            = (T*)malloc((height + 2 * radius_y) * bufferStride * sizeof(T));
 
-    CopyMakeBorder<T, cn>(height, width, inWidthStride, inData, height + 2 * radius_y, width + 2 * radius_x, (width + 2 * radius_x) * cn, buffer, border_type);
+    CopyMakeBorder<T, cn>(height, width, inWidthStride, inData, height + 2 * radius_y, width + 2 * radius_x, bufferStride, buffer, border_type);
 
-    int32_t area     = ksize * ksize;
-    int32_t midIndex = (area >> 1) + 1;
-    for (int32_t i = 0; i < height; ++i) {
-        for (int32_t j = 0; j < width; ++j) {
-            for (int32_t c = 0; c < cn; ++c) {
-                for (int32_t ky = 0; ky < ksize; ++ky) {
-                    for (int32_t kx = 0; kx < ksize; ++kx) {
-                        temp[ky * ksize + kx] = buffer[(i + ky) * (width + 2 * radius_x) * cn + (j + kx) * cn + c];
-                    }
-                }
-                outData[i * outWidthStride + j * cn + c] = findKth(temp, area, midIndex);
-            }
-        }
-    }
+    parallel_for_rows(height, (int64_t)width * cn * ksize, [&](int32_t begin, int32_t end) {
+        MedianBlurRows<T, cn>::run(buffer, bufferStride, begin, end, width, ksize, outWidthStride, outData);
+    });
     free(buffer);
-    free(temp);
     return ppl::common::RC_SUCCESS;
 }
 
@@ -61,4 +61,20 @@ TEST(MEDIAN_BLUR_UINT8, x86)
     MedianBlurTest<uint8_t, 5, 3>(720, 1080, 1e-3);
     MedianBlurTest<uint8_t, 3, 4>(720, 1080, 1e-3);
     MedianBlurTest<uint8_t, 5, 4>(720, 1080, 1e-3);
+    MedianBlurTest<uint8_t, 3, 1>(31, 17, 1e-3);
+    MedianBlurTest<uint8_t, 5, 3>(31, 5, 1e-3);
+}
+
+TEST(MEDIAN_BLUR_UINT8_LARGE_KERNEL, x86)
+{
+    MedianBlurTest<uint8_t, 7, 1>(720, 1080, 1e-3);
+    MedianBlurTest<uint8_t, 7, 3>(720, 1080, 1e-3);
+    MedianBlurTest<uint8_t, 7, 4>(720, 1080, 1e-3);
+    MedianBlurTest<uint8_t, 9, 1>(241, 321, 1e-3);
+    MedianBlurTest<uint8_t, 15, 1>(720, 1080, 1e-3);
+    MedianBlurTest<uint8_t, 15, 3>(241, 321, 1e-3);
+    MedianBlurTest<uint8_t, 15, 4>(241, 321, 1e-3);
+    MedianBlurTest<uint8_t, 31, 1>(720, 1080, 1e-3);
+    MedianBlurTest<uint8_t, 31, 3>(241, 321, 1e-3);
+    MedianBlurTest<uint8_t, 31, 4>(67, 23, 1e-3);
 }
@@ -17,9 +17,11 @@
 
 #include "ppl/cv/x86/merge.h"
 #include "ppl/cv/x86/fma/internal_fma.hpp"
+#include "ppl/cv/x86/avx512/internal_avx512.hpp"
 #include "ppl/cv/types.h"
 #include "ppl/common/sys.h"
 #include "ppl/common/x86/sysinfo.h"
+#include "ppl/cv/x86/isa.hpp"
 
 namespace ppl {
 namespace cv {
@@ -67,7 +69,9 @@ void Merge<float, 4>(
     int32_t outWidthStride,
     float* outData)
 {
-    if (ppl::common::CpuSupports(ppl::common::ISA_X86_FMA)) {
+    if (isa_supported(ppl::common::ISA_X86_AVX512)) {
+        avx512::mergeSOA2AOS<float, 4>(height, width, inWidthStride, inData, outWidthStride, outData);
+    } else if (isa_supported(ppl::common::ISA_X86_FMA)) {
         fma::mergeSOA2AOS<float, 4>(height, width, inWidthStride, inData, outWidthStride, outData);
     } else {
         mergeSOA2AOS<float>(4, height, width, inWidthStride, inData, outWidthStride, outData);
@@ -83,7 +87,9 @@ void Merge<float, 3>(
     int32_t outWidthStride,
     float* outData)
 {
-    if (ppl::common::CpuSupports(ppl::common::ISA_X86_FMA)) {
+    if (isa_supported(ppl::common::ISA_X86_AVX512)) {
+        avx512::mergeSOA2AOS<float, 3>(height, width, inWidthStride, inData, outWidthStride, outData);
+    } else if (isa_supported(ppl::common::ISA_X86_FMA)) {
         fma::mergeSOA2AOS<float, 3>(height, width, inWidthStride, inData, outWidthStride, outData);
     } else {
         mergeSOA2AOS<float>(3, height, width, inWidthStride, inData, outWidthStride, outData);
@@ -99,7 +105,9 @@ void Merge<uint8_t, 4>(
     int32_t outWidthStride,
     uint8_t* outData)
 {
-    if (ppl::common::CpuSupports(ppl::common::ISA_X86_FMA)) {
+    if (isa_supported(ppl::common::ISA_X86_AVX512)) {
+        avx512::mergeSOA2AOS<uint8_t, 4>(height, width, inWidthStride, inData, outWidthStride, outData);
+    } else if (isa_supported(ppl::common::ISA_X86_FMA)) {
         fma::mergeSOA2AOS<uint8_t, 4>(height, width, inWidthStride, inData, outWidthStride, outData);
     } else {
         mergeSOA2AOS<uint8_t>(4, height, width, inWidthStride, inData, outWidthStride, outData);
@@ -115,7 +123,9 @@ void Merge<uint8_t, 3>(
     int32_t outWidthStride,
     uint8_t* outData)
 {
-    if (ppl::common::CpuSupports(ppl::common::ISA_X86_FMA)) {
+    if (isa_supported(ppl::common::ISA_X86_AVX512)) {
+        avx512::mergeSOA2AOS<uint8_t, 3>(height, width, inWidthStride, inData, outWidthStride, outData);
+    } else if (isa_supported(ppl::common::ISA_X86_FMA)) {
         fma::mergeSOA2AOS<uint8_t, 3>(height, width, inWidthStride, inData, outWidthStride, outData);
     } else {
         mergeSOA2AOS<uint8_t>(3, height, width, inWidthStride, inData, outWidthStride, outData);
@@ -0,0 +1,217 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "ppl/cv/x86/parallel.h"
+#include "ppl/cv/x86/parallel.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace ppl {
+namespace cv {
+namespace x86 {
+
+static std::atomic<int32_t> g_num_threads(0);
+static thread_local bool t_in_parallel_region = false;
+
+static int32_t default_num_threads()
+{
+#ifdef _OPENMP
+    return omp_get_max_threads();
+#else
+    int32_t num_threads = std::thread::hardware_concurrency();
+    return num_threads > 0 ? num_threads : 1;
+#endif
+}
+
+::ppl::common::RetCode SetNumThreads(int32_t num_threads)
+{
+    if (num_threads < 0) {
+        return ppl::common::RC_INVALID_VALUE;
+    }
+    g_num_threads.store(num_threads);
+    return ppl::common::RC_SUCCESS;
+}
+
+int32_t GetNumThreads()
+{
+    int32_t num_threads = g_num_threads.load();
+    return num_threads > 0 ? num_threads : default_num_threads();
+}
+
+#ifndef _OPENMP
+// Workers are created on first use and kept for the life of the process, so a
+// kernel call only pays for a wake-up, never for thread creation. One job runs
+// at a time; the caller executes tasks alongside the workers.
+class ThreadPool {
+public:
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        start_cond_.notify_all();
+        for (size_t i = 0; i < workers_.size(); ++i) {
+            workers_[i].join();
+        }
+    }
+
+    static ThreadPool *GetInstance()
+    {
+        static ThreadPool pool;
+        return &pool;
+    }
+
+    // Returns false without running anything when another job is in flight.
+    bool Run(int32_t num_tasks, int32_t num_threads, const std::function<void(int32_t)> &task)
+    {
+        std::unique_lock<std::mutex> run_lock(run_mutex_, std::try_to_lock);
+        if (!run_lock.owns_lock()) {
+            return false;
+        }
+
+        int32_t num_workers = std::min(num_threads, num_tasks) - 1;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            while ((int32_t)workers_.size() < num_workers) {
+                workers_.emplace_back(&ThreadPool::WorkerLoop, this, (int32_t)workers_.size());
+            }
+            task_             = &task;
+            num_tasks_        = num_tasks;
+            num_participants_ = num_workers;
+            num_running_      = num_workers;
+            next_task_.store(0);
+            ++generation_;
+        }
+        start_cond_.notify_all();
+
+        t_in_parallel_region = true;
+        RunTasks();
+        t_in_parallel_region = false;
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_cond_.wait(lock, [this] { return num_running_ == 0; });
+        task_ = nullptr;
+        return true;
+    }
+
+private:
+    ThreadPool() {}
+
+    void RunTasks()
+    {
+        for (int32_t i = next_task_.fetch_add(1); i < num_tasks_; i = next_task_.fetch_add(1)) {
+            (*task_)(i);
+        }
+    }
+
+    void WorkerLoop(int32_t index)
+    {
+        t_in_parallel_region = true;
+        uint64_t seen        = 0;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                start_cond_.wait(lock, [&] {
+                    return stop_ || (generation_ != seen && index < num_participants_);
+                });
+                if (stop_) {
+                    return;
+                }
+                seen = generation_;
+            }
+            RunTasks();
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (--num_running_ == 0) {
+                done_cond_.notify_one();
+            }
+        }
+    }
+
+    std::vector<std::thread> workers_;
+    std::mutex run_mutex_;
+    std::mutex mutex_;
+    std::condition_variable start_cond_;
+    std::condition_variable done_cond_;
+    const std::function<void(int32_t)> *task_ = nullptr;
+    int32_t num_tasks_                        = 0;
+    int32_t num_participants_                 = 0;
+    int32_t num_running_                      = 0;
+    uint64_t generation_                      = 0;
+    bool stop_                                = false;
+    std::atomic<int32_t> next_task_{0};
+};
+#endif
+
+void parallel_run(int32_t num_tasks, const std::function<void(int32_t)> &task)
+{
+    int32_t num_threads = GetNumThreads();
+    if (num_tasks > 1 && num_threads > 1 && !t_in_parallel_region) {
+#ifdef _OPENMP
+        if (!omp_in_parallel()) {
+            #pragma omp parallel for num_threads(std::min(num_threads, num_tasks)) schedule(dynamic, 1)
+            for (int32_t i = 0; i < num_tasks; ++i) {
+                bool in_region       = t_in_parallel_region;
+                t_in_parallel_region = true;
+                task(i);
+                t_in_parallel_region = in_region;
+            }
+            return;
+        }
+#else
+        if (ThreadPool::GetInstance()->Run(num_tasks, num_threads, task)) {
+            return;
+        }
+#endif
+    }
+    for (int32_t i = 0; i < num_tasks; ++i) {
+        task(i);
+    }
+}
+
+int32_t parallel_num_bands(int32_t height, int64_t elements_per_row, int32_t row_align,
+                           int32_t max_bands)
+{
+    int32_t num_threads = GetNumThreads();
+    if (max_bands > 0) {
+        num_threads = std::min(num_threads, max_bands);
+    }
+    if (num_threads <= 1 || t_in_parallel_region) {
+        return 1;
+    }
+#ifdef _OPENMP
+    if (omp_in_parallel()) {
+        return 1;
+    }
+#endif
+    int64_t by_size  = (int64_t)height * elements_per_row / PARALLEL_MIN_ELEMENTS_PER_BAND;
+    int64_t by_rows  = (height + row_align - 1) / row_align;
+    int64_t by_bands = std::min<int64_t>(std::min<int64_t>(by_size, by_rows), num_threads);
+    return by_bands > 1 ? (int32_t)by_bands : 1;
+}
+
+}
+}
+} // namespace ppl::cv::x86
@@ -0,0 +1,98 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#ifndef PPL_CV_X86_PARALLEL_HPP_
+#define PPL_CV_X86_PARALLEL_HPP_
+
+#include "ppl/common/retcode.h"
+
+#include <stdint.h>
+#include <algorithm>
+#include <atomic>
+#include <functional>
+
+namespace ppl {
+namespace cv {
+namespace x86 {
+
+// Images are only split when every band gets at least this many elements;
+// below that, waking the workers costs more than the band saves.
+#define PARALLEL_MIN_ELEMENTS_PER_BAND (32 * 1024)
+
+// Runs task(0), ..., task(num_tasks - 1) on the x86 worker pool and returns
+// when all of them have finished. The calling thread takes part in the work.
+// Calls made from inside a task, or while the pool is busy with a call from
+// another thread, run serially on the calling thread.
+void parallel_run(int32_t num_tasks, const std::function<void(int32_t)> &task);
+
+// Number of row bands parallel_for_rows() splits `height` rows into, at most
+// `max_bands` when it is positive.
+int32_t parallel_num_bands(int32_t height, int64_t elements_per_row, int32_t row_align,
+                           int32_t max_bands = 0);
+
+// Splits [0, height) into contiguous bands and calls body(begin, end) for each
+// of them concurrently. Band boundaries are multiples of `row_align`, which
+// lets subsampled planes (e.g. 4:2:0 chroma) split on the same rows. Bodies
+// only own their output rows; stencil kernels read the `radius` rows around
+// a band from the shared input, so no band needs data written by another one.
+// A positive `max_bands` caps the number of bands below the thread count.
+template <typename Body>
+void parallel_for_rows(
+    int32_t height,
+    int64_t elements_per_row,
+    const Body &body,
+    int32_t row_align = 1,
+    int32_t max_bands = 0)
+{
+    int32_t num_bands = parallel_num_bands(height, elements_per_row, row_align, max_bands);
+    if (num_bands <= 1) {
+        body(0, height);
+        return;
+    }
+
+    int64_t units = (height + row_align - 1) / row_align;
+    parallel_run(num_bands, [&](int32_t band) {
+        int32_t begin = (int32_t)(units * band / num_bands * row_align);
+        int32_t end   = (int32_t)std::min<int64_t>(units * (band + 1) / num_bands * row_align, height);
+        body(begin, end);
+    });
+}
+
+// parallel_for_rows() for bodies returning a RetCode. Returns RC_SUCCESS when
+// every band succeeded, otherwise the status of one of the failing bands.
+template <typename Body>
+::ppl::common::RetCode parallel_for_rows_status(
+    int32_t height,
+    int64_t elements_per_row,
+    const Body &body,
+    int32_t row_align = 1)
+{
+    std::atomic<::ppl::common::RetCode> status(ppl::common::RC_SUCCESS);
+    parallel_for_rows(height, elements_per_row, [&](int32_t begin, int32_t end) {
+        ::ppl::common::RetCode band_status = body(begin, end);
+        if (band_status != ppl::common::RC_SUCCESS) {
+            status.store(band_status);
+        }
+    }, row_align);
+    return status.load();
+}
+
+}
+}
+} // namespace ppl::cv::x86
+
+#endif //! PPL_CV_X86_PARALLEL_HPP_
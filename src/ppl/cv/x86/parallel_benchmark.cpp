@@ -0,0 +1,98 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include <benchmark/benchmark.h>
+#include "ppl/cv/x86/parallel.h"
+#include "ppl/cv/x86/gaussianblur.h"
+#include "ppl/cv/x86/resize.h"
+#include "ppl/cv/x86/warpaffine.h"
+#include "ppl/cv/x86/cvtcolor.h"
+#include "ppl/cv/debug.h"
+#include <memory>
+namespace {
+
+// Scaling of the banded kernels on a 4K frame; range(0) is the thread count.
+template<typename T, int32_t nc>
+void BM_GaussianBlur_threads_ppl_x86(benchmark::State &state) {
+    int32_t width = 3840;
+    int32_t height = 2160;
+    std::unique_ptr<T[]> src(new T[width * height * nc]);
+    std::unique_ptr<T[]> dst(new T[width * height * nc]);
+    ppl::cv::debug::randomFill<T>(src.get(), width * height * nc, 0, 255);
+    ppl::cv::x86::SetNumThreads(state.range(0));
+    for (auto _ : state) {
+        ppl::cv::x86::GaussianBlur<T, nc>(height, width, width * nc, src.get(), 5, 0.0f, width * nc, dst.get(), ppl::cv::BORDER_DEFAULT);
+    }
+    ppl::cv::x86::SetNumThreads(0);
+    state.SetItemsProcessed(state.iterations() * 1);
+}
+
+template<typename T, int32_t nc>
+void BM_ResizeLinear_threads_ppl_x86(benchmark::State &state) {
+    int32_t width = 3840;
+    int32_t height = 2160;
+    int32_t out_width = 1280;
+    int32_t out_height = 720;
+    std::unique_ptr<T[]> src(new T[width * height * nc]);
+    std::unique_ptr<T[]> dst(new T[out_width * out_height * nc]);
+    ppl::cv::debug::randomFill<T>(src.get(), width * height * nc, 0, 255);
+    ppl::cv::x86::SetNumThreads(state.range(0));
+    for (auto _ : state) {
+        ppl::cv::x86::ResizeLinear<T, nc>(height, width, width * nc, src.get(), out_height, out_width, out_width * nc, dst.get());
+    }
+    ppl::cv::x86::SetNumThreads(0);
+    state.SetItemsProcessed(state.iterations() * 1);
+}
+
+template<typename T, int32_t nc>
+void BM_WarpAffineLinear_threads_ppl_x86(benchmark::State &state) {
+    int32_t width = 3840;
+    int32_t height = 2160;
+    std::unique_ptr<T[]> src(new T[width * height * nc]);
+    std::unique_ptr<T[]> dst(new T[width * height * nc]);
+    ppl::cv::debug::randomFill<T>(src.get(), width * height * nc, 0, 255);
+    double M[6] = {0.9, 0.1, -10.0, -0.12, 1.05, 20.0};
+    ppl::cv::x86::SetNumThreads(state.range(0));
+    for (auto _ : state) {
+        ppl::cv::x86::WarpAffineLinear<T, nc>(height, width, width * nc, src.get(), height, width, width * nc, dst.get(), M, ppl::cv::BORDER_CONSTANT, 0);
+    }
+    ppl::cv::x86::SetNumThreads(0);
+    state.SetItemsProcessed(state.iterations() * 1);
+}
+
+void BM_NV122BGR_threads_ppl_x86(benchmark::State &state) {
+    int32_t width = 3840;
+    int32_t height = 2160;
+    std::unique_ptr<uint8_t[]> src(new uint8_t[width * height * 3 / 2]);
+    std::unique_ptr<uint8_t[]> dst(new uint8_t[width * height * 3]);
+    ppl::cv::debug::randomFill<uint8_t>(src.get(), width * height * 3 / 2, 0, 255);
+    ppl::cv::x86::SetNumThreads(state.range(0));
+    for (auto _ : state) {
+        ppl::cv::x86::NV122BGR<uint8_t>(height, width, width, src.get(), width * 3, dst.get());
+    }
+    ppl::cv::x86::SetNumThreads(0);
+    state.SetItemsProcessed(state.iterations() * 1);
+}
+
+using namespace ppl::cv::debug;
+BENCHMARK_TEMPLATE(BM_GaussianBlur_threads_ppl_x86, float, c3)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->Arg(16)->Arg(32)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_GaussianBlur_threads_ppl_x86, uint8_t, c3)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->Arg(16)->Arg(32)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ResizeLinear_threads_ppl_x86, float, c3)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->Arg(16)->Arg(32)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ResizeLinear_threads_ppl_x86, uint8_t, c3)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->Arg(16)->Arg(32)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_WarpAffineLinear_threads_ppl_x86, uint8_t, c3)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->Arg(16)->Arg(32)->UseRealTime();
+BENCHMARK(BM_NV122BGR_threads_ppl_x86)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->Arg(16)->Arg(32)->UseRealTime();
+}
@@ -0,0 +1,162 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "ppl/cv/x86/parallel.h"
+#include "ppl/cv/x86/gaussianblur.h"
+#include "ppl/cv/x86/boxfilter.h"
+#include "ppl/cv/x86/resize.h"
+#include "ppl/cv/x86/warpaffine.h"
+#include "ppl/cv/x86/cvtcolor.h"
+#include "ppl/cv/x86/isa.h"
+#include "ppl/common/x86/sysinfo.h"
+#include "ppl/cv/debug.h"
+#include "ppl/cv/x86/test.h"
+#include <gtest/gtest.h>
+#include <functional>
+#include <memory>
+
+TEST(parallel, num_threads)
+{
+    int32_t num_threads = ppl::cv::x86::GetNumThreads();
+    EXPECT_GE(num_threads, 1);
+    EXPECT_EQ(ppl::cv::x86::SetNumThreads(-1), ppl::common::RC_INVALID_VALUE);
+    EXPECT_EQ(ppl::cv::x86::SetNumThreads(3), ppl::common::RC_SUCCESS);
+    EXPECT_EQ(ppl::cv::x86::GetNumThreads(), 3);
+    EXPECT_EQ(ppl::cv::x86::SetNumThreads(0), ppl::common::RC_SUCCESS);
+    EXPECT_EQ(ppl::cv::x86::GetNumThreads(), num_threads);
+}
+
+// Banded kernels give the same results whatever the number of threads.
+template <typename T, int32_t c>
+void checkThreadInvariant(
+    int32_t height,
+    int32_t width,
+    const std::function<void(T *)> &func,
+    float diff_THR = 1e-6f)
+{
+    std::unique_ptr<T[]> dst_ref(new T[height * width * c]);
+    std::unique_ptr<T[]> dst(new T[height * width * c]);
+
+    ppl::cv::x86::SetNumThreads(1);
+    func(dst_ref.get());
+    ppl::cv::x86::SetNumThreads(4);
+    func(dst.get());
+    ppl::cv::x86::SetNumThreads(0);
+
+    checkResult<T, c>(dst_ref.get(), dst.get(), height, width, width * c, width * c, diff_THR);
+}
+
+template <typename T, int32_t c>
+class parallel_ : public ::testing::TestWithParam<Size> {
+public:
+    void apply(const Size &size)
+    {
+        int32_t height = size.height;
+        int32_t width  = size.width;
+        std::unique_ptr<T[]> src(new T[height * width * c]);
+        ppl::cv::debug::randomFill<T>(src.get(), height * width * c, 0, 255);
+        const T *in = src.get();
+
+        checkThreadInvariant<T, c>(height, width, [&](T *out) {
+            ppl::cv::x86::GaussianBlur<T, c>(height, width, width * c, in, 5, 0.0f, width * c, out, ppl::cv::BORDER_REFLECT_101);
+        });
+        checkThreadInvariant<T, c>(height, width, [&](T *out) {
+            ppl::cv::x86::BoxFilter<T, c>(height, width, width * c, in, 7, 5, true, width * c, out, ppl::cv::BORDER_REFLECT);
+        });
+        checkThreadInvariant<T, c>(height * 2 / 3, width * 3 / 4, [&](T *out) {
+            ppl::cv::x86::ResizeLinear<T, c>(height, width, width * c, in, height * 2 / 3, width * 3 / 4, width * 3 / 4 * c, out);
+        });
+        checkThreadInvariant<T, c>(height * 3 / 2, width * 3 / 2, [&](T *out) {
+            ppl::cv::x86::ResizeLinear<T, c>(height, width, width * c, in, height * 3 / 2, width * 3 / 2, width * 3 / 2 * c, out);
+        });
+        double M[6] = {0.9, 0.1, -10.0, -0.12, 1.05, 20.0};
+        checkThreadInvariant<T, c>(height, width, [&](T *out) {
+            ppl::cv::x86::WarpAffineLinear<T, c>(height, width, width * c, in, height, width, width * c, out, M, ppl::cv::BORDER_CONSTANT, 0);
+        });
+    }
+};
+
+#define R(name, t, c)                                                                        \
+    using name = parallel_<t, c>;                                                            \
+    TEST_P(name, abc)                                                                        \
+    {                                                                                        \
+        this->apply(GetParam());                                                             \
+    }                                                                                        \
+    INSTANTIATE_TEST_CASE_P(standard, name,                                                  \
+                            ::testing::Values(Size{640, 480}, Size{1283, 723}, Size{1920, 1080}));
+
+R(parallel_f32c1, float, 1)
+R(parallel_f32c3, float, 3)
+R(parallel_u8c1, uint8_t, 1)
+R(parallel_u8c4, uint8_t, 4)
+
+// Every tier of the warp kernels has to locate a row the same way whatever
+// band it falls in. Matrices whose entries are not dyadic fractions round
+// differently once the row offset is folded into the translation.
+template <typename T, int32_t c>
+void checkWarpAffineIsa(int32_t height, int32_t width)
+{
+    std::unique_ptr<T[]> src(new T[height * width * c]);
+    ppl::cv::debug::randomFill<T>(src.get(), height * width * c, 0, 255);
+    const T *in = src.get();
+    const uint32_t isa_masks[] = {
+        (uint32_t)ppl::common::ISA_X86_SSE41,
+        ~(uint32_t)ppl::common::ISA_X86_AVX512,
+        0xffffffffu,
+    };
+
+    double M[6] = {0.9, 0.15, 3.3, -0.12, 1.05, -2.1};
+    for (uint32_t isa_mask : isa_masks) {
+        ppl::cv::x86::SetIsaMask(isa_mask);
+        checkThreadInvariant<T, c>(height, width, [&](T *out) {
+            ppl::cv::x86::WarpAffineLinear<T, c>(height, width, width * c, in, height, width, width * c, out, M, ppl::cv::BORDER_CONSTANT, 0);
+        });
+        checkThreadInvariant<T, c>(height, width, [&](T *out) {
+            ppl::cv::x86::WarpAffineNearestPoint<T, c>(height, width, width * c, in, height, width, width * c, out, M, ppl::cv::BORDER_CONSTANT, 0);
+        });
+    }
+    ppl::cv::x86::SetIsaMask(0xffffffffu);
+}
+
+TEST(parallel, warpaffine_isa)
+{
+    checkWarpAffineIsa<float, 1>(480, 640);
+    checkWarpAffineIsa<float, 3>(480, 640);
+    checkWarpAffineIsa<uint8_t, 1>(480, 640);
+    checkWarpAffineIsa<uint8_t, 4>(480, 640);
+}
+
+TEST(parallel, yuv420)
+{
+    const int32_t height = 1080, width = 1920;
+    std::unique_ptr<uint8_t[]> src(new uint8_t[height * width * 3]);
+    ppl::cv::debug::randomFill<uint8_t>(src.get(), height * width * 3, 0, 255);
+    const uint8_t *in = src.get();
+
+    checkThreadInvariant<uint8_t, 3>(height, width, [&](uint8_t *out) {
+        ppl::cv::x86::NV122BGR<uint8_t>(height, width, width, in, width * 3, out);
+    });
+    checkThreadInvariant<uint8_t, 3>(height, width, [&](uint8_t *out) {
+        ppl::cv::x86::I4202BGR<uint8_t>(height, width, width, in, width * 3, out);
+    });
+    checkThreadInvariant<uint8_t, 1>(height * 3 / 2, width, [&](uint8_t *out) {
+        ppl::cv::x86::BGR2I420<uint8_t>(height, width, width * 3, in, width, out);
+    });
+    checkThreadInvariant<uint8_t, 1>(height, width, [&](uint8_t *out) {
+        ppl::cv::x86::BGR2GRAY<uint8_t>(height, width, width * 3, in, width, out);
+    });
+}
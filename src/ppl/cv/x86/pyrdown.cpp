@@ -16,7 +16,7 @@
 // under the License.
 
 #include "ppl/cv/x86/pyrdown.h"
-#include "ppl/cv/x86/util.hpp"
+#include "ppl/cv/x86/filter_engine.hpp"
 #include "ppl/cv/types.h"
 #include "ppl/common/sys.h"
 #include <string.h>
@@ -26,7 +26,9 @@ namespace ppl {
 namespace cv {
 namespace x86 {
 
-void pyrdown_kernel_f32(
+// Output rows [begin, end) of the band, each band keeping its own ring of the
+// five horizontally filtered source rows it reads.
+static void pyrdown_rows_f32(
     int32_t height,
     int32_t width,
     int32_t channels,
@@ -35,7 +37,10 @@ void pyrdown_kernel_f32(
     int32_t outHeight,
     int32_t outWidth,
     int32_t outWidthStride,
-    float *outData)
+    float *outData,
+    BorderType border_type,
+    int32_t begin,
+    int32_t end)
 {
     const int32_t PD_SZ = 5;
     int32_t bufstep     = (outWidth * channels + 16 - 1) / 16 * 16;
@@ -46,7 +51,7 @@ void pyrdown_kernel_f32(
 
     float *rows[PD_SZ];
 
-    int32_t k, x, sy0 = -PD_SZ / 2, sy = sy0;
+    int32_t k, x, sy0 = begin * 2 - PD_SZ / 2, sy = sy0;
     int32_t width0 = outWidth;
     if ((width - PD_SZ / 2 - 1) / 2 + 1 < width0) {
         width0 = (width - PD_SZ / 2 - 1) / 2 + 1;
@@ -55,8 +60,8 @@ void pyrdown_kernel_f32(
     float r = 1.0f / 256.0f;
 
     for (x = 0; x <= PD_SZ + 1; ++x) {
-        int32_t sx0 = borderInterpolate(x - PD_SZ / 2, width) * channels;
-        int32_t sx1 = borderInterpolate(x + width0 * 2 - PD_SZ / 2, width) * channels;
+        int32_t sx0 = border_interpolate(x - PD_SZ / 2, width, border_type) * channels;
+        int32_t sx1 = border_interpolate(x + width0 * 2 - PD_SZ / 2, width, border_type) * channels;
         for (k = 0; k < channels; ++k) {
             tabL[x * channels + k] = sx0 + k;
             tabR[x * channels + k] = sx1 + k;
@@ -71,12 +76,12 @@ void pyrdown_kernel_f32(
         tabM[x] = (x / channels) * 2 * channels + x % channels;
     }
 
-    for (int32_t y = 0; y < outHeight; ++y) {
+    for (int32_t y = begin; y < end; ++y) {
         float *dst = outData + y * outWidthStride;
 
         for (; sy <= y * 2 + 2; ++sy) {
             float *row         = buf + ((sy - sy0) % PD_SZ) * bufstep;
-            int32_t _sy        = borderInterpolate(sy, height);
+            int32_t _sy        = border_interpolate(sy, height, border_type);
             const float *src   = inData + _sy * inWidthStride;
             int32_t limit      = channels;
             const int32_t *tab = tabL;
@@ -147,10 +152,27 @@ void pyrdown_kernel_f32(
         }
     }
     free(tabM);
-    ppl::common::AlignedFree(buf);
+    free(buf);
 }
 
-void pyrdown_kernel_u8(
+void pyrdown_kernel_f32(
+    int32_t height,
+    int32_t width,
+    int32_t channels,
+    int32_t inWidthStride,
+    const float *inData,
+    int32_t outHeight,
+    int32_t outWidth,
+    int32_t outWidthStride,
+    float *outData,
+    BorderType border_type)
+{
+    parallel_for_rows(outHeight, (int64_t)outWidth * channels * 4, [&](int32_t begin, int32_t end) {
+        pyrdown_rows_f32(height, width, channels, inWidthStride, inData, outHeight, outWidth, outWidthStride, outData, border_type, begin, end);
+    });
+}
+
+static void pyrdown_rows_u8(
     int32_t height,
     int32_t width,
     int32_t channels,
@@ -159,7 +181,10 @@ void pyrdown_kernel_u8(
     int32_t outHeight,
     int32_t outWidth,
     int32_t outWidthStride,
-    uint8_t *outData)
+    uint8_t *outData,
+    BorderType border_type,
+    int32_t begin,
+    int32_t end)
 {
     const int32_t PD_SZ = 5;
     int32_t bufstep     = (outWidth * channels + 16 - 1) / 16 * 16;
@@ -170,15 +195,15 @@ void pyrdown_kernel_u8(
 
     int32_t *rows[PD_SZ];
 
-    int32_t k, x, sy0 = -PD_SZ / 2, sy = sy0;
+    int32_t k, x, sy0 = begin * 2 - PD_SZ / 2, sy = sy0;
     int32_t width0 = outWidth;
     if ((width - PD_SZ / 2 - 1) / 2 + 1 < width0) {
         width0 = (width - PD_SZ / 2 - 1) / 2 + 1;
     }
 
     for (x = 0; x <= PD_SZ + 1; ++x) {
-        int32_t sx0 = borderInterpolate(x - PD_SZ / 2, width) * channels;
-        int32_t sx1 = borderInterpolate(x + width0 * 2 - PD_SZ / 2, width) * channels;
+        int32_t sx0 = border_interpolate(x - PD_SZ / 2, width, border_type) * channels;
+        int32_t sx1 = border_interpolate(x + width0 * 2 - PD_SZ / 2, width, border_type) * channels;
         for (k = 0; k < channels; ++k) {
             tabL[x * channels + k] = sx0 + k;
             tabR[x * channels + k] = sx1 + k;
@@ -193,12 +218,12 @@ void pyrdown_kernel_u8(
         tabM[x] = (x / channels) * 2 * channels + x % channels;
     }
 
-    for (int32_t y = 0; y < outHeight; ++y) {
+    for (int32_t y = begin; y < end; ++y) {
         uint8_t *dst = outData + y * outWidthStride;
 
         for (; sy <= y * 2 + 2; ++sy) {
             int32_t *row       = buf + ((sy - sy0) % PD_SZ) * bufstep;
-            int32_t _sy        = borderInterpolate(sy, height);
+            int32_t _sy        = border_interpolate(sy, height, border_type);
             const uint8_t *src = inData + _sy * inWidthStride;
             int32_t limit      = channels;
             const int32_t *tab = tabL;
@@ -271,7 +296,24 @@ void pyrdown_kernel_u8(
         }
     }
     free(tabM);
-    ppl::common::AlignedFree(buf);
+    free(buf);
+}
+
+void pyrdown_kernel_u8(
+    int32_t height,
+    int32_t width,
+    int32_t channels,
+    int32_t inWidthStride,
+    const uint8_t *inData,
+    int32_t outHeight,
+    int32_t outWidth,
+    int32_t outWidthStride,
+    uint8_t *outData,
+    BorderType border_type)
+{
+    parallel_for_rows(outHeight, (int64_t)outWidth * channels * 4, [&](int32_t begin, int32_t end) {
+        pyrdown_rows_u8(height, width, channels, inWidthStride, inData, outHeight, outWidth, outWidthStride, outData, border_type, begin, end);
+    });
 }
 
 template <>
@@ -290,12 +332,12 @@ template <>
     if (height <= 0 || width <= 0 || inWidthStride < width) {
         return ppl::common::RC_INVALID_VALUE;
     }
-    if (border_type != ppl::cv::BORDER_REFLECT_101) {
+    if (border_type == ppl::cv::BORDER_CONSTANT || !filter_border_supported(border_type)) {
         return ppl::common::RC_INVALID_VALUE;
     }
     int32_t outHeight = (height + 1) / 2;
     int32_t outWidth  = (width + 1) / 2;
-    pyrdown_kernel_f32(height, width, 1, inWidthStride, inData, outHeight, outWidth, outWidthStride, outData);
+    pyrdown_kernel_f32(height, width, 1, inWidthStride, inData, outHeight, outWidth, outWidthStride, outData, border_type);
     return ppl::common::RC_SUCCESS;
 }
 
@@ -315,12 +357,12 @@ template <>
     if (height <= 0 || width <= 0 || inWidthStride < width) {
         return ppl::common::RC_INVALID_VALUE;
     }
-    if (border_type != ppl::cv::BORDER_REFLECT_101) {
+    if (border_type == ppl::cv::BORDER_CONSTANT || !filter_border_supported(border_type)) {
         return ppl::common::RC_INVALID_VALUE;
     }
     int32_t outHeight = (height + 1) / 2;
     int32_t outWidth  = (width + 1) / 2;
-    pyrdown_kernel_f32(height, width, 3, inWidthStride, inData, outHeight, outWidth, outWidthStride, outData);
+    pyrdown_kernel_f32(height, width, 3, inWidthStride, inData, outHeight, outWidth, outWidthStride, outData, border_type);
     return ppl::common::RC_SUCCESS;
 }
 
@@ -340,12 +382,12 @@ template <>
     if (height <= 0 || width <= 0 || inWidthStride < width) {
         return ppl::common::RC_INVALID_VALUE;
     }
-    if (border_type != ppl::cv::BORDER_REFLECT_101) {
+    if (border_type == ppl::cv::BORDER_CONSTANT || !filter_border_supported(border_type)) {
         return ppl::common::RC_INVALID_VALUE;
     }
     int32_t outHeight = (height + 1) / 2;
     int32_t outWidth  = (width + 1) / 2;
-    pyrdown_kernel_f32(height, width, 4, inWidthStride, inData, outHeight, outWidth, outWidthStride, outData);
+    pyrdown_kernel_f32(height, width, 4, inWidthStride, inData, outHeight, outWidth, outWidthStride, outData, border_type);
     return ppl::common::RC_SUCCESS;
 }
 
@@ -365,12 +407,12 @@ template <>
     if (height <= 0 || width <= 0 || inWidthStride < width) {
         return ppl::common::RC_INVALID_VALUE;
     }
-    if (border_type != ppl::cv::BORDER_REFLECT_101) {
+    if (border_type == ppl::cv::BORDER_CONSTANT || !filter_border_supported(border_type)) {
         return ppl::common::RC_INVALID_VALUE;
     }
     int32_t outHeight = (height + 1) / 2;
     int32_t outWidth  = (width + 1) / 2;
-    pyrdown_kernel_u8(height, width, 1, inWidthStride, inData, outHeight, outWidth, outWidthStride, outData);
+    pyrdown_kernel_u8(height, width, 1, inWidthStride, inData, outHeight, outWidth, outWidthStride, outData, border_type);
     return ppl::common::RC_SUCCESS;
 }
 
@@ -390,12 +432,12 @@ template <>
     if (height <= 0 || width <= 0 || inWidthStride < width) {
         return ppl::common::RC_INVALID_VALUE;
     }
-    if (border_type != ppl::cv::BORDER_REFLECT_101) {
+    if (border_type == ppl::cv::BORDER_CONSTANT || !filter_border_supported(border_type)) {
         return ppl::common::RC_INVALID_VALUE;
     }
     int32_t outHeight = (height + 1) / 2;
     int32_t outWidth  = (width + 1) / 2;
-    pyrdown_kernel_u8(height, width, 3, inWidthStride, inData, outHeight, outWidth, outWidthStride, outData);
+    pyrdown_kernel_u8(height, width, 3, inWidthStride, inData, outHeight, outWidth, outWidthStride, outData, border_type);
     return ppl::common::RC_SUCCESS;
 }
 
@@ -415,12 +457,12 @@ template <>
     if (height <= 0 || width <= 0 || inWidthStride < width) {
         return ppl::common::RC_INVALID_VALUE;
     }
-    if (border_type != ppl::cv::BORDER_REFLECT_101) {
+    if (border_type == ppl::cv::BORDER_CONSTANT || !filter_border_supported(border_type)) {
         return ppl::common::RC_INVALID_VALUE;
     }
     int32_t outHeight = (height + 1) / 2;
     int32_t outWidth  = (width + 1) / 2;
-    pyrdown_kernel_u8(height, width, 4, inWidthStride, inData, outHeight, outWidth, outWidthStride, outData);
+    pyrdown_kernel_u8(height, width, 4, inWidthStride, inData, outHeight, outWidth, outWidthStride, outData, border_type);
     return ppl::common::RC_SUCCESS;
 }
 
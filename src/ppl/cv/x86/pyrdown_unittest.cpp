@@ -22,9 +22,9 @@
 #include <memory>
 
 template<typename T, int32_t c>
-class PyrDown : public ::testing::TestWithParam<std::tuple<Size, Size>> {
+class PyrDown : public ::testing::TestWithParam<std::tuple<Size, Size, ppl::cv::BorderType>> {
 public:
-    using PyrDownParam = std::tuple<Size, Size>;
+    using PyrDownParam = std::tuple<Size, Size, ppl::cv::BorderType>;
     PyrDown()
     {
     }
@@ -36,6 +36,7 @@ public:
     void apply(const PyrDownParam &param) {
         Size isize = std::get<0>(param);
         Size osize = std::get<1>(param);
+        ppl::cv::BorderType border_type = std::get<2>(param);
 
         std::unique_ptr<T> src(new T[isize.width * isize.height * c]);
         ppl::cv::debug::randomFill<T>(src.get(), isize.width * isize.height * c, 0, 255);
@@ -43,12 +44,12 @@ public:
         std::unique_ptr<T> dst_opencv(new T[osize.width * osize.height * c]);
 
         ppl::cv::x86::PyrDown<T, c>(isize.height, isize.width, isize.width * c, src.get(),
-            osize.width * c, dst.get(), ppl::cv::BORDER_DEFAULT);
+            osize.width * c, dst.get(), border_type);
 
         ::cv::Mat iMat(isize.height, isize.width, T2CvType<T, c>::type, src.get());
         ::cv::Mat oMat(osize.height, osize.width, T2CvType<T, c>::type, dst_opencv.get());
 
-        ::cv::pyrDown(iMat, oMat, ::cv::Size(osize.width, osize.height));
+        ::cv::pyrDown(iMat, oMat, ::cv::Size(osize.width, osize.height), border_type);
         checkResult<T, c>(dst.get(), dst_opencv.get(), osize.height, osize.width, osize.width * c, osize.width * c, 1e-3);
     }
 };
@@ -61,7 +62,8 @@ public:
     }\
     INSTANTIATE_TEST_CASE_P(standard, name,\
         ::testing::Combine(::testing::Values(Size{6, 8}),\
-                           ::testing::Values(Size{3, 4})));
+                           ::testing::Values(Size{3, 4}),\
+                           ::testing::Values(ppl::cv::BORDER_DEFAULT, ppl::cv::BORDER_REFLECT, ppl::cv::BORDER_REPLICATE)));
 
 R(PyrDown_x86_f32c1, float, 1)
 R(PyrDown_x86_f32c3, float, 3)
@@ -16,7 +16,7 @@
 // under the License.
 
 #include "ppl/cv/x86/pyrup.h"
-#include "ppl/cv/x86/util.hpp"
+#include "ppl/cv/x86/filter_engine.hpp"
 #include "ppl/cv/types.h"
 #include "ppl/common/sys.h"
 #include <string.h>
@@ -26,7 +26,9 @@ namespace ppl {
 namespace cv {
 namespace x86 {
 
-void pyrup_kernel_f32(
+// Output rows of input rows [begin, end) of the band, each band keeping its own
+// ring of the three horizontally filtered source rows it reads.
+static void pyrup_rows_f32(
     int32_t height,
     int32_t width,
     int32_t channels,
@@ -35,7 +37,10 @@ void pyrup_kernel_f32(
     int32_t outHeight,
     int32_t outWidth,
     int32_t outWidthStride,
-    float *outData)
+    float *outData,
+    BorderType border_type,
+    int32_t begin,
+    int32_t end)
 {
     const int32_t PU_SZ = 3;
     int32_t bufstep     = ((outWidth + 1) * channels + 16 - 1) / 16 * 16;
@@ -45,7 +50,7 @@ void pyrup_kernel_f32(
 
     float *rows[3];
 
-    int32_t k, x, sy0 = -PU_SZ / 2, sy = sy0;
+    int32_t k, x, sy0 = begin - PU_SZ / 2, sy = sy0;
     float r = 1.0f / 64;
 
     width *= channels;
@@ -55,7 +60,7 @@ void pyrup_kernel_f32(
         dtab[x] = (x / channels) * 2 * channels + x % channels;
     }
 
-    for (int32_t y = 0; y < height; ++y) {
+    for (int32_t y = begin; y < end; ++y) {
         float *dst0 = outData + (y * 2) * outWidthStride;
 
         int32_t oy1 = y * 2 + 1;
@@ -67,7 +72,7 @@ void pyrup_kernel_f32(
 
         for (; sy <= y + 1; ++sy) {
             float *row  = buf + ((sy - sy0) % PU_SZ) * bufstep;
-            int32_t _sy = borderInterpolate(sy * 2, height * 2) / 2;
+            int32_t _sy = border_interpolate(sy * 2, height * 2, border_type) / 2;
 
             const float *src = inData + _sy * inWidthStride;
 
@@ -121,7 +126,7 @@ void pyrup_kernel_f32(
         }
     }
 
-    if (outHeight > height * 2) {
+    if (end == height && outHeight > height * 2) {
         float *dst0 = outData + (height * 2 - 2) * outWidthStride;
         float *dst2 = outData + (height * 2) * outWidthStride;
 
@@ -134,7 +139,24 @@ void pyrup_kernel_f32(
     free(buf);
 }
 
-void pyrup_kernel_u8(
+void pyrup_kernel_f32(
+    int32_t height,
+    int32_t width,
+    int32_t channels,
+    int32_t inWidthStride,
+    const float *inData,
+    int32_t outHeight,
+    int32_t outWidth,
+    int32_t outWidthStride,
+    float *outData,
+    BorderType border_type)
+{
+    parallel_for_rows(height, (int64_t)outWidth * channels * 2, [&](int32_t begin, int32_t end) {
+        pyrup_rows_f32(height, width, channels, inWidthStride, inData, outHeight, outWidth, outWidthStride, outData, border_type, begin, end);
+    });
+}
+
+static void pyrup_rows_u8(
     int32_t height,
     int32_t width,
     int32_t channels,
@@ -143,7 +165,10 @@ void pyrup_kernel_u8(
     int32_t outHeight,
     int32_t outWidth,
     int32_t outWidthStride,
-    uint8_t *outData)
+    uint8_t *outData,
+    BorderType border_type,
+    int32_t begin,
+    int32_t end)
 {
     const int32_t PU_SZ = 3;
     int32_t bufstep     = ((outWidth + 1) * channels + 16 - 1) / 16 * 16;
@@ -153,7 +178,7 @@ void pyrup_kernel_u8(
 
     int32_t *rows[3];
 
-    int32_t k, x, sy0 = -PU_SZ / 2, sy = sy0;
+    int32_t k, x, sy0 = begin - PU_SZ / 2, sy = sy0;
 
     width *= channels;
     outWidth *= channels;
@@ -162,7 +187,7 @@ void pyrup_kernel_u8(
         dtab[x] = (x / channels) * 2 * channels + x % channels;
     }
 
-    for (int32_t y = 0; y < height; ++y) {
+    for (int32_t y = begin; y < end; ++y) {
         uint8_t *dst0 = outData + (y * 2) * outWidthStride;
 
         int32_t oy1 = y * 2 + 1;
@@ -174,7 +199,7 @@ void pyrup_kernel_u8(
 
         for (; sy <= y + 1; ++sy) {
             int32_t *row = buf + ((sy - sy0) % PU_SZ) * bufstep;
-            int32_t _sy  = borderInterpolate(sy * 2, height * 2) / 2;
+            int32_t _sy  = border_interpolate(sy * 2, height * 2, border_type) / 2;
 
             const uint8_t *src = inData + _sy * inWidthStride;
 
@@ -231,7 +256,7 @@ void pyrup_kernel_u8(
         }
     }
 
-    if (outHeight > height * 2) {
+    if (end == height && outHeight > height * 2) {
         uint8_t *dst0 = outData + (height * 2 - 2) * outWidthStride;
         uint8_t *dst2 = outData + (height * 2) * outWidthStride;
 
@@ -244,6 +269,23 @@ void pyrup_kernel_u8(
     free(buf);
 }
 
+void pyrup_kernel_u8(
+    int32_t height,
+    int32_t width,
+    int32_t channels,
+    int32_t inWidthStride,
+    const uint8_t *inData,
+    int32_t outHeight,
+    int32_t outWidth,
+    int32_t outWidthStride,
+    uint8_t *outData,
+    BorderType border_type)
+{
+    parallel_for_rows(height, (int64_t)outWidth * channels * 2, [&](int32_t begin, int32_t end) {
+        pyrup_rows_u8(height, width, channels, inWidthStride, inData, outHeight, outWidth, outWidthStride, outData, border_type, begin, end);
+    });
+}
+
 template <>
 ::ppl::common::RetCode PyrUp<float, 1>(
     int32_t height,
@@ -265,7 +307,7 @@ template <>
     }
     int32_t outHeight = height * 2;
     int32_t outWidth  = width * 2;
-    pyrup_kernel_f32(height, width, 1, inWidthStride, inData, outHeight, outWidth, outWidthStride, outData);
+    pyrup_kernel_f32(height, width, 1, inWidthStride, inData, outHeight, outWidth, outWidthStride, outData, border_type);
     return ppl::common::RC_SUCCESS;
 }
 
@@ -290,7 +332,7 @@ template <>
     }
     int32_t outHeight = height * 2;
     int32_t outWidth  = width * 2;
-    pyrup_kernel_f32(height, width, 3, inWidthStride, inData, outHeight, outWidth, outWidthStride, outData);
+    pyrup_kernel_f32(height, width, 3, inWidthStride, inData, outHeight, outWidth, outWidthStride, outData, border_type);
     return ppl::common::RC_SUCCESS;
 }
 
@@ -315,7 +357,7 @@ template <>
     }
     int32_t outHeight = height * 2;
     int32_t outWidth  = width * 2;
-    pyrup_kernel_f32(height, width, 4, inWidthStride, inData, outHeight, outWidth, outWidthStride, outData);
+    pyrup_kernel_f32(height, width, 4, inWidthStride, inData, outHeight, outWidth, outWidthStride, outData, border_type);
     return ppl::common::RC_SUCCESS;
 }
 
@@ -340,7 +382,7 @@ template <>
     }
     int32_t outHeight = height * 2;
     int32_t outWidth  = width * 2;
-    pyrup_kernel_u8(height, width, 1, inWidthStride, inData, outHeight, outWidth, outWidthStride, outData);
+    pyrup_kernel_u8(height, width, 1, inWidthStride, inData, outHeight, outWidth, outWidthStride, outData, border_type);
     return ppl::common::RC_SUCCESS;
 }
 
@@ -365,7 +407,7 @@ template <>
     }
     int32_t outHeight = height * 2;
     int32_t outWidth  = width * 2;
-    pyrup_kernel_u8(height, width, 3, inWidthStride, inData, outHeight, outWidth, outWidthStride, outData);
+    pyrup_kernel_u8(height, width, 3, inWidthStride, inData, outHeight, outWidth, outWidthStride, outData, border_type);
     return ppl::common::RC_SUCCESS;
 }
 
@@ -390,7 +432,7 @@ template <>
     }
     int32_t outHeight = height * 2;
     int32_t outWidth  = width * 2;
-    pyrup_kernel_u8(height, width, 4, inWidthStride, inData, outHeight, outWidth, outWidthStride, outData);
+    pyrup_kernel_u8(height, width, 4, inWidthStride, inData, outHeight, outWidth, outWidthStride, outData, border_type);
     return ppl::common::RC_SUCCESS;
 }
 
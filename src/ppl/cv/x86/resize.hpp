@@ -0,0 +1,194 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#ifndef PPL_CV_X86_RESIZE_HPP_
+#define PPL_CV_X86_RESIZE_HPP_
+
+#include "ppl/cv/types.h"
+#include "ppl/common/retcode.h"
+
+#include <stdint.h>
+
+namespace ppl {
+namespace cv {
+namespace x86 {
+
+// Everything a resize needs besides the two images: the source row and column
+// of every output pixel, their interpolation weights, the instruction set to
+// run and the row buffers of each band. ResizeLinear, ResizeNearestPoint and
+// ResizeArea build one per call, ResizePlan builds it once and reuses it for
+// every frame.
+struct ResizeTable {
+    int32_t inHeight;
+    int32_t inWidth;
+    int32_t outHeight;
+    int32_t outWidth;
+    int32_t channels;
+    bool use_fma;
+    bool use_avx512;   // only the float kernels have an AVX-512 version
+    bool shrink2;      // exact 2x downscale, interpolated without tables
+    int32_t w_max;     // last output column whose right neighbour is inside the image
+    bool area_linear;  // INTERPOLATION_AREA enlarging an axis, run as a linear resize
+    int32_t scale_h;   // INTERPOLATION_AREA: integer shrink factors of the box filter,
+    int32_t scale_w;   // 0 when the source pixels are weighted by the tables
+    int32_t h_taps;    // INTERPOLATION_AREA: source rows and columns weighted
+    int32_t w_taps;    // for every output row and column
+    int32_t *h_offset; // source row of every output row
+    int32_t *w_offset; // source column of every output column
+    void *h_coeff;     // int16_t for uint8_t images, float for float images
+    void *w_coeff;
+    int32_t num_bands; // most bands the output rows are split into
+    uint64_t row_size; // bytes of one horizontally interpolated row
+    void *rows;        // two rows for each band
+    void *buffer;      // owns the tables and the rows
+};
+
+::ppl::common::RetCode resize_linear_table_create_u8(
+    int32_t inHeight,
+    int32_t inWidth,
+    int32_t channels,
+    int32_t outHeight,
+    int32_t outWidth,
+    ResizeTable *table,
+    bool area = false);
+
+::ppl::common::RetCode resize_linear_table_create_fp32(
+    int32_t inHeight,
+    int32_t inWidth,
+    int32_t channels,
+    int32_t outHeight,
+    int32_t outWidth,
+    ResizeTable *table,
+    bool area = false);
+
+::ppl::common::RetCode resize_nearest_table_create_u8(
+    int32_t inHeight,
+    int32_t inWidth,
+    int32_t channels,
+    int32_t outHeight,
+    int32_t outWidth,
+    ResizeTable *table);
+
+::ppl::common::RetCode resize_nearest_table_create_fp32(
+    int32_t inHeight,
+    int32_t inWidth,
+    int32_t channels,
+    int32_t outHeight,
+    int32_t outWidth,
+    ResizeTable *table);
+
+::ppl::common::RetCode resize_area_table_create_u8(
+    int32_t inHeight,
+    int32_t inWidth,
+    int32_t channels,
+    int32_t outHeight,
+    int32_t outWidth,
+    ResizeTable *table);
+
+::ppl::common::RetCode resize_area_table_create_fp32(
+    int32_t inHeight,
+    int32_t inWidth,
+    int32_t channels,
+    int32_t outHeight,
+    int32_t outWidth,
+    ResizeTable *table);
+
+void resize_table_destroy(ResizeTable *table);
+
+// INTERPOLATION_AREA enlarges with linear interpolation whose weight of the
+// next source pixel is its share of output pixel d, as OpenCV does. Replaces
+// the linear source position s and weight f of output pixel d.
+inline void resize_area_linear_coeff(int32_t d, double scale, double inv_scale, int32_t &s, float &f)
+{
+    s = (int32_t)(d * scale);
+    f = (float)((d + 1) - (s + 1) * inv_scale);
+    f = f <= 0 ? 0.f : f - (int32_t)f;
+}
+
+// Runs a resize with a table made by the matching create function. A table
+// is used by one call at a time, as the bands write to its row buffers.
+void resize_linear_run_u8(
+    const ResizeTable &table,
+    int32_t inWidthStride,
+    const uint8_t *inData,
+    int32_t outWidthStride,
+    uint8_t *outData);
+
+void resize_linear_run_fp32(
+    const ResizeTable &table,
+    int32_t inWidthStride,
+    const float *inData,
+    int32_t outWidthStride,
+    float *outData);
+
+// Produces output rows [begin, end) of a linear resize on the calling thread,
+// `outData` pointing at row `begin` and `rows` at the two row buffers of one
+// band. Lets fused operators consume a few resized rows while they are still
+// in cache instead of resizing the whole image first.
+void resize_linear_run_rows_u8(
+    const ResizeTable &table,
+    int32_t inWidthStride,
+    const uint8_t *inData,
+    int32_t outWidthStride,
+    uint8_t *outData,
+    void *rows,
+    int32_t begin,
+    int32_t end);
+
+void resize_linear_run_rows_fp32(
+    const ResizeTable &table,
+    int32_t inWidthStride,
+    const float *inData,
+    int32_t outWidthStride,
+    float *outData,
+    void *rows,
+    int32_t begin,
+    int32_t end);
+
+void resize_nearest_run_u8(
+    const ResizeTable &table,
+    int32_t inWidthStride,
+    const uint8_t *inData,
+    int32_t outWidthStride,
+    uint8_t *outData);
+
+void resize_nearest_run_fp32(
+    const ResizeTable &table,
+    int32_t inWidthStride,
+    const float *inData,
+    int32_t outWidthStride,
+    float *outData);
+
+void resize_area_run_u8(
+    const ResizeTable &table,
+    int32_t inWidthStride,
+    const uint8_t *inData,
+    int32_t outWidthStride,
+    uint8_t *outData);
+
+void resize_area_run_fp32(
+    const ResizeTable &table,
+    int32_t inWidthStride,
+    const float *inData,
+    int32_t outWidthStride,
+    float *outData);
+
+}
+}
+} // namespace ppl::cv::x86
+
+#endif //! PPL_CV_X86_RESIZE_HPP_
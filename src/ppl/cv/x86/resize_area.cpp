@@ -0,0 +1,920 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "ppl/cv/x86/resize.h"
+
+#include "ppl/cv/types.h"
+#include "ppl/common/sys.h"
+#include "ppl/common/retcode.h"
+#include "ppl/common/x86/sysinfo.h"
+#include "ppl/cv/x86/isa.hpp"
+
+#include <string.h>
+#include <immintrin.h>
+#include <stdint.h>
+#include <math.h>
+#include <algorithm>
+#include <atomic>
+
+#include "ppl/cv/x86/fma/internal_fma.hpp"
+#include "ppl/cv/x86/parallel.hpp"
+#include "ppl/cv/x86/resize.hpp"
+
+namespace ppl {
+namespace cv {
+namespace x86 {
+
+// INTERPOLATION_AREA averages the source pixels covered by every output pixel.
+// When both factors are integers this is a box filter, summed exactly and
+// divided once. Otherwise every output row and column weights a few source
+// rows and columns by how much of them it covers, from tables with the same
+// number of taps for every output pixel. Each output row first sums its
+// source rows into one row, so the columns are weighted once per output row
+// rather than once per source row.
+
+// elements after a row buffer that the vector loops may read or write
+#define RESIZE_AREA_ROW_PADDING (32)
+
+// the vertical box sums of uint8_t rows are kept in 16 bits
+#define RESIZE_AREA_MAX_BOX_U8 (257)
+
+// round half to even, as the default MXCSR rounding mode does
+static inline int32_t resize_area_round(float value)
+{
+    return _mm_cvtss_si32(_mm_set_ss(value));
+}
+
+static inline uint8_t resize_area_saturate_u8(int32_t value)
+{
+    return value < 0 ? 0 : (value > 255 ? 255 : value);
+}
+
+// Calls emit(source index, weight) for each source pixel under output pixel d,
+// with the weights of OpenCV's area tables.
+template <typename Emit>
+static void resize_area_cover(int32_t in_size, double scale, int32_t d, const Emit &emit)
+{
+    double fs1  = d * scale;
+    double fs2  = fs1 + scale;
+    double cell = std::min(scale, in_size - fs1);
+
+    int32_t s2 = std::min((int32_t)floor(fs2), in_size - 1);
+    int32_t s1 = std::min((int32_t)ceil(fs1), s2);
+
+    if (s1 - fs1 > 1e-3) {
+        emit(s1 - 1, (float)((s1 - fs1) / cell));
+    }
+    for (int32_t s = s1; s < s2; ++s) {
+        emit(s, (float)(1.0 / cell));
+    }
+    if (fs2 - s2 > 1e-3) {
+        emit(s2, (float)(std::min(std::min(fs2 - s2, 1.0), cell) / cell));
+    }
+}
+
+static int32_t resize_area_count_taps(int32_t in_size, int32_t out_size)
+{
+    double scale = (double)in_size / out_size;
+    int32_t taps = 0;
+    for (int32_t d = 0; d < out_size; ++d) {
+        int32_t count = 0;
+        resize_area_cover(in_size, scale, d, [&](int32_t, float) { ++count; });
+        taps = std::max(taps, count);
+    }
+    return taps;
+}
+
+// Output pixel d weights source pixels offset[d] .. offset[d] + taps - 1 by
+// coeff[d * stride ..]. The window is moved left at the end of the image, so
+// that it never reaches past it; the weights it gains there are zero.
+static void resize_area_calc_taps(
+    int32_t in_size,
+    int32_t out_size,
+    int32_t taps,
+    int32_t stride,
+    int32_t *offset,
+    float *coeff)
+{
+    double scale = (double)in_size / out_size;
+    memset(coeff, 0, out_size * stride * sizeof(float));
+    for (int32_t d = 0; d < out_size; ++d) {
+        int32_t first = -1;
+        resize_area_cover(in_size, scale, d, [&](int32_t s, float) {
+            if (first < 0) first = s;
+        });
+        offset[d] = std::min(first, in_size - taps);
+        resize_area_cover(in_size, scale, d, [&](int32_t s, float w) {
+            coeff[d * stride + s - offset[d]] = w;
+        });
+    }
+}
+
+static ::ppl::common::RetCode resize_area_table_create(
+    int32_t inHeight,
+    int32_t inWidth,
+    int32_t channels,
+    int32_t outHeight,
+    int32_t outWidth,
+    bool is_u8,
+    ResizeTable *table)
+{
+    memset(table, 0, sizeof(ResizeTable));
+    table->inHeight  = inHeight;
+    table->inWidth   = inWidth;
+    table->outHeight = outHeight;
+    table->outWidth  = outWidth;
+    table->channels  = channels;
+    table->use_fma   = isa_supported(ppl::common::ISA_X86_FMA);
+
+    if (inHeight % outHeight == 0 && inWidth % outWidth == 0) {
+        int32_t scale_h = inHeight / outHeight;
+        int32_t scale_w = inWidth / outWidth;
+        if (!is_u8 || scale_h * scale_w <= RESIZE_AREA_MAX_BOX_U8) {
+            table->scale_h = scale_h;
+            table->scale_w = scale_w;
+        }
+    }
+
+    uint64_t size_for_h_offset = 0;
+    uint64_t size_for_w_offset = 0;
+    uint64_t size_for_h_coeff  = 0;
+    uint64_t size_for_w_coeff  = 0;
+    int32_t w_stride           = 0;
+    if (0 == table->scale_h) {
+        table->h_taps     = resize_area_count_taps(inHeight, outHeight);
+        table->w_taps     = resize_area_count_taps(inWidth, outWidth);
+        w_stride          = (table->w_taps + 3) & ~3;
+        size_for_h_offset = (outHeight * sizeof(int32_t) + 128 - 1) / 128 * 128;
+        size_for_w_offset = (outWidth * sizeof(int32_t) + 128 - 1) / 128 * 128;
+        size_for_h_coeff  = (outHeight * table->h_taps * sizeof(float) + 128 - 1) / 128 * 128;
+        size_for_w_coeff  = (outWidth * w_stride * sizeof(float) + 128 - 1) / 128 * 128;
+    }
+
+    // a row of every source row summed, then the columns summed or weighted
+    int64_t in_elements = (int64_t)inWidth * channels;
+    table->num_bands    = parallel_num_bands(outHeight, in_elements * inHeight / outHeight, 1);
+    table->row_size     = ((in_elements + RESIZE_AREA_ROW_PADDING) * sizeof(float) + 128 - 1) / 128 * 128;
+    uint64_t size_for_rows = table->row_size * 2 * table->num_bands;
+
+    uint64_t total_size = size_for_h_offset + size_for_w_offset + size_for_h_coeff + size_for_w_coeff + size_for_rows;
+
+    table->buffer = ppl::common::AlignedAlloc(total_size, 128);
+    if (nullptr == table->buffer) {
+        return ppl::common::RC_OUT_OF_MEMORY;
+    }
+    table->h_offset = (int32_t *)table->buffer;
+    table->w_offset = (int32_t *)((unsigned char *)table->h_offset + size_for_h_offset);
+    table->h_coeff  = (unsigned char *)table->w_offset + size_for_w_offset;
+    table->w_coeff  = (unsigned char *)table->h_coeff + size_for_h_coeff;
+    table->rows     = (unsigned char *)table->w_coeff + size_for_w_coeff;
+    // the padding of the rows is read by the column weighting, keep it zero
+    memset(table->rows, 0, size_for_rows);
+
+    if (0 == table->scale_h) {
+        resize_area_calc_taps(inHeight, outHeight, table->h_taps, table->h_taps, table->h_offset, (float *)table->h_coeff);
+        resize_area_calc_taps(inWidth, outWidth, table->w_taps, w_stride, table->w_offset, (float *)table->w_coeff);
+    }
+    return ppl::common::RC_SUCCESS;
+}
+
+::ppl::common::RetCode resize_area_table_create_u8(
+    int32_t inHeight,
+    int32_t inWidth,
+    int32_t channels,
+    int32_t outHeight,
+    int32_t outWidth,
+    ResizeTable *table)
+{
+    if (outHeight > inHeight || outWidth > inWidth) {
+        ::ppl::common::RetCode status = resize_linear_table_create_u8(inHeight, inWidth, channels, outHeight, outWidth, table, true);
+        table->area_linear = true;
+        return status;
+    }
+    return resize_area_table_create(inHeight, inWidth, channels, outHeight, outWidth, true, table);
+}
+
+::ppl::common::RetCode resize_area_table_create_fp32(
+    int32_t inHeight,
+    int32_t inWidth,
+    int32_t channels,
+    int32_t outHeight,
+    int32_t outWidth,
+    ResizeTable *table)
+{
+    if (outHeight > inHeight || outWidth > inWidth) {
+        ::ppl::common::RetCode status = resize_linear_table_create_fp32(inHeight, inWidth, channels, outHeight, outWidth, table, true);
+        table->area_linear = true;
+        return status;
+    }
+    return resize_area_table_create(inHeight, inWidth, channels, outHeight, outWidth, false, table);
+}
+
+// Sums `rows` source rows of `length` elements.
+static void resize_area_box_v_u8(
+    const uint8_t *src,
+    int32_t stride,
+    int32_t rows,
+    int32_t length,
+    bool use_fma,
+    uint16_t *sum)
+{
+    int32_t i = 0;
+    if (use_fma) {
+        i = fma::resize_area_box_v_u8_fma(src, stride, rows, length, sum);
+    }
+
+    __m128i m_zero = _mm_setzero_si128();
+    for (; i <= length - 16; i += 16) {
+        __m128i m_sum_0 = _mm_setzero_si128();
+        __m128i m_sum_1 = _mm_setzero_si128();
+        for (int32_t r = 0; r < rows; ++r) {
+            __m128i m_data = _mm_loadu_si128((const __m128i *)(src + r * stride + i));
+            m_sum_0        = _mm_add_epi16(m_sum_0, _mm_unpacklo_epi8(m_data, m_zero));
+            m_sum_1        = _mm_add_epi16(m_sum_1, _mm_unpackhi_epi8(m_data, m_zero));
+        }
+        _mm_storeu_si128((__m128i *)(sum + i + 0), m_sum_0);
+        _mm_storeu_si128((__m128i *)(sum + i + 8), m_sum_1);
+    }
+    for (; i < length; ++i) {
+        int32_t value = 0;
+        for (int32_t r = 0; r < rows; ++r) {
+            value += src[r * stride + i];
+        }
+        sum[i] = value;
+    }
+}
+
+static void resize_area_box_v_fp32(
+    const float *src,
+    int32_t stride,
+    int32_t rows,
+    int32_t length,
+    float *sum)
+{
+    int32_t i = 0;
+    for (; i <= length - 8; i += 8) {
+        __m128 m_sum_0 = _mm_loadu_ps(src + i + 0);
+        __m128 m_sum_1 = _mm_loadu_ps(src + i + 4);
+        for (int32_t r = 1; r < rows; ++r) {
+            m_sum_0 = _mm_add_ps(m_sum_0, _mm_loadu_ps(src + r * stride + i + 0));
+            m_sum_1 = _mm_add_ps(m_sum_1, _mm_loadu_ps(src + r * stride + i + 4));
+        }
+        _mm_storeu_ps(sum + i + 0, m_sum_0);
+        _mm_storeu_ps(sum + i + 4, m_sum_1);
+    }
+    for (; i < length; ++i) {
+        float value = src[i];
+        for (int32_t r = 1; r < rows; ++r) {
+            value += src[r * stride + i];
+        }
+        sum[i] = value;
+    }
+}
+
+// Adds every pair of neighbouring pixels: dst pixel j is src pixel 2j plus
+// src pixel 2j + 1. `length` is the number of dst elements.
+static void resize_area_fold2_u16(
+    const uint16_t *src,
+    int32_t channels,
+    int32_t length,
+    uint16_t *dst)
+{
+    int32_t i = 0;
+    if (1 == channels) {
+        for (; i <= length - 8; i += 8) {
+            __m128i m_data_0 = _mm_loadu_si128((const __m128i *)(src + i * 2 + 0));
+            __m128i m_data_1 = _mm_loadu_si128((const __m128i *)(src + i * 2 + 8));
+            _mm_storeu_si128((__m128i *)(dst + i), _mm_hadd_epi16(m_data_0, m_data_1));
+        }
+    } else if (3 == channels) {
+        // s, t and u hold the sums of the elements 3 apart, of which the
+        // ones of even pixels are gathered into the 12 dst elements
+        __m128i m_s  = _mm_setr_epi8(0, 1, 2, 3, 4, 5, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1);
+        __m128i m_t0 = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 0, 1, 8, 9, 10, 11);
+        __m128i m_t1 = _mm_setr_epi8(12, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+        __m128i m_u  = _mm_setr_epi8(-1, -1, 4, 5, 6, 7, 8, 9, -1, -1, -1, -1, -1, -1, -1, -1);
+        for (; i <= length - 12; i += 12) {
+            const uint16_t *p = src + i * 2;
+            __m128i m_sum_s   = _mm_add_epi16(_mm_loadu_si128((const __m128i *)(p + 0)), _mm_loadu_si128((const __m128i *)(p + 3)));
+            __m128i m_sum_t   = _mm_add_epi16(_mm_loadu_si128((const __m128i *)(p + 8)), _mm_loadu_si128((const __m128i *)(p + 11)));
+            __m128i m_sum_u   = _mm_add_epi16(_mm_loadu_si128((const __m128i *)(p + 16)), _mm_loadu_si128((const __m128i *)(p + 19)));
+            __m128i m_dst_0   = _mm_or_si128(_mm_shuffle_epi8(m_sum_s, m_s), _mm_shuffle_epi8(m_sum_t, m_t0));
+            __m128i m_dst_1   = _mm_or_si128(_mm_shuffle_epi8(m_sum_t, m_t1), _mm_shuffle_epi8(m_sum_u, m_u));
+            _mm_storeu_si128((__m128i *)(dst + i), m_dst_0);
+            _mm_storel_epi64((__m128i *)(dst + i + 8), m_dst_1);
+        }
+    } else if (4 == channels) {
+        for (; i <= length - 8; i += 8) {
+            __m128i m_data_0 = _mm_loadu_si128((const __m128i *)(src + i * 2 + 0));
+            __m128i m_data_1 = _mm_loadu_si128((const __m128i *)(src + i * 2 + 8));
+            _mm_storeu_si128((__m128i *)(dst + i), _mm_add_epi16(_mm_unpacklo_epi64(m_data_0, m_data_1), _mm_unpackhi_epi64(m_data_0, m_data_1)));
+        }
+    }
+    for (; i < length; ++i) {
+        int32_t pixel = i / channels * 2 * channels + i % channels;
+        dst[i]        = src[pixel] + src[pixel + channels];
+    }
+}
+
+static void resize_area_fold2_fp32(
+    const float *src,
+    int32_t channels,
+    int32_t length,
+    float *dst)
+{
+    int32_t i = 0;
+    if (1 == channels) {
+        for (; i <= length - 4; i += 4) {
+            _mm_storeu_ps(dst + i, _mm_hadd_ps(_mm_loadu_ps(src + i * 2 + 0), _mm_loadu_ps(src + i * 2 + 4)));
+        }
+    } else {
+        // the fourth lane of a 3 channel pixel is overwritten by the next one
+        for (; i <= length - 4; i += channels) {
+            _mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(src + i * 2), _mm_loadu_ps(src + i * 2 + channels)));
+        }
+    }
+    for (; i < length; ++i) {
+        int32_t pixel = i / channels * 2 * channels + i % channels;
+        dst[i]        = src[pixel] + src[pixel + channels];
+    }
+}
+
+// Adds every `factor` neighbouring pixels, for the odd factors left after
+// folding by 2. `width` is the number of dst pixels.
+template <typename T, int32_t channels>
+static void resize_area_fold_c(
+    const T *src,
+    int32_t factor,
+    int32_t width,
+    T *dst)
+{
+    for (int32_t w = 0; w < width; ++w, dst += channels) {
+        for (int32_t c = 0; c < channels; ++c) {
+            dst[c] = src[c];
+        }
+        src += channels;
+        for (int32_t k = 1; k < factor; ++k, src += channels) {
+            for (int32_t c = 0; c < channels; ++c) {
+                dst[c] += src[c];
+            }
+        }
+    }
+}
+
+template <typename T>
+static void resize_area_fold(
+    const T *src,
+    int32_t channels,
+    int32_t factor,
+    int32_t width,
+    T *dst)
+{
+    if (1 == channels) {
+        resize_area_fold_c<T, 1>(src, factor, width, dst);
+    } else if (3 == channels) {
+        resize_area_fold_c<T, 3>(src, factor, width, dst);
+    } else {
+        resize_area_fold_c<T, 4>(src, factor, width, dst);
+    }
+}
+
+static void resize_area_box_store_u8(
+    const uint16_t *sum,
+    int32_t length,
+    int32_t area,
+    uint8_t *dst)
+{
+    int32_t i = 0;
+    if (4 == area) { // the 2x2 box rounds halves up, as OpenCV does
+        __m128i m_two = _mm_set1_epi16(2);
+        for (; i <= length - 16; i += 16) {
+            __m128i m_sum_0 = _mm_srli_epi16(_mm_add_epi16(_mm_loadu_si128((const __m128i *)(sum + i + 0)), m_two), 2);
+            __m128i m_sum_1 = _mm_srli_epi16(_mm_add_epi16(_mm_loadu_si128((const __m128i *)(sum + i + 8)), m_two), 2);
+            _mm_storeu_si128((__m128i *)(dst + i), _mm_packus_epi16(m_sum_0, m_sum_1));
+        }
+        for (; i < length; ++i) {
+            dst[i] = (sum[i] + 2) >> 2;
+        }
+        return;
+    }
+
+    float scale     = 1.0f / area;
+    __m128 m_scale  = _mm_set1_ps(scale);
+    __m128i m_zero  = _mm_setzero_si128();
+    for (; i <= length - 16; i += 16) {
+        __m128i m_sum_0 = _mm_loadu_si128((const __m128i *)(sum + i + 0));
+        __m128i m_sum_1 = _mm_loadu_si128((const __m128i *)(sum + i + 8));
+        __m128i m_dst_0 = _mm_cvtps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(m_sum_0, m_zero)), m_scale));
+        __m128i m_dst_1 = _mm_cvtps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(m_sum_0, m_zero)), m_scale));
+        __m128i m_dst_2 = _mm_cvtps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(m_sum_1, m_zero)), m_scale));
+        __m128i m_dst_3 = _mm_cvtps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(m_sum_1, m_zero)), m_scale));
+        _mm_storeu_si128((__m128i *)(dst + i), _mm_packus_epi16(_mm_packs_epi32(m_dst_0, m_dst_1), _mm_packs_epi32(m_dst_2, m_dst_3)));
+    }
+    for (; i < length; ++i) {
+        dst[i] = resize_area_saturate_u8(resize_area_round(sum[i] * scale));
+    }
+}
+
+static void resize_area_box_store_fp32(
+    const float *sum,
+    int32_t length,
+    int32_t area,
+    float *dst)
+{
+    float scale    = 1.0f / area;
+    __m128 m_scale = _mm_set1_ps(scale);
+    int32_t i      = 0;
+    for (; i <= length - 4; i += 4) {
+        _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_loadu_ps(sum + i), m_scale));
+    }
+    for (; i < length; ++i) {
+        dst[i] = sum[i] * scale;
+    }
+}
+
+// Weights source rows `taps` rows from src into one float row.
+static void resize_area_v_u8(
+    const uint8_t *src,
+    int32_t stride,
+    const float *coeff,
+    int32_t taps,
+    int32_t length,
+    bool use_fma,
+    float *row)
+{
+    int32_t i = 0;
+    if (use_fma) {
+        i = fma::resize_area_v_u8_fma(src, stride, coeff, taps, length, row);
+    }
+
+    for (; i <= length - 16; i += 16) {
+        __m128 m_sum_0 = _mm_setzero_ps();
+        __m128 m_sum_1 = _mm_setzero_ps();
+        __m128 m_sum_2 = _mm_setzero_ps();
+        __m128 m_sum_3 = _mm_setzero_ps();
+        for (int32_t t = 0; t < taps; ++t) {
+            if (0 == coeff[t]) {
+                continue;
+            }
+            __m128 m_coeff = _mm_set1_ps(coeff[t]);
+            __m128i m_data = _mm_loadu_si128((const __m128i *)(src + t * stride + i));
+            m_sum_0        = _mm_add_ps(m_sum_0, _mm_mul_ps(_mm_cvtepi32_ps(_mm_cvtepu8_epi32(m_data)), m_coeff));
+            m_sum_1        = _mm_add_ps(m_sum_1, _mm_mul_ps(_mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_srli_si128(m_data, 4))), m_coeff));
+            m_sum_2        = _mm_add_ps(m_sum_2, _mm_mul_ps(_mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_srli_si128(m_data, 8))), m_coeff));
+            m_sum_3        = _mm_add_ps(m_sum_3, _mm_mul_ps(_mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_srli_si128(m_data, 12))), m_coeff));
+        }
+        _mm_storeu_ps(row + i + 0, m_sum_0);
+        _mm_storeu_ps(row + i + 4, m_sum_1);
+        _mm_storeu_ps(row + i + 8, m_sum_2);
+        _mm_storeu_ps(row + i + 12, m_sum_3);
+    }
+    for (; i < length; ++i) {
+        float value = 0;
+        for (int32_t t = 0; t < taps; ++t) {
+            value += src[t * stride + i] * coeff[t];
+        }
+        row[i] = value;
+    }
+}
+
+static void resize_area_v_fp32(
+    const float *src,
+    int32_t stride,
+    const float *coeff,
+    int32_t taps,
+    int32_t length,
+    bool use_fma,
+    float *row)
+{
+    int32_t i = 0;
+    if (use_fma) {
+        i = fma::resize_area_v_fp32_fma(src, stride, coeff, taps, length, row);
+    }
+
+    for (; i <= length - 8; i += 8) {
+        __m128 m_sum_0 = _mm_setzero_ps();
+        __m128 m_sum_1 = _mm_setzero_ps();
+        for (int32_t t = 0; t < taps; ++t) {
+            if (0 == coeff[t]) {
+                continue;
+            }
+            __m128 m_coeff = _mm_set1_ps(coeff[t]);
+            m_sum_0        = _mm_add_ps(m_sum_0, _mm_mul_ps(_mm_loadu_ps(src + t * stride + i + 0), m_coeff));
+            m_sum_1        = _mm_add_ps(m_sum_1, _mm_mul_ps(_mm_loadu_ps(src + t * stride + i + 4), m_coeff));
+        }
+        _mm_storeu_ps(row + i + 0, m_sum_0);
+        _mm_storeu_ps(row + i + 4, m_sum_1);
+    }
+    for (; i < length; ++i) {
+        float value = 0;
+        for (int32_t t = 0; t < taps; ++t) {
+            value += src[t * stride + i] * coeff[t];
+        }
+        row[i] = value;
+    }
+}
+
+// Weights the columns of a vertically weighted row. The tables of the
+// columns have `stride` taps, a multiple of 4 padded with zero weights that
+// read the zeroed padding of the row.
+static void resize_area_h(
+    const float *row,
+    int32_t channels,
+    int32_t outWidth,
+    const int32_t *offset,
+    const float *coeff,
+    int32_t taps,
+    int32_t stride,
+    float *dst)
+{
+    int32_t w = 0;
+    if (1 == channels) {
+        for (; w <= outWidth - 4; w += 4) {
+            __m128 m_sum[4];
+            for (int32_t j = 0; j < 4; ++j) {
+                const float *p = row + offset[w + j];
+                const float *c = coeff + (w + j) * stride;
+                m_sum[j]       = _mm_mul_ps(_mm_loadu_ps(p), _mm_loadu_ps(c));
+                for (int32_t t = 4; t < stride; t += 4) {
+                    m_sum[j] = _mm_add_ps(m_sum[j], _mm_mul_ps(_mm_loadu_ps(p + t), _mm_loadu_ps(c + t)));
+                }
+            }
+            _mm_storeu_ps(dst + w, _mm_hadd_ps(_mm_hadd_ps(m_sum[0], m_sum[1]), _mm_hadd_ps(m_sum[2], m_sum[3])));
+        }
+        for (; w < outWidth; ++w) {
+            float value = 0;
+            for (int32_t t = 0; t < taps; ++t) {
+                value += row[offset[w] + t] * coeff[w * stride + t];
+            }
+            dst[w] = value;
+        }
+        return;
+    }
+
+    // the fourth lane of a 3 channel pixel is overwritten by the next one
+    for (; w < outWidth; ++w) {
+        const float *p = row + offset[w] * channels;
+        const float *c = coeff + w * stride;
+        __m128 m_sum   = _mm_mul_ps(_mm_loadu_ps(p), _mm_set1_ps(c[0]));
+        for (int32_t t = 1; t < taps; ++t) {
+            m_sum = _mm_add_ps(m_sum, _mm_mul_ps(_mm_loadu_ps(p + t * channels), _mm_set1_ps(c[t])));
+        }
+        _mm_storeu_ps(dst + w * channels, m_sum);
+    }
+}
+
+static void resize_area_store_u8(
+    const float *row,
+    int32_t length,
+    uint8_t *dst)
+{
+    int32_t i = 0;
+    for (; i <= length - 16; i += 16) {
+        __m128i m_dst_0 = _mm_cvtps_epi32(_mm_loadu_ps(row + i + 0));
+        __m128i m_dst_1 = _mm_cvtps_epi32(_mm_loadu_ps(row + i + 4));
+        __m128i m_dst_2 = _mm_cvtps_epi32(_mm_loadu_ps(row + i + 8));
+        __m128i m_dst_3 = _mm_cvtps_epi32(_mm_loadu_ps(row + i + 12));
+        _mm_storeu_si128((__m128i *)(dst + i), _mm_packus_epi16(_mm_packs_epi32(m_dst_0, m_dst_1), _mm_packs_epi32(m_dst_2, m_dst_3)));
+    }
+    for (; i < length; ++i) {
+        dst[i] = resize_area_saturate_u8(resize_area_round(row[i]));
+    }
+}
+
+static void resize_area_store_fp32(
+    const float *row,
+    int32_t length,
+    float *dst)
+{
+    memcpy(dst, row, length * sizeof(float));
+}
+
+// overloads picking the kernels of each data type
+static inline void resize_area_box_v(const uint8_t *src, int32_t stride, int32_t rows, int32_t length, bool use_fma, uint16_t *sum)
+{
+    resize_area_box_v_u8(src, stride, rows, length, use_fma, sum);
+}
+static inline void resize_area_box_v(const float *src, int32_t stride, int32_t rows, int32_t length, bool, float *sum)
+{
+    resize_area_box_v_fp32(src, stride, rows, length, sum);
+}
+static inline void resize_area_fold2(const uint16_t *src, int32_t channels, int32_t length, uint16_t *dst)
+{
+    resize_area_fold2_u16(src, channels, length, dst);
+}
+static inline void resize_area_fold2(const float *src, int32_t channels, int32_t length, float *dst)
+{
+    resize_area_fold2_fp32(src, channels, length, dst);
+}
+static inline void resize_area_box_store(const uint16_t *sum, int32_t length, int32_t area, uint8_t *dst)
+{
+    resize_area_box_store_u8(sum, length, area, dst);
+}
+static inline void resize_area_box_store(const float *sum, int32_t length, int32_t area, float *dst)
+{
+    resize_area_box_store_fp32(sum, length, area, dst);
+}
+static inline void resize_area_v(const uint8_t *src, int32_t stride, const float *coeff, int32_t taps, int32_t length, bool use_fma, float *row)
+{
+    resize_area_v_u8(src, stride, coeff, taps, length, use_fma, row);
+}
+static inline void resize_area_v(const float *src, int32_t stride, const float *coeff, int32_t taps, int32_t length, bool use_fma, float *row)
+{
+    resize_area_v_fp32(src, stride, coeff, taps, length, use_fma, row);
+}
+static inline void resize_area_store(const float *row, int32_t length, uint8_t *dst)
+{
+    resize_area_store_u8(row, length, dst);
+}
+static inline void resize_area_store(const float *row, int32_t length, float *dst)
+{
+    resize_area_store_fp32(row, length, dst);
+}
+
+// Box filters output rows [begin, end) by integer factors, with two row
+// buffers of the band. The source rows are summed first, then the pixels of
+// the summed row are folded by 2 while the factor is even.
+template <typename T, typename TSum>
+static void resize_area_box_rows(
+    const ResizeTable &table,
+    int32_t inWidthStride,
+    const T *inData,
+    int32_t outWidthStride,
+    T *outData,
+    TSum *row_0,
+    TSum *row_1,
+    int32_t begin,
+    int32_t end)
+{
+    int32_t channels = table.channels;
+    int32_t scale_h  = table.scale_h;
+    int32_t area     = table.scale_h * table.scale_w;
+    for (int32_t h = begin; h < end; ++h) {
+        const T *src = inData + h * scale_h * inWidthStride;
+        TSum *cur    = row_0;
+        TSum *next   = row_1;
+        int32_t width   = table.inWidth;
+        int32_t factor  = table.scale_w;
+        resize_area_box_v(src, inWidthStride, scale_h, width * channels, table.use_fma, cur);
+        for (; factor % 2 == 0; factor /= 2) {
+            width /= 2;
+            resize_area_fold2(cur, channels, width * channels, next);
+            std::swap(cur, next);
+        }
+        if (factor > 1) {
+            width /= factor;
+            resize_area_fold(cur, channels, factor, width, next);
+            std::swap(cur, next);
+        }
+        resize_area_box_store(cur, width * channels, area, outData + h * outWidthStride);
+    }
+}
+
+// Weights the source pixels of output rows [begin, end) by the tables, with
+// two row buffers of the band.
+template <typename T>
+static void resize_area_rows(
+    const ResizeTable &table,
+    int32_t inWidthStride,
+    const T *inData,
+    int32_t outWidthStride,
+    T *outData,
+    float *row_0,
+    float *row_1,
+    int32_t begin,
+    int32_t end)
+{
+    int32_t channels     = table.channels;
+    int32_t w_stride     = (table.w_taps + 3) & ~3;
+    const float *h_coeff = (const float *)table.h_coeff;
+    const float *w_coeff = (const float *)table.w_coeff;
+    for (int32_t h = begin; h < end; ++h) {
+        const T *src = inData + table.h_offset[h] * inWidthStride;
+        resize_area_v(src, inWidthStride, h_coeff + h * table.h_taps, table.h_taps, table.inWidth * channels, table.use_fma, row_0);
+        resize_area_h(row_0, channels, table.outWidth, table.w_offset, w_coeff, table.w_taps, w_stride, row_1);
+        resize_area_store(row_1, table.outWidth * channels, outData + h * outWidthStride);
+    }
+}
+
+template <typename T, typename TSum>
+static void resize_area_run(
+    const ResizeTable &table,
+    int32_t inWidthStride,
+    const T *inData,
+    int32_t outWidthStride,
+    T *outData)
+{
+    int64_t in_elements = (int64_t)table.inWidth * table.channels;
+
+    // bands take the row buffers in the order they start
+    std::atomic<int32_t> next_band(0);
+    parallel_for_rows(table.outHeight, in_elements * table.inHeight / table.outHeight, [&](int32_t begin, int32_t end) {
+        unsigned char *row_0 = (unsigned char *)table.rows + table.row_size * 2 * next_band.fetch_add(1);
+        unsigned char *row_1 = row_0 + table.row_size;
+        if (0 != table.scale_h) {
+            resize_area_box_rows<T, TSum>(table, inWidthStride, inData, outWidthStride, outData, (TSum *)row_0, (TSum *)row_1, begin, end);
+        } else {
+            resize_area_rows<T>(table, inWidthStride, inData, outWidthStride, outData, (float *)row_0, (float *)row_1, begin, end);
+        }
+    }, 1, table.num_bands);
+}
+
+void resize_area_run_u8(
+    const ResizeTable &table,
+    int32_t inWidthStride,
+    const uint8_t *inData,
+    int32_t outWidthStride,
+    uint8_t *outData)
+{
+    if (table.area_linear) {
+        resize_linear_run_u8(table, inWidthStride, inData, outWidthStride, outData);
+        return;
+    }
+    resize_area_run<uint8_t, uint16_t>(table, inWidthStride, inData, outWidthStride, outData);
+}
+
+void resize_area_run_fp32(
+    const ResizeTable &table,
+    int32_t inWidthStride,
+    const float *inData,
+    int32_t outWidthStride,
+    float *outData)
+{
+    if (table.area_linear) {
+        resize_linear_run_fp32(table, inWidthStride, inData, outWidthStride, outData);
+        return;
+    }
+    resize_area_run<float, float>(table, inWidthStride, inData, outWidthStride, outData);
+}
+
+static ::ppl::common::RetCode resize_area_u8(
+    int32_t inHeight,
+    int32_t inWidth,
+    int32_t inWidthStride,
+    const uint8_t *inData,
+    int32_t channels,
+    int32_t outHeight,
+    int32_t outWidth,
+    int32_t outWidthStride,
+    uint8_t *outData)
+{
+    if (nullptr == inData) {
+        return ppl::common::RC_INVALID_VALUE;
+    }
+    if (nullptr == outData) {
+        return ppl::common::RC_INVALID_VALUE;
+    }
+    if (inHeight <= 0 || inWidth <= 0 || outHeight <= 0 || outWidth <= 0) {
+        return ppl::common::RC_INVALID_VALUE;
+    }
+
+    ResizeTable table;
+    ::ppl::common::RetCode status = resize_area_table_create_u8(inHeight, inWidth, channels, outHeight, outWidth, &table);
+    if (ppl::common::RC_SUCCESS != status) {
+        return status;
+    }
+    resize_area_run_u8(table, inWidthStride, inData, outWidthStride, outData);
+    resize_table_destroy(&table);
+
+    return ppl::common::RC_SUCCESS;
+}
+
+static ::ppl::common::RetCode resize_area_fp32(
+    int32_t inHeight,
+    int32_t inWidth,
+    int32_t inWidthStride,
+    const float *inData,
+    int32_t channels,
+    int32_t outHeight,
+    int32_t outWidth,
+    int32_t outWidthStride,
+    float *outData)
+{
+    if (nullptr == inData) {
+        return ppl::common::RC_INVALID_VALUE;
+    }
+    if (nullptr == outData) {
+        return ppl::common::RC_INVALID_VALUE;
+    }
+    if (inHeight <= 0 || inWidth <= 0 || outHeight <= 0 || outWidth <= 0) {
+        return ppl::common::RC_INVALID_VALUE;
+    }
+
+    ResizeTable table;
+    ::ppl::common::RetCode status = resize_area_table_create_fp32(inHeight, inWidth, channels, outHeight, outWidth, &table);
+    if (ppl::common::RC_SUCCESS != status) {
+        return status;
+    }
+    resize_area_run_fp32(table, inWidthStride, inData, outWidthStride, outData);
+    resize_table_destroy(&table);
+
+    return ppl::common::RC_SUCCESS;
+}
+
+template <>
+::ppl::common::RetCode ResizeArea<uint8_t, 1>(
+    int32_t inHeight,
+    int32_t inWidth,
+    int32_t inWidthStride,
+    const uint8_t *inData,
+    int32_t outHeight,
+    int32_t outWidth,
+    int32_t outWidthStride,
+    uint8_t *outData)
+{
+    return resize_area_u8(
+        inHeight, inWidth, inWidthStride, inData, 1, outHeight, outWidth, outWidthStride, outData);
+}
+
+template <>
+::ppl::common::RetCode ResizeArea<uint8_t, 3>(
+    int32_t inHeight,
+    int32_t inWidth,
+    int32_t inWidthStride,
+    const uint8_t *inData,
+    int32_t outHeight,
+    int32_t outWidth,
+    int32_t outWidthStride,
+    uint8_t *outData)
+{
+    return resize_area_u8(
+        inHeight, inWidth, inWidthStride, inData, 3, outHeight, outWidth, outWidthStride, outData);
+}
+
+template <>
+::ppl::common::RetCode ResizeArea<uint8_t, 4>(
+    int32_t inHeight,
+    int32_t inWidth,
+    int32_t inWidthStride,
+    const uint8_t *inData,
+    int32_t outHeight,
+    int32_t outWidth,
+    int32_t outWidthStride,
+    uint8_t *outData)
+{
+    return resize_area_u8(
+        inHeight, inWidth, inWidthStride, inData, 4, outHeight, outWidth, outWidthStride, outData);
+}
+
+template <>
+::ppl::common::RetCode ResizeArea<float, 1>(
+    int32_t inHeight,
+    int32_t inWidth,
+    int32_t inWidthStride,
+    const float *inData,
+    int32_t outHeight,
+    int32_t outWidth,
+    int32_t outWidthStride,
+    float *outData)
+{
+    return resize_area_fp32(
+        inHeight, inWidth, inWidthStride, inData, 1, outHeight, outWidth, outWidthStride, outData);
+}
+
+template <>
+::ppl::common::RetCode ResizeArea<float, 3>(
+    int32_t inHeight,
+    int32_t inWidth,
+    int32_t inWidthStride,
+    const float *inData,
+    int32_t outHeight,
+    int32_t outWidth,
+    int32_t outWidthStride,
+    float *outData)
+{
+    return resize_area_fp32(
+        inHeight, inWidth, inWidthStride, inData, 3, outHeight, outWidth, outWidthStride, outData);
+}
+
+template <>
+::ppl::common::RetCode ResizeArea<float, 4>(
+    int32_t inHeight,
+    int32_t inWidth,
+    int32_t inWidthStride,
+    const float *inData,
+    int32_t outHeight,
+    int32_t outWidth,
+    int32_t outWidthStride,
+    float *outData)
+{
+    return resize_area_fp32(
+        inHeight, inWidth, inWidthStride, inData, 4, outHeight, outWidth, outWidthStride, outData);
+}
+
+}
+}
+} // namespace ppl::cv::x86
@@ -65,6 +65,16 @@ public:
                                                           this->outWidth * channels,
                                                           this->dev_oImage);
         }
+        else if (mode == ppl::cv::INTERPOLATION_AREA) {
+            ppl::cv::x86::ResizeArea<T, channels>(this->inHeight,
+                                                  this->inWidth,
+                                                  this->inWidth * channels,
+                                                  this->dev_iImage,
+                                                  this->outHeight,
+                                                  this->outWidth,
+                                                  this->outWidth * channels,
+                                                  this->dev_oImage);
+        }
     }
 
     void apply_opencv() {
@@ -81,6 +91,12 @@ public:
 
             cv::resize(src_opencv, dst_opencv, cv::Size(outWidth, outHeight), 0, 0,cv::INTER_NEAREST);
         }
+        else if (mode == ppl::cv::INTERPOLATION_AREA) {
+            cv::Mat src_opencv(inHeight, inWidth, CV_MAKETYPE(cv::DataType<T>::depth, channels), dev_iImage);
+            cv::Mat dst_opencv(outHeight, outWidth, CV_MAKETYPE(cv::DataType<T>::depth, channels), dev_oImage);
+
+            cv::resize(src_opencv, dst_opencv, cv::Size(outWidth, outHeight), 0, 0,cv::INTER_AREA);
+        }
     }
 
     ~ResizeBenchmark() {
@@ -110,9 +126,22 @@ static void BM_Resize_opencv_x86(benchmark::State &state) {
     state.SetItemsProcessed(state.iterations());
 }
 
+// the tables, dispatch and row buffers are set up once for the whole stream
+template<typename T, int32_t channels, int32_t mode>
+static void BM_ResizePlan_ppl_x86(benchmark::State &state) {
+    ResizeBenchmark<T, channels, mode> bm(state.range(0), state.range(1), state.range(2), state.range(3));
+    ppl::cv::x86::ResizePlan<T, channels> plan;
+    plan.Init(bm.inHeight, bm.inWidth, bm.outHeight, bm.outWidth, (ppl::cv::InterpolationType)mode);
+    for (auto _: state) {
+        plan.Apply(bm.inWidth * channels, bm.dev_iImage, bm.outWidth * channels, bm.dev_oImage);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
 using namespace ppl::cv::debug;
 using ppl::cv::INTERPOLATION_LINEAR;
 using ppl::cv::INTERPOLATION_NEAREST_POINT;
+using ppl::cv::INTERPOLATION_AREA;
 BENCHMARK_TEMPLATE(BM_Resize_ppl_x86, float, c1, INTERPOLATION_LINEAR)->Args({320, 240, 640, 480})->Args({640, 480, 320, 240})->Args({1280, 720, 800, 600})->Args({800, 600, 1280, 720});
 BENCHMARK_TEMPLATE(BM_Resize_opencv_x86, float, c1, INTERPOLATION_LINEAR)->Args({320, 240, 640, 480})->Args({640, 480, 320, 240})->Args({1280, 720, 800, 600})->Args({800, 600, 1280, 720});
 BENCHMARK_TEMPLATE(BM_Resize_ppl_x86, float, c3, INTERPOLATION_LINEAR)->Args({320, 240, 640, 480})->Args({640, 480, 320, 240})->Args({1280, 720, 800, 600})->Args({800, 600, 1280, 720});
@@ -138,3 +167,24 @@ BENCHMARK_TEMPLATE(BM_Resize_ppl_x86, uint8_t, c3, INTERPOLATION_NEAREST_POINT)-
 BENCHMARK_TEMPLATE(BM_Resize_opencv_x86, uint8_t, c3, INTERPOLATION_NEAREST_POINT)->Args({320, 240, 640, 480})->Args({640, 480, 320, 240})->Args({1280, 720, 800, 600})->Args({800, 600, 1280, 720});
 BENCHMARK_TEMPLATE(BM_Resize_ppl_x86, uint8_t, c4, INTERPOLATION_NEAREST_POINT)->Args({320, 240, 640, 480})->Args({640, 480, 320, 240})->Args({1280, 720, 800, 600})->Args({800, 600, 1280, 720});
 BENCHMARK_TEMPLATE(BM_Resize_opencv_x86, uint8_t, c4, INTERPOLATION_NEAREST_POINT)->Args({320, 240, 640, 480})->Args({640, 480, 320, 240})->Args({1280, 720, 800, 600})->Args({800, 600, 1280, 720});
+
+BENCHMARK_TEMPLATE(BM_Resize_ppl_x86, uint8_t, c3, INTERPOLATION_LINEAR)->Args({1920, 1080, 640, 360})->Args({1920, 1080, 320, 180})->Args({640, 360, 1920, 1080});
+BENCHMARK_TEMPLATE(BM_ResizePlan_ppl_x86, uint8_t, c3, INTERPOLATION_LINEAR)->Args({1920, 1080, 640, 360})->Args({1920, 1080, 320, 180})->Args({640, 360, 1920, 1080});
+BENCHMARK_TEMPLATE(BM_Resize_ppl_x86, uint8_t, c3, INTERPOLATION_NEAREST_POINT)->Args({1920, 1080, 640, 360})->Args({1920, 1080, 320, 180})->Args({640, 360, 1920, 1080});
+BENCHMARK_TEMPLATE(BM_ResizePlan_ppl_x86, uint8_t, c3, INTERPOLATION_NEAREST_POINT)->Args({1920, 1080, 640, 360})->Args({1920, 1080, 320, 180})->Args({640, 360, 1920, 1080});
+BENCHMARK_TEMPLATE(BM_Resize_ppl_x86, float, c3, INTERPOLATION_LINEAR)->Args({1920, 1080, 640, 360})->Args({1920, 1080, 320, 180})->Args({640, 360, 1920, 1080});
+BENCHMARK_TEMPLATE(BM_ResizePlan_ppl_x86, float, c3, INTERPOLATION_LINEAR)->Args({1920, 1080, 640, 360})->Args({1920, 1080, 320, 180})->Args({640, 360, 1920, 1080});
+
+BENCHMARK_TEMPLATE(BM_Resize_ppl_x86, uint8_t, c1, INTERPOLATION_AREA)->Args({1920, 1080, 960, 540})->Args({1920, 1080, 480, 270})->Args({1920, 1080, 640, 360})->Args({1920, 1080, 1280, 720});
+BENCHMARK_TEMPLATE(BM_Resize_opencv_x86, uint8_t, c1, INTERPOLATION_AREA)->Args({1920, 1080, 960, 540})->Args({1920, 1080, 480, 270})->Args({1920, 1080, 640, 360})->Args({1920, 1080, 1280, 720});
+BENCHMARK_TEMPLATE(BM_Resize_ppl_x86, uint8_t, c3, INTERPOLATION_AREA)->Args({1920, 1080, 960, 540})->Args({1920, 1080, 480, 270})->Args({1920, 1080, 640, 360})->Args({1920, 1080, 1280, 720});
+BENCHMARK_TEMPLATE(BM_Resize_opencv_x86, uint8_t, c3, INTERPOLATION_AREA)->Args({1920, 1080, 960, 540})->Args({1920, 1080, 480, 270})->Args({1920, 1080, 640, 360})->Args({1920, 1080, 1280, 720});
+BENCHMARK_TEMPLATE(BM_Resize_ppl_x86, uint8_t, c4, INTERPOLATION_AREA)->Args({1920, 1080, 960, 540})->Args({1920, 1080, 480, 270})->Args({1920, 1080, 640, 360})->Args({1920, 1080, 1280, 720});
+BENCHMARK_TEMPLATE(BM_Resize_opencv_x86, uint8_t, c4, INTERPOLATION_AREA)->Args({1920, 1080, 960, 540})->Args({1920, 1080, 480, 270})->Args({1920, 1080, 640, 360})->Args({1920, 1080, 1280, 720});
+BENCHMARK_TEMPLATE(BM_Resize_ppl_x86, float, c1, INTERPOLATION_AREA)->Args({1920, 1080, 960, 540})->Args({1920, 1080, 480, 270})->Args({1920, 1080, 640, 360})->Args({1920, 1080, 1280, 720});
+BENCHMARK_TEMPLATE(BM_Resize_opencv_x86, float, c1, INTERPOLATION_AREA)->Args({1920, 1080, 960, 540})->Args({1920, 1080, 480, 270})->Args({1920, 1080, 640, 360})->Args({1920, 1080, 1280, 720});
+BENCHMARK_TEMPLATE(BM_Resize_ppl_x86, float, c3, INTERPOLATION_AREA)->Args({1920, 1080, 960, 540})->Args({1920, 1080, 480, 270})->Args({1920, 1080, 640, 360})->Args({1920, 1080, 1280, 720});
+BENCHMARK_TEMPLATE(BM_Resize_opencv_x86, float, c3, INTERPOLATION_AREA)->Args({1920, 1080, 960, 540})->Args({1920, 1080, 480, 270})->Args({1920, 1080, 640, 360})->Args({1920, 1080, 1280, 720});
+BENCHMARK_TEMPLATE(BM_Resize_ppl_x86, float, c4, INTERPOLATION_AREA)->Args({1920, 1080, 960, 540})->Args({1920, 1080, 480, 270})->Args({1920, 1080, 640, 360})->Args({1920, 1080, 1280, 720});
+BENCHMARK_TEMPLATE(BM_Resize_opencv_x86, float, c4, INTERPOLATION_AREA)->Args({1920, 1080, 960, 540})->Args({1920, 1080, 480, 270})->Args({1920, 1080, 640, 360})->Args({1920, 1080, 1280, 720});
+BENCHMARK_TEMPLATE(BM_ResizePlan_ppl_x86, uint8_t, c3, INTERPOLATION_AREA)->Args({1920, 1080, 960, 540})->Args({1920, 1080, 480, 270})->Args({1920, 1080, 640, 360})->Args({1920, 1080, 1280, 720});
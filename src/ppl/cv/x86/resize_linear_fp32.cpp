@@ -21,6 +21,7 @@
 #include "ppl/common/sys.h"
 #include "ppl/common/retcode.h"
 #include "ppl/common/x86/sysinfo.h"
+#include "ppl/cv/x86/isa.hpp"
 
 #include <string.h>
 #include <limits.h>
@@ -28,8 +29,12 @@
 #include <float.h>
 #include <stdint.h>
 #include <math.h>
+#include <atomic>
 
 #include "ppl/cv/x86/fma/internal_fma.hpp"
+#include "ppl/cv/x86/avx512/internal_avx512.hpp"
+#include "ppl/cv/x86/parallel.hpp"
+#include "ppl/cv/x86/resize.hpp"
 
 namespace ppl {
 namespace cv {
@@ -46,6 +51,7 @@ static void resize_linear_calc_offset_fp32(
     int32_t channels,
     int32_t outHeight,
     int32_t outWidth,
+    bool area,
     int32_t &w_max,
     int32_t *h_offset,
     int32_t *w_offset,
@@ -58,6 +64,9 @@ static void resize_linear_calc_offset_fp32(
         float float_h = (h + 0.5) * scale_h - 0.5;
         int32_t int_h = resize_img_floor(float_h);
         float_h -= int_h;
+        if (area) {
+            resize_area_linear_coeff(h, scale_h, inv_scale_h, int_h, float_h);
+        }
 
         if (int_h < 0) {
             int_h   = 0;
@@ -80,6 +89,9 @@ static void resize_linear_calc_offset_fp32(
         float float_w = (w + 0.5) * scale_w - 0.5;
         int32_t int_w = resize_img_floor(float_w);
         float_w -= int_w;
+        if (area) {
+            resize_area_linear_coeff(w, scale_w, inv_scale_w, int_w, float_w);
+        }
 
         if (int_w < 0) {
             int_w   = 0;
@@ -111,13 +123,17 @@ static void resize_linear_twoline_fp32(
     const float *w_coeff,
     int32_t h_idx,
     float h_coeff,
+    bool use_avx512,
+    bool use_fma,
     float *row_0,
     float *row_1,
     float *outData)
 {
     int32_t i = 0;
 
-    if (ppl::common::CpuSupports(ppl::common::ISA_X86_FMA)) {
+    if (use_avx512) {
+        i = avx512::resize_linear_twoline_fp32(w_max * channels, channels, inData_0, inData_1, w_offset, w_coeff, h_coeff, row_0, row_1, outData);
+    } else if (use_fma) {
         i = fma::resize_linear_twoline_fp32_fma(w_max * channels, channels, inData_0, inData_1, w_offset, w_coeff, h_coeff, row_0, row_1, outData);
     }
 
@@ -217,11 +233,19 @@ static void resize_linear_w_oneline_fp32(
     int32_t w_max,
     const int32_t *w_offset,
     const float *w_coeff,
+    bool use_avx512,
+    bool use_fma,
     float *row)
 {
     __m128 m_one = _mm_set1_ps(1.0f);
     int32_t i    = 0;
 
+    if (use_avx512) {
+        i = avx512::resize_linear_w_oneline_fp32(w_max * channels, channels, inData, w_offset, w_coeff, row);
+    } else if (use_fma) {
+        i = fma::resize_linear_w_oneline_fp32_fma(w_max * channels, channels, inData, w_offset, w_coeff, row);
+    }
+
     if (channels == 4) {
         for (; i < w_max * channels; i += 4) {
             __m128 m_data_0 = _mm_loadu_ps(inData + w_offset[i]);
@@ -290,46 +314,48 @@ static void resize_linear_h_fp32(
     }
 }
 
-static void resize_linear_kernel_fp32(
+// Produces output rows [begin, end) from the precomputed tables, `outData`
+// pointing at row `begin`. Each band owns its pair of horizontally
+// interpolated rows so bands can run concurrently.
+static void resize_linear_rows_fp32(
     int32_t inHeight,
     int32_t inWidth,
     int32_t inWidthStride,
     const float *inData,
     int32_t channels,
-    int32_t outHeight,
     int32_t outWidth,
     int32_t outWidthStride,
-    float *outData)
+    float *outData,
+    int32_t w_max,
+    const int32_t *h_offset,
+    const int32_t *w_offset,
+    const float *h_coeff,
+    const float *w_coeff,
+    bool use_avx512,
+    bool use_fma,
+    float *row_0,
+    float *row_1,
+    int32_t begin,
+    int32_t end)
 {
-    int32_t cn_width           = channels * outWidth;
-    uint64_t size_for_h_offset = (outHeight * sizeof(int32_t) + 128 - 1) / 128 * 128;
-    uint64_t size_for_w_offset = (cn_width * sizeof(int32_t) + 128 - 1) / 128 * 128;
-    uint64_t size_for_h_coeff  = (outHeight * sizeof(float) + 128 - 1) / 128 * 128;
-    uint64_t size_for_w_coeff  = (cn_width * sizeof(float) + 128 - 1) / 128 * 128;
-    uint64_t size_for_row_0    = (cn_width * sizeof(float) + 128 - 1) / 128 * 128;
-    uint64_t size_for_row_1    = (cn_width * sizeof(float) + 128 - 1) / 128 * 128;
-
-    uint64_t total_size = size_for_h_offset + size_for_w_offset + size_for_h_coeff + size_for_w_coeff + size_for_row_0 + size_for_row_1;
-
-    void *temp_buffer = ppl::common::AlignedAlloc(total_size, 128);
-
-    int32_t *h_offset = (int32_t *)temp_buffer;
-    int32_t *w_offset = (int32_t *)((unsigned char *)h_offset + size_for_h_offset);
-    float *h_coeff    = (float *)((unsigned char *)w_offset + size_for_w_offset);
-    float *w_coeff    = (float *)((unsigned char *)h_coeff + size_for_h_coeff);
-    float *row_0      = (float *)((unsigned char *)w_coeff + size_for_w_coeff);
-    float *row_1      = (float *)((unsigned char *)row_0 + size_for_row_0);
-
-    int32_t w_max = 0;
-    resize_linear_calc_offset_fp32(inHeight, inWidth, channels, outHeight, outWidth, w_max, h_offset, w_offset, h_coeff, w_coeff);
-
     int32_t prev_h[2]  = {-1, -1};
     float *prev_ptr[2] = {nullptr, nullptr};
 
+    // Start from the rows cached by the previous output row, so each row takes
+    // the same code path, and gives the same result, for any band split.
+    if (begin > 0) {
+        prev_h[0]   = h_offset[begin - 1];
+        prev_h[1]   = prev_h[0] == inHeight - 1 ? prev_h[0] : prev_h[0] + 1;
+        prev_ptr[0] = row_0;
+        prev_ptr[1] = row_1;
+        resize_linear_w_oneline_fp32(inWidth, outWidth, channels, inData + prev_h[0] * inWidthStride, w_max, w_offset, w_coeff, use_avx512, use_fma, row_0);
+        resize_linear_w_oneline_fp32(inWidth, outWidth, channels, inData + prev_h[1] * inWidthStride, w_max, w_offset, w_coeff, use_avx512, use_fma, row_1);
+    }
+
     int32_t reuse_count;
     float *row_ptr[2];
 
-    for (int32_t h = 0; h < outHeight; ++h) {
+    for (int32_t h = begin; h < end; ++h) {
         reuse_count = 0;
         row_ptr[0]  = nullptr;
         row_ptr[1]  = nullptr;
@@ -362,7 +388,7 @@ static void resize_linear_kernel_fp32(
             row_ptr[0] = row_0;
             row_ptr[1] = row_1;
 
-            resize_linear_twoline_fp32(inWidth, outWidth, channels, inData + src_h_idx_0 * inWidthStride, inData + src_h_idx_1 * inWidthStride, w_max, w_offset, w_coeff, h_offset[h], h_coeff[h], row_ptr[0], row_ptr[1], outData + h * outWidthStride);
+            resize_linear_twoline_fp32(inWidth, outWidth, channels, inData + src_h_idx_0 * inWidthStride, inData + src_h_idx_1 * inWidthStride, w_max, w_offset, w_coeff, h_offset[h], h_coeff[h], use_avx512, use_fma, row_ptr[0], row_ptr[1], outData + (h - begin) * outWidthStride);
         } else {
             if (reuse_count == 1) {
                 if (row_ptr[0] == row_0) {
@@ -370,9 +396,9 @@ static void resize_linear_kernel_fp32(
                 } else {
                     row_ptr[1] = row_0;
                 }
-                resize_linear_w_oneline_fp32(inWidth, outWidth, channels, inData + src_h_idx_1 * inWidthStride, w_max, w_offset, w_coeff, row_ptr[1]);
+                resize_linear_w_oneline_fp32(inWidth, outWidth, channels, inData + src_h_idx_1 * inWidthStride, w_max, w_offset, w_coeff, use_avx512, use_fma, row_ptr[1]);
             }
-            resize_linear_h_fp32(outWidth, channels, row_ptr[0], row_ptr[1], h_offset[h], h_coeff[h], outData + h * outWidthStride);
+            resize_linear_h_fp32(outWidth, channels, row_ptr[0], row_ptr[1], h_offset[h], h_coeff[h], outData + (h - begin) * outWidthStride);
         }
 
         prev_h[0]   = src_h_idx_0;
@@ -380,9 +406,9 @@ static void resize_linear_kernel_fp32(
         prev_ptr[0] = row_ptr[0];
         prev_ptr[1] = row_ptr[1];
     }
-    ppl::common::AlignedFree(temp_buffer);
 }
 
+
 static void resize_linear_shrink2_c1_kernel_fp32(
     const float *inData,
     int32_t inWidthStride,
@@ -486,41 +512,114 @@ static void resize_linear_shrink2_c4_kernel_fp32(
     }
 }
 
-template <>
-::ppl::common::RetCode ResizeLinear<float, 1>(
+::ppl::common::RetCode resize_linear_table_create_fp32(
     int32_t inHeight,
     int32_t inWidth,
-    int32_t inWidthStride,
-    const float *inData,
+    int32_t channels,
     int32_t outHeight,
     int32_t outWidth,
-    int32_t outWidthStride,
-    float *outData)
+    ResizeTable *table,
+    bool area)
 {
-    if (nullptr == inData) {
-        return ppl::common::RC_INVALID_VALUE;
+    memset(table, 0, sizeof(ResizeTable));
+    table->inHeight  = inHeight;
+    table->inWidth   = inWidth;
+    table->outHeight = outHeight;
+    table->outWidth  = outWidth;
+    table->channels  = channels;
+    table->use_fma   = isa_supported(ppl::common::ISA_X86_FMA);
+    table->use_avx512 = isa_supported(ppl::common::ISA_X86_AVX512);
+    table->shrink2   = outHeight * 2 == inHeight && outWidth * 2 == inWidth;
+    if (table->shrink2) {
+        return ppl::common::RC_SUCCESS;
     }
-    if (nullptr == outData) {
-        return ppl::common::RC_INVALID_VALUE;
+
+    int32_t cn_width = channels * outWidth;
+    table->num_bands = parallel_num_bands(outHeight, (int64_t)cn_width * 4, 1);
+    table->row_size  = (cn_width * sizeof(float) + 128 - 1) / 128 * 128;
+
+    uint64_t size_for_h_offset = (outHeight * sizeof(int32_t) + 128 - 1) / 128 * 128;
+    uint64_t size_for_w_offset = (cn_width * sizeof(int32_t) + 128 - 1) / 128 * 128;
+    uint64_t size_for_h_coeff  = (outHeight * sizeof(float) + 128 - 1) / 128 * 128;
+    uint64_t size_for_w_coeff  = (cn_width * sizeof(float) + 128 - 1) / 128 * 128;
+    uint64_t size_for_rows     = table->row_size * 2 * table->num_bands;
+
+    uint64_t total_size = size_for_h_offset + size_for_w_offset + size_for_h_coeff + size_for_w_coeff + size_for_rows;
+
+    table->buffer = ppl::common::AlignedAlloc(total_size, 128);
+    if (nullptr == table->buffer) {
+        return ppl::common::RC_OUT_OF_MEMORY;
     }
+    table->h_offset = (int32_t *)table->buffer;
+    table->w_offset = (int32_t *)((unsigned char *)table->h_offset + size_for_h_offset);
+    table->h_coeff  = (unsigned char *)table->w_offset + size_for_w_offset;
+    table->w_coeff  = (unsigned char *)table->h_coeff + size_for_h_coeff;
+    table->rows     = (unsigned char *)table->w_coeff + size_for_w_coeff;
 
-    if (outHeight * 2 == inHeight && outWidth * 2 == inWidth) {
-        resize_linear_shrink2_c1_kernel_fp32(inData, inWidthStride, outHeight, outWidth, outWidthStride, outData);
-        return ppl::common::RC_SUCCESS;
+    resize_linear_calc_offset_fp32(inHeight, inWidth, channels, outHeight, outWidth, area, table->w_max, table->h_offset, table->w_offset, (float *)table->h_coeff, (float *)table->w_coeff);
+    return ppl::common::RC_SUCCESS;
+}
+
+void resize_linear_run_rows_fp32(
+    const ResizeTable &table,
+    int32_t inWidthStride,
+    const float *inData,
+    int32_t outWidthStride,
+    float *outData,
+    void *rows,
+    int32_t begin,
+    int32_t end)
+{
+    int32_t outWidth = table.outWidth;
+    int32_t channels = table.channels;
+
+    if (table.shrink2) {
+        if (1 == channels) {
+            resize_linear_shrink2_c1_kernel_fp32(inData + begin * 2 * inWidthStride, inWidthStride, end - begin, outWidth, outWidthStride, outData);
+        } else if (3 == channels) {
+            resize_linear_shrink2_c3_kernel_fp32(inData + begin * 2 * inWidthStride, inWidthStride, end - begin, outWidth, outWidthStride, outData);
+        } else {
+            resize_linear_shrink2_c4_kernel_fp32(inData + begin * 2 * inWidthStride, inWidthStride, end - begin, outWidth, outWidthStride, outData);
+        }
+        return;
     }
 
-    resize_linear_kernel_fp32(
-        inHeight, inWidth, inWidthStride, inData, 1, outHeight, outWidth, outWidthStride, outData);
+    float *row_0 = (float *)rows;
+    float *row_1 = (float *)((unsigned char *)row_0 + table.row_size);
+    resize_linear_rows_fp32(table.inHeight, table.inWidth, inWidthStride, inData, channels, outWidth, outWidthStride, outData, table.w_max, table.h_offset, table.w_offset, (const float *)table.h_coeff, (const float *)table.w_coeff, table.use_avx512, table.use_fma, row_0, row_1, begin, end);
+}
 
-    return ppl::common::RC_SUCCESS;
+void resize_linear_run_fp32(
+    const ResizeTable &table,
+    int32_t inWidthStride,
+    const float *inData,
+    int32_t outWidthStride,
+    float *outData)
+{
+    int32_t outHeight = table.outHeight;
+    int32_t cn_width  = table.channels * table.outWidth;
+
+    if (table.shrink2) {
+        parallel_for_rows(outHeight, (int64_t)cn_width * 4, [&](int32_t begin, int32_t end) {
+            resize_linear_run_rows_fp32(table, inWidthStride, inData, outWidthStride, outData + begin * outWidthStride, nullptr, begin, end);
+        });
+        return;
+    }
+
+    // bands take the row buffers in the order they start
+    std::atomic<int32_t> next_band(0);
+    parallel_for_rows(outHeight, (int64_t)cn_width * 4, [&](int32_t begin, int32_t end) {
+        void *rows = (unsigned char *)table.rows + table.row_size * 2 * next_band.fetch_add(1);
+        resize_linear_run_rows_fp32(table, inWidthStride, inData, outWidthStride, outData + begin * outWidthStride, rows, begin, end);
+    }, 1, table.num_bands);
 }
 
-template <>
-::ppl::common::RetCode ResizeLinear<float, 3>(
+static ::ppl::common::RetCode resize_linear_fp32(
     int32_t inHeight,
     int32_t inWidth,
     int32_t inWidthStride,
     const float *inData,
+    int32_t channels,
     int32_t outHeight,
     int32_t outWidth,
     int32_t outWidthStride,
@@ -533,19 +632,19 @@ template <>
         return ppl::common::RC_INVALID_VALUE;
     }
 
-    if (outHeight * 2 == inHeight && outWidth * 2 == inWidth) {
-        resize_linear_shrink2_c3_kernel_fp32(inData, inWidthStride, outHeight, outWidth, outWidthStride, outData);
-        return ppl::common::RC_SUCCESS;
+    ResizeTable table;
+    ::ppl::common::RetCode status = resize_linear_table_create_fp32(inHeight, inWidth, channels, outHeight, outWidth, &table);
+    if (ppl::common::RC_SUCCESS != status) {
+        return status;
     }
-
-    resize_linear_kernel_fp32(
-        inHeight, inWidth, inWidthStride, inData, 3, outHeight, outWidth, outWidthStride, outData);
+    resize_linear_run_fp32(table, inWidthStride, inData, outWidthStride, outData);
+    resize_table_destroy(&table);
 
     return ppl::common::RC_SUCCESS;
 }
 
 template <>
-::ppl::common::RetCode ResizeLinear<float, 4>(
+::ppl::common::RetCode ResizeLinear<float, 1>(
     int32_t inHeight,
     int32_t inWidth,
     int32_t inWidthStride,
@@ -555,22 +654,38 @@ template <>
     int32_t outWidthStride,
     float *outData)
 {
-    if (nullptr == inData) {
-        return ppl::common::RC_INVALID_VALUE;
-    }
-    if (nullptr == outData) {
-        return ppl::common::RC_INVALID_VALUE;
-    }
+    return resize_linear_fp32(
+        inHeight, inWidth, inWidthStride, inData, 1, outHeight, outWidth, outWidthStride, outData);
+}
 
-    if (outHeight * 2 == inHeight && outWidth * 2 == inWidth) {
-        resize_linear_shrink2_c4_kernel_fp32(inData, inWidthStride, outHeight, outWidth, outWidthStride, outData);
-        return ppl::common::RC_SUCCESS;
-    }
+template <>
+::ppl::common::RetCode ResizeLinear<float, 3>(
+    int32_t inHeight,
+    int32_t inWidth,
+    int32_t inWidthStride,
+    const float *inData,
+    int32_t outHeight,
+    int32_t outWidth,
+    int32_t outWidthStride,
+    float *outData)
+{
+    return resize_linear_fp32(
+        inHeight, inWidth, inWidthStride, inData, 3, outHeight, outWidth, outWidthStride, outData);
+}
 
-    resize_linear_kernel_fp32(
+template <>
+::ppl::common::RetCode ResizeLinear<float, 4>(
+    int32_t inHeight,
+    int32_t inWidth,
+    int32_t inWidthStride,
+    const float *inData,
+    int32_t outHeight,
+    int32_t outWidth,
+    int32_t outWidthStride,
+    float *outData)
+{
+    return resize_linear_fp32(
         inHeight, inWidth, inWidthStride, inData, 4, outHeight, outWidth, outWidthStride, outData);
-
-    return ppl::common::RC_SUCCESS;
 }
 
 }
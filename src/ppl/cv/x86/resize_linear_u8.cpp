@@ -21,6 +21,7 @@
 #include "ppl/common/sys.h"
 #include "ppl/common/retcode.h"
 #include "ppl/common/x86/sysinfo.h"
+#include "ppl/cv/x86/isa.hpp"
 
 #include <string.h>
 #include <limits.h>
@@ -30,8 +31,11 @@
 #include <cmath>
 #include <stdlib.h>
 #include <algorithm>
+#include <atomic>
 
 #include "ppl/cv/x86/fma/internal_fma.hpp"
+#include "ppl/cv/x86/parallel.hpp"
+#include "ppl/cv/x86/resize.hpp"
 
 namespace ppl {
 namespace cv {
@@ -45,15 +49,10 @@ static inline int32_t resize_img_floor(float a)
     return (((a) >= 0) ? ((int32_t)a) : ((int32_t)a - 1));
 }
 
+// round half to even, as the default MXCSR rounding mode does
 static inline int32_t resize_img_round(float value)
 {
-    double intpart, fractpart;
-    fractpart = modf(value, &intpart);
-    if (fabs(fractpart) != 0.5f || ((((int32_t)intpart) % 2) != 0)) {
-        return (int32_t)(value + (value >= 0 ? 0.5f : -0.5f));
-    } else {
-        return (int32_t)intpart;
-    }
+    return _mm_cvtss_si32(_mm_set_ss(value));
 }
 
 static inline int16_t resize_img_saturate_cast_short(float x)
@@ -69,6 +68,7 @@ static void resize_linear_calc_offset_u8(
     int32_t channels,
     int32_t outHeight,
     int32_t outWidth,
+    bool area,
     int32_t &w_max,
     int32_t *h_offset,
     int32_t *w_offset,
@@ -82,6 +82,9 @@ static void resize_linear_calc_offset_u8(
         float float_h = (h + 0.5) * scale_h - 0.5;
         int32_t int_h = resize_img_floor(float_h);
         float_h -= int_h;
+        if (area) {
+            resize_area_linear_coeff(h, scale_h, inv_scale_h, int_h, float_h);
+        }
 
         h_offset[h] = int_h;
         h_coeff[h]  = resize_img_saturate_cast_short((1.0f - float_h) * INTER_RESIZE_COEF_SCALE);
@@ -95,6 +98,9 @@ static void resize_linear_calc_offset_u8(
         float float_w = (w + 0.5) * scale_w - 0.5;
         int32_t int_w = resize_img_floor(float_w);
         float_w -= int_w;
+        if (area) {
+            resize_area_linear_coeff(w, scale_w, inv_scale_w, int_w, float_w);
+        }
 
         if (int_w < 0) {
             int_w   = 0;
@@ -124,20 +130,18 @@ static void resize_linear_w_oneline_u8(
     int32_t w_max,
     const int32_t *w_offset,
     const int16_t *w_coeff,
+    bool use_fma,
     int32_t *row)
 {
     int32_t i = 0;
 
-    if (1 == channels &&
-        ppl::common::CpuSupports(ppl::common::ISA_X86_FMA)) {
+    if (1 == channels && use_fma) {
         i = fma::resize_linear_w_oneline_c1_u8_fma(inWidth, inData, outWidth, w_offset, w_coeff, INTER_RESIZE_COEF_SCALE, row);
     }
-    if (3 == channels &&
-        ppl::common::CpuSupports(ppl::common::ISA_X86_FMA)) {
+    if (3 == channels && use_fma) {
         i = fma::resize_linear_w_oneline_c3_u8_fma(inWidth, inData, outWidth, w_offset, w_coeff, INTER_RESIZE_COEF_SCALE, row);
     }
-    if (4 == channels &&
-        ppl::common::CpuSupports(ppl::common::ISA_X86_FMA)) {
+    if (4 == channels && use_fma) {
         i = fma::resize_linear_w_oneline_c4_u8_fma(inWidth, inData, outWidth, w_offset, w_coeff, INTER_RESIZE_COEF_SCALE, row);
     }
 
@@ -214,48 +218,30 @@ static void resize_linear_h_u8(
     }
 }
 
-static void resize_linear_kernel_u8(
+// Produces output rows [begin, end) from the precomputed tables, `outData`
+// pointing at row `begin`. Each band owns its pair of horizontally
+// interpolated rows so bands can run concurrently.
+static void resize_linear_rows_u8(
     int32_t inHeight,
     int32_t inWidth,
     int32_t inWidthStride,
     const uint8_t *inData,
     int32_t channels,
-    int32_t outHeight,
     int32_t outWidth,
     int32_t outWidthStride,
-    uint8_t *outData)
+    uint8_t *outData,
+    int32_t w_max,
+    const int32_t *h_offset,
+    const int32_t *w_offset,
+    const int16_t *h_coeff,
+    const int16_t *w_coeff,
+    bool use_fma,
+    int32_t *row_0,
+    int32_t *row_1,
+    int32_t begin,
+    int32_t end)
 {
-    int32_t cn_width           = channels * outWidth;
-    uint64_t size_for_h_offset = (outHeight * sizeof(int32_t) + 128 - 1) / 128 * 128;
-    uint64_t size_for_w_offset = (cn_width * sizeof(int32_t) + 128 - 1) / 128 * 128;
-    uint64_t size_for_h_coeff  = (outHeight * sizeof(int16_t) * 2 + 128 - 1) / 128 * 128;
-    uint64_t size_for_w_coeff  = (cn_width * sizeof(int16_t) * 2 + 128 - 1) / 128 * 128;
-    uint64_t size_for_row_0    = (cn_width * sizeof(int32_t) + 128 - 1) / 128 * 128;
-    uint64_t size_for_row_1    = (cn_width * sizeof(int32_t) + 128 - 1) / 128 * 128;
-
-    uint64_t total_size = size_for_h_offset + size_for_w_offset + size_for_h_coeff + size_for_w_coeff + size_for_row_0 + size_for_row_1;
-
-    void *temp_buffer = ppl::common::AlignedAlloc(total_size, 128);
-    int32_t *h_offset = (int32_t *)temp_buffer;
-    int32_t *w_offset = (int32_t *)((unsigned char *)h_offset + size_for_h_offset);
-    int16_t *h_coeff  = (int16_t *)((unsigned char *)w_offset + size_for_w_offset);
-    int16_t *w_coeff  = (int16_t *)((unsigned char *)h_coeff + size_for_h_coeff);
-    int32_t *row_0    = (int32_t *)((unsigned char *)w_coeff + size_for_w_coeff);
-    int32_t *row_1    = (int32_t *)((unsigned char *)row_0 + size_for_row_0);
-
-    int32_t w_max = 0;
-    resize_linear_calc_offset_u8(inHeight, inWidth, channels, outHeight, outWidth, w_max, h_offset, w_offset, h_coeff, w_coeff);
-
-    if (1 == channels &&
-        inHeight > outHeight &&
-        ppl::common::CpuSupports(ppl::common::ISA_X86_FMA)) {
-        fma::resize_linear_kernel_c1_shrink_u8_fma(inHeight, inWidth, inWidthStride, inData, outHeight, outWidth, outWidthStride, h_offset, w_offset, h_coeff, w_coeff, INTER_RESIZE_COEF_SCALE, outData);
-
-        ppl::common::AlignedFree(temp_buffer);
-        return;
-    }
-
-    int32_t h = 0;
+    int32_t h = begin;
 
     int32_t prev_h[2]    = {-1, -1};
     int32_t *prev_ptr[2] = {nullptr, nullptr};
@@ -263,7 +249,7 @@ static void resize_linear_kernel_u8(
     int32_t reuse_count;
     int32_t *row_ptr[2];
 
-    for (; h < outHeight; ++h) {
+    for (; h < end; ++h) {
         reuse_count = 0;
         row_ptr[0]  = nullptr;
         row_ptr[1]  = nullptr;
@@ -299,8 +285,8 @@ static void resize_linear_kernel_u8(
             row_ptr[0] = row_0;
             row_ptr[1] = row_1;
 
-            resize_linear_w_oneline_u8(inWidth, outWidth, channels, inData + src_h_idx_0 * inWidthStride, w_max, w_offset, w_coeff, row_ptr[0]);
-            resize_linear_w_oneline_u8(inWidth, outWidth, channels, inData + src_h_idx_1 * inWidthStride, w_max, w_offset, w_coeff, row_ptr[1]);
+            resize_linear_w_oneline_u8(inWidth, outWidth, channels, inData + src_h_idx_0 * inWidthStride, w_max, w_offset, w_coeff, use_fma, row_ptr[0]);
+            resize_linear_w_oneline_u8(inWidth, outWidth, channels, inData + src_h_idx_1 * inWidthStride, w_max, w_offset, w_coeff, use_fma, row_ptr[1]);
         } else {
             if (reuse_count == 1) {
                 if (row_ptr[0] == row_0) {
@@ -308,17 +294,16 @@ static void resize_linear_kernel_u8(
                 } else {
                     row_ptr[1] = row_0;
                 }
-                resize_linear_w_oneline_u8(inWidth, outWidth, channels, inData + src_h_idx_1 * inWidthStride, w_max, w_offset, w_coeff, row_ptr[1]);
+                resize_linear_w_oneline_u8(inWidth, outWidth, channels, inData + src_h_idx_1 * inWidthStride, w_max, w_offset, w_coeff, use_fma, row_ptr[1]);
             }
         }
-        resize_linear_h_u8(outWidth, channels, row_ptr[0], row_ptr[1], h_offset[h], h_coeff[h], outData + h * outWidthStride);
+        resize_linear_h_u8(outWidth, channels, row_ptr[0], row_ptr[1], h_offset[h], h_coeff[h], outData + (h - begin) * outWidthStride);
 
         prev_h[0]   = src_h_idx_0;
         prev_h[1]   = src_h_idx_1;
         prev_ptr[0] = row_ptr[0];
         prev_ptr[1] = row_ptr[1];
     }
-    ppl::common::AlignedFree(temp_buffer);
 }
 
 static void resize_linear_shrink2_c1_kernel_u8(
@@ -327,14 +312,15 @@ static void resize_linear_shrink2_c1_kernel_u8(
     int32_t outHeight,
     int32_t outWidth,
     int32_t outWidthStride,
-    uint8_t *outData)
+    uint8_t *outData,
+    bool use_fma)
 {
     __m128i m_zero      = _mm_set1_epi8(0);
     __m128i m_epi16_two = _mm_set1_epi16(2);
     for (int32_t h = 0; h < outHeight; ++h) {
         int32_t w = 0;
 
-        if (ppl::common::CpuSupports(ppl::common::ISA_X86_FMA)) {
+        if (use_fma) {
             w = fma::resize_linear_shrink2_oneline_c1_kernel_u8_fma(inData + h * 2 * inWidthStride, inWidthStride, outWidth, outData + h * outWidthStride);
         }
         for (; w <= outWidth - 16; w += 16) {
@@ -391,7 +377,8 @@ static void resize_linear_shrink2_c4_kernel_u8(
     int32_t outHeight,
     int32_t outWidth,
     int32_t outWidthStride,
-    uint8_t *outData)
+    uint8_t *outData,
+    bool use_fma)
 {
     const int32_t channels = 4;
 
@@ -400,7 +387,7 @@ static void resize_linear_shrink2_c4_kernel_u8(
     for (int32_t h = 0; h < outHeight; ++h) {
         int32_t w = 0;
 
-        if (ppl::common::CpuSupports(ppl::common::ISA_X86_FMA)) {
+        if (use_fma) {
             w = fma::resize_linear_shrink2_oneline_c4_kernel_u8_fma(inData + h * 2 * inWidthStride, inWidthStride, outWidth, outData + h * outWidthStride);
         }
         for (; w <= outWidth - 4; w += 4) {
@@ -477,41 +464,134 @@ static void resize_linear_shrink2_c4_kernel_u8(
     }
 }
 
-template <>
-::ppl::common::RetCode ResizeLinear<uint8_t, 1>(
+::ppl::common::RetCode resize_linear_table_create_u8(
     int32_t inHeight,
     int32_t inWidth,
-    int32_t inWidthStride,
-    const uint8_t *inData,
+    int32_t channels,
     int32_t outHeight,
     int32_t outWidth,
+    ResizeTable *table,
+    bool area)
+{
+    memset(table, 0, sizeof(ResizeTable));
+    table->inHeight  = inHeight;
+    table->inWidth   = inWidth;
+    table->outHeight = outHeight;
+    table->outWidth  = outWidth;
+    table->channels  = channels;
+    table->use_fma   = isa_supported(ppl::common::ISA_X86_FMA);
+    table->shrink2   = (1 == channels || 4 == channels) &&
+                     outHeight * 2 == inHeight && outWidth * 2 == inWidth;
+    if (table->shrink2) {
+        return ppl::common::RC_SUCCESS;
+    }
+
+    // the fma shrink kernel walks output rows in groups of 4 and needs no rows
+    bool c1_shrink       = 1 == channels && inHeight > outHeight && table->use_fma;
+    int32_t cn_width     = channels * outWidth;
+    table->num_bands     = parallel_num_bands(outHeight, (int64_t)cn_width * 4, c1_shrink ? 4 : 1);
+    table->row_size      = c1_shrink ? 0 : (cn_width * sizeof(int32_t) + 128 - 1) / 128 * 128;
+
+    uint64_t size_for_h_offset = (outHeight * sizeof(int32_t) + 128 - 1) / 128 * 128;
+    uint64_t size_for_w_offset = (cn_width * sizeof(int32_t) + 128 - 1) / 128 * 128;
+    uint64_t size_for_h_coeff  = (outHeight * sizeof(int16_t) * 2 + 128 - 1) / 128 * 128;
+    uint64_t size_for_w_coeff  = (cn_width * sizeof(int16_t) * 2 + 128 - 1) / 128 * 128;
+    uint64_t size_for_rows     = table->row_size * 2 * table->num_bands;
+
+    uint64_t total_size = size_for_h_offset + size_for_w_offset + size_for_h_coeff + size_for_w_coeff + size_for_rows;
+
+    table->buffer = ppl::common::AlignedAlloc(total_size, 128);
+    if (nullptr == table->buffer) {
+        return ppl::common::RC_OUT_OF_MEMORY;
+    }
+    table->h_offset = (int32_t *)table->buffer;
+    table->w_offset = (int32_t *)((unsigned char *)table->h_offset + size_for_h_offset);
+    table->h_coeff  = (unsigned char *)table->w_offset + size_for_w_offset;
+    table->w_coeff  = (unsigned char *)table->h_coeff + size_for_h_coeff;
+    table->rows     = (unsigned char *)table->w_coeff + size_for_w_coeff;
+
+    resize_linear_calc_offset_u8(inHeight, inWidth, channels, outHeight, outWidth, area, table->w_max, table->h_offset, table->w_offset, (int16_t *)table->h_coeff, (int16_t *)table->w_coeff);
+    return ppl::common::RC_SUCCESS;
+}
+
+void resize_linear_run_rows_u8(
+    const ResizeTable &table,
+    int32_t inWidthStride,
+    const uint8_t *inData,
     int32_t outWidthStride,
-    uint8_t *outData)
+    uint8_t *outData,
+    void *rows,
+    int32_t begin,
+    int32_t end)
 {
-    if (nullptr == inData) {
-        return ppl::common::RC_INVALID_VALUE;
+    int32_t inHeight = table.inHeight;
+    int32_t inWidth  = table.inWidth;
+    int32_t outWidth = table.outWidth;
+    int32_t channels = table.channels;
+    bool use_fma     = table.use_fma;
+
+    if (table.shrink2) {
+        if (1 == channels) {
+            resize_linear_shrink2_c1_kernel_u8(inData + begin * 2 * inWidthStride, inWidthStride, end - begin, outWidth, outWidthStride, outData, use_fma);
+        } else {
+            resize_linear_shrink2_c4_kernel_u8(inData + begin * 2 * inWidthStride, inWidthStride, end - begin, outWidth, outWidthStride, outData, use_fma);
+        }
+        return;
     }
-    if (nullptr == outData) {
-        return ppl::common::RC_INVALID_VALUE;
+
+    const int32_t *h_offset = table.h_offset;
+    const int32_t *w_offset = table.w_offset;
+    int16_t *h_coeff        = (int16_t *)table.h_coeff;
+    int16_t *w_coeff        = (int16_t *)table.w_coeff;
+
+    if (0 == table.row_size) { // the fma shrink kernel
+        fma::resize_linear_kernel_c1_shrink_u8_fma(inHeight, inWidth, inWidthStride, inData, end - begin, outWidth, outWidthStride, h_offset + begin, w_offset, h_coeff + begin, w_coeff, INTER_RESIZE_COEF_SCALE, outData);
+        return;
     }
 
-    if (outHeight * 2 == inHeight && outWidth * 2 == inWidth) {
-        resize_linear_shrink2_c1_kernel_u8(inData, inWidthStride, outHeight, outWidth, outWidthStride, outData);
-        return ppl::common::RC_SUCCESS;
+    int32_t *row_0 = (int32_t *)rows;
+    int32_t *row_1 = (int32_t *)((unsigned char *)row_0 + table.row_size);
+    resize_linear_rows_u8(inHeight, inWidth, inWidthStride, inData, channels, outWidth, outWidthStride, outData, table.w_max, h_offset, w_offset, h_coeff, w_coeff, use_fma, row_0, row_1, begin, end);
+}
+
+void resize_linear_run_u8(
+    const ResizeTable &table,
+    int32_t inWidthStride,
+    const uint8_t *inData,
+    int32_t outWidthStride,
+    uint8_t *outData)
+{
+    int32_t outHeight = table.outHeight;
+    int32_t cn_width  = table.channels * table.outWidth;
+
+    if (table.shrink2) {
+        parallel_for_rows(outHeight, (int64_t)cn_width * 4, [&](int32_t begin, int32_t end) {
+            resize_linear_run_rows_u8(table, inWidthStride, inData, outWidthStride, outData + begin * outWidthStride, nullptr, begin, end);
+        });
+        return;
     }
 
-    resize_linear_kernel_u8(
-        inHeight, inWidth, inWidthStride, inData, 1, outHeight, outWidth, outWidthStride, outData);
+    if (0 == table.row_size) { // the fma shrink kernel
+        parallel_for_rows(outHeight, (int64_t)cn_width * 4, [&](int32_t begin, int32_t end) {
+            resize_linear_run_rows_u8(table, inWidthStride, inData, outWidthStride, outData + begin * outWidthStride, nullptr, begin, end);
+        }, 4, table.num_bands);
+        return;
+    }
 
-    return ppl::common::RC_SUCCESS;
+    // bands take the row buffers in the order they start
+    std::atomic<int32_t> next_band(0);
+    parallel_for_rows(outHeight, (int64_t)cn_width * 4, [&](int32_t begin, int32_t end) {
+        void *rows = (unsigned char *)table.rows + table.row_size * 2 * next_band.fetch_add(1);
+        resize_linear_run_rows_u8(table, inWidthStride, inData, outWidthStride, outData + begin * outWidthStride, rows, begin, end);
+    }, 1, table.num_bands);
 }
 
-template <>
-::ppl::common::RetCode ResizeLinear<uint8_t, 3>(
+static ::ppl::common::RetCode resize_linear_u8(
     int32_t inHeight,
     int32_t inWidth,
     int32_t inWidthStride,
     const uint8_t *inData,
+    int32_t channels,
     int32_t outHeight,
     int32_t outWidth,
     int32_t outWidthStride,
@@ -524,14 +604,19 @@ template <>
         return ppl::common::RC_INVALID_VALUE;
     }
 
-    resize_linear_kernel_u8(
-        inHeight, inWidth, inWidthStride, inData, 3, outHeight, outWidth, outWidthStride, outData);
+    ResizeTable table;
+    ::ppl::common::RetCode status = resize_linear_table_create_u8(inHeight, inWidth, channels, outHeight, outWidth, &table);
+    if (ppl::common::RC_SUCCESS != status) {
+        return status;
+    }
+    resize_linear_run_u8(table, inWidthStride, inData, outWidthStride, outData);
+    resize_table_destroy(&table);
 
     return ppl::common::RC_SUCCESS;
 }
 
 template <>
-::ppl::common::RetCode ResizeLinear<uint8_t, 4>(
+::ppl::common::RetCode ResizeLinear<uint8_t, 1>(
     int32_t inHeight,
     int32_t inWidth,
     int32_t inWidthStride,
@@ -541,22 +626,38 @@ template <>
     int32_t outWidthStride,
     uint8_t *outData)
 {
-    if (nullptr == inData) {
-        return ppl::common::RC_INVALID_VALUE;
-    }
-    if (nullptr == outData) {
-        return ppl::common::RC_INVALID_VALUE;
-    }
+    return resize_linear_u8(
+        inHeight, inWidth, inWidthStride, inData, 1, outHeight, outWidth, outWidthStride, outData);
+}
 
-    if (outHeight * 2 == inHeight && outWidth * 2 == inWidth) {
-        resize_linear_shrink2_c4_kernel_u8(inData, inWidthStride, outHeight, outWidth, outWidthStride, outData);
-        return ppl::common::RC_SUCCESS;
-    }
+template <>
+::ppl::common::RetCode ResizeLinear<uint8_t, 3>(
+    int32_t inHeight,
+    int32_t inWidth,
+    int32_t inWidthStride,
+    const uint8_t *inData,
+    int32_t outHeight,
+    int32_t outWidth,
+    int32_t outWidthStride,
+    uint8_t *outData)
+{
+    return resize_linear_u8(
+        inHeight, inWidth, inWidthStride, inData, 3, outHeight, outWidth, outWidthStride, outData);
+}
 
-    resize_linear_kernel_u8(
+template <>
+::ppl::common::RetCode ResizeLinear<uint8_t, 4>(
+    int32_t inHeight,
+    int32_t inWidth,
+    int32_t inWidthStride,
+    const uint8_t *inData,
+    int32_t outHeight,
+    int32_t outWidth,
+    int32_t outWidthStride,
+    uint8_t *outData)
+{
+    return resize_linear_u8(
         inHeight, inWidth, inWidthStride, inData, 4, outHeight, outWidth, outWidthStride, outData);
-
-    return ppl::common::RC_SUCCESS;
 }
 
 }
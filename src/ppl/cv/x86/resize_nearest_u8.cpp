@@ -28,6 +28,8 @@
 #include <stdint.h>
 #include <math.h>
 
+#include "ppl/cv/x86/resize.hpp"
+
 namespace ppl {
 namespace cv {
 namespace x86 {
@@ -219,27 +221,48 @@ static void resize_nearest_c4_w_oneline_kernel_u8(
     }
 }
 
-static void resize_nearest_kernel_u8(
+::ppl::common::RetCode resize_nearest_table_create_u8(
     int32_t inHeight,
     int32_t inWidth,
-    int32_t inWidthStride,
-    const uint8_t *inData,
     int32_t channels,
     int32_t outHeight,
     int32_t outWidth,
-    int32_t outWidthStride,
-    uint8_t *outData)
+    ResizeTable *table)
 {
+    memset(table, 0, sizeof(ResizeTable));
+    table->inHeight  = inHeight;
+    table->inWidth   = inWidth;
+    table->outHeight = outHeight;
+    table->outWidth  = outWidth;
+    table->channels  = channels;
+
     uint64_t size_for_h_offset = (outHeight * sizeof(int32_t) + 128 - 1) / 128 * 128;
     uint64_t size_for_w_offset = (outWidth * sizeof(int32_t) + 128 - 1) / 128 * 128;
     uint64_t total_size        = size_for_h_offset + size_for_w_offset;
 
-    void *temp_buffer = ppl::common::AlignedAlloc(total_size, 128);
+    table->buffer = ppl::common::AlignedAlloc(total_size, 128);
+    if (nullptr == table->buffer) {
+        return ppl::common::RC_OUT_OF_MEMORY;
+    }
+    table->h_offset = (int32_t *)table->buffer;
+    table->w_offset = (int32_t *)((unsigned char *)table->h_offset + size_for_h_offset);
 
-    int32_t *h_offset = (int32_t *)temp_buffer;
-    int32_t *w_offset = (int32_t *)((unsigned char *)h_offset + size_for_h_offset);
+    resize_nearest_calc_offset_u8(inHeight, inWidth, outHeight, outWidth, table->h_offset, table->w_offset);
+    return ppl::common::RC_SUCCESS;
+}
 
-    resize_nearest_calc_offset_u8(inHeight, inWidth, outHeight, outWidth, h_offset, w_offset);
+void resize_nearest_run_u8(
+    const ResizeTable &table,
+    int32_t inWidthStride,
+    const uint8_t *inData,
+    int32_t outWidthStride,
+    uint8_t *outData)
+{
+    int32_t channels        = table.channels;
+    int32_t outHeight       = table.outHeight;
+    int32_t outWidth        = table.outWidth;
+    const int32_t *h_offset = table.h_offset;
+    int32_t *w_offset       = table.w_offset;
 
     int32_t i = 0;
     for (; i <= outHeight - 4; i += 4) {
@@ -304,16 +327,14 @@ static void resize_nearest_kernel_u8(
                                                   outData + i * outWidthStride);
         }
     }
-
-    ppl::common::AlignedFree(temp_buffer);
 }
 
-template <>
-::ppl::common::RetCode ResizeNearestPoint<uint8_t, 1>(
+static ::ppl::common::RetCode resize_nearest_u8(
     int32_t inHeight,
     int32_t inWidth,
     int32_t inWidthStride,
     const uint8_t *inData,
+    int32_t channels,
     int32_t outHeight,
     int32_t outWidth,
     int32_t outWidthStride,
@@ -326,14 +347,19 @@ template <>
         return ppl::common::RC_INVALID_VALUE;
     }
 
-    resize_nearest_kernel_u8(
-        inHeight, inWidth, inWidthStride, inData, 1, outHeight, outWidth, outWidthStride, outData);
+    ResizeTable table;
+    ::ppl::common::RetCode status = resize_nearest_table_create_u8(inHeight, inWidth, channels, outHeight, outWidth, &table);
+    if (ppl::common::RC_SUCCESS != status) {
+        return status;
+    }
+    resize_nearest_run_u8(table, inWidthStride, inData, outWidthStride, outData);
+    resize_table_destroy(&table);
 
     return ppl::common::RC_SUCCESS;
 }
 
 template <>
-::ppl::common::RetCode ResizeNearestPoint<uint8_t, 3>(
+::ppl::common::RetCode ResizeNearestPoint<uint8_t, 1>(
     int32_t inHeight,
     int32_t inWidth,
     int32_t inWidthStride,
@@ -343,17 +369,23 @@ template <>
     int32_t outWidthStride,
     uint8_t *outData)
 {
-    if (nullptr == inData) {
-        return ppl::common::RC_INVALID_VALUE;
-    }
-    if (nullptr == outData) {
-        return ppl::common::RC_INVALID_VALUE;
-    }
+    return resize_nearest_u8(
+        inHeight, inWidth, inWidthStride, inData, 1, outHeight, outWidth, outWidthStride, outData);
+}
 
-    resize_nearest_kernel_u8(
+template <>
+::ppl::common::RetCode ResizeNearestPoint<uint8_t, 3>(
+    int32_t inHeight,
+    int32_t inWidth,
+    int32_t inWidthStride,
+    const uint8_t *inData,
+    int32_t outHeight,
+    int32_t outWidth,
+    int32_t outWidthStride,
+    uint8_t *outData)
+{
+    return resize_nearest_u8(
         inHeight, inWidth, inWidthStride, inData, 3, outHeight, outWidth, outWidthStride, outData);
-
-    return ppl::common::RC_SUCCESS;
 }
 
 template <>
@@ -367,17 +399,8 @@ template <>
     int32_t outWidthStride,
     uint8_t *outData)
 {
-    if (nullptr == inData) {
-        return ppl::common::RC_INVALID_VALUE;
-    }
-    if (nullptr == outData) {
-        return ppl::common::RC_INVALID_VALUE;
-    }
-
-    resize_nearest_kernel_u8(
+    return resize_nearest_u8(
         inHeight, inWidth, inWidthStride, inData, 4, outHeight, outWidth, outWidthStride, outData);
-
-    return ppl::common::RC_SUCCESS;
 }
 
 }
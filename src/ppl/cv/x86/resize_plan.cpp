@@ -0,0 +1,195 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "ppl/cv/x86/resize.h"
+
+#include "ppl/cv/types.h"
+#include "ppl/common/sys.h"
+#include "ppl/common/retcode.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include "ppl/cv/x86/resize.hpp"
+
+namespace ppl {
+namespace cv {
+namespace x86 {
+
+void resize_table_destroy(ResizeTable *table)
+{
+    if (nullptr != table->buffer) {
+        ppl::common::AlignedFree(table->buffer);
+    }
+    memset(table, 0, sizeof(ResizeTable));
+}
+
+static ::ppl::common::RetCode resize_table_create(
+    const uint8_t *,
+    InterpolationType interpolation,
+    int32_t inHeight,
+    int32_t inWidth,
+    int32_t channels,
+    int32_t outHeight,
+    int32_t outWidth,
+    ResizeTable *table)
+{
+    if (INTERPOLATION_LINEAR == interpolation) {
+        return resize_linear_table_create_u8(inHeight, inWidth, channels, outHeight, outWidth, table);
+    }
+    if (INTERPOLATION_AREA == interpolation) {
+        return resize_area_table_create_u8(inHeight, inWidth, channels, outHeight, outWidth, table);
+    }
+    return resize_nearest_table_create_u8(inHeight, inWidth, channels, outHeight, outWidth, table);
+}
+
+static ::ppl::common::RetCode resize_table_create(
+    const float *,
+    InterpolationType interpolation,
+    int32_t inHeight,
+    int32_t inWidth,
+    int32_t channels,
+    int32_t outHeight,
+    int32_t outWidth,
+    ResizeTable *table)
+{
+    if (INTERPOLATION_LINEAR == interpolation) {
+        return resize_linear_table_create_fp32(inHeight, inWidth, channels, outHeight, outWidth, table);
+    }
+    if (INTERPOLATION_AREA == interpolation) {
+        return resize_area_table_create_fp32(inHeight, inWidth, channels, outHeight, outWidth, table);
+    }
+    return resize_nearest_table_create_fp32(inHeight, inWidth, channels, outHeight, outWidth, table);
+}
+
+static void resize_table_run(
+    const ResizeTable &table,
+    InterpolationType interpolation,
+    int32_t inWidthStride,
+    const uint8_t *inData,
+    int32_t outWidthStride,
+    uint8_t *outData)
+{
+    if (INTERPOLATION_LINEAR == interpolation) {
+        resize_linear_run_u8(table, inWidthStride, inData, outWidthStride, outData);
+    } else if (INTERPOLATION_AREA == interpolation) {
+        resize_area_run_u8(table, inWidthStride, inData, outWidthStride, outData);
+    } else {
+        resize_nearest_run_u8(table, inWidthStride, inData, outWidthStride, outData);
+    }
+}
+
+static void resize_table_run(
+    const ResizeTable &table,
+    InterpolationType interpolation,
+    int32_t inWidthStride,
+    const float *inData,
+    int32_t outWidthStride,
+    float *outData)
+{
+    if (INTERPOLATION_LINEAR == interpolation) {
+        resize_linear_run_fp32(table, inWidthStride, inData, outWidthStride, outData);
+    } else if (INTERPOLATION_AREA == interpolation) {
+        resize_area_run_fp32(table, inWidthStride, inData, outWidthStride, outData);
+    } else {
+        resize_nearest_run_fp32(table, inWidthStride, inData, outWidthStride, outData);
+    }
+}
+
+template <typename T, int32_t channels>
+ResizePlan<T, channels>::ResizePlan()
+    : interpolation_(INTERPOLATION_LINEAR)
+    , table_(nullptr)
+{
+}
+
+template <typename T, int32_t channels>
+ResizePlan<T, channels>::~ResizePlan()
+{
+    if (nullptr != table_) {
+        resize_table_destroy(table_);
+        delete table_;
+    }
+}
+
+template <typename T, int32_t channels>
+::ppl::common::RetCode ResizePlan<T, channels>::Init(
+    int32_t inHeight,
+    int32_t inWidth,
+    int32_t outHeight,
+    int32_t outWidth,
+    InterpolationType interpolation)
+{
+    if (inHeight <= 0 || inWidth <= 0 || outHeight <= 0 || outWidth <= 0) {
+        return ppl::common::RC_INVALID_VALUE;
+    }
+    if (INTERPOLATION_LINEAR != interpolation &&
+        INTERPOLATION_NEAREST_POINT != interpolation &&
+        INTERPOLATION_AREA != interpolation) {
+        return ppl::common::RC_UNSUPPORTED;
+    }
+
+    if (nullptr == table_) {
+        table_ = new ResizeTable;
+    } else {
+        resize_table_destroy(table_);
+    }
+    interpolation_ = interpolation;
+
+    ::ppl::common::RetCode status = resize_table_create((const T *)nullptr, interpolation, inHeight, inWidth, channels, outHeight, outWidth, table_);
+    if (ppl::common::RC_SUCCESS != status) {
+        resize_table_destroy(table_);
+        delete table_;
+        table_ = nullptr;
+    }
+    return status;
+}
+
+template <typename T, int32_t channels>
+::ppl::common::RetCode ResizePlan<T, channels>::Apply(
+    int32_t inWidthStride,
+    const T *inData,
+    int32_t outWidthStride,
+    T *outData)
+{
+    if (nullptr == table_) {
+        return ppl::common::RC_INVALID_VALUE;
+    }
+    if (nullptr == inData) {
+        return ppl::common::RC_INVALID_VALUE;
+    }
+    if (nullptr == outData) {
+        return ppl::common::RC_INVALID_VALUE;
+    }
+    if (inWidthStride < table_->inWidth * channels || outWidthStride < table_->outWidth * channels) {
+        return ppl::common::RC_INVALID_VALUE;
+    }
+
+    resize_table_run(*table_, interpolation_, inWidthStride, inData, outWidthStride, outData);
+    return ppl::common::RC_SUCCESS;
+}
+
+template class ResizePlan<uint8_t, 1>;
+template class ResizePlan<uint8_t, 3>;
+template class ResizePlan<uint8_t, 4>;
+template class ResizePlan<float, 1>;
+template class ResizePlan<float, 3>;
+template class ResizePlan<float, 4>;
+
+}
+}
+} // namespace ppl::cv::x86
@@ -70,6 +70,29 @@ void ResizeNearestTest(int32_t inHeight, int32_t inWidth,
                     diff);
 }
 
+template<typename T, int32_t nc>
+void ResizeAreaTest(int32_t inHeight, int32_t inWidth,
+                    int32_t outHeight, int32_t outWidth, T diff) {
+    std::unique_ptr<T[]> src(new T[inWidth * inHeight * nc]);
+    std::unique_ptr<T[]> dst_ref(new T[outWidth * outHeight * nc]);
+    std::unique_ptr<T[]> dst(new T[outWidth * outHeight * nc]);
+    ppl::cv::debug::randomFill<T>(src.get(), inWidth * inHeight * nc, 0, 255);
+    cv::Mat src_opencv(inHeight, inWidth, CV_MAKETYPE(cv::DataType<T>::depth, nc), src.get(), sizeof(T) * inWidth * nc);
+    cv::Mat dst_opencv(outHeight, outWidth, CV_MAKETYPE(cv::DataType<T>::depth, nc), dst_ref.get(), sizeof(T) * outWidth * nc);
+
+    cv::resize(src_opencv, dst_opencv, cv::Size(outWidth, outHeight), 0, 0, cv::INTER_AREA);
+    auto rst = ppl::cv::x86::ResizeArea<T, nc>(inHeight, inWidth, inWidth * nc, src.get(),
+                                               outHeight, outWidth, outWidth * nc,
+                                               dst.get());
+
+    EXPECT_EQ(rst, ppl::common::RC_SUCCESS);
+
+    checkResult<T, nc>(dst_ref.get(), dst.get(),
+                    outHeight, outWidth,
+                    outWidth * nc, outWidth * nc,
+                    diff);
+}
+
 TEST(RESIZE_LINEAR_FP32, x86)
 {
     ResizeLinearTest<float, 1>(360, 540, 720, 1080, 1);
@@ -141,3 +164,112 @@ TEST(RESIZE_NEAREST_UINT8, x86)
     ResizeNearestTest<uint8_t, 4>(360, 540, 640, 480, 1);
     ResizeNearestTest<uint8_t, 4>(640, 480, 360, 540, 1);
 }
+
+TEST(RESIZE_AREA_FP32, x86)
+{
+    ResizeAreaTest<float, 1>(720, 1080, 360, 540, 1e-3f);
+    ResizeAreaTest<float, 1>(720, 1080, 180, 270, 1e-3f);
+    ResizeAreaTest<float, 1>(720, 1080, 240, 360, 1e-3f);
+    ResizeAreaTest<float, 1>(720, 1080, 480, 720, 1e-3f);
+    ResizeAreaTest<float, 1>(640, 480, 360, 540, 1e-3f);
+    ResizeAreaTest<float, 1>(360, 540, 720, 1080, 1e-3f);
+
+    ResizeAreaTest<float, 3>(720, 1080, 360, 540, 1e-3f);
+    ResizeAreaTest<float, 3>(720, 1080, 180, 270, 1e-3f);
+    ResizeAreaTest<float, 3>(720, 1080, 240, 360, 1e-3f);
+    ResizeAreaTest<float, 3>(720, 1080, 480, 720, 1e-3f);
+    ResizeAreaTest<float, 3>(640, 480, 360, 540, 1e-3f);
+    ResizeAreaTest<float, 3>(360, 540, 720, 1080, 1e-3f);
+
+    ResizeAreaTest<float, 4>(720, 1080, 360, 540, 1e-3f);
+    ResizeAreaTest<float, 4>(720, 1080, 180, 270, 1e-3f);
+    ResizeAreaTest<float, 4>(720, 1080, 240, 360, 1e-3f);
+    ResizeAreaTest<float, 4>(720, 1080, 480, 720, 1e-3f);
+    ResizeAreaTest<float, 4>(640, 480, 360, 540, 1e-3f);
+    ResizeAreaTest<float, 4>(360, 540, 720, 1080, 1e-3f);
+}
+
+TEST(RESIZE_AREA_UINT8, x86)
+{
+    ResizeAreaTest<uint8_t, 1>(720, 1080, 360, 540, 1);
+    ResizeAreaTest<uint8_t, 1>(720, 1080, 180, 270, 1);
+    ResizeAreaTest<uint8_t, 1>(720, 1080, 240, 360, 1);
+    ResizeAreaTest<uint8_t, 1>(720, 1080, 480, 720, 1);
+    ResizeAreaTest<uint8_t, 1>(640, 480, 360, 540, 1);
+    ResizeAreaTest<uint8_t, 1>(360, 540, 720, 1080, 1);
+
+    ResizeAreaTest<uint8_t, 3>(720, 1080, 360, 540, 1);
+    ResizeAreaTest<uint8_t, 3>(720, 1080, 180, 270, 1);
+    ResizeAreaTest<uint8_t, 3>(720, 1080, 240, 360, 1);
+    ResizeAreaTest<uint8_t, 3>(720, 1080, 480, 720, 1);
+    ResizeAreaTest<uint8_t, 3>(640, 480, 360, 540, 1);
+    ResizeAreaTest<uint8_t, 3>(360, 540, 720, 1080, 1);
+
+    ResizeAreaTest<uint8_t, 4>(720, 1080, 360, 540, 1);
+    ResizeAreaTest<uint8_t, 4>(720, 1080, 180, 270, 1);
+    ResizeAreaTest<uint8_t, 4>(720, 1080, 240, 360, 1);
+    ResizeAreaTest<uint8_t, 4>(720, 1080, 480, 720, 1);
+    ResizeAreaTest<uint8_t, 4>(640, 480, 360, 540, 1);
+    ResizeAreaTest<uint8_t, 4>(360, 540, 720, 1080, 1);
+}
+
+// A plan applied to several frames gives the same images as the one-shot calls.
+template<typename T, int32_t nc>
+void ResizePlanTest(int32_t inHeight, int32_t inWidth,
+                    int32_t outHeight, int32_t outWidth, ppl::cv::InterpolationType interpolation) {
+    std::unique_ptr<T[]> src(new T[inWidth * inHeight * nc]);
+    std::unique_ptr<T[]> dst_ref(new T[outWidth * outHeight * nc]);
+    std::unique_ptr<T[]> dst(new T[outWidth * outHeight * nc]);
+
+    ppl::cv::x86::ResizePlan<T, nc> plan;
+    EXPECT_EQ(plan.Apply(inWidth * nc, src.get(), outWidth * nc, dst.get()), ppl::common::RC_INVALID_VALUE);
+    EXPECT_EQ(plan.Init(inHeight, inWidth, outHeight, outWidth, interpolation), ppl::common::RC_SUCCESS);
+    EXPECT_EQ(plan.Apply(inWidth * nc - 1, src.get(), outWidth * nc, dst.get()), ppl::common::RC_INVALID_VALUE);
+    EXPECT_EQ(plan.Apply(inWidth * nc, src.get(), outWidth * nc - 1, dst.get()), ppl::common::RC_INVALID_VALUE);
+
+    for (int32_t frame = 0; frame < 3; ++frame) {
+        ppl::cv::debug::randomFill<T>(src.get(), inWidth * inHeight * nc, 0, 255);
+        if (interpolation == ppl::cv::INTERPOLATION_LINEAR) {
+            ppl::cv::x86::ResizeLinear<T, nc>(inHeight, inWidth, inWidth * nc, src.get(),
+                                              outHeight, outWidth, outWidth * nc, dst_ref.get());
+        } else if (interpolation == ppl::cv::INTERPOLATION_AREA) {
+            ppl::cv::x86::ResizeArea<T, nc>(inHeight, inWidth, inWidth * nc, src.get(),
+                                            outHeight, outWidth, outWidth * nc, dst_ref.get());
+        } else {
+            ppl::cv::x86::ResizeNearestPoint<T, nc>(inHeight, inWidth, inWidth * nc, src.get(),
+                                                    outHeight, outWidth, outWidth * nc, dst_ref.get());
+        }
+        auto rst = plan.Apply(inWidth * nc, src.get(), outWidth * nc, dst.get());
+        EXPECT_EQ(rst, ppl::common::RC_SUCCESS);
+
+        checkResult<T, nc>(dst_ref.get(), dst.get(),
+                        outHeight, outWidth,
+                        outWidth * nc, outWidth * nc,
+                        1e-6f);
+    }
+}
+
+TEST(RESIZE_PLAN, x86)
+{
+    ResizePlanTest<uint8_t, 1>(720, 1080, 360, 540, ppl::cv::INTERPOLATION_LINEAR);
+    ResizePlanTest<uint8_t, 1>(640, 480, 360, 540, ppl::cv::INTERPOLATION_LINEAR);
+    ResizePlanTest<uint8_t, 3>(360, 540, 640, 480, ppl::cv::INTERPOLATION_LINEAR);
+    ResizePlanTest<uint8_t, 4>(720, 1080, 360, 540, ppl::cv::INTERPOLATION_LINEAR);
+    ResizePlanTest<float, 1>(360, 540, 720, 1080, ppl::cv::INTERPOLATION_LINEAR);
+    ResizePlanTest<float, 3>(720, 1080, 360, 540, ppl::cv::INTERPOLATION_LINEAR);
+    ResizePlanTest<float, 4>(640, 480, 360, 540, ppl::cv::INTERPOLATION_LINEAR);
+
+    ResizePlanTest<uint8_t, 1>(360, 540, 640, 480, ppl::cv::INTERPOLATION_NEAREST_POINT);
+    ResizePlanTest<uint8_t, 3>(720, 1080, 360, 540, ppl::cv::INTERPOLATION_NEAREST_POINT);
+    ResizePlanTest<float, 4>(360, 540, 720, 1080, ppl::cv::INTERPOLATION_NEAREST_POINT);
+
+    ResizePlanTest<uint8_t, 1>(720, 1080, 360, 540, ppl::cv::INTERPOLATION_AREA);
+    ResizePlanTest<uint8_t, 3>(720, 1080, 480, 720, ppl::cv::INTERPOLATION_AREA);
+    ResizePlanTest<uint8_t, 4>(360, 540, 640, 480, ppl::cv::INTERPOLATION_AREA);
+    ResizePlanTest<float, 3>(720, 1080, 180, 270, ppl::cv::INTERPOLATION_AREA);
+    ResizePlanTest<float, 4>(640, 480, 360, 540, ppl::cv::INTERPOLATION_AREA);
+
+    ppl::cv::x86::ResizePlan<uint8_t, 3> plan;
+    EXPECT_EQ(plan.Init(0, 540, 360, 540, ppl::cv::INTERPOLATION_LINEAR), ppl::common::RC_INVALID_VALUE);
+    EXPECT_EQ(plan.Init(720, 1080, 360, 540, (ppl::cv::InterpolationType)3), ppl::common::RC_UNSUPPORTED);
+}
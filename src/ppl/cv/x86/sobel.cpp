@@ -14,372 +14,278 @@
 // KIND, either express or implied.  See the License for the
 // specific language governing permissions and limitations
 // under the License.
-
 #include "ppl/cv/x86/sobel.h"
-#include "ppl/cv/x86/avx/internal_avx.hpp"
-#include "ppl/cv/x86/fma/internal_fma.hpp"
-#include "intrinutils.hpp"
+#include "ppl/cv/x86/filter_engine.hpp"
 #include "ppl/cv/types.h"
 #include "ppl/common/sys.h"
 #include "ppl/common/retcode.h"
-#include "ppl/common/x86/sysinfo.h"
 #include <string.h>
 #include <cmath>
-#include <assert.h>
 #include <immintrin.h>
+#include <vector>
 
 namespace ppl {
 namespace cv {
 namespace x86 {
 
-void getScharrKernels_f32(
-    float *kx,
-    float *ky,
-    int32_t &ksizeX,
-    int32_t &ksizeY,
+// Integer Sobel or Scharr kernels of the x and y derivatives, without the
+// scale. Returns false for the orders and sizes that have no kernel.
+static bool getSobelKernels(
+    std::vector<int32_t> &kx,
+    std::vector<int32_t> &ky,
     int32_t dx,
     int32_t dy,
-    double scale)
-{
-    if (dx == 0) {
-        kx[0] = 3 * scale;
-        kx[1] = 10 * scale;
-        kx[2] = 3 * scale;
-    } else if (dx == 1) {
-        kx[0] = -scale;
-        kx[1] = 0;
-        kx[2] = scale;
-    }
-
-    if (dy == 0) {
-        ky[0] = 3 * scale;
-        ky[1] = 10 * scale;
-        ky[2] = 3 * scale;
-    } else if (dy == 1) {
-        ky[0] = -scale;
-        ky[1] = 0;
-        ky[2] = scale;
-    }
-
-    ksizeX = 3;
-    ksizeY = 3;
-}
-
-void getSobelKernels_f32(
-    float *kx,
-    float *ky,
-    int32_t &ksizeX,
-    int32_t &ksizeY,
-    int32_t dx,
-    int32_t dy,
-    double scale,
     int32_t ksize)
 {
-    if (ksize == -1) {
-        getScharrKernels_f32(kx, ky, ksizeX, ksizeY, dx, dy, scale);
-        return;
+    if (dx < 0 || dy < 0 || dx + dy <= 0) {
+        return false;
     }
-
-    int32_t i, j;
-
-    ksizeX = ksize;
-    ksizeY = ksize;
-    if (ksizeX == 1 && dx > 0) {
-        ksizeX = 3;
+    if (ksize == -1) {
+        if (dx + dy != 1) {
+            return false;
+        }
+        kx = dx == 0 ? std::vector<int32_t>{3, 10, 3} : std::vector<int32_t>{-1, 0, 1};
+        ky = dy == 0 ? std::vector<int32_t>{3, 10, 3} : std::vector<int32_t>{-1, 0, 1};
+        return true;
     }
-    if (ksizeY == 1 && dy > 0) {
-        ksizeY = 3;
+    if (ksize != 1 && ksize != 3 && ksize != 5 && ksize != 7) {
+        return false;
     }
 
-    float kerI[33];
-
     for (int32_t k = 0; k < 2; ++k) {
-        float *kernel = k == 0 ? kx : ky;
-        int32_t order = k == 0 ? dx : dy;
-        int32_t ksize = k == 0 ? ksizeX : ksizeY;
+        std::vector<int32_t> &kernel = k == 0 ? kx : ky;
+        int32_t order                = k == 0 ? dx : dy;
+        int32_t size                 = ksize == 1 && order > 0 ? 3 : ksize;
+        if (order >= size) {
+            return false;
+        }
 
-        if (ksize == 1) {
-            kerI[0] = 1;
-        } else if (ksize == 3) {
-            if (order == 0) {
-                kerI[0] = 1;
-                kerI[1] = 2;
-                kerI[2] = 1;
-            } else if (order == 1) {
-                kerI[0] = -1;
-                kerI[1] = 0;
-                kerI[2] = 1;
-            } else {
-                kerI[0] = 1;
-                kerI[1] = -2;
-                kerI[2] = 1;
-            }
-        } else {
-            int32_t oldval, newval;
-            kerI[0] = 1;
-            for (i = 0; i < ksize; ++i) {
-                kerI[i + 1] = 0;
-            }
-            for (i = 0; i < ksize - order - 1; ++i) {
-                oldval = kerI[0];
-                for (j = 1; j <= ksize; ++j) {
-                    newval      = kerI[j] + kerI[j - 1];
-                    kerI[j - 1] = oldval;
-                    oldval      = newval;
+        kernel.assign(size + 1, 0);
+        kernel[0] = 1;
+        if (size == 3) {
+            static const int32_t k3[3][3] = {{1, 2, 1}, {-1, 0, 1}, {1, -2, 1}};
+            kernel.assign(k3[order], k3[order] + 3);
+        } else if (size > 1) {
+            // binomial smoothing convolved with `order` differences
+            for (int32_t i = 0; i < size - order - 1; ++i) {
+                int32_t oldval = kernel[0];
+                for (int32_t j = 1; j <= size; ++j) {
+                    int32_t newval = kernel[j] + kernel[j - 1];
+                    kernel[j - 1]  = oldval;
+                    oldval         = newval;
                 }
             }
-
-            for (i = 0; i < order; ++i) {
-                oldval = -kerI[0];
-                for (j = 1; j <= ksize; ++j) {
-                    newval      = kerI[j - 1] - kerI[j];
-                    kerI[j - 1] = oldval;
-                    oldval      = newval;
+            for (int32_t i = 0; i < order; ++i) {
+                int32_t oldval = -kernel[0];
+                for (int32_t j = 1; j <= size; ++j) {
+                    int32_t newval = kernel[j - 1] - kernel[j];
+                    kernel[j - 1]  = oldval;
+                    oldval         = newval;
                 }
             }
         }
-
-        for (i = 0; i < ksize; ++i) {
-            kernel[i] = kerI[i] * scale;
-        }
+        kernel.resize(size);
     }
+    return true;
 }
 
-void sobel_kernel_reflect101_f32(
-    int32_t height,
-    int32_t width,
-    int32_t channels,
-    int32_t inWidthStride,
-    const float *inData,
-    int32_t dx,
-    int32_t dy,
-    int32_t ksize,
-    double scale,
-    double delta,
-    int32_t outWidthStride,
-    float *outData)
-{
-    float kx[33];
-    float ky[33];
-    int32_t ksizeX = 0;
-    int32_t ksizeY = 0;
-
-    getSobelKernels_f32(kx, ky, ksizeX, ksizeY, dx, dy, scale, ksize);
-
-    int32_t x_r = ksizeX / 2;
-    int32_t y_r = ksizeY / 2;
-
-    float sum[4] = {};
-
-    for (int32_t i = 0; i < height; ++i) {
-        for (int32_t j = 0; j < width; ++j) {
-            for (int32_t c = 0; c < channels; ++c) {
-                sum[c] = delta;
+struct SobelRowVec_32f {
+    SobelRowVec_32f(const std::vector<int32_t> &_kernel)
+        : kernel(_kernel.begin(), _kernel.end()) {}
+
+    void operator()(const float *src, float *dst, int32_t width, int32_t cn) const
+    {
+        int32_t ksize = kernel.size();
+        int32_t i     = 0;
+        width *= cn;
+        for (; i <= width - 8; i += 8) {
+            const float *S = src + i;
+            __m128 s0 = _mm_setzero_ps(), s1 = s0;
+            for (int32_t k = 0; k < ksize; k++, S += cn) {
+                __m128 f = _mm_set1_ps(kernel[k]);
+                s0       = _mm_add_ps(s0, _mm_mul_ps(_mm_loadu_ps(S), f));
+                s1       = _mm_add_ps(s1, _mm_mul_ps(_mm_loadu_ps(S + 4), f));
             }
-
-            for (int32_t ii = -y_r; ii <= y_r; ++ii) {
-                for (int32_t jj = -x_r; jj <= x_r; ++jj) {
-                    int32_t y = i + ii;
-                    int32_t x = j + jj;
-                    if (y < 0) {
-                        y = -y;
-                    }
-                    if (x < 0) {
-                        x = -x;
-                    }
-                    if (y >= height) {
-                        y = (height - 2 - (y - height));
-                    }
-                    if (x >= width) {
-                        x = (width - 2 - (x - width));
-                    }
-
-                    for (int32_t c = 0; c < channels; ++c) {
-                        sum[c] += ky[ii + y_r] * kx[jj + x_r] * inData[y * inWidthStride + x * channels + c];
-                    }
-                }
-            }
-
-            for (int32_t c = 0; c < channels; ++c) {
-                outData[i * outWidthStride + j * channels + c] = sum[c];
+            _mm_store_ps(dst + i, s0);
+            _mm_store_ps(dst + i + 4, s1);
+        }
+        for (; i < width; i++) {
+            const float *S = src + i;
+            float s        = 0;
+            for (int32_t k = 0; k < ksize; k++, S += cn) {
+                s += S[0] * kernel[k];
             }
+            dst[i] = s;
         }
     }
-}
-
-void getScharrKernels_u8(
-    int16_t *kx,
-    int16_t *ky,
-    int32_t &ksizeX,
-    int32_t &ksizeY,
-    int32_t dx,
-    int32_t dy,
-    double scale)
-{
-    if (dx == 0) {
-        kx[0] = 3 * scale;
-        kx[1] = 10 * scale;
-        kx[2] = 3 * scale;
-    } else if (dx == 1) {
-        kx[0] = -scale;
-        kx[1] = 0;
-        kx[2] = scale;
-    }
-
-    if (dy == 0) {
-        ky[0] = 3 * scale;
-        ky[1] = 10 * scale;
-        ky[2] = 3 * scale;
-    } else if (dy == 1) {
-        ky[0] = -scale;
-        ky[1] = 0;
-        ky[2] = scale;
-    }
-
-    ksizeX = 3;
-    ksizeY = 3;
-}
-
-void getSobelKernels_u8(
-    int16_t *kx,
-    int16_t *ky,
-    int32_t &ksizeX,
-    int32_t &ksizeY,
-    int32_t dx,
-    int32_t dy,
-    double scale,
-    int32_t ksize)
-{
-    if (ksize == -1) {
-        getScharrKernels_u8(kx, ky, ksizeX, ksizeY, dx, dy, scale);
-        return;
+    std::vector<float> kernel;
+};
+
+struct SobelColumnVec_32f {
+    SobelColumnVec_32f(const std::vector<int32_t> &_kernel, double scale, double _delta)
+        : delta(_delta)
+    {
+        for (size_t i = 0; i < _kernel.size(); i++) {
+            kernel.push_back((float)(_kernel[i] * scale));
+        }
     }
 
-    int32_t i, j;
-
-    ksizeX = ksize;
-    ksizeY = ksize;
-    if (ksizeX == 1 && dx > 0) {
-        ksizeX = 3;
-    }
-    if (ksizeY == 1 && dy > 0) {
-        ksizeY = 3;
+    void operator()(const float **src, float *dst, int32_t dststep, int32_t count, int32_t width) const
+    {
+        int32_t ksize = kernel.size();
+        __m128 d4     = _mm_set1_ps(delta);
+        for (; count-- > 0; src++, dst += dststep) {
+            int32_t i = 0;
+            for (; i <= width - 8; i += 8) {
+                __m128 s0 = d4, s1 = d4;
+                for (int32_t k = 0; k < ksize; k++) {
+                    __m128 f = _mm_set1_ps(kernel[k]);
+                    s0       = _mm_add_ps(s0, _mm_mul_ps(_mm_load_ps(src[k] + i), f));
+                    s1       = _mm_add_ps(s1, _mm_mul_ps(_mm_load_ps(src[k] + i + 4), f));
+                }
+                _mm_storeu_ps(dst + i, s0);
+                _mm_storeu_ps(dst + i + 4, s1);
+            }
+            for (; i < width; i++) {
+                float s = delta;
+                for (int32_t k = 0; k < ksize; k++) {
+                    s += src[k][i] * kernel[k];
+                }
+                dst[i] = s;
+            }
+        }
     }
-
-    int16_t kerI[33];
-
-    for (int32_t k = 0; k < 2; ++k) {
-        int16_t *kernel = k == 0 ? kx : ky;
-        int32_t order   = k == 0 ? dx : dy;
-        int32_t ksize   = k == 0 ? ksizeX : ksizeY;
-
-        if (ksize == 1) {
-            kerI[0] = 1;
-        } else if (ksize == 3) {
-            if (order == 0) {
-                kerI[0] = 1;
-                kerI[1] = 2;
-                kerI[2] = 1;
-            } else if (order == 1) {
-                kerI[0] = -1;
-                kerI[1] = 0;
-                kerI[2] = 1;
-            } else {
-                kerI[0] = 1;
-                kerI[1] = -2;
-                kerI[2] = 1;
+    std::vector<float> kernel;
+    float delta;
+};
+
+// uint8_t rows are filtered exactly in int32_t; the scale and delta are
+// applied once per output pixel in float.
+struct SobelRowVec_8u32s {
+    SobelRowVec_8u32s(const std::vector<int32_t> &_kernel)
+        : kernel(_kernel) {}
+
+    void operator()(const uint8_t *src, int32_t *dst, int32_t width, int32_t cn) const
+    {
+        int32_t ksize = kernel.size();
+        int32_t i     = 0;
+        width *= cn;
+        for (; i <= width - 8; i += 8) {
+            const uint8_t *S = src + i;
+            __m128i s0 = _mm_setzero_si128(), s1 = s0;
+            for (int32_t k = 0; k < ksize; k++, S += cn) {
+                __m128i f  = _mm_set1_epi32(kernel[k]);
+                __m128i x0 = _mm_cvtepu8_epi32(_mm_cvtsi32_si128(*(const int32_t *)S));
+                __m128i x1 = _mm_cvtepu8_epi32(_mm_cvtsi32_si128(*(const int32_t *)(S + 4)));
+                s0         = _mm_add_epi32(s0, _mm_mullo_epi32(x0, f));
+                s1         = _mm_add_epi32(s1, _mm_mullo_epi32(x1, f));
             }
-        } else {
-            int32_t oldval, newval;
-            kerI[0] = 1;
-            for (i = 0; i < ksize; ++i) {
-                kerI[i + 1] = 0;
+            _mm_store_si128((__m128i *)(dst + i), s0);
+            _mm_store_si128((__m128i *)(dst + i + 4), s1);
+        }
+        for (; i < width; i++) {
+            const uint8_t *S = src + i;
+            int32_t s        = 0;
+            for (int32_t k = 0; k < ksize; k++, S += cn) {
+                s += S[0] * kernel[k];
             }
-            for (i = 0; i < ksize - order - 1; ++i) {
-                oldval = kerI[0];
-                for (j = 1; j <= ksize; ++j) {
-                    newval      = kerI[j] + kerI[j - 1];
-                    kerI[j - 1] = oldval;
-                    oldval      = newval;
+            dst[i] = s;
+        }
+    }
+    std::vector<int32_t> kernel;
+};
+
+struct SobelColumnVec_32s16s {
+    SobelColumnVec_32s16s(const std::vector<int32_t> &_kernel, double _scale, double _delta)
+        : kernel(_kernel)
+        , scale(_scale)
+        , delta(_delta) {}
+
+    void operator()(const int32_t **src, int16_t *dst, int32_t dststep, int32_t count, int32_t width) const
+    {
+        int32_t ksize = kernel.size();
+        __m128 scale4 = _mm_set1_ps(scale);
+        __m128 d4     = _mm_set1_ps(delta);
+        for (; count-- > 0; src++, dst += dststep) {
+            int32_t i = 0;
+            for (; i <= width - 8; i += 8) {
+                __m128i s0 = _mm_setzero_si128(), s1 = s0;
+                for (int32_t k = 0; k < ksize; k++) {
+                    __m128i f = _mm_set1_epi32(kernel[k]);
+                    s0        = _mm_add_epi32(s0, _mm_mullo_epi32(_mm_load_si128((const __m128i *)(src[k] + i)), f));
+                    s1        = _mm_add_epi32(s1, _mm_mullo_epi32(_mm_load_si128((const __m128i *)(src[k] + i + 4)), f));
                 }
+                __m128 f0 = _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(s0), scale4), d4);
+                __m128 f1 = _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(s1), scale4), d4);
+                _mm_storeu_si128((__m128i *)(dst + i), _mm_packs_epi32(_mm_cvtps_epi32(f0), _mm_cvtps_epi32(f1)));
             }
-
-            for (i = 0; i < order; ++i) {
-                oldval = -kerI[0];
-                for (j = 1; j <= ksize; ++j) {
-                    newval      = kerI[j - 1] - kerI[j];
-                    kerI[j - 1] = oldval;
-                    oldval      = newval;
+            for (; i < width; i++) {
+                int32_t s = 0;
+                for (int32_t k = 0; k < ksize; k++) {
+                    s += src[k][i] * kernel[k];
                 }
+                int32_t v = _mm_cvtss_si32(_mm_set_ss(s * scale + delta));
+                dst[i]    = (int16_t)std::min(std::max(v, (int32_t)INT16_MIN), (int32_t)INT16_MAX);
             }
         }
+    }
+    std::vector<int32_t> kernel;
+    float scale;
+    float delta;
+};
 
-        for (i = 0; i < ksize; ++i) {
-            kernel[i] = kerI[i] * scale;
-        }
+template <int32_t nc>
+static ::ppl::common::RetCode sobel_f32(
+    int32_t height,
+    int32_t width,
+    int32_t inWidthStride,
+    const float *inData,
+    int32_t outWidthStride,
+    float *outData,
+    int32_t dx,
+    int32_t dy,
+    int32_t ksize,
+    double scale,
+    double delta,
+    BorderType border_type)
+{
+    std::vector<int32_t> kx, ky;
+    if (inData == nullptr || outData == nullptr || height <= 0 || width <= 0 ||
+        inWidthStride < width * nc || outWidthStride < width * nc ||
+        !getSobelKernels(kx, ky, dx, dy, ksize) || !filter_border_supported(border_type)) {
+        return ppl::common::RC_INVALID_VALUE;
     }
+    SeparableFilterEngine<float, float, float, SobelRowVec_32f, SobelColumnVec_32f> engine(
+        height, width, nc, ky.size(), kx.size(), border_type, 0.f, SobelRowVec_32f(kx), SobelColumnVec_32f(ky, scale, delta));
+    engine.process(inData, inWidthStride, outData, outWidthStride);
+    return ppl::common::RC_SUCCESS;
 }
 
-void sobel_kernel_reflect101_u8(
+template <int32_t nc>
+static ::ppl::common::RetCode sobel_u8(
     int32_t height,
     int32_t width,
-    int32_t channels,
     int32_t inWidthStride,
     const uint8_t *inData,
+    int32_t outWidthStride,
+    int16_t *outData,
     int32_t dx,
     int32_t dy,
     int32_t ksize,
     double scale,
     double delta,
-    int32_t outWidthStride,
-    int16_t *outData)
+    BorderType border_type)
 {
-    int16_t kx[33];
-    int16_t ky[33];
-    int32_t ksizeX = 0;
-    int32_t ksizeY = 0;
-
-    getSobelKernels_u8(kx, ky, ksizeX, ksizeY, dx, dy, scale, ksize);
-
-    int32_t x_r = ksizeX / 2;
-    int32_t y_r = ksizeY / 2;
-
-    int16_t sum[4] = {};
-
-    for (int32_t i = 0; i < height; ++i) {
-        for (int32_t j = 0; j < width; ++j) {
-            for (int32_t c = 0; c < channels; ++c) {
-                sum[c] = delta;
-            }
-
-            for (int32_t ii = -y_r; ii <= y_r; ++ii) {
-                for (int32_t jj = -x_r; jj <= x_r; ++jj) {
-                    int32_t y = i + ii;
-                    int32_t x = j + jj;
-                    if (y < 0) {
-                        y = -y;
-                    }
-                    if (x < 0) {
-                        x = -x;
-                    }
-                    if (y >= height) {
-                        y = (height - 2 - (y - height));
-                    }
-                    if (x >= width) {
-                        x = (width - 2 - (x - width));
-                    }
-
-                    for (int32_t c = 0; c < channels; ++c) {
-                        sum[c] += ky[ii + y_r] * kx[jj + x_r] * inData[y * inWidthStride + x * channels + c];
-                    }
-                }
-            }
-
-            for (int32_t c = 0; c < channels; ++c) {
-                outData[i * outWidthStride + j * channels + c] = sum[c];
-            }
-        }
+    std::vector<int32_t> kx, ky;
+    if (inData == nullptr || outData == nullptr || height <= 0 || width <= 0 ||
+        inWidthStride < width * nc || outWidthStride < width * nc ||
+        !getSobelKernels(kx, ky, dx, dy, ksize) || !filter_border_supported(border_type)) {
+        return ppl::common::RC_INVALID_VALUE;
     }
+    SeparableFilterEngine<uint8_t, int32_t, int16_t, SobelRowVec_8u32s, SobelColumnVec_32s16s> engine(
+        height, width, nc, ky.size(), kx.size(), border_type, 0, SobelRowVec_8u32s(kx), SobelColumnVec_32s16s(ky, scale, delta));
+    engine.process(inData, inWidthStride, outData, outWidthStride);
+    return ppl::common::RC_SUCCESS;
 }
 
 template <>
@@ -397,9 +303,7 @@ template <>
     double delta,
     BorderType border_type)
 {
-    assert(border_type == ppl::cv::BORDER_REFLECT_101);
-    sobel_kernel_reflect101_f32(height, width, 1, inWidthStride, inData, dx, dy, ksize, scale, delta, outWidthStride, outData);
-    return ppl::common::RC_SUCCESS;
+    return sobel_f32<1>(height, width, inWidthStride, inData, outWidthStride, outData, dx, dy, ksize, scale, delta, border_type);
 }
 
 template <>
@@ -417,9 +321,7 @@ template <>
     double delta,
     BorderType border_type)
 {
-    assert(border_type == ppl::cv::BORDER_REFLECT_101);
-    sobel_kernel_reflect101_f32(height, width, 3, inWidthStride, inData, dx, dy, ksize, scale, delta, outWidthStride, outData);
-    return ppl::common::RC_SUCCESS;
+    return sobel_f32<3>(height, width, inWidthStride, inData, outWidthStride, outData, dx, dy, ksize, scale, delta, border_type);
 }
 
 template <>
@@ -437,9 +339,7 @@ template <>
     double delta,
     BorderType border_type)
 {
-    assert(border_type == ppl::cv::BORDER_REFLECT_101);
-    sobel_kernel_reflect101_f32(height, width, 4, inWidthStride, inData, dx, dy, ksize, scale, delta, outWidthStride, outData);
-    return ppl::common::RC_SUCCESS;
+    return sobel_f32<4>(height, width, inWidthStride, inData, outWidthStride, outData, dx, dy, ksize, scale, delta, border_type);
 }
 
 template <>
@@ -457,9 +357,7 @@ template <>
     double delta,
     BorderType border_type)
 {
-    assert(border_type == ppl::cv::BORDER_REFLECT_101);
-    sobel_kernel_reflect101_u8(height, width, 1, inWidthStride, inData, dx, dy, ksize, scale, delta, outWidthStride, outData);
-    return ppl::common::RC_SUCCESS;
+    return sobel_u8<1>(height, width, inWidthStride, inData, outWidthStride, outData, dx, dy, ksize, scale, delta, border_type);
 }
 
 template <>
@@ -477,9 +375,7 @@ template <>
     double delta,
     BorderType border_type)
 {
-    assert(border_type == ppl::cv::BORDER_REFLECT_101);
-    sobel_kernel_reflect101_u8(height, width, 3, inWidthStride, inData, dx, dy, ksize, scale, delta, outWidthStride, outData);
-    return ppl::common::RC_SUCCESS;
+    return sobel_u8<3>(height, width, inWidthStride, inData, outWidthStride, outData, dx, dy, ksize, scale, delta, border_type);
 }
 
 template <>
@@ -497,9 +393,7 @@ template <>
     double delta,
     BorderType border_type)
 {
-    assert(border_type == ppl::cv::BORDER_REFLECT_101);
-    sobel_kernel_reflect101_u8(height, width, 4, inWidthStride, inData, dx, dy, ksize, scale, delta, outWidthStride, outData);
-    return ppl::common::RC_SUCCESS;
+    return sobel_u8<4>(height, width, inWidthStride, inData, outWidthStride, outData, dx, dy, ksize, scale, delta, border_type);
 }
 
 }
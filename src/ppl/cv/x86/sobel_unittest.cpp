@@ -23,7 +23,7 @@
 #include "ppl/cv/debug.h"
 #include "ppl/common/retcode.h"
 
-template <typename Tsrc, int c, typename Tdst>
+template <typename Tsrc, int c, typename Tdst, ppl::cv::BorderType border_type>
 class Sobel : public ::testing::TestWithParam<std::tuple<Size, int, int, int, double, double>> {
 public:
     using SobelParam = std::tuple<Size, int, int, int, double, double>;
@@ -50,35 +50,76 @@ public:
         std::unique_ptr<Tdst[]> dst(new Tdst[size.width * size.height * c]);
         std::unique_ptr<Tdst[]> dst_opencv(new Tdst[size.width * size.height * c]);
 
-        ppl::cv::x86::Sobel<Tsrc, Tdst, c>(size.height, size.width, size.width * c, src.get(), size.width * c, dst.get(), dx, dy, ksize, scale, delta, ppl::cv::BORDER_DEFAULT);
+        ppl::cv::x86::Sobel<Tsrc, Tdst, c>(size.height, size.width, size.width * c, src.get(), size.width * c, dst.get(), dx, dy, ksize, scale, delta, border_type);
 
         ::cv::Mat iMat(size.height, size.width, CV_MAKETYPE(cv::DataType<Tsrc>::depth, c), src.get());
         ::cv::Mat oMat(size.height, size.width, CV_MAKETYPE(cv::DataType<Tdst>::depth, c), dst_opencv.get());
 
-        ::cv::Sobel(iMat, oMat, oMat.depth(), dx, dy, ksize, scale, delta, ::cv::BORDER_REFLECT_101);
+        if (border_type == ppl::cv::BORDER_WRAP) {
+            // OpenCV filters reject BORDER_WRAP, so filter a wrapped copy and crop it.
+            int radius = ksize > 1 ? ksize / 2 : 1;
+            ::cv::Mat padded, filtered;
+            ::cv::copyMakeBorder(iMat, padded, radius, radius, radius, radius, ::cv::BORDER_WRAP);
+            ::cv::Sobel(padded, filtered, oMat.depth(), dx, dy, ksize, scale, delta, ::cv::BORDER_REPLICATE);
+            filtered(::cv::Rect(radius, radius, size.width, size.height)).copyTo(oMat);
+        } else {
+            ::cv::Sobel(iMat, oMat, oMat.depth(), dx, dy, ksize, scale, delta, (int)border_type);
+        }
         checkResult<Tdst, c>(
             dst.get(),
             dst_opencv.get(),
-            size.width,
             size.height,
-            size.height * c,
-            size.height * c,
+            size.width,
+            size.width * c,
+            size.width * c,
             1.01f);
     }
 };
 
-#define R(name, ts, c, td)         \
-    using name = Sobel<ts, c, td>; \
-    TEST_P(name, abc)              \
-    {                              \
-        this->apply(GetParam());   \
-    }                              \
-    INSTANTIATE_TEST_CASE_P(standard, name, ::testing::Combine(::testing::Values(Size{10, 8}), ::testing::Values(1, 2), ::testing::Values(1, 2), ::testing::Values(1, 3, 5), ::testing::Values(1.0), ::testing::Values(0.0)));
-
-R(Sobel_f32c1, float, 1, float)
-R(Sobel_f32c3, float, 3, float)
-R(Sobel_f32c4, float, 4, float)
-
-R(Sobel_u8c1, uint8_t, 1, int16_t)
-R(Sobel_u8c3, uint8_t, 3, int16_t)
-R(Sobel_u8c4, uint8_t, 4, int16_t)
+#define R(name, ts, c, td, b)         \
+    using name = Sobel<ts, c, td, b>; \
+    TEST_P(name, abc)                 \
+    {                                 \
+        this->apply(GetParam());      \
+    }                                 \
+    INSTANTIATE_TEST_CASE_P(standard, name, ::testing::Combine(::testing::Values(Size{10, 8}, Size{320, 240}, Size{321, 241}), ::testing::Values(1, 2), ::testing::Values(1, 2), ::testing::Values(1, 3, 5, 7), ::testing::Values(1.0, 0.5), ::testing::Values(0.0, 3.0)));
+
+R(Sobel_f32c1, float, 1, float, ppl::cv::BORDER_DEFAULT)
+R(Sobel_f32c3, float, 3, float, ppl::cv::BORDER_DEFAULT)
+R(Sobel_f32c4, float, 4, float, ppl::cv::BORDER_DEFAULT)
+
+R(Sobel_u8c1, uint8_t, 1, int16_t, ppl::cv::BORDER_DEFAULT)
+R(Sobel_u8c3, uint8_t, 3, int16_t, ppl::cv::BORDER_DEFAULT)
+R(Sobel_u8c4, uint8_t, 4, int16_t, ppl::cv::BORDER_DEFAULT)
+
+R(Sobel_f32c1_reflect, float, 1, float, ppl::cv::BORDER_REFLECT)
+R(Sobel_f32c3_reflect, float, 3, float, ppl::cv::BORDER_REFLECT)
+R(Sobel_f32c4_reflect, float, 4, float, ppl::cv::BORDER_REFLECT)
+
+R(Sobel_u8c1_reflect, uint8_t, 1, int16_t, ppl::cv::BORDER_REFLECT)
+R(Sobel_u8c3_reflect, uint8_t, 3, int16_t, ppl::cv::BORDER_REFLECT)
+R(Sobel_u8c4_reflect, uint8_t, 4, int16_t, ppl::cv::BORDER_REFLECT)
+
+R(Sobel_f32c1_replicate, float, 1, float, ppl::cv::BORDER_REPLICATE)
+R(Sobel_f32c3_replicate, float, 3, float, ppl::cv::BORDER_REPLICATE)
+R(Sobel_f32c4_replicate, float, 4, float, ppl::cv::BORDER_REPLICATE)
+
+R(Sobel_u8c1_replicate, uint8_t, 1, int16_t, ppl::cv::BORDER_REPLICATE)
+R(Sobel_u8c3_replicate, uint8_t, 3, int16_t, ppl::cv::BORDER_REPLICATE)
+R(Sobel_u8c4_replicate, uint8_t, 4, int16_t, ppl::cv::BORDER_REPLICATE)
+
+R(Sobel_f32c1_constant, float, 1, float, ppl::cv::BORDER_CONSTANT)
+R(Sobel_f32c3_constant, float, 3, float, ppl::cv::BORDER_CONSTANT)
+R(Sobel_f32c4_constant, float, 4, float, ppl::cv::BORDER_CONSTANT)
+
+R(Sobel_u8c1_constant, uint8_t, 1, int16_t, ppl::cv::BORDER_CONSTANT)
+R(Sobel_u8c3_constant, uint8_t, 3, int16_t, ppl::cv::BORDER_CONSTANT)
+R(Sobel_u8c4_constant, uint8_t, 4, int16_t, ppl::cv::BORDER_CONSTANT)
+
+R(Sobel_f32c1_wrap, float, 1, float, ppl::cv::BORDER_WRAP)
+R(Sobel_f32c3_wrap, float, 3, float, ppl::cv::BORDER_WRAP)
+R(Sobel_f32c4_wrap, float, 4, float, ppl::cv::BORDER_WRAP)
+
+R(Sobel_u8c1_wrap, uint8_t, 1, int16_t, ppl::cv::BORDER_WRAP)
+R(Sobel_u8c3_wrap, uint8_t, 3, int16_t, ppl::cv::BORDER_WRAP)
+R(Sobel_u8c4_wrap, uint8_t, 4, int16_t, ppl::cv::BORDER_WRAP)
@@ -18,11 +18,13 @@
 #include "ppl/cv/x86/split.h"
 #include "ppl/cv/x86/avx/internal_avx.hpp"
 #include "ppl/cv/x86/fma/internal_fma.hpp"
+#include "ppl/cv/x86/avx512/internal_avx512.hpp"
 #include "intrinutils.hpp"
 #include "ppl/cv/types.h"
 #include "ppl/common/sys.h"
 #include "ppl/common/retcode.h"
 #include "ppl/common/x86/sysinfo.h"
+#include "ppl/cv/x86/isa.hpp"
 #include <string.h>
 #include <cmath>
 #include <immintrin.h>
@@ -48,8 +50,10 @@ template <>
     if (nullptr == outDataChannel0 || nullptr == outDataChannel1 || nullptr == outDataChannel2) {
         return ppl::common::RC_INVALID_VALUE;
     }
-    if (ppl::common::CpuSupports(ppl::common::ISA_X86_FMA)) {
-        uint8_t* outData[3] = {outDataChannel0, outDataChannel1, outDataChannel2};
+    uint8_t* outData[3] = {outDataChannel0, outDataChannel1, outDataChannel2};
+    if (isa_supported(ppl::common::ISA_X86_AVX512)) {
+        return avx512::splitAOS2SOA<uint8_t, 3>(height, width, inWidthStride, inData, outWidthStride, outData);
+    } else if (isa_supported(ppl::common::ISA_X86_FMA)) {
         return fma::splitAOS2SOA<uint8_t, 3>(height, width, inWidthStride, inData, outWidthStride, outData);
     } else {
         for (int32_t h = 0; h < height; h++) {
@@ -96,8 +100,10 @@ template <>
     if (nullptr == outDataChannel0 || nullptr == outDataChannel1 || nullptr == outDataChannel2) {
         return ppl::common::RC_INVALID_VALUE;
     }
-    if (ppl::common::CpuSupports(ppl::common::ISA_X86_FMA)) {
-        float* outData[3] = {outDataChannel0, outDataChannel1, outDataChannel2};
+    float* outData[3] = {outDataChannel0, outDataChannel1, outDataChannel2};
+    if (isa_supported(ppl::common::ISA_X86_AVX512)) {
+        return avx512::splitAOS2SOA<float, 3>(height, width, inWidthStride, inData, outWidthStride, outData);
+    } else if (isa_supported(ppl::common::ISA_X86_FMA)) {
         return fma::splitAOS2SOA<float, 3>(height, width, inWidthStride, inData, outWidthStride, outData);
     } else {
         for (int32_t h = 0; h < height; h++) {
@@ -146,7 +152,9 @@ template <>
         return ppl::common::RC_INVALID_VALUE;
     }
     uint8_t* outData[4] = {outDataChannel0, outDataChannel1, outDataChannel2, outDataChannel3};
-    if (ppl::common::CpuSupports(ppl::common::ISA_X86_FMA)) {
+    if (isa_supported(ppl::common::ISA_X86_AVX512)) {
+        return avx512::splitAOS2SOA<uint8_t, 4>(height, width, inWidthStride, inData, outWidthStride, outData);
+    } else if (isa_supported(ppl::common::ISA_X86_FMA)) {
         return fma::splitAOS2SOA<uint8_t, 4>(height, width, inWidthStride, inData, outWidthStride, outData);
     } else {
         for (int32_t h = 0; h < height; h++) {
@@ -199,7 +207,9 @@ template <>
         return ppl::common::RC_INVALID_VALUE;
     }
     float* outData[4] = {outDataChannel0, outDataChannel1, outDataChannel2, outDataChannel3};
-    if (ppl::common::CpuSupports(ppl::common::ISA_X86_FMA)) {
+    if (isa_supported(ppl::common::ISA_X86_AVX512)) {
+        return avx512::splitAOS2SOA<float, 4>(height, width, inWidthStride, inData, outWidthStride, outData);
+    } else if (isa_supported(ppl::common::ISA_X86_FMA)) {
         return fma::splitAOS2SOA<float, 4>(height, width, inWidthStride, inData, outWidthStride, outData);
     } else {
         for (int32_t h = 0; h < height; h++) {
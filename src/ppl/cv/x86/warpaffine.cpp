@@ -18,10 +18,13 @@
 #include "ppl/cv/x86/warpaffine.h"
 #include "ppl/cv/x86/avx/internal_avx.hpp"
 #include "ppl/cv/x86/fma/internal_fma.hpp"
+#include "ppl/cv/x86/avx512/internal_avx512.hpp"
+#include "ppl/cv/x86/parallel.hpp"
 #include "ppl/cv/types.h"
 #include "ppl/common/sys.h"
 #include "ppl/common/retcode.h"
 #include "ppl/common/x86/sysinfo.h"
+#include "ppl/cv/x86/isa.hpp"
 #include <string.h>
 #include <cmath>
 
@@ -69,6 +72,7 @@ template <typename T, int32_t nc, ppl::cv::BorderType borderMode>
     int32_t inHeight,
     int32_t inWidth,
     int32_t inWidthStride,
+    int32_t rowBegin,
     int32_t outHeight,
     int32_t outWidth,
     int32_t outWidthStride,
@@ -78,8 +82,8 @@ template <typename T, int32_t nc, ppl::cv::BorderType borderMode>
     T delta)
 {
     for (int32_t i = 0; i < outHeight; i++) {
-        int32_t base_x = saturate_cast((M[1] * i + M[2]) * 1024) + 512;
-        int32_t base_y = saturate_cast((M[4] * i + M[5]) * 1024) + 512;
+        int32_t base_x = saturate_cast((M[1] * (rowBegin + i) + M[2]) * 1024) + 512;
+        int32_t base_y = saturate_cast((M[4] * (rowBegin + i) + M[5]) * 1024) + 512;
         for (int32_t j = 0; j < outWidth; j++) {
             int32_t sx = (base_x + saturate_cast(M[0] * j * 1024)) >> 10;
             int32_t sy = (base_y + saturate_cast(M[3] * j * 1024)) >> 10;
@@ -122,6 +126,7 @@ template <typename T, int32_t nc, ppl::cv::BorderType borderMode>
     int32_t inHeight,
     int32_t inWidth,
     int32_t inWidthStride,
+    int32_t rowBegin,
     int32_t outHeight,
     int32_t outWidth,
     int32_t outWidthStride,
@@ -131,8 +136,8 @@ template <typename T, int32_t nc, ppl::cv::BorderType borderMode>
     T delta)
 {
     for (int32_t i = 0; i < outHeight; i++) {
-        float base_x = M[1] * i + M[2];
-        float base_y = M[4] * i + M[5];
+        float base_x = M[1] * (rowBegin + i) + M[2];
+        float base_y = M[4] * (rowBegin + i) + M[5];
         for (int32_t j = 0; j < outWidth; j++) {
             float x     = base_x + M[0] * j;
             float y     = base_y + M[3] * j;
@@ -215,6 +220,28 @@ template <typename T, int32_t nc, ppl::cv::BorderType borderMode>
     return ppl::common::RC_SUCCESS;
 }
 
+// Runs a warp kernel on bands of output rows. The kernels are given the
+// absolute index of the first row of a band, so the coordinates of a row are
+// computed the same way whatever the band boundaries are.
+template <typename T, typename Kernel>
+::ppl::common::RetCode warpaffine_parallel(
+    int32_t inHeight,
+    int32_t inWidth,
+    int32_t inWidthStride,
+    int32_t outHeight,
+    int32_t outWidth,
+    int32_t outWidthStride,
+    T* dst,
+    const T* src,
+    const double* M,
+    T delta,
+    Kernel kernel)
+{
+    return parallel_for_rows_status(outHeight, outWidth * 16, [&](int32_t begin, int32_t end) {
+        return kernel(inHeight, inWidth, inWidthStride, begin, end - begin, outWidth, outWidthStride, dst + begin * outWidthStride, src, M, delta);
+    });
+}
+
 template <typename T, int32_t nc>
 ::ppl::common::RetCode WarpAffineNearestPoint(
     int32_t inHeight,
@@ -229,21 +256,21 @@ template <typename T, int32_t nc>
     BorderType border_type,
     T border_value)
 {
-    if (ppl::common::CpuSupports(ppl::common::ISA_X86_FMA)) {
+    if (isa_supported(ppl::common::ISA_X86_FMA)) {
         if (border_type == ppl::cv::BORDER_CONSTANT) {
-            return fma::warpaffine_nearest<T, nc, ppl::cv::BORDER_CONSTANT>(inHeight, inWidth, inWidthStride, outHeight, outWidth, outWidthStride, outData, inData, affineMatrix, border_value);
+            return warpaffine_parallel<T>(inHeight, inWidth, inWidthStride, outHeight, outWidth, outWidthStride, outData, inData, affineMatrix, border_value, fma::warpaffine_nearest<T, nc, ppl::cv::BORDER_CONSTANT>);
         } else if (border_type == ppl::cv::BORDER_REPLICATE) {
-            return fma::warpaffine_nearest<T, nc, ppl::cv::BORDER_REPLICATE>(inHeight, inWidth, inWidthStride, outHeight, outWidth, outWidthStride, outData, inData, affineMatrix, border_value);
+            return warpaffine_parallel<T>(inHeight, inWidth, inWidthStride, outHeight, outWidth, outWidthStride, outData, inData, affineMatrix, border_value, fma::warpaffine_nearest<T, nc, ppl::cv::BORDER_REPLICATE>);
         } else if (border_type == ppl::cv::BORDER_TRANSPARENT) {
-            return fma::warpaffine_nearest<T, nc, ppl::cv::BORDER_TRANSPARENT>(inHeight, inWidth, inWidthStride, outHeight, outWidth, outWidthStride, outData, inData, affineMatrix, border_value);
+            return warpaffine_parallel<T>(inHeight, inWidth, inWidthStride, outHeight, outWidth, outWidthStride, outData, inData, affineMatrix, border_value, fma::warpaffine_nearest<T, nc, ppl::cv::BORDER_TRANSPARENT>);
         }
     } else {
         if (border_type == ppl::cv::BORDER_CONSTANT) {
-            return warpaffine_nearest<T, nc, ppl::cv::BORDER_CONSTANT>(inHeight, inWidth, inWidthStride, outHeight, outWidth, outWidthStride, outData, inData, affineMatrix, border_value);
+            return warpaffine_parallel<T>(inHeight, inWidth, inWidthStride, outHeight, outWidth, outWidthStride, outData, inData, affineMatrix, border_value, warpaffine_nearest<T, nc, ppl::cv::BORDER_CONSTANT>);
         } else if (border_type == ppl::cv::BORDER_REPLICATE) {
-            return warpaffine_nearest<T, nc, ppl::cv::BORDER_REPLICATE>(inHeight, inWidth, inWidthStride, outHeight, outWidth, outWidthStride, outData, inData, affineMatrix, border_value);
+            return warpaffine_parallel<T>(inHeight, inWidth, inWidthStride, outHeight, outWidth, outWidthStride, outData, inData, affineMatrix, border_value, warpaffine_nearest<T, nc, ppl::cv::BORDER_REPLICATE>);
         } else if (border_type == ppl::cv::BORDER_TRANSPARENT) {
-            return warpaffine_nearest<T, nc, ppl::cv::BORDER_TRANSPARENT>(inHeight, inWidth, inWidthStride, outHeight, outWidth, outWidthStride, outData, inData, affineMatrix, border_value);
+            return warpaffine_parallel<T>(inHeight, inWidth, inWidthStride, outHeight, outWidth, outWidthStride, outData, inData, affineMatrix, border_value, warpaffine_nearest<T, nc, ppl::cv::BORDER_TRANSPARENT>);
         }
     }
     return ppl::common::RC_SUCCESS;
@@ -367,21 +394,29 @@ template <typename T, int32_t nc>
     BorderType border_type,
     T border_value)
 {
-    if (ppl::common::CpuSupports(ppl::common::ISA_X86_FMA)) {
+    if (isa_supported(ppl::common::ISA_X86_AVX512)) {
+        if (border_type == ppl::cv::BORDER_CONSTANT) {
+            return warpaffine_parallel<T>(inHeight, inWidth, inWidthStride, outHeight, outWidth, outWidthStride, outData, inData, affineMatrix, border_value, avx512::warpaffine_linear<T, nc, ppl::cv::BORDER_CONSTANT>);
+        } else if (border_type == ppl::cv::BORDER_REPLICATE) {
+            return warpaffine_parallel<T>(inHeight, inWidth, inWidthStride, outHeight, outWidth, outWidthStride, outData, inData, affineMatrix, border_value, avx512::warpaffine_linear<T, nc, ppl::cv::BORDER_REPLICATE>);
+        } else if (border_type == ppl::cv::BORDER_TRANSPARENT) {
+            return warpaffine_parallel<T>(inHeight, inWidth, inWidthStride, outHeight, outWidth, outWidthStride, outData, inData, affineMatrix, border_value, avx512::warpaffine_linear<T, nc, ppl::cv::BORDER_TRANSPARENT>);
+        }
+    } else if (isa_supported(ppl::common::ISA_X86_FMA)) {
         if (border_type == ppl::cv::BORDER_CONSTANT) {
-            return fma::warpaffine_linear<T, nc, ppl::cv::BORDER_CONSTANT>(inHeight, inWidth, inWidthStride, outHeight, outWidth, outWidthStride, outData, inData, affineMatrix, border_value);
+            return warpaffine_parallel<T>(inHeight, inWidth, inWidthStride, outHeight, outWidth, outWidthStride, outData, inData, affineMatrix, border_value, fma::warpaffine_linear<T, nc, ppl::cv::BORDER_CONSTANT>);
         } else if (border_type == ppl::cv::BORDER_REPLICATE) {
-            return fma::warpaffine_linear<T, nc, ppl::cv::BORDER_REPLICATE>(inHeight, inWidth, inWidthStride, outHeight, outWidth, outWidthStride, outData, inData, affineMatrix, border_value);
+            return warpaffine_parallel<T>(inHeight, inWidth, inWidthStride, outHeight, outWidth, outWidthStride, outData, inData, affineMatrix, border_value, fma::warpaffine_linear<T, nc, ppl::cv::BORDER_REPLICATE>);
         } else if (border_type == ppl::cv::BORDER_TRANSPARENT) {
-            return fma::warpaffine_linear<T, nc, ppl::cv::BORDER_TRANSPARENT>(inHeight, inWidth, inWidthStride, outHeight, outWidth, outWidthStride, outData, inData, affineMatrix, border_value);
+            return warpaffine_parallel<T>(inHeight, inWidth, inWidthStride, outHeight, outWidth, outWidthStride, outData, inData, affineMatrix, border_value, fma::warpaffine_linear<T, nc, ppl::cv::BORDER_TRANSPARENT>);
         }
     } else {
         if (border_type == ppl::cv::BORDER_CONSTANT) {
-            return warpaffine_linear<T, nc, ppl::cv::BORDER_CONSTANT>(inHeight, inWidth, inWidthStride, outHeight, outWidth, outWidthStride, outData, inData, affineMatrix, border_value);
+            return warpaffine_parallel<T>(inHeight, inWidth, inWidthStride, outHeight, outWidth, outWidthStride, outData, inData, affineMatrix, border_value, warpaffine_linear<T, nc, ppl::cv::BORDER_CONSTANT>);
         } else if (border_type == ppl::cv::BORDER_REPLICATE) {
-            return warpaffine_linear<T, nc, ppl::cv::BORDER_REPLICATE>(inHeight, inWidth, inWidthStride, outHeight, outWidth, outWidthStride, outData, inData, affineMatrix, border_value);
+            return warpaffine_parallel<T>(inHeight, inWidth, inWidthStride, outHeight, outWidth, outWidthStride, outData, inData, affineMatrix, border_value, warpaffine_linear<T, nc, ppl::cv::BORDER_REPLICATE>);
         } else if (border_type == ppl::cv::BORDER_TRANSPARENT) {
-            return warpaffine_linear<T, nc, ppl::cv::BORDER_TRANSPARENT>(inHeight, inWidth, inWidthStride, outHeight, outWidth, outWidthStride, outData, inData, affineMatrix, border_value);
+            return warpaffine_parallel<T>(inHeight, inWidth, inWidthStride, outHeight, outWidth, outWidthStride, outData, inData, affineMatrix, border_value, warpaffine_linear<T, nc, ppl::cv::BORDER_TRANSPARENT>);
         }
     }
     return ppl::common::RC_SUCCESS;
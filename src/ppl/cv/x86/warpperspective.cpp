@@ -22,6 +22,7 @@
 #include "ppl/common/sys.h"
 #include "ppl/common/retcode.h"
 #include "ppl/common/x86/sysinfo.h"
+#include "ppl/cv/x86/isa.hpp"
 #include <string.h>
 #include <cmath>
 #include <algorithm>
@@ -279,7 +280,7 @@ template <typename T, int32_t nc>
     M[2][0] = affineMatrix[6];
     M[2][1] = affineMatrix[7];
     M[2][2] = affineMatrix[8];
-    if (ppl::common::CpuSupports(ppl::common::ISA_X86_FMA)) {
+    if (isa_supported(ppl::common::ISA_X86_FMA)) {
         if (border_type == ppl::cv::BORDER_CONSTANT) {
             fma::warpperspective_nearest<T, nc, ppl::cv::BORDER_CONSTANT>(inHeight, inWidth, inWidthStride, outHeight, outWidth, outWidthStride, outData, inData, M, border_value);
         } else if (border_type == ppl::cv::BORDER_REPLICATE) {
@@ -323,7 +324,7 @@ template <typename T, int32_t nc>
     M[2][0] = affineMatrix[6];
     M[2][1] = affineMatrix[7];
     M[2][2] = affineMatrix[8];
-    if (ppl::common::CpuSupports(ppl::common::ISA_X86_FMA)) {
+    if (isa_supported(ppl::common::ISA_X86_FMA)) {
         if (border_type == ppl::cv::BORDER_CONSTANT) {
             fma::warpperspective_linear<T, nc, ppl::cv::BORDER_CONSTANT>(inHeight, inWidth, inWidthStride, outHeight, outWidth, outWidthStride, outData, inData, M, border_value);
         } else if (border_type == ppl::cv::BORDER_REPLICATE) {